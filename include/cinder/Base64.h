@@ -25,6 +25,7 @@
 
 #include "cinder/Cinder.h"
 #include "cinder/Buffer.h"
+#include "cinder/Stream.h"
 
 #include <string>
 
@@ -44,4 +45,55 @@ Buffer fromBase64( const Buffer &input );
 //! Converts Base64-encoded data \a input into unencoded data.
 Buffer fromBase64( const void *input, size_t inputSize );
 
+//! Returns the number of characters toBase64() produces for \a inputSize bytes, including the newlines inserted when \a charsPerLine > 0.
+size_t getBase64EncodedSize( size_t inputSize, int charsPerLine = 0 );
+//! Returns the most bytes fromBase64() can produce for \a inputSize characters. Padding, whitespace and line breaks make the actual size smaller.
+size_t getBase64DecodedSizeMax( size_t inputSize );
+
+//! Converts \a input of length \a inputSize into Base64, writing to \a output, which must have room for getBase64EncodedSize( \a inputSize, \a charsPerLine ) characters. No null terminator is written. Returns the number of characters written.
+size_t toBase64( const void *input, size_t inputSize, char *output, int charsPerLine = 0 );
+//! Converts Base64-encoded data \a input of length \a inputSize into \a output, which must have room for getBase64DecodedSizeMax( \a inputSize ) bytes. Returns the number of bytes written.
+size_t fromBase64( const void *input, size_t inputSize, void *output );
+
+//! Reads \a input to its end and writes it Base64-encoded to \a output, a chunk at a time. Returns the number of characters written.
+size_t toBase64( const IStreamRef &input, const OStreamRef &output, int charsPerLine = 0 );
+//! Reads Base64-encoded data from \a input to its end and writes it decoded to \a output, a chunk at a time. Returns the number of bytes written.
+size_t fromBase64( const IStreamRef &input, const OStreamRef &output );
+
+//! Encodes data into Base64 incrementally, for input which arrives in chunks. Bytes which don't complete a 3 byte group are held until the next call to encode() or finish().
+class Base64Encoder {
+  public:
+	//! If \a charsPerLine > 0, carriage returns (\n) are inserted every \a charsPerLine characters, rounded down to the nearest multiple of 4.
+	explicit Base64Encoder( int charsPerLine = 0 );
+
+	//! Returns the number of characters the next call to encode() writes for \a inputSize bytes.
+	size_t	getEncodedSize( size_t inputSize ) const;
+	//! Encodes \a inputSize bytes of \a input into \a output, which must have room for getEncodedSize( \a inputSize ) characters. Returns the number of characters written.
+	size_t	encode( const void *input, size_t inputSize, char *output );
+	//! Encodes any held bytes along with their padding into \a output, which must have room for 4 characters, and readies the encoder for new data. Returns the number of characters written.
+	size_t	finish( char *output );
+
+  private:
+	char*	encodeLines( const uint8_t *input, size_t numGroups, char *output );
+
+	uint8_t		mPending[3];
+	size_t		mNumPending;
+	size_t		mGroupsPerLine, mGroupsOnLine;
+};
+
+//! Decodes Base64 incrementally, for input which arrives in chunks. Characters outside of the Base64 alphabet, such as whitespace and padding, are skipped. Each byte is written as soon as the characters completing it have been decoded.
+class Base64Decoder {
+  public:
+	Base64Decoder();
+
+	//! Returns the most bytes the next call to decode() can write for \a inputSize characters.
+	size_t	getDecodedSizeMax( size_t inputSize ) const;
+	//! Decodes \a inputSize characters of \a input into \a output, which must have room for getDecodedSizeMax( \a inputSize ) bytes. Returns the number of bytes written.
+	size_t	decode( const char *input, size_t inputSize, void *output );
+
+  private:
+	uint32_t	mBits;
+	size_t		mNumPending;
+};
+
 } // namespace cinder
\ No newline at end of file
@@ -0,0 +1,153 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Color.h"
+#include "cinder/Easing.h"
+#include "cinder/Vector.h"
+
+#include <vector>
+
+namespace cinder {
+
+//! Number of float components tweened by BatchTimeline for each supported type. Other types are not supported and fail to compile.
+template<typename T> struct BatchTweenComponents;
+template<> struct BatchTweenComponents<float>	{ static const uint32_t value = 1; };
+template<> struct BatchTweenComponents<vec2>	{ static const uint32_t value = 2; };
+template<> struct BatchTweenComponents<vec3>	{ static const uint32_t value = 3; };
+template<> struct BatchTweenComponents<vec4>	{ static const uint32_t value = 4; };
+template<> struct BatchTweenComponents<Color>	{ static const uint32_t value = 3; };
+template<> struct BatchTweenComponents<ColorA>	{ static const uint32_t value = 4; };
+
+/** \brief A Timeline variant for large numbers of simple tweens.
+ *
+ *  Tweens of float, vec2, vec3, vec4, Color and ColorA are stored by value in contiguous arrays, grouped by their easing function, and evaluated a group at a time
+ *  without any per-tween allocations or virtual calls. Tweens are identified by a Handle, which removes them in constant time. Unlike Timeline, there are no
+ *  callbacks, looping or Anim<> support, and adding a tween does not replace the existing tweens on its target. Targets are written through raw pointers, so a
+ *  target must outlive its tweens or have them removed first. **/
+class BatchTimeline {
+  public:
+	//! Easing functions are grouped by address, so they must be plain functions such as the ones in Easing.h
+	typedef float (*EaseFnPtr)( float );
+
+	//! Identifies a tween in a BatchTimeline. A Handle remains safe to use after its tween completes or is removed.
+	class Handle {
+	  public:
+		Handle() : mSlot( INVALID_SLOT ), mGeneration( 0 ) {}
+
+		//! Returns whether the Handle was returned by a BatchTimeline, which does not imply its tween is still active
+		bool	isValid() const { return mSlot != INVALID_SLOT; }
+
+		bool	operator==( const Handle &rhs ) const { return mSlot == rhs.mSlot && mGeneration == rhs.mGeneration; }
+		bool	operator!=( const Handle &rhs ) const { return ! ( *this == rhs ); }
+
+	  private:
+		Handle( uint32_t slot, uint32_t generation ) : mSlot( slot ), mGeneration( generation ) {}
+
+		static const uint32_t INVALID_SLOT = 0xFFFFFFFF;
+
+		uint32_t	mSlot, mGeneration;
+
+		friend class BatchTimeline;
+	};
+
+	BatchTimeline();
+
+	//! Advances time a specified amount and evaluates tweens
+	void	step( float timestep );
+	//! Goes to a specific time and evaluates tweens
+	void	stepTo( float absoluteTime );
+	//! Returns the timeline's most recent current time
+	float	getCurrentTime() const { return mCurrentTime; }
+
+	//! Adds a tween of \a target from its current value to \a endValue at the timeline's current time
+	template<typename T>
+	Handle	apply( T *target, const T &endValue, float duration, EaseFnPtr easeFunction = easeNone )
+	{
+		return insert( target, *target, endValue, mCurrentTime, duration, easeFunction );
+	}
+	//! Adds a tween of \a target from \a startValue to \a endValue at the timeline's current time
+	template<typename T>
+	Handle	apply( T *target, const T &startValue, const T &endValue, float duration, EaseFnPtr easeFunction = easeNone )
+	{
+		return insert( target, startValue, endValue, mCurrentTime, duration, easeFunction );
+	}
+	//! Adds a tween of \a target from \a startValue to \a endValue which starts at \a startTime. \a target is not modified before \a startTime.
+	template<typename T>
+	Handle	insert( T *target, const T &startValue, const T &endValue, float startTime, float duration, EaseFnPtr easeFunction = easeNone )
+	{
+		static_assert( sizeof( T ) == BatchTweenComponents<T>::value * sizeof( float ), "BatchTimeline only tweens types made of floats" );
+		return insertComponents( reinterpret_cast<float*>( target ), reinterpret_cast<const float*>( &startValue ), reinterpret_cast<const float*>( &endValue ),
+									BatchTweenComponents<T>::value, startTime, duration, easeFunction );
+	}
+
+	//! Removes the tween identified by \a handle in constant time. Returns \c false if it had already completed or been removed.
+	bool	remove( Handle handle );
+	//! Returns whether the tween identified by \a handle has neither been removed nor, with auto-removal, completed
+	bool	isActive( Handle handle ) const;
+	//! Removes all tweens
+	void	clear();
+
+	//! Returns the number of tweens in the timeline
+	size_t	getNumTweens() const { return mNumTweens; }
+	//! Returns whether the timeline has no tweens
+	bool	empty() const { return mNumTweens == 0; }
+
+	//! Sets whether tweens are removed once they complete. Defaults to \c true. Tweens which are kept can be evaluated again by stepping backwards.
+	void	setAutoRemove( bool autoRemove = true ) { mAutoRemove = autoRemove; }
+	//! Returns whether tweens are removed once they complete
+	bool	getAutoRemove() const { return mAutoRemove; }
+
+  private:
+	// Tweens sharing an easing function and number of components, stored as parallel arrays
+	struct Group {
+		EaseFnPtr				mEaseFn;
+		uint32_t				mNumComponents;
+		std::vector<float*>		mTargets;
+		std::vector<float>		mStartTimes, mInvDurations;
+		// mNumComponents values per tween
+		std::vector<float>		mStartValues, mEndValues;
+		std::vector<uint32_t>	mSlots;
+	};
+
+	// Locates a tween for its Handle. Free slots form a list through mIndex, and removal increments mGeneration to invalidate existing Handles.
+	struct Slot {
+		uint32_t	mGroup, mIndex, mGeneration;
+	};
+
+	Handle	insertComponents( float *target, const float *startValue, const float *endValue, uint32_t numComponents, float startTime, float duration, EaseFnPtr easeFn );
+	void	removeFromGroup( uint32_t group, uint32_t index );
+
+	std::vector<Group>		mGroups;
+	std::vector<Slot>		mSlots;
+	uint32_t				mFreeSlot;
+	size_t					mNumTweens;
+	float					mCurrentTime;
+	bool					mAutoRemove;
+	// indices of the completed tweens in the group being evaluated
+	std::vector<uint32_t>	mCompleted;
+};
+
+} // namespace cinder
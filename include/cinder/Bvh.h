@@ -0,0 +1,147 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "cinder/AxisAlignedBox.h"
+#include "cinder/Frustum.h"
+#include "cinder/GeomIo.h"
+#include "cinder/Ray.h"
+
+#include <vector>
+
+namespace cinder {
+
+typedef std::shared_ptr<class Bvh>	BvhRef;
+
+/** \brief Bounding volume hierarchy over the triangles of a mesh, for ray casting, picking and overlap queries.
+ *
+ * The hierarchy is built top-down with a binned surface area heuristic, optionally in parallel, and stored as a flat array of nodes in
+ * depth-first order. Leaves hold up to four triangles, which are stored together so that a ray can be tested against all of them at once
+ * with SSE. When the vertices of the mesh move but its triangles don't change, refit() updates the bounds without rebuilding.
+ *
+ * Example usage:
+ * \code
+ * Bvh bvh( *myTriMesh );
+ * Bvh::Hit hit;
+ * if( bvh.closestHit( camera.generateRay( mousePos, windowSize ), &hit ) )
+ *     console() << "picked triangle " << hit.mTriangle << " at distance " << hit.mDistance << std::endl;
+ * \endcode
+**/
+class Bvh {
+  public:
+	class Format {
+	  public:
+		Format() : mParallel( true ), mNumBins( 16 ) {}
+
+		//! Builds large subtrees on separate threads. Defaults to \c true.
+		Format&		parallel( bool parallel = true ) { mParallel = parallel; return *this; }
+		//! Sets the number of bins the surface area heuristic evaluates per axis, between \c 2 and \c 64. Defaults to \c 16.
+		Format&		bins( int numBins ) { mNumBins = std::min( std::max( 2, numBins ), 64 ); return *this; }
+
+		bool	isParallel() const { return mParallel; }
+		int		getNumBins() const { return mNumBins; }
+
+	  private:
+		bool	mParallel;
+		int		mNumBins;
+	};
+
+	//! The result of a ray query.
+	struct Hit {
+		//! Index of the triangle in the mesh, as in indices[mTriangle * 3] to indices[mTriangle * 3 + 2]
+		uint32_t	mTriangle;
+		//! Distance along the ray, in multiples of its direction
+		float		mDistance;
+		//! Barycentric coordinates of the hit with respect to the second and third vertex of the triangle
+		float		mU, mV;
+	};
+
+	//! Builds a Bvh over the triangles of \a source, which needs 3D positions.
+	static BvhRef	create( const geom::Source &source, const Format &format = Format() ) { return BvhRef( new Bvh( source, format ) ); }
+	//! Builds a Bvh over the triangles described by \a numIndices \a indices into \a positions.
+	static BvhRef	create( const vec3 *positions, size_t numVertices, const uint32_t *indices, size_t numIndices, const Format &format = Format() )
+	{
+		return BvhRef( new Bvh( positions, numVertices, indices, numIndices, format ) );
+	}
+
+	//! Builds a Bvh over the triangles of \a source, which needs 3D positions.
+	Bvh( const geom::Source &source, const Format &format = Format() );
+	//! Builds a Bvh over the triangles described by \a numIndices \a indices into \a positions.
+	Bvh( const vec3 *positions, size_t numVertices, const uint32_t *indices, size_t numIndices, const Format &format = Format() );
+
+	//! Finds the closest triangle hit by \a ray within \a maxDistance, in multiples of its direction. Returns \c false if there is none.
+	bool	closestHit( const Ray &ray, Hit *result, float maxDistance = std::numeric_limits<float>::max() ) const;
+	//! Returns whether \a ray hits any triangle within \a maxDistance, which is faster than closestHit() for visibility tests.
+	bool	anyHit( const Ray &ray, float maxDistance = std::numeric_limits<float>::max() ) const;
+	//! Appends the indices of the triangles whose bounds overlap \a box to \a result.
+	void	queryTriangles( const AxisAlignedBox &box, std::vector<uint32_t> *result ) const;
+	//! Appends the indices of the triangles whose bounds intersect \a frustum to \a result.
+	void	queryTriangles( const Frustum &frustum, std::vector<uint32_t> *result ) const;
+
+	//! Updates the hierarchy for moved vertices. The mesh must have the same triangles it was built with.
+	void	refit( const vec3 *positions, size_t numVertices );
+	//! Updates the hierarchy for moved vertices of \a source, which must have the same triangles the Bvh was built with.
+	void	refit( const geom::Source &source );
+
+	//! Returns the bounds of all triangles.
+	AxisAlignedBox	getBounds() const;
+	//! Returns the number of triangles in the hierarchy.
+	size_t			getNumTriangles() const		{ return mNumTriangles; }
+	//! Returns the number of nodes in the hierarchy.
+	size_t			getNumNodes() const			{ return mNodes.size(); }
+
+  private:
+	//! Leaves refer to mCount triangles starting at packet mOffset, interior nodes have their first child next to them and their second one at mOffset.
+	struct Node {
+		vec3		mMin;
+		uint32_t	mOffset;
+		vec3		mMax;
+		uint32_t	mCount;
+	};
+
+	//! Up to four triangles in structure-of-arrays layout, indexed by [axis][triangle]. Unused slots have zero edges.
+	struct TrianglePacket {
+		float	mVertex0[3][4];
+		float	mEdge1[3][4];
+		float	mEdge2[3][4];
+	};
+
+	void	build( const vec3 *positions, size_t numVertices, const uint32_t *indices, size_t numIndices, const Format &format );
+	void	updatePacket( size_t packet, const vec3 *positions );
+	template<typename OverlapFn, typename ContainsFn>
+	void	queryTrianglesImpl( const OverlapFn &overlaps, const ContainsFn &contains, std::vector<uint32_t> *result ) const;
+	template<bool AnyHit>
+	bool	traceRay( const Ray &ray, float maxDistance, Hit *result ) const;
+
+	std::vector<Node>				mNodes;
+	std::vector<TrianglePacket>		mPackets;
+	//! Triangle index for each packet slot, or ~0 for unused slots
+	std::vector<uint32_t>			mPacketTriangles;
+	//! Vertex indices for each packet slot, used for refitting
+	std::vector<uint32_t>			mPacketIndices;
+	size_t							mNumTriangles;
+	size_t							mMaxDepth;
+};
+
+} // namespace cinder
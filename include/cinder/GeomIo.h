@@ -37,6 +37,8 @@
 #include <map>
 #include <algorithm>
 #include <array>
+#include <functional>
+#include <cfloat>
 
 // Forward declarations in cinder::
 namespace cinder {
@@ -77,6 +79,35 @@ void copyData( uint8_t srcDimensions, size_t srcStrideBytes, const float *srcDat
 void calculateTangents( size_t numIndices, const uint32_t *indices, size_t numVertices, const vec3 *positions, const vec3 *normals, const vec2 *texCoords, std::vector<vec3> *resultTangents, std::vector<vec3> *resultBitangents );
 //! Utility function for calculating tangents and bitangents from indexed geometry and 3D texture coordinates. \a resultBitangents may be NULL if not needed.
 void calculateTangents( size_t numIndices, const uint32_t *indices, size_t numVertices, const vec3 *positions, const vec3 *normals, const vec3 *texCoords, std::vector<vec3> *resultTangents, std::vector<vec3> *resultBitangents );
+//! Utility function for welding vertices. For each of \a numVertices \a positions, \a resultRemap receives the index of the first vertex whose position lies within \a tolerance
+//! and for which \a isEquivalent( first, vertex ) returns \c true (if provided), or the vertex's own index if there is none. A \a tolerance of \c 0 only matches identical positions.
+//! Coincident vertices are found with a spatial hash, so this runs in expected linear time. Returns the number of unique vertices.
+size_t calculateWeldMap( size_t numVertices, const vec3 *positions, float tolerance, std::vector<uint32_t> *resultRemap, const std::function<bool( uint32_t, uint32_t )> &isEquivalent = nullptr );
+//! Utility function for simplifying indexed triangles by quadric error metric edge collapse. Collapses edges until no more than \a targetNumIndices remain or the next collapse would move the surface
+//! further than \a maxError. Vertices are never moved, so \a resultIndices refers to the same vertices and their attributes remain valid. Vertices which share a position but differ in other
+//! attributes are only collapsed along their seam, and open borders only along the border. \a resultError, if provided, receives the largest error of any collapse. Returns the number of indices remaining.
+size_t calculateSimplifiedIndices( size_t numIndices, const uint32_t *indices, size_t numVertices, const vec3 *positions, size_t targetNumIndices, float maxError, std::vector<uint32_t> *resultIndices, float *resultError = nullptr );
+//! Utility function for reordering indexed triangles to make better use of the GPU's post-transform vertex cache, using Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+void calculateVertexCacheOptimizedIndices( size_t numIndices, const uint32_t *indices, size_t numVertices, std::vector<uint32_t> *resultIndices );
+//! Utility function for reordering indexed triangles, already optimized with calculateVertexCacheOptimizedIndices(), to reduce overdraw. Triangles are split into clusters that are drawn outermost first.
+//! More clusters reduce overdraw further at the expense of vertex cache efficiency; \a threshold is the largest acceptable ratio of the resulting to the original ACMR, such as \c 1.05.
+void calculateOverdrawOptimizedIndices( size_t numIndices, const uint32_t *indices, size_t numVertices, const vec3 *positions, float threshold, std::vector<uint32_t> *resultIndices );
+//! Utility function for reordering vertices in the order \a indices first use them, which improves the locality of vertex fetches. \a resultRemap receives the new index of each vertex;
+//! unused vertices are moved to the end. Returns the number of vertices used.
+size_t calculateVertexFetchRemap( size_t numIndices, const uint32_t *indices, size_t numVertices, std::vector<uint32_t> *resultRemap );
+
+//! Post-transform vertex cache statistics for indexed triangles, as returned by calculateVertexCacheStats()
+struct VertexCacheStats {
+	//! Average cache miss ratio; the number of vertices transformed per triangle. Ranges from 3 down to about 0.5 for large regular meshes.
+	float	mAcmr;
+	//! Average transformed to vertex ratio; the number of vertices transformed per vertex used. 1 is ideal.
+	float	mAtvr;
+	//! The number of vertices transformed
+	size_t	mNumTransformed;
+};
+
+//! Utility function for measuring the post-transform vertex cache efficiency of indexed triangles by simulating a FIFO cache of \a cacheSize vertices.
+VertexCacheStats calculateVertexCacheStats( size_t numIndices, const uint32_t *indices, size_t numVertices, size_t cacheSize = 16 );
 
 struct AttribInfo {
 	AttribInfo( const Attrib &attrib, uint8_t dims, size_t stride, size_t offset, uint32_t instanceDivisor = 0 )
@@ -1260,16 +1291,19 @@ class Lines : public Modifier {
 class ColorFromAttrib : public Modifier {
   public:
 	ColorFromAttrib( Attrib attrib, const std::function<Colorf(vec2)> &fn )
-		: mAttrib( attrib ), mFnColor2( fn )
+		: mAttrib( attrib ), mFnColor2( fn ), mParallel( false )
 	{}
 	ColorFromAttrib( Attrib attrib, const std::function<Colorf(vec3)> &fn )
-		: mAttrib( attrib ), mFnColor3( fn )
+		: mAttrib( attrib ), mFnColor3( fn ), mParallel( false )
 	{}
 	
 	Attrib				getAttrib() const { return mAttrib; }
 	ColorFromAttrib&	attrib( Attrib attrib ) { mAttrib = attrib; return *this; }
+	//! Allows the color function to be called concurrently from multiple threads on large meshes. Default is \c false; only enable it for thread-safe functions.
+	ColorFromAttrib&	parallel( bool enable = true ) { mParallel = enable; return *this; }
+	bool				isParallel() const { return mParallel; }
 
-	Modifier*	clone() const override { return new ColorFromAttrib( mAttrib, mFnColor2, mFnColor3 ); }
+	Modifier*	clone() const override { return new ColorFromAttrib( *this ); }
 	uint8_t		getAttribDims( Attrib attr, uint8_t upstreamDims ) const override;
 	AttribSet	getAvailableAttribs( const Modifier::Params &upstreamParams ) const override;
 	
@@ -1277,12 +1311,13 @@ class ColorFromAttrib : public Modifier {
 	
   protected:
 	ColorFromAttrib( Attrib attrib, const std::function<Colorf(vec2)> &fn2, const std::function<Colorf(vec3)> &fn3 )
-		: mAttrib( attrib ), mFnColor2( fn2 ), mFnColor3( fn3 )
+		: mAttrib( attrib ), mFnColor2( fn2 ), mFnColor3( fn3 ), mParallel( false )
 	{}
 
 	Attrib							mAttrib;
 	std::function<Colorf(vec2)>		mFnColor2;
 	std::function<Colorf(vec3)>		mFnColor3;
+	bool							mParallel;
 };
 
 //! Sets an attribute of a geom::Source to be a constant value for every vertex. Determines dimension from constructor (vec4 -> 4, for example)
@@ -1318,14 +1353,18 @@ class AttribFn : public Modifier {
 	static const int DSTDIM = sizeof(D)/ sizeof(float);
 	
 	AttribFn( Attrib src, Attrib dst, const FN &fn )
-		: mSrcAttrib( src ), mDstAttrib( dst ), mFn( fn )
+		: mSrcAttrib( src ), mDstAttrib( dst ), mFn( fn ), mParallel( false )
 	{}
 
 	AttribFn( Attrib attrib, const FN &fn )
-		: mSrcAttrib( attrib ), mDstAttrib( attrib ), mFn( fn )
+		: mSrcAttrib( attrib ), mDstAttrib( attrib ), mFn( fn ), mParallel( false )
 	{}
 	
-	Modifier*	clone() const override { return new AttribFn( mSrcAttrib, mDstAttrib, mFn ); }
+	//! Allows \a fn to be called concurrently from multiple threads on large meshes. Default is \c false; only enable it for thread-safe functions.
+	AttribFn&	parallel( bool enable = true ) { mParallel = enable; return *this; }
+	bool		isParallel() const { return mParallel; }
+
+	Modifier*	clone() const override { return new AttribFn( *this ); }
 	uint8_t		getAttribDims( Attrib attr, uint8_t upstreamDims ) const override;
 	AttribSet	getAvailableAttribs( const Modifier::Params &upstreamParams ) const override;
 	
@@ -1334,6 +1373,7 @@ class AttribFn : public Modifier {
   protected:
 	geom::Attrib		mSrcAttrib, mDstAttrib;
 	FN					mFn;
+	bool				mParallel;
 };
 
 //! Draws lines representing the Attrib::NORMALs for a geom::Source. Encodes 0 for base and 1 for normal into CUSTOM_0
@@ -1431,6 +1471,58 @@ class Subdivide : public Modifier {
 };
 
 
+//! Reduces the number of triangles of a geom::Source by quadric error metric edge collapse. Only the indices are changed, so normals, texture coordinates and their seams are preserved. Requires TRIANGLES and 3D POSITION.
+class Simplify : public Modifier {
+  public:
+	//! Simplifies to \a ratio of the upstream triangle count
+	Simplify( float ratio = 0.5f )
+		: mRatio( ratio ), mNumTriangles( 0 ), mMaxError( FLT_MAX )
+	{}
+
+	//! Sets the fraction of the upstream triangles to keep. Ignored if numTriangles() is set.
+	Simplify&	ratio( float ratio ) { mRatio = ratio; return *this; }
+	//! Sets the number of triangles to simplify to, which overrides ratio(). Default is \c 0.
+	Simplify&	numTriangles( size_t numTriangles ) { mNumTriangles = numTriangles; return *this; }
+	//! Stops simplifying before any collapse that would move the surface further than \a maxError. Default is \c FLT_MAX.
+	Simplify&	maxError( float maxError ) { mMaxError = maxError; return *this; }
+
+	//! Returns an upper bound, as the actual number depends on the geometry.
+	size_t		getNumIndices( const Modifier::Params &upstreamParams ) const override;
+	
+	Modifier*	clone() const override { return new Simplify( *this ); }
+	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
+
+  protected:
+	size_t		getTargetNumIndices( size_t upstreamNumIndices ) const;
+
+	float		mRatio;
+	size_t		mNumTriangles;
+	float		mMaxError;
+};
+
+//! Reorders the triangles of a geom::Source for the GPU's post-transform vertex cache, and optionally to reduce overdraw. By default the vertices are then reordered
+//! in the order the triangles use them, which improves the locality of vertex fetches. The number of vertices is unchanged. Requires TRIANGLES.
+class OptimizeVertexCache : public Modifier {
+  public:
+	OptimizeVertexCache()
+		: mVertexFetch( true ), mOverdraw( false ), mOverdrawThreshold( 1.05f )
+	{}
+
+	//! Enables reordering the vertices in the order the triangles use them. Default is \c true.
+	OptimizeVertexCache&	vertexFetch( bool enable = true ) { mVertexFetch = enable; return *this; }
+	//! Enables reordering clusters of triangles to reduce overdraw, as long as the ACMR grows by no more than \a threshold times. Requires 3D POSITION. Default is \c false.
+	OptimizeVertexCache&	overdraw( bool enable = true, float threshold = 1.05f ) { mOverdraw = enable; mOverdrawThreshold = threshold; return *this; }
+
+	size_t		getNumIndices( const Modifier::Params &upstreamParams ) const override;
+
+	Modifier*	clone() const override { return new OptimizeVertexCache( *this ); }
+	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
+
+  protected:
+	bool		mVertexFetch, mOverdraw;
+	float		mOverdrawThreshold;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Base class for SourceMods<> and SourceModsPtr<>
 //! Used by Modifiers to process Source -> Target
@@ -1470,6 +1562,8 @@ class SourceModsContext : public Target {
 	void			preload( const AttribSet &requestedAttribs );
 	void			combine( const SourceModsContext &rhs );
 	void			complete( Target *target, const AttribSet &requestedAttribs );
+	//! Copies the captured data for \a requestedAttribs, along with any indices, into \a target. Used to replay a capturing SourceModsContext.
+	void			copyInto( Target *target, const AttribSet &requestedAttribs ) const;
 	
   private:
 	const Source					*mSource;
@@ -1492,16 +1586,16 @@ class SourceModsContext : public Target {
 class SourceMods : public Source {
   public:
 	SourceMods()
-		: mVariablesCached( false ), mSourcePtr( nullptr )
+		: mVariablesCached( false ), mSourcePtr( nullptr ), mCacheEnabled( false )
 	{}
 	SourceMods( const geom::Source &source )
-		: mVariablesCached( false )
+		: mVariablesCached( false ), mCacheEnabled( false )
 	{
 		mSourceStorage = std::unique_ptr<Source>( source.clone() );
 		mSourcePtr = mSourceStorage.get();
 	}
 	SourceMods( const geom::Source *source )
-		: mVariablesCached( false )
+		: mVariablesCached( false ), mCacheEnabled( false )
 	{
 		mSourcePtr = source;
 	}
@@ -1518,10 +1612,13 @@ class SourceMods : public Source {
 		mSourcePtr = rhs.mSourcePtr;
 		mModifiers = std::move( rhs.mModifiers );
 		mChildren = std::move( rhs.mChildren );
+		mCacheEnabled = rhs.mCacheEnabled;
+		mCache = std::move( rhs.mCache );
+		mCachedAttribs = std::move( rhs.mCachedAttribs );
 	}
 
 	explicit SourceMods( const Source *source, bool clone )
-		: mVariablesCached( false )
+		: mVariablesCached( false ), mCacheEnabled( false )
 	{
 		if( clone ) {
 			mSourceStorage = std::unique_ptr<Source>( source->clone() );
@@ -1539,6 +1636,13 @@ class SourceMods : public Source {
 	SourceMods&	operator&=( const SourceMods &sourceMods ) { append( sourceMods ); return *this; }
 	SourceMods&	operator&=( const Source &source ) { append( source ); return *this; }	
 	
+	//! Enables caching of the processed attribute data, so that repeated calls to loadInto() (when building several Targets from the same SourceMods, for example) only evaluate the Source and Modifiers once.
+	//! The cache is discarded by append(). Call invalidateCache() after modifying a Source that isn't owned by the SourceMods. Default is \c false.
+	SourceMods&	enableCache( bool enable = true );
+	bool		isCacheEnabled() const { return mCacheEnabled; }
+	//! Discards any cached attribute data, forcing the next loadInto() to evaluate the Source and Modifiers again.
+	void		invalidateCache();
+
 	const std::vector<std::unique_ptr<Modifier>>&	getModifiers() const { return mModifiers; }
 	const Source*									getSource() const { return mSourcePtr; }
 	//! Not generally useful. Use getSource() instead. Maps to nullptr when the SourceMods is not responsible for ownership.
@@ -1556,6 +1660,7 @@ class SourceMods : public Source {
   protected:
 	void		copyImpl( const SourceMods &rhs );
 	void		cacheVariables() const;
+	void		loadIntoUncached( Target *target, const AttribSet &requestedAttribs ) const;
 	
 	const Source* 							mSourcePtr; // null if we have children
 	std::unique_ptr<Source>					mSourceStorage; // null if we don't have ownership
@@ -1565,6 +1670,11 @@ class SourceMods : public Source {
 	mutable std::vector<Modifier::Params>	mParamsStack;
 	
 	std::vector<std::unique_ptr<SourceMods>>	mChildren;
+
+	bool										mCacheEnabled;
+	// captured results of the Source and Modifiers; immutable once created, so it may be shared between copies
+	mutable std::shared_ptr<SourceModsContext>	mCache;
+	mutable AttribSet							mCachedAttribs;
 	
 	friend class SourceModsContext;
 };
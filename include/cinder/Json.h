@@ -38,6 +38,9 @@ namespace Json {
 
 namespace cinder {
 
+class JsonReader;
+class JsonWriter;
+
 class JsonTree {
   public:
 	
@@ -102,6 +105,11 @@ class JsonTree {
 	explicit JsonTree( DataSourceRef dataSource, ParseOptions parseOptions = ParseOptions() );
 	//! Parses the JSON contained in the string \a jsonString .
 	explicit JsonTree( const std::string &jsonString, ParseOptions parseOptions = ParseOptions() );
+	/** \brief Builds a JsonTree from the value at the current event of \a reader, which is left at the last event of the value. Throws ExcJsonReader if the document is malformed.
+		Calls JsonReader::next() first if \a reader has no current event, and if the current event is a key it becomes the key of the tree. Unlike the other
+		constructors this doesn't go through JsonCpp, keeps the members of objects in document order and keeps the text of numbers as written.
+		<br><tt>JsonReader reader( loadAsset( "scene.json" ) ); JsonTree scene( reader );</tt> **/
+	explicit JsonTree( JsonReader &reader );
 	//! Creates a JsonTree with key \a key and boolean \a value .
 	explicit JsonTree( const std::string &key, bool value );
 	//! Creates a JsonTree with key \a key and double \a value .
@@ -213,6 +221,8 @@ class JsonTree {
 		If \a writeOptions creates a document then an implicit parent object node is created when necessary and \a this is treated as the root element.
 	    If \a writeOptions indents then the JSON string will be indented.**/
 	void							write( DataTargetRef target, WriteOptions writeOptions = WriteOptions() );
+	//! Writes the value of this JsonTree to \a writer, which is faster than the other variants for large trees. The key of the node itself is not written.
+	void							write( JsonWriter &writer ) const;
 
 	//! Returns the node's key as a string. Returns index if node does not have a key.
 	const std::string&				getKey() const;
@@ -263,6 +273,8 @@ private:
 	void							init( const std::string &key, const Json::Value &value, bool setType = false, 
 		NodeType nodeType = NODE_VALUE, ValueType valueType = VALUE_STRING );
 	
+	void							readValue( JsonReader &reader );
+
 	JsonTree*						getNodePtr( const std::string &relativePath, bool caseSensitive, char separator ) const;
 	static bool						isIndex( const std::string &key );
 	
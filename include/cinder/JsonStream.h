@@ -0,0 +1,221 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/DataSource.h"
+#include "cinder/DataTarget.h"
+#include "cinder/Exception.h"
+#include "cinder/Noncopyable.h"
+
+#include <boost/utility/string_ref.hpp>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace cinder {
+
+typedef std::shared_ptr<class MemoryMappedFile>	MemoryMappedFileRef;
+
+/** \brief Pull parser which reads a JSON document one event at a time, without building a tree.
+	Strings and keys are returned as views into the source data, and numbers are parsed without going through a std::string. File based DataSources are memory mapped.
+	\code
+	JsonReader reader( loadAsset( "scene.json" ) );
+	while( reader.next() != JsonReader::EVENT_END_DOCUMENT ) {
+		if( reader.getEvent() == JsonReader::EVENT_KEY && reader.getString() == "meshes" )
+			...
+	}
+	\endcode **/
+class JsonReader : private Noncopyable {
+  public:
+	//! The events returned by next().
+	enum Event { EVENT_NONE, EVENT_START_OBJECT, EVENT_END_OBJECT, EVENT_START_ARRAY, EVENT_END_ARRAY, EVENT_KEY,
+				EVENT_STRING, EVENT_NUMBER, EVENT_BOOL, EVENT_NULL, EVENT_END_DOCUMENT };
+
+	//! Reads the JSON document in \a dataSource. If \a allowComments, C and C++ style comments are treated as whitespace.
+	explicit JsonReader( const DataSourceRef &dataSource, bool allowComments = true );
+	//! Reads the JSON document in the \a size bytes at \a data, which are not copied and must outlive the JsonReader.
+	JsonReader( const char *data, size_t size, bool allowComments = true );
+	~JsonReader();
+
+	//! Advances to the next event and returns it. Throws ExcJsonReader if the document is malformed. Returns EVENT_END_DOCUMENT once the document is complete.
+	Event		next();
+	//! Returns the current event, which is EVENT_NONE before the first call to next().
+	Event		getEvent() const				{ return mEvent; }
+	//! Skips the value starting at the current event. Following EVENT_START_OBJECT or EVENT_START_ARRAY, advances to the matching end event. Following EVENT_KEY, skips the key's value. Does nothing otherwise.
+	void		skip();
+	//! Returns the number of objects and arrays enclosing the current position.
+	size_t		getDepth() const				{ return mStack.size(); }
+
+	/** Returns the current key or string with its escape sequences decoded, or the text of the current number. Strings without escape sequences
+		point directly into the source data, others remain valid until the next call to next(). **/
+	boost::string_ref	getString() const		{ return mString; }
+	//! Returns a copy of getString().
+	std::string	getStringCopy() const			{ return mString.to_string(); }
+	//! Returns the current boolean.
+	bool		getBool() const					{ return mBool; }
+	//! Returns whether the current number was written without a fraction or exponent, and fits in an int64_t or uint64_t.
+	bool		isInteger() const				{ return mNumberType != NUMBER_DOUBLE; }
+	//! Returns the current number as a double.
+	double		getDouble() const;
+	//! Returns the current number as an int64_t. Numbers which are not integers are truncated.
+	int64_t		getInt64() const;
+	//! Returns the current number as a uint64_t. Numbers which are not integers are truncated.
+	uint64_t	getUint64() const;
+	//! Returns the current number as a float.
+	float		getFloat() const				{ return (float)getDouble(); }
+	//! Returns the current number as an int.
+	int			getInt() const					{ return (int)getInt64(); }
+
+	//! Returns the offset in bytes of the current position in the source data.
+	size_t		getOffset() const				{ return mPos - mBegin; }
+
+  private:
+	enum State { STATE_VALUE, STATE_VALUE_OR_END, STATE_KEY_OR_END, STATE_COMMA_OR_END, STATE_DONE };
+	enum NumberType { NUMBER_INT, NUMBER_UINT, NUMBER_DOUBLE };
+
+	void		init( bool allowComments );
+	void		skipWhitespace();
+	Event		readValue();
+	void		readString();
+	void		readNumber();
+	void		readLiteral( const char *literal, size_t length );
+	void		throwError( const std::string &message ) const;
+
+	const char				*mBegin, *mEnd, *mPos;
+	MemoryMappedFileRef		mMappedFile;
+	BufferRef				mBuffer;
+	bool					mAllowComments;
+
+	Event					mEvent;
+	State					mState;
+	//! One entry for each enclosing container, \c true for objects
+	std::vector<bool>		mStack;
+
+	boost::string_ref		mString;
+	std::string				mUnescaped;
+	bool					mBool;
+	NumberType				mNumberType;
+	union {
+		int64_t				mInt;
+		uint64_t			mUint;
+		double				mDouble;
+	};
+};
+
+/** \brief Writes a JSON document incrementally, without building a tree first. Output is buffered and written to the target as it grows.
+	\code
+	JsonWriter writer( writeFile( "scene.json" ) );
+	writer.startObject().key( "positions" ).startArray();
+	for( const vec3 &p : positions )
+		writer.value( p.x ).value( p.y ).value( p.z );
+	writer.endArray().endObject();
+	\endcode **/
+class JsonWriter : private Noncopyable {
+  public:
+	//! Writes to \a dataTarget, indenting with tabs if \a indented.
+	explicit JsonWriter( const DataTargetRef &dataTarget, bool indented = true );
+	//! Writes to \a stream, which must outlive the JsonWriter, indenting with tabs if \a indented.
+	explicit JsonWriter( std::ostream &stream, bool indented = true );
+	//! Flushes any buffered output.
+	~JsonWriter();
+
+	//! Starts an object. Throws ExcJsonWriter if a value is not allowed at this point, as for all of the following methods.
+	JsonWriter&		startObject();
+	//! Ends the current object.
+	JsonWriter&		endObject();
+	//! Starts an array.
+	JsonWriter&		startArray();
+	//! Ends the current array.
+	JsonWriter&		endArray();
+	//! Writes the key of the next value in the current object.
+	JsonWriter&		key( const boost::string_ref &key );
+	//! Writes a string value.
+	JsonWriter&		value( const boost::string_ref &value );
+	//! Writes a string value.
+	JsonWriter&		value( const char *value )			{ return this->value( boost::string_ref( value ) ); }
+	//! Writes a string value.
+	JsonWriter&		value( const std::string &value )	{ return this->value( boost::string_ref( value ) ); }
+	//! Writes a boolean value.
+	JsonWriter&		value( bool value );
+	//! Writes an integer value.
+	JsonWriter&		value( int32_t value )				{ return this->value( (int64_t)value ); }
+	//! Writes an integer value.
+	JsonWriter&		value( uint32_t value )				{ return this->value( (uint64_t)value ); }
+	//! Writes an integer value.
+	JsonWriter&		value( int64_t value );
+	//! Writes an integer value.
+	JsonWriter&		value( uint64_t value );
+	//! Writes a number value. Infinite and NaN values, which JSON can't express, are written as null.
+	JsonWriter&		value( double value );
+	//! Writes a number value. Infinite and NaN values, which JSON can't express, are written as null.
+	JsonWriter&		value( float value );
+	//! Writes a null value.
+	JsonWriter&		nullValue();
+	//! Writes \a json as a value without validating it, for instance a number that was formatted elsewhere.
+	JsonWriter&		rawValue( const boost::string_ref &json );
+
+	//! Returns the number of objects and arrays which have been started and not yet ended.
+	size_t			getDepth() const	{ return mStack.size(); }
+	//! Writes any buffered output to the target.
+	void			flush();
+
+  private:
+	struct Level {
+		bool	mObject;
+		bool	mEmpty;
+	};
+
+	void		beginValue();
+	void		endContainer( bool object );
+	void		newLine();
+	void		appendEscaped( const boost::string_ref &s );
+	void		throwError( const std::string &message ) const;
+
+	OStreamRef			mStream;
+	std::ostream		*mStdStream;
+	std::string			mBuffer;
+	bool				mIndented;
+	std::vector<Level>	mStack;
+	bool				mHasKey;
+	bool				mDocumentStarted;
+};
+
+//! Exception thrown by JsonReader for malformed documents.
+class ExcJsonReader : public Exception {
+  public:
+	ExcJsonReader( const std::string &description )
+		: Exception( description )
+	{}
+};
+
+//! Exception thrown by JsonWriter when called in an order which would produce an invalid document.
+class ExcJsonWriter : public Exception {
+  public:
+	ExcJsonWriter( const std::string &description )
+		: Exception( description )
+	{}
+};
+
+} // namespace cinder
@@ -29,65 +29,15 @@
 #include <float.h>
 #include <stdlib.h>
 #include <algorithm>
-#include <utility>
+#include <thread>
 
 namespace cinder {
 
-// KdTree Declarations
-template<unsigned char K>
-struct KdNode {
-	void init( float p, uint32_t a) {
-		splitPos = p;
-		splitAxis = a;
-		rightChild = ~0;
-		hasLeftChild = 0;
-	}
-	void initLeaf() {
-		splitAxis = K;
-		rightChild = ~0;
-		hasLeftChild = 0;
-	}
-	// KdNode Data
-	float splitPos;
-	uint32_t splitAxis:2;
-	uint32_t hasLeftChild:1;
-	uint32_t rightChild:29;
-};
-
 struct NullLookupProc {
  public:
 	void process( uint32_t id, float distSqrd, float &maxDistSqrd ) {}
 };
 
-template <typename NodeData, unsigned char K=3, class LookupProc = NullLookupProc> class KdTree {
-public:
-	typedef std::pair<const NodeData*, uint32_t> NodeDataIndex;
-	
-	// KdTree Public Methods
-	template<typename NodeDataVector>
-	KdTree( const NodeDataVector &data );
-	KdTree() {}
-	template<typename NodeDataVector>
-	void initialize( const NodeDataVector &d );
-	~KdTree() {
-		free( nodes );
-		delete[] mNodeData;
-	}
-	void recursiveBuild( uint32_t nodeNum, uint32_t start, uint32_t end, std::vector<NodeDataIndex> &buildNodes );
-	void lookup( const NodeData &p, const LookupProc &process, float maxDist ) const;
-	void findNearest( float p[K], float result[K], uint32_t *resultIndex ) const;
-	
-private:
-	// KdTree Private Methods
-	void privateLookup(uint32_t nodeNum, float p[K], const LookupProc &process, float &maxDistSquared) const;
-	void privateFindNearest( uint32_t nodeNum, float p[K], float &maxDistSquared, float result[K], uint32_t *resultIndex ) const;
-	// KdTree Private Data
-	KdNode<K> *nodes;
-	NodeDataIndex *mNodeData;
-	uint32_t nNodes, nextFreeNode;
-};
-
-
 // Shims
 template<typename NDV>
 struct NodeDataVectorTraits
@@ -132,173 +82,378 @@ struct NodeDataTraits<vec2>
 	}
 };
 
-template<typename NodeData> struct CompareNode {
-	CompareNode( int a ) { axis = a; }
-	int axis;
-	bool operator()(const std::pair<const NodeData*,uint32_t> &d1,
-			const std::pair<const NodeData*,uint32_t> &d2) const {
-		return NodeDataTraits<NodeData>::getAxis( *d1.first, axis ) == NodeDataTraits<NodeData>::getAxis( *d2.first, axis ) ? ( d1.first < d2.first ) :
-			NodeDataTraits<NodeData>::getAxis( *d1.first, axis ) < NodeDataTraits<NodeData>::getAxis( *d2.first, axis );
-	}
+/** \brief K-dimensional tree over a set of points, for nearest neighbour and radius queries.
+ *
+ * The tree is built by splitting the widest axis at the median with std::nth_element, optionally building large subtrees on separate
+ * threads. Nodes live in one contiguous array in depth-first order, and leaves refer to buckets of up to Format::bucketSize() points whose
+ * coordinates are copied into the tree in the same order, so queries touch as little memory as possible. The tree doesn't keep a
+ * reference to the data it was built from, and results refer to points by their index in that data.
+ *
+ * Queries write into caller-supplied buffers so that they don't allocate, and the batched overloads of findNearest() and findWithinRadius()
+ * split a set of queries across threads.
+ *
+ * Example usage:
+ * \code
+ * KdTree<vec3> tree( particlePositions );
+ * uint32_t neighbors[8];
+ * float distancesSquared[8];
+ * size_t numNeighbors = tree.findNearest( particlePositions[0], 8, neighbors, distancesSquared, 10.0f );
+ * \endcode
+**/
+template <typename NodeData, unsigned char K=3, class LookupProc = NullLookupProc> class KdTree {
+  public:
+	class Format {
+	  public:
+		Format() : mBucketSize( 8 ), mParallel( true ) {}
+
+		//! Sets the maximum number of points in a leaf. Defaults to \c 8.
+		Format&		bucketSize( uint32_t size ) { mBucketSize = std::max<uint32_t>( 1, size ); return *this; }
+		//! Builds large subtrees on separate threads. Defaults to \c true.
+		Format&		parallel( bool parallel = true ) { mParallel = parallel; return *this; }
+
+		uint32_t	getBucketSize() const { return mBucketSize; }
+		bool		isParallel() const { return mParallel; }
+
+	  private:
+		uint32_t	mBucketSize;
+		bool		mParallel;
+	};
+
+	KdTree() : mBucketSize( 0 ) {}
+	//! Builds a KdTree over the points in \a data, which is typically a std::vector<NodeData>.
+	template<typename NodeDataVector>
+	KdTree( const NodeDataVector &data, const Format &format = Format() );
+
+	//! Rebuilds the tree over the points in \a data.
+	template<typename NodeDataVector>
+	void initialize( const NodeDataVector &data, const Format &format = Format() );
+
+	//! Returns the number of points in the tree.
+	size_t	getNumPoints() const { return mIndices.size(); }
+
+	//! Calls \a process.process( index, distanceSquared, maxDistanceSquared ) for every point closer than \a maxDist to \a p, which may reduce maxDistanceSquared to narrow the search.
+	void	lookup( const NodeData &p, const LookupProc &process, float maxDist ) const;
+	//! Finds the point closest to \a p, returning its coordinates in \a result and its index in \a resultIndex, which is set to \c -1 if the tree is empty.
+	void	findNearest( float p[K], float result[K], uint32_t *resultIndex ) const;
+
+	//! Finds up to \a k points closest to \a p within \a maxDistance and writes their indices and squared distances sorted by distance to \a indices and \a distancesSquared, which must hold \a k elements. Returns the number of points found.
+	size_t	findNearest( const NodeData &p, size_t k, uint32_t *indices, float *distancesSquared, float maxDistance = FLT_MAX ) const;
+	//! Finds the points within \a radius of \a p in no particular order and writes up to \a maxResults of them to \a indices and \a distancesSquared, which may be \c nullptr. Returns the number of points found, which may be larger than \a maxResults.
+	size_t	findWithinRadius( const NodeData &p, float radius, uint32_t *indices, float *distancesSquared, size_t maxResults ) const;
+	//! Appends the indices of the points within \a radius of \a p to \a indices, and their squared distances to \a distancesSquared unless it is \c nullptr.
+	void	findWithinRadius( const NodeData &p, float radius, std::vector<uint32_t> *indices, std::vector<float> *distancesSquared = nullptr ) const;
+
+	//! Runs findNearest() for each of the \a numPoints \a points across threads. The results for point \c i start at \a indices and \a distancesSquared + \c i * \a k, and unused slots have an index of \c ~0 and a distance of \c FLT_MAX. The number of points found for each query is written to \a counts unless it is \c nullptr.
+	void	findNearest( const NodeData *points, size_t numPoints, size_t k, uint32_t *indices, float *distancesSquared, size_t *counts = nullptr, float maxDistance = FLT_MAX ) const;
+	//! Runs findWithinRadius() for each of the \a numPoints \a points across threads. The results for point \c i start at \a indices and \a distancesSquared + \c i * \a maxResults, and the number of points found for each query is written to \a counts.
+	void	findWithinRadius( const NodeData *points, size_t numPoints, float radius, size_t maxResults, uint32_t *indices, float *distancesSquared, size_t *counts ) const;
+
+  private:
+	//! Interior nodes have their left child next to them, leaves have an mAxis of K.
+	struct Node {
+		float		mSplitPos;
+		uint32_t	mAxis;
+		//! Right child of interior nodes, first point of leaves
+		uint32_t	mFirst;
+		//! Number of points in leaves
+		uint32_t	mCount;
+	};
+
+	struct BuildPoint {
+		float		mPos[K];
+		uint32_t	mIndex;
+	};
+
+	static uint32_t	calcNumNodes( uint32_t numPoints, uint32_t bucketSize );
+	void			buildNode( uint32_t nodeIndex, BuildPoint *points, uint32_t begin, uint32_t end, int parallelDepth );
+	//! Calls \a visitor( point, distanceSquared, maxDistanceSquared ) for the points closer than \a maxDistanceSquared to \a p, which returns the new maxDistanceSquared.
+	template<typename Visitor>
+	void			traverse( const float p[K], float maxDistanceSquared, const Visitor &visitor ) const;
+	//! Calls \a fn( begin, end ) for ranges that cover [0, \a count) on as many threads as are worthwhile.
+	template<typename Fn>
+	static void		parallelFor( size_t count, const Fn &fn );
+
+	std::vector<Node>		mNodes;
+	//! K coordinates for each point, in tree order
+	std::vector<float>		mPoints;
+	//! Index in the source data of each point, in tree order
+	std::vector<uint32_t>	mIndices;
+	uint32_t				mBucketSize;
 };
 
 // KdTree Method Definitions
 template<typename NodeData, unsigned char K, typename LookupProc>
  template<typename NodeDataVector>
-KdTree<NodeData, K, LookupProc>::KdTree(const NodeDataVector &d)
+KdTree<NodeData, K, LookupProc>::KdTree( const NodeDataVector &d, const Format &format )
 {
-	initialize( d );
+	initialize( d, format );
 }
 
 template<typename NodeData, unsigned char K, typename LookupProc>
  template<typename NodeDataVector>
-void KdTree<NodeData, K, LookupProc>::initialize( const NodeDataVector &d )
+void KdTree<NodeData, K, LookupProc>::initialize( const NodeDataVector &d, const Format &format )
 {
-	nNodes = NodeDataVectorTraits<NodeDataVector>::getSize( d );
-	nextFreeNode = 1;
-	nodes = (KdNode<K> *)malloc(nNodes * sizeof(KdNode<K>));
-	mNodeData = new NodeDataIndex[nNodes];
-	std::vector<NodeDataIndex> buildNodes;
-	buildNodes.reserve( nNodes );
-	for( uint32_t i = 0; i < nNodes; ++i )
-		buildNodes.push_back( std::make_pair( &d[i], i ) );
-	// Begin the KdTree building process
-	recursiveBuild( 0, 0, nNodes, buildNodes );
+	const uint32_t numPoints = NodeDataVectorTraits<NodeDataVector>::getSize( d );
+	mBucketSize = format.getBucketSize();
+
+	std::vector<BuildPoint> buildPoints( numPoints );
+	for( uint32_t i = 0; i < numPoints; ++i ) {
+		for( unsigned char k = 0; k < K; ++k )
+			buildPoints[i].mPos[k] = NodeDataTraits<NodeData>::getAxis( d[i], k );
+		buildPoints[i].mIndex = i;
+	}
+
+	// the number of nodes only depends on the number of points, so every subtree's place in the array is known up front
+	mNodes.assign( numPoints ? calcNumNodes( numPoints, mBucketSize ) : 0, Node() );
+	if( numPoints ) {
+		int parallelDepth = 0;
+		if( format.isParallel() ) {
+			for( unsigned int threads = 1; threads < std::thread::hardware_concurrency(); threads *= 2 )
+				parallelDepth++;
+		}
+		buildNode( 0, buildPoints.data(), 0, numPoints, parallelDepth );
+	}
+
+	mPoints.resize( numPoints * K );
+	mIndices.resize( numPoints );
+	for( uint32_t i = 0; i < numPoints; ++i ) {
+		std::copy( buildPoints[i].mPos, buildPoints[i].mPos + K, &mPoints[i * K] );
+		mIndices[i] = buildPoints[i].mIndex;
+	}
 }
 
 template<typename NodeData, unsigned char K, typename LookupProc>
-void KdTree<NodeData, K, LookupProc>::recursiveBuild( uint32_t nodeNum, uint32_t start, uint32_t end, std::vector<NodeDataIndex> &buildNodes )
+uint32_t KdTree<NodeData, K, LookupProc>::calcNumNodes( uint32_t numPoints, uint32_t bucketSize )
 {
-	// Create leaf node of kd-tree if we've reached the bottom
-	if( start + 1 == end) {
-		nodes[nodeNum].initLeaf();
-		mNodeData[nodeNum] = buildNodes[start];
+	if( numPoints <= bucketSize )
+		return 1;
+
+	return 1 + calcNumNodes( numPoints / 2, bucketSize ) + calcNumNodes( numPoints - numPoints / 2, bucketSize );
+}
+
+template<typename NodeData, unsigned char K, typename LookupProc>
+void KdTree<NodeData, K, LookupProc>::buildNode( uint32_t nodeIndex, BuildPoint *points, uint32_t begin, uint32_t end, int parallelDepth )
+{
+	Node &node = mNodes[nodeIndex];
+	const uint32_t count = end - begin;
+	if( count <= mBucketSize ) {
+		node.mSplitPos = 0;
+		node.mAxis = K;
+		node.mFirst = begin;
+		node.mCount = count;
 		return;
 	}
-	// Choose split direction and partition data
-	// Compute bounds of data from _start_ to _end_
+
+	// split the widest axis at the median
 	float boundMin[K], boundMax[K];
 	for( unsigned char k = 0; k < K; ++k ) {
 		boundMin[k] = FLT_MAX;
-		boundMax[k] = FLT_MIN;
+		boundMax[k] = -FLT_MAX;
 	}
-	
-	for( uint32_t i = start; i < end; ++i ) {
-		for( uint8_t axis = 0; axis < K; axis++ ) {
-			// NOT Compiling? you should define NOMINMAX
-			boundMin[axis] = std::min( boundMin[axis], NodeDataTraits<NodeData>::getAxis( *buildNodes[i].first, axis ) );
-			boundMax[axis] = std::max( boundMax[axis], NodeDataTraits<NodeData>::getAxis( *buildNodes[i].first, axis ) );
+	for( uint32_t i = begin; i < end; ++i ) {
+		for( unsigned char k = 0; k < K; ++k ) {
+			boundMin[k] = std::min( boundMin[k], points[i].mPos[k] );
+			boundMax[k] = std::max( boundMax[k], points[i].mPos[k] );
 		}
 	}
-	int splitAxis = 0;
-	float maxExtent = boundMax[0] - boundMin[0];
+	uint32_t axis = 0;
 	for( unsigned char k = 1; k < K; ++k ) {
-		if( boundMax[k] - boundMin[k] > maxExtent ) {
-			splitAxis = k;
-			maxExtent = boundMax[k] - boundMin[k];
-		}	
+		if( boundMax[k] - boundMin[k] > boundMax[axis] - boundMin[axis] )
+			axis = k;
 	}
-	uint32_t splitPos = ( start + end ) / 2;
-	std::nth_element( &buildNodes[start], &buildNodes[splitPos], &buildNodes[end-1] + 1, CompareNode<NodeData>(splitAxis) );
-	// Allocate kd-tree node and continue recursively
-	nodes[nodeNum].init( NodeDataTraits<NodeData>::getAxis( *buildNodes[splitPos].first, splitAxis ), splitAxis );
-	mNodeData[nodeNum] = buildNodes[splitPos];
-	if( start < splitPos ) {
-		nodes[nodeNum].hasLeftChild = 1;
-		uint32_t childNum = nextFreeNode++;
-		recursiveBuild( childNum, start, splitPos, buildNodes );
+
+	const uint32_t middle = begin + count / 2;
+	std::nth_element( points + begin, points + middle, points + end, [axis]( const BuildPoint &a, const BuildPoint &b ) {
+		return a.mPos[axis] < b.mPos[axis];
+	} );
+
+	node.mSplitPos = points[middle].mPos[axis];
+	node.mAxis = axis;
+	node.mFirst = nodeIndex + 1 + calcNumNodes( middle - begin, mBucketSize );
+	node.mCount = 0;
+
+	const uint32_t right = node.mFirst;
+	if( parallelDepth > 0 && count > 65536 ) {
+		std::thread left( &KdTree::buildNode, this, nodeIndex + 1, points, begin, middle, parallelDepth - 1 );
+		buildNode( right, points, middle, end, parallelDepth - 1 );
+		left.join();
 	}
-	if( splitPos + 1 < end ) {
-		nodes[nodeNum].rightChild = nextFreeNode++;
-		recursiveBuild( nodes[nodeNum].rightChild, splitPos + 1, end, buildNodes );
+	else {
+		buildNode( nodeIndex + 1, points, begin, middle, 0 );
+		buildNode( right, points, middle, end, 0 );
 	}
 }
 
+template<typename NodeData, unsigned char K, typename LookupProc>
+ template<typename Visitor>
+void KdTree<NodeData, K, LookupProc>::traverse( const float p[K], float maxDistanceSquared, const Visitor &visitor ) const
+{
+	if( mNodes.empty() )
+		return;
+
+	// every level of the tree adds at most one entry, and a tree over 2^32 points is at most 33 levels deep
+	struct Entry {
+		uint32_t	mNode;
+		float		mDistanceSquared;
+	};
+	Entry stack[64];
+	size_t stackSize = 0;
+	stack[stackSize++] = Entry{ 0, 0 };
+	while( stackSize ) {
+		const Entry entry = stack[--stackSize];
+		if( entry.mDistanceSquared >= maxDistanceSquared )
+			continue;
+
+		// descend to the leaf on the side of \a p, deferring the other children for as long as they are close enough
+		uint32_t nodeIndex = entry.mNode;
+		while( mNodes[nodeIndex].mAxis != K ) {
+			const Node &node = mNodes[nodeIndex];
+			const float diff = p[node.mAxis] - node.mSplitPos;
+			if( diff * diff < maxDistanceSquared )
+				stack[stackSize++] = Entry{ ( diff <= 0 ) ? node.mFirst : nodeIndex + 1, diff * diff };
+			nodeIndex = ( diff <= 0 ) ? nodeIndex + 1 : node.mFirst;
+		}
+
+		const Node &leaf = mNodes[nodeIndex];
+		const float *point = &mPoints[leaf.mFirst * K];
+		for( uint32_t i = 0; i < leaf.mCount; ++i, point += K ) {
+			float distanceSquared = 0;
+			for( unsigned char k = 0; k < K; ++k )
+				distanceSquared += ( point[k] - p[k] ) * ( point[k] - p[k] );
+			if( distanceSquared < maxDistanceSquared )
+				maxDistanceSquared = visitor( leaf.mFirst + i, distanceSquared, maxDistanceSquared );
+		}
+	}
+}
+
+template<typename NodeData, unsigned char K, typename LookupProc>
+ template<typename Fn>
+void KdTree<NodeData, K, LookupProc>::parallelFor( size_t count, const Fn &fn )
+{
+	// queries are cheap, so only spread them across threads when there are enough of them to pay for the threads
+	const size_t minPerThread = 1024;
+	const size_t numThreads = std::max<size_t>( 1, std::min<size_t>( std::thread::hardware_concurrency(), count / minPerThread ) );
+	if( numThreads == 1 ) {
+		fn( 0, count );
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	for( size_t t = 1; t < numThreads; ++t )
+		threads.push_back( std::thread( fn, count * t / numThreads, count * ( t + 1 ) / numThreads ) );
+	fn( 0, count / numThreads );
+	for( auto &thread : threads )
+		thread.join();
+}
+
 template<typename NodeData, unsigned char K, typename LookupProc>
 void KdTree<NodeData, K, LookupProc>::lookup( const NodeData &p, const LookupProc &proc, float maxDist ) const 
 {
-	float maxDistSqrd = maxDist * maxDist;
 	float pt[K];
 	for( unsigned char k = 0; k < K; ++k )
 		pt[k] = NodeDataTraits<NodeData>::getAxis( p, k );
 
-	privateLookup( 0, pt, proc, maxDistSqrd );
+	traverse( pt, maxDist * maxDist, [&]( uint32_t point, float distanceSquared, float maxDistanceSquared ) {
+		proc.process( mIndices[point], distanceSquared, maxDistanceSquared );
+		return maxDistanceSquared;
+	} );
 }
 
 template<typename NodeData, unsigned char K, typename LookupProc>
-void KdTree<NodeData, K, LookupProc>::privateLookup( uint32_t nodeNum, float p[K], const LookupProc &process, float &maxDistSquared ) const 
+void KdTree<NodeData, K, LookupProc>::findNearest( float p[K], float result[K], uint32_t *resultIndex ) const
+{
+	*resultIndex = -1;
+	traverse( p, FLT_MAX, [&]( uint32_t point, float distanceSquared, float maxDistanceSquared ) {
+		std::copy( &mPoints[point * K], &mPoints[point * K] + K, result );
+		*resultIndex = mIndices[point];
+		return distanceSquared;
+	} );
+}
+
+template<typename NodeData, unsigned char K, typename LookupProc>
+size_t KdTree<NodeData, K, LookupProc>::findNearest( const NodeData &p, size_t k, uint32_t *indices, float *distancesSquared, float maxDistance ) const
 {
-	KdNode<K> *node = &nodes[nodeNum];
-	// process kd-tree node's children
-	int axis = node->splitAxis;
-	if( axis != K ) {
-		float dist2 = ( p[axis] - node->splitPos ) * ( p[axis] - node->splitPos );
-		if( p[axis] <= node->splitPos ) {
-			if(node->hasLeftChild)
-				privateLookup( nodeNum + 1, p, process, maxDistSquared );
-			if( ( dist2 < maxDistSquared ) && ( node->rightChild < nNodes ) )
-				privateLookup( node->rightChild, p, process, maxDistSquared );
+	if( k == 0 )
+		return 0;
+
+	float pt[K];
+	for( unsigned char a = 0; a < K; ++a )
+		pt[a] = NodeDataTraits<NodeData>::getAxis( p, a );
+
+	// keep the results sorted by insertion, which beats a heap for the small k typical of neighbour searches
+	size_t count = 0;
+	traverse( pt, maxDistance * maxDistance, [&]( uint32_t point, float distanceSquared, float maxDistanceSquared ) {
+		size_t i = ( count < k ) ? count++ : k - 1;
+		for( ; i > 0 && distancesSquared[i - 1] > distanceSquared; --i ) {
+			distancesSquared[i] = distancesSquared[i - 1];
+			indices[i] = indices[i - 1];
 		}
-		else {
-			if( node->rightChild < nNodes )
-				privateLookup( node->rightChild, p, process, maxDistSquared );
-			if( ( dist2 < maxDistSquared ) && node->hasLeftChild )
-				privateLookup( nodeNum + 1, p, process, maxDistSquared );
+		distancesSquared[i] = distanceSquared;
+		indices[i] = mIndices[point];
+		return ( count == k ) ? distancesSquared[k - 1] : maxDistanceSquared;
+	} );
+
+	return count;
+}
+
+template<typename NodeData, unsigned char K, typename LookupProc>
+size_t KdTree<NodeData, K, LookupProc>::findWithinRadius( const NodeData &p, float radius, uint32_t *indices, float *distancesSquared, size_t maxResults ) const
+{
+	float pt[K];
+	for( unsigned char k = 0; k < K; ++k )
+		pt[k] = NodeDataTraits<NodeData>::getAxis( p, k );
+
+	size_t count = 0;
+	traverse( pt, radius * radius, [&]( uint32_t point, float distanceSquared, float maxDistanceSquared ) {
+		if( count < maxResults ) {
+			if( indices )
+				indices[count] = mIndices[point];
+			if( distancesSquared )
+				distancesSquared[count] = distanceSquared;
 		}
-	}
-	// Hand kd-tree node to processing function
-	float distSqr = 0.0f;
-	for( unsigned char k = 0; k < K; ++k ) {
-		float v = NodeDataTraits<NodeData>::getAxis( *mNodeData[nodeNum].first, k ) - p[k];
-		distSqr += v * v;
-	}
-	
-	if( distSqr < maxDistSquared )
-		process.process( mNodeData[nodeNum].second, distSqr, maxDistSquared );
+		count++;
+		return maxDistanceSquared;
+	} );
+
+	return count;
 }
 
-// Find Nearest
 template<typename NodeData, unsigned char K, typename LookupProc>
-void KdTree<NodeData, K, LookupProc>::findNearest( float p[K], float result[K], uint32_t *resultIndex ) const
+void KdTree<NodeData, K, LookupProc>::findWithinRadius( const NodeData &p, float radius, std::vector<uint32_t> *indices, std::vector<float> *distancesSquared ) const
 {
-	float maxDist = FLT_MAX;
-	*resultIndex = -1;
-	privateFindNearest( 0, p, maxDist, result, resultIndex );
+	float pt[K];
+	for( unsigned char k = 0; k < K; ++k )
+		pt[k] = NodeDataTraits<NodeData>::getAxis( p, k );
+
+	traverse( pt, radius * radius, [&]( uint32_t point, float distanceSquared, float maxDistanceSquared ) {
+		indices->push_back( mIndices[point] );
+		if( distancesSquared )
+			distancesSquared->push_back( distanceSquared );
+		return maxDistanceSquared;
+	} );
 }
 
 template<typename NodeData, unsigned char K, typename LookupProc>
-void KdTree<NodeData, K, LookupProc>::privateFindNearest( uint32_t nodeNum, float p[K], float &maxDistSquared, float result[K], uint32_t *resultIndex ) const
+void KdTree<NodeData, K, LookupProc>::findNearest( const NodeData *points, size_t numPoints, size_t k, uint32_t *indices, float *distancesSquared, size_t *counts, float maxDistance ) const
 {
-	KdNode<K> *node = &nodes[nodeNum];
-	// process kd-tree node's children
-	int axis = node->splitAxis;
-	if( axis != K ) {
-		float dist2 = (p[axis] - node->splitPos) * (p[axis] - node->splitPos);
-		if( p[axis] <= node->splitPos ) {
-			if( node->hasLeftChild )
-				privateFindNearest( nodeNum+1, p, maxDistSquared, result, resultIndex );
-			if( ( dist2 < maxDistSquared ) && ( node->rightChild < nNodes) )
-				privateFindNearest( node->rightChild, p, maxDistSquared, result, resultIndex );
-		}
-		else {
-			if( node->rightChild < nNodes)
-				privateFindNearest(node->rightChild,
-				              p,
-							  maxDistSquared, result, resultIndex );
-			if( dist2 < maxDistSquared && node->hasLeftChild)
-				privateFindNearest(nodeNum+1,
-				              p,
-							  maxDistSquared, result, resultIndex );
+	parallelFor( numPoints, [=]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i ) {
+			const size_t count = findNearest( points[i], k, indices + i * k, distancesSquared + i * k, maxDistance );
+			std::fill( indices + i * k + count, indices + ( i + 1 ) * k, ~0u );
+			std::fill( distancesSquared + i * k + count, distancesSquared + ( i + 1 ) * k, FLT_MAX );
+			if( counts )
+				counts[i] = count;
 		}
-	}
-	
-	float distSqr = NodeDataTraits<NodeData>::distanceSquared( *mNodeData[nodeNum].first, p );
-	if( distSqr < maxDistSquared ) {
-		maxDistSquared = distSqr;
-		for( unsigned char k = 0; k < K; ++k )
-			result[k] = NodeDataTraits<NodeData>::getAxis( *mNodeData[nodeNum].first, k );
-		*resultIndex = mNodeData[nodeNum].second;
-	}
+	} );
+}
+
+template<typename NodeData, unsigned char K, typename LookupProc>
+void KdTree<NodeData, K, LookupProc>::findWithinRadius( const NodeData *points, size_t numPoints, float radius, size_t maxResults, uint32_t *indices, float *distancesSquared, size_t *counts ) const
+{
+	parallelFor( numPoints, [=]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			counts[i] = findWithinRadius( points[i], radius, indices + i * maxResults, distancesSquared ? distancesSquared + i * maxResults : nullptr, maxResults );
+	} );
 }
 
 } // namespace ci
@@ -215,7 +215,23 @@ public:
 	std::vector<LoggerRef> getAllLoggers();
 	//! Returns the mutex used for thread safe logging.
 	std::mutex& getMutex() const			{ return mMutex; }
-	
+
+	//! \brief Enables asynchronous logging, in which log calls only copy their record into a buffer of the calling thread and return.
+	//!
+	//! A background thread formats the buffered records and writes them to the Loggers, so that logging from the audio thread or worker threads
+	//! never waits on a lock or on disk. Each thread's buffer holds \a bufferSize bytes and is allocated on its first log call. Records which don't fit
+	//! are dropped and counted by getNumDroppedRecords(). Records of LEVEL_FATAL are flushed before the call returns. If \a flushOnCrash is \c true,
+	//! handlers for fatal signals write out the buffered records before passing the signal on to the previous handler.
+	void		enableAsync( size_t bufferSize = 64 * 1024, bool flushOnCrash = true );
+	//! Writes out all buffered records, stops the background thread and returns to synchronous logging.
+	void		disableAsync();
+	//! Returns whether asynchronous logging is enabled.
+	bool		isAsyncEnabled() const;
+	//! Blocks until all records logged before the call have been written to the Loggers. Does nothing when logging synchronously.
+	void		flush();
+	//! Returns the number of records dropped because the buffer of the logging thread was full.
+	uint64_t	getNumDroppedRecords() const;
+
 	void write( const Metadata &meta, const std::string &text );
 	
 	template<typename LoggerT, typename... Args>
@@ -226,10 +242,14 @@ public:
 	
 protected:
 	LogManager();
+	~LogManager();
+
+	class AsyncWriter;
 
 	std::vector<LoggerRef>			mLoggers;
 	
 	mutable std::mutex				mMutex;
+	std::unique_ptr<AsyncWriter>	mAsyncWriter;
 	
 	static LogManager 				*sInstance;
 };
@@ -0,0 +1,70 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Exception.h"
+#include "cinder/Filesystem.h"
+#include "cinder/Noncopyable.h"
+
+namespace cinder {
+
+typedef std::shared_ptr<class MemoryMappedFile>	MemoryMappedFileRef;
+
+//! Maps the contents of a file into memory for reading, so that it can be accessed without copying it into a Buffer first.
+//! The mapping is released when the MemoryMappedFile is destroyed. Empty files result in a null data pointer and a size of zero.
+class MemoryMappedFile : private Noncopyable {
+  public:
+	//! Maps the file at \a path for reading. Throws ExcMemoryMappedFile on failure.
+	static MemoryMappedFileRef	create( const fs::path &path )	{ return MemoryMappedFileRef( new MemoryMappedFile( path ) ); }
+
+	~MemoryMappedFile();
+
+	//! Returns a pointer to the mapped contents of the file.
+	const void*		getData() const		{ return mData; }
+	//! Returns the size of the mapped file in bytes.
+	size_t			getSize() const		{ return mSize; }
+	//! Returns the path of the mapped file.
+	const fs::path&	getFilePath() const	{ return mFilePath; }
+
+  private:
+	MemoryMappedFile( const fs::path &path );
+
+	fs::path	mFilePath;
+	const void*	mData;
+	size_t		mSize;
+#if defined( CINDER_MSW )
+	void*		mFileHandle;
+	void*		mMappingHandle;
+#endif
+};
+
+class ExcMemoryMappedFile : public Exception {
+  public:
+	ExcMemoryMappedFile( const fs::path &path )
+		: Exception( "Failed to map file into memory: " + path.string() )
+	{}
+};
+
+} // namespace cinder
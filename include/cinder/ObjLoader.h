@@ -29,7 +29,6 @@
 #include "cinder/DataTarget.h"
 #include "cinder/GeomIo.h"
 
-#include <tuple>
 #include <map>
 
 namespace cinder {
@@ -43,6 +42,8 @@ namespace cinder {
  * myCubeRef = gl::Batch::create( loader, gl::getStockShader( gl::ShaderDef().color() ) );
  * myCubeRef->draw();
  * \endcode
+ *
+ * File-based DataSources are memory-mapped, and large files are split into chunks that are parsed in parallel.
 **/
 
 class ObjLoader : public geom::Source {
@@ -91,18 +92,23 @@ class ObjLoader : public geom::Source {
         float		Kd[3];
     };
     
+	//! A polygon of a Group. Its attribute indices are stored contiguously in the Group's index arrays, starting at \a mFirstIndex.
 	struct Face {
 		int						mNumVertices;
-		std::vector<int32_t>	mVertexIndices;
-		std::vector<int32_t>	mTexCoordIndices;
-		std::vector<int32_t>	mNormalIndices;
+		uint32_t				mFirstIndex;
 		const Material*			mMaterial;
 	};
 
 	struct Group {
+		Group()
+			: mBaseVertexOffset( 0 ), mBaseTexCoordOffset( 0 ), mBaseNormalOffset( 0 ), mHasTexCoords( false ), mHasNormals( false )
+		{}
+
 		std::string				mName;
 		int32_t					mBaseVertexOffset, mBaseTexCoordOffset, mBaseNormalOffset;
 		std::vector<Face>		mFaces;
+		//! Zero-based position, texture coordinate and normal indices of all faces. A missing index is stored as -1, and the tex coord and normal arrays are empty when no face of the group has them.
+		std::vector<int32_t>	mVertexIndices, mTexCoordIndices, mNormalIndices;
 		bool					mHasTexCoords;
 		bool					mHasNormals;
 	};
@@ -122,21 +128,15 @@ class ObjLoader : public geom::Source {
 	Source*			clone() const override { return new ObjLoader( *this ); }
 
   private:
-	typedef std::tuple<int,int> VertexPair;
-	typedef std::tuple<int,int,int> VertexTriple;
+	struct UniqueVertexMap;
 
-	void	parse( bool includeNormals, bool includeTexCoords );
- 	void	parseFace( Group *group, const Material *material, const std::string &s, bool includeNormals, bool includeTexCoords );
+	void	parse( const char *data, size_t dataSize, bool includeNormals, bool includeTexCoords );
     void    parseMaterial( std::shared_ptr<IStreamCinder> material );
 
 	void	load() const;
 
-	void	loadGroupNormalsTextures( const Group &group, std::map<VertexTriple,int> &uniqueVerts ) const;
-	void	loadGroupNormals( const Group &group, std::map<VertexPair,int> &uniqueVerts ) const;
-	void	loadGroupTextures( const Group &group, std::map<VertexPair,int> &uniqueVerts ) const;
-	void	loadGroup( const Group &group, std::map<int,int> &uniqueVerts ) const;
-
-	std::shared_ptr<IStreamCinder>	mStream;
+	void	loadGroup( const Group &group, bool normals, bool texCoords, UniqueVertexMap *uniqueVerts ) const;
+	void	removeDuplicateOutputVertices() const;
 
 	std::vector<vec3>			    mInternalVertices, mInternalNormals;
 	std::vector<vec2>			    mInternalTexCoords;
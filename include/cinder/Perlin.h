@@ -24,6 +24,7 @@
 
 #include "cinder/Cinder.h"
 #include "cinder/Vector.h"
+#include "cinder/Channel.h"
 
 namespace cinder {
 
@@ -51,6 +52,18 @@ class Perlin
 	vec3	dfBm( const vec3 &v ) const;
 	vec3	dfBm( float x, float y, float z ) const { return dfBm( vec3( x, y, z ) ); }
 
+	/// Batched fBm() and dfBm() of \a count \a positions into \a result. Points are evaluated four at a time with SSE2 where available, and spread across threads if \a parallel. The results are identical to those of the single point versions.
+	void	fBm( const vec2 *positions, size_t count, float *result, bool parallel = false ) const;
+	void	fBm( const vec3 *positions, size_t count, float *result, bool parallel = false ) const;
+	void	dfBm( const vec2 *positions, size_t count, vec2 *result, bool parallel = false ) const;
+	void	dfBm( const vec3 *positions, size_t count, vec3 *result, bool parallel = false ) const;
+	/// Batched fBm() over a grid of \a size points into \a result, in rows along x. The point at ( i, j ) is <tt>origin + step * vec2( i, j )</tt>.
+	void	fBm( const ivec2 &size, const vec2 &origin, const vec2 &step, float *result, bool parallel = false ) const;
+	/// Batched fBm() over a grid of \a size points into \a result, in rows along x and then slices along y. The point at ( i, j, k ) is <tt>origin + step * vec3( i, j, k )</tt>.
+	void	fBm( const ivec3 &size, const vec3 &origin, const vec3 &step, float *result, bool parallel = false ) const;
+	/// Batched fBm() into every pixel of \a channel, where the pixel at ( i, j ) is <tt>origin + step * vec2( i, j )</tt>.
+	void	fBm( Channel32f *channel, const vec2 &origin, const vec2 &step, bool parallel = false ) const;
+
 	/// Calculates a single octave of noise
 	float	noise( float x ) const;
 	float	noise( float x, float y ) const;
@@ -65,6 +78,9 @@ class Perlin
 
  private:
 	void	initPermutationTable();
+	/// Evaluates fBm() at \a count points spaced by \a stepX along x from \a start
+	void	fBmRow( const vec2 &start, float stepX, size_t count, float *result ) const;
+	void	fBmRow( const vec3 &start, float stepX, size_t count, float *result ) const;
 
 	float grad( int32_t hash, float x ) const;
 	float grad( int32_t hash, float x, float y ) const;
@@ -74,14 +74,14 @@ class PolyLineT {
 	//! Returns the centroid or "center of mass" of the polygon. Assumes closed and no self-intersections.
 	T		calcCentroid() const;
 
-	//! Calculates the boolean union of \a a and \a b. Assumes the first PolyLine in the vector is the outermost and the (optional) others are holes.
-	static std::vector<PolyLineT> 	calcUnion( const std::vector<PolyLineT> &a, std::vector<PolyLineT> &b );
-	//! Calculates the boolean intersection of \a a and \a b. Assumes the first PolyLine in the vector is the outermost and the (optional) others are holes.
-	static std::vector<PolyLineT> 	calcIntersection( const std::vector<PolyLineT> &a, std::vector<PolyLineT> &b );
-	//! Calculates the boolean XOR (symmetric difference) of \a a and \a b. Assumes the first PolyLine in the vector is the outermost and the (optional) others are holes.
-	static std::vector<PolyLineT> 	calcXor( const std::vector<PolyLineT> &a, std::vector<PolyLineT> &b );
-	//! Calculates the boolean difference of \a a and \a b. Assumes the first PolyLine in the vector is the outermost and the (optional) others are holes.
-	static std::vector<PolyLineT> 	calcDifference( const std::vector<PolyLineT> &a, std::vector<PolyLineT> &b );
+	//! Calculates the boolean union of \a a and \a b. The contours of each are combined by the even-odd rule, so the first PolyLine is typically the outermost and the (optional) others are holes. See PolygonClipper for other winding rules and for reusing memory across calls.
+	static std::vector<PolyLineT> 	calcUnion( const std::vector<PolyLineT> &a, const std::vector<PolyLineT> &b );
+	//! Calculates the boolean intersection of \a a and \a b. The contours of each are combined by the even-odd rule, so the first PolyLine is typically the outermost and the (optional) others are holes.
+	static std::vector<PolyLineT> 	calcIntersection( const std::vector<PolyLineT> &a, const std::vector<PolyLineT> &b );
+	//! Calculates the boolean XOR (symmetric difference) of \a a and \a b. The contours of each are combined by the even-odd rule, so the first PolyLine is typically the outermost and the (optional) others are holes.
+	static std::vector<PolyLineT> 	calcXor( const std::vector<PolyLineT> &a, const std::vector<PolyLineT> &b );
+	//! Calculates the boolean difference of \a a and \a b. The contours of each are combined by the even-odd rule, so the first PolyLine is typically the outermost and the (optional) others are holes.
+	static std::vector<PolyLineT> 	calcDifference( const std::vector<PolyLineT> &a, const std::vector<PolyLineT> &b );
 
 	friend std::ostream& operator<<( std::ostream& lhs, const PolyLineT& rhs )
 	{
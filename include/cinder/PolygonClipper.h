@@ -0,0 +1,107 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/PolyLine.h"
+#include "cinder/Shape2d.h"
+#include "cinder/Path2d.h"
+
+#include <vector>
+
+namespace cinder {
+
+//! Computes boolean operations and offsets of polygons, given as PolyLines or as flattened Path2d and Shape2d contours. Contours are added to either the subject or
+//! the clip of an operation and may self-intersect and overlap each other freely; which regions they enclose is determined by a Winding rule. The edges are split
+//! against each other once and the result is reused by every subsequent calc() until contours are added or cleared, and all memory is kept across clear(), so a single
+//! PolygonClipper can evaluate several operations per frame without allocating.
+class PolygonClipper {
+  public:
+	typedef enum Operation { OPERATION_UNION, OPERATION_INTERSECTION, OPERATION_DIFFERENCE, OPERATION_XOR } Operation;
+	typedef enum Winding { WINDING_ODD, WINDING_NONZERO, WINDING_POSITIVE, WINDING_NEGATIVE } Winding;
+	typedef enum Join { JOIN_ROUND, JOIN_MITER, JOIN_SQUARE } Join;
+
+	//! Default constructor
+	PolygonClipper();
+
+	//! Adds \a polyLine to the subject. It is always treated as closed.
+	void		addSubject( const PolyLine2f &polyLine );
+	//! Adds \a polyLine to the subject. It is always treated as closed.
+	void		addSubject( const PolyLine2d &polyLine );
+	//! Adds each of \a polyLines to the subject.
+	void		addSubject( const std::vector<PolyLine2f> &polyLines );
+	//! Adds the contours of \a shape to the subject. \a approximationScale represents how smooth the flattening is, with 1.0 corresponding to 1:1 with screen space
+	void		addSubject( const Shape2d &shape, float approximationScale = 1.0f );
+	//! Adds \a path to the subject. \a approximationScale represents how smooth the flattening is, with 1.0 corresponding to 1:1 with screen space
+	void		addSubject( const Path2d &path, float approximationScale = 1.0f );
+	//! Adds \a polyLine to the clip. It is always treated as closed.
+	void		addClip( const PolyLine2f &polyLine );
+	//! Adds \a polyLine to the clip. It is always treated as closed.
+	void		addClip( const PolyLine2d &polyLine );
+	//! Adds each of \a polyLines to the clip.
+	void		addClip( const std::vector<PolyLine2f> &polyLines );
+	//! Adds the contours of \a shape to the clip. \a approximationScale represents how smooth the flattening is, with 1.0 corresponding to 1:1 with screen space
+	void		addClip( const Shape2d &shape, float approximationScale = 1.0f );
+	//! Adds \a path to the clip. \a approximationScale represents how smooth the flattening is, with 1.0 corresponding to 1:1 with screen space
+	void		addClip( const Path2d &path, float approximationScale = 1.0f );
+	//! Removes all contours, keeping the allocated memory for reuse
+	void		clear();
+
+	//! Returns the result of \a operation on the subject and clip as closed PolyLines without self-intersections. Outer contours are counterclockwise and holes clockwise.
+	std::vector<PolyLine2f>	calc( Operation operation, Winding winding = WINDING_ODD );
+	//! Replaces the contents of \a result with the result of \a operation, reusing the memory of its PolyLines.
+	void		calc( Operation operation, std::vector<PolyLine2f> *result, Winding winding = WINDING_ODD );
+	//! Replaces the contents of \a result with the result of \a operation, reusing the memory of its PolyLines.
+	void		calc( Operation operation, std::vector<PolyLine2d> *result, Winding winding = WINDING_ODD );
+
+	//! Returns the union of all contours, subject and clip alike, inflated by \a delta, or deflated if \a delta is negative. Corners which grow are joined according to \a join.
+	std::vector<PolyLine2f>	calcOffset( float delta, Join join = JOIN_ROUND, Winding winding = WINDING_ODD );
+	//! Replaces the contents of \a result with the union of all contours offset by \a delta, reusing the memory of its PolyLines.
+	void		calcOffset( float delta, std::vector<PolyLine2f> *result, Join join = JOIN_ROUND, Winding winding = WINDING_ODD );
+
+	//! Sets the ratio of the distance of a JOIN_MITER corner from its vertex to the offset beyond which it is squared off instead. Default is \c 2.
+	void		setMiterLimit( float limit ) { mMiterLimit = limit; }
+	//! Returns the ratio of the distance of a JOIN_MITER corner from its vertex to the offset beyond which it is squared off instead.
+	float		getMiterLimit() const { return mMiterLimit; }
+	//! Sets the maximum distance of the segments of a JOIN_ROUND corner from the true arc. Default is \c 0.25.
+	void		setArcTolerance( float tolerance ) { mArcTolerance = tolerance; }
+	//! Returns the maximum distance of the segments of a JOIN_ROUND corner from the true arc.
+	float		getArcTolerance() const { return mArcTolerance; }
+
+  protected:
+	struct Arrangement;
+
+	template<typename T>
+	void		addContour( const T *points, size_t numPoints, bool clip );
+	//! Splits the edges against each other and calculates their windings, unless that has already been done for the current contours.
+	void		prepare();
+	template<typename T>
+	void		copyLoops( const Arrangement &arrangement, std::vector<PolyLineT<T>> *result ) const;
+
+	float							mMiterLimit, mArcTolerance;
+	bool							mPrepared;
+	std::shared_ptr<Arrangement>	mArrangement, mOffsetArrangement;
+};
+
+} // namespace cinder
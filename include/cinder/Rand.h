@@ -248,6 +248,143 @@ class Rand {
 	static std::uniform_real_distribution<float> sFloatGen;
 };
 
+//! A counter-based random generator (Philox4x32-10), whose value at any position of a sequence can be computed directly. Each combination of seed and stream is an
+//! independent sequence and discard() skips ahead in constant time, so threads can draw from their own streams of a shared seed without any synchronization.
+//! The fill*() functions generate whole arrays with SSE2 where available, consuming the sequence exactly like the equivalent calls of the next*() functions.
+class Philox {
+  public:
+	typedef uint32_t	result_type;
+
+	Philox( uint64_t seed = 0, uint64_t stream = 0 )
+	{
+		this->seed( seed, stream );
+	}
+
+	//! Re-seeds the generator and restarts it at the beginning of \a stream
+	void seed( uint64_t seed, uint64_t stream = 0 )
+	{
+		mKey[0] = (uint32_t)seed;
+		mKey[1] = (uint32_t)( seed >> 32 );
+		mStream = stream;
+		mBlock = 0;
+		mIndex = 4;
+		mHasSpareGaussian = false;
+	}
+
+	//! Skips the next \a count 32-bit values of the sequence in constant time
+	void discard( uint64_t count );
+	//! Returns the number of 32-bit values consumed from the sequence so far
+	uint64_t getPosition() const	{ return mBlock * 4 - ( 4 - mIndex ); }
+	uint64_t getStream() const		{ return mStream; }
+
+	//! Returns the next 32-bit value, so that Philox can be used with the standard library's distributions
+	uint32_t operator()()			{ return nextUint(); }
+	// parenthesized against the min and max macros of windows.h
+#if defined( _MSC_VER ) && ( _MSC_VER < 1900 )
+	static uint32_t (min)()				{ return 0; }
+	static uint32_t (max)()				{ return 0xFFFFFFFF; }
+#else
+	static constexpr uint32_t (min)()	{ return 0; }
+	static constexpr uint32_t (max)()	{ return 0xFFFFFFFF; }
+#endif
+
+	//! returns a random boolean value
+	bool nextBool()
+	{
+		return nextUint() & 1;
+	}
+
+	//! returns a random integer in the range [-2147483648,2147483647]
+	int32_t nextInt()
+	{
+		return (int32_t)nextUint();
+	}
+
+	//! returns a random integer in the range [0,4294967296)
+	uint32_t nextUint()
+	{
+		if( mIndex == 4 )
+			generateBlock();
+		return mBuffer[mIndex++];
+	}
+
+	//! returns a random integer in the range [0,v)
+	int32_t nextInt( int32_t v )
+	{
+		if( v <= 0 ) return 0;
+		return nextUint() % v;
+	}
+
+	//! returns a random integer in the range [0,v)
+	uint32_t nextUint( uint32_t v )
+	{
+		if( v == 0 ) return 0;
+		return nextUint() % v;
+	}
+
+	//! returns a random integer in the range [a,b)
+	int32_t nextInt( int32_t a, int32_t b )
+	{
+		return nextInt( b - a ) + a;
+	}
+
+	//! returns a random float in the range [0.0f,1.0f), from the upper 24 bits of the next value
+	float nextFloat()
+	{
+		return (float)( nextUint() >> 8 ) * ( 1.0f / 16777216.0f );
+	}
+
+	//! returns a random float in the range [0.0f,v)
+	float nextFloat( float v )
+	{
+		return nextFloat() * v;
+	}
+
+	//! returns a random float in the range [a,b)
+	float nextFloat( float a, float b )
+	{
+		return nextFloat() * ( b - a ) + a;
+	}
+
+	//! returns a random float in the range [a,b) or the range [-b,-a)
+	float posNegFloat( float a, float b )
+	{
+		if( nextBool() )
+			return nextFloat( a, b );
+		else
+			return -nextFloat( a, b );
+	}
+
+	//! returns a random vec2 that represents a point on the unit circle, consuming one value
+	vec2 nextVec2();
+	//! returns a random vec3 that represents a point on the unit sphere, consuming two values
+	vec3 nextVec3();
+	//! returns a random float via Gaussian distribution, with a mean of 0 and a standard deviation of 1.0. Values are generated in pairs from two values of the sequence.
+	float nextGaussian();
+
+	//! Fills \a result with \a count values of nextUint()
+	void fillUint( uint32_t *result, size_t count );
+	//! Fills \a result with \a count values of nextFloat( \a a, \a b )
+	void fillFloat( float *result, size_t count, float a = 0.0f, float b = 1.0f );
+	//! Fills \a result with \a count values of nextGaussian(), scaled by \a stdDev and offset by \a mean
+	void fillGaussian( float *result, size_t count, float mean = 0.0f, float stdDev = 1.0f );
+	//! Fills \a result with \a count values of nextVec2()
+	void fillVec2( vec2 *result, size_t count );
+	//! Fills \a result with \a count values of nextVec3()
+	void fillVec3( vec3 *result, size_t count );
+
+  private:
+	//! Computes the values of block mBlock into mBuffer and advances to the next one
+	void generateBlock();
+
+	uint32_t	mKey[2];
+	uint64_t	mStream, mBlock;	// the upper and lower halves of the counter
+	uint32_t	mBuffer[4];
+	uint32_t	mIndex;				// the next value of mBuffer, where 4 means it is used up
+	float		mSpareGaussian;
+	bool		mHasSpareGaussian;
+};
+
 //! Resets the static random generator to the specific seed \a seedValue
 inline void randSeed( uint32_t seedValue ) { Rand::randSeed( seedValue ); }
 
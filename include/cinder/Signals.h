@@ -29,9 +29,11 @@
 #include "cinder/CinderAssert.h"
 #include "cinder/Noncopyable.h"
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <map>
+#include <mutex>
 #include <vector>
 
 namespace cinder { namespace signals {
@@ -216,7 +218,8 @@ struct CollectorDefault<void> {
 template<class Collector, class R, class... Args>
 struct CollectorInvocation<Collector, R ( Args... )> : public SignalBase {
 
-	bool invoke( Collector &collector, const std::function<R ( Args... )> &callback, Args... args )
+	template<typename CallbackT>
+	bool invoke( Collector &collector, const CallbackT &callback, Args... args )
 	{
 		return collector( callback( args... ) );
 	}
@@ -226,7 +229,8 @@ struct CollectorInvocation<Collector, R ( Args... )> : public SignalBase {
 template<class Collector, class... Args>
 struct CollectorInvocation<Collector, void( Args... )> : public SignalBase {
 
-	bool invoke( Collector &collector, const std::function<void( Args... )> &callback, Args... args )
+	template<typename CallbackT>
+	bool invoke( Collector &collector, const CallbackT &callback, Args... args )
 	{
 		callback( args... );
 		return collector();
@@ -492,6 +496,370 @@ std::function<R ( Args... )> slot( Class *object, R ( Class::*method )( Args...
 	return [object, method] ( Args... args )	{ return ( object ->* method )( args... ); };
 }
 
+// ----------------------------------------------------------------------------------------------------
+// FlatSignal
+// ----------------------------------------------------------------------------------------------------
+
+namespace detail {
+
+//! Stores a callable of up to four pointers in size within the object, and larger ones on the heap. Used by FlatSignal in place of std::function.
+template<typename> class SlotFunction;   // undefined
+
+template<class R, class... Args>
+class SlotFunction<R ( Args... )> {
+	typedef typename std::aligned_storage<4 * sizeof( void* )>::type	Storage;
+
+	template<typename Fn>
+	struct IsInline {
+		static const bool value = sizeof( Fn ) <= sizeof( Storage ) && std::alignment_of<Fn>::value <= std::alignment_of<Storage>::value;
+	};
+
+  public:
+	SlotFunction()
+		: mInvokeFn( nullptr ), mCopyFn( nullptr ), mDestroyFn( nullptr )
+	{}
+
+	template<typename F, typename = typename std::enable_if<! std::is_same<typename std::decay<F>::type, SlotFunction>::value>::type>
+	SlotFunction( F &&fn )
+		: mInvokeFn( &invoke<typename std::decay<F>::type> ), mCopyFn( &copy<typename std::decay<F>::type> ), mDestroyFn( &destroy<typename std::decay<F>::type> )
+	{
+		typedef typename std::decay<F>::type Fn;
+		if( IsInline<Fn>::value )
+			new( &mStorage ) Fn( std::forward<F>( fn ) );
+		else
+			*reinterpret_cast<Fn**>( &mStorage ) = new Fn( std::forward<F>( fn ) );
+	}
+
+	SlotFunction( const SlotFunction &other )
+		: mInvokeFn( other.mInvokeFn ), mCopyFn( other.mCopyFn ), mDestroyFn( other.mDestroyFn )
+	{
+		if( mCopyFn )
+			mCopyFn( &mStorage, &other.mStorage );
+	}
+
+	SlotFunction& operator=( const SlotFunction &rhs )
+	{
+		if( this != &rhs ) {
+			if( mDestroyFn )
+				mDestroyFn( &mStorage );
+			mInvokeFn = nullptr;
+			mCopyFn = nullptr;
+			mDestroyFn = nullptr;
+			if( rhs.mCopyFn )
+				rhs.mCopyFn( &mStorage, &rhs.mStorage );
+			mInvokeFn = rhs.mInvokeFn;
+			mCopyFn = rhs.mCopyFn;
+			mDestroyFn = rhs.mDestroyFn;
+		}
+		return *this;
+	}
+
+	~SlotFunction()
+	{
+		if( mDestroyFn )
+			mDestroyFn( &mStorage );
+	}
+
+	R operator()( Args... args ) const
+	{
+		return mInvokeFn( &mStorage, args... );
+	}
+
+	explicit operator bool() const	{ return mInvokeFn != nullptr; }
+
+  private:
+	template<typename Fn>
+	static Fn* get( void *storage )
+	{
+		return IsInline<Fn>::value ? reinterpret_cast<Fn*>( storage ) : *reinterpret_cast<Fn**>( storage );
+	}
+
+	template<typename Fn>
+	static R invoke( void *storage, Args... args )
+	{
+		return ( *get<Fn>( storage ) )( args... );
+	}
+
+	template<typename Fn>
+	static void copy( void *storage, const void *otherStorage )
+	{
+		const Fn &other = *get<Fn>( const_cast<void*>( otherStorage ) );
+		if( IsInline<Fn>::value )
+			new( storage ) Fn( other );
+		else
+			*reinterpret_cast<Fn**>( storage ) = new Fn( other );
+	}
+
+	template<typename Fn>
+	static void destroy( void *storage )
+	{
+		if( IsInline<Fn>::value )
+			get<Fn>( storage )->~Fn();
+		else
+			delete get<Fn>( storage );
+	}
+
+	// the callable is invoked through a const SlotFunction, but may have a non-const call operator, like std::function allows
+	mutable Storage	mStorage;
+	R				(*mInvokeFn)( void*, Args... );
+	void			(*mCopyFn)( void*, const void* );
+	void			(*mDestroyFn)( void* );
+};
+
+//! The link of a FlatSignal slot, which Connection uses to disconnect, enable and disable it. It is reference counted by the slot arrays containing it.
+struct FlatSignalLink : public SignalLinkBase {
+	FlatSignalLink()
+		: mConnected( true )
+	{}
+
+	//! FlatSignal slots have no siblings, disconnecting them goes through FlatSignal::disconnect()
+	bool removeSibling( SignalLinkBase * ) override	{ return false; }
+
+	bool isConnected() const	{ return mConnected.load( std::memory_order_relaxed ); }
+
+	std::atomic<bool>	mConnected;
+};
+
+} // namespace detail
+
+//! \brief FlatSignal is a Signal with lower per-slot emission overhead, intended for signals with several slots which are emitted far more often than they are connected to.
+//!
+//! FlatSignal has the same interface and ordering as Signal, and returns the same Connection type. Slots are kept
+//! in a contiguous array sorted by priority, and callables of up to four pointers in size are stored within
+//! the array rather than allocated. Connecting a slot copies the array, so connect() is O(n) where Signal's is
+//! O(log n) in the number of priority groups.
+//!
+//! Slots which are disconnected during an emission are not called again, and are removed from the array in one
+//! batch after the last emission in progress completes. Slots connected during an emission are first called by
+//! the next one.
+//!
+//! emit() may be called from several threads at once, and concurrently with connect() and disconnect(), without
+//! taking a lock. Only connecting and disconnecting take a lock. A slot which is disconnected from another thread
+//! may still be called by emissions that were already in progress.
+template <typename Signature, class Collector = detail::CollectorDefault<typename std::function<Signature>::result_type> >
+class FlatSignal;   // undefined
+
+template<class Collector, class R, class... Args>
+class FlatSignal<R ( Args... ), Collector> : private detail::CollectorInvocation<Collector, R ( Args... )> {
+  public:
+	typedef detail::SlotFunction<R ( Args... )>		CallbackFn;
+	typedef typename Collector::CollectorResult		CollectorResult;
+
+	//! Constructs an empty FlatSignal
+	FlatSignal()
+		: mSlots( new SlotArray ), mNumEmitting( 0 ), mNeedsCleanup( false ), mNumDisconnected( 0 ), mDisconnector( new detail::Disconnector( this ) )
+	{}
+
+	//! Destructor releases all resources associated with this signal. The signal must not be emitting.
+	~FlatSignal()
+	{
+		// expire all Connections first, as destroying the callables may disconnect them
+		mDisconnector.reset();
+
+		std::vector<SlotArray*> garbage;
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			mRetired.push_back( mSlots.exchange( nullptr ) );
+			collectRetired( &garbage );
+		}
+		deleteArrays( garbage );
+	}
+
+	//! Connects \a callback to the signal, assigned to the default priority group (priority = 0). \return a Connection, which can be used to disconnect this callback slot.
+	template<typename F>
+	Connection connect( F &&callback )
+	{
+		return connect( 0, std::forward<F>( callback ) );
+	}
+
+	//! Connects \a callback to the signal, assigned to the priority group \a priority. \return a Connection, which can be used to disconnect this callback slot.
+	template<typename F>
+	Connection connect( int priority, F &&callback )
+	{
+		Slot newSlot = { CallbackFn( std::forward<F>( callback ) ), nullptr, priority };
+		newSlot.mLink = new detail::FlatSignalLink;		// ref count = 1, owned by the array it is inserted into
+		Connection result( mDisconnector, newSlot.mLink, priority );
+
+		std::vector<SlotArray*> garbage;
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			const SlotArray &current = *mSlots.load();
+			SlotArray *slots = new SlotArray;
+			slots->reserve( current.size() - mNumDisconnected + 1 );
+			// the new slot follows all others of the same priority, disconnected slots are dropped along the way
+			bool inserted = false;
+			for( const Slot &slot : current ) {
+				if( ! slot.mLink->isConnected() )
+					continue;
+				if( ! inserted && slot.mPriority < priority ) {
+					slots->push_back( newSlot );
+					inserted = true;
+				}
+				slot.mLink->incrRef();
+				slots->push_back( slot );
+			}
+			if( ! inserted )
+				slots->push_back( newSlot );
+
+			publish( slots, &garbage );
+		}
+		deleteArrays( garbage );
+
+		return result;
+	}
+
+	//! Emit a signal, i.e. invoke all its callbacks and collect return types with Collector. \return the CollectorResult from the collector.
+	CollectorResult	emit( Args... args )
+	{
+		Collector collector;
+		emit( collector, args... );
+		return collector.getResult();
+	}
+
+	//! Emit a signal, i.e. invoke all its callbacks and collect return types with \a collector.
+	void emit( Collector &collector, Args... args )
+	{
+		// registering the emission before loading the array guarantees a writer either sees it, or the emission sees the writer's array
+		EmissionScope scope( this );
+		const SlotArray &slots = *mSlots.load();
+		for( const Slot &slot : slots ) {
+			if( slot.mLink->isConnected() && slot.mLink->isEnabled() ) {
+				if( ! this->invoke( collector, slot.mCallbackFn, args... ) )
+					break;
+			}
+		}
+	}
+
+	//! Returns the number of connected slots.
+	size_t getNumSlots() const
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		return mSlots.load()->size() - mNumDisconnected;
+	}
+
+  private:
+	struct Slot {
+		CallbackFn					mCallbackFn;
+		detail::FlatSignalLink*		mLink;
+		int							mPriority;
+	};
+
+	typedef std::vector<Slot>	SlotArray;
+
+	// Counts an emission in progress, and cleans up after the last one
+	struct EmissionScope {
+		EmissionScope( FlatSignal *signal )
+			: mSignal( signal )
+		{
+			mSignal->mNumEmitting.fetch_add( 1 );
+		}
+
+		~EmissionScope()
+		{
+			if( mSignal->mNumEmitting.fetch_sub( 1 ) == 1 && mSignal->mNeedsCleanup.load() )
+				mSignal->cleanup();
+		}
+
+		FlatSignal*	mSignal;
+	};
+
+	bool disconnect( detail::SignalLinkBase *link, int /*priority*/ ) override
+	{
+		std::vector<SlotArray*> garbage;
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			detail::FlatSignalLink *flatLink = static_cast<detail::FlatSignalLink*>( link );
+			if( ! flatLink || ! flatLink->isConnected() )
+				return false;
+
+			// emissions skip the slot from now on, the array is only rebuilt once none are in progress
+			flatLink->mConnected.store( false );
+			++mNumDisconnected;
+			if( mNumEmitting.load() == 0 )
+				compact( &garbage );
+			else
+				mNeedsCleanup.store( true );
+		}
+		deleteArrays( garbage );
+
+		return true;
+	}
+
+	void cleanup()
+	{
+		std::vector<SlotArray*> garbage;
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			if( mNumEmitting.load() != 0 )
+				return;
+
+			mNeedsCleanup.store( false );
+			if( mNumDisconnected )
+				compact( &garbage );
+			else
+				collectRetired( &garbage );
+		}
+		deleteArrays( garbage );
+	}
+
+	// Replaces the slot array with one without the disconnected slots. Must be called with mMutex locked.
+	void compact( std::vector<SlotArray*> *garbage )
+	{
+		const SlotArray &current = *mSlots.load();
+		SlotArray *slots = new SlotArray;
+		slots->reserve( current.size() - mNumDisconnected );
+		for( const Slot &slot : current ) {
+			if( slot.mLink->isConnected() ) {
+				slot.mLink->incrRef();
+				slots->push_back( slot );
+			}
+		}
+
+		publish( slots, garbage );
+	}
+
+	// Makes \a slots the array used by emissions, retiring the previous one. Must be called with mMutex locked.
+	void publish( SlotArray *slots, std::vector<SlotArray*> *garbage )
+	{
+		mRetired.push_back( mSlots.exchange( slots ) );
+		mNumDisconnected = 0;
+		collectRetired( garbage );
+	}
+
+	// Moves the retired arrays to \a garbage if no emission can be using them and releases their links, otherwise leaves them to the last emission. Must be called with mMutex locked.
+	void collectRetired( std::vector<SlotArray*> *garbage )
+	{
+		if( mNumEmitting.load() != 0 ) {
+			mNeedsCleanup.store( true );
+			return;
+		}
+
+		for( SlotArray *slots : mRetired ) {
+			if( slots ) {
+				for( const Slot &slot : *slots )
+					slot.mLink->decrRef();
+				garbage->push_back( slots );
+			}
+		}
+		mRetired.clear();
+	}
+
+	// Deletes \a arrays without mMutex locked, as destroying the callables may disconnect slots
+	static void deleteArrays( const std::vector<SlotArray*> &arrays )
+	{
+		for( SlotArray *slots : arrays )
+			delete slots;
+	}
+
+	std::atomic<SlotArray*>					mSlots;				// the slots called by emissions, sorted by decreasing priority. Replaced rather than modified.
+	std::atomic<int>						mNumEmitting;		// emissions in progress, which may be using mSlots or any of mRetired
+	std::atomic<bool>						mNeedsCleanup;		// whether the last emission in progress needs to compact mSlots or delete mRetired
+	mutable std::mutex						mMutex;				// guards mRetired, mNumDisconnected, link reference counts and replacing mSlots
+	std::vector<SlotArray*>					mRetired;
+	size_t									mNumDisconnected;	// slots in mSlots which have been disconnected
+	std::shared_ptr<detail::Disconnector>	mDisconnector;		// Connection holds a weak_ptr to this to make disconnections.
+};
+
 // ----------------------------------------------------------------------------------------------------
 // Collectors
 // ----------------------------------------------------------------------------------------------------
@@ -0,0 +1,189 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "cinder/Vector.h"
+
+#include <vector>
+
+namespace cinder {
+
+/** \brief Uniform grid over a set of 2D or 3D points, for radius queries on points that move every frame.
+ *
+ * build() sorts the points into their cells with a counting sort, which takes linear time and can be split across threads, so the grid
+ * can be rebuilt from scratch every frame. When the bounds of the points span a reasonable number of cells, the cells are stored densely
+ * in row order, so a query reads each row of cells it overlaps as one contiguous range. Otherwise the cells are hashed into a fixed number
+ * of buckets, so that widely scattered points don't need a huge grid. The points are copied in cell order, and getIndices() maps them back
+ * to their index in the data the grid was built from. A radius query only visits the cells the radius overlaps, which is cheapest when the
+ * cell size is close to the typical query radius. Querying the neighbours of every point is several times faster in the order of getPoints()
+ * than in the original order, since consecutive queries then read the same cells.
+ *
+ * Example usage:
+ * \code
+ * SpatialHashGrid3f grid( neighborRadius );
+ * grid.build( particlePositions );
+ * grid.forEachWithinRadius( particlePositions[0], neighborRadius, [&]( uint32_t index, float distanceSquared ) {
+ *     ...
+ * } );
+ * \endcode
+**/
+template<int D, typename T>
+class SpatialHashGrid {
+  public:
+	typedef typename VECDIM<D, T>::TYPE		VecT;
+	typedef typename VECDIM<D, int>::TYPE	IVecT;
+
+	//! Creates a grid of cells of size \a cellSize. If \a numBuckets isn't \c 0 the cells are always hashed into that many buckets, rounded up to a power of two.
+	SpatialHashGrid( T cellSize = 1, uint32_t numBuckets = 0 );
+
+	//! Sets the size of the cells, which takes effect on the next build().
+	void	setCellSize( T cellSize )	{ mCellSize = cellSize; }
+	//! Returns the size of the cells.
+	T		getCellSize() const			{ return mCellSize; }
+
+	//! Rebuilds the grid over \a numPoints \a points, on multiple threads if \a parallel is \c true and there are enough points.
+	void	build( const VecT *points, size_t numPoints, bool parallel = true );
+	//! Rebuilds the grid over \a points, on multiple threads if \a parallel is \c true and there are enough points.
+	void	build( const std::vector<VecT> &points, bool parallel = true ) { build( points.data(), points.size(), parallel ); }
+
+	//! Returns the number of points in the grid.
+	size_t						getNumPoints() const	{ return mPoints.size(); }
+	//! Returns whether the cells are hashed into buckets, rather than stored densely.
+	bool						isHashed() const		{ return ! mDense; }
+	//! Returns the points sorted by cell.
+	const std::vector<VecT>&	getPoints() const		{ return mPoints; }
+	//! Returns the index in the source data of each point in getPoints().
+	const std::vector<uint32_t>&	getIndices() const	{ return mIndices; }
+
+	//! Calls \a fn( index, distanceSquared ) for every point within \a radius of \a p, in no particular order.
+	template<typename Fn>
+	void	forEachWithinRadius( const VecT &p, T radius, const Fn &fn ) const;
+	//! Finds the points within \a radius of \a p in no particular order and writes up to \a maxResults of them to \a indices and \a distancesSquared, which may be \c nullptr. Returns the number of points found, which may be larger than \a maxResults.
+	size_t	findWithinRadius( const VecT &p, T radius, uint32_t *indices, T *distancesSquared, size_t maxResults ) const;
+	//! Appends the indices of the points within \a radius of \a p to \a indices, and their squared distances to \a distancesSquared unless it is \c nullptr.
+	void	findWithinRadius( const VecT &p, T radius, std::vector<uint32_t> *indices, std::vector<T> *distancesSquared = nullptr ) const;
+	//! Runs findWithinRadius() for each of the \a numPoints \a points across threads. The results for point \c i start at \a indices and \a distancesSquared + \c i * \a maxResults, and the number of points found for each query is written to \a counts.
+	void	findWithinRadius( const VecT *points, size_t numPoints, T radius, size_t maxResults, uint32_t *indices, T *distancesSquared, size_t *counts ) const;
+
+  private:
+	IVecT		calcCell( const VecT &p ) const		{ return IVecT( glm::floor( p * mInvCellSize ) ); }
+	//! Dense grids require \a cell to be inside the grid.
+	uint32_t	calcBucket( const IVecT &cell ) const
+	{
+		uint32_t result = 0;
+		if( mDense ) {
+			for( int i = D - 1; i >= 0; --i )
+				result = result * mGridSize[i] + uint32_t( cell[i] - mGridMin[i] );
+			return result;
+		}
+
+		static const uint32_t primes[] = { 73856093, 19349663, 83492791, 2654435761u };
+		for( int i = 0; i < D; ++i )
+			result ^= uint32_t( cell[i] ) * primes[i];
+		return result & ( mNumBuckets - 1 );
+	}
+
+	T							mCellSize, mInvCellSize;
+	uint32_t					mFixedNumBuckets, mNumBuckets;
+	bool						mDense;
+	//! First and number of cells along each axis of a dense grid
+	IVecT						mGridMin, mGridSize;
+	//! First point of each bucket, followed by the number of points
+	std::vector<uint32_t>		mBucketStarts;
+	std::vector<VecT>			mPoints;
+	std::vector<uint32_t>		mIndices;
+};
+
+template<int D, typename T>
+template<typename Fn>
+void SpatialHashGrid<D, T>::forEachWithinRadius( const VecT &p, T radius, const Fn &fn ) const
+{
+	if( mPoints.empty() )
+		return;
+
+	const T radiusSquared = radius * radius;
+	IVecT minCell = calcCell( p - VecT( radius ) ), maxCell = calcCell( p + VecT( radius ) );
+	if( mDense ) {
+		minCell = glm::max( minCell, mGridMin );
+		maxCell = glm::min( maxCell, mGridMin + mGridSize - IVecT( 1 ) );
+		for( int i = 0; i < D; ++i ) {
+			if( minCell[i] > maxCell[i] )
+				return;
+		}
+	}
+
+	double numCells = 1;
+	for( int i = 0; i < D; ++i )
+		numCells *= double( maxCell[i] ) - minCell[i] + 1;
+
+	// with a radius this large relative to the cells it's faster to test every point
+	if( numCells > mPoints.size() ) {
+		for( size_t i = 0; i < mPoints.size(); ++i ) {
+			const T distanceSquared = glm::distance2( mPoints[i], p );
+			if( distanceSquared <= radiusSquared )
+				fn( mIndices[i], distanceSquared );
+		}
+		return;
+	}
+
+	// dense grids visit each row of cells along the first axis as one range of points, hashed grids visit one cell at a time
+	const int firstAxis = mDense ? 1 : 0;
+	IVecT cell = minCell;
+	while( true ) {
+		if( mDense ) {
+			IVecT rowEnd = cell;
+			rowEnd[0] = maxCell[0];
+			for( uint32_t i = mBucketStarts[calcBucket( cell )], end = mBucketStarts[calcBucket( rowEnd ) + 1]; i < end; ++i ) {
+				const T distanceSquared = glm::distance2( mPoints[i], p );
+				if( distanceSquared <= radiusSquared )
+					fn( mIndices[i], distanceSquared );
+			}
+		}
+		else {
+			const uint32_t bucket = calcBucket( cell );
+			for( uint32_t i = mBucketStarts[bucket]; i < mBucketStarts[bucket + 1]; ++i ) {
+				const T distanceSquared = glm::distance2( mPoints[i], p );
+				// other cells may share the bucket and be visited too, so only report points in the cell being visited
+				if( distanceSquared <= radiusSquared && calcCell( mPoints[i] ) == cell )
+					fn( mIndices[i], distanceSquared );
+			}
+		}
+
+		int axis = firstAxis;
+		for( ; axis < D; ++axis ) {
+			if( cell[axis] < maxCell[axis] ) {
+				cell[axis]++;
+				break;
+			}
+			cell[axis] = minCell[axis];
+		}
+		if( axis == D )
+			break;
+	}
+}
+
+typedef SpatialHashGrid<2, float>	SpatialHashGrid2f;
+typedef SpatialHashGrid<3, float>	SpatialHashGrid3f;
+
+} // namespace cinder
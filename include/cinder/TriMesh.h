@@ -298,7 +298,7 @@ class TriMesh : public geom::Source {
 	//! Calculates the bounding box of all vertices as transformed by \a transform. Fails if the positions are not 3D.
 	AxisAlignedBox	calcBoundingBox( const mat4 &transform ) const;
 
-	//! Fills this TriMesh with the data from a binary file, which was created with TriMesh::write().
+	//! Fills this TriMesh with the data from a binary file, which was created with TriMesh::write() or TriMeshView::write().
 	void		read( const DataSourceRef &dataSource );
 	//! Writes this TriMesh out to a binary data file.
 	void		write( const DataTargetRef &dataTarget ) const { write( dataTarget, ~0 ); }
@@ -317,6 +317,29 @@ class TriMesh : public geom::Source {
 	//! Adds or replaces bitangents by calculating them from the normals and tangents. Requires 3D normals and tangents.
 	bool		recalculateBitangents();
 
+	/*! Merges vertices whose positions lie within \a tolerance of each other, remapping the indices and removing the merged vertices.
+		Unless \a positionsOnly is TRUE, all other attributes must also match within \a tolerance, so that seams in normals or texture
+		coordinates are preserved. Coincident vertices are found with a spatial hash. Requires 3D vertices and indices. Returns the number of vertices removed. */
+	size_t		weldVertices( float tolerance = 0.0001f, bool positionsOnly = false );
+	//! Removes vertices that are identical to an earlier vertex in all attributes, remapping the indices. Returns the number of vertices removed.
+	size_t		removeDuplicateVertices() { return weldVertices( 0 ); }
+
+	/*! Reduces the TriMesh to at most \a numTriangles triangles by quadric error metric edge collapse, stopping before any collapse that would move the surface further than \a maxError.
+		Vertices are never moved, so normals, texture coordinates and their seams are preserved. Vertices which are no longer referenced are removed. Requires 3D vertices and indices.
+		Returns the largest distance any collapse moved the surface. */
+	float		simplify( size_t numTriangles, float maxError = FLT_MAX );
+	//! Returns a chain of levels of detail, one for each of the decreasing triangle counts in \a numTriangles. Each level is simplified from the previous one with simplify().
+	std::vector<TriMeshRef>	createLods( const std::vector<size_t> &numTriangles, float maxError = FLT_MAX ) const;
+
+	//! Reorders the triangles to make better use of the GPU's post-transform vertex cache. Requires indices.
+	void		optimizeVertexCache();
+	//! Reorders clusters of triangles, which should already be optimized with optimizeVertexCache(), to reduce overdraw while growing the ACMR by no more than \a threshold times. Requires 3D vertices and indices.
+	void		optimizeOverdraw( float threshold = 1.05f );
+	//! Reorders the vertices in the order the triangles use them, improving the locality of vertex fetches. Call after reordering the triangles. Requires indices.
+	void		optimizeVertexFetch();
+	//! Returns the post-transform vertex cache statistics of the triangles, for a FIFO cache of \a cacheSize vertices.
+	geom::VertexCacheStats	calcVertexCacheStats( size_t cacheSize = 16 ) const;
+
 	/*! Subdivide each triangle of the TriMesh into \a division times division triangles. Division less than 2 leaves the mesh unaltered.
 		Optionally, vertices are normalized if \a normalize is TRUE. */
 	void		subdivide( int division = 2, bool normalize = false );
@@ -338,8 +361,10 @@ class TriMesh : public geom::Source {
 	void		getAttribPointer( geom::Attrib attr, const float **resultPtr, size_t *resultStrideBytes, uint8_t *resultDims ) const;
 	void		copyAttrib( geom::Attrib attr, uint8_t dims, size_t stride, const float *srcData, size_t count );
 
-	//! Returns whether or not the vertex, color etc. at both indices is the same.
-	bool		verticesEqual( uint32_t indexA, uint32_t indexB ) const;
+	//! Returns whether or not the vertex, color etc. at both indices are the same within \a tolerance.
+	bool		verticesEqual( uint32_t indexA, uint32_t indexB, float tolerance ) const;
+	//! Keeps only the vertices that \a remap maps onto themselves, preserving their order, and renumbers the indices. Every index must refer to a kept vertex.
+	void		compactVertices( const std::vector<uint32_t> &remap );
 
 	void		readImplV2( const IStreamRef &in );
 	void		readImplV1( const IStreamRef &in );
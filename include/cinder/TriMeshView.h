@@ -0,0 +1,162 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "cinder/GeomIo.h"
+#include "cinder/DataSource.h"
+#include "cinder/DataTarget.h"
+#include "cinder/MemoryMappedFile.h"
+#include "cinder/Exception.h"
+
+namespace cinder {
+
+typedef std::shared_ptr<class TriMeshView>	TriMeshViewRef;
+
+/** \brief Read-only geom::Source over a binary mesh cache file.
+ *
+ * The file consists of a header, a table of attributes and the raw, 16-byte aligned arrays. File-based DataSources are mapped into
+ * memory and used in place, so opening a file involves no parsing and float attributes and uncompressed indices are never copied until
+ * loadInto() hands them to a geom::Target. Positions may optionally be quantized to 16 bits per component, normals, tangents and bitangents
+ * to 32-bit octahedral encodings, and indices may be compressed with an edge-based codec. Those are decoded in loadInto().
+ *
+ * Example usage:
+ * \code
+ * TriMeshView::write( writeFile( "bunny.mesh" ), ObjLoader( loadFile( "bunny.obj" ) ), TriMeshView::Format().quantizePositions().compressIndices() );
+ * auto batch = gl::Batch::create( *TriMeshView::create( loadFile( "bunny.mesh" ) ), gl::getStockShader( gl::ShaderDef().lambert() ) );
+ * \endcode
+**/
+class TriMeshView : public geom::Source {
+  public:
+	//! Describes how an attribute or the indices are stored in the file.
+	enum class Encoding : uint8_t {
+		//! 32-bit floats for attributes, indices stored as 16-bit values when there are at most 65536 vertices and 32-bit values otherwise
+		NONE,
+		//! 16-bit unsigned integers per component, scaled to the bounds of the attribute
+		UNORM16,
+		//! Octahedral mapping of unit vectors to two 16-bit signed integers
+		OCTAHEDRAL16,
+		//! Indices compressed with an edge and vertex FIFO codec. Triangles may be rotated, but keep their winding.
+		COMPRESSED
+	};
+
+	//! Options for writing a mesh cache file with TriMeshView::write().
+	class Format {
+	  public:
+		Format() : mQuantizePositions( false ), mQuantizeNormals( false ), mCompressIndices( false ) {}
+
+		//! Stores positions as 16-bit integers relative to their bounding box, with a precision of 1/65535 of its size.
+		Format&		quantizePositions( bool quantize = true ) { mQuantizePositions = quantize; return *this; }
+		//! Stores normals, tangents and bitangents in 32-bit octahedral encodings. Requires unit length vectors.
+		Format&		quantizeNormals( bool quantize = true ) { mQuantizeNormals = quantize; return *this; }
+		//! Compresses the indices, which works best after the triangles and vertices have been ordered for the vertex cache.
+		Format&		compressIndices( bool compress = true ) { mCompressIndices = compress; return *this; }
+
+		bool	getQuantizePositions() const { return mQuantizePositions; }
+		bool	getQuantizeNormals() const { return mQuantizeNormals; }
+		bool	getCompressIndices() const { return mCompressIndices; }
+
+	  private:
+		bool	mQuantizePositions, mQuantizeNormals, mCompressIndices;
+	};
+
+	//! Opens the mesh cache file \a dataSource, mapping it into memory if it is a file. Throws ExcTriMeshView if it isn't a valid file.
+	static TriMeshViewRef	create( const DataSourceRef &dataSource ) { return TriMeshViewRef( new TriMeshView( dataSource ) ); }
+	//! Opens the mesh cache file \a dataSource, mapping it into memory if it is a file. Throws ExcTriMeshView if it isn't a valid file.
+	TriMeshView( const DataSourceRef &dataSource );
+
+	//! Writes the triangles of \a source to \a dataTarget in the mesh cache format, which can be opened with TriMeshView or TriMesh::read().
+	static void		write( const DataTargetRef &dataTarget, const geom::Source &source, const Format &format = Format() );
+	//! Returns whether the data in \a dataSource starts with the mesh cache file signature.
+	static bool		isTriMeshView( const DataSourceRef &dataSource );
+
+	//! Returns how \a attr is stored, or Encoding::NONE if it isn't present.
+	Encoding		getAttribEncoding( geom::Attrib attr ) const;
+	//! Returns a pointer to the mapped floats of \a attr, or \c nullptr if it is missing or quantized.
+	const float*	getAttribData( geom::Attrib attr ) const;
+	//! Decodes \a attr into \a result, which needs room for getNumVertices() * getAttribDims( \a attr ) floats.
+	void			decodeAttrib( geom::Attrib attr, float *result ) const;
+
+	//! Returns how the indices are stored.
+	Encoding		getIndexEncoding() const { return (Encoding)mHeader->mIndexEncoding; }
+	//! Returns a pointer to the mapped indices, which are getIndexBytes() wide, or \c nullptr if they are compressed.
+	const void*		getIndexData() const;
+	//! Returns the number of bytes per uncompressed index, or \c 0 if the indices are compressed.
+	uint8_t			getIndexBytes() const;
+	//! Decodes the indices into \a result, which needs room for getNumIndices() indices.
+	void			decodeIndices( uint32_t *result ) const;
+
+	//! Returns the bounding box of the positions, as stored in the header.
+	AxisAlignedBox	getBoundingBox() const;
+
+	// geom::Source virtuals
+	size_t				getNumVertices() const override { return mHeader->mNumVertices; }
+	size_t				getNumIndices() const override { return mHeader->mNumIndices; }
+	geom::Primitive		getPrimitive() const override { return geom::Primitive::TRIANGLES; }
+	uint8_t				getAttribDims( geom::Attrib attr ) const override;
+	geom::AttribSet		getAvailableAttribs() const override;
+	void				loadInto( geom::Target *target, const geom::AttribSet &requestedAttribs ) const override;
+	TriMeshView*		clone() const override { return new TriMeshView( *this ); }
+
+	//! Layout of the file header. All fields are little-endian.
+	struct Header {
+		char		mSignature[8];
+		uint32_t	mVersion;
+		uint32_t	mByteOrderMark;
+		uint32_t	mNumVertices;
+		uint32_t	mNumIndices;
+		uint32_t	mNumAttribs;
+		uint32_t	mIndexEncoding;
+		uint64_t	mIndexOffset, mIndexSize;
+		float		mBoundsMin[3], mBoundsMax[3];
+	};
+
+	//! Layout of an entry of the attribute table, which follows the header. Quantized values decode to \a value * mScale + mBias.
+	struct AttribEntry {
+		uint32_t	mAttrib;
+		uint8_t		mDims;
+		uint8_t		mEncoding;
+		uint16_t	mReserved;
+		uint64_t	mOffset, mSize;
+		float		mScale[4], mBias[4];
+	};
+
+  private:
+	const AttribEntry*	findAttrib( geom::Attrib attr ) const;
+
+	MemoryMappedFileRef		mMappedFile;
+	BufferRef				mBuffer;
+	const uint8_t*			mData;
+	size_t					mDataSize;
+	const Header*			mHeader;
+	const AttribEntry*		mAttribs;
+};
+
+class ExcTriMeshView : public Exception {
+  public:
+	ExcTriMeshView( const std::string &description )
+		: Exception( "TriMeshView error: " + description )
+	{}
+};
+
+} // namespace cinder
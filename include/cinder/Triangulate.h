@@ -32,7 +32,8 @@ struct TESStesselator;
 
 namespace cinder {
 
-//! Converts an arbitrary Shape2d into a TriMesh2d
+//! Converts an arbitrary Shape2d into a TriMesh2d. Contours which are simple polygons with holes, such as glyph outlines, are triangulated
+//! by ear clipping. Anything else, such as self-intersecting contours, falls back to the slower but fully general libtess2.
 class Triangulator {
   public:
 	typedef enum Winding { WINDING_ODD, WINDING_NONZERO, WINDING_POSITIVE, WINDING_NEGATIVE, WINDING_ABS_GEQ_TWO } Winding;
@@ -54,20 +55,40 @@ class Triangulator {
 	void		addPolyLine( const PolyLine2f &polyLine );
 	//! Adds a PolyLine defined as a series of vec2's
 	void		addPolyLine( const vec2 *points, size_t numPoints );
+	//! Removes all contours, keeping the allocated memory for reuse
+	void		clear();
 
 	//! Performs the tesselation, returning a TriMesh2d
 	TriMesh		calcMesh( Winding winding = WINDING_ODD );
 	//! Performs the tesselation, returning a TriMesh2d
 	TriMeshRef	createMesh( Winding winding = WINDING_ODD );
+
+	//! Enables ear clipping of simple polygons. When disabled, everything is tesselated by libtess2. Default is \c true.
+	void		setEarClippingEnabled( bool enable = true ) { mEarClippingEnabled = enable; }
+	//! Returns whether ear clipping of simple polygons is enabled.
+	bool		isEarClippingEnabled() const { return mEarClippingEnabled; }
+
+	//! Tesselates each of \a shapes, returning a TriMesh2d for each in the same order. The shapes are distributed across worker threads, each of which reuses a single Triangulator.
+	static std::vector<TriMesh>	calcMeshes( const std::vector<Shape2d> &shapes, float approximationScale = 1.0f, Winding winding = WINDING_ODD );
 	
 	class Exception : public cinder::Exception {
 	};
 	
   protected:	
+	struct EarClipper;
+
 	void			allocate();
+	void			addContour( const vec2 *points, size_t numPoints );
+	//! Triangulates the contours into \a result by ear clipping. Returns \c false if they aren't simple polygons with holes under \a winding.
+	bool			earClip( Winding winding, TriMesh *result );
+	void			tesselate( Winding winding, TriMesh *result );
 	
 	int									mAllocated;
 	std::shared_ptr<TESStesselator>		mTess;
+	bool								mEarClippingEnabled;
+	std::vector<vec2>					mPoints;
+	std::vector<uint32_t>				mContourOffsets; // the first point of each contour in mPoints, followed by mPoints.size()
+	std::shared_ptr<EarClipper>			mEarClipper;
 };
 
 } // namespace cinder
\ No newline at end of file
@@ -33,11 +33,13 @@
 
 #include <string>
 #include <vector>
+#include <boost/utility/string_ref.hpp>
 
 //! \cond
 namespace rapidxml {
 	template<class Ch> class xml_document;
 	template<class Ch> class xml_node;
+	template<class Ch> class xml_attribute;
 };
 //! \endcond
 
@@ -402,7 +404,7 @@ class XmlTree {
 	XmlTree*	getNodePtr( const std::string &relativePath, bool caseSensitive, char separator ) const;
 	void		appendRapidXmlNode( rapidxml::xml_document<char> &doc, rapidxml::xml_node<char> *parent ) const;
 
-	static Container::const_iterator	findNextChildNamed( const Container &sequence, Container::const_iterator firstCandidate, const std::string &searchTag, bool caseSensitive );
+	static Container::const_iterator	findNextChildNamed( const Container &sequence, Container::const_iterator firstCandidate, const boost::string_ref &searchTag, bool caseSensitive );
 
 	NodeType					mNodeType;
   	std::string					mTag;
@@ -417,6 +419,213 @@ class XmlTree {
 
 std::ostream& operator<<( std::ostream &out, const XmlTree &xml );
 
+/** \brief Read-only view of an XML document, which is parsed in place and not copied into XmlTree nodes.
+	Tags, values and attributes are returned as views into a single copy of the document, and nodes live in RapidXML's memory pool. Copying an XmlView
+	is cheap and shares the document, and Nodes remain valid as long as any XmlView of their document exists. Children are visited the same way as
+	XmlTree's default ParseOptions, skipping data and DOCTYPE nodes. Unlike XmlTree, CDATA sections are not collapsed into the value of their parent.
+	<br><tt>XmlView svg( loadAsset( "drawing.svg" ) ); for( XmlView::Node path : svg.getChild( "svg" ).children( "path" ) ) ...</tt> **/
+class XmlView {
+  public:
+	class Node;
+
+	//! An attribute of a Node.
+	class Attr {
+	  public:
+		//! Returns whether this refers to an attribute, which is \c false for the end of a Node's attributes.
+		explicit operator bool() const	{ return mAttr != nullptr; }
+
+		//! Returns the name of the attribute.
+		boost::string_ref		getName() const;
+		//! Returns the value of the attribute.
+		boost::string_ref		getValue() const;
+		//! Returns the value of the attribute parsed as a T.
+		template<typename T>
+		T						getValue() const { boost::string_ref value = getValue(); return boost::lexical_cast<T>( value.data(), value.size() ); }
+		//! Returns the next attribute of the same Node.
+		Attr					getNextAttribute() const;
+
+	  private:
+		friend class Node;
+		explicit Attr( const rapidxml::xml_attribute<char> *attr ) : mAttr( attr ) {}
+
+		const rapidxml::xml_attribute<char>	*mAttr;
+	};
+
+	//! Iterates the children of a Node, optionally only those with a given tag.
+	class ChildIter {
+	  public:
+		Node		operator*() const	{ return Node( mNode ); }
+		ChildIter&	operator++();
+
+		bool operator==( const ChildIter &rhs ) const { return mNode == rhs.mNode; }
+		bool operator!=( const ChildIter &rhs ) const { return mNode != rhs.mNode; }
+
+	  private:
+		friend class Node;
+		ChildIter( const rapidxml::xml_node<char> *node, const boost::string_ref &tag, bool caseSensitive );
+
+		const rapidxml::xml_node<char>	*mNode;
+		boost::string_ref				mTag;
+		bool							mCaseSensitive;
+	};
+
+	//! A range of children for use with range-based for loops, returned by Node::children().
+	class ChildRange {
+	  public:
+		ChildIter	begin() const	{ return mBegin; }
+		ChildIter	end() const		{ return mEnd; }
+
+	  private:
+		friend class Node;
+		ChildRange( const ChildIter &begin, const ChildIter &end ) : mBegin( begin ), mEnd( end ) {}
+
+		ChildIter	mBegin, mEnd;
+	};
+
+	//! A node of an XmlView. Default constructed Nodes, and those returned by a failed find(), are null.
+	class Node {
+	  public:
+		Node() : mNode( nullptr ) {}
+
+		//! Returns whether this refers to a node of the document.
+		explicit operator bool() const	{ return mNode != nullptr; }
+		bool operator==( const Node &rhs ) const { return mNode == rhs.mNode; }
+		bool operator!=( const Node &rhs ) const { return mNode != rhs.mNode; }
+
+		//! Returns the type of this node.
+		XmlTree::NodeType		getNodeType() const;
+		//! Returns whether this node is an element node.
+		bool					isElement() const	{ return getNodeType() == XmlTree::NODE_ELEMENT; }
+
+		//! Returns the tag or name of the node.
+		boost::string_ref		getTag() const;
+		//! Returns the value of the node, which for elements is their first block of text.
+		boost::string_ref		getValue() const;
+		//! Returns the value of the node parsed as a T.
+		template<typename T>
+		T						getValue() const { boost::string_ref value = getValue(); return boost::lexical_cast<T>( value.data(), value.size() ); }
+		//! Returns the value of the node parsed as a T. If the value is empty or fails to parse \a defaultValue is returned.
+		template<typename T>
+		T						getValue( const T &defaultValue ) const { try { return getValue<T>(); } catch( ... ) { return defaultValue; } }
+
+		//! Returns whether the node has an attribute named \a attrName.
+		bool					hasAttribute( const boost::string_ref &attrName ) const;
+		//! Returns the value of the attribute \a attrName. Throws XmlView::ExcAttrNotFound if no attribute exists with that name.
+		boost::string_ref		getAttributeValue( const boost::string_ref &attrName ) const;
+		//! Returns the value of the attribute \a attrName parsed as a T. Throws XmlView::ExcAttrNotFound if no attribute exists with that name.
+		template<typename T>
+		T						getAttributeValue( const boost::string_ref &attrName ) const { boost::string_ref value = getAttributeValue( attrName ); return boost::lexical_cast<T>( value.data(), value.size() ); }
+		//! Returns the value of the attribute \a attrName parsed as a T. Returns \a defaultValue if no attribute exists with that name or the attribute fails to cast to T.
+		template<typename T>
+		T						getAttributeValue( const boost::string_ref &attrName, const T &defaultValue ) const;
+		//! Returns the value of the attribute \a attrName, or an empty string if it doesn't exist.
+		boost::string_ref		operator[]( const boost::string_ref &attrName ) const;
+		//! Returns the first attribute of the node, which is null if there are none.
+		Attr					getFirstAttribute() const;
+
+		//! Returns an iterator to the first child of this node.
+		ChildIter				begin() const		{ return ChildIter( firstChild(), boost::string_ref(), false ); }
+		//! Returns an iterator which marks the end of the children of this node.
+		ChildIter				end() const			{ return ChildIter( nullptr, boost::string_ref(), false ); }
+		//! Returns the children of this node with the tag \a tag, or all of them if \a tag is empty.
+		ChildRange				children( const boost::string_ref &tag = boost::string_ref(), bool caseSensitive = false ) const	{ return ChildRange( ChildIter( firstChild(), tag, caseSensitive ), end() ); }
+
+		//! Returns the first descendant matching \a relativePath, trying every child whose tag matches each component of the path. Returns a null Node if none matches.
+		Node					find( const boost::string_ref &relativePath, bool caseSensitive = false, char separator = '/' ) const;
+		//! Returns whether the child at \a relativePath exists, following the first child whose tag matches each component of the path as XmlTree::hasChild() does.
+		bool					hasChild( const boost::string_ref &relativePath, bool caseSensitive = false, char separator = '/' ) const	{ return getNodePtr( relativePath, caseSensitive, separator ) != nullptr; }
+		//! Returns the child at \a relativePath, following the first child whose tag matches each component of the path. Throws XmlView::ExcChildNotFound if none matches.
+		Node					getChild( const boost::string_ref &relativePath, bool caseSensitive = false, char separator = '/' ) const;
+		//! Returns the first child with the tag \a childName. Throws XmlView::ExcChildNotFound if none matches.
+		Node					operator/( const boost::string_ref &childName ) const	{ return getChild( childName ); }
+
+		//! Returns whether this node has a parent node.
+		bool					hasParent() const;
+		//! Returns the parent of this node, which is null for the document node.
+		Node					getParent() const;
+		//! Returns a path to this node, separated by the character \a separator.
+		std::string				getPath( char separator = '/' ) const;
+
+		//! Returns a copy of this node and its descendants as an XmlTree, which can be modified.
+		XmlTree					createXmlTree( const XmlTree::ParseOptions &parseOptions = XmlTree::ParseOptions() ) const;
+
+	  private:
+		friend class XmlView;
+		friend class ChildIter;
+		explicit Node( const rapidxml::xml_node<char> *node ) : mNode( node ) {}
+
+		const rapidxml::xml_node<char>*	firstChild() const;
+		const rapidxml::xml_node<char>*	getNodePtr( const boost::string_ref &relativePath, bool caseSensitive, char separator ) const;
+
+		const rapidxml::xml_node<char>	*mNode;
+	};
+
+	//! Parses XML contained in \a dataSource, including comments if \a parseComments. Throws rapidxml::parse_error if the document is malformed.
+	explicit XmlView( const DataSourceRef &dataSource, bool parseComments = false );
+	//! Parses the XML contained in the string \a xmlString, including comments if \a parseComments.
+	explicit XmlView( const std::string &xmlString, bool parseComments = false );
+
+	//! Returns the document node, whose children are the root elements.
+	Node					getDocument() const;
+	//! Returns the DOCTYPE string of the document.
+	boost::string_ref		getDocType() const;
+
+	//! Returns an iterator to the first child of the document node.
+	ChildIter				begin() const	{ return getDocument().begin(); }
+	//! Returns an iterator which marks the end of the children of the document node.
+	ChildIter				end() const		{ return getDocument().end(); }
+	//! Returns the first descendant of the document node matching \a relativePath. Returns a null Node if none matches.
+	Node					find( const boost::string_ref &relativePath, bool caseSensitive = false, char separator = '/' ) const	{ return getDocument().find( relativePath, caseSensitive, separator ); }
+	//! Returns whether the document node has a child at \a relativePath.
+	bool					hasChild( const boost::string_ref &relativePath, bool caseSensitive = false, char separator = '/' ) const	{ return getDocument().hasChild( relativePath, caseSensitive, separator ); }
+	//! Returns the child of the document node at \a relativePath. Throws XmlView::ExcChildNotFound if none matches.
+	Node					getChild( const boost::string_ref &relativePath, bool caseSensitive = false, char separator = '/' ) const	{ return getDocument().getChild( relativePath, caseSensitive, separator ); }
+	//! Returns the first child of the document node with the tag \a childName. Throws XmlView::ExcChildNotFound if none matches.
+	Node					operator/( const boost::string_ref &childName ) const	{ return getChild( childName ); }
+
+	//! Exception expressing the absence of an expected child node.
+	class ExcChildNotFound : public XmlTree::Exception {
+	  public:
+		ExcChildNotFound( const Node &node, const boost::string_ref &childPath ) throw();
+
+		virtual const char* what() const throw() { return mMessage; }
+
+	  private:
+		char mMessage[2048];
+	};
+
+	//! Exception expressing the absence of an expected attribute.
+	class ExcAttrNotFound : public XmlTree::Exception {
+	  public:
+		ExcAttrNotFound( const Node &node, const boost::string_ref &attrName ) throw();
+
+		virtual const char* what() const throw() { return mMessage; }
+
+	  private:
+		char mMessage[2048];
+	};
+
+  private:
+	struct Document;
+
+	std::shared_ptr<Document>	mDocument;
+};
+
+template<typename T>
+T XmlView::Node::getAttributeValue( const boost::string_ref &attrName, const T &defaultValue ) const
+{
+	if( hasAttribute( attrName ) ) {
+		try {
+			return getAttributeValue<T>( attrName );
+		}
+		catch( ... ) {
+			return defaultValue;
+		}
+	}
+	else
+		return defaultValue;
+}
+
 } // namespace cinder
 
 namespace std {
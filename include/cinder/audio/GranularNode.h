@@ -0,0 +1,136 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "cinder/audio/InputNode.h"
+#include "cinder/audio/dsp/Dsp.h"
+#include "cinder/Rand.h"
+
+namespace cinder { namespace audio {
+
+typedef std::shared_ptr<class GranularNode>		GranularNodeRef;
+
+//! \brief Granular synthesis InputNode, which plays many short, windowed 'grains' read from a shared Buffer.
+//!
+//! Grains are scheduled automatically at the rate set by setDensity(), with sample-accurate onsets. Each grain reads from the Buffer
+//! starting at the current position (plus optional random jitter) at its own playback rate, and is shaped by a window created with
+//! dsp::generateWindow(). Grains are taken from a fixed-size pool that is allocated up front, so no memory is allocated on the audio
+//! thread. If the pool is exhausted, new grains are dropped and counted, see getNumDroppedGrains().
+//!
+//! The Buffer is treated as circular, grains that read past its end continue from the beginning.
+//! The ChannelMode is set to Node::ChannelMode::SPECIFIED and the number of channels matches the Buffer's.
+class GranularNode : public InputNode {
+  public:
+	//! Constructs a GranularNode without a buffer, with the assumption one will be set later. \note Format::channels() can still be used to allocate the expected channel count ahead of time.
+	GranularNode( const Format &format = Format() );
+	//! Constructs a GranularNode that plays grains from \a buffer, with an optional \a format. Num channels matches \a buffer.
+	GranularNode( const BufferRef &buffer, const Format &format = Format() );
+
+	//! Sets the Buffer grains are read from. Safe to do while enabled, active grains are discarded.
+	void				setBuffer( const BufferRef &buffer );
+	//! Returns a shared_ptr to the current Buffer.
+	const BufferRef&	getBuffer() const	{ return mBuffer; }
+
+	//! Sets the maximum number of grains that can be active at once (default = 256). Allocates memory and blocks the audio graph.
+	void	setMaxGrains( size_t maxGrains );
+	//! Returns the maximum number of grains that can be active at once.
+	size_t	getMaxGrains() const					{ return mGrains.size(); }
+
+	//! Sets the number of grains triggered per second (default = 20).
+	void	setDensity( float grainsPerSecond )		{ mDensity = grainsPerSecond; }
+	//! Returns the number of grains triggered per second.
+	float	getDensity() const						{ return mDensity; }
+	//! Sets the amount of randomness applied to the time between grain onsets, in the range [0:1] (default = 0, periodic onsets).
+	void	setOnsetJitter( float amount )			{ mOnsetJitter = amount; }
+	//! Returns the amount of randomness applied to the time between grain onsets.
+	float	getOnsetJitter() const					{ return mOnsetJitter; }
+	//! Sets the duration of new grains, in seconds (default = 0.05).
+	void	setGrainDuration( float seconds )		{ mGrainDuration = seconds; }
+	//! Returns the duration of new grains, in seconds.
+	float	getGrainDuration() const				{ return mGrainDuration; }
+	//! Sets the position within the Buffer that new grains start reading from, in seconds (default = 0).
+	void	setPosition( float seconds )			{ mPosition = seconds; }
+	//! Returns the position within the Buffer that new grains start reading from, in seconds.
+	float	getPosition() const						{ return mPosition; }
+	//! Sets the maximum random offset applied to the start position of new grains, in seconds (default = 0).
+	void	setPositionJitter( float seconds )		{ mPositionJitter = seconds; }
+	//! Returns the maximum random offset applied to the start position of new grains, in seconds.
+	float	getPositionJitter() const				{ return mPositionJitter; }
+	//! Sets the playback rate of new grains, where 1 is the original pitch and negative values play backwards (default = 1).
+	void	setRate( float rate )					{ mRate = rate; }
+	//! Returns the playback rate of new grains.
+	float	getRate() const							{ return mRate; }
+	//! Sets the maximum random deviation applied to the playback rate of new grains (default = 0).
+	void	setRateJitter( float amount )			{ mRateJitter = amount; }
+	//! Returns the maximum random deviation applied to the playback rate of new grains.
+	float	getRateJitter() const					{ return mRateJitter; }
+	//! Sets the amplitude of new grains (default = 1).
+	void	setGrainAmp( float amp )				{ mGrainAmp = amp; }
+	//! Returns the amplitude of new grains.
+	float	getGrainAmp() const						{ return mGrainAmp; }
+
+	//! Sets the window used as each grain's envelope (default = dsp::WindowType::HANN). Blocks the audio graph while the window is regenerated.
+	void			setWindowType( dsp::WindowType windowType );
+	//! Returns the window used as each grain's envelope.
+	dsp::WindowType	getWindowType() const			{ return mWindowType; }
+
+	//! Returns the number of grains that were active during the last processing block.
+	size_t		getNumActiveGrains() const			{ return mNumActiveGrains; }
+	//! Returns the number of grains that have been dropped because the pool was full, since the last time this method was called.
+	uint64_t	getNumDroppedGrains();
+
+  protected:
+	void initialize()				override;
+	void process( Buffer *buffer )	override;
+
+  private:
+	struct Grain {
+		double	mReadPos;		// read position in the Buffer, in frames
+		float	mRate;
+		float	mAmp;
+		float	mWindowPos;		// position in the window table
+		float	mWindowIncr;
+		size_t	mFramesLeft;
+		size_t	mStartOffset;	// onset within the current processing block, zero after the first block
+	};
+
+	void startGrain( size_t frameOffset );
+	void renderGrain( Grain *grain, Buffer *buffer, size_t frameBegin, size_t frameEnd );
+
+	BufferRef			mBuffer;
+	std::vector<Grain>	mGrains;
+	std::vector<size_t>	mFreeGrains, mActiveGrains;
+	BufferDynamic		mWindow;
+	BufferDynamic		mGrainBuffer;		// holds the envelope of the grain currently being rendered
+	dsp::WindowType		mWindowType;
+	ci::Rand			mRand;
+	double				mFramesUntilNextGrain;
+	float				mSampleRate;
+
+	std::atomic<float>		mDensity, mOnsetJitter, mGrainDuration, mPosition, mPositionJitter, mRate, mRateJitter, mGrainAmp;
+	std::atomic<size_t>		mNumActiveGrains;
+	std::atomic<uint64_t>	mNumDroppedGrains;
+};
+
+} } // namespace cinder::audio
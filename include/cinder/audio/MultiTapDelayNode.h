@@ -0,0 +1,132 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "cinder/audio/Node.h"
+#include "cinder/audio/Param.h"
+
+#include <memory>
+#include <mutex>
+
+namespace cinder { namespace audio {
+
+typedef std::shared_ptr<class MultiTapDelayNode>		MultiTapDelayNodeRef;
+
+//! \brief Multichannel delay with any number of modulated taps, mixed by an input gain, output gain and feedback matrix.
+//!
+//! Each tap owns a delay line per channel and has its own delay time Param, which may vary at audio rate for chorus, flanger or vibrato
+//! style modulation. Fractional delays are read with cubic (default), allpass or linear interpolation. The output of every tap is fed back
+//! into the input of every other tap through an N x N feedback matrix, so this can be used to build feedback delay network reverbs, chorus
+//! banks and multitap echoes within a single Node. Channels are processed independently using the same taps and gains.
+//!
+//! \note Feedback paths are only applied to delays of at least one processing block. Shorter delays still read the dry input.
+class MultiTapDelayNode : public Node {
+  public:
+	//! Describes the interpolation used when reading fractional delay times.
+	enum class Interpolation {
+		//! Cheapest, but attenuates high frequencies as the fractional delay approaches half a sample.
+		LINEAR,
+		//! 4-point Hermite interpolation, a good default for modulated delays.
+		CUBIC,
+		//! First-order allpass interpolation, which has a flat magnitude response. Best used with slowly varying delays.
+		ALLPASS
+	};
+
+	//! Constructs a MultiTapDelayNode with \a numTaps taps and an optional \a format.
+	MultiTapDelayNode( size_t numTaps = 1, const Format &format = Format() );
+
+	//! Returns the number of taps.
+	size_t	getNumTaps() const		{ return mParamsDelaySeconds.size(); }
+
+	//! Sets the maximimum delay in seconds for all taps. This allocates memory and clears the delay lines, so it shouldn't be done frequently.
+	void	setMaxDelaySeconds( float seconds );
+	//! Returns the maximum delay in seconds.
+	float	getMaxDelaySeconds() const		{ return mMaxDelaySeconds; }
+
+	//! Sets the delay value of \a tap in seconds. Increases the max delay seconds if needed.
+	void	setDelaySeconds( size_t tap, float seconds );
+	//! Returns the delay value of \a tap in seconds.
+	float	getDelaySeconds( size_t tap ) const;
+	//! Returns the Param used to automate the delay seconds of \a tap. \note Values over max delay seconds will be clipped.
+	Param*	getParamDelaySeconds( size_t tap );
+
+	//! Sets the gain applied to the input before it is written into \a tap's delay line. Default is 1.
+	void	setInputGain( size_t tap, float gain );
+	//! Returns the input gain of \a tap.
+	float	getInputGain( size_t tap ) const;
+	//! Sets the gain applied to the output of \a tap when it is mixed to the Node's output. Default is 1.
+	void	setOutputGain( size_t tap, float gain );
+	//! Returns the output gain of \a tap.
+	float	getOutputGain( size_t tap ) const;
+	//! Sets the gain of the dry input that is mixed to the Node's output. Default is 0.
+	void	setDryGain( float gain );
+	//! Returns the gain of the dry input that is mixed to the Node's output.
+	float	getDryGain() const;
+
+	//! Sets the amount of \a sourceTap's output that is fed back into \a destTap's delay line. Default is 0.
+	void	setFeedback( size_t destTap, size_t sourceTap, float gain );
+	//! Returns the amount of \a sourceTap's output that is fed back into \a destTap's delay line.
+	float	getFeedback( size_t destTap, size_t sourceTap ) const;
+	//! Sets the entire feedback matrix from \a matrix, which must contain getNumTaps() * getNumTaps() elements in row-major order (one row per destination tap).
+	void	setFeedbackMatrix( const std::vector<float> &matrix );
+	//! Returns a copy of the feedback matrix in row-major order (one row per destination tap).
+	std::vector<float>	getFeedbackMatrix() const;
+
+	//! Sets the Interpolation used when reading fractional delays.
+	void			setInterpolation( Interpolation interpolation );
+	//! Returns the Interpolation used when reading fractional delays.
+	Interpolation	getInterpolation() const	{ return mInterpolation; }
+
+	//! Clears any samples in the delay lines (sets them to zero).
+	void clearBuffer();
+
+  protected:
+	void initialize()				override;
+	void process( Buffer *buffer )	override;
+	bool supportsCycles() const		override	{ return true; }
+
+  private:
+	void resizeDelayLines();
+	void syncGains();
+
+	std::vector<std::unique_ptr<Param>>	mParamsDelaySeconds;
+	std::atomic<Interpolation>			mInterpolation;
+	size_t								mWriteIndex;
+	float								mMaxDelaySeconds, mMaxDelayFrames, mSampleRate;
+
+	// gains written from the user thread, protected by mGainsMutex
+	std::vector<float>		mInputGains, mOutputGains, mFeedbackMatrix;
+	float					mDryGain;
+	std::mutex				mGainsMutex;
+	std::atomic<bool>		mGainsDirty;
+
+	// owned by the audio thread
+	std::vector<float>		mTapInputGains, mTapOutputGains, mTapFeedbackMatrix, mAllpassStates;
+	float					mTapDryGain;
+	BufferDynamic			mDelayLines;	// one channel per tap per channel, each a power of two frames long
+	BufferDynamic			mTapBuffer;		// one channel per tap, holding the current block of tap outputs
+	BufferDynamic			mDelayFramesBuffer;
+};
+
+} } // namespace cinder::audio
@@ -28,5 +28,6 @@
 #include "cinder/audio/GainNode.h"
 #include "cinder/audio/NodeMath.h"
 #include "cinder/audio/DelayNode.h"
+#include "cinder/audio/MultiTapDelayNode.h"
 #include "cinder/audio/PanNode.h"
 #include "cinder/audio/FilterNode.h"
@@ -0,0 +1,112 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "cinder/audio/InputNode.h"
+#include "cinder/audio/WaveTable.h"
+
+#include <mutex>
+
+namespace cinder { namespace audio {
+
+typedef std::shared_ptr<class OscillatorBankNode>	OscillatorBankNodeRef;
+
+//! \brief Renders a bank of band-limited wavetable oscillators ('voices') within a single Node.
+//!
+//! Each voice has its own frequency, amplitude, phase and pan position, and all voices are mixed into the Node's output channels.
+//! This avoids the per-Node overhead of building additive or granular textures from many GenOscNode's. Voice parameters are double
+//! buffered and picked up by the audio thread at the start of the next processing block without blocking the graph; amplitude changes are
+//! ramped over one block to avoid clicks. Voices with an amplitude of zero are skipped.
+//!
+//! The number of output channels defaults to that of the Node's output, and can be specified with Node::Format::channels().
+class OscillatorBankNode : public InputNode {
+  public:
+	//! Constructs an OscillatorBankNode with \a numVoices voices, all of which are initially silent.
+	OscillatorBankNode( size_t numVoices = 0, const Format &format = Format() );
+	//! Constructs an OscillatorBankNode with \a numVoices voices that use \a waveformType.
+	OscillatorBankNode( WaveformType waveformType, size_t numVoices = 0, const Format &format = Format() );
+
+	//! Sets the number of voices. This allocates memory and blocks the audio graph, so it shouldn't be done frequently. New voices are silent.
+	void	setNumVoices( size_t numVoices );
+	//! Returns the number of voices.
+	size_t	getNumVoices() const	{ return mFreqs.size(); }
+
+	//! Sets the frequency of voice \a voice, in hertz.
+	void	setFreq( size_t voice, float freq );
+	//! Sets the amplitude of voice \a voice. Zero amplitude voices aren't processed.
+	void	setAmp( size_t voice, float amp );
+	//! Sets the pan position of voice \a voice, in the range [0:1], spread with equal power across all output channels.
+	void	setPan( size_t voice, float pan );
+	//! Resets the phase of voice \a voice to \a phase (range [0:1]) at the start of the next processing block.
+	void	setPhase( size_t voice, float phase );
+
+	//! Sets the frequencies of \a count voices beginning at \a firstVoice from \a freqs.
+	void	setFreqs( const float *freqs, size_t count, size_t firstVoice = 0 );
+	//! Sets the amplitudes of \a count voices beginning at \a firstVoice from \a amps.
+	void	setAmps( const float *amps, size_t count, size_t firstVoice = 0 );
+	//! Sets the pan positions of \a count voices beginning at \a firstVoice from \a pans.
+	void	setPans( const float *pans, size_t count, size_t firstVoice = 0 );
+
+	//! Returns the frequency of voice \a voice, in hertz.
+	float	getFreq( size_t voice ) const;
+	//! Returns the amplitude of voice \a voice.
+	float	getAmp( size_t voice ) const;
+	//! Returns the pan position of voice \a voice.
+	float	getPan( size_t voice ) const;
+
+	//! Sets the WaveformType used by all voices. This can be a heavy operation and blocks the audio graph.
+	void			setWaveform( WaveformType waveformType );
+	//! Returns the current WaveformType.
+	WaveformType	getWaveform() const		{ return mWaveformType; }
+	//! Assigns \a waveTable as the wavetable shared by all voices. This allows one to share a WaveTable2d with other Node's.
+	void			setWaveTable( const WaveTable2dRef &waveTable );
+	//! Returns a reference to the current wavetable.
+	const WaveTable2dRef&	getWaveTable() const	{ return mWaveTable; }
+
+  protected:
+	void initialize()				override;
+	void process( Buffer *buffer )	override;
+
+  private:
+	void resizeVoices( size_t numVoices );
+	void syncVoiceParams();
+	void updatePanGains( size_t voice );
+
+	WaveTable2dRef		mWaveTable;
+	WaveformType		mWaveformType;
+	float				mSamplePeriod;
+
+	// parameters written from the user thread, protected by mParamsMutex
+	std::vector<float>	mFreqs, mAmps, mPans, mResetPhases, mPanGains1, mPanGains2;
+	std::vector<size_t>	mPanChannels;
+	std::mutex			mParamsMutex;
+	std::atomic<bool>	mParamsDirty;
+
+	// parameters owned by the audio thread
+	std::vector<float>	mVoiceFreqs, mVoiceAmps, mVoiceCurrentAmps, mVoicePhases, mVoicePanGains1, mVoicePanGains2;
+	std::vector<size_t>	mVoiceChannels;
+	BufferDynamic		mVoiceBuffer;
+};
+
+} } // namespace cinder::audio
@@ -83,6 +83,8 @@ class WaveTable2d : public WaveTable {
 	void copyFrom( const float *array, size_t tableIndex );
 
 	float calcBandlimitedTableIndex( float f0 ) const;
+	//! Returns a pointer to the band-limited table appropriate for fundamental frequency \a f0, which is getTableSize() samples long.
+	const float*	getBandLimitedTable( float f0 ) const;
 
 	size_t getNumTables() const	{ return mNumTables; }
 
@@ -91,7 +93,6 @@ class WaveTable2d : public WaveTable {
 	void		fillBandLimitedTable( WaveformType type, float *table, size_t numPartials );
 	size_t		getMaxHarmonicsForTable( size_t tableIndex ) const;
 
-	const float*	getBandLimitedTable( float f0 ) const;
 	std::tuple<const float*, const float*, float> getBandLimitedTablesLerp( float f0 ) const;
 
 	size_t			mNumTables;
@@ -41,7 +41,9 @@
 #include "cinder/audio/NodeMath.h"
 #include "cinder/audio/ChannelRouterNode.h"
 #include "cinder/audio/GenNode.h"
+#include "cinder/audio/GranularNode.h"
 #include "cinder/audio/MonitorNode.h"
+#include "cinder/audio/OscillatorBankNode.h"
 #include "cinder/audio/InputNode.h"
 #include "cinder/audio/OutputNode.h"
 #include "cinder/audio/SamplePlayerNode.h"
@@ -51,5 +53,6 @@
 #include "cinder/audio/dsp/Dsp.h"
 #include "cinder/audio/dsp/Biquad.h"
 #include "cinder/audio/dsp/Converter.h"
+#include "cinder/audio/dsp/ConverterPolyphase.h"
 #include "cinder/audio/dsp/Fft.h"
 #include "cinder/audio/dsp/RingBuffer.h"
@@ -0,0 +1,80 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "cinder/audio/dsp/Converter.h"
+
+#include <vector>
+
+namespace cinder { namespace audio { namespace dsp {
+
+//! \brief \a Converter implementation using a polyphase windowed-sinc FIR filter with precomputed phase tables.
+//!
+//! Considerably cheaper than ConverterImplR8brain at comparable quality for typical music material, and the conversion ratio can be
+//! changed while running (for example to vary playback speed or compensate for clock drift), see setRatio(). All channels are processed
+//! together, so the filter coefficients for each output frame are computed once regardless of the channel count.
+class ConverterImplPolyphase : public Converter {
+  public:
+	//! Trade-off between filter length (and thus cost) and stopband attenuation / passband width.
+	enum class Quality {
+		//! 8 taps, roughly 50 dB stopband attenuation.
+		LOW,
+		//! 24 taps, roughly 75 dB stopband attenuation.
+		MEDIUM,
+		//! 48 taps, roughly 100 dB stopband attenuation.
+		HIGH
+	};
+
+	ConverterImplPolyphase( size_t sourceSampleRate, size_t destSampleRate, size_t sourceNumChannels, size_t destNumChannels, size_t sourceMaxFramesPerBlock, Quality quality = Quality::MEDIUM );
+
+	std::pair<size_t, size_t>	convert( const Buffer *sourceBuffer, Buffer *destBuffer )	override;
+	void						clear()														override;
+
+	//! Sets the conversion ratio, in destination frames per source frame, effective from the next call to convert(). getDestSampleRate() and
+	//! getDestMaxFramesPerBlock() are updated accordingly. \note Lowering the ratio below the one the filter was designed for (more downsampling)
+	//! recomputes the filter tables, which allocates memory and may reset the converter state (see clear()).
+	void	setRatio( double ratio );
+	//! Returns the current conversion ratio, in destination frames per source frame.
+	double	getRatio() const		{ return mRatio; }
+	//! Returns the Quality preset used to design the filter.
+	Quality	getQuality() const		{ return mQuality; }
+	//! Returns the number of filter taps applied to compute each output frame.
+	size_t	getNumTaps() const		{ return mNumTaps; }
+
+  private:
+	void	designFilter( double cutoff );
+	size_t	process( size_t numFrames, Buffer *destBuffer, size_t destMaxFrames );
+
+	Quality				mQuality;
+	double				mRatio, mStep, mDesignCutoff;
+	double				mReadPos;			// fractional read position in mHistory of the next output frame
+	size_t				mNumTaps, mNumPhases, mNumResampledChannels, mHistoryFrames;
+
+	std::vector<float>	mPhaseTable;		// ( mNumPhases + 1 ) rows of mNumTaps coefficients
+	std::vector<float>	mCoeffs;			// interpolated coefficients for the current output frame
+	BufferDynamic		mHistory;			// past and current input frames of each resampled channel
+	BufferDynamic		mMixingBuffer;
+};
+
+} } } // namespace cinder::audio::dsp
@@ -24,10 +24,12 @@
 #pragma once
 
 #include "cinder/audio/Source.h"
+#include "cinder/Filesystem.h"
 
 namespace audioloader {
 
 class FileLoader;
+struct SeekIndex;
 
 } // namespace audioloader
 
@@ -49,16 +51,26 @@ class SourceFileAudioLoader : public SourceFile {
 
 	static std::vector<std::string>	getSupportedExtensions();
 
+	//! Sets the directory used to cache the seek indices of compressed files, so they don't need to be rebuilt the next time a file is opened. Default is empty, which disables caching.
+	static void				setSeekIndexCacheDirectory( const fs::path &directory );
+	//! Returns the directory used to cache the seek indices of compressed files.
+	static const fs::path&	getSeekIndexCacheDirectory();
+
   private:
+	SourceFileAudioLoader( const DataSourceRef &dataSource, size_t sampleRate, const std::shared_ptr<audioloader::SeekIndex> &seekIndex );
+
 	std::unique_ptr<audioloader::FileLoader>	mFileLoader;
+	std::shared_ptr<audioloader::SeekIndex>		mSeekIndex;
 
 	DataSourceRef	mDataSource;  // stored so that clone() can tell if original data source is a file
 	ci::IStreamRef	mStream;
 	BufferDynamic	mAudioData;
 
 	BufferDynamic	mReadBuffer;
+	size_t			mFileReadPos;
 
 	void 			init();
+	size_t			performReadParallel( Buffer *buffer, size_t bufferFrameOffset, size_t numFramesNeeded );
 };
 
 } } } // namespace cinder::audio::linux
\ No newline at end of file
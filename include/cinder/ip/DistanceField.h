@@ -0,0 +1,81 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Channel.h"
+#include "cinder/Surface.h"
+#include "cinder/Shape2d.h"
+
+namespace cinder { namespace ip {
+
+//! Options for distanceField() and multiChannelDistanceField()
+class DistanceFieldFormat {
+  public:
+	DistanceFieldFormat()
+		: mScale( 1 ), mOffset( 0 ), mRange( 4 ), mEvenOddFill( true ), mCornerAngle( 0.15f ), mParallel( true )
+	{}
+
+	//! Sets the number of pixels per unit of the Shape2d. Default is \c 1.
+	DistanceFieldFormat&	scale( float scale ) { mScale = scale; return *this; }
+	//! Sets the offset in pixels of the Shape2d's origin. Default is \c (0,0).
+	DistanceFieldFormat&	offset( const vec2 &offset ) { mOffset = offset; return *this; }
+	//! Sets the distance in pixels at which the field is clamped. Segments further than this from a pixel are never considered for it. Default is \c 4.
+	DistanceFieldFormat&	range( float range ) { mRange = range; return *this; }
+	//! Sets whether the Even-Odd fill rule is used to decide what is inside the Shape2d, rather than the Winding fill rule. Default is \c true.
+	DistanceFieldFormat&	evenOddFill( bool evenOdd = true ) { mEvenOddFill = evenOdd; return *this; }
+	//! Sets the change of direction in radians above which a multi-channel field treats the join of two segments as a corner to be kept sharp. Default is \c 0.15.
+	DistanceFieldFormat&	cornerAngle( float radians ) { mCornerAngle = radians; return *this; }
+	//! Enables splitting the rows of the field across threads. Default is \c true.
+	DistanceFieldFormat&	parallel( bool enable = true ) { mParallel = enable; return *this; }
+
+	float			getScale() const { return mScale; }
+	const vec2&		getOffset() const { return mOffset; }
+	float			getRange() const { return mRange; }
+	bool			isEvenOddFill() const { return mEvenOddFill; }
+	float			getCornerAngle() const { return mCornerAngle; }
+	bool			isParallel() const { return mParallel; }
+
+  protected:
+	float		mScale;
+	vec2		mOffset;
+	float		mRange;
+	bool		mEvenOddFill;
+	float		mCornerAngle;
+	bool		mParallel;
+};
+
+//! Fills \a dstChannel with the signed distance from the center of each pixel to \a shape, measured in pixels, negative inside and clamped to the range of \a format.
+/** Unlike calling Shape2d::calcSignedDistance() for each pixel, only the segments near each band of rows are considered. Every contour is treated as closed. **/
+void		distanceField( const Shape2d &shape, Channel32f *dstChannel, const DistanceFieldFormat &format = DistanceFieldFormat() );
+//! Returns a Channel of \a size filled with the signed distance field of \a shape, as described by distanceField()
+Channel32f	distanceField( const Shape2d &shape, const ivec2 &size, const DistanceFieldFormat &format = DistanceFieldFormat() );
+
+//! Fills the RGB channels of \a dstSurface with a multi-channel signed distance field of \a shape, after Chlumsky's msdfgen. The median of the three channels gives the signed distance
+//! in pixels, but unlike a single-channel field it keeps corners sharp when the field is magnified. If \a dstSurface has an alpha channel it receives the single-channel field.
+void		multiChannelDistanceField( const Shape2d &shape, Surface32f *dstSurface, const DistanceFieldFormat &format = DistanceFieldFormat() );
+//! Returns a Surface of \a size filled with the multi-channel signed distance field of \a shape, as described by multiChannelDistanceField()
+Surface32f	multiChannelDistanceField( const Shape2d &shape, const ivec2 &size, bool alpha = false, const DistanceFieldFormat &format = DistanceFieldFormat() );
+
+} } // namespace cinder::ip
@@ -21,6 +21,7 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/Color.cpp
 	${CINDER_SRC_DIR}/cinder/ConvexHull.cpp
 	${CINDER_SRC_DIR}/cinder/DataSource.cpp
+	${CINDER_SRC_DIR}/cinder/MemoryMappedFile.cpp
 	${CINDER_SRC_DIR}/cinder/DataTarget.cpp
 	${CINDER_SRC_DIR}/cinder/Display.cpp
 	${CINDER_SRC_DIR}/cinder/Exception.cpp
@@ -33,6 +34,7 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/ImageSourceFileStbImage.cpp
 	${CINDER_SRC_DIR}/cinder/ImageTargetFileStbImage.cpp
 	${CINDER_SRC_DIR}/cinder/Json.cpp
+	${CINDER_SRC_DIR}/cinder/JsonStream.cpp
 	${CINDER_SRC_DIR}/cinder/Log.cpp
 	${CINDER_SRC_DIR}/cinder/Matrix.cpp
 	${CINDER_SRC_DIR}/cinder/ObjLoader.cpp
@@ -41,7 +43,9 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/Plane.cpp
 	${CINDER_SRC_DIR}/cinder/PolyLine.cpp
 	${CINDER_SRC_DIR}/cinder/Rand.cpp
+	${CINDER_SRC_DIR}/cinder/Bvh.cpp
 	${CINDER_SRC_DIR}/cinder/Ray.cpp
+	${CINDER_SRC_DIR}/cinder/SpatialHashGrid.cpp
 	${CINDER_SRC_DIR}/cinder/Rect.cpp
 	${CINDER_SRC_DIR}/cinder/Shape2d.cpp
 	${CINDER_SRC_DIR}/cinder/Signals.cpp
@@ -53,8 +57,11 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/Timeline.cpp
 	${CINDER_SRC_DIR}/cinder/TimelineItem.cpp
 	${CINDER_SRC_DIR}/cinder/Timer.cpp
+	${CINDER_SRC_DIR}/cinder/PolygonClipper.cpp
+	${CINDER_SRC_DIR}/cinder/BatchTimeline.cpp
 	${CINDER_SRC_DIR}/cinder/Triangulate.cpp
 	${CINDER_SRC_DIR}/cinder/TriMesh.cpp
+	${CINDER_SRC_DIR}/cinder/TriMeshView.cpp
 	${CINDER_SRC_DIR}/cinder/Tween.cpp
 	${CINDER_SRC_DIR}/cinder/Unicode.cpp
 	${CINDER_SRC_DIR}/cinder/Url.cpp
@@ -102,14 +109,17 @@ list( APPEND SRC_SET_CINDER_AUDIO
 	${CINDER_SRC_DIR}/cinder/audio/ChannelRouterNode.cpp
 	${CINDER_SRC_DIR}/cinder/audio/Context.cpp
 	${CINDER_SRC_DIR}/cinder/audio/DelayNode.cpp
+	${CINDER_SRC_DIR}/cinder/audio/MultiTapDelayNode.cpp
 	${CINDER_SRC_DIR}/cinder/audio/Device.cpp
 	${CINDER_SRC_DIR}/cinder/audio/FileOggVorbis.cpp
 	${CINDER_SRC_DIR}/cinder/audio/FilterNode.cpp
 	${CINDER_SRC_DIR}/cinder/audio/GenNode.cpp
+	${CINDER_SRC_DIR}/cinder/audio/GranularNode.cpp
 	${CINDER_SRC_DIR}/cinder/audio/InputNode.cpp
 	${CINDER_SRC_DIR}/cinder/audio/Node.cpp
 	${CINDER_SRC_DIR}/cinder/audio/NodeMath.cpp
 	${CINDER_SRC_DIR}/cinder/audio/MonitorNode.cpp
+	${CINDER_SRC_DIR}/cinder/audio/OscillatorBankNode.cpp
 	${CINDER_SRC_DIR}/cinder/audio/OutputNode.cpp
 	${CINDER_SRC_DIR}/cinder/audio/PanNode.cpp
 	${CINDER_SRC_DIR}/cinder/audio/Param.cpp
@@ -122,6 +132,7 @@ list( APPEND SRC_SET_CINDER_AUDIO
 	${CINDER_SRC_DIR}/cinder/audio/WaveTable.cpp
 	${CINDER_SRC_DIR}/cinder/audio/dsp/Biquad.cpp
 	${CINDER_SRC_DIR}/cinder/audio/dsp/Converter.cpp
+	${CINDER_SRC_DIR}/cinder/audio/dsp/ConverterPolyphase.cpp
 	${CINDER_SRC_DIR}/cinder/audio/dsp/Dsp.cpp
 	${CINDER_SRC_DIR}/cinder/audio/dsp/Fft.cpp
 )
@@ -184,6 +195,7 @@ list( APPEND SRC_SET_CINDER_IP
 	${CINDER_SRC_DIR}/cinder/ip/Flip.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Hdr.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Resize.cpp
+	${CINDER_SRC_DIR}/cinder/ip/DistanceField.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Trim.cpp
 )
 
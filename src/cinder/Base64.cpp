@@ -21,207 +21,267 @@
  POSSIBILITY OF SUCH DAMAGE.
 */
 
-/* Significant portions of this code come from the public domain libb64 project. For details, see http://sourceforge.net/projects/libb64 */
 
 #include "cinder/Base64.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// The shuffle based encoder and decoder need SSSE3, which MSVC only signals through /arch:AVX
+#if defined( __SSSE3__ ) || defined( __AVX__ )
+	#define CINDER_BASE64_SSSE3
+	#include <tmmintrin.h>
+#endif
+
+// Size of the chunks read from an IStreamCinder by the streaming toBase64() and fromBase64()
+#define BASE64_STREAM_CHUNK_SIZE	( 48 * 1024 )
+
+using namespace std;
+
 namespace {
 
-typedef enum { step_a, step_b, step_c, step_d } base64_decodestep;
+const char sEncoding[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// The 6-bit value of every character, or -1 for characters outside of the alphabet, including the '=' padding
+const int8_t sDecoding[256] = {
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+	52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+	-1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+	15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+	-1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+	41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+#if defined( CINDER_BASE64_SSSE3 )
+// Encodes the first 12 bytes of \a input into 16 characters
+inline __m128i encodeBlock( __m128i input )
+{
+	// spread each group of 3 bytes over 4 bytes, ordered so that the multiplies can move every 6 bits into a byte of its own
+	const __m128i in = _mm_shuffle_epi8( input, _mm_setr_epi8( 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10 ) );
+	const __m128i ac = _mm_mulhi_epu16( _mm_and_si128( in, _mm_set1_epi32( 0x0fc0fc00 ) ), _mm_set1_epi32( 0x04000040 ) );
+	const __m128i bd = _mm_mullo_epi16( _mm_and_si128( in, _mm_set1_epi32( 0x003f03f0 ) ), _mm_set1_epi32( 0x01000010 ) );
+	const __m128i indices = _mm_or_si128( ac, bd );
+
+	// classify each index into one of the alphabet's ranges, then add that range's offset: 13 for 'A'-'Z', 0 for 'a'-'z', 1-10 for '0'-'9', 11 for '+' and 12 for '/'
+	__m128i range = _mm_subs_epu8( indices, _mm_set1_epi8( 51 ) );
+	range = _mm_or_si128( range, _mm_and_si128( _mm_cmpgt_epi8( _mm_set1_epi8( 26 ), indices ), _mm_set1_epi8( 13 ) ) );
+	const __m128i offsets = _mm_setr_epi8( 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0 );
+	return _mm_add_epi8( indices, _mm_shuffle_epi8( offsets, range ) );
+}
+
+// Decodes 16 characters from \a input into 12 bytes of \a output. Returns false without writing anything if any of them are outside of the alphabet.
+inline bool decodeBlock( const uint8_t *input, uint8_t *output )
+{
+	const __m128i in = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input ) );
+	const __m128i hiNibbles = _mm_and_si128( _mm_srli_epi32( in, 4 ), _mm_set1_epi8( 0x0f ) );
+	const __m128i loNibbles = _mm_and_si128( in, _mm_set1_epi8( 0x0f ) );
+
+	// a character is valid when the bit for its high nibble is set in the mask for its low nibble
+	const __m128i validMasks = _mm_setr_epi8( (char)0xa8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf0, 0x54, 0x50, 0x50, 0x50, 0x54 );
+	const __m128i hiBits = _mm_setr_epi8( 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, (char)0x80, 0, 0, 0, 0, 0, 0, 0, 0 );
+	const __m128i valid = _mm_and_si128( _mm_shuffle_epi8( validMasks, loNibbles ), _mm_shuffle_epi8( hiBits, hiNibbles ) );
+	if( _mm_movemask_epi8( _mm_cmpeq_epi8( valid, _mm_setzero_si128() ) ) )
+		return false;
 
-typedef struct {
-	base64_decodestep step;
-	char plainchar;
-} base64_decodestate;
+	// the offset from a character to its value depends only on its high nibble, except for '/' which shares its nibble with '+'
+	const __m128i hiOffsets = _mm_setr_epi8( 0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 );
+	const __m128i isSlash = _mm_cmpeq_epi8( in, _mm_set1_epi8( '/' ) );
+	const __m128i offsets = _mm_or_si128( _mm_andnot_si128( isSlash, _mm_shuffle_epi8( hiOffsets, hiNibbles ) ), _mm_and_si128( isSlash, _mm_set1_epi8( 16 ) ) );
+	const __m128i values = _mm_add_epi8( in, offsets );
 
-int base64_decode_value( char value_in ) {
-	static const char decoding[] = {62,static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),63,52,53,54,55,56,57,58,59,60,61,static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-2),static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51};
-	static const char decoding_size = sizeof(decoding);
-	value_in -= 43;
-	if (value_in < 0 || value_in > decoding_size) return -1;
-	return decoding[(int)value_in];
+	// merge pairs of 6 bit values into 12 bits, then pairs of those into 24, and pack the 3 bytes of each group together
+	const __m128i pairs = _mm_maddubs_epi16( values, _mm_set1_epi32( 0x01400140 ) );
+	const __m128i groups = _mm_madd_epi16( pairs, _mm_set1_epi32( 0x00011000 ) );
+	const __m128i out = _mm_shuffle_epi8( groups, _mm_setr_epi8( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 ) );
+	_mm_storel_epi64( reinterpret_cast<__m128i*>( output ), out );
+	const int32_t last = _mm_cvtsi128_si32( _mm_srli_si128( out, 8 ) );
+	memcpy( output + 8, &last, 4 );
+	return true;
 }
+#endif // defined( CINDER_BASE64_SSSE3 )
 
-void base64_init_decodestate( base64_decodestate* state_in )
+// Encodes \a numGroups groups of 3 bytes from \a input into 4 characters each. Returns the end of the characters written.
+char* encodeGroups( const uint8_t *input, size_t numGroups, char *output )
 {
-	state_in->step = step_a;
-	state_in->plainchar = 0;
+#if defined( CINDER_BASE64_SSSE3 )
+	// each block loads 16 bytes but only consumes 12, so stop while the load stays inside the input
+	for( ; numGroups >= 6; numGroups -= 4 ) {
+		const __m128i in = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( output ), encodeBlock( in ) );
+		input += 12;
+		output += 16;
+	}
+#endif // defined( CINDER_BASE64_SSSE3 )
+	for( ; numGroups > 0; --numGroups ) {
+		const uint32_t group = ( input[0] << 16 ) | ( input[1] << 8 ) | input[2];
+		output[0] = sEncoding[group >> 18];
+		output[1] = sEncoding[( group >> 12 ) & 0x3f];
+		output[2] = sEncoding[( group >> 6 ) & 0x3f];
+		output[3] = sEncoding[group & 0x3f];
+		input += 3;
+		output += 4;
+	}
+	return output;
 }
 
-ptrdiff_t base64_decode_block( const char* code_in, const size_t length_in, char* plaintext_out, base64_decodestate* state_in )
+// Decodes groups of 4 characters from \a *input into 3 bytes each at \a *output, up to the first group with a character outside of the alphabet. Advances both pointers past what was decoded.
+void decodeGroups( const uint8_t **input, const uint8_t *inputEnd, uint8_t **output )
 {
-	const char* codechar = code_in;
-	char* plainchar = plaintext_out;
-	char fragment;
-	
-	*plainchar = state_in->plainchar;
-	
-	switch (state_in->step)
-	{
-		while (1)
-		{
-	case step_a:
-			do {
-				if (codechar == code_in+length_in)
-				{
-					state_in->step = step_a;
-					state_in->plainchar = 0;
-					return plainchar - plaintext_out;
-				}
-				fragment = (char)base64_decode_value(*codechar++);
-			} while (fragment < 0);
-			*plainchar    = (fragment & 0x03f) << 2;
-	case step_b:
-			do {
-				if (codechar == code_in+length_in)
-				{
-					state_in->step = step_b;
-					state_in->plainchar = *plainchar;
-					return plainchar - plaintext_out;
-				}
-				fragment = (char)base64_decode_value(*codechar++);
-			} while (fragment < 0);
-			*plainchar++ |= (fragment & 0x030) >> 4;
-			*plainchar    = (fragment & 0x00f) << 4;
-	case step_c:
-			do {
-				if (codechar == code_in+length_in)
-				{
-					state_in->step = step_c;
-					state_in->plainchar = *plainchar;
-					return plainchar - plaintext_out;
-				}
-				fragment = (char)base64_decode_value(*codechar++);
-			} while (fragment < 0);
-			*plainchar++ |= (fragment & 0x03c) >> 2;
-			*plainchar    = (fragment & 0x003) << 6;
-	case step_d:
-			do {
-				if (codechar == code_in+length_in)
-				{
-					state_in->step = step_d;
-					state_in->plainchar = *plainchar;
-					return plainchar - plaintext_out;
-				}
-				fragment = (char)base64_decode_value(*codechar++);
-			} while (fragment < 0);
-			*plainchar++   |= (fragment & 0x03f);
-		}
+	const uint8_t *in = *input;
+	uint8_t *out = *output;
+#if defined( CINDER_BASE64_SSSE3 )
+	while( inputEnd - in >= 16 && decodeBlock( in, out ) ) {
+		in += 16;
+		out += 12;
+	}
+#endif // defined( CINDER_BASE64_SSSE3 )
+	while( inputEnd - in >= 4 ) {
+		const int32_t a = sDecoding[in[0]], b = sDecoding[in[1]], c = sDecoding[in[2]], d = sDecoding[in[3]];
+		if( ( a | b | c | d ) < 0 )
+			break;
+		const uint32_t group = ( a << 18 ) | ( b << 12 ) | ( c << 6 ) | d;
+		out[0] = uint8_t( group >> 16 );
+		out[1] = uint8_t( group >> 8 );
+		out[2] = uint8_t( group );
+		in += 4;
+		out += 3;
 	}
-	/* control should not reach here */
-	return plainchar - plaintext_out;
+	*input = in;
+	*output = out;
 }
 
+} // anonymous namespace
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-// encode
-typedef enum { step_A, step_B, step_C } base64_encodestep;
+namespace cinder {
 
-typedef struct {
-	base64_encodestep step;
-	char result;
-	int stepcount;
-} base64_encodestate;
+Base64Encoder::Base64Encoder( int charsPerLine )
+	: mNumPending( 0 ), mGroupsPerLine( ( charsPerLine > 0 ) ? charsPerLine / 4 : 0 ), mGroupsOnLine( 0 )
+{
+}
 
-void base64_init_encodestate( base64_encodestate* state_in )
+size_t Base64Encoder::getEncodedSize( size_t inputSize ) const
 {
-	state_in->step = step_A;
-	state_in->result = 0;
-	state_in->stepcount = 0;
+	const size_t numGroups = ( mNumPending + inputSize ) / 3;
+	const size_t numLines = ( mGroupsPerLine > 0 ) ? ( mGroupsOnLine + numGroups ) / mGroupsPerLine : 0;
+	return numGroups * 4 + numLines;
 }
 
-char base64_encode_value(char value_in)
+size_t Base64Encoder::encode( const void *input, size_t inputSize, char *output )
 {
-	static const char* encoding = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-	if (value_in > 63) return '=';
-	return encoding[(int)value_in];
+	const uint8_t *in = static_cast<const uint8_t*>( input );
+	const uint8_t *end = in + inputSize;
+	char *out = output;
+
+	// complete the group held from the previous call first
+	if( mNumPending > 0 ) {
+		while( mNumPending < 3 && in < end )
+			mPending[mNumPending++] = *in++;
+		if( mNumPending < 3 )
+			return 0;
+		out = encodeLines( mPending, 1, out );
+		mNumPending = 0;
+	}
+
+	const size_t numGroups = ( end - in ) / 3;
+	out = encodeLines( in, numGroups, out );
+	in += numGroups * 3;
+	while( in < end )
+		mPending[mNumPending++] = *in++;
+
+	return out - output;
 }
 
-ptrdiff_t base64_encode_block(const char* plaintext_in, size_t length_in, char* code_out, base64_encodestate* state_in, int charsPerLine )
+size_t Base64Encoder::finish( char *output )
 {
-	const char* plainchar = plaintext_in;
-	const char* const plaintextend = plaintext_in + length_in;
-	char* codechar = code_out;
-	char result;
-	char fragment;
-	
-	result = state_in->result;
-	
-	switch (state_in->step)
-	{
-		while (1)
-		{
-	case step_A:
-			if (plainchar == plaintextend)
-			{
-				state_in->result = result;
-				state_in->step = step_A;
-				return codechar - code_out;
-			}
-			fragment = *plainchar++;
-			result = (fragment & 0x0fc) >> 2;
-			*codechar++ = base64_encode_value(result);
-			result = (fragment & 0x003) << 4;
-	case step_B:
-			if (plainchar == plaintextend)
-			{
-				state_in->result = result;
-				state_in->step = step_B;
-				return codechar - code_out;
-			}
-			fragment = *plainchar++;
-			result |= (fragment & 0x0f0) >> 4;
-			*codechar++ = base64_encode_value(result);
-			result = (fragment & 0x00f) << 2;
-	case step_C:
-			if (plainchar == plaintextend)
-			{
-				state_in->result = result;
-				state_in->step = step_C;
-				return codechar - code_out;
-			}
-			fragment = *plainchar++;
-			result |= (fragment & 0x0c0) >> 6;
-			*codechar++ = base64_encode_value(result);
-			result  = (fragment & 0x03f) >> 0;
-			*codechar++ = base64_encode_value(result);
-			
-			++(state_in->stepcount);
-			if ( ( charsPerLine != 0 ) && ( state_in->stepcount == charsPerLine/4 ) )
-			{
-				*codechar++ = '\n';
-				state_in->stepcount = 0;
-			}
-		}
+	size_t result = 0;
+	if( mNumPending > 0 ) {
+		const uint32_t group = ( mPending[0] << 16 ) | ( ( mNumPending > 1 ) ? mPending[1] << 8 : 0 );
+		output[0] = sEncoding[group >> 18];
+		output[1] = sEncoding[( group >> 12 ) & 0x3f];
+		output[2] = ( mNumPending > 1 ) ? sEncoding[( group >> 6 ) & 0x3f] : '=';
+		output[3] = '=';
+		result = 4;
 	}
-	/* control should not reach here */
-	return codechar - code_out;
+
+	mNumPending = 0;
+	mGroupsOnLine = 0;
+	return result;
 }
 
-ptrdiff_t base64_encode_blockend( char* code_out, base64_encodestate* state_in )
+char* Base64Encoder::encodeLines( const uint8_t *input, size_t numGroups, char *output )
 {
-	char* codechar = code_out;
-	
-	switch (state_in->step) {
-	case step_B:
-		*codechar++ = base64_encode_value(state_in->result);
-		*codechar++ = '=';
-		*codechar++ = '=';
-		break;
-	case step_C:
-		*codechar++ = base64_encode_value(state_in->result);
-		*codechar++ = '=';
-		break;
-	case step_A:
-		break;
+	if( mGroupsPerLine == 0 )
+		return encodeGroups( input, numGroups, output );
+
+	while( numGroups > 0 ) {
+		const size_t lineGroups = std::min( numGroups, mGroupsPerLine - mGroupsOnLine );
+		output = encodeGroups( input, lineGroups, output );
+		input += lineGroups * 3;
+		numGroups -= lineGroups;
+		mGroupsOnLine += lineGroups;
+		if( mGroupsOnLine == mGroupsPerLine ) {
+			*output++ = '\n';
+			mGroupsOnLine = 0;
+		}
 	}
-	
-	return codechar - code_out;
+	return output;
 }
 
-} // anonymous namespace
+Base64Decoder::Base64Decoder()
+	: mBits( 0 ), mNumPending( 0 )
+{
+}
 
-////////////////////////////////////////////////////////////////////////////////////////////////////
-namespace cinder {
+size_t Base64Decoder::getDecodedSizeMax( size_t inputSize ) const
+{
+	// every character completes at most 3/4 of a byte, and the pending characters have already written the bytes they complete
+	return getBase64DecodedSizeMax( mNumPending + inputSize ) - mNumPending * 3 / 4;
+}
+
+size_t Base64Decoder::decode( const char *input, size_t inputSize, void *output )
+{
+	const uint8_t *in = reinterpret_cast<const uint8_t*>( input );
+	const uint8_t *end = in + inputSize;
+	uint8_t *out = static_cast<uint8_t*>( output );
+
+	while( in < end ) {
+		if( mNumPending == 0 )
+			decodeGroups( &in, end, &out );
+
+		// one character at a time through line breaks, padding and anything else which interrupts the groups, until the next group boundary
+		while( in < end ) {
+			const int8_t value = sDecoding[*in++];
+			if( value < 0 )
+				continue;
+			mBits = ( mBits << 6 ) | value;
+			++mNumPending;
+			if( mNumPending == 2 )
+				*out++ = uint8_t( mBits >> 4 );
+			else if( mNumPending == 3 )
+				*out++ = uint8_t( mBits >> 2 );
+			else if( mNumPending == 4 ) {
+				*out++ = uint8_t( mBits );
+				mBits = 0;
+				mNumPending = 0;
+				break;
+			}
+		}
+	}
+
+	return out - static_cast<uint8_t*>( output );
+}
 
 std::string toBase64( const std::string &input, int charsPerLine )
 {
@@ -237,19 +297,8 @@ std::string toBase64( const void *input, size_t inputSize, int charsPerLine )
 {
 	if( inputSize == 0 ) return std::string();
 
-	if( charsPerLine != 0 )
-		charsPerLine -= charsPerLine % 4;
-	size_t lines = ( charsPerLine == 0 ) ? 0 : ( inputSize * 4 / 3 / charsPerLine + 1 ); // account for inserted carriage returns
-	char *buffer = new char[inputSize * 4 / 3 + 4 + lines];
-
-	base64_encodestate encs;
-	base64_init_encodestate( &encs );
-	ptrdiff_t resultSize = base64_encode_block( reinterpret_cast<const char*>(input), inputSize, &buffer[0], &encs, charsPerLine );
-	resultSize += base64_encode_blockend( &buffer[resultSize], &encs );
-	buffer[resultSize] = 0; // null terminate the string
-	
-	std::string result( buffer );
-	delete [] buffer;
+	std::string result( getBase64EncodedSize( inputSize, charsPerLine ), 0 );
+	toBase64( input, inputSize, &result[0], charsPerLine );
 	return result;
 }
 
@@ -265,16 +314,65 @@ Buffer fromBase64( const Buffer &input )
 
 Buffer fromBase64( const void *input, size_t inputSize )
 {
-	size_t outputSize = inputSize / 4 * 3;
-	Buffer result( outputSize );
-	if( inputSize >= 4 ) {
-		base64_decodestate decs;
-		base64_init_decodestate( &decs );
-		ptrdiff_t actualSize = base64_decode_block( reinterpret_cast<const char*>(input), inputSize, (char*)result.getData(), &decs );
-		result.setSize( actualSize );
-	}
+	Buffer result( getBase64DecodedSizeMax( inputSize ) );
+	result.setSize( fromBase64( input, inputSize, result.getData() ) );
 	return result;
 }
 
+size_t getBase64EncodedSize( size_t inputSize, int charsPerLine )
+{
+	return Base64Encoder( charsPerLine ).getEncodedSize( inputSize ) + ( ( inputSize % 3 ) ? 4 : 0 );
+}
+
+size_t getBase64DecodedSizeMax( size_t inputSize )
+{
+	return inputSize / 4 * 3 + inputSize % 4 * 3 / 4;
+}
+
+size_t toBase64( const void *input, size_t inputSize, char *output, int charsPerLine )
+{
+	Base64Encoder encoder( charsPerLine );
+	const size_t result = encoder.encode( input, inputSize, output );
+	return result + encoder.finish( output + result );
+}
+
+size_t fromBase64( const void *input, size_t inputSize, void *output )
+{
+	return Base64Decoder().decode( static_cast<const char*>( input ), inputSize, output );
+}
+
+size_t toBase64( const IStreamRef &input, const OStreamRef &output, int charsPerLine )
+{
+	Base64Encoder encoder( charsPerLine );
+	vector<uint8_t> inBuffer( BASE64_STREAM_CHUNK_SIZE );
+	vector<char> outBuffer;
+	size_t result = 0;
+	while( size_t inSize = input->readDataAvailable( inBuffer.data(), inBuffer.size() ) ) {
+		outBuffer.resize( std::max<size_t>( outBuffer.size(), encoder.getEncodedSize( inSize ) ) );
+		const size_t outSize = encoder.encode( inBuffer.data(), inSize, outBuffer.data() );
+		output->writeData( outBuffer.data(), outSize );
+		result += outSize;
+	}
+
+	char tail[4];
+	const size_t tailSize = encoder.finish( tail );
+	output->writeData( tail, tailSize );
+	return result + tailSize;
+}
+
+size_t fromBase64( const IStreamRef &input, const OStreamRef &output )
+{
+	Base64Decoder decoder;
+	vector<char> inBuffer( BASE64_STREAM_CHUNK_SIZE );
+	vector<uint8_t> outBuffer;
+	size_t result = 0;
+	while( size_t inSize = input->readDataAvailable( inBuffer.data(), inBuffer.size() ) ) {
+		outBuffer.resize( std::max<size_t>( outBuffer.size(), decoder.getDecodedSizeMax( inSize ) ) );
+		const size_t outSize = decoder.decode( inBuffer.data(), inSize, outBuffer.data() );
+		output->writeData( outBuffer.data(), outSize );
+		result += outSize;
+	}
+	return result;
+}
 
 } // namespace cinder
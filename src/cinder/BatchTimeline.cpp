@@ -0,0 +1,192 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cinder/BatchTimeline.h"
+
+#include <limits>
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+// Evaluates the tweens of \a group with \a N components at \a time, appending the indices of the completed tweens to \a completed when it is non-null
+template<uint32_t N>
+void evaluateGroup( BatchTimeline::EaseFnPtr easeFn, size_t count, float * const *targets, const float *startTimes, const float *invDurations,
+					const float *startValues, const float *endValues, float time, vector<uint32_t> *completed )
+{
+	for( size_t i = 0; i < count; ++i ) {
+		float t = ( time - startTimes[i] ) * invDurations[i];
+		if( t < 0 )
+			continue;
+		// a zero duration tween at its start time gives NaN, which is treated as complete
+		const bool complete = ! ( t < 1 );
+		if( complete ) {
+			t = 1;
+			if( completed )
+				completed->push_back( (uint32_t)i );
+		}
+
+		const float e = easeFn( t );
+		float *target = targets[i];
+		const float *start = startValues + i * N, *end = endValues + i * N;
+		for( uint32_t c = 0; c < N; ++c )
+			target[c] = start[c] * ( 1 - e ) + end[c] * e;
+	}
+}
+
+} // anonymous namespace
+
+BatchTimeline::BatchTimeline()
+	: mFreeSlot( Handle::INVALID_SLOT ), mNumTweens( 0 ), mCurrentTime( 0 ), mAutoRemove( true )
+{
+}
+
+void BatchTimeline::step( float timestep )
+{
+	stepTo( mCurrentTime + timestep );
+}
+
+void BatchTimeline::stepTo( float absoluteTime )
+{
+	mCurrentTime = absoluteTime;
+
+	for( uint32_t g = 0; g < (uint32_t)mGroups.size(); ++g ) {
+		const Group &group = mGroups[g];
+		const size_t count = group.mTargets.size();
+		if( count == 0 )
+			continue;
+
+		mCompleted.clear();
+		vector<uint32_t> *completed = mAutoRemove ? &mCompleted : nullptr;
+		switch( group.mNumComponents ) {
+			case 1: evaluateGroup<1>( group.mEaseFn, count, group.mTargets.data(), group.mStartTimes.data(), group.mInvDurations.data(), group.mStartValues.data(), group.mEndValues.data(), mCurrentTime, completed ); break;
+			case 2: evaluateGroup<2>( group.mEaseFn, count, group.mTargets.data(), group.mStartTimes.data(), group.mInvDurations.data(), group.mStartValues.data(), group.mEndValues.data(), mCurrentTime, completed ); break;
+			case 3: evaluateGroup<3>( group.mEaseFn, count, group.mTargets.data(), group.mStartTimes.data(), group.mInvDurations.data(), group.mStartValues.data(), group.mEndValues.data(), mCurrentTime, completed ); break;
+			case 4: evaluateGroup<4>( group.mEaseFn, count, group.mTargets.data(), group.mStartTimes.data(), group.mInvDurations.data(), group.mStartValues.data(), group.mEndValues.data(), mCurrentTime, completed ); break;
+		}
+
+		// removing from the back keeps the indices of the remaining completed tweens valid, since only the last tween is moved
+		for( auto it = mCompleted.rbegin(); it != mCompleted.rend(); ++it )
+			removeFromGroup( g, *it );
+	}
+}
+
+BatchTimeline::Handle BatchTimeline::insertComponents( float *target, const float *startValue, const float *endValue, uint32_t numComponents, float startTime, float duration, EaseFnPtr easeFn )
+{
+	uint32_t groupIndex = 0;
+	while( groupIndex < mGroups.size() && ( mGroups[groupIndex].mEaseFn != easeFn || mGroups[groupIndex].mNumComponents != numComponents ) )
+		++groupIndex;
+	if( groupIndex == mGroups.size() ) {
+		mGroups.push_back( Group() );
+		mGroups.back().mEaseFn = easeFn;
+		mGroups.back().mNumComponents = numComponents;
+	}
+
+	uint32_t slotIndex = mFreeSlot;
+	if( slotIndex != Handle::INVALID_SLOT )
+		mFreeSlot = mSlots[slotIndex].mIndex;
+	else {
+		slotIndex = (uint32_t)mSlots.size();
+		mSlots.push_back( Slot() );
+		mSlots.back().mGeneration = 0;
+	}
+
+	Group &group = mGroups[groupIndex];
+	Slot &slot = mSlots[slotIndex];
+	slot.mGroup = groupIndex;
+	slot.mIndex = (uint32_t)group.mTargets.size();
+
+	group.mTargets.push_back( target );
+	group.mStartTimes.push_back( startTime );
+	group.mInvDurations.push_back( ( duration > 0 ) ? ( 1 / duration ) : numeric_limits<float>::infinity() );
+	group.mStartValues.insert( group.mStartValues.end(), startValue, startValue + numComponents );
+	group.mEndValues.insert( group.mEndValues.end(), endValue, endValue + numComponents );
+	group.mSlots.push_back( slotIndex );
+	++mNumTweens;
+
+	return Handle( slotIndex, slot.mGeneration );
+}
+
+bool BatchTimeline::remove( Handle handle )
+{
+	if( ! isActive( handle ) )
+		return false;
+
+	const Slot &slot = mSlots[handle.mSlot];
+	removeFromGroup( slot.mGroup, slot.mIndex );
+	return true;
+}
+
+bool BatchTimeline::isActive( Handle handle ) const
+{
+	return handle.mSlot < mSlots.size() && mSlots[handle.mSlot].mGeneration == handle.mGeneration;
+}
+
+void BatchTimeline::clear()
+{
+	for( auto &group : mGroups ) {
+		for( uint32_t slotIndex : group.mSlots ) {
+			++mSlots[slotIndex].mGeneration;
+			mSlots[slotIndex].mIndex = mFreeSlot;
+			mFreeSlot = slotIndex;
+		}
+	}
+
+	mGroups.clear();
+	mNumTweens = 0;
+}
+
+void BatchTimeline::removeFromGroup( uint32_t groupIndex, uint32_t index )
+{
+	Group &group = mGroups[groupIndex];
+	const uint32_t n = group.mNumComponents;
+	const uint32_t slotIndex = group.mSlots[index];
+	const uint32_t last = (uint32_t)group.mTargets.size() - 1;
+
+	// move the last tween into the removed one's place
+	if( index != last ) {
+		group.mTargets[index] = group.mTargets[last];
+		group.mStartTimes[index] = group.mStartTimes[last];
+		group.mInvDurations[index] = group.mInvDurations[last];
+		copy( group.mStartValues.begin() + last * n, group.mStartValues.begin() + ( last + 1 ) * n, group.mStartValues.begin() + index * n );
+		copy( group.mEndValues.begin() + last * n, group.mEndValues.begin() + ( last + 1 ) * n, group.mEndValues.begin() + index * n );
+		group.mSlots[index] = group.mSlots[last];
+		mSlots[group.mSlots[index]].mIndex = index;
+	}
+
+	group.mTargets.pop_back();
+	group.mStartTimes.pop_back();
+	group.mInvDurations.pop_back();
+	group.mStartValues.resize( last * n );
+	group.mEndValues.resize( last * n );
+	group.mSlots.pop_back();
+
+	++mSlots[slotIndex].mGeneration;
+	mSlots[slotIndex].mIndex = mFreeSlot;
+	mFreeSlot = slotIndex;
+	--mNumTweens;
+}
+
+} // namespace cinder
@@ -0,0 +1,587 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cinder/Bvh.h"
+#include "cinder/TriMesh.h"
+#include "cinder/CinderAssert.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+	#define CINDER_BVH_SSE
+	#include <xmmintrin.h>
+#endif
+
+using namespace std;
+
+// Subtrees with more triangles than this are built on a separate thread
+#define BVH_MIN_PARALLEL_TRIANGLES	16384
+// Leaves hold at most one TrianglePacket
+#define BVH_MAX_LEAF_TRIANGLES		4
+// Must match the limit in Bvh::Format::bins()
+#define BVH_MAX_BINS				64
+
+namespace cinder {
+
+namespace {
+
+struct BuildTriangle {
+	vec3		mMin, mMax, mCentroid;
+	uint32_t	mIndex;
+};
+
+struct BuildNode {
+	vec3						mMin, mMax;
+	uint32_t					mBegin, mEnd;
+	unique_ptr<BuildNode>		mChildren[2];
+};
+
+inline float surfaceArea( const vec3 &min, const vec3 &max )
+{
+	const vec3 size = glm::max( max - min, vec3( 0 ) );
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+// Splits the triangles [begin, end) with a binned surface area heuristic and recurses into the children, on a new thread if there are enough triangles left.
+void buildNode( BuildNode *node, BuildTriangle *triangles, uint32_t begin, uint32_t end, int numBins, int parallelDepth )
+{
+	node->mBegin = begin;
+	node->mEnd = end;
+	node->mMin = vec3( numeric_limits<float>::max() );
+	node->mMax = vec3( -numeric_limits<float>::max() );
+	vec3 centroidMin = node->mMin, centroidMax = node->mMax;
+	for( uint32_t t = begin; t < end; ++t ) {
+		node->mMin = glm::min( node->mMin, triangles[t].mMin );
+		node->mMax = glm::max( node->mMax, triangles[t].mMax );
+		centroidMin = glm::min( centroidMin, triangles[t].mCentroid );
+		centroidMax = glm::max( centroidMax, triangles[t].mCentroid );
+	}
+
+	const uint32_t count = end - begin;
+	if( count <= 1 )
+		return;
+
+	struct Bin {
+		vec3		mMin, mMax;
+		uint32_t	mCount;
+	};
+
+	// bin the triangles along all three axes in a single pass
+	Bin bins[3][BVH_MAX_BINS];
+	vec3 binScale;
+	for( int axis = 0; axis < 3; ++axis ) {
+		const float extent = centroidMax[axis] - centroidMin[axis];
+		binScale[axis] = ( extent > 0 ) ? numBins / extent : 0;
+		for( int b = 0; b < numBins; ++b ) {
+			bins[axis][b].mMin = vec3( numeric_limits<float>::max() );
+			bins[axis][b].mMax = vec3( -numeric_limits<float>::max() );
+			bins[axis][b].mCount = 0;
+		}
+	}
+
+	for( uint32_t t = begin; t < end; ++t ) {
+		const BuildTriangle &triangle = triangles[t];
+		const ivec3 index = glm::min( ivec3( ( triangle.mCentroid - centroidMin ) * binScale ), ivec3( numBins - 1 ) );
+		for( int axis = 0; axis < 3; ++axis ) {
+			Bin &bin = bins[axis][index[axis]];
+			bin.mMin = glm::min( bin.mMin, triangle.mMin );
+			bin.mMax = glm::max( bin.mMax, triangle.mMax );
+			bin.mCount++;
+		}
+	}
+
+	float rightCosts[BVH_MAX_BINS];
+	float bestCost = numeric_limits<float>::max();
+	int bestAxis = -1, bestBin = 0;
+	for( int axis = 0; axis < 3; ++axis ) {
+		if( binScale[axis] == 0 )
+			continue;
+
+		// sweep from the right to find the cost of everything right of each split, then from the left to find the best split
+		vec3 min = vec3( numeric_limits<float>::max() ), max = vec3( -numeric_limits<float>::max() );
+		uint32_t rightCount = 0;
+		for( int b = numBins - 1; b > 0; --b ) {
+			min = glm::min( min, bins[axis][b].mMin );
+			max = glm::max( max, bins[axis][b].mMax );
+			rightCount += bins[axis][b].mCount;
+			rightCosts[b] = rightCount ? surfaceArea( min, max ) * rightCount : 0;
+		}
+
+		min = vec3( numeric_limits<float>::max() );
+		max = vec3( -numeric_limits<float>::max() );
+		uint32_t leftCount = 0;
+		for( int b = 0; b < numBins - 1; ++b ) {
+			min = glm::min( min, bins[axis][b].mMin );
+			max = glm::max( max, bins[axis][b].mMax );
+			leftCount += bins[axis][b].mCount;
+			if( leftCount == 0 || leftCount == count )
+				continue;
+
+			const float cost = surfaceArea( min, max ) * leftCount + rightCosts[b + 1];
+			if( cost < bestCost ) {
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = b;
+			}
+		}
+	}
+
+	// small nodes become leaves when splitting doesn't pay off, which assumes a traversal step costs as much as a triangle test
+	const float area = surfaceArea( node->mMin, node->mMax );
+	if( count <= BVH_MAX_LEAF_TRIANGLES && ( bestAxis < 0 || area + bestCost >= area * count ) )
+		return;
+
+	uint32_t middle;
+	if( bestAxis >= 0 ) {
+		const float axisScale = binScale[bestAxis], axisMin = centroidMin[bestAxis];
+		middle = uint32_t( std::partition( triangles + begin, triangles + end, [=]( const BuildTriangle &t ) {
+			return std::min( numBins - 1, int( ( t.mCentroid[bestAxis] - axisMin ) * axisScale ) ) <= bestBin;
+		} ) - triangles );
+	}
+	else // all centroids coincide, so any split is as good as another
+		middle = begin + count / 2;
+
+	node->mChildren[0].reset( new BuildNode );
+	node->mChildren[1].reset( new BuildNode );
+	if( parallelDepth > 0 && count > BVH_MIN_PARALLEL_TRIANGLES ) {
+		thread left( buildNode, node->mChildren[0].get(), triangles, begin, middle, numBins, parallelDepth - 1 );
+		buildNode( node->mChildren[1].get(), triangles, middle, end, numBins, parallelDepth - 1 );
+		left.join();
+	}
+	else {
+		buildNode( node->mChildren[0].get(), triangles, begin, middle, numBins, 0 );
+		buildNode( node->mChildren[1].get(), triangles, middle, end, numBins, 0 );
+	}
+}
+
+// Slab test of the ray against a node's bounds, returns the entry distance or infinity if it misses within [0, maxDistance].
+inline float intersectBounds( const vec3 &min, const vec3 &max, const vec3 &origin, const vec3 &invDirection, float maxDistance )
+{
+	const vec3 t0 = ( min - origin ) * invDirection;
+	const vec3 t1 = ( max - origin ) * invDirection;
+	const vec3 tNear = glm::min( t0, t1 ), tFar = glm::max( t0, t1 );
+	const float enter = std::max( std::max( tNear.x, tNear.y ), std::max( tNear.z, 0.0f ) );
+	const float exit = std::min( std::min( tFar.x, tFar.y ), std::min( tFar.z, maxDistance ) );
+	return ( enter <= exit ) ? enter : numeric_limits<float>::infinity();
+}
+
+// Like Ray::getInverseDirection() but finite, so that rays parallel to an axis which lie on a node's boundary don't produce 0 * inf = NaN.
+inline vec3 calcInverseDirection( const vec3 &direction )
+{
+	vec3 result;
+	for( int axis = 0; axis < 3; ++axis )
+		result[axis] = ( direction[axis] != 0 ) ? 1.0f / direction[axis] : numeric_limits<float>::max();
+	return result;
+}
+
+// Fixed size stack for traversing the hierarchy, which only allocates for unusually deep trees.
+class TraversalStack {
+  public:
+	TraversalStack( size_t maxDepth )
+		: mData( mBuffer ), mSize( 0 )
+	{
+		if( maxDepth + 1 > sizeof( mBuffer ) / sizeof( mBuffer[0] ) ) {
+			mHeap.resize( maxDepth + 1 );
+			mData = mHeap.data();
+		}
+	}
+
+	bool		empty() const			{ return mSize == 0; }
+	void		push( uint32_t node )	{ mData[mSize++] = node; }
+	uint32_t	pop()					{ return mData[--mSize]; }
+
+  private:
+	uint32_t			mBuffer[64];
+	vector<uint32_t>	mHeap;
+	uint32_t*			mData;
+	size_t				mSize;
+};
+
+} // anonymous namespace
+
+Bvh::Bvh( const geom::Source &source, const Format &format )
+	: mNumTriangles( 0 ), mMaxDepth( 0 )
+{
+	TriMesh mesh( source, TriMesh::Format().positions() );
+	if( mesh.getAttribDims( geom::POSITION ) != 3 )
+		throw geom::ExcIllegalSourceDimensions();
+
+	build( mesh.getPositions<3>(), mesh.getNumVertices(), mesh.getIndices().data(), mesh.getNumIndices(), format );
+}
+
+Bvh::Bvh( const vec3 *positions, size_t numVertices, const uint32_t *indices, size_t numIndices, const Format &format )
+	: mNumTriangles( 0 ), mMaxDepth( 0 )
+{
+	build( positions, numVertices, indices, numIndices, format );
+}
+
+void Bvh::build( const vec3 *positions, size_t numVertices, const uint32_t *indices, size_t numIndices, const Format &format )
+{
+	mNumTriangles = numIndices / 3;
+
+	vector<BuildTriangle> triangles( mNumTriangles );
+	for( size_t t = 0; t < mNumTriangles; ++t ) {
+		CI_ASSERT( indices[t * 3] < numVertices && indices[t * 3 + 1] < numVertices && indices[t * 3 + 2] < numVertices );
+		const vec3 &a = positions[indices[t * 3]], &b = positions[indices[t * 3 + 1]], &c = positions[indices[t * 3 + 2]];
+		triangles[t].mMin = glm::min( a, glm::min( b, c ) );
+		triangles[t].mMax = glm::max( a, glm::max( b, c ) );
+		triangles[t].mCentroid = ( a + b + c ) / 3.0f;
+		triangles[t].mIndex = (uint32_t)t;
+	}
+
+	mNodes.clear();
+	mPackets.clear();
+	mPacketTriangles.clear();
+	mPacketIndices.clear();
+	mMaxDepth = 0;
+	if( triangles.empty() )
+		return;
+
+	// each level of parallelDepth doubles the number of threads
+	int parallelDepth = 0;
+	if( format.isParallel() ) {
+		for( unsigned int threads = 1; threads < thread::hardware_concurrency(); threads *= 2 )
+			parallelDepth++;
+	}
+
+	BuildNode root;
+	buildNode( &root, triangles.data(), 0, (uint32_t)triangles.size(), format.getNumBins(), parallelDepth );
+
+	// flatten the build tree in depth-first order, so that the first child of an interior node is always next to it
+	mNodes.reserve( mNumTriangles * 2 / BVH_MAX_LEAF_TRIANGLES + 1 );
+	struct Entry {
+		const BuildNode		*mNode;
+		uint32_t			mParent;
+		size_t				mDepth;
+	};
+
+	vector<Entry> stack( 1, Entry{ &root, ~0u, 0 } );
+	while( ! stack.empty() ) {
+		const Entry entry = stack.back();
+		stack.pop_back();
+
+		const uint32_t index = (uint32_t)mNodes.size();
+		// the parent's second child is the one that was pushed first, so it is placed after the whole first subtree
+		if( entry.mParent != ~0u && mNodes[entry.mParent].mOffset == 0 && index != entry.mParent + 1 )
+			mNodes[entry.mParent].mOffset = index;
+		mMaxDepth = std::max( mMaxDepth, entry.mDepth );
+
+		Node node;
+		node.mMin = entry.mNode->mMin;
+		node.mMax = entry.mNode->mMax;
+		if( ! entry.mNode->mChildren[0] ) {
+			node.mOffset = (uint32_t)mPackets.size();
+			node.mCount = entry.mNode->mEnd - entry.mNode->mBegin;
+			mNodes.push_back( node );
+
+			mPackets.push_back( TrianglePacket() );
+			for( uint32_t slot = 0; slot < BVH_MAX_LEAF_TRIANGLES; ++slot ) {
+				const bool used = slot < node.mCount;
+				const uint32_t triangle = used ? triangles[entry.mNode->mBegin + slot].mIndex : ~0u;
+				mPacketTriangles.push_back( triangle );
+				for( int v = 0; v < 3; ++v )
+					mPacketIndices.push_back( used ? indices[triangle * 3 + v] : 0 );
+			}
+			updatePacket( mPackets.size() - 1, positions );
+		}
+		else {
+			node.mOffset = 0;
+			node.mCount = 0;
+			mNodes.push_back( node );
+			stack.push_back( Entry{ entry.mNode->mChildren[1].get(), index, entry.mDepth + 1 } );
+			stack.push_back( Entry{ entry.mNode->mChildren[0].get(), index, entry.mDepth + 1 } );
+		}
+	}
+}
+
+void Bvh::updatePacket( size_t packet, const vec3 *positions )
+{
+	TrianglePacket &p = mPackets[packet];
+	for( size_t slot = 0; slot < BVH_MAX_LEAF_TRIANGLES; ++slot ) {
+		const uint32_t *indices = &mPacketIndices[( packet * BVH_MAX_LEAF_TRIANGLES + slot ) * 3];
+		const bool used = mPacketTriangles[packet * BVH_MAX_LEAF_TRIANGLES + slot] != ~0u;
+		const vec3 v0 = used ? positions[indices[0]] : vec3( 0 );
+		const vec3 e1 = used ? positions[indices[1]] - v0 : vec3( 0 );
+		const vec3 e2 = used ? positions[indices[2]] - v0 : vec3( 0 );
+		for( int axis = 0; axis < 3; ++axis ) {
+			p.mVertex0[axis][slot] = v0[axis];
+			p.mEdge1[axis][slot] = e1[axis];
+			p.mEdge2[axis][slot] = e2[axis];
+		}
+	}
+}
+
+void Bvh::refit( const vec3 *positions, size_t numVertices )
+{
+	for( size_t packet = 0; packet < mPackets.size(); ++packet ) {
+		for( size_t i = 0; i < BVH_MAX_LEAF_TRIANGLES * 3; ++i )
+			CI_ASSERT( mPacketIndices[packet * BVH_MAX_LEAF_TRIANGLES * 3 + i] < numVertices );
+		updatePacket( packet, positions );
+	}
+
+	// children are always stored after their parent, so a reverse sweep updates them first
+	for( size_t n = mNodes.size(); n-- > 0; ) {
+		Node &node = mNodes[n];
+		if( node.mCount ) {
+			const TrianglePacket &p = mPackets[node.mOffset];
+			node.mMin = vec3( numeric_limits<float>::max() );
+			node.mMax = vec3( -numeric_limits<float>::max() );
+			for( uint32_t slot = 0; slot < node.mCount; ++slot ) {
+				const vec3 v0( p.mVertex0[0][slot], p.mVertex0[1][slot], p.mVertex0[2][slot] );
+				const vec3 v1 = v0 + vec3( p.mEdge1[0][slot], p.mEdge1[1][slot], p.mEdge1[2][slot] );
+				const vec3 v2 = v0 + vec3( p.mEdge2[0][slot], p.mEdge2[1][slot], p.mEdge2[2][slot] );
+				node.mMin = glm::min( node.mMin, glm::min( v0, glm::min( v1, v2 ) ) );
+				node.mMax = glm::max( node.mMax, glm::max( v0, glm::max( v1, v2 ) ) );
+			}
+		}
+		else {
+			const Node &first = mNodes[n + 1], &second = mNodes[node.mOffset];
+			node.mMin = glm::min( first.mMin, second.mMin );
+			node.mMax = glm::max( first.mMax, second.mMax );
+		}
+	}
+}
+
+void Bvh::refit( const geom::Source &source )
+{
+	TriMesh mesh( source, TriMesh::Format().positions() );
+	if( mesh.getAttribDims( geom::POSITION ) != 3 )
+		throw geom::ExcIllegalSourceDimensions();
+
+	refit( mesh.getPositions<3>(), mesh.getNumVertices() );
+}
+
+AxisAlignedBox Bvh::getBounds() const
+{
+	if( mNodes.empty() )
+		return AxisAlignedBox();
+
+	return AxisAlignedBox( mNodes[0].mMin, mNodes[0].mMax );
+}
+
+bool Bvh::closestHit( const Ray &ray, Hit *result, float maxDistance ) const
+{
+	return traceRay<false>( ray, maxDistance, result );
+}
+
+bool Bvh::anyHit( const Ray &ray, float maxDistance ) const
+{
+	Hit hit;
+	return traceRay<true>( ray, maxDistance, &hit );
+}
+
+template<bool AnyHit>
+bool Bvh::traceRay( const Ray &ray, float maxDistance, Hit *result ) const
+{
+	if( mNodes.empty() )
+		return false;
+
+	const vec3 &origin = ray.getOrigin(), &direction = ray.getDirection();
+	const vec3 invDirection = calcInverseDirection( direction );
+	float closest = maxDistance;
+	bool found = false;
+
+#if defined( CINDER_BVH_SSE )
+	const __m128 originX = _mm_set1_ps( origin.x ), originY = _mm_set1_ps( origin.y ), originZ = _mm_set1_ps( origin.z );
+	const __m128 directionX = _mm_set1_ps( direction.x ), directionY = _mm_set1_ps( direction.y ), directionZ = _mm_set1_ps( direction.z );
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps( 1.0f ), epsilon = _mm_set1_ps( 0.000001f );
+	const __m128 absMask = _mm_castsi128_ps( _mm_set1_epi32( 0x7FFFFFFF ) );
+#endif
+
+	TraversalStack stack( mMaxDepth );
+	stack.push( 0 );
+	while( ! stack.empty() ) {
+		const Node &node = mNodes[stack.pop()];
+		if( intersectBounds( node.mMin, node.mMax, origin, invDirection, closest ) == numeric_limits<float>::infinity() )
+			continue;
+
+		if( node.mCount ) {
+			// Moller-Trumbore against all four triangles of the leaf, as in Ray::calcTriangleIntersection()
+			const TrianglePacket &p = mPackets[node.mOffset];
+			float t[4], u[4], v[4];
+			int hitMask;
+#if defined( CINDER_BVH_SSE )
+			const __m128 e1x = _mm_loadu_ps( p.mEdge1[0] ), e1y = _mm_loadu_ps( p.mEdge1[1] ), e1z = _mm_loadu_ps( p.mEdge1[2] );
+			const __m128 e2x = _mm_loadu_ps( p.mEdge2[0] ), e2y = _mm_loadu_ps( p.mEdge2[1] ), e2z = _mm_loadu_ps( p.mEdge2[2] );
+
+			// pvec = direction x edge2
+			const __m128 px = _mm_sub_ps( _mm_mul_ps( directionY, e2z ), _mm_mul_ps( directionZ, e2y ) );
+			const __m128 py = _mm_sub_ps( _mm_mul_ps( directionZ, e2x ), _mm_mul_ps( directionX, e2z ) );
+			const __m128 pz = _mm_sub_ps( _mm_mul_ps( directionX, e2y ), _mm_mul_ps( directionY, e2x ) );
+			const __m128 det = _mm_add_ps( _mm_add_ps( _mm_mul_ps( e1x, px ), _mm_mul_ps( e1y, py ) ), _mm_mul_ps( e1z, pz ) );
+			const __m128 invDet = _mm_div_ps( one, det );
+
+			// tvec = origin - vertex0
+			const __m128 tx = _mm_sub_ps( originX, _mm_loadu_ps( p.mVertex0[0] ) );
+			const __m128 ty = _mm_sub_ps( originY, _mm_loadu_ps( p.mVertex0[1] ) );
+			const __m128 tz = _mm_sub_ps( originZ, _mm_loadu_ps( p.mVertex0[2] ) );
+			const __m128 u4 = _mm_mul_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( tx, px ), _mm_mul_ps( ty, py ) ), _mm_mul_ps( tz, pz ) ), invDet );
+
+			// qvec = tvec x edge1
+			const __m128 qx = _mm_sub_ps( _mm_mul_ps( ty, e1z ), _mm_mul_ps( tz, e1y ) );
+			const __m128 qy = _mm_sub_ps( _mm_mul_ps( tz, e1x ), _mm_mul_ps( tx, e1z ) );
+			const __m128 qz = _mm_sub_ps( _mm_mul_ps( tx, e1y ), _mm_mul_ps( ty, e1x ) );
+			const __m128 v4 = _mm_mul_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( directionX, qx ), _mm_mul_ps( directionY, qy ) ), _mm_mul_ps( directionZ, qz ) ), invDet );
+			const __m128 t4 = _mm_mul_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( e2x, qx ), _mm_mul_ps( e2y, qy ) ), _mm_mul_ps( e2z, qz ) ), invDet );
+
+			__m128 mask = _mm_cmpgt_ps( _mm_and_ps( det, absMask ), epsilon );
+			mask = _mm_and_ps( mask, _mm_cmpge_ps( u4, zero ) );
+			mask = _mm_and_ps( mask, _mm_cmpge_ps( v4, zero ) );
+			mask = _mm_and_ps( mask, _mm_cmple_ps( _mm_add_ps( u4, v4 ), one ) );
+			mask = _mm_and_ps( mask, _mm_cmpge_ps( t4, zero ) );
+			mask = _mm_and_ps( mask, _mm_cmplt_ps( t4, _mm_set1_ps( closest ) ) );
+			hitMask = _mm_movemask_ps( mask );
+			_mm_storeu_ps( t, t4 );
+			_mm_storeu_ps( u, u4 );
+			_mm_storeu_ps( v, v4 );
+#else
+			hitMask = 0;
+			for( uint32_t slot = 0; slot < node.mCount; ++slot ) {
+				const vec3 e1( p.mEdge1[0][slot], p.mEdge1[1][slot], p.mEdge1[2][slot] );
+				const vec3 e2( p.mEdge2[0][slot], p.mEdge2[1][slot], p.mEdge2[2][slot] );
+				const vec3 pvec = cross( direction, e2 );
+				const float det = dot( e1, pvec );
+				if( det > -0.000001f && det < 0.000001f )
+					continue;
+
+				const float invDet = 1.0f / det;
+				const vec3 tvec = origin - vec3( p.mVertex0[0][slot], p.mVertex0[1][slot], p.mVertex0[2][slot] );
+				const vec3 qvec = cross( tvec, e1 );
+				u[slot] = dot( tvec, pvec ) * invDet;
+				v[slot] = dot( direction, qvec ) * invDet;
+				t[slot] = dot( e2, qvec ) * invDet;
+				if( u[slot] >= 0 && v[slot] >= 0 && u[slot] + v[slot] <= 1 && t[slot] >= 0 && t[slot] < closest )
+					hitMask |= 1 << slot;
+			}
+#endif
+
+			for( uint32_t slot = 0; hitMask; ++slot, hitMask >>= 1 ) {
+				if( ( hitMask & 1 ) && t[slot] < closest ) {
+					closest = t[slot];
+					result->mTriangle = mPacketTriangles[node.mOffset * BVH_MAX_LEAF_TRIANGLES + slot];
+					result->mDistance = t[slot];
+					result->mU = u[slot];
+					result->mV = v[slot];
+					found = true;
+				}
+			}
+
+			if( AnyHit && found )
+				return true;
+		}
+		else {
+			// visit the nearer child first so that closer hits prune the other one
+			const uint32_t first = uint32_t( &node - mNodes.data() ) + 1, second = node.mOffset;
+			const float firstDistance = intersectBounds( mNodes[first].mMin, mNodes[first].mMax, origin, invDirection, closest );
+			const float secondDistance = intersectBounds( mNodes[second].mMin, mNodes[second].mMax, origin, invDirection, closest );
+			if( firstDistance <= secondDistance ) {
+				if( secondDistance != numeric_limits<float>::infinity() )
+					stack.push( second );
+				if( firstDistance != numeric_limits<float>::infinity() )
+					stack.push( first );
+			}
+			else {
+				if( firstDistance != numeric_limits<float>::infinity() )
+					stack.push( first );
+				stack.push( second );
+			}
+		}
+	}
+
+	return found;
+}
+
+template<typename OverlapFn, typename ContainsFn>
+void Bvh::queryTrianglesImpl( const OverlapFn &overlaps, const ContainsFn &contains, vector<uint32_t> *result ) const
+{
+	if( mNodes.empty() )
+		return;
+
+	TraversalStack stack( mMaxDepth );
+	stack.push( 0 );
+	while( ! stack.empty() ) {
+		const uint32_t index = stack.pop();
+		const Node &node = mNodes[index];
+		if( ! overlaps( node.mMin, node.mMax ) )
+			continue;
+
+		// everything below a node that is fully contained is part of the result, its subtree ends where the next sibling starts
+		if( contains( node.mMin, node.mMax ) ) {
+			uint32_t end = (uint32_t)mNodes.size();
+			for( uint32_t n = 0; n < index; ) {
+				const Node &ancestor = mNodes[n];
+				if( ancestor.mCount )
+					break;
+				if( index < ancestor.mOffset ) {
+					end = ancestor.mOffset;
+					n = n + 1;
+				}
+				else
+					n = ancestor.mOffset;
+			}
+
+			for( uint32_t n = index; n < end; ++n ) {
+				if( mNodes[n].mCount )
+					result->insert( result->end(), mPacketTriangles.begin() + mNodes[n].mOffset * BVH_MAX_LEAF_TRIANGLES,
+									mPacketTriangles.begin() + mNodes[n].mOffset * BVH_MAX_LEAF_TRIANGLES + mNodes[n].mCount );
+			}
+			continue;
+		}
+
+		if( node.mCount ) {
+			const TrianglePacket &p = mPackets[node.mOffset];
+			for( uint32_t slot = 0; slot < node.mCount; ++slot ) {
+				const vec3 v0( p.mVertex0[0][slot], p.mVertex0[1][slot], p.mVertex0[2][slot] );
+				const vec3 v1 = v0 + vec3( p.mEdge1[0][slot], p.mEdge1[1][slot], p.mEdge1[2][slot] );
+				const vec3 v2 = v0 + vec3( p.mEdge2[0][slot], p.mEdge2[1][slot], p.mEdge2[2][slot] );
+				if( overlaps( glm::min( v0, glm::min( v1, v2 ) ), glm::max( v0, glm::max( v1, v2 ) ) ) )
+					result->push_back( mPacketTriangles[node.mOffset * BVH_MAX_LEAF_TRIANGLES + slot] );
+			}
+		}
+		else {
+			stack.push( node.mOffset );
+			stack.push( index + 1 );
+		}
+	}
+}
+
+void Bvh::queryTriangles( const AxisAlignedBox &box, vector<uint32_t> *result ) const
+{
+	const vec3 boxMin = box.getMin(), boxMax = box.getMax();
+	queryTrianglesImpl(
+		[&]( const vec3 &min, const vec3 &max ) { return all( lessThanEqual( min, boxMax ) ) && all( greaterThanEqual( max, boxMin ) ); },
+		[&]( const vec3 &min, const vec3 &max ) { return all( greaterThanEqual( min, boxMin ) ) && all( lessThanEqual( max, boxMax ) ); },
+		result );
+}
+
+void Bvh::queryTriangles( const Frustum &frustum, vector<uint32_t> *result ) const
+{
+	queryTrianglesImpl(
+		[&]( const vec3 &min, const vec3 &max ) { return frustum.intersects( AxisAlignedBox( min, max ) ); },
+		[&]( const vec3 &min, const vec3 &max ) { return frustum.contains( AxisAlignedBox( min, max ) ); },
+		result );
+}
+
+} // namespace cinder
@@ -32,6 +32,9 @@
 #include "cinder/Matrix.h"
 #include "cinder/Sphere.h"
 #include <algorithm>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
 
 #if defined( CINDER_ANDROID )
   #include "cinder/app/App.h"
@@ -39,8 +42,33 @@
 
 using namespace std;
 
+// Per-vertex Modifiers split their work across threads for at least this many vertices
+#define GEOM_MIN_PARALLEL_VERTICES	32768
+
 namespace cinder { namespace geom {
 
+namespace {
+
+// Calls fn( begin, end ) for ranges covering [0, count), spread across threads if \a parallel and there are enough elements.
+template<typename Fn>
+void parallelFor( size_t count, const Fn &fn, bool parallel = true )
+{
+	const size_t numThreads = parallel ? std::min<size_t>( thread::hardware_concurrency(), count / GEOM_MIN_PARALLEL_VERTICES ) : 1;
+	if( numThreads <= 1 ) {
+		fn( 0, count );
+		return;
+	}
+
+	vector<thread> threads;
+	for( size_t t = 1; t < numThreads; ++t )
+		threads.push_back( thread( fn, count * t / numThreads, count * ( t + 1 ) / numThreads ) );
+	fn( 0, count / numThreads );
+	for( auto &t : threads )
+		t.join();
+}
+
+} // anonymous namespace
+
 std::string sAttribNames[(int)Attrib::NUM_ATTRIBS] = {
 	"POSITION", "COLOR", "TEX_COORD_0", "TEX_COORD_1", "TEX_COORD_2", "TEX_COORD_3",
 	"NORMAL", "TANGENT", "BITANGENT", "BONE_INDEX", "BONE_WEIGHT",
@@ -444,6 +472,611 @@ void calculateTangents( size_t numIndices, const uint32_t *indices, size_t numVe
 	calculateTangentsImpl( numIndices, indices, numVertices, positions, normals, texCoords, resultTangents, resultBitangents );
 }
 
+namespace {
+
+const uint32_t WELD_NONE = numeric_limits<uint32_t>::max();
+
+inline uint64_t hashWeldCell( int64_t x, int64_t y, int64_t z )
+{
+	return ( uint64_t( x ) * 73856093ULL ) ^ ( uint64_t( y ) * 19349663ULL ) ^ ( uint64_t( z ) * 83492791ULL );
+}
+
+// Returns the grid cell of \a value. When welding exactly, the cell is the value's bit pattern (with -0 folded into +0).
+// Otherwise it is clamped so that huge or non-finite positions still land in a valid, if crowded, cell.
+inline int64_t toWeldCell( float value, float invCellSize )
+{
+	if( invCellSize == 0 ) {
+		value += 0.0f;
+		uint32_t bits;
+		memcpy( &bits, &value, sizeof( bits ) );
+		return bits;
+	}
+
+	float cell = floor( value * invCellSize );
+	if( ! ( cell > -1e15f ) )
+		cell = -1e15f;
+	else if( cell > 1e15f )
+		cell = 1e15f;
+
+	return (int64_t)cell;
+}
+
+} // anonymous namespace
+
+size_t calculateWeldMap( size_t numVertices, const vec3 *positions, float tolerance, vector<uint32_t> *resultRemap, const function<bool( uint32_t, uint32_t )> &isEquivalent )
+{
+	resultRemap->resize( numVertices );
+
+	// cells are as wide as the tolerance so only the neighboring cells need to be searched, or exact bit patterns when the tolerance is zero.
+	const bool exact = tolerance <= 0;
+	const float tolerance2 = exact ? 0 : tolerance * tolerance;
+	const float invCellSize = exact ? 0 : 1 / tolerance;
+	const int64_t searchRadius = exact ? 0 : 1;
+
+	// maps a cell's hash to the most recently added unique vertex within it, earlier unique vertices with the same hash are linked through cellNext.
+	unordered_map<uint64_t, uint32_t> cellHeads;
+	cellHeads.reserve( numVertices );
+	vector<uint32_t> cellNext( numVertices, WELD_NONE );
+
+	size_t numUnique = 0;
+	for( uint32_t i = 0; i < (uint32_t)numVertices; ++i ) {
+		const vec3 &p = positions[i];
+		const int64_t cx = toWeldCell( p.x, invCellSize );
+		const int64_t cy = toWeldCell( p.y, invCellSize );
+		const int64_t cz = toWeldCell( p.z, invCellSize );
+
+		uint32_t match = WELD_NONE;
+		for( int64_t z = cz - searchRadius; z <= cz + searchRadius; ++z ) {
+			for( int64_t y = cy - searchRadius; y <= cy + searchRadius; ++y ) {
+				for( int64_t x = cx - searchRadius; x <= cx + searchRadius; ++x ) {
+					auto cellIt = cellHeads.find( hashWeldCell( x, y, z ) );
+					if( cellIt == cellHeads.end() )
+						continue;
+
+					for( uint32_t j = cellIt->second; j != WELD_NONE; j = cellNext[j] ) {
+						if( j < match && distance2( positions[j], p ) <= tolerance2 && ( ! isEquivalent || isEquivalent( j, i ) ) )
+							match = j;
+					}
+				}
+			}
+		}
+
+		if( match != WELD_NONE ) {
+			(*resultRemap)[i] = match;
+			continue;
+		}
+
+		(*resultRemap)[i] = i;
+		++numUnique;
+
+		auto inserted = cellHeads.emplace( hashWeldCell( cx, cy, cz ), i );
+		if( ! inserted.second ) {
+			cellNext[i] = inserted.first->second;
+			inserted.first->second = i;
+		}
+	}
+
+	return numUnique;
+}
+
+namespace {
+
+// open boundaries are constrained by planes perpendicular to their faces, weighted this much more than the faces themselves
+const double SIMPLIFY_BORDER_WEIGHT = 10;
+// a collapse is rejected if it rotates any remaining face normal by more than acos() of this
+const float SIMPLIFY_MIN_NORMAL_DOT = 0.25f;
+
+// Garland, Michael and Heckbert, Paul. "Surface Simplification Using Quadric Error Metrics". SIGGRAPH 1997.
+// Symmetric 4x4 quadric of weighted squared distances to a set of planes.
+struct Quadric {
+	Quadric()
+		: a00( 0 ), a01( 0 ), a02( 0 ), a11( 0 ), a12( 0 ), a22( 0 ), b0( 0 ), b1( 0 ), b2( 0 ), c( 0 ), w( 0 )
+	{}
+
+	void addPlane( const dvec3 &n, double d, double weight )
+	{
+		a00 += weight * n.x * n.x; a01 += weight * n.x * n.y; a02 += weight * n.x * n.z;
+		a11 += weight * n.y * n.y; a12 += weight * n.y * n.z; a22 += weight * n.z * n.z;
+		b0 += weight * n.x * d; b1 += weight * n.y * d; b2 += weight * n.z * d;
+		c += weight * d * d;
+		w += weight;
+	}
+
+	Quadric& operator+=( const Quadric &rhs )
+	{
+		a00 += rhs.a00; a01 += rhs.a01; a02 += rhs.a02; a11 += rhs.a11; a12 += rhs.a12; a22 += rhs.a22;
+		b0 += rhs.b0; b1 += rhs.b1; b2 += rhs.b2; c += rhs.c; w += rhs.w;
+		return *this;
+	}
+
+	// weighted sum of squared distances from \a p to the planes
+	double eval( const vec3 &p ) const
+	{
+		const double x = p.x, y = p.y, z = p.z;
+		const double result = x * x * a00 + y * y * a11 + z * z * a22 + 2 * ( x * y * a01 + x * z * a02 + y * z * a12 )
+								+ 2 * ( x * b0 + y * b1 + z * b2 ) + c;
+		return std::max( result, 0.0 );
+	}
+
+	double a00, a01, a02, a11, a12, a22, b0, b1, b2, c, w;
+};
+
+inline uint64_t simplifyEdgeKey( uint32_t a, uint32_t b )
+{
+	return ( (uint64_t)a << 32 ) | b;
+}
+
+struct SimplifyCollapse {
+	uint32_t	mFrom, mTo;
+	float		mError; // squared
+	bool operator<( const SimplifyCollapse &rhs ) const { return mError < rhs.mError; }
+};
+
+} // anonymous namespace
+
+size_t calculateSimplifiedIndices( size_t numIndices, const uint32_t *indices, size_t numVertices, const vec3 *positions, size_t targetNumIndices, float maxError, vector<uint32_t> *resultIndices, float *resultError )
+{
+	resultIndices->assign( indices, indices + numIndices - numIndices % 3 );
+	vector<uint32_t> &tris = *resultIndices;
+	float error = 0;
+
+	// the surface is defined by positions alone; 'wedges' are the vertices that share a position but differ in other attributes
+	vector<uint32_t> posRemap;
+	calculateWeldMap( numVertices, positions, 0, &posRemap );
+	// circular lists of the wedges of each position
+	vector<uint32_t> wedgeNext( numVertices );
+	for( uint32_t v = 0; v < (uint32_t)numVertices; ++v ) {
+		const uint32_t p = posRemap[v];
+		if( p == v )
+			wedgeNext[v] = v;
+		else {
+			wedgeNext[v] = wedgeNext[p];
+			wedgeNext[p] = v;
+		}
+	}
+
+	// directed edges of the triangles by position, sorted so that opposing edges can be found
+	vector<uint64_t> edges;
+	auto buildEdges = [&]() {
+		edges.clear();
+		for( size_t i = 0; i < tris.size(); i += 3 )
+			for( int k = 0; k < 3; ++k )
+				edges.push_back( simplifyEdgeKey( posRemap[tris[i + k]], posRemap[tris[i + ( k + 1 ) % 3]] ) );
+		sort( edges.begin(), edges.end() );
+	};
+	auto hasEdge = [&]( uint32_t a, uint32_t b ) {
+		return binary_search( edges.begin(), edges.end(), simplifyEdgeKey( a, b ) );
+	};
+
+	// accumulate the planes of the faces and the borders into the quadrics of their positions
+	vector<Quadric> quadrics( numVertices );
+	vector<uint8_t> isBorder( numVertices, 0 );
+	buildEdges();
+	for( size_t i = 0; i < tris.size(); i += 3 ) {
+		const uint32_t p[3] = { posRemap[tris[i]], posRemap[tris[i + 1]], posRemap[tris[i + 2]] };
+		const dvec3 p0( positions[p[0]] ), p1( positions[p[1]] ), p2( positions[p[2]] );
+		dvec3 normal = cross( p1 - p0, p2 - p0 );
+		const double area = length( normal );
+		if( area <= 0 )
+			continue;
+		normal /= area;
+
+		Quadric face;
+		face.addPlane( normal, -dot( normal, p0 ), area );
+		for( int k = 0; k < 3; ++k )
+			quadrics[p[k]] += face;
+
+		for( int k = 0; k < 3; ++k ) {
+			const uint32_t a = p[k], b = p[( k + 1 ) % 3];
+			if( hasEdge( b, a ) )
+				continue;
+			isBorder[a] = isBorder[b] = 1;
+			const dvec3 pa( positions[a] ), pb( positions[b] );
+			const dvec3 edge = pb - pa;
+			const double edgeLength = length( edge );
+			if( edgeLength <= 0 )
+				continue;
+			const dvec3 borderNormal = normalize( cross( edge, normal ) );
+			Quadric border;
+			border.addPlane( borderNormal, -dot( borderNormal, pa ), edgeLength * edgeLength * SIMPLIFY_BORDER_WEIGHT );
+			quadrics[a] += border;
+			quadrics[b] += border;
+		}
+	}
+
+	const float maxError2 = ( maxError < FLT_MAX ) ? maxError * maxError : FLT_MAX;
+	const size_t targetNumTriangles = targetNumIndices / 3;
+	vector<uint32_t> adjacencyOffsets, adjacency, collapseTo( numVertices );
+	vector<uint8_t> locked( numVertices );
+	vector<SimplifyCollapse> collapses;
+
+	// each pass collapses the cheapest edges whose neighborhoods don't overlap, then rebuilds the topology
+	while( tris.size() / 3 > targetNumTriangles ) {
+		const size_t numTriangles = tris.size() / 3;
+
+		// triangles around each position
+		adjacencyOffsets.assign( numVertices + 1, 0 );
+		for( uint32_t index : tris )
+			++adjacencyOffsets[posRemap[index] + 1];
+		for( size_t v = 0; v < numVertices; ++v )
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		adjacency.resize( tris.size() );
+		{
+			vector<uint32_t> fill( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+			for( size_t i = 0; i < tris.size(); ++i )
+				adjacency[fill[posRemap[tris[i]]]++] = (uint32_t)( i / 3 );
+		}
+
+		// the cheaper direction of every edge; a border position may only slide along the border
+		collapses.clear();
+		for( size_t i = 0; i < tris.size(); i += 3 ) {
+			for( int k = 0; k < 3; ++k ) {
+				const uint32_t a = posRemap[tris[i + k]], b = posRemap[tris[i + ( k + 1 ) % 3]];
+				const bool borderEdge = ! hasEdge( b, a );
+				if( a == b || ( ! borderEdge && a > b ) )
+					continue;
+
+				SimplifyCollapse best = { 0, 0, FLT_MAX };
+				for( int dir = 0; dir < 2; ++dir ) {
+					const uint32_t from = dir ? b : a, to = dir ? a : b;
+					if( isBorder[from] && ! borderEdge )
+						continue;
+					Quadric q = quadrics[from];
+					q += quadrics[to];
+					const float e = ( q.w > 0 ) ? (float)( q.eval( positions[to] ) / q.w ) : 0;
+					if( e < best.mError ) {
+						best.mFrom = from; best.mTo = to; best.mError = e;
+					}
+				}
+				if( best.mError <= maxError2 )
+					collapses.push_back( best );
+			}
+		}
+		sort( collapses.begin(), collapses.end() );
+
+		for( uint32_t v = 0; v < (uint32_t)numVertices; ++v )
+			collapseTo[v] = v;
+		locked.assign( numVertices, 0 );
+		size_t numRemoved = 0;
+		for( const auto &collapse : collapses ) {
+			const uint32_t from = collapse.mFrom, to = collapse.mTo;
+			if( locked[from] || locked[to] )
+				continue;
+
+			// every wedge of 'from' must share an edge with a wedge of 'to', which it becomes; this keeps attribute seams intact
+			bool valid = true;
+			uint32_t w = from;
+			do {
+				uint32_t partner = UINT32_MAX;
+				for( uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1] && partner == UINT32_MAX; ++a ) {
+					const uint32_t *tri = &tris[adjacency[a] * 3];
+					if( tri[0] != w && tri[1] != w && tri[2] != w )
+						continue;
+					for( int k = 0; k < 3; ++k )
+						if( posRemap[tri[k]] == to )
+							partner = tri[k];
+				}
+				if( partner == UINT32_MAX ) {
+					valid = false;
+					break;
+				}
+				collapseTo[w] = partner;
+				w = wedgeNext[w];
+			} while( w != from );
+
+			// the remaining faces around 'from' mustn't flip or rotate too far
+			const vec3 &target = positions[to];
+			for( uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1] && valid; ++a ) {
+				const uint32_t *tri = &tris[adjacency[a] * 3];
+				const uint32_t p[3] = { posRemap[tri[0]], posRemap[tri[1]], posRemap[tri[2]] };
+				if( p[0] == to || p[1] == to || p[2] == to )
+					continue;
+				const int k = ( p[0] == from ) ? 0 : ( ( p[1] == from ) ? 1 : 2 );
+				const vec3 &p1 = positions[p[( k + 1 ) % 3]], &p2 = positions[p[( k + 2 ) % 3]];
+				const vec3 oldNormal = cross( p1 - positions[from], p2 - positions[from] );
+				const vec3 newNormal = cross( p1 - target, p2 - target );
+				if( dot( oldNormal, newNormal ) < SIMPLIFY_MIN_NORMAL_DOT * length( oldNormal ) * length( newNormal ) )
+					valid = false;
+			}
+
+			if( ! valid ) {
+				w = from;
+				do {
+					collapseTo[w] = w;
+					w = wedgeNext[w];
+				} while( w != from );
+				continue;
+			}
+
+			// lock the neighborhood so that the remaining collapses of this pass are tested against unchanged faces
+			for( uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; ++a ) {
+				const uint32_t *tri = &tris[adjacency[a] * 3];
+				bool removed = false;
+				for( int k = 0; k < 3; ++k ) {
+					locked[posRemap[tri[k]]] = 1;
+					removed = removed || ( posRemap[tri[k]] == to );
+				}
+				numRemoved += removed ? 1 : 0;
+			}
+			quadrics[to] += quadrics[from];
+			error = std::max( error, collapse.mError );
+
+			if( numTriangles - numRemoved <= targetNumTriangles )
+				break;
+		}
+
+		if( numRemoved == 0 )
+			break;
+
+		// apply the collapses and discard triangles that became degenerate
+		size_t numOut = 0;
+		for( size_t i = 0; i < tris.size(); i += 3 ) {
+			const uint32_t t0 = collapseTo[tris[i]], t1 = collapseTo[tris[i + 1]], t2 = collapseTo[tris[i + 2]];
+			const uint32_t p0 = posRemap[t0], p1 = posRemap[t1], p2 = posRemap[t2];
+			if( p0 == p1 || p1 == p2 || p2 == p0 )
+				continue;
+			tris[numOut++] = t0; tris[numOut++] = t1; tris[numOut++] = t2;
+		}
+		tris.resize( numOut );
+		buildEdges();
+	}
+
+	if( resultError )
+		*resultError = sqrt( error );
+
+	return tris.size();
+}
+
+namespace {
+
+// Forsyth's scoring constants, tuned for a simulated LRU cache of this many vertices
+const int		FORSYTH_CACHE_SIZE = 32;
+const float		FORSYTH_CACHE_DECAY_POWER = 1.5f;
+const float		FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+const float		FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+const float		FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+float forsythVertexScore( int cachePosition, uint32_t numRemainingTriangles )
+{
+	if( numRemainingTriangles == 0 )
+		return -1;
+
+	float score = 0;
+	if( cachePosition >= 0 ) {
+		// the vertices of the most recent triangle are deliberately scored lower, so that strips don't double back on themselves
+		if( cachePosition < 3 )
+			score = FORSYTH_LAST_TRIANGLE_SCORE;
+		else
+			score = pow( 1.0f - ( cachePosition - 3 ) / float( FORSYTH_CACHE_SIZE - 3 ), FORSYTH_CACHE_DECAY_POWER );
+	}
+
+	// favor vertices with few remaining triangles, so that they are finished off and lone triangles aren't left behind
+	return score + FORSYTH_VALENCE_BOOST_SCALE * pow( (float)numRemainingTriangles, -FORSYTH_VALENCE_BOOST_POWER );
+}
+
+// Simulates a FIFO cache of \a cacheSize vertices, returning whether \a vertex missed. \a timestamps holds the time each vertex entered the cache.
+inline bool fifoCacheMiss( uint32_t vertex, size_t cacheSize, vector<size_t> *timestamps, size_t *time )
+{
+	if( *time - (*timestamps)[vertex] < cacheSize )
+		return false;
+	(*timestamps)[vertex] = ++(*time);
+	return true;
+}
+
+} // anonymous namespace
+
+void calculateVertexCacheOptimizedIndices( size_t numIndices, const uint32_t *indices, size_t numVertices, vector<uint32_t> *resultIndices )
+{
+	const size_t numTriangles = numIndices / 3;
+	resultIndices->clear();
+	resultIndices->reserve( numTriangles * 3 );
+
+	// triangles using each vertex
+	vector<uint32_t> adjacencyOffsets( numVertices + 1, 0 );
+	for( size_t i = 0; i < numTriangles * 3; ++i )
+		++adjacencyOffsets[indices[i] + 1];
+	for( size_t v = 0; v < numVertices; ++v )
+		adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+	vector<uint32_t> adjacency( numTriangles * 3 );
+	vector<uint32_t> numRemaining( numVertices );
+	for( size_t v = 0; v < numVertices; ++v )
+		numRemaining[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+	{
+		vector<uint32_t> fill( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+		for( size_t i = 0; i < numTriangles * 3; ++i )
+			adjacency[fill[indices[i]]++] = (uint32_t)( i / 3 );
+	}
+
+	vector<int> cachePositions( numVertices, -1 );
+	vector<float> vertexScores( numVertices );
+	for( size_t v = 0; v < numVertices; ++v )
+		vertexScores[v] = forsythVertexScore( -1, numRemaining[v] );
+	vector<float> triangleScores( numTriangles );
+	for( size_t t = 0; t < numTriangles; ++t )
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+	vector<uint8_t> emitted( numTriangles, 0 );
+
+	// the LRU cache, with room for the 3 vertices pushed out by each new triangle
+	uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+	int cacheCount = 0;
+	size_t nextUnemitted = 0;
+	int64_t bestTriangle = -1;
+
+	for( size_t n = 0; n < numTriangles; ++n ) {
+		// without a candidate from the cache, start again from the first triangle not yet emitted
+		if( bestTriangle < 0 ) {
+			while( emitted[nextUnemitted] )
+				++nextUnemitted;
+			bestTriangle = (int64_t)nextUnemitted;
+		}
+
+		const uint32_t *tri = &indices[bestTriangle * 3];
+		resultIndices->insert( resultIndices->end(), tri, tri + 3 );
+		emitted[bestTriangle] = 1;
+
+		// move the triangle's vertices to the front of the cache, keeping the order of the rest
+		uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+		int newCount = 0;
+		for( int k = 0; k < 3; ++k ) {
+			const uint32_t v = tri[k];
+			newCache[newCount++] = v;
+			// remove the triangle from the vertex's remaining adjacency
+			uint32_t *begin = &adjacency[adjacencyOffsets[v]], *end = begin + numRemaining[v];
+			*std::find( begin, end, (uint32_t)bestTriangle ) = *( end - 1 );
+			--numRemaining[v];
+		}
+		for( int c = 0; c < cacheCount; ++c ) {
+			const uint32_t v = cache[c];
+			if( v != tri[0] && v != tri[1] && v != tri[2] )
+				newCache[newCount++] = v;
+		}
+
+		// rescore the vertices that were in the cache, and their triangles, picking the best for the next iteration
+		bestTriangle = -1;
+		float bestScore = -1;
+		for( int c = 0; c < newCount; ++c ) {
+			const uint32_t v = newCache[c];
+			cachePositions[v] = ( c < FORSYTH_CACHE_SIZE ) ? c : -1;
+			const float newScore = forsythVertexScore( cachePositions[v], numRemaining[v] );
+			const float delta = newScore - vertexScores[v];
+			vertexScores[v] = newScore;
+			for( uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v] + numRemaining[v]; ++a ) {
+				const uint32_t t = adjacency[a];
+				triangleScores[t] += delta;
+				if( triangleScores[t] > bestScore ) {
+					bestScore = triangleScores[t];
+					bestTriangle = t;
+				}
+			}
+		}
+
+		cacheCount = std::min( newCount, FORSYTH_CACHE_SIZE );
+		std::copy( newCache, newCache + cacheCount, cache );
+	}
+}
+
+void calculateOverdrawOptimizedIndices( size_t numIndices, const uint32_t *indices, size_t numVertices, const vec3 *positions, float threshold, vector<uint32_t> *resultIndices )
+{
+	const size_t numTriangles = numIndices / 3;
+	resultIndices->assign( indices, indices + numTriangles * 3 );
+	if( numTriangles == 0 )
+		return;
+
+	// clusters start wherever all 3 vertices of a triangle miss the cache, which is where the cache optimization started a new strip
+	vector<size_t> timestamps( numVertices, 0 );
+	size_t time = FORSYTH_CACHE_SIZE + 1;
+	auto triangleMisses = [&]( size_t t ) {
+		int misses = 0;
+		for( int k = 0; k < 3; ++k )
+			misses += fifoCacheMiss( indices[t * 3 + k], FORSYTH_CACHE_SIZE, &timestamps, &time ) ? 1 : 0;
+		return misses;
+	};
+	vector<size_t> hardBoundaries;
+	for( size_t t = 0; t < numTriangles; ++t )
+		if( triangleMisses( t ) == 3 || t == 0 )
+			hardBoundaries.push_back( t );
+	hardBoundaries.push_back( numTriangles );
+
+	// Each cluster is drawn starting from a cold cache. Clusters are split further wherever the ACMR so far has come within 'threshold' of the whole cluster's
+	vector<size_t> boundaries;
+	for( size_t h = 0; h + 1 < hardBoundaries.size(); ++h ) {
+		const size_t begin = hardBoundaries[h], end = hardBoundaries[h + 1];
+		time += FORSYTH_CACHE_SIZE + 1;
+		size_t clusterMisses = 0;
+		for( size_t t = begin; t < end; ++t )
+			clusterMisses += triangleMisses( t );
+		const float clusterThreshold = threshold * clusterMisses / float( end - begin );
+
+		boundaries.push_back( begin );
+		time += FORSYTH_CACHE_SIZE + 1;
+		size_t runningMisses = 0, runningTriangles = 0;
+		for( size_t t = begin; t + 1 < end; ++t ) {
+			runningMisses += triangleMisses( t );
+			++runningTriangles;
+			if( runningMisses <= clusterThreshold * runningTriangles ) {
+				boundaries.push_back( t + 1 );
+				time += FORSYTH_CACHE_SIZE + 1;
+				runningMisses = runningTriangles = 0;
+			}
+		}
+	}
+	boundaries.push_back( numTriangles );
+
+	vec3 meshCentroid( 0 );
+	for( size_t v = 0; v < numVertices; ++v )
+		meshCentroid += positions[v];
+	meshCentroid /= (float)std::max<size_t>( numVertices, 1 );
+
+	// Sander, Pedro V., Nehab, Diego and Barczak, Joshua. "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw". SIGGRAPH 2007.
+	// clusters facing away from the center of the mesh are likely to occlude the others, so they are drawn first
+	const size_t numClusters = boundaries.size() - 1;
+	vector<pair<float, uint32_t>> clusterKeys( numClusters );
+	for( size_t c = 0; c < numClusters; ++c ) {
+		vec3 centroid( 0 ), normal( 0 );
+		float area = 0;
+		for( size_t t = boundaries[c]; t < boundaries[c + 1]; ++t ) {
+			const vec3 &a = positions[indices[t * 3]], &b = positions[indices[t * 3 + 1]], &c2 = positions[indices[t * 3 + 2]];
+			const vec3 n = cross( b - a, c2 - a );
+			const float triangleArea = length( n );
+			centroid += ( a + b + c2 ) * ( triangleArea / 3 );
+			normal += n;
+			area += triangleArea;
+		}
+		if( area > 0 )
+			centroid /= area;
+		const float normalLength = length( normal );
+		clusterKeys[c] = make_pair( normalLength > 0 ? -dot( centroid - meshCentroid, normal / normalLength ) : 0, (uint32_t)c );
+	}
+	stable_sort( clusterKeys.begin(), clusterKeys.end() );
+
+	size_t outIndex = 0;
+	for( const auto &key : clusterKeys )
+		for( size_t i = boundaries[key.second] * 3; i < boundaries[key.second + 1] * 3; ++i )
+			(*resultIndices)[outIndex++] = indices[i];
+}
+
+size_t calculateVertexFetchRemap( size_t numIndices, const uint32_t *indices, size_t numVertices, vector<uint32_t> *resultRemap )
+{
+	const uint32_t unmapped = numeric_limits<uint32_t>::max();
+	resultRemap->assign( numVertices, unmapped );
+
+	// vertices are numbered in the order they are first used, and unused ones follow in their original order
+	uint32_t nextVertex = 0;
+	for( size_t i = 0; i < numIndices; ++i ) {
+		uint32_t &newIndex = (*resultRemap)[indices[i]];
+		if( newIndex == unmapped )
+			newIndex = nextVertex++;
+	}
+	const size_t numUsed = nextVertex;
+	for( auto &newIndex : *resultRemap )
+		if( newIndex == unmapped )
+			newIndex = nextVertex++;
+
+	return numUsed;
+}
+
+VertexCacheStats calculateVertexCacheStats( size_t numIndices, const uint32_t *indices, size_t numVertices, size_t cacheSize )
+{
+	VertexCacheStats result;
+	result.mNumTransformed = 0;
+
+	vector<size_t> timestamps( numVertices, 0 );
+	size_t time = cacheSize + 1;
+	vector<uint8_t> used( numVertices, 0 );
+	size_t numUsed = 0;
+	for( size_t i = 0; i < numIndices; ++i ) {
+		result.mNumTransformed += fifoCacheMiss( indices[i], cacheSize, &timestamps, &time ) ? 1 : 0;
+		if( ! used[indices[i]] ) {
+			used[indices[i]] = 1;
+			++numUsed;
+		}
+	}
+
+	result.mAcmr = ( numIndices >= 3 ) ? result.mNumTransformed / float( numIndices / 3 ) : 0;
+	result.mAtvr = numUsed ? result.mNumTransformed / float( numUsed ) : 0;
+	return result;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Target
 void Target::copyIndexDataForceTriangles( Primitive primitive, const uint32_t *source, size_t numIndices, uint32_t indexOffset, uint32_t *target )
@@ -2694,21 +3327,26 @@ void Transform::process( SourceModsContext *ctx, const AttribSet &requestedAttri
 
 	if( ctx->getAttribDims( POSITION ) == 2 ) {
 		const vec2* inPositions = reinterpret_cast<vec2*>( ctx->getAttribData( POSITION ) );
-		vector<vec3> outPositions;
-		outPositions.reserve( numVertices );
-		for( size_t v = 0; v < numVertices; ++v )
-			outPositions.push_back( vec3( mTransform * vec4( inPositions[v], 0, 1 ) ) );
+		vector<vec3> outPositions( numVertices );
+		parallelFor( numVertices, [&]( size_t begin, size_t end ) {
+			for( size_t v = begin; v < end; ++v )
+				outPositions[v] = vec3( mTransform * vec4( inPositions[v], 0, 1 ) );
+		} );
 		ctx->copyAttrib( POSITION, 3, 0, (const float*)outPositions.data(), numVertices );
 	}
 	else if( ctx->getAttribDims( POSITION ) == 3 ) {
 		vec3* positions = reinterpret_cast<vec3*>( ctx->getAttribData( POSITION ) );
-		for( size_t v = 0; v < numVertices; ++v )
-			positions[v] = vec3( mTransform * vec4( positions[v], 1 ) );
+		parallelFor( numVertices, [&]( size_t begin, size_t end ) {
+			for( size_t v = begin; v < end; ++v )
+				positions[v] = vec3( mTransform * vec4( positions[v], 1 ) );
+		} );
 	}
 	else if( ctx->getAttribDims( POSITION ) == 4 ) {
 		vec4* positions = reinterpret_cast<vec4*>( ctx->getAttribData( POSITION ) );
-		for( size_t v = 0; v < numVertices; ++v )
-			positions[v] = mTransform * positions[v];
+		parallelFor( numVertices, [&]( size_t begin, size_t end ) {
+			for( size_t v = begin; v < end; ++v )
+				positions[v] = mTransform * positions[v];
+		} );
 	}
 	else if( ctx->getAttribDims( POSITION ) != 0 )
 		CI_LOG_W( "Unsupported dimension for geom::POSITION passed to geom::Transform" );
@@ -2718,8 +3356,10 @@ void Transform::process( SourceModsContext *ctx, const AttribSet &requestedAttri
 	if( ctx->getAttribDims( NORMAL ) == 3 ) {
 		vec3* normals = reinterpret_cast<vec3*>( ctx->getAttribData( NORMAL ) );
 		mat3 normalsTransform = glm::transpose( inverse( mat3( mTransform ) ) );
-		for( size_t v = 0; v < numVertices; ++v )
-			normals[v] = normalize( normalsTransform * normals[v] );
+		parallelFor( numVertices, [&]( size_t begin, size_t end ) {
+			for( size_t v = begin; v < end; ++v )
+				normals[v] = normalize( normalsTransform * normals[v] );
+		} );
 	}
 	else if( ctx->getAttribDims( NORMAL ) != 0 )
 		CI_LOG_W( "Unsupported dimension for geom::NORMAL passed to geom::Transform" );
@@ -2729,8 +3369,10 @@ void Transform::process( SourceModsContext *ctx, const AttribSet &requestedAttri
 	if( ctx->getAttribDims( TANGENT ) == 3 ) {
 		vec3* tangents = reinterpret_cast<vec3*>( ctx->getAttribData( TANGENT ) );
 		mat3 tangentsTransform = glm::transpose( inverse( mat3( mTransform ) ) );
-		for( size_t v = 0; v < numVertices; ++v )
-			tangents[v] = normalize( tangentsTransform * tangents[v] );
+		parallelFor( numVertices, [&]( size_t begin, size_t end ) {
+			for( size_t v = begin; v < end; ++v )
+				tangents[v] = normalize( tangentsTransform * tangents[v] );
+		} );
 	}
 	else if( ctx->getAttribDims( TANGENT ) != 0 )
 		CI_LOG_W( "Unsupported dimension for geom::TANGENT passed to geom::Transform" );
@@ -2754,25 +3396,27 @@ void Twist::process( SourceModsContext *ctx, const AttribSet &requestedAttribs )
 		if( ctx->getAttribDims( TANGENT ) == 3 )
 			tangents = reinterpret_cast<vec3*>( ctx->getAttribData( TANGENT ) );
 		
-		for( size_t v = 0; v < numVertices; ++v ) {
-			// find the 't' value of the point on the axis that inPosition is closest to
-			float closestDist = dot( positions[v] - mAxisStart, axisDir );
-			float tVal = glm::clamp<float>( closestDist * invAxisLength, 0, 1 );
-			// 'pointOnAxis' is the actual point on the axis inPosition is closest to
-			vec3 pointOnAxis = mAxisStart + axisDir * closestDist;
-			// our rotation is around the axis, and the angle is a lerp between 'mStartAngle' and 'mEndAngle' based on 't'
-			mat4 rotation = rotate( glm::mix( mStartAngle, mEndAngle, tVal ), axisDir );
-			// now transform the point by rotating around 'pointOnAxis'
-			mat4 transform = translate( pointOnAxis ) * rotation * translate( -pointOnAxis );
-			vec3 outPos = vec3( transform * vec4( positions[v], 1 ) );
-			positions[v] = outPos;
-			// we need to transform the normal by rotating it by the same angle (but not around the point) we did the position
-			if( normals )
-				normals[v] = vec3( rotation * vec4( normals[v], 0 ) );
-			// we need to transform the tangent by rotating it by the same angle (but not around the point) we did the position
-			if( tangents )
-				tangents[v] = vec3( rotation * vec4( tangents[v], 0 ) );
-		}
+		parallelFor( numVertices, [&]( size_t begin, size_t end ) {
+			for( size_t v = begin; v < end; ++v ) {
+				// find the 't' value of the point on the axis that inPosition is closest to
+				float closestDist = dot( positions[v] - mAxisStart, axisDir );
+				float tVal = glm::clamp<float>( closestDist * invAxisLength, 0, 1 );
+				// 'pointOnAxis' is the actual point on the axis inPosition is closest to
+				vec3 pointOnAxis = mAxisStart + axisDir * closestDist;
+				// our rotation is around the axis, and the angle is a lerp between 'mStartAngle' and 'mEndAngle' based on 't'
+				mat4 rotation = rotate( glm::mix( mStartAngle, mEndAngle, tVal ), axisDir );
+				// now transform the point by rotating around 'pointOnAxis'
+				mat4 transform = translate( pointOnAxis ) * rotation * translate( -pointOnAxis );
+				vec3 outPos = vec3( transform * vec4( positions[v], 1 ) );
+				positions[v] = outPos;
+				// we need to transform the normal by rotating it by the same angle (but not around the point) we did the position
+				if( normals )
+					normals[v] = vec3( rotation * vec4( normals[v], 0 ) );
+				// we need to transform the tangent by rotating it by the same angle (but not around the point) we did the position
+				if( tangents )
+					tangents[v] = vec3( rotation * vec4( tangents[v], 0 ) );
+			}
+		} );
 	}
 	else if( ctx->getAttribDims( POSITION ) != 0 )
 		CI_LOG_W( "Unsupported dimension for geom::POSITION passed to geom::Twist" );
@@ -2936,21 +3580,25 @@ AttribSet ColorFromAttrib::getAvailableAttribs( const Modifier::Params &upstream
 
 namespace {
 template<typename I, typename IFD, typename O>
-void processColorAttrib( const I* inputData, O *outputData, const std::function<O(IFD)> &fn, size_t numVertices )
+void processColorAttrib( const I* inputData, O *outputData, const std::function<O(IFD)> &fn, size_t numVertices, bool parallel )
 {
-	for( size_t v = 0; v < numVertices; ++v ) {
-		IFD in( (IFD)inputData[v] );
-		outputData[v] = fn( in );
-	}
+	parallelFor( numVertices, [&]( size_t begin, size_t end ) {
+		for( size_t v = begin; v < end; ++v ) {
+			IFD in( (IFD)inputData[v] );
+			outputData[v] = fn( in );
+		}
+	}, parallel );
 }
 
 template<typename O>
-void processColorAttrib2d( const vec2* inputData, O *outputData, const std::function<O(vec3)> &fn, size_t numVertices )
+void processColorAttrib2d( const vec2* inputData, O *outputData, const std::function<O(vec3)> &fn, size_t numVertices, bool parallel )
 {
-	for( size_t v = 0; v < numVertices; ++v ) {
-		vec3 in( inputData[v], 0 );
-		outputData[v] = fn( in );
-	}
+	parallelFor( numVertices, [&]( size_t begin, size_t end ) {
+		for( size_t v = begin; v < end; ++v ) {
+			vec3 in( inputData[v], 0 );
+			outputData[v] = fn( in );
+		}
+	}, parallel );
 }
 } // anonymous namespace
 
@@ -2976,19 +3624,19 @@ void ColorFromAttrib::process( SourceModsContext *ctx, const AttribSet &requeste
 	
 	if( mFnColor2 ) {
 		if( inputAttribDims == 2 )
-			processColorAttrib( reinterpret_cast<const vec2*>( inputAttribData ), reinterpret_cast<Colorf*>( mColorData.get() ), mFnColor2, numVertices );
+			processColorAttrib( reinterpret_cast<const vec2*>( inputAttribData ), reinterpret_cast<Colorf*>( mColorData.get() ), mFnColor2, numVertices, mParallel );
 		else if( inputAttribDims == 3 )
-			processColorAttrib( reinterpret_cast<const vec3*>( inputAttribData ), reinterpret_cast<Colorf*>( mColorData.get() ), mFnColor2, numVertices );
+			processColorAttrib( reinterpret_cast<const vec3*>( inputAttribData ), reinterpret_cast<Colorf*>( mColorData.get() ), mFnColor2, numVertices, mParallel );
 		else if( inputAttribDims == 4 )
-			processColorAttrib( reinterpret_cast<const vec4*>( inputAttribData ), reinterpret_cast<Colorf*>( mColorData.get() ), mFnColor2, numVertices );
+			processColorAttrib( reinterpret_cast<const vec4*>( inputAttribData ), reinterpret_cast<Colorf*>( mColorData.get() ), mFnColor2, numVertices, mParallel );
 	}
 	else if( mFnColor3 ) {
 		if( inputAttribDims == 2 )
-			processColorAttrib2d( reinterpret_cast<const vec2*>( inputAttribData ), reinterpret_cast<Colorf*>( mColorData.get() ), mFnColor3, numVertices );
+			processColorAttrib2d( reinterpret_cast<const vec2*>( inputAttribData ), reinterpret_cast<Colorf*>( mColorData.get() ), mFnColor3, numVertices, mParallel );
 		if( inputAttribDims == 3 )
-			processColorAttrib( reinterpret_cast<const vec3*>( inputAttribData ), reinterpret_cast<Colorf*>( mColorData.get() ), mFnColor3, numVertices );
+			processColorAttrib( reinterpret_cast<const vec3*>( inputAttribData ), reinterpret_cast<Colorf*>( mColorData.get() ), mFnColor3, numVertices, mParallel );
 		else if( inputAttribDims == 4 )
-			processColorAttrib( reinterpret_cast<const vec4*>( inputAttribData ), reinterpret_cast<Colorf*>( mColorData.get() ), mFnColor3, numVertices );
+			processColorAttrib( reinterpret_cast<const vec4*>( inputAttribData ), reinterpret_cast<Colorf*>( mColorData.get() ), mFnColor3, numVertices, mParallel );
 	}
 
 	ctx->copyAttrib( Attrib::COLOR, 3, 0, mColorData.get(), numVertices );
@@ -3072,13 +3720,15 @@ AttribSet AttribFn<S,D>::getAvailableAttribs( const Modifier::Params &upstreamPa
 
 namespace {
 template<typename S, typename D>
-void processAttrib( const float *inputDataFloat, float *outputDataFloat, const std::function<D(S)> &fn, size_t numVertices )
+void processAttrib( const float *inputDataFloat, float *outputDataFloat, const std::function<D(S)> &fn, size_t numVertices, bool parallel )
 {
 	const S *inData = reinterpret_cast<const S*>( inputDataFloat );
 	D *outData = reinterpret_cast<D*>( outputDataFloat );
 
-	for( size_t v = 0; v < numVertices; ++v )
-		outData[v] = fn( inData[v] );
+	parallelFor( numVertices, [&]( size_t begin, size_t end ) {
+		for( size_t v = begin; v < end; ++v )
+			outData[v] = fn( inData[v] );
+	}, parallel );
 }
 } // anonymous namespace
 
@@ -3110,7 +3760,7 @@ void geom::AttribFn<S,D>::process( SourceModsContext *ctx, const AttribSet &requ
 	else
 		inputAttribData = ctx->getAttribData( mSrcAttrib );
 	
-	processAttrib<S,D>( inputAttribData, outData.get(), mFn, numVertices );
+	processAttrib<S,D>( inputAttribData, outData.get(), mFn, numVertices, mParallel );
 	ctx->copyAttrib( mDstAttrib, DSTDIM, 0, outData.get(), numVertices );
 }
 
@@ -4544,22 +5194,25 @@ void Subdivide::process( SourceModsContext *ctx, const AttribSet &requestedAttri
 	const uint32_t *inIndices = ctx->getIndicesData();
 	const vec3 *inPositions = reinterpret_cast<const vec3*>( ctx->getAttribData( POSITION ) );
 	
-	vector<vec3> outPositions;
-	vector<uint32_t> outIndices;
+	const size_t numTriangles = numInIndices / 3;
+	vector<vec3> outPositions( numTriangles );
+	vector<uint32_t> outIndices( numTriangles * 9 );
 	
-	for( size_t idx = 0; idx < numInIndices; idx += 3 ) {
-		vec3 sumPos = inPositions[inIndices[idx+0]] + inPositions[inIndices[idx+1]] +
-						inPositions[inIndices[idx+2]];
-		outPositions.push_back( sumPos / 3.0f );
-		
-		uint32_t newIdx = (uint32_t)(outPositions.size() + numInVertices - 1);
-		// 0-new-2
-		outIndices.push_back( inIndices[idx+0] ); outIndices.push_back( newIdx ); outIndices.push_back( inIndices[idx+2] );
-		// 0-1-new
-		outIndices.push_back( inIndices[idx+0] ); outIndices.push_back( inIndices[idx+1] ); outIndices.push_back( newIdx );
-		// new-1-2
-		outIndices.push_back( newIdx ); outIndices.push_back( inIndices[idx+1] ); outIndices.push_back( inIndices[idx+2] );
-	}
+	parallelFor( numTriangles, [&]( size_t begin, size_t end ) {
+		for( size_t t = begin; t < end; ++t ) {
+			const uint32_t *tri = &inIndices[t * 3];
+			outPositions[t] = ( inPositions[tri[0]] + inPositions[tri[1]] + inPositions[tri[2]] ) / 3.0f;
+			
+			const uint32_t newIdx = (uint32_t)( numInVertices + t );
+			uint32_t *out = &outIndices[t * 9];
+			// 0-new-2
+			out[0] = tri[0]; out[1] = newIdx; out[2] = tri[2];
+			// 0-1-new
+			out[3] = tri[0]; out[4] = tri[1]; out[5] = newIdx;
+			// new-1-2
+			out[6] = newIdx; out[7] = tri[1]; out[8] = tri[2];
+		}
+	} );
 	
 	// iterate the attributes and lerp
 	for( const auto &attr : ctx->getAvailableAttribs() ) {
@@ -4567,25 +5220,24 @@ void Subdivide::process( SourceModsContext *ctx, const AttribSet &requestedAttri
 		if( attr == POSITION )
 			continue;
 	
-		vector<float> outData;
 		const float *inData = ctx->getAttribData( attr );
 		uint8_t dims = ctx->getAttribDims( attr );
-		outData.reserve( numInIndices / 3 * dims );
-		for( size_t idx = 0; idx < numInIndices; idx += 3 ) {
-			for( uint8_t dim = 0; dim < dims; ++dim )
-				outData.push_back( (inData[inIndices[idx+0]*dims + dim] +
-									inData[inIndices[idx+1]*dims + dim] +
-									inData[inIndices[idx+2]*dims + dim]) / 3.0f );
-		}
-		
+		vector<float> outData( numTriangles * dims );
 		// normalize 3D NORMAL, TANGENT or BITANGENT
-		if( ( (attr == NORMAL) || (attr == TANGENT) || (attr == BITANGENT) ) && ( dims == 3 ) ) {
-			size_t numVerts = outData.size() / 3;
-			for( size_t v = 0; v < numVerts; ++v ) {
-				vec3 *d = reinterpret_cast<vec3*>( &outData[v * 3] );
-				*d = normalize( *d );
+		const bool normalizeOut = ( (attr == NORMAL) || (attr == TANGENT) || (attr == BITANGENT) ) && ( dims == 3 );
+		parallelFor( numTriangles, [&]( size_t begin, size_t end ) {
+			for( size_t t = begin; t < end; ++t ) {
+				const uint32_t *tri = &inIndices[t * 3];
+				for( uint8_t dim = 0; dim < dims; ++dim )
+					outData[t * dims + dim] = ( inData[tri[0]*dims + dim] +
+												inData[tri[1]*dims + dim] +
+												inData[tri[2]*dims + dim] ) / 3.0f;
+				if( normalizeOut ) {
+					vec3 *d = reinterpret_cast<vec3*>( &outData[t * 3] );
+					*d = normalize( *d );
+				}
 			}
-		}
+		} );
 
 		ctx->appendAttrib( attr, dims, outData.data(), outData.size() / dims );
 	}
@@ -4594,6 +5246,125 @@ void Subdivide::process( SourceModsContext *ctx, const AttribSet &requestedAttri
 	ctx->copyIndices( ctx->getPrimitive(), outIndices.data(), outIndices.size(), 4 );
 }
 
+///////////////////////////////////////////////////////////////////////////////////////
+// Simplify
+size_t Simplify::getTargetNumIndices( size_t upstreamNumIndices ) const
+{
+	if( mNumTriangles > 0 )
+		return std::min( upstreamNumIndices, mNumTriangles * 3 );
+	else
+		return std::min( upstreamNumIndices, (size_t)( upstreamNumIndices / 3 * glm::clamp( mRatio, 0.0f, 1.0f ) ) * 3 );
+}
+
+size_t Simplify::getNumIndices( const Modifier::Params &upstreamParams ) const
+{
+	if( upstreamParams.getPrimitive() == Primitive::TRIANGLES )
+		return upstreamParams.getNumIndices() ? upstreamParams.getNumIndices() : upstreamParams.getNumVertices();
+	else
+		return upstreamParams.getNumIndices();
+}
+
+void Simplify::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
+{
+	AttribSet request = requestedAttribs;
+	request.insert( POSITION );
+	ctx->processUpstream( request );
+	
+	if( ctx->getPrimitive() != Primitive::TRIANGLES ) {
+		CI_LOG_E( "geom::Simplify only supports TRIANGLES primitive." );
+		return;
+	}
+
+	if( ctx->getAttribDims( POSITION ) != 3 ) {
+		CI_LOG_E( "geom::Simplify requires 3D POSITION." );
+		return;
+	}
+
+	const size_t numVertices = ctx->getNumVertices();
+	const vec3 *positions = reinterpret_cast<const vec3*>( ctx->getAttribData( POSITION ) );
+
+	// non-indexed geometry is simplified through indices referring to every vertex
+	vector<uint32_t> inIndices;
+	const uint32_t *indices = ctx->getIndicesData();
+	size_t numIndices = ctx->getNumIndices();
+	if( numIndices == 0 ) {
+		inIndices.resize( numVertices );
+		for( size_t v = 0; v < numVertices; ++v )
+			inIndices[v] = (uint32_t)v;
+		indices = inIndices.data();
+		numIndices = numVertices;
+	}
+
+	vector<uint32_t> outIndices;
+	calculateSimplifiedIndices( numIndices, indices, numVertices, positions, getTargetNumIndices( numIndices ), mMaxError, &outIndices );
+	ctx->copyIndices( Primitive::TRIANGLES, outIndices.data(), outIndices.size(), calcIndicesRequiredBytes( numVertices ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+// OptimizeVertexCache
+size_t OptimizeVertexCache::getNumIndices( const Modifier::Params &upstreamParams ) const
+{
+	// non-indexed triangles become indexed
+	if( upstreamParams.getPrimitive() == Primitive::TRIANGLES && upstreamParams.getNumIndices() == 0 )
+		return upstreamParams.getNumVertices();
+	else
+		return upstreamParams.getNumIndices();
+}
+
+void OptimizeVertexCache::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
+{
+	AttribSet request = requestedAttribs;
+	if( mOverdraw )
+		request.insert( POSITION );
+	ctx->processUpstream( request );
+
+	if( ctx->getPrimitive() != Primitive::TRIANGLES ) {
+		CI_LOG_E( "geom::OptimizeVertexCache only supports TRIANGLES primitive." );
+		return;
+	}
+
+	const size_t numVertices = ctx->getNumVertices();
+	vector<uint32_t> indices;
+	if( ctx->getNumIndices() )
+		indices.assign( ctx->getIndicesData(), ctx->getIndicesData() + ctx->getNumIndices() );
+	else {
+		indices.resize( numVertices );
+		for( size_t v = 0; v < numVertices; ++v )
+			indices[v] = (uint32_t)v;
+	}
+
+	vector<uint32_t> optimized;
+	calculateVertexCacheOptimizedIndices( indices.size(), indices.data(), numVertices, &optimized );
+	indices.swap( optimized );
+
+	if( mOverdraw ) {
+		if( ctx->getAttribDims( POSITION ) == 3 ) {
+			calculateOverdrawOptimizedIndices( indices.size(), indices.data(), numVertices, reinterpret_cast<const vec3*>( ctx->getAttribData( POSITION ) ), mOverdrawThreshold, &optimized );
+			indices.swap( optimized );
+		}
+		else
+			CI_LOG_W( "geom::OptimizeVertexCache requires 3D POSITION to reduce overdraw." );
+	}
+
+	if( mVertexFetch ) {
+		vector<uint32_t> remap;
+		calculateVertexFetchRemap( indices.size(), indices.data(), numVertices, &remap );
+		for( auto &index : indices )
+			index = remap[index];
+
+		for( const auto &attr : ctx->getAvailableAttribs() ) {
+			const uint8_t dims = ctx->getAttribDims( attr );
+			const float *inData = ctx->getAttribData( attr );
+			vector<float> outData( numVertices * dims );
+			for( size_t v = 0; v < numVertices; ++v )
+				std::copy( inData + v * dims, inData + ( v + 1 ) * dims, outData.begin() + remap[v] * dims );
+			ctx->copyAttrib( attr, dims, 0, outData.data(), numVertices );
+		}
+	}
+
+	ctx->copyIndices( Primitive::TRIANGLES, indices.data(), indices.size(), calcIndicesRequiredBytes( numVertices ) );
+}
+
 //////////////////////////////////////////////////////////////////////////////////////
 // SourceMods
 void SourceMods::copyImpl( const SourceMods &rhs )
@@ -4614,6 +5385,10 @@ void SourceMods::copyImpl( const SourceMods &rhs )
 		mModifiers.push_back( std::unique_ptr<Modifier>( modifier->clone() ) );
 	for( auto &child : rhs.mChildren )
 		mChildren.push_back( std::unique_ptr<SourceMods>( child->clone() ) );
+
+	mCacheEnabled = rhs.mCacheEnabled;
+	mCache = rhs.mCache;
+	mCachedAttribs = rhs.mCachedAttribs;
 }
 
 size_t SourceMods::getNumVertices() const
@@ -4729,6 +5504,40 @@ void SourceMods::cacheVariables() const
 }
 
 void SourceMods::loadInto( Target *target, const AttribSet &requestedAttribs ) const
+{
+	if( ! mCacheEnabled ) {
+		loadIntoUncached( target, requestedAttribs );
+		return;
+	}
+
+	// (re)capture if we have no cache yet or it lacks some of the requested attributes
+	if( ! mCache || ! std::includes( mCachedAttribs.begin(), mCachedAttribs.end(), requestedAttribs.begin(), requestedAttribs.end() ) ) {
+		AttribSet attribs = mCachedAttribs;
+		attribs.insert( requestedAttribs.begin(), requestedAttribs.end() );
+		auto cache = make_shared<SourceModsContext>();
+		loadIntoUncached( cache.get(), attribs );
+		mCache = cache;
+		mCachedAttribs = attribs;
+	}
+
+	mCache->copyInto( target, requestedAttribs );
+}
+
+SourceMods& SourceMods::enableCache( bool enable )
+{
+	mCacheEnabled = enable;
+	if( ! enable )
+		invalidateCache();
+	return *this;
+}
+
+void SourceMods::invalidateCache()
+{
+	mCache.reset();
+	mCachedAttribs.clear();
+}
+
+void SourceMods::loadIntoUncached( Target *target, const AttribSet &requestedAttribs ) const
 {
 	if( mSourcePtr ) { // normal, no children
 		if( mModifiers.empty() ) {
@@ -4755,6 +5564,7 @@ void SourceMods::append( const Modifier &modifier )
 {
 	mModifiers.emplace_back( modifier.clone() );
 	mVariablesCached = false;
+	invalidateCache();
 }
 
 void SourceMods::append( const Source &source )
@@ -4778,12 +5588,14 @@ void SourceMods::append( const SourceMods &sourceMods )
 		// add the original SourceMods we were combining with
 		mChildren.emplace_back( sourceMods.clone() );
 	}
+
+	invalidateCache();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // SourceModsContext
 SourceModsContext::SourceModsContext( const SourceMods *sourceMods )
-	: mNumIndices( 0 ), mNumVertices( 0 ), mAttribMask( nullptr ), mPrimitive( NUM_PRIMITIVES )
+	: mNumIndices( 0 ), mNumVertices( 0 ), mAttribMask( nullptr ), mIndicesRequiredBytes( 0 ), mPrimitive( NUM_PRIMITIVES )
 {
 	mSource = sourceMods->getSource();
 	
@@ -4795,7 +5607,7 @@ SourceModsContext::SourceModsContext( const SourceMods *sourceMods )
 }
 
 SourceModsContext::SourceModsContext()
-	: mNumIndices( 0 ), mNumVertices( 0 ), mSource( nullptr ), mAttribMask( nullptr ), mPrimitive( NUM_PRIMITIVES )
+	: mNumIndices( 0 ), mNumVertices( 0 ), mSource( nullptr ), mAttribMask( nullptr ), mIndicesRequiredBytes( 0 ), mPrimitive( NUM_PRIMITIVES )
 {
 }
 
@@ -4923,6 +5735,21 @@ void SourceModsContext::complete( Target *target, const AttribSet &requestedAttr
 	target->copyIndices( mPrimitive, mIndices.get(), mNumIndices, calcIndicesRequiredBytes( mNumIndices ) );	
 }
 
+void SourceModsContext::copyInto( Target *target, const AttribSet &requestedAttribs ) const
+{
+	for( const auto &attribInfoPair : mAttribInfo ) {
+		Attrib attrib = attribInfoPair.first;
+		if( requestedAttribs.count( attrib ) == 0 )
+			continue;
+		const AttribInfo &attribInfo = attribInfoPair.second;
+		target->copyAttrib( attrib, attribInfo.getDims(), attribInfo.getStride(), mAttribData.at( attrib ).get(), mAttribCount.at( attrib ) );
+	}
+
+	// a non-indexed Source may never have specified its primitive
+	if( mPrimitive != NUM_PRIMITIVES )
+		target->copyIndices( mPrimitive, mIndices.get(), mNumIndices, mIndicesRequiredBytes );
+}
+
 void SourceModsContext::loadInto( Target *target, const AttribSet &requestedAttribs )
 {
 	if( ! mSource ) {
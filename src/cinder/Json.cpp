@@ -29,10 +29,12 @@
 #include "jsoncpp/json.h"
 
 #include "cinder/Json.h"
+#include "cinder/JsonStream.h"
 #include "cinder/Stream.h"
 #include "cinder/Utilities.h"
 
 #include <cstdlib>
+#include <limits>
 
 using namespace std;
 
@@ -148,6 +150,19 @@ JsonTree::JsonTree( const std::string &jsonString, ParseOptions parseOptions )
 	}
 }
 
+JsonTree::JsonTree( JsonReader &reader )
+	: mParent( NULL ), mNodeType( NODE_NULL ), mValueType( VALUE_STRING )
+{
+	if( reader.getEvent() == JsonReader::EVENT_NONE )
+		reader.next();
+	if( reader.getEvent() == JsonReader::EVENT_KEY ) {
+		mKey = reader.getStringCopy();
+		reader.next();
+	}
+
+	readValue( reader );
+}
+
 JsonTree::JsonTree( const std::string &key, const Json::Value &value )
 {
 	init( key, value, true, NODE_VALUE );
@@ -274,6 +289,57 @@ void JsonTree::init( const string &key, const Json::Value &value, bool setType,
 	}
 }
 
+void JsonTree::readValue( JsonReader &reader )
+{
+	switch( reader.getEvent() ) {
+		case JsonReader::EVENT_START_OBJECT:
+			mNodeType = NODE_OBJECT;
+			// children are built in place, rather than copied in with pushBack()
+			while( reader.next() == JsonReader::EVENT_KEY ) {
+				mChildren.push_back( JsonTree() );
+				JsonTree &child = mChildren.back();
+				child.mParent = this;
+				child.mKey = reader.getStringCopy();
+				reader.next();
+				child.readValue( reader );
+			}
+		break;
+		case JsonReader::EVENT_START_ARRAY:
+			mNodeType = NODE_ARRAY;
+			while( reader.next() != JsonReader::EVENT_END_ARRAY ) {
+				mChildren.push_back( JsonTree() );
+				mChildren.back().mParent = this;
+				mChildren.back().readValue( reader );
+			}
+		break;
+		case JsonReader::EVENT_STRING:
+			mNodeType = NODE_VALUE;
+			mValueType = VALUE_STRING;
+			mValue = reader.getStringCopy();
+		break;
+		case JsonReader::EVENT_NUMBER:
+			mNodeType = NODE_VALUE;
+			mValue = reader.getStringCopy();
+			if( ! reader.isInteger() )
+				mValueType = VALUE_DOUBLE;
+			else if( mValue[0] == '-' || reader.getUint64() <= (uint64_t)std::numeric_limits<int64_t>::max() )
+				mValueType = VALUE_INT;
+			else
+				mValueType = VALUE_UINT;
+		break;
+		case JsonReader::EVENT_BOOL:
+			mNodeType = NODE_VALUE;
+			mValueType = VALUE_BOOL;
+			mValue = toString( reader.getBool() );
+		break;
+		case JsonReader::EVENT_NULL:
+			mNodeType = NODE_NULL;
+		break;
+		default:
+			throw ExcJsonReader( "JSON parse error: expected a value" );
+	}
+}
+
 //! Converts a JSON string into a JsonCpp object
 Json::Value JsonTree::deserializeNative( const string &jsonString, ParseOptions parseOptions )
 {
@@ -705,6 +771,49 @@ void JsonTree::write( DataTargetRef target, JsonTree::WriteOptions writeOptions
 
 
 
+void JsonTree::write( JsonWriter &writer ) const
+{
+	switch( mNodeType ) {
+		case NODE_ARRAY:
+			writer.startArray();
+			for( ConstIter childIt = mChildren.begin(); childIt != mChildren.end(); ++childIt ) {
+				childIt->write( writer );
+			}
+			writer.endArray();
+		break;
+		case NODE_OBJECT:
+			writer.startObject();
+			for( ConstIter childIt = mChildren.begin(); childIt != mChildren.end(); ++childIt ) {
+				writer.key( childIt->getKey() );
+				childIt->write( writer );
+			}
+			writer.endObject();
+		break;
+		case NODE_VALUE:
+			switch( mValueType ) {
+				case VALUE_BOOL:
+					writer.value( fromString<bool>( mValue ) );
+				break;
+				case VALUE_DOUBLE:
+					writer.value( fromString<double>( mValue ) );
+				break;
+				case VALUE_INT:
+					writer.value( fromString<int64_t>( mValue ) );
+				break;
+				case VALUE_STRING:
+					writer.value( mValue );
+				break;
+				case VALUE_UINT:
+					writer.value( fromString<uint64_t>( mValue ) );
+				break;
+			}
+		break;
+		default:
+			writer.nullValue();
+		break;
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 JsonTree::ExcChildNotFound::ExcChildNotFound( const JsonTree &node, const string &childPath ) throw()
@@ -0,0 +1,801 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cinder/JsonStream.h"
+#include "cinder/MemoryMappedFile.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+namespace cinder {
+
+// Output is written to the target whenever JsonWriter's buffer grows past this many bytes
+#define JSON_WRITER_BUFFER_SIZE		( 64 * 1024 )
+
+namespace {
+
+// Powers of ten which are exactly representable as doubles
+const double sPowersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16,
+							1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+inline bool isDigit( char c )
+{
+	return c >= '0' && c <= '9';
+}
+
+// Returns whether appending the decimal digit \a c to \a mantissa fits in a uint64_t
+inline bool fitsDigit( uint64_t mantissa, char c )
+{
+	const uint64_t limit = numeric_limits<uint64_t>::max() / 10;
+	return mantissa < limit || ( mantissa == limit && (uint64_t)( c - '0' ) <= numeric_limits<uint64_t>::max() % 10 );
+}
+
+int hexValue( char c )
+{
+	if( c >= '0' && c <= '9' )
+		return c - '0';
+	else if( c >= 'a' && c <= 'f' )
+		return c - 'a' + 10;
+	else if( c >= 'A' && c <= 'F' )
+		return c - 'A' + 10;
+	else
+		return -1;
+}
+
+void appendUtf8( uint32_t codePoint, string *result )
+{
+	if( codePoint < 0x80 )
+		result->push_back( (char)codePoint );
+	else if( codePoint < 0x800 ) {
+		result->push_back( (char)( 0xC0 | ( codePoint >> 6 ) ) );
+		result->push_back( (char)( 0x80 | ( codePoint & 0x3F ) ) );
+	}
+	else if( codePoint < 0x10000 ) {
+		result->push_back( (char)( 0xE0 | ( codePoint >> 12 ) ) );
+		result->push_back( (char)( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) ) );
+		result->push_back( (char)( 0x80 | ( codePoint & 0x3F ) ) );
+	}
+	else {
+		result->push_back( (char)( 0xF0 | ( codePoint >> 18 ) ) );
+		result->push_back( (char)( 0x80 | ( ( codePoint >> 12 ) & 0x3F ) ) );
+		result->push_back( (char)( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) ) );
+		result->push_back( (char)( 0x80 | ( codePoint & 0x3F ) ) );
+	}
+}
+
+// Writes the decimal digits of \a value so that they end at \a end, returning a pointer to the first digit
+char* formatUnsigned( uint64_t value, char *end )
+{
+	do {
+		*--end = (char)( '0' + value % 10 );
+		value /= 10;
+	} while( value );
+	return end;
+}
+
+// Formats \a value with the fewest of \a minDigits or \a maxDigits significant digits which read back as the same \a T
+template<typename T>
+int formatReal( T value, int minDigits, int maxDigits, char *result, size_t resultSize )
+{
+#if defined( CINDER_MSW )
+	int length = sprintf_s( result, resultSize, "%.*g", minDigits, (double)value );
+	if( (T)strtod( result, nullptr ) != value )
+		length = sprintf_s( result, resultSize, "%.*g", maxDigits, (double)value );
+#else
+	int length = snprintf( result, resultSize, "%.*g", minDigits, (double)value );
+	if( (T)strtod( result, nullptr ) != value )
+		length = snprintf( result, resultSize, "%.*g", maxDigits, (double)value );
+#endif
+	// keep numbers which happen to be integral recognizable as reals
+	if( ! strpbrk( result, ".eE" ) ) {
+		result[length++] = '.';
+		result[length++] = '0';
+		result[length] = 0;
+	}
+	return length;
+}
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// JsonReader
+
+JsonReader::JsonReader( const DataSourceRef &dataSource, bool allowComments )
+{
+	if( dataSource->isFilePath() ) {
+		try {
+			mMappedFile = MemoryMappedFile::create( dataSource->getFilePath() );
+			mBegin = (const char*)mMappedFile->getData();
+			mEnd = mBegin + mMappedFile->getSize();
+		}
+		catch( ExcMemoryMappedFile & ) {
+		}
+	}
+
+	if( ! mMappedFile ) {
+		mBuffer = dataSource->getBuffer();
+		mBegin = (const char*)mBuffer->getData();
+		mEnd = mBegin + mBuffer->getSize();
+	}
+
+	init( allowComments );
+}
+
+JsonReader::JsonReader( const char *data, size_t size, bool allowComments )
+	: mBegin( data ), mEnd( data + size )
+{
+	init( allowComments );
+}
+
+JsonReader::~JsonReader()
+{
+}
+
+void JsonReader::init( bool allowComments )
+{
+	mPos = mBegin;
+	mAllowComments = allowComments;
+	mEvent = EVENT_NONE;
+	mState = STATE_VALUE;
+	mBool = false;
+	mNumberType = NUMBER_INT;
+	mInt = 0;
+
+	// skip a UTF-8 byte order mark
+	if( mEnd - mBegin >= 3 && memcmp( mBegin, "\xEF\xBB\xBF", 3 ) == 0 )
+		mPos += 3;
+}
+
+JsonReader::Event JsonReader::next()
+{
+	skipWhitespace();
+
+	if( mState == STATE_DONE )
+		return mEvent = EVENT_END_DOCUMENT;
+
+	if( mState == STATE_COMMA_OR_END && mStack.empty() ) {
+		if( mPos != mEnd )
+			throwError( "unexpected data after the end of the document" );
+		mState = STATE_DONE;
+		return mEvent = EVENT_END_DOCUMENT;
+	}
+
+	if( mPos == mEnd )
+		throwError( "unexpected end of the document" );
+
+	const char c = *mPos;
+	switch( mState ) {
+		case STATE_COMMA_OR_END:
+			if( c == ',' ) {
+				++mPos;
+				skipWhitespace();
+				if( mPos == mEnd )
+					throwError( "unexpected end of the document" );
+				if( ! mStack.back() )
+					return mEvent = readValue();
+			}
+			else if( c == ( mStack.back() ? '}' : ']' ) ) {
+				++mPos;
+				mEvent = mStack.back() ? EVENT_END_OBJECT : EVENT_END_ARRAY;
+				mStack.pop_back();
+				return mEvent;
+			}
+			else
+				throwError( mStack.back() ? "expected ',' or '}'" : "expected ',' or ']'" );
+		break;
+		case STATE_KEY_OR_END:
+			if( c == '}' ) {
+				++mPos;
+				mStack.pop_back();
+				mState = STATE_COMMA_OR_END;
+				return mEvent = EVENT_END_OBJECT;
+			}
+		break;
+		case STATE_VALUE_OR_END:
+			if( c == ']' ) {
+				++mPos;
+				mStack.pop_back();
+				mState = STATE_COMMA_OR_END;
+				return mEvent = EVENT_END_ARRAY;
+			}
+			return mEvent = readValue();
+		case STATE_VALUE:
+			return mEvent = readValue();
+		default:
+		break;
+	}
+
+	// all remaining paths expect a key
+	if( *mPos != '"' )
+		throwError( "expected a key" );
+	readString();
+	skipWhitespace();
+	if( mPos == mEnd || *mPos != ':' )
+		throwError( "expected ':' after a key" );
+	++mPos;
+	mState = STATE_VALUE;
+	return mEvent = EVENT_KEY;
+}
+
+void JsonReader::skip()
+{
+	if( mEvent == EVENT_KEY )
+		next();
+
+	if( mEvent == EVENT_START_OBJECT || mEvent == EVENT_START_ARRAY ) {
+		const size_t depth = mStack.size();
+		while( mStack.size() >= depth )
+			next();
+	}
+}
+
+double JsonReader::getDouble() const
+{
+	switch( mNumberType ) {
+		case NUMBER_INT:	return (double)mInt;
+		case NUMBER_UINT:	return (double)mUint;
+		default:			return mDouble;
+	}
+}
+
+int64_t JsonReader::getInt64() const
+{
+	switch( mNumberType ) {
+		case NUMBER_INT:	return mInt;
+		case NUMBER_UINT:	return (int64_t)mUint;
+		default:			return (int64_t)mDouble;
+	}
+}
+
+uint64_t JsonReader::getUint64() const
+{
+	switch( mNumberType ) {
+		case NUMBER_INT:	return (uint64_t)mInt;
+		case NUMBER_UINT:	return mUint;
+		default:			return (uint64_t)mDouble;
+	}
+}
+
+void JsonReader::skipWhitespace()
+{
+	while( mPos != mEnd ) {
+		const char c = *mPos;
+		if( c == ' ' || c == '\n' || c == '\r' || c == '\t' )
+			++mPos;
+		else if( c == '/' && mAllowComments && mEnd - mPos >= 2 && mPos[1] == '/' ) {
+			while( mPos != mEnd && *mPos != '\n' )
+				++mPos;
+		}
+		else if( c == '/' && mAllowComments && mEnd - mPos >= 2 && mPos[1] == '*' ) {
+			const char *start = mPos;
+			mPos += 2;
+			while( mEnd - mPos >= 2 && ! ( mPos[0] == '*' && mPos[1] == '/' ) )
+				++mPos;
+			if( mEnd - mPos < 2 ) {
+				mPos = start;
+				throwError( "unterminated comment" );
+			}
+			mPos += 2;
+		}
+		else
+			break;
+	}
+}
+
+JsonReader::Event JsonReader::readValue()
+{
+	switch( *mPos ) {
+		case '{':
+			++mPos;
+			mStack.push_back( true );
+			mState = STATE_KEY_OR_END;
+			return EVENT_START_OBJECT;
+		case '[':
+			++mPos;
+			mStack.push_back( false );
+			mState = STATE_VALUE_OR_END;
+			return EVENT_START_ARRAY;
+		case '"':
+			readString();
+			mState = STATE_COMMA_OR_END;
+			return EVENT_STRING;
+		case 't':
+			readLiteral( "true", 4 );
+			mBool = true;
+			mState = STATE_COMMA_OR_END;
+			return EVENT_BOOL;
+		case 'f':
+			readLiteral( "false", 5 );
+			mBool = false;
+			mState = STATE_COMMA_OR_END;
+			return EVENT_BOOL;
+		case 'n':
+			readLiteral( "null", 4 );
+			mState = STATE_COMMA_OR_END;
+			return EVENT_NULL;
+		default:
+			if( *mPos == '-' || isDigit( *mPos ) ) {
+				readNumber();
+				mState = STATE_COMMA_OR_END;
+				return EVENT_NUMBER;
+			}
+			throwError( "expected a value" );
+			return EVENT_NONE; // unreachable
+	}
+}
+
+void JsonReader::readString()
+{
+	// the common case of a string without escape sequences is returned in place
+	const char *start = ++mPos;
+	while( mPos != mEnd && *mPos != '"' && *mPos != '\\' && (unsigned char)*mPos >= 0x20 )
+		++mPos;
+	if( mPos != mEnd && *mPos == '"' ) {
+		mString = boost::string_ref( start, mPos - start );
+		++mPos;
+		return;
+	}
+
+	mUnescaped.assign( start, mPos );
+	while( true ) {
+		if( mPos == mEnd ) {
+			mPos = start - 1;
+			throwError( "unterminated string" );
+		}
+
+		const char c = *mPos;
+		if( c == '"' ) {
+			++mPos;
+			break;
+		}
+		else if( (unsigned char)c < 0x20 )
+			throwError( "control character in string" );
+		else if( c != '\\' ) {
+			mUnescaped.push_back( c );
+			++mPos;
+			continue;
+		}
+
+		if( mEnd - mPos < 2 )
+			throwError( "unterminated escape sequence" );
+		const char escaped = mPos[1];
+		mPos += 2;
+		switch( escaped ) {
+			case '"':	mUnescaped.push_back( '"' ); break;
+			case '\\':	mUnescaped.push_back( '\\' ); break;
+			case '/':	mUnescaped.push_back( '/' ); break;
+			case 'b':	mUnescaped.push_back( '\b' ); break;
+			case 'f':	mUnescaped.push_back( '\f' ); break;
+			case 'n':	mUnescaped.push_back( '\n' ); break;
+			case 'r':	mUnescaped.push_back( '\r' ); break;
+			case 't':	mUnescaped.push_back( '\t' ); break;
+			case 'u': {
+				uint32_t codePoint = 0;
+				// a surrogate pair is two consecutive escapes
+				for( int unit = 0; unit < 2; unit++ ) {
+					if( mEnd - mPos < 4 )
+						throwError( "invalid unicode escape sequence" );
+					uint32_t value = 0;
+					for( int i = 0; i < 4; i++ ) {
+						const int digit = hexValue( mPos[i] );
+						if( digit < 0 )
+							throwError( "invalid unicode escape sequence" );
+						value = value * 16 + digit;
+					}
+					mPos += 4;
+
+					if( unit == 0 ) {
+						codePoint = value;
+						if( value < 0xD800 || value > 0xDBFF )
+							break;
+						if( mEnd - mPos < 2 || mPos[0] != '\\' || mPos[1] != 'u' )
+							throwError( "unpaired surrogate in unicode escape sequence" );
+						mPos += 2;
+					}
+					else {
+						if( value < 0xDC00 || value > 0xDFFF )
+							throwError( "unpaired surrogate in unicode escape sequence" );
+						codePoint = 0x10000 + ( ( codePoint - 0xD800 ) << 10 ) + ( value - 0xDC00 );
+					}
+				}
+				appendUtf8( codePoint, &mUnescaped );
+			}
+			break;
+			default:
+				mPos -= 2;
+				throwError( "invalid escape sequence" );
+		}
+	}
+
+	mString = boost::string_ref( mUnescaped );
+}
+
+void JsonReader::readNumber()
+{
+	const char *start = mPos;
+	const bool negative = *mPos == '-';
+	if( negative )
+		++mPos;
+
+	// accumulate as many significant digits as fit in a uint64_t
+	uint64_t mantissa = 0;
+	int exponent = 0;
+	bool truncated = false;
+
+	if( mPos == mEnd || ! isDigit( *mPos ) )
+		throwError( "invalid number" );
+	if( *mPos == '0' ) {
+		++mPos;
+		if( mPos != mEnd && isDigit( *mPos ) )
+			throwError( "invalid number, leading zeros are not allowed" );
+	}
+	else {
+		for( ; mPos != mEnd && isDigit( *mPos ); ++mPos ) {
+			if( fitsDigit( mantissa, *mPos ) )
+				mantissa = mantissa * 10 + ( *mPos - '0' );
+			else {
+				truncated = true;
+				exponent++;
+			}
+		}
+	}
+
+	bool isReal = false;
+	if( mPos != mEnd && *mPos == '.' ) {
+		isReal = true;
+		++mPos;
+		if( mPos == mEnd || ! isDigit( *mPos ) )
+			throwError( "invalid number, expected a digit after '.'" );
+		for( ; mPos != mEnd && isDigit( *mPos ); ++mPos ) {
+			if( fitsDigit( mantissa, *mPos ) && ( mantissa || *mPos != '0' ) ) {
+				mantissa = mantissa * 10 + ( *mPos - '0' );
+				exponent--;
+			}
+			else if( ! mantissa )
+				exponent--;
+			else if( *mPos != '0' )
+				truncated = true;
+		}
+	}
+
+	if( mPos != mEnd && ( *mPos == 'e' || *mPos == 'E' ) ) {
+		isReal = true;
+		++mPos;
+		bool negativeExponent = false;
+		if( mPos != mEnd && ( *mPos == '+' || *mPos == '-' ) )
+			negativeExponent = *mPos++ == '-';
+		if( mPos == mEnd || ! isDigit( *mPos ) )
+			throwError( "invalid number, expected a digit in the exponent" );
+		int explicitExponent = 0;
+		for( ; mPos != mEnd && isDigit( *mPos ); ++mPos ) {
+			if( explicitExponent < 100000 )
+				explicitExponent = explicitExponent * 10 + ( *mPos - '0' );
+		}
+		exponent += negativeExponent ? -explicitExponent : explicitExponent;
+	}
+
+	mString = boost::string_ref( start, mPos - start );
+
+	if( ! isReal && ! truncated ) {
+		if( ! negative && mantissa <= (uint64_t)numeric_limits<int64_t>::max() ) {
+			mNumberType = NUMBER_INT;
+			mInt = (int64_t)mantissa;
+			return;
+		}
+		else if( ! negative ) {
+			mNumberType = NUMBER_UINT;
+			mUint = mantissa;
+			return;
+		}
+		else if( mantissa <= (uint64_t)numeric_limits<int64_t>::max() + 1 ) {
+			mNumberType = NUMBER_INT;
+			mInt = (int64_t)( 0 - mantissa );
+			return;
+		}
+	}
+
+	mNumberType = NUMBER_DOUBLE;
+	// mantissas up to 2^53 and powers of ten up to 22 are exact, so a single multiplication or division rounds correctly
+	if( ! truncated && mantissa <= ( (uint64_t)1 << 53 ) && exponent >= -22 && exponent <= 22 ) {
+		mDouble = exponent < 0 ? (double)mantissa / sPowersOf10[-exponent] : (double)mantissa * sPowersOf10[exponent];
+		if( negative )
+			mDouble = -mDouble;
+	}
+	else {
+		const string text( start, mPos );
+		mDouble = strtod( text.c_str(), nullptr );
+	}
+}
+
+void JsonReader::readLiteral( const char *literal, size_t length )
+{
+	if( (size_t)( mEnd - mPos ) < length || memcmp( mPos, literal, length ) != 0 )
+		throwError( "expected a value" );
+	mPos += length;
+}
+
+void JsonReader::throwError( const string &message ) const
+{
+	size_t line = 1, column = 1;
+	for( const char *c = mBegin; c != mPos; ++c ) {
+		if( *c == '\n' ) {
+			line++;
+			column = 1;
+		}
+		else
+			column++;
+	}
+
+	throw ExcJsonReader( "JSON parse error at line " + to_string( line ) + ", column " + to_string( column ) + ": " + message );
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// JsonWriter
+
+JsonWriter::JsonWriter( const DataTargetRef &dataTarget, bool indented )
+	: mStream( dataTarget->getStream() ), mStdStream( nullptr ), mIndented( indented ), mHasKey( false ), mDocumentStarted( false )
+{
+	mBuffer.reserve( JSON_WRITER_BUFFER_SIZE + 1024 );
+}
+
+JsonWriter::JsonWriter( std::ostream &stream, bool indented )
+	: mStdStream( &stream ), mIndented( indented ), mHasKey( false ), mDocumentStarted( false )
+{
+	mBuffer.reserve( JSON_WRITER_BUFFER_SIZE + 1024 );
+}
+
+JsonWriter::~JsonWriter()
+{
+	// errors can't be reported from here, call flush() first to be notified of them
+	try {
+		flush();
+	}
+	catch( ... ) {
+	}
+}
+
+JsonWriter& JsonWriter::startObject()
+{
+	beginValue();
+	mBuffer.push_back( '{' );
+	Level level = { true, true };
+	mStack.push_back( level );
+	return *this;
+}
+
+JsonWriter& JsonWriter::endObject()
+{
+	endContainer( true );
+	return *this;
+}
+
+JsonWriter& JsonWriter::startArray()
+{
+	beginValue();
+	mBuffer.push_back( '[' );
+	Level level = { false, true };
+	mStack.push_back( level );
+	return *this;
+}
+
+JsonWriter& JsonWriter::endArray()
+{
+	endContainer( false );
+	return *this;
+}
+
+JsonWriter& JsonWriter::key( const boost::string_ref &key )
+{
+	if( mStack.empty() || ! mStack.back().mObject )
+		throwError( "keys can only be written inside of an object" );
+	if( mHasKey )
+		throwError( "the previous key has no value" );
+	if( mBuffer.size() >= JSON_WRITER_BUFFER_SIZE )
+		flush();
+
+	if( ! mStack.back().mEmpty )
+		mBuffer.push_back( ',' );
+	mStack.back().mEmpty = false;
+	newLine();
+	appendEscaped( key );
+	mBuffer.append( mIndented ? " : " : ":" );
+	mHasKey = true;
+	return *this;
+}
+
+JsonWriter& JsonWriter::value( const boost::string_ref &value )
+{
+	beginValue();
+	appendEscaped( value );
+	return *this;
+}
+
+JsonWriter& JsonWriter::value( bool value )
+{
+	beginValue();
+	mBuffer.append( value ? "true" : "false" );
+	return *this;
+}
+
+JsonWriter& JsonWriter::value( int64_t value )
+{
+	beginValue();
+	char digits[24];
+	char *end = digits + sizeof( digits );
+	char *start = formatUnsigned( value < 0 ? 0 - (uint64_t)value : (uint64_t)value, end );
+	if( value < 0 )
+		*--start = '-';
+	mBuffer.append( start, end );
+	return *this;
+}
+
+JsonWriter& JsonWriter::value( uint64_t value )
+{
+	beginValue();
+	char digits[24];
+	char *end = digits + sizeof( digits );
+	mBuffer.append( formatUnsigned( value, end ), end );
+	return *this;
+}
+
+JsonWriter& JsonWriter::value( double value )
+{
+	if( ! std::isfinite( value ) )
+		return nullValue();
+
+	beginValue();
+	char text[32];
+	int length = formatReal( value, 15, 17, text, sizeof( text ) );
+	mBuffer.append( text, length );
+	return *this;
+}
+
+JsonWriter& JsonWriter::value( float value )
+{
+	if( ! std::isfinite( value ) )
+		return nullValue();
+
+	beginValue();
+	char text[32];
+	int length = formatReal( value, 7, 9, text, sizeof( text ) );
+	mBuffer.append( text, length );
+	return *this;
+}
+
+JsonWriter& JsonWriter::nullValue()
+{
+	beginValue();
+	mBuffer.append( "null" );
+	return *this;
+}
+
+JsonWriter& JsonWriter::rawValue( const boost::string_ref &json )
+{
+	beginValue();
+	mBuffer.append( json.data(), json.size() );
+	return *this;
+}
+
+void JsonWriter::flush()
+{
+	if( mBuffer.empty() )
+		return;
+
+	if( mStream )
+		mStream->writeData( mBuffer.data(), mBuffer.size() );
+	else
+		mStdStream->write( mBuffer.data(), mBuffer.size() );
+	mBuffer.clear();
+}
+
+void JsonWriter::beginValue()
+{
+	if( mBuffer.size() >= JSON_WRITER_BUFFER_SIZE )
+		flush();
+
+	if( mStack.empty() ) {
+		if( mDocumentStarted )
+			throwError( "a JSON document can only have a single root value" );
+		mDocumentStarted = true;
+	}
+	else if( mStack.back().mObject ) {
+		if( ! mHasKey )
+			throwError( "values inside of an object must follow a key" );
+		mHasKey = false;
+	}
+	else {
+		if( ! mStack.back().mEmpty )
+			mBuffer.push_back( ',' );
+		mStack.back().mEmpty = false;
+		newLine();
+	}
+}
+
+void JsonWriter::endContainer( bool object )
+{
+	if( mStack.empty() || mStack.back().mObject != object )
+		throwError( object ? "endObject() doesn't match a call to startObject()" : "endArray() doesn't match a call to startArray()" );
+	if( mHasKey )
+		throwError( "the last key of the object has no value" );
+
+	const bool empty = mStack.back().mEmpty;
+	mStack.pop_back();
+	if( ! empty )
+		newLine();
+	mBuffer.push_back( object ? '}' : ']' );
+
+	if( mStack.empty() && mIndented )
+		mBuffer.push_back( '\n' );
+}
+
+void JsonWriter::newLine()
+{
+	if( mIndented ) {
+		mBuffer.push_back( '\n' );
+		mBuffer.append( mStack.size(), '\t' );
+	}
+}
+
+void JsonWriter::appendEscaped( const boost::string_ref &s )
+{
+	static const char *sHexDigits = "0123456789abcdef";
+
+	mBuffer.push_back( '"' );
+	const char *run = s.data(), *end = s.data() + s.size();
+	for( const char *c = run; c != end; ++c ) {
+		const unsigned char u = (unsigned char)*c;
+		if( u >= 0x20 && u != '"' && u != '\\' )
+			continue;
+
+		mBuffer.append( run, c );
+		run = c + 1;
+		mBuffer.push_back( '\\' );
+		switch( u ) {
+			case '"':	mBuffer.push_back( '"' ); break;
+			case '\\':	mBuffer.push_back( '\\' ); break;
+			case '\b':	mBuffer.push_back( 'b' ); break;
+			case '\f':	mBuffer.push_back( 'f' ); break;
+			case '\n':	mBuffer.push_back( 'n' ); break;
+			case '\r':	mBuffer.push_back( 'r' ); break;
+			case '\t':	mBuffer.push_back( 't' ); break;
+			default:
+				mBuffer.append( "u00" );
+				mBuffer.push_back( sHexDigits[u >> 4] );
+				mBuffer.push_back( sHexDigits[u & 0xF] );
+		}
+	}
+	mBuffer.append( run, end );
+	mBuffer.push_back( '"' );
+}
+
+void JsonWriter::throwError( const string &message ) const
+{
+	throw ExcJsonWriter( "Invalid JSON: " + message );
+}
+
+} // namespace cinder
@@ -45,7 +45,17 @@
 	#error "This file must be compiled as Objective-C++ on the Mac"
 #endif
 
+#if defined( CINDER_COCOA ) || defined( CINDER_LINUX )
+	#include <pthread.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
 #include <mutex>
+#include <thread>
 #include <time.h>
 
 using namespace std;
@@ -85,8 +95,423 @@ const std::string getDailyLogString( const std::string& format )
 	return result;
 }
 
+// Time the background thread of asynchronous logging waits between writing out the buffered records
+#define ASYNC_LOG_INTERVAL_MS 10
+
+// Header of an asynchronous log record, which is followed by the function name, file name and text
+struct RecordHeader {
+	uint32_t	mSize;
+	uint32_t	mLevel;
+	uint32_t	mLineNumber;
+	uint32_t	mFunctionNameLength, mFileNameLength, mTextLength;
+};
+
+// Ring buffer of records written by a single thread and read by the background thread
+struct ThreadBuffer {
+	// \a capacity must be a power of two, so that positions stay consistent when they wrap around
+	ThreadBuffer( size_t capacity )
+		: mData( capacity ), mWritePos( 0 ), mReadPos( 0 ), mOrphaned( false )
+	{}
+
+	void copyIn( size_t pos, const void *src, size_t size )
+	{
+		const size_t offset = pos & ( mData.size() - 1 );
+		const size_t first = std::min( size, mData.size() - offset );
+		memcpy( &mData[offset], src, first );
+		memcpy( &mData[0], static_cast<const char*>( src ) + first, size - first );
+	}
+
+	void copyOut( size_t pos, void *dst, size_t size ) const
+	{
+		const size_t offset = pos & ( mData.size() - 1 );
+		const size_t first = std::min( size, mData.size() - offset );
+		memcpy( dst, &mData[offset], first );
+		memcpy( static_cast<char*>( dst ) + first, &mData[0], size - first );
+	}
+
+	std::vector<char>		mData;
+	// bytes written and read in total, each only advanced by one thread
+	std::atomic<size_t>		mWritePos, mReadPos;
+	// set once the writing thread has exited, after which the buffer is deleted when empty
+	std::atomic<bool>		mOrphaned;
+};
+
+#if ! defined( CINDER_UWP )
+const int sCrashSignals[] = {
+	SIGSEGV, SIGABRT, SIGFPE, SIGILL,
+#if defined( SIGBUS )
+	SIGBUS,
+#endif
+};
+const size_t sNumCrashSignals = sizeof( sCrashSignals ) / sizeof( sCrashSignals[0] );
+
+void (*sPreviousCrashHandlers[sNumCrashSignals])( int );
+#endif
+
+#if defined( CINDER_COCOA ) || defined( CINDER_LINUX )
+	pthread_key_t sThreadBufferKey;
+
+	void orphanThreadBuffer( void *buffer )
+	{
+		static_cast<ThreadBuffer*>( buffer )->mOrphaned.store( true );
+	}
+
+	ThreadBuffer* getThreadBuffer()					{ return static_cast<ThreadBuffer*>( pthread_getspecific( sThreadBufferKey ) ); }
+	void setThreadBuffer( ThreadBuffer *buffer )	{ pthread_setspecific( sThreadBufferKey, buffer ); }
+#else
+	// without a notification of thread exit, the buffers of exited threads are kept until the LogManager is destroyed
+	#if defined( _MSC_VER )
+		__declspec(thread) ThreadBuffer *sThreadBuffer = nullptr;
+	#else
+		thread_local ThreadBuffer *sThreadBuffer = nullptr;
+	#endif
+
+	ThreadBuffer* getThreadBuffer()					{ return sThreadBuffer; }
+	void setThreadBuffer( ThreadBuffer *buffer )	{ sThreadBuffer = buffer; }
+#endif
+
 } // anonymous namespace
 
+// ----------------------------------------------------------------------------------------------------
+// LogManager::AsyncWriter
+// ----------------------------------------------------------------------------------------------------
+
+class LogManager::AsyncWriter {
+  public:
+	AsyncWriter( LogManager *manager )
+		: mManager( manager ), mEnabled( false ), mNumWriting( 0 ), mNumDropped( 0 ), mDraining( false ),
+			mBufferCapacity( 0 ), mStop( false ), mFlushRequested( 0 ), mFlushCompleted( 0 ), mNumDroppedReported( 0 )
+	{
+#if defined( CINDER_COCOA ) || defined( CINDER_LINUX )
+		pthread_key_create( &sThreadBufferKey, orphanThreadBuffer );
+#endif
+	}
+
+	~AsyncWriter()
+	{
+		disable();
+		AsyncWriter *self = this;
+		sExitWriter.compare_exchange_strong( self, nullptr );
+#if defined( CINDER_COCOA ) || defined( CINDER_LINUX )
+		pthread_key_delete( sThreadBufferKey );
+#endif
+		for( ThreadBuffer *buffer : mBuffers )
+			delete buffer;
+	}
+
+	void enable( size_t bufferSize, bool flushOnCrash )
+	{
+		lock_guard<mutex> lock( mMutex );
+		if( mEnabled )
+			return;
+
+		// buffers of threads that have logged asynchronously before keep their capacity
+		mBufferCapacity = 1;
+		while( mBufferCapacity < std::max<size_t>( bufferSize, sizeof( RecordHeader ) ) )
+			mBufferCapacity *= 2;
+
+		mStop = false;
+		mThread = thread( &AsyncWriter::run, this );
+		mEnabled = true;
+		if( flushOnCrash )
+			installCrashHandlers( this );
+
+		// the LogManager is leaked, so the buffered records are written out by an exit handler
+		if( ! sExitWriter.exchange( this ) )
+			std::atexit( &AsyncWriter::disableAtExit );
+	}
+
+	void disable()
+	{
+		{
+			lock_guard<mutex> lock( mMutex );
+			if( ! mEnabled )
+				return;
+			mEnabled = false;
+			mStop = true;
+		}
+
+		// let the writes which saw async logging enabled finish before the final drain
+		while( mNumWriting.load() != 0 )
+			this_thread::yield();
+
+		mCondition.notify_all();
+		mThread.join();
+		drainAll( true );
+		installCrashHandlers( nullptr );
+	}
+
+	bool isEnabled() const			{ return mEnabled; }
+	uint64_t getNumDropped() const	{ return mNumDropped; }
+
+	//! Returns \c false if async logging is disabled and \a meta and \a text were not written
+	bool write( const Metadata &meta, const string &text )
+	{
+		mNumWriting.fetch_add( 1 );
+		if( ! mEnabled ) {
+			mNumWriting.fetch_sub( 1 );
+			return false;
+		}
+
+		ThreadBuffer *buffer = getThreadBuffer();
+		if( ! buffer )
+			buffer = createThreadBuffer();
+		if( ! push( buffer, meta, text ) )
+			mNumDropped.fetch_add( 1, memory_order_relaxed );
+		mNumWriting.fetch_sub( 1 );
+
+		if( meta.mLevel == LEVEL_FATAL )
+			flush();
+
+		return true;
+	}
+
+	void flush()
+	{
+		// a Logger which logs a fatal record would otherwise wait for itself
+		if( this_thread::get_id() == mThread.get_id() )
+			return;
+
+		unique_lock<mutex> lock( mMutex );
+		if( ! mEnabled )
+			return;
+
+		const uint64_t request = ++mFlushRequested;
+		mCondition.notify_all();
+		mCondition.wait( lock, [&] { return mFlushCompleted >= request || mStop; } );
+	}
+
+  private:
+	ThreadBuffer* createThreadBuffer()
+	{
+		ThreadBuffer *buffer = new ThreadBuffer( mBufferCapacity );
+		{
+			lock_guard<mutex> lock( mBuffersMutex );
+			mBuffers.push_back( buffer );
+		}
+		setThreadBuffer( buffer );
+		return buffer;
+	}
+
+	static bool push( ThreadBuffer *buffer, const Metadata &meta, const string &text )
+	{
+		const string &functionName = meta.mLocation.getFunctionName();
+		const string &fileName = meta.mLocation.getFileName();
+
+		RecordHeader header;
+		const size_t size = sizeof( header ) + functionName.size() + fileName.size() + text.size();
+		const size_t writePos = buffer->mWritePos.load( memory_order_relaxed );
+		const size_t readPos = buffer->mReadPos.load( memory_order_acquire );
+		if( size > buffer->mData.size() - ( writePos - readPos ) )
+			return false;
+
+		header.mSize = (uint32_t)size;
+		header.mLevel = (uint32_t)meta.mLevel;
+		header.mLineNumber = (uint32_t)meta.mLocation.getLineNumber();
+		header.mFunctionNameLength = (uint32_t)functionName.size();
+		header.mFileNameLength = (uint32_t)fileName.size();
+		header.mTextLength = (uint32_t)text.size();
+
+		size_t pos = writePos;
+		buffer->copyIn( pos, &header, sizeof( header ) );
+		pos += sizeof( header );
+		buffer->copyIn( pos, functionName.data(), functionName.size() );
+		pos += functionName.size();
+		buffer->copyIn( pos, fileName.data(), fileName.size() );
+		pos += fileName.size();
+		buffer->copyIn( pos, text.data(), text.size() );
+
+		buffer->mWritePos.store( writePos + size, memory_order_release );
+		return true;
+	}
+
+	void run()
+	{
+		unique_lock<mutex> lock( mMutex );
+		while( ! mStop ) {
+			mCondition.wait_for( lock, chrono::milliseconds( ASYNC_LOG_INTERVAL_MS ), [this] { return mStop || mFlushRequested != mFlushCompleted; } );
+			const uint64_t request = mFlushRequested;
+			lock.unlock();
+			drainAll( true );
+			lock.lock();
+			mFlushCompleted = request;
+			mCondition.notify_all();
+		}
+	}
+
+	void drainAll( bool lockLoggers )
+	{
+		// drains are serialized by mDraining rather than a mutex, so that a crash handler can give up on it
+		while( mDraining.exchange( true, memory_order_acquire ) )
+			this_thread::yield();
+
+		// Loggers may log from this thread, which registers a buffer, so mBuffersMutex can't be held while writing to them
+		vector<ThreadBuffer*> buffers;
+		{
+			lock_guard<mutex> lock( mBuffersMutex );
+			buffers = mBuffers;
+		}
+
+		vector<ThreadBuffer*> orphans;
+		for( ThreadBuffer *buffer : buffers ) {
+			// reading the flag first guarantees nothing is written to an orphaned buffer after its last drain
+			const bool orphaned = buffer->mOrphaned.load();
+			drain( buffer, lockLoggers );
+			if( orphaned )
+				orphans.push_back( buffer );
+		}
+
+		if( ! orphans.empty() ) {
+			lock_guard<mutex> lock( mBuffersMutex );
+			for( ThreadBuffer *orphan : orphans ) {
+				mBuffers.erase( std::remove( mBuffers.begin(), mBuffers.end(), orphan ), mBuffers.end() );
+				delete orphan;
+			}
+		}
+
+		const uint64_t numDropped = mNumDropped.load( memory_order_relaxed );
+		if( numDropped != mNumDroppedReported ) {
+			Metadata meta;
+			meta.mLevel = LEVEL_WARNING;
+			meta.mLocation = Location( CINDER_CURRENT_FUNCTION, __FILE__, __LINE__ );
+			writeToLoggers( meta, toString( numDropped - mNumDroppedReported ) + " log records were dropped because the buffer of their thread was full", lockLoggers );
+			mNumDroppedReported = numDropped;
+		}
+
+		mDraining.store( false, memory_order_release );
+	}
+
+	// Must be called with mDraining set
+	void drain( ThreadBuffer *buffer, bool lockLoggers )
+	{
+		size_t readPos = buffer->mReadPos.load( memory_order_relaxed );
+		const size_t writePos = buffer->mWritePos.load( memory_order_acquire );
+		while( readPos != writePos ) {
+			RecordHeader header;
+			size_t pos = readPos;
+			buffer->copyOut( pos, &header, sizeof( header ) );
+			pos += sizeof( header );
+			mFunctionName.resize( header.mFunctionNameLength );
+			buffer->copyOut( pos, &mFunctionName[0], header.mFunctionNameLength );
+			pos += header.mFunctionNameLength;
+			mFileName.resize( header.mFileNameLength );
+			buffer->copyOut( pos, &mFileName[0], header.mFileNameLength );
+			pos += header.mFileNameLength;
+			mText.resize( header.mTextLength );
+			buffer->copyOut( pos, &mText[0], header.mTextLength );
+
+			// release the space before writing, which may be slow
+			readPos += header.mSize;
+			buffer->mReadPos.store( readPos, memory_order_release );
+
+			Metadata meta;
+			meta.mLevel = (Level)header.mLevel;
+			meta.mLocation = Location( mFunctionName, mFileName, header.mLineNumber );
+			writeToLoggers( meta, mText, lockLoggers );
+		}
+	}
+
+	void writeToLoggers( const Metadata &meta, const string &text, bool lockLoggers )
+	{
+		unique_lock<mutex> lock( mManager->mMutex, defer_lock );
+		if( lockLoggers )
+			lock.lock();
+
+		for( auto &logger : mManager->mLoggers )
+			logger->write( meta, text );
+	}
+
+	// Writes out the buffered records from a fatal signal handler. This is best effort, as nothing here is async-signal-safe.
+	void flushOnCrash()
+	{
+		// the crash may have happened during a drain, possibly on this thread
+		for( int attempt = 0; mDraining.exchange( true, memory_order_acquire ); ++attempt ) {
+			if( attempt == 1000 )
+				return;
+			this_thread::yield();
+		}
+
+		// the crashing thread may hold the mutexes, so neither the buffers nor the Loggers are locked
+		for( ThreadBuffer *buffer : mBuffers )
+			drain( buffer, false );
+
+		mDraining.store( false, memory_order_release );
+	}
+
+	// Installs the fatal signal handlers writing out the records of \a writer, or restores the previous handlers if \a writer is null
+	static void installCrashHandlers( AsyncWriter *writer );
+	static void handleCrash( int signal );
+
+	static void disableAtExit()
+	{
+		AsyncWriter *writer = sExitWriter.load();
+		if( writer )
+			writer->disable();
+	}
+
+	static atomic<AsyncWriter*>	sCrashWriter, sExitWriter;
+
+	LogManager*				mManager;
+	atomic<bool>			mEnabled;
+	atomic<int>				mNumWriting;	// writes in progress which saw async logging enabled
+	atomic<uint64_t>		mNumDropped;
+	atomic<bool>			mDraining;
+
+	mutex					mBuffersMutex;	// guards mBuffers
+	vector<ThreadBuffer*>	mBuffers;
+
+	mutex					mMutex;			// guards the state below, which controls the background thread
+	condition_variable		mCondition;
+	size_t					mBufferCapacity;
+	thread					mThread;
+	bool					mStop;
+	uint64_t				mFlushRequested, mFlushCompleted;
+
+	// only accessed while draining
+	uint64_t				mNumDroppedReported;
+	string					mFunctionName, mFileName, mText;
+};
+
+atomic<LogManager::AsyncWriter*> LogManager::AsyncWriter::sCrashWriter( nullptr );
+atomic<LogManager::AsyncWriter*> LogManager::AsyncWriter::sExitWriter( nullptr );
+
+void LogManager::AsyncWriter::installCrashHandlers( AsyncWriter *writer )
+{
+#if ! defined( CINDER_UWP )
+	AsyncWriter *previous = sCrashWriter.exchange( writer );
+	if( writer && ! previous ) {
+		for( size_t i = 0; i < sNumCrashSignals; i++ )
+			sPreviousCrashHandlers[i] = std::signal( sCrashSignals[i], &AsyncWriter::handleCrash );
+	}
+	else if( ! writer && previous ) {
+		for( size_t i = 0; i < sNumCrashSignals; i++ ) {
+			// leave handlers alone which have been replaced since
+			auto current = std::signal( sCrashSignals[i], sPreviousCrashHandlers[i] );
+			if( current != &AsyncWriter::handleCrash )
+				std::signal( sCrashSignals[i], current );
+		}
+	}
+#endif
+}
+
+void LogManager::AsyncWriter::handleCrash( int signal )
+{
+#if ! defined( CINDER_UWP )
+	AsyncWriter *writer = sCrashWriter.exchange( nullptr );
+	if( writer )
+		writer->flushOnCrash();
+
+	// pass the signal on to the previous handler, which for SIG_DFL terminates
+	for( size_t i = 0; i < sNumCrashSignals; i++ ) {
+		if( sCrashSignals[i] == signal ) {
+			std::signal( signal, sPreviousCrashHandlers[i] );
+			break;
+		}
+	}
+	std::raise( signal );
+#endif
+}
+
 // ----------------------------------------------------------------------------------------------------
 // LogManager
 // ----------------------------------------------------------------------------------------------------
@@ -99,10 +524,15 @@ LogManager* manager()
 }
 
 LogManager::LogManager()
+	: mAsyncWriter( new AsyncWriter( this ) )
 {
 	restoreToDefault();
 }
 
+LogManager::~LogManager()
+{
+}
+
 void LogManager::clearLoggers()
 {
 	lock_guard<mutex> lock( mMutex );
@@ -150,8 +580,36 @@ void LogManager::restoreToDefault()
 #endif
 }
 	
+void LogManager::enableAsync( size_t bufferSize, bool flushOnCrash )
+{
+	mAsyncWriter->enable( bufferSize, flushOnCrash );
+}
+
+void LogManager::disableAsync()
+{
+	mAsyncWriter->disable();
+}
+
+bool LogManager::isAsyncEnabled() const
+{
+	return mAsyncWriter->isEnabled();
+}
+
+void LogManager::flush()
+{
+	mAsyncWriter->flush();
+}
+
+uint64_t LogManager::getNumDroppedRecords() const
+{
+	return mAsyncWriter->getNumDropped();
+}
+
 void LogManager::write( const Metadata &meta, const std::string &text )
 {
+	if( mAsyncWriter->write( meta, text ) )
+		return;
+
 	// TODO move this to a shared_lock_timed with c++14 support
 	lock_guard<mutex> lock( mMutex );
 
@@ -0,0 +1,127 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cinder/MemoryMappedFile.h"
+
+#if defined( CINDER_MSW )
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace cinder {
+
+#if defined( CINDER_MSW )
+
+MemoryMappedFile::MemoryMappedFile( const fs::path &path )
+	: mFilePath( path ), mData( nullptr ), mSize( 0 ), mFileHandle( INVALID_HANDLE_VALUE ), mMappingHandle( nullptr )
+{
+#if defined( CINDER_UWP )
+	mFileHandle = ::CreateFile2( path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr );
+#else
+	mFileHandle = ::CreateFileW( path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+#endif
+	if( mFileHandle == INVALID_HANDLE_VALUE )
+		throw ExcMemoryMappedFile( path );
+
+	LARGE_INTEGER fileSize;
+	if( ! ::GetFileSizeEx( mFileHandle, &fileSize ) ) {
+		::CloseHandle( mFileHandle );
+		throw ExcMemoryMappedFile( path );
+	}
+
+	mSize = (size_t)fileSize.QuadPart;
+	if( mSize == 0 )
+		return;
+
+#if defined( CINDER_UWP )
+	mMappingHandle = ::CreateFileMappingFromApp( mFileHandle, nullptr, PAGE_READONLY, 0, nullptr );
+	if( mMappingHandle )
+		mData = ::MapViewOfFileFromApp( mMappingHandle, FILE_MAP_READ, 0, 0 );
+#else
+	mMappingHandle = ::CreateFileMappingW( mFileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	if( mMappingHandle )
+		mData = ::MapViewOfFile( mMappingHandle, FILE_MAP_READ, 0, 0, 0 );
+#endif
+
+	if( ! mData ) {
+		if( mMappingHandle )
+			::CloseHandle( mMappingHandle );
+		::CloseHandle( mFileHandle );
+		throw ExcMemoryMappedFile( path );
+	}
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	if( mData )
+		::UnmapViewOfFile( mData );
+	if( mMappingHandle )
+		::CloseHandle( mMappingHandle );
+	if( mFileHandle != INVALID_HANDLE_VALUE )
+		::CloseHandle( mFileHandle );
+}
+
+#else // ! defined( CINDER_MSW )
+
+MemoryMappedFile::MemoryMappedFile( const fs::path &path )
+	: mFilePath( path ), mData( nullptr ), mSize( 0 )
+{
+	int fd = ::open( path.c_str(), O_RDONLY );
+	if( fd < 0 )
+		throw ExcMemoryMappedFile( path );
+
+	struct stat fileStat;
+	if( ::fstat( fd, &fileStat ) != 0 ) {
+		::close( fd );
+		throw ExcMemoryMappedFile( path );
+	}
+
+	mSize = (size_t)fileStat.st_size;
+	if( mSize > 0 ) {
+		void *data = ::mmap( nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if( data == MAP_FAILED ) {
+			::close( fd );
+			throw ExcMemoryMappedFile( path );
+		}
+
+		// the mapping stays valid after the file descriptor is closed
+		::madvise( data, mSize, MADV_SEQUENTIAL );
+		mData = data;
+	}
+
+	::close( fd );
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	if( mData )
+		::munmap( const_cast<void *>( mData ), mSize );
+}
+
+#endif // ! defined( CINDER_MSW )
+
+} // namespace cinder
@@ -24,34 +24,473 @@
 */
 
 #include "cinder/ObjLoader.h"
+#include "cinder/MemoryMappedFile.h"
 
 #include <sstream>
+#include <thread>
+#include <exception>
+#include <cstdlib>
+#include <cstring>
 using namespace std;
 
-// For stoi
-#if defined( CINDER_ANDROID )
-	#include "cinder/android/CinderAndroid.h"
-#endif
+// Files smaller than this are parsed on the calling thread, larger ones are split into chunks of at least this size
+#define OBJ_MIN_CHUNK_SIZE	( 1 << 20 )
 
 namespace cinder {
 
+namespace {
+
+// Moves the vertices that are mapped onto themselves by \a remap to the front of \a buffer, keeping their order, and discards the rest.
+template<typename T>
+void compactVertices( vector<T> &buffer, const vector<uint32_t> &remap )
+{
+	if( buffer.size() < remap.size() )
+		return;
+
+	size_t numUnique = 0;
+	for( size_t i = 0; i < remap.size(); ++i ) {
+		if( remap[i] == i )
+			buffer[numUnique++] = buffer[i];
+	}
+
+	buffer.resize( numUnique );
+}
+
+// The result of parsing a range of whole lines. Indices are zero-based, and negative OBJ indices are stored relative to the
+// start of the chunk's attributes until the sizes of all preceding chunks are known.
+struct ObjChunk {
+	struct Event {
+		enum Type { GROUP, MATERIAL };
+
+		Type		mType;
+		string		mName;
+		// number of faces and attributes parsed in the chunk before this event
+		size_t		mNumFaces, mNumVertices, mNumTexCoords, mNumNormals;
+	};
+
+	void releaseIndices()
+	{
+		vector<uint32_t>().swap( mFaceEnds );
+		vector<int32_t>().swap( mVertexIndices );
+		vector<int32_t>().swap( mTexCoordIndices );
+		vector<int32_t>().swap( mNormalIndices );
+	}
+
+	vector<vec3>		mVertices, mNormals;
+	vector<vec2>		mTexCoords;
+	vector<Event>		mEvents;
+
+	// end of each face in the index arrays
+	vector<uint32_t>	mFaceEnds;
+	// the tex coord and normal indices stay empty until the first face that has them, missing ones are stored as -1
+	vector<int32_t>		mVertexIndices, mTexCoordIndices, mNormalIndices;
+	// locations in the index arrays that hold relative indices
+	vector<uint32_t>	mRelativeVertexIndices, mRelativeTexCoordIndices, mRelativeNormalIndices;
+
+	size_t				mBaseVertex, mBaseTexCoord, mBaseNormal;
+};
+
+const double sPowersOf10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isBlank( char c )
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool isDigit( char c )
+{
+	return c >= '0' && c <= '9';
+}
+
+inline const char* skipBlanks( const char *p, const char *end )
+{
+	while( p < end && isBlank( *p ) )
+		++p;
+	return p;
+}
+
+inline const char* skipToken( const char *p, const char *end )
+{
+	while( p < end && ! isBlank( *p ) )
+		++p;
+	return p;
+}
+
+// Parses a decimal number starting at \a p and advances \a p past it. Numbers that can be converted exactly from a 64-bit mantissa
+// and a power of ten are handled here, everything else (long mantissas, large exponents, inf, nan) is passed on to strtod().
+float parseFloat( const char *&p, const char *end )
+{
+	p = skipBlanks( p, end );
+	const char *start = p;
+
+	bool negative = false;
+	if( p < end && ( *p == '-' || *p == '+' ) ) {
+		negative = ( *p == '-' );
+		++p;
+	}
+
+	uint64_t mantissa = 0;
+	int exponent = 0;
+	bool hasDigits = false, exact = true;
+	for( ; p < end && isDigit( *p ); ++p ) {
+		hasDigits = true;
+		if( mantissa < 1000000000000000000ULL )
+			mantissa = mantissa * 10 + ( *p - '0' );
+		else {
+			++exponent;
+			exact = false;
+		}
+	}
+
+	if( p < end && *p == '.' ) {
+		for( ++p; p < end && isDigit( *p ); ++p ) {
+			hasDigits = true;
+			if( mantissa < 1000000000000000000ULL ) {
+				mantissa = mantissa * 10 + ( *p - '0' );
+				--exponent;
+			}
+			else
+				exact = false;
+		}
+	}
+
+	if( hasDigits && p < end && ( *p == 'e' || *p == 'E' ) ) {
+		const char *e = p + 1;
+		bool negativeExponent = false;
+		if( e < end && ( *e == '-' || *e == '+' ) ) {
+			negativeExponent = ( *e == '-' );
+			++e;
+		}
+		if( e < end && isDigit( *e ) ) {
+			int value = 0;
+			for( ; e < end && isDigit( *e ); ++e ) {
+				if( value < 10000 )
+					value = value * 10 + ( *e - '0' );
+			}
+			exponent += negativeExponent ? -value : value;
+			p = e;
+		}
+	}
+
+	if( hasDigits && exact && mantissa <= ( 1ULL << 53 ) && exponent >= -22 && exponent <= 22 ) {
+		double result = (double)mantissa;
+		result = ( exponent < 0 ) ? result / sPowersOf10[-exponent] : result * sPowersOf10[exponent];
+		return (float)( negative ? -result : result );
+	}
+
+	// strtod() needs a null-terminated copy of the token
+	char token[64];
+	size_t tokenLength = std::min<size_t>( skipToken( start, end ) - start, sizeof( token ) - 1 );
+	memcpy( token, start, tokenLength );
+	token[tokenLength] = 0;
+
+	char *tokenEnd;
+	double result = strtod( token, &tokenEnd );
+	p = start + ( tokenEnd - token );
+	return (float)result;
+}
+
+// Parses a decimal integer starting at \a p and advances \a p past it. Returns false if there is no number at \a p.
+bool parseInt( const char *&p, const char *end, int32_t *result )
+{
+	const char *start = p;
+	bool negative = false;
+	if( p < end && ( *p == '-' || *p == '+' ) ) {
+		negative = ( *p == '-' );
+		++p;
+	}
+
+	if( p == end || ! isDigit( *p ) ) {
+		p = start;
+		return false;
+	}
+
+	int64_t value = 0;
+	for( ; p < end && isDigit( *p ); ++p ) {
+		if( value < numeric_limits<int32_t>::max() )
+			value = value * 10 + ( *p - '0' );
+	}
+
+	value = std::min<int64_t>( value, numeric_limits<int32_t>::max() );
+	*result = (int32_t)( negative ? -value : value );
+	return true;
+}
+
+// Converts a one-based OBJ index to a zero-based one. Negative indices count back from \a count, and are recorded in \a relative so that they can be
+// offset by the chunk's base once it is known. Returns false for the invalid index 0.
+inline bool resolveIndex( int32_t index, size_t count, uint32_t location, vector<uint32_t> *relative, int32_t *result )
+{
+	if( index > 0 )
+		*result = index - 1;
+	else if( index < 0 ) {
+		*result = (int32_t)count + index;
+		relative->push_back( location );
+	}
+
+	return index != 0;
+}
+
+// Appends \a index to the optional index array \a indices, allocating it on the first index that is present.
+inline void appendOptionalIndex( vector<int32_t> &indices, size_t location, bool present, int32_t index )
+{
+	if( present && indices.size() < location )
+		indices.resize( location, -1 );
+	if( ! indices.empty() || present )
+		indices.push_back( present ? index : -1 );
+}
+
+void parseFace( const char *p, const char *end, bool includeNormals, bool includeTexCoords, ObjChunk *chunk )
+{
+	const size_t firstIndex = chunk->mVertexIndices.size();
+	while( true ) {
+		p = skipBlanks( p, end );
+		if( p == end )
+			break;
+
+		// each vertex is "v", "v/vt", "v//vn" or "v/vt/vn"
+		int32_t vertex, texCoord = 0, normal = 0;
+		if( ! parseInt( p, end, &vertex ) ) {
+			p = skipToken( p, end );
+			continue;
+		}
+		if( p < end && *p == '/' ) {
+			++p;
+			parseInt( p, end, &texCoord );
+			if( p < end && *p == '/' ) {
+				++p;
+				parseInt( p, end, &normal );
+			}
+		}
+		p = skipToken( p, end );
+
+		const uint32_t location = (uint32_t)chunk->mVertexIndices.size();
+		int32_t resolved;
+		if( ! resolveIndex( vertex, chunk->mVertices.size(), location, &chunk->mRelativeVertexIndices, &resolved ) )
+			resolved = -1;
+		chunk->mVertexIndices.push_back( resolved );
+
+		bool present = includeTexCoords && resolveIndex( texCoord, chunk->mTexCoords.size(), location, &chunk->mRelativeTexCoordIndices, &resolved );
+		appendOptionalIndex( chunk->mTexCoordIndices, location, present, resolved );
+
+		present = includeNormals && resolveIndex( normal, chunk->mNormals.size(), location, &chunk->mRelativeNormalIndices, &resolved );
+		appendOptionalIndex( chunk->mNormalIndices, location, present, resolved );
+	}
+
+	if( chunk->mVertexIndices.size() > firstIndex )
+		chunk->mFaceEnds.push_back( (uint32_t)chunk->mVertexIndices.size() );
+}
+
+void parseLine( const char *p, const char *end, bool includeNormals, bool includeTexCoords, ObjChunk *chunk )
+{
+	p = skipBlanks( p, end );
+	if( p == end || *p == '#' )
+		return;
+
+	const char *tag = p;
+	p = skipToken( p, end );
+	const size_t tagLength = p - tag;
+
+	if( tagLength == 1 && tag[0] == 'v' ) { // vertex
+		vec3 v;
+		v.x = parseFloat( p, end );
+		v.y = parseFloat( p, end );
+		v.z = parseFloat( p, end );
+		chunk->mVertices.push_back( v );
+	}
+	else if( tagLength == 2 && tag[0] == 'v' && tag[1] == 't' ) { // vertex texture coordinates
+		if( includeTexCoords ) {
+			vec2 tex;
+			tex.x = parseFloat( p, end );
+			tex.y = parseFloat( p, end );
+			chunk->mTexCoords.push_back( tex );
+		}
+	}
+	else if( tagLength == 2 && tag[0] == 'v' && tag[1] == 'n' ) { // vertex normals
+		if( includeNormals ) {
+			vec3 v;
+			v.x = parseFloat( p, end );
+			v.y = parseFloat( p, end );
+			v.z = parseFloat( p, end );
+			chunk->mNormals.push_back( normalize( v ) );
+		}
+	}
+	else if( tagLength == 1 && tag[0] == 'f' ) { // face
+		parseFace( p, end, includeNormals, includeTexCoords, chunk );
+	}
+	else if( ( tagLength == 1 && tag[0] == 'g' ) || ( tagLength == 6 && ! strncmp( tag, "usemtl", 6 ) ) ) { // group or material
+		ObjChunk::Event event;
+		event.mType = ( tagLength == 1 ) ? ObjChunk::Event::GROUP : ObjChunk::Event::MATERIAL;
+		event.mNumFaces = chunk->mFaceEnds.size();
+		event.mNumVertices = chunk->mVertices.size();
+		event.mNumTexCoords = chunk->mTexCoords.size();
+		event.mNumNormals = chunk->mNormals.size();
+
+		// groups are named by the rest of the line, materials by the first token
+		p = skipBlanks( p, end );
+		const char *nameEnd = end;
+		if( event.mType == ObjChunk::Event::MATERIAL )
+			nameEnd = skipToken( p, end );
+		while( nameEnd > p && isBlank( nameEnd[-1] ) )
+			--nameEnd;
+		event.mName.assign( p, nameEnd );
+
+		chunk->mEvents.push_back( event );
+	}
+}
+
+// Returns whether the line [\a begin, \a end) continues on the next line.
+inline bool isContinued( const char *begin, const char *end )
+{
+	while( end > begin && end[-1] == '\r' )
+		--end;
+	return end > begin && end[-1] == '\\';
+}
+
+void parseChunk( const char *begin, const char *end, bool includeNormals, bool includeTexCoords, ObjChunk *chunk )
+{
+	string joinedLine;
+	const char *lineBegin = begin;
+	while( lineBegin < end ) {
+		const char *lineEnd = (const char*)memchr( lineBegin, '\n', end - lineBegin );
+		if( ! lineEnd )
+			lineEnd = end;
+
+		if( ! isContinued( lineBegin, lineEnd ) ) {
+			parseLine( lineBegin, lineEnd, includeNormals, includeTexCoords, chunk );
+			lineBegin = lineEnd + 1;
+			continue;
+		}
+
+		// lines ending in a backslash are joined with the following ones
+		joinedLine.clear();
+		while( true ) {
+			const bool continued = isContinued( lineBegin, lineEnd );
+			const char *contentEnd = lineEnd;
+			while( contentEnd > lineBegin && contentEnd[-1] == '\r' )
+				--contentEnd;
+			joinedLine.append( lineBegin, continued ? contentEnd - 1 : contentEnd );
+
+			lineBegin = lineEnd + 1;
+			if( ! continued || lineBegin >= end )
+				break;
+
+			lineEnd = (const char*)memchr( lineBegin, '\n', end - lineBegin );
+			if( ! lineEnd )
+				lineEnd = end;
+		}
+
+		parseLine( joinedLine.data(), joinedLine.data() + joinedLine.size(), includeNormals, includeTexCoords, chunk );
+	}
+}
+
+// Returns the start of the first line after \a p that doesn't continue a previous line.
+const char* findChunkBoundary( const char *data, const char *p, const char *end )
+{
+	while( p < end ) {
+		const char *newline = (const char*)memchr( p, '\n', end - p );
+		if( ! newline )
+			return end;
+		if( ! isContinued( data, newline ) )
+			return newline + 1;
+		p = newline + 1;
+	}
+
+	return end;
+}
+
+template<typename T>
+void appendAndRelease( vector<T> &dest, vector<T> &source )
+{
+	dest.insert( dest.end(), source.begin(), source.end() );
+	vector<T>().swap( source );
+}
+
+void offsetIndices( vector<int32_t> &indices, const vector<uint32_t> &locations, size_t base )
+{
+	for( uint32_t location : locations )
+		indices[location] += (int32_t)base;
+}
+
+// File-based sources are mapped into memory, anything else is read into \a buffer.
+const char* loadObjData( const DataSourceRef &dataSource, MemoryMappedFileRef *mappedFile, BufferRef *buffer, size_t *dataSize )
+{
+	if( dataSource->isFilePath() ) {
+		try {
+			*mappedFile = MemoryMappedFile::create( dataSource->getFilePath() );
+			*dataSize = (*mappedFile)->getSize();
+			return (const char*)(*mappedFile)->getData();
+		}
+		catch( ExcMemoryMappedFile & ) {
+		}
+	}
+
+	*buffer = dataSource->getBuffer();
+	*dataSize = (*buffer)->getSize();
+	return (const char*)(*buffer)->getData();
+}
+
+} // anonymous namespace
+
+// Maps each position index to the output vertices that were created for it, chained by their tex coord and normal indices.
+struct ObjLoader::UniqueVertexMap {
+	UniqueVertexMap( size_t numPositions )
+		: mFirst( numPositions, -1 )
+	{}
+
+	//! Returns the output index of the vertex with the given attribute indices, or \a output if it hasn't been seen before.
+	uint32_t insert( int32_t position, int32_t texCoord, int32_t normal, uint32_t output )
+	{
+		for( int32_t e = mFirst[position]; e >= 0; e = mEntries[e].mNext ) {
+			if( mEntries[e].mTexCoord == texCoord && mEntries[e].mNormal == normal )
+				return mEntries[e].mOutput;
+		}
+
+		Entry entry = { texCoord, normal, output, mFirst[position] };
+		mFirst[position] = (int32_t)mEntries.size();
+		mEntries.push_back( entry );
+		return output;
+	}
+
+	struct Entry {
+		int32_t		mTexCoord, mNormal;
+		uint32_t	mOutput;
+		int32_t		mNext;
+	};
+
+	vector<int32_t>	mFirst;
+	vector<Entry>	mEntries;
+};
+
 ObjLoader::ObjLoader( shared_ptr<IStreamCinder> stream, bool includeNormals, bool includeTexCoords, bool optimize )
-	: mStream( stream ), mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
+	: mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
 {
-	parse( includeNormals, includeTexCoords );
+	BufferRef buffer = loadStreamBuffer( stream );
+	parse( (const char*)buffer->getData(), buffer->getSize(), includeNormals, includeTexCoords );
 }
 
 ObjLoader::ObjLoader( DataSourceRef dataSource, bool includeNormals, bool includeTexCoords, bool optimize )
-	: mStream( dataSource->createStream() ), mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
+	: mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
 {
-	parse( includeNormals, includeTexCoords );
+	MemoryMappedFileRef mappedFile;
+	BufferRef buffer;
+	size_t dataSize;
+	const char *data = loadObjData( dataSource, &mappedFile, &buffer, &dataSize );
+	parse( data, dataSize, includeNormals, includeTexCoords );
 }
 
 ObjLoader::ObjLoader( DataSourceRef dataSource, DataSourceRef materialSource, bool includeNormals, bool includeTexCoords, bool optimize )
-	: mStream( dataSource->createStream() ), mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
+	: mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
 {
 	parseMaterial( materialSource->createStream() );
-	parse( includeNormals, includeTexCoords );
+
+	MemoryMappedFileRef mappedFile;
+	BufferRef buffer;
+	size_t dataSize;
+	const char *data = loadObjData( dataSource, &mappedFile, &buffer, &dataSize );
+	parse( data, dataSize, includeNormals, includeTexCoords );
 }
 
 ObjLoader& ObjLoader::groupIndex( size_t groupIndex )
@@ -181,141 +620,173 @@ void ObjLoader::parseMaterial( std::shared_ptr<IStreamCinder> material )
         mMaterials[m.mName] = m;
 }
 
-void ObjLoader::parse( bool includeNormals, bool includeTexCoords )
+void ObjLoader::parse( const char *data, size_t dataSize, bool includeNormals, bool includeTexCoords )
 {
-	Group *currentGroup;
-	mGroups.push_back( Group() );
-	currentGroup = &mGroups[mGroups.size()-1];
-	currentGroup->mBaseVertexOffset = currentGroup->mBaseTexCoordOffset = currentGroup->mBaseNormalOffset = 0;
+	// split the data at line boundaries, one chunk per thread
+	const size_t numChunks = std::max<size_t>( 1, std::min<size_t>( thread::hardware_concurrency(), dataSize / OBJ_MIN_CHUNK_SIZE ) );
+	vector<const char*> chunkBounds( 1, data );
+	for( size_t i = 1; i < numChunks; ++i )
+		chunkBounds.push_back( findChunkBoundary( data, std::max( chunkBounds.back(), data + dataSize * i / numChunks ), data + dataSize ) );
+	chunkBounds.push_back( data + dataSize );
+
+	vector<ObjChunk> chunks( numChunks );
+	if( numChunks == 1 )
+		parseChunk( data, data + dataSize, includeNormals, includeTexCoords, &chunks[0] );
+	else {
+		vector<thread> threads;
+		vector<exception_ptr> exceptions( numChunks );
+		for( size_t i = 0; i < numChunks; ++i ) {
+			threads.emplace_back( [&, i] {
+				try {
+					parseChunk( chunkBounds[i], chunkBounds[i + 1], includeNormals, includeTexCoords, &chunks[i] );
+				}
+				catch( ... ) {
+					exceptions[i] = current_exception();
+				}
+			} );
+		}
 
-    const Material *currentMaterial = 0;
+		for( auto &t : threads )
+			t.join();
+		for( const auto &e : exceptions ) {
+			if( e )
+				rethrow_exception( e );
+		}
+	}
 
-	size_t lineNumber = 0;
-	while( ! mStream->isEof() ) {
-		lineNumber++;
-		string line = mStream->readLine(), tag;
-        if( line.empty() || line[0] == '#' )
-            continue;
+	// merge the attributes, now that the base of each chunk is known relative indices can be resolved
+	size_t numVertices = 0, numTexCoords = 0, numNormals = 0;
+	for( auto &chunk : chunks ) {
+		chunk.mBaseVertex = numVertices;
+		chunk.mBaseTexCoord = numTexCoords;
+		chunk.mBaseNormal = numNormals;
+		numVertices += chunk.mVertices.size();
+		numTexCoords += chunk.mTexCoords.size();
+		numNormals += chunk.mNormals.size();
+
+		offsetIndices( chunk.mVertexIndices, chunk.mRelativeVertexIndices, chunk.mBaseVertex );
+		offsetIndices( chunk.mTexCoordIndices, chunk.mRelativeTexCoordIndices, chunk.mBaseTexCoord );
+		offsetIndices( chunk.mNormalIndices, chunk.mRelativeNormalIndices, chunk.mBaseNormal );
+	}
 
-		while( line.back() == '\\' && ! mStream->isEof() ) {
-			auto next = mStream->readLine();
-			line = line.substr( 0, line.size() - 1 ) + next;
-		}
+	mInternalVertices.reserve( numVertices );
+	mInternalTexCoords.reserve( numTexCoords );
+	mInternalNormals.reserve( numNormals );
+	for( auto &chunk : chunks ) {
+		appendAndRelease( mInternalVertices, chunk.mVertices );
+		appendAndRelease( mInternalTexCoords, chunk.mTexCoords );
+		appendAndRelease( mInternalNormals, chunk.mNormals );
+	}
 
-		stringstream ss( line );
-		ss >> tag;
-		if( tag == "v" ) { // vertex
-			vec3 v;
-			ss >> v.x >> v.y >> v.z;
-			mInternalVertices.push_back( v );
-		}
-		else if( tag == "vt" ) { // vertex texture coordinates
-			if( includeTexCoords ) {
-				vec2 tex;
-				ss >> tex.x >> tex.y;
-				mInternalTexCoords.push_back( tex );
+	// replay the group and material changes to find out which range of faces of each chunk belongs to which group
+	struct FaceRange {
+		size_t			mGroup, mChunk, mBegin, mEnd;
+		const Material	*mMaterial;
+	};
+
+	vector<FaceRange> faceRanges;
+	const Material *currentMaterial = nullptr;
+	size_t currentGroupNumFaces = 0;
+	mGroups.push_back( Group() );
+
+	for( size_t c = 0; c < chunks.size(); ++c ) {
+		const ObjChunk &chunk = chunks[c];
+		size_t face = 0;
+		for( const auto &event : chunk.mEvents ) {
+			if( event.mNumFaces > face ) {
+				FaceRange range = { mGroups.size() - 1, c, face, event.mNumFaces, currentMaterial };
+				faceRanges.push_back( range );
+				currentGroupNumFaces += event.mNumFaces - face;
+				face = event.mNumFaces;
 			}
-		}
-		else if( tag == "vn" ) { // vertex normals
-			if ( includeNormals ) {
-				vec3 v;
-				ss >> v.x >> v.y >> v.z;
-				mInternalNormals.push_back( normalize( v ) );
+
+			if( event.mType == ObjChunk::Event::GROUP ) {
+				if( currentGroupNumFaces > 0 ) {
+					mGroups.push_back( Group() );
+					currentGroupNumFaces = 0;
+				}
+
+				Group &group = mGroups.back();
+				group.mBaseVertexOffset = (int32_t)( chunk.mBaseVertex + event.mNumVertices );
+				group.mBaseTexCoordOffset = (int32_t)( chunk.mBaseTexCoord + event.mNumTexCoords );
+				group.mBaseNormalOffset = (int32_t)( chunk.mBaseNormal + event.mNumNormals );
+				group.mName = event.mName;
+			}
+			else {
+				auto m = mMaterials.find( event.mName );
+				if( m != mMaterials.end() )
+					currentMaterial = &m->second;
 			}
 		}
-		else if( tag == "f" ) { // face
-			parseFace( currentGroup, currentMaterial, line, includeNormals, includeTexCoords );
-		}
-		else if( tag == "g" ) { // group
-			if( ! currentGroup->mFaces.empty() )
-				mGroups.push_back( Group() );
-			currentGroup = &mGroups[mGroups.size()-1];
-			currentGroup->mBaseVertexOffset = (int32_t)mInternalVertices.size();
-			currentGroup->mBaseTexCoordOffset = (int32_t)mInternalTexCoords.size();
-			currentGroup->mBaseNormalOffset = (int32_t)mInternalNormals.size();
-			currentGroup->mName = line.substr( line.find( ' ' ) + 1 );
-		}
-        else if( tag == "usemtl") { // material
-            string tag;
-            ss >> tag;
-            std::map<std::string, Material>::const_iterator m = mMaterials.find(tag);
-            if( m != mMaterials.end() ) {
-                currentMaterial = &m->second;
-            }
-        }
+
+		if( chunk.mFaceEnds.size() > face ) {
+			FaceRange range = { mGroups.size() - 1, c, face, chunk.mFaceEnds.size(), currentMaterial };
+			faceRanges.push_back( range );
+			currentGroupNumFaces += chunk.mFaceEnds.size() - face;
+		}
 	}
-}
 
-void ObjLoader::parseFace( Group *group, const Material *material, const std::string &s, bool includeNormals, bool includeTexCoords )
-{
-	ObjLoader::Face result;
-	result.mNumVertices = 0;
-    result.mMaterial = material;
-
-	size_t offset = 2; // account for "f "
-	size_t length = s.length();
-	while( offset < length ) {
-		size_t endOfTriple, firstSlashOffset, secondSlashOffset;
-
-		while( s[offset] == ' ' )
-			++offset;
-
-		// find the end of this triple "v/vt/vn"
-		endOfTriple = s.find( ' ', offset );
-		if( endOfTriple == string::npos ) endOfTriple = length;
-		firstSlashOffset = s.find( '/', offset );
-		if( firstSlashOffset != string::npos ) {
-			secondSlashOffset = s.find( '/', firstSlashOffset + 1 );
-			if( secondSlashOffset > endOfTriple ) secondSlashOffset = string::npos;
-		}
-		else
-			secondSlashOffset = string::npos;
-
-		// process the vertex index
-		int vertexIndex = (firstSlashOffset != string::npos) ?
-            stoi( s.substr( offset, firstSlashOffset - offset ) ) :
-            stoi( s.substr( offset, endOfTriple - offset));
-
-		if( vertexIndex < 0 )
-			result.mVertexIndices.push_back( group->mBaseVertexOffset + vertexIndex );
-		else
-			result.mVertexIndices.push_back( vertexIndex - 1 );
-
-		// process the tex coord index
-		if( includeTexCoords && ( firstSlashOffset != string::npos ) ) {
-			size_t numSize = ( secondSlashOffset == string::npos ) ? ( endOfTriple - firstSlashOffset - 1 ) : secondSlashOffset - firstSlashOffset - 1;
-			if( numSize > 0 ) {
-				int texCoordIndex = stoi( s.substr( firstSlashOffset + 1, numSize ) );
-				if( texCoordIndex < 0 )
-					result.mTexCoordIndices.push_back( group->mBaseTexCoordOffset + texCoordIndex );
-				else
-					result.mTexCoordIndices.push_back( texCoordIndex - 1 );
-				if( group->mFaces.empty() )
-					group->mHasTexCoords = true;
-			}
-			else
-				group->mHasTexCoords = false;
+	// size each group's arrays exactly, allocating tex coord and normal indices only for groups that use them
+	vector<size_t> groupNumFaces( mGroups.size(), 0 ), groupNumIndices( mGroups.size(), 0 );
+	for( const auto &range : faceRanges ) {
+		const ObjChunk &chunk = chunks[range.mChunk];
+		const uint32_t indexBegin = range.mBegin ? chunk.mFaceEnds[range.mBegin - 1] : 0;
+		const uint32_t indexEnd = chunk.mFaceEnds[range.mEnd - 1];
+		auto isPresent = []( int32_t index ) { return index >= 0; };
+
+		Group &group = mGroups[range.mGroup];
+		groupNumFaces[range.mGroup] += range.mEnd - range.mBegin;
+		groupNumIndices[range.mGroup] += indexEnd - indexBegin;
+		if( ! chunk.mTexCoordIndices.empty() && any_of( chunk.mTexCoordIndices.begin() + indexBegin, chunk.mTexCoordIndices.begin() + indexEnd, isPresent ) )
+			group.mHasTexCoords = true;
+		if( ! chunk.mNormalIndices.empty() && any_of( chunk.mNormalIndices.begin() + indexBegin, chunk.mNormalIndices.begin() + indexEnd, isPresent ) )
+			group.mHasNormals = true;
+	}
+
+	for( size_t g = 0; g < mGroups.size(); ++g ) {
+		mGroups[g].mFaces.reserve( groupNumFaces[g] );
+		mGroups[g].mVertexIndices.reserve( groupNumIndices[g] );
+		if( mGroups[g].mHasTexCoords )
+			mGroups[g].mTexCoordIndices.reserve( groupNumIndices[g] );
+		if( mGroups[g].mHasNormals )
+			mGroups[g].mNormalIndices.reserve( groupNumIndices[g] );
+	}
+
+	// copy the faces into their groups, releasing each chunk once all of its faces have been copied
+	size_t chunkIndex = 0;
+	for( const auto &range : faceRanges ) {
+		for( ; chunkIndex < range.mChunk; ++chunkIndex )
+			chunks[chunkIndex].releaseIndices();
+
+		const ObjChunk &chunk = chunks[range.mChunk];
+		Group &group = mGroups[range.mGroup];
+		const uint32_t indexBegin = range.mBegin ? chunk.mFaceEnds[range.mBegin - 1] : 0;
+		const uint32_t indexEnd = chunk.mFaceEnds[range.mEnd - 1];
+
+		uint32_t faceBegin = indexBegin;
+		for( size_t f = range.mBegin; f < range.mEnd; ++f ) {
+			Face face;
+			face.mNumVertices = (int)( chunk.mFaceEnds[f] - faceBegin );
+			face.mFirstIndex = (uint32_t)group.mVertexIndices.size() + faceBegin - indexBegin;
+			face.mMaterial = range.mMaterial;
+			group.mFaces.push_back( face );
+			faceBegin = chunk.mFaceEnds[f];
 		}
-		else if( group->mFaces.empty() ) // if this is the first face, let's note that this group has no tex coords
-			group->mHasTexCoords = false;
 
-		// process the normal index
-		if( includeNormals && ( secondSlashOffset != string::npos ) ) {
-			int normalIndex = stoi( s.substr( secondSlashOffset + 1, endOfTriple - secondSlashOffset - 1 ) );
-			if( normalIndex < 0 )
-				result.mNormalIndices.push_back( group->mBaseNormalOffset + normalIndex );
+		group.mVertexIndices.insert( group.mVertexIndices.end(), chunk.mVertexIndices.begin() + indexBegin, chunk.mVertexIndices.begin() + indexEnd );
+		if( group.mHasTexCoords ) {
+			if( chunk.mTexCoordIndices.empty() )
+				group.mTexCoordIndices.resize( group.mTexCoordIndices.size() + indexEnd - indexBegin, -1 );
 			else
-				result.mNormalIndices.push_back( normalIndex - 1 );
-			group->mHasNormals = true;
+				group.mTexCoordIndices.insert( group.mTexCoordIndices.end(), chunk.mTexCoordIndices.begin() + indexBegin, chunk.mTexCoordIndices.begin() + indexEnd );
+		}
+		if( group.mHasNormals ) {
+			if( chunk.mNormalIndices.empty() )
+				group.mNormalIndices.resize( group.mNormalIndices.size() + indexEnd - indexBegin, -1 );
+			else
+				group.mNormalIndices.insert( group.mNormalIndices.end(), chunk.mNormalIndices.begin() + indexBegin, chunk.mNormalIndices.begin() + indexEnd );
 		}
-		else if( group->mFaces.empty() ) // if this is the first face, let's note that this group has no normals
-			group->mHasNormals = false;
-
-		offset = endOfTriple + 1;
-		result.mNumVertices++;
 	}
-
-	group->mFaces.push_back( result );
 }
 
 void ObjLoader::load() const
@@ -359,272 +830,134 @@ void ObjLoader::load() const
 		}
 	}
 
-	if( normals && texCoords ) {
-		if( hasGroupIndex ) {
-			map<VertexTriple,int> uniqueVerts;
-			loadGroupNormalsTextures( mGroups[mGroupIndex], uniqueVerts );
-		}
-		else {
-			map<VertexTriple,int> uniqueVerts;
-			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
-				loadGroupNormalsTextures( *groupIt, uniqueVerts );
-		}
-	}
-	else if( normals ) {
-		if( hasGroupIndex ) {
-			map<VertexPair,int> uniqueVerts;
-			loadGroupNormals( mGroups[mGroupIndex], uniqueVerts );
-		}
-		else {
-			map<VertexPair,int> uniqueVerts;
-			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
-				loadGroupNormals( *groupIt, uniqueVerts );
-		}
-	}
-	else if( texCoords ) {
-		if( hasGroupIndex ) {
-			map<VertexPair,int> uniqueVerts;
-			loadGroupTextures( mGroups[mGroupIndex], uniqueVerts );
-		}
-		else {
-			map<VertexPair,int> uniqueVerts;
-			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
-				loadGroupTextures( *groupIt, uniqueVerts );
+	// reserve the output, vertices can only be estimated since their number depends on how many are shared
+	size_t numFaceVertices = 0, numTriangleIndices = 0;
+	for( size_t g = 0; g < mGroups.size(); ++g ) {
+		if( hasGroupIndex && g != mGroupIndex )
+			continue;
+		for( const auto &face : mGroups[g].mFaces ) {
+			numFaceVertices += face.mNumVertices;
+			numTriangleIndices += ( face.mNumVertices >= 3 ) ? ( face.mNumVertices - 2 ) * 3 : 0;
 		}
 	}
+
+	const size_t numVerticesEstimate = mOptimizeVertices ? std::min( numFaceVertices, mInternalVertices.size() ) : numFaceVertices;
+	mOutputVertices.reserve( numVerticesEstimate );
+	if( normals )
+		mOutputNormals.reserve( numVerticesEstimate );
+	if( texCoords )
+		mOutputTexCoords.reserve( numVerticesEstimate );
+	if( ! mMaterials.empty() )
+		mOutputColors.reserve( numVerticesEstimate );
+	mOutputIndices.reserve( numTriangleIndices );
+
+	UniqueVertexMap uniqueVerts( mInternalVertices.size() );
+	if( hasGroupIndex )
+		loadGroup( mGroups[mGroupIndex], normals, texCoords, &uniqueVerts );
 	else {
-		if( hasGroupIndex ) {
-			map<int,int> uniqueVerts;
-			loadGroup( mGroups[mGroupIndex], uniqueVerts );
-		}
-		else {
-			map<int,int> uniqueVerts;
-			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
-				loadGroup( *groupIt, uniqueVerts );
-		}
+		for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
+			loadGroup( *groupIt, normals, texCoords, &uniqueVerts );
 	}
 
+	// faces that don't share OBJ indices can still produce identical vertices, those are merged here
+	if( mOptimizeVertices )
+		removeDuplicateOutputVertices();
+
 	mOutputCached = true;
 }
 
-void ObjLoader::loadGroupNormalsTextures( const Group &group, map<VertexTriple,int> &uniqueVerts ) const
+void ObjLoader::removeDuplicateOutputVertices() const
 {
-    bool hasColors = mMaterials.size() > 0;
-	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
-		vec3 inferredNormal;
-		bool forceUnique = ! mOptimizeVertices;
-		Color rgb;
-		if( hasColors ) {
-			const Material *m = group.mFaces[f].mMaterial;
-			if( m ) {
-				rgb.r = m->Kd[0];
-				rgb.g = m->Kd[1];
-				rgb.b = m->Kd[2];
-			}
-			else {
-				rgb.r = 1;
-				rgb.g = 1;
-				rgb.b = 1;
-			}
-		}
-		if( group.mFaces[f].mNormalIndices.empty() ) { // we'll have to derive it from two edges
-			vec3 edge1 = mInternalVertices[group.mFaces[f].mVertexIndices[1]] - mInternalVertices[group.mFaces[f].mVertexIndices[0]];
-			vec3 edge2 = mInternalVertices[group.mFaces[f].mVertexIndices[2]] - mInternalVertices[group.mFaces[f].mVertexIndices[0]];
-			inferredNormal = normalize( cross( edge1, edge2 ) );
-			forceUnique = true;
-		}
+	const size_t numVertices = mOutputVertices.size();
 
-		if( group.mFaces[f].mTexCoordIndices.empty() )
-			forceUnique = true;
+	vector<uint32_t> uniqueVertices;
+	size_t numUnique = geom::calculateWeldMap( numVertices, mOutputVertices.data(), 0, &uniqueVertices, [this, numVertices]( uint32_t a, uint32_t b ) {
+		return ( mOutputNormals.size() < numVertices || mOutputNormals[a] == mOutputNormals[b] )
+			&& ( mOutputTexCoords.size() < numVertices || mOutputTexCoords[a] == mOutputTexCoords[b] )
+			&& ( mOutputColors.size() < numVertices || mOutputColors[a] == mOutputColors[b] );
+	} );
 
-		vector<int> faceIndices;
-		faceIndices.reserve( group.mFaces[f].mNumVertices );
-		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
-			if( ! forceUnique ) {
-				VertexTriple vTriple = make_tuple( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mTexCoordIndices[v], group.mFaces[f].mNormalIndices[v] );
-				pair<map<VertexTriple,int>::iterator,bool> result = uniqueVerts.insert( make_pair( vTriple, mOutputVertices.size() ) );
-				if( result.second ) { // we've got a new, unique vertex here, so let's append it
-					mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
-					mOutputNormals.push_back( mInternalNormals[group.mFaces[f].mNormalIndices[v]] );
-					mOutputTexCoords.push_back( mInternalTexCoords[group.mFaces[f].mTexCoordIndices[v]] );
-					if( hasColors )
-						mOutputColors.push_back( rgb );
-				}
-				// the unique ID of the vertex is appended for this vert
-				faceIndices.push_back( result.first->second );
-			}
-			else { // have to force unique because this group lacks either normals or texCoords
-				faceIndices.push_back( (int32_t)mOutputVertices.size() );
-
-				mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
-				if( ! group.mHasNormals )
-					mOutputNormals.push_back( inferredNormal );
-				else
-					mOutputNormals.push_back( mInternalNormals[group.mFaces[f].mNormalIndices[v]] );
-				if( ! group.mHasTexCoords )
-					mOutputTexCoords.push_back( vec2() );
-				else
-					mOutputTexCoords.push_back( mInternalTexCoords[group.mFaces[f].mTexCoordIndices[v]] );
-                if( hasColors )
-                    mOutputColors.push_back( rgb );
-			}
-		}
+	if( numUnique == numVertices )
+		return;
 
-		int32_t triangles = (int32_t)faceIndices.size() - 2;
-		for( int t = 0; t < triangles; ++t ) {
-			mOutputIndices.push_back( faceIndices[0] ); mOutputIndices.push_back( faceIndices[t + 1] ); mOutputIndices.push_back( faceIndices[t + 2] );
-		}
-	}
+	vector<uint32_t> newIndices( numVertices );
+	uint32_t nextIndex = 0;
+	for( size_t i = 0; i < numVertices; ++i )
+		newIndices[i] = ( uniqueVertices[i] == i ) ? nextIndex++ : newIndices[uniqueVertices[i]];
+
+	for( auto &index : mOutputIndices )
+		index = newIndices[index];
+
+	compactVertices( mOutputVertices, uniqueVertices );
+	compactVertices( mOutputNormals, uniqueVertices );
+	compactVertices( mOutputTexCoords, uniqueVertices );
+	compactVertices( mOutputColors, uniqueVertices );
 }
 
-void ObjLoader::loadGroupNormals( const Group &group, map<VertexPair,int> &uniqueVerts ) const
+void ObjLoader::loadGroup( const Group &group, bool normals, bool texCoords, UniqueVertexMap *uniqueVerts ) const
 {
-    bool hasColors = mMaterials.size() > 0;
-	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
-        Color rgb;
-        if( hasColors ) {
-			const Material *m = group.mFaces[f].mMaterial;
-			if( m ) {
-				rgb.r = m->Kd[0];
-				rgb.g = m->Kd[1];
-				rgb.b = m->Kd[2];
-			}
-			else {
-				rgb.r = 1;
-				rgb.g = 1;
-				rgb.b = 1;
-			}
-        }
-		vec3 inferredNormal;
-		bool forceUnique = ! mOptimizeVertices;
-		if( group.mFaces[f].mNormalIndices.empty() ) { // we'll have to derive it from two edges
-			vec3 edge1 = mInternalVertices[group.mFaces[f].mVertexIndices[1]] - mInternalVertices[group.mFaces[f].mVertexIndices[0]];
-			vec3 edge2 = mInternalVertices[group.mFaces[f].mVertexIndices[2]] - mInternalVertices[group.mFaces[f].mVertexIndices[0]];
-			inferredNormal = normalize( cross( edge1, edge2 ) );
-			forceUnique = true;
+	const bool hasColors = ! mMaterials.empty();
+	const int32_t numPositions = (int32_t)mInternalVertices.size();
+	const int32_t numTexCoords = (int32_t)mInternalTexCoords.size();
+	const int32_t numNormals = (int32_t)mInternalNormals.size();
+
+	vector<uint32_t> faceIndices;
+	for( const auto &face : group.mFaces ) {
+		if( face.mNumVertices < 3 )
+			continue;
+
+		const int32_t *vertexIndices = &group.mVertexIndices[face.mFirstIndex];
+		const int32_t *texCoordIndices = ( texCoords && group.mHasTexCoords ) ? &group.mTexCoordIndices[face.mFirstIndex] : nullptr;
+		const int32_t *normalIndices = ( normals && group.mHasNormals ) ? &group.mNormalIndices[face.mFirstIndex] : nullptr;
+
+		// faces that refer to positions outside of the file are skipped, and tex coords or normals are only used if the whole face has them
+		bool validPositions = true, faceHasTexCoords = ( texCoordIndices != nullptr ), faceHasNormals = ( normalIndices != nullptr );
+		for( int v = 0; v < face.mNumVertices; ++v ) {
+			validPositions = validPositions && vertexIndices[v] >= 0 && vertexIndices[v] < numPositions;
+			faceHasTexCoords = faceHasTexCoords && texCoordIndices[v] >= 0 && texCoordIndices[v] < numTexCoords;
+			faceHasNormals = faceHasNormals && normalIndices[v] >= 0 && normalIndices[v] < numNormals;
 		}
+		if( ! validPositions )
+			continue;
 
-		vector<int> faceIndices;
-		faceIndices.reserve( group.mFaces[f].mNumVertices );
-		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
-			if( ! forceUnique ) {
-				VertexPair vPair = make_tuple( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mNormalIndices[v] );
-				pair<map<VertexPair,int>::iterator,bool> result = uniqueVerts.insert( make_pair( vPair, mOutputVertices.size() ) );
-				if( result.second ) { // we've got a new, unique vertex here, so let's append it
-					mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
-					mOutputNormals.push_back( mInternalNormals[group.mFaces[f].mNormalIndices[v]] );
-                    if( hasColors )
-                        mOutputColors.push_back( rgb );
-				}
-				// the unique ID of the vertex is appended for this vert
-				faceIndices.push_back( result.first->second );
-			}
-			else { // have to force unique because this group lacks normals
-				faceIndices.push_back( (int32_t)mOutputVertices.size() );
-
-				mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
-				if( ! group.mHasNormals )
-					mOutputNormals.push_back( inferredNormal );
-				else
-					mOutputNormals.push_back( mInternalNormals[group.mFaces[f].mNormalIndices[v]] );
-                if( hasColors )
-                    mOutputColors.push_back( rgb );
-			}
-		}
+		Colorf rgb( 1, 1, 1 );
+		if( hasColors && face.mMaterial )
+			rgb = Colorf( face.mMaterial->Kd[0], face.mMaterial->Kd[1], face.mMaterial->Kd[2] );
 
-		int32_t triangles = (int32_t)faceIndices.size() - 2;
-		for( int t = 0; t < triangles; ++t ) {
-			mOutputIndices.push_back( faceIndices[0] ); mOutputIndices.push_back( faceIndices[t + 1] ); mOutputIndices.push_back( faceIndices[t + 2] );
+		vec3 inferredNormal;
+		if( normals && ! faceHasNormals ) { // we'll have to derive it from two edges
+			vec3 edge1 = mInternalVertices[vertexIndices[1]] - mInternalVertices[vertexIndices[0]];
+			vec3 edge2 = mInternalVertices[vertexIndices[2]] - mInternalVertices[vertexIndices[0]];
+			inferredNormal = normalize( cross( edge1, edge2 ) );
 		}
-	}
-}
 
-void ObjLoader::loadGroupTextures( const Group &group, map<VertexPair,int> &uniqueVerts ) const
-{
-    bool hasColors = mMaterials.size() > 0;
-	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
-        Color rgb;
-        if( hasColors ) {
-			const Material *m = group.mFaces[f].mMaterial;
-			if( m ) {
-				rgb.r = m->Kd[0];
-				rgb.g = m->Kd[1];
-				rgb.b = m->Kd[2];
-			}
-			else {
-				rgb.r = 1;
-				rgb.g = 1;
-				rgb.b = 1;
-			}
-		}
-		bool forceUnique = ! mOptimizeVertices;
-		if( group.mFaces[f].mTexCoordIndices.empty() )
-			forceUnique = true;
+		// vertices that use an inferred normal or a default tex coord are never shared, neither is anything unless optimizing
+		// (faces with positions only are always shared)
+		bool forceUnique = ( normals || texCoords ) && ( ! mOptimizeVertices || ( normals && ! faceHasNormals ) || ( texCoords && ! faceHasTexCoords ) );
+
+		faceIndices.clear();
+		for( int v = 0; v < face.mNumVertices; ++v ) {
+			const int32_t texCoordIndex = faceHasTexCoords ? texCoordIndices[v] : -1;
+			const int32_t normalIndex = faceHasNormals ? normalIndices[v] : -1;
+			const uint32_t outputIndex = (uint32_t)mOutputVertices.size();
 
-		vector<int32_t> faceIndices;
-		faceIndices.reserve( group.mFaces[f].mNumVertices );
-		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
 			if( ! forceUnique ) {
-				VertexPair vPair = make_tuple( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mTexCoordIndices[v] );
-				pair<map<VertexPair,int>::iterator,bool> result = uniqueVerts.insert( make_pair( vPair, mOutputVertices.size() ) );
-				if( result.second ) { // we've got a new, unique vertex here, so let's append it
-					mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
-					mOutputTexCoords.push_back( mInternalTexCoords[group.mFaces[f].mTexCoordIndices[v]] );
-                    if( hasColors )
-                        mOutputColors.push_back( rgb );
+				uint32_t existingIndex = uniqueVerts->insert( vertexIndices[v], texCoordIndex, normalIndex, outputIndex );
+				if( existingIndex != outputIndex ) {
+					faceIndices.push_back( existingIndex );
+					continue;
 				}
-				// the unique ID of the vertex is appended for this vert
-				faceIndices.push_back( result.first->second );
-			}
-			else { // have to force unique because this group lacks texCoords
-				faceIndices.push_back( (int32_t)mOutputVertices.size() );
-
-				mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
-				if( ! group.mHasTexCoords )
-					mOutputTexCoords.push_back( vec2() );
-				else
-					mOutputTexCoords.push_back( mInternalTexCoords[group.mFaces[f].mTexCoordIndices[v]] );
-                if( hasColors )
-                    mOutputColors.push_back( rgb );
 			}
-		}
 
-		int32_t triangles = (int32_t)faceIndices.size() - 2;
-		for( int t = 0; t < triangles; ++t ) {
-			mOutputIndices.push_back( faceIndices[0] ); mOutputIndices.push_back( faceIndices[t + 1] ); mOutputIndices.push_back( faceIndices[t + 2] );
-		}
-	}
-}
-
-void ObjLoader::loadGroup( const Group &group, map<int,int> &uniqueVerts ) const
-{
-    bool hasColors = mMaterials.size() > 0;
-	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
-        Color rgb;
-        if( hasColors ) {
-			const Material *m = group.mFaces[f].mMaterial;
-            if( m ) {
-                rgb.r = m->Kd[0];
-                rgb.g = m->Kd[1];
-                rgb.b = m->Kd[2];
-            }
-            else {
-                rgb.r = 1;
-                rgb.g = 1;
-                rgb.b = 1;
-            }
-        }
-		vector<int> faceIndices;
-		faceIndices.reserve( group.mFaces[f].mNumVertices );
-		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
-			pair<map<int,int>::iterator,bool> result = uniqueVerts.insert( make_pair( group.mFaces[f].mVertexIndices[v], mOutputVertices.size() ) );
-			if( result.second ) { // we've got a new, unique vertex here, so let's append it
-				mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
-                if( hasColors )
-                    mOutputColors.push_back( rgb );
-			}
-			// the unique ID of the vertex is appended for this vert
-			faceIndices.push_back( result.first->second );
+			// we've got a new, unique vertex here, so let's append it
+			faceIndices.push_back( outputIndex );
+			mOutputVertices.push_back( mInternalVertices[vertexIndices[v]] );
+			if( normals )
+				mOutputNormals.push_back( faceHasNormals ? mInternalNormals[normalIndex] : inferredNormal );
+			if( texCoords )
+				mOutputTexCoords.push_back( faceHasTexCoords ? mInternalTexCoords[texCoordIndex] : vec2() );
+			if( hasColors )
+				mOutputColors.push_back( rgb );
 		}
 
 		int32_t triangles = (int32_t)faceIndices.size() - 2;
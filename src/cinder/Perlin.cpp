@@ -28,12 +28,272 @@
 #include "cinder/CinderMath.h"
 #include "cinder/Rand.h"
 
+#include <thread>
+#include <vector>
+
+// The batches only match the single point functions exactly when those use SSE arithmetic too
+#if defined( __SSE2_MATH__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+	#define CINDER_PERLIN_SSE
+	#include <emmintrin.h>
+#endif
+
+// Batches are split across threads for at least this many points per thread
+#define PERLIN_MIN_PARALLEL_POINTS	16384
+// Points with a coordinate of this magnitude in their last octave overflow the SSE integer conversion, so they are evaluated one at a time
+#define PERLIN_MAX_SSE_COORDINATE	1073741824.0f
+
 namespace cinder {
 
 static inline float fade( float t ) { return t * t * t * (t * (t * 6 - 15) + 10); }
 static inline float dfade( float t ) { return 30.0f * t * t * ( t * ( t - 2.0f ) + 1.0f ); }
 inline float nlerp(float t, float a, float b) { return a + t * (b - a); }
 
+namespace {
+
+// Calls fn( begin, end ) for ranges covering [0, count), spread across threads if \a parallel and there are enough of the \a pointsPerItem points.
+template<typename Fn>
+void parallelFor( size_t count, size_t pointsPerItem, bool parallel, const Fn &fn )
+{
+	const size_t numThreads = parallel ? std::min<size_t>( std::thread::hardware_concurrency(), count * pointsPerItem / PERLIN_MIN_PARALLEL_POINTS ) : 1;
+	if( numThreads <= 1 ) {
+		fn( 0, count );
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	for( size_t t = 1; t < numThreads; ++t )
+		threads.push_back( std::thread( fn, count * t / numThreads, count * ( t + 1 ) / numThreads ) );
+	fn( 0, count / numThreads );
+	for( auto &t : threads )
+		t.join();
+}
+
+#if defined( CINDER_PERLIN_SSE )
+
+// The functions below evaluate four points at once, performing exactly the same float operations as their scalar counterparts. Only the permutation
+// table lookups are done per lane.
+
+inline __m128 select4( __m128 mask, __m128 a, __m128 b )
+{
+	return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+}
+
+// Returns floorf( x ), and its integer value in \a floorInt
+inline __m128 floor4( __m128 x, __m128i *floorInt )
+{
+	const __m128i truncated = _mm_cvttps_epi32( x );
+	const __m128 truncatedFloat = _mm_cvtepi32_ps( truncated );
+	// truncation rounds negative values up, where the mask is -1
+	const __m128 roundedUp = _mm_cmpgt_ps( truncatedFloat, x );
+	*floorInt = _mm_add_epi32( truncated, _mm_castps_si128( roundedUp ) );
+	return _mm_sub_ps( truncatedFloat, _mm_and_ps( roundedUp, _mm_set1_ps( 1.0f ) ) );
+}
+
+inline __m128 fade4( __m128 t )
+{
+	const __m128 t3 = _mm_mul_ps( _mm_mul_ps( t, t ), t );
+	return _mm_mul_ps( t3, _mm_add_ps( _mm_mul_ps( t, _mm_sub_ps( _mm_mul_ps( t, _mm_set1_ps( 6 ) ), _mm_set1_ps( 15 ) ) ), _mm_set1_ps( 10 ) ) );
+}
+
+inline __m128 dfade4( __m128 t )
+{
+	const __m128 t2 = _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( 30.0f ), t ), t );
+	const __m128 d = _mm_mul_ps( t2, _mm_add_ps( _mm_mul_ps( t, _mm_sub_ps( t, _mm_set1_ps( 2.0f ) ) ), _mm_set1_ps( 1.0f ) ) );
+	// matches the clamping of the derivatives in Perlin::dnoise()
+	return select4( _mm_cmplt_ps( d, _mm_set1_ps( 0.000001f ) ), _mm_set1_ps( 1.0f ), d );
+}
+
+inline __m128 nlerp4( __m128 t, __m128 a, __m128 b )
+{
+	return _mm_add_ps( a, _mm_mul_ps( t, _mm_sub_ps( b, a ) ) );
+}
+
+// The 2D gradients are those of 3D with a z of 0
+inline __m128 grad4( const int32_t hash[4], __m128 x, __m128 y, __m128 z )
+{
+	const __m128i h = _mm_and_si128( _mm_loadu_si128( reinterpret_cast<const __m128i*>( hash ) ), _mm_set1_epi32( 15 ) );
+	const __m128 u = select4( _mm_castsi128_ps( _mm_cmplt_epi32( h, _mm_set1_epi32( 8 ) ) ), x, y );
+	const __m128 h12or14 = _mm_castsi128_ps( _mm_or_si128( _mm_cmpeq_epi32( h, _mm_set1_epi32( 12 ) ), _mm_cmpeq_epi32( h, _mm_set1_epi32( 14 ) ) ) );
+	const __m128 v = select4( _mm_castsi128_ps( _mm_cmplt_epi32( h, _mm_set1_epi32( 4 ) ) ), y, select4( h12or14, x, z ) );
+	// negating flips the sign bit
+	const __m128 signU = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( h, _mm_set1_epi32( 1 ) ), 31 ) );
+	const __m128 signV = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( h, _mm_set1_epi32( 2 ) ), 30 ) );
+	return _mm_add_ps( _mm_xor_ps( u, signU ), _mm_xor_ps( v, signV ) );
+}
+
+// Computes the gradient hashes of the four corners of the cells of \a cellX, \a cellY, in the order of Perlin::noise( float, float )
+inline void hashes4( const uint8_t *perms, __m128i cellX, __m128i cellY, int32_t hashes[4][4] )
+{
+	int32_t X[4], Y[4];
+	_mm_storeu_si128( reinterpret_cast<__m128i*>( X ), _mm_and_si128( cellX, _mm_set1_epi32( 255 ) ) );
+	_mm_storeu_si128( reinterpret_cast<__m128i*>( Y ), _mm_and_si128( cellY, _mm_set1_epi32( 255 ) ) );
+	for( int l = 0; l < 4; ++l ) {
+		const int32_t A = perms[X[l]] + Y[l], B = perms[X[l] + 1] + Y[l];
+		hashes[0][l] = perms[perms[A]];
+		hashes[1][l] = perms[perms[B]];
+		hashes[2][l] = perms[perms[A + 1]];
+		hashes[3][l] = perms[perms[B + 1]];
+	}
+}
+
+// Computes the gradient hashes of the eight corners of the cells of \a cellX, \a cellY, \a cellZ, in the order of Perlin::noise( float, float, float )
+inline void hashes4( const uint8_t *perms, __m128i cellX, __m128i cellY, __m128i cellZ, int32_t hashes[8][4] )
+{
+	int32_t X[4], Y[4], Z[4];
+	_mm_storeu_si128( reinterpret_cast<__m128i*>( X ), _mm_and_si128( cellX, _mm_set1_epi32( 255 ) ) );
+	_mm_storeu_si128( reinterpret_cast<__m128i*>( Y ), _mm_and_si128( cellY, _mm_set1_epi32( 255 ) ) );
+	_mm_storeu_si128( reinterpret_cast<__m128i*>( Z ), _mm_and_si128( cellZ, _mm_set1_epi32( 255 ) ) );
+	for( int l = 0; l < 4; ++l ) {
+		const int32_t A = perms[X[l]] + Y[l], AA = perms[A] + Z[l], AB = perms[A + 1] + Z[l],
+			B = perms[X[l] + 1] + Y[l], BA = perms[B] + Z[l], BB = perms[B + 1] + Z[l];
+		hashes[0][l] = perms[AA];
+		hashes[1][l] = perms[BA];
+		hashes[2][l] = perms[AB];
+		hashes[3][l] = perms[BB];
+		hashes[4][l] = perms[AA + 1];
+		hashes[5][l] = perms[BA + 1];
+		hashes[6][l] = perms[AB + 1];
+		hashes[7][l] = perms[BB + 1];
+	}
+}
+
+__m128 noise4( const uint8_t *perms, __m128 x, __m128 y )
+{
+	__m128i cellX, cellY;
+	x = _mm_sub_ps( x, floor4( x, &cellX ) );
+	y = _mm_sub_ps( y, floor4( y, &cellY ) );
+	int32_t hashes[4][4];
+	hashes4( perms, cellX, cellY, hashes );
+
+	const __m128 one = _mm_set1_ps( 1.0f ), zero = _mm_setzero_ps();
+	const __m128 u = fade4( x ), v = fade4( y );
+	const __m128 x1 = _mm_sub_ps( x, one ), y1 = _mm_sub_ps( y, one );
+	return nlerp4( v, nlerp4( u, grad4( hashes[0], x, y, zero ), grad4( hashes[1], x1, y, zero ) ),
+					nlerp4( u, grad4( hashes[2], x, y1, zero ), grad4( hashes[3], x1, y1, zero ) ) );
+}
+
+__m128 noise4( const uint8_t *perms, __m128 x, __m128 y, __m128 z )
+{
+	__m128i cellX, cellY, cellZ;
+	x = _mm_sub_ps( x, floor4( x, &cellX ) );
+	y = _mm_sub_ps( y, floor4( y, &cellY ) );
+	z = _mm_sub_ps( z, floor4( z, &cellZ ) );
+	int32_t hashes[8][4];
+	hashes4( perms, cellX, cellY, cellZ, hashes );
+
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 u = fade4( x ), v = fade4( y ), w = fade4( z );
+	const __m128 x1 = _mm_sub_ps( x, one ), y1 = _mm_sub_ps( y, one ), z1 = _mm_sub_ps( z, one );
+	const __m128 a = grad4( hashes[0], x, y, z );
+	const __m128 b = grad4( hashes[1], x1, y, z );
+	const __m128 c = grad4( hashes[2], x, y1, z );
+	const __m128 d = grad4( hashes[3], x1, y1, z );
+	const __m128 e = grad4( hashes[4], x, y, z1 );
+	const __m128 f = grad4( hashes[5], x1, y, z1 );
+	const __m128 g = grad4( hashes[6], x, y1, z1 );
+	const __m128 h = grad4( hashes[7], x1, y1, z1 );
+	return nlerp4( w, nlerp4( v, nlerp4( u, a, b ), nlerp4( u, c, d ) ),
+					nlerp4( v, nlerp4( u, e, f ), nlerp4( u, g, h ) ) );
+}
+
+void dnoise4( const uint8_t *perms, __m128 x, __m128 y, __m128 *dx, __m128 *dy )
+{
+	// Perlin::dnoise( float, float ) truncates rather than floors to find the cell, which is kept for identical results
+	const __m128i cellX = _mm_cvttps_epi32( x ), cellY = _mm_cvttps_epi32( y );
+	__m128i unused;
+	x = _mm_sub_ps( x, floor4( x, &unused ) );
+	y = _mm_sub_ps( y, floor4( y, &unused ) );
+	int32_t hashes[4][4];
+	hashes4( perms, cellX, cellY, hashes );
+
+	const __m128 one = _mm_set1_ps( 1.0f ), zero = _mm_setzero_ps();
+	const __m128 u = fade4( x ), v = fade4( y );
+	const __m128 du = dfade4( x ), dv = dfade4( y );
+	const __m128 x1 = _mm_sub_ps( x, one ), y1 = _mm_sub_ps( y, one );
+	const __m128 a = grad4( hashes[0], x, y, zero );
+	const __m128 b = grad4( hashes[1], x1, y, zero );
+	const __m128 c = grad4( hashes[2], x, y1, zero );
+	const __m128 d = grad4( hashes[3], x1, y1, zero );
+
+	const __m128 k1 = _mm_sub_ps( b, a );
+	const __m128 k2 = _mm_sub_ps( c, a );
+	const __m128 k4 = _mm_add_ps( _mm_sub_ps( _mm_sub_ps( a, b ), c ), d );
+	*dx = _mm_mul_ps( du, _mm_add_ps( k1, _mm_mul_ps( k4, v ) ) );
+	*dy = _mm_mul_ps( dv, _mm_add_ps( k2, _mm_mul_ps( k4, u ) ) );
+}
+
+void dnoise4( const uint8_t *perms, __m128 x, __m128 y, __m128 z, __m128 *dx, __m128 *dy, __m128 *dz )
+{
+	__m128i cellX, cellY, cellZ;
+	x = _mm_sub_ps( x, floor4( x, &cellX ) );
+	y = _mm_sub_ps( y, floor4( y, &cellY ) );
+	z = _mm_sub_ps( z, floor4( z, &cellZ ) );
+	int32_t hashes[8][4];
+	hashes4( perms, cellX, cellY, cellZ, hashes );
+
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 u = fade4( x ), v = fade4( y ), w = fade4( z );
+	const __m128 du = dfade4( x ), dv = dfade4( y ), dw = dfade4( z );
+	const __m128 x1 = _mm_sub_ps( x, one ), y1 = _mm_sub_ps( y, one ), z1 = _mm_sub_ps( z, one );
+	const __m128 a = grad4( hashes[0], x, y, z );
+	const __m128 b = grad4( hashes[1], x1, y, z );
+	const __m128 c = grad4( hashes[2], x, y1, z );
+	const __m128 d = grad4( hashes[3], x1, y1, z );
+	const __m128 e = grad4( hashes[4], x, y, z1 );
+	const __m128 f = grad4( hashes[5], x1, y, z1 );
+	const __m128 g = grad4( hashes[6], x, y1, z1 );
+	const __m128 h = grad4( hashes[7], x1, y1, z1 );
+
+	const __m128 k1 = _mm_sub_ps( b, a );
+	const __m128 k2 = _mm_sub_ps( c, a );
+	const __m128 k3 = _mm_sub_ps( e, a );
+	const __m128 k4 = _mm_add_ps( _mm_sub_ps( _mm_sub_ps( a, b ), c ), d );
+	const __m128 k5 = _mm_add_ps( _mm_sub_ps( _mm_sub_ps( a, c ), e ), g );
+	const __m128 k6 = _mm_add_ps( _mm_sub_ps( _mm_sub_ps( a, b ), e ), f );
+	const __m128 k7 = _mm_add_ps( _mm_sub_ps( _mm_sub_ps( _mm_add_ps( _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_sub_ps( _mm_setzero_ps(), a ), b ), c ), d ), e ), f ), g ), h );
+	*dx = _mm_mul_ps( du, _mm_add_ps( _mm_add_ps( _mm_add_ps( k1, _mm_mul_ps( k4, v ) ), _mm_mul_ps( k6, w ) ), _mm_mul_ps( _mm_mul_ps( k7, v ), w ) ) );
+	*dy = _mm_mul_ps( dv, _mm_add_ps( _mm_add_ps( _mm_add_ps( k2, _mm_mul_ps( k5, w ) ), _mm_mul_ps( k4, u ) ), _mm_mul_ps( _mm_mul_ps( k7, w ), u ) ) );
+	*dz = _mm_mul_ps( dw, _mm_add_ps( _mm_add_ps( _mm_add_ps( k3, _mm_mul_ps( k6, u ) ), _mm_mul_ps( k5, v ) ), _mm_mul_ps( _mm_mul_ps( k7, u ), v ) ) );
+}
+
+// Returns whether every lane of \a x stays within range of the integer conversion over \a numOctaves
+inline bool isInRange4( __m128 x, uint8_t numOctaves )
+{
+	const float limit = PERLIN_MAX_SSE_COORDINATE / (float)( 1u << std::min<uint8_t>( numOctaves, 30 ) );
+	const __m128 absX = _mm_andnot_ps( _mm_set1_ps( -0.0f ), x );
+	return _mm_movemask_ps( _mm_cmpge_ps( absX, _mm_set1_ps( limit ) ) ) == 0;
+}
+
+__m128 fBm4( const uint8_t *perms, uint8_t numOctaves, __m128 x, __m128 y )
+{
+	__m128 result = _mm_setzero_ps();
+	float amp = 0.5f;
+	const __m128 two = _mm_set1_ps( 2.0f );
+	for( uint8_t i = 0; i < numOctaves; i++ ) {
+		result = _mm_add_ps( result, _mm_mul_ps( noise4( perms, x, y ), _mm_set1_ps( amp ) ) );
+		x = _mm_mul_ps( x, two ); y = _mm_mul_ps( y, two );
+		amp *= 0.5f;
+	}
+	return result;
+}
+
+__m128 fBm4( const uint8_t *perms, uint8_t numOctaves, __m128 x, __m128 y, __m128 z )
+{
+	__m128 result = _mm_setzero_ps();
+	float amp = 0.5f;
+	const __m128 two = _mm_set1_ps( 2.0f );
+	for( uint8_t i = 0; i < numOctaves; i++ ) {
+		result = _mm_add_ps( result, _mm_mul_ps( noise4( perms, x, y, z ), _mm_set1_ps( amp ) ) );
+		x = _mm_mul_ps( x, two ); y = _mm_mul_ps( y, two ); z = _mm_mul_ps( z, two );
+		amp *= 0.5f;
+	}
+	return result;
+}
+
+#endif // defined( CINDER_PERLIN_SSE )
+
+} // anonymous namespace
+
 Perlin::Perlin( uint8_t aOctaves, int32_t aSeed )
 	: mOctaves( aOctaves ), mSeed( aSeed ){
 	initPermutationTable();
@@ -153,6 +413,214 @@ vec3 Perlin::dfBm( const vec3 &v ) const
 	return result;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// batches
+void Perlin::fBm( const vec2 *positions, size_t count, float *result, bool parallel ) const
+{
+	parallelFor( count, 1, parallel, [&]( size_t begin, size_t end ) {
+		size_t i = begin;
+#if defined( CINDER_PERLIN_SSE )
+		for( ; i + 4 <= end; i += 4 ) {
+			const vec2 *p = positions + i;
+			const __m128 x = _mm_setr_ps( p[0].x, p[1].x, p[2].x, p[3].x ), y = _mm_setr_ps( p[0].y, p[1].y, p[2].y, p[3].y );
+			if( isInRange4( x, mOctaves ) && isInRange4( y, mOctaves ) )
+				_mm_storeu_ps( result + i, fBm4( mPerms, mOctaves, x, y ) );
+			else {
+				for( size_t j = i; j < i + 4; ++j )
+					result[j] = fBm( positions[j] );
+			}
+		}
+#endif
+		for( ; i < end; ++i )
+			result[i] = fBm( positions[i] );
+	} );
+}
+
+void Perlin::fBm( const vec3 *positions, size_t count, float *result, bool parallel ) const
+{
+	parallelFor( count, 1, parallel, [&]( size_t begin, size_t end ) {
+		size_t i = begin;
+#if defined( CINDER_PERLIN_SSE )
+		for( ; i + 4 <= end; i += 4 ) {
+			const vec3 *p = positions + i;
+			const __m128 x = _mm_setr_ps( p[0].x, p[1].x, p[2].x, p[3].x ), y = _mm_setr_ps( p[0].y, p[1].y, p[2].y, p[3].y ), z = _mm_setr_ps( p[0].z, p[1].z, p[2].z, p[3].z );
+			if( isInRange4( x, mOctaves ) && isInRange4( y, mOctaves ) && isInRange4( z, mOctaves ) )
+				_mm_storeu_ps( result + i, fBm4( mPerms, mOctaves, x, y, z ) );
+			else {
+				for( size_t j = i; j < i + 4; ++j )
+					result[j] = fBm( positions[j] );
+			}
+		}
+#endif
+		for( ; i < end; ++i )
+			result[i] = fBm( positions[i] );
+	} );
+}
+
+void Perlin::dfBm( const vec2 *positions, size_t count, vec2 *result, bool parallel ) const
+{
+	parallelFor( count, 1, parallel, [&]( size_t begin, size_t end ) {
+		size_t i = begin;
+#if defined( CINDER_PERLIN_SSE )
+		const __m128 two = _mm_set1_ps( 2.0f );
+		for( ; i + 4 <= end; i += 4 ) {
+			const vec2 *p = positions + i;
+			__m128 x = _mm_setr_ps( p[0].x, p[1].x, p[2].x, p[3].x ), y = _mm_setr_ps( p[0].y, p[1].y, p[2].y, p[3].y );
+			if( ! isInRange4( x, mOctaves ) || ! isInRange4( y, mOctaves ) ) {
+				for( size_t j = i; j < i + 4; ++j )
+					result[j] = dfBm( positions[j] );
+				continue;
+			}
+
+			__m128 resultX = _mm_setzero_ps(), resultY = _mm_setzero_ps();
+			float amp = 0.5f;
+			for( uint8_t o = 0; o < mOctaves; o++ ) {
+				__m128 dx, dy;
+				dnoise4( mPerms, x, y, &dx, &dy );
+				const __m128 amp4 = _mm_set1_ps( amp );
+				resultX = _mm_add_ps( resultX, _mm_mul_ps( dx, amp4 ) );
+				resultY = _mm_add_ps( resultY, _mm_mul_ps( dy, amp4 ) );
+				x = _mm_mul_ps( x, two ); y = _mm_mul_ps( y, two );
+				amp *= 0.5f;
+			}
+			float rx[4], ry[4];
+			_mm_storeu_ps( rx, resultX );
+			_mm_storeu_ps( ry, resultY );
+			for( int l = 0; l < 4; ++l )
+				result[i + l] = vec2( rx[l], ry[l] );
+		}
+#endif
+		for( ; i < end; ++i )
+			result[i] = dfBm( positions[i] );
+	} );
+}
+
+void Perlin::dfBm( const vec3 *positions, size_t count, vec3 *result, bool parallel ) const
+{
+	parallelFor( count, 1, parallel, [&]( size_t begin, size_t end ) {
+		size_t i = begin;
+#if defined( CINDER_PERLIN_SSE )
+		const __m128 two = _mm_set1_ps( 2.0f );
+		for( ; i + 4 <= end; i += 4 ) {
+			const vec3 *p = positions + i;
+			__m128 x = _mm_setr_ps( p[0].x, p[1].x, p[2].x, p[3].x ), y = _mm_setr_ps( p[0].y, p[1].y, p[2].y, p[3].y ), z = _mm_setr_ps( p[0].z, p[1].z, p[2].z, p[3].z );
+			if( ! isInRange4( x, mOctaves ) || ! isInRange4( y, mOctaves ) || ! isInRange4( z, mOctaves ) ) {
+				for( size_t j = i; j < i + 4; ++j )
+					result[j] = dfBm( positions[j] );
+				continue;
+			}
+
+			__m128 resultX = _mm_setzero_ps(), resultY = _mm_setzero_ps(), resultZ = _mm_setzero_ps();
+			float amp = 0.5f;
+			for( uint8_t o = 0; o < mOctaves; o++ ) {
+				__m128 dx, dy, dz;
+				dnoise4( mPerms, x, y, z, &dx, &dy, &dz );
+				const __m128 amp4 = _mm_set1_ps( amp );
+				resultX = _mm_add_ps( resultX, _mm_mul_ps( dx, amp4 ) );
+				resultY = _mm_add_ps( resultY, _mm_mul_ps( dy, amp4 ) );
+				resultZ = _mm_add_ps( resultZ, _mm_mul_ps( dz, amp4 ) );
+				x = _mm_mul_ps( x, two ); y = _mm_mul_ps( y, two ); z = _mm_mul_ps( z, two );
+				amp *= 0.5f;
+			}
+			float rx[4], ry[4], rz[4];
+			_mm_storeu_ps( rx, resultX );
+			_mm_storeu_ps( ry, resultY );
+			_mm_storeu_ps( rz, resultZ );
+			for( int l = 0; l < 4; ++l )
+				result[i + l] = vec3( rx[l], ry[l], rz[l] );
+		}
+#endif
+		for( ; i < end; ++i )
+			result[i] = dfBm( positions[i] );
+	} );
+}
+
+void Perlin::fBm( const ivec2 &size, const vec2 &origin, const vec2 &step, float *result, bool parallel ) const
+{
+	if( size.x <= 0 || size.y <= 0 )
+		return;
+
+	parallelFor( size.y, size.x, parallel, [&]( size_t begin, size_t end ) {
+		for( size_t j = begin; j < end; ++j )
+			fBmRow( vec2( origin.x, origin.y + step.y * (float)j ), step.x, size.x, result + j * size.x );
+	} );
+}
+
+void Perlin::fBm( const ivec3 &size, const vec3 &origin, const vec3 &step, float *result, bool parallel ) const
+{
+	if( size.x <= 0 || size.y <= 0 || size.z <= 0 )
+		return;
+
+	parallelFor( (size_t)size.y * size.z, size.x, parallel, [&]( size_t begin, size_t end ) {
+		for( size_t row = begin; row < end; ++row ) {
+			const size_t j = row % size.y, k = row / size.y;
+			fBmRow( vec3( origin.x, origin.y + step.y * (float)j, origin.z + step.z * (float)k ), step.x, size.x, result + row * size.x );
+		}
+	} );
+}
+
+void Perlin::fBm( Channel32f *channel, const vec2 &origin, const vec2 &step, bool parallel ) const
+{
+	const int32_t width = channel->getWidth();
+	const uint8_t increment = channel->getIncrement();
+	parallelFor( channel->getHeight(), width, parallel, [&]( size_t begin, size_t end ) {
+		std::vector<float> row( ( increment != 1 ) ? width : 0 );
+		for( size_t j = begin; j < end; ++j ) {
+			float *data = channel->getData( 0, (int32_t)j );
+			const vec2 start( origin.x, origin.y + step.y * (float)j );
+			if( increment == 1 )
+				fBmRow( start, step.x, width, data );
+			else {
+				fBmRow( start, step.x, width, row.data() );
+				for( int32_t i = 0; i < width; ++i )
+					data[i * increment] = row[i];
+			}
+		}
+	} );
+}
+
+void Perlin::fBmRow( const vec2 &start, float stepX, size_t count, float *result ) const
+{
+	size_t i = 0;
+#if defined( CINDER_PERLIN_SSE )
+	const __m128 y = _mm_set1_ps( start.y );
+	const bool yInRange = isInRange4( y, mOctaves );
+	for( ; i + 4 <= count; i += 4 ) {
+		const __m128i index = _mm_add_epi32( _mm_set1_epi32( (int32_t)i ), _mm_setr_epi32( 0, 1, 2, 3 ) );
+		const __m128 x = _mm_add_ps( _mm_set1_ps( start.x ), _mm_mul_ps( _mm_set1_ps( stepX ), _mm_cvtepi32_ps( index ) ) );
+		if( yInRange && isInRange4( x, mOctaves ) )
+			_mm_storeu_ps( result + i, fBm4( mPerms, mOctaves, x, y ) );
+		else {
+			for( size_t j = i; j < i + 4; ++j )
+				result[j] = fBm( vec2( start.x + stepX * (float)j, start.y ) );
+		}
+	}
+#endif
+	for( ; i < count; ++i )
+		result[i] = fBm( vec2( start.x + stepX * (float)i, start.y ) );
+}
+
+void Perlin::fBmRow( const vec3 &start, float stepX, size_t count, float *result ) const
+{
+	size_t i = 0;
+#if defined( CINDER_PERLIN_SSE )
+	const __m128 y = _mm_set1_ps( start.y ), z = _mm_set1_ps( start.z );
+	const bool yzInRange = isInRange4( y, mOctaves ) && isInRange4( z, mOctaves );
+	for( ; i + 4 <= count; i += 4 ) {
+		const __m128i index = _mm_add_epi32( _mm_set1_epi32( (int32_t)i ), _mm_setr_epi32( 0, 1, 2, 3 ) );
+		const __m128 x = _mm_add_ps( _mm_set1_ps( start.x ), _mm_mul_ps( _mm_set1_ps( stepX ), _mm_cvtepi32_ps( index ) ) );
+		if( yzInRange && isInRange4( x, mOctaves ) )
+			_mm_storeu_ps( result + i, fBm4( mPerms, mOctaves, x, y, z ) );
+		else {
+			for( size_t j = i; j < i + 4; ++j )
+				result[j] = fBm( vec3( start.x + stepX * (float)j, start.y, start.z ) );
+		}
+	}
+#endif
+	for( ; i < count; ++i )
+		result[i] = fBm( vec3( start.x + stepX * (float)i, start.y, start.z ) );
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // noise
 float Perlin::noise( float x ) const
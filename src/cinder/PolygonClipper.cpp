@@ -0,0 +1,666 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cinder/PolygonClipper.h"
+#include "cinder/CinderMath.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+// Intersections closer than this to an endpoint of the edges, relative to the extent of all contours, are moved onto it
+#define POLYGON_CLIPPER_SNAP_EPSILON 1e-10
+// Vertices of a result whose edges deviate by less than this angle, in radians, from a straight line are removed
+#define POLYGON_CLIPPER_COLLINEAR_EPSILON 1e-10
+// The arc tolerance of round joins is never less than this fraction of the offset, which limits the number of segments per corner
+#define POLYGON_CLIPPER_MIN_ARC_TOLERANCE 1e-4
+// Corners of an offset contour turning by less than this angle, in radians, are offset as a single point
+#define POLYGON_CLIPPER_OFFSET_EPSILON 1e-9
+
+namespace cinder {
+
+namespace {
+
+inline bool lexLess( const dvec2 &a, const dvec2 &b )
+{
+	return a.x < b.x || ( a.x == b.x && a.y < b.y );
+}
+
+inline double cross( const dvec2 &a, const dvec2 &b )
+{
+	return a.x * b.y - a.y * b.x;
+}
+
+// Returns twice the signed area of triangle abc. When the points are converted from floats the differences and products are exact, so its sign is too.
+inline double orient( const dvec2 &a, const dvec2 &b, const dvec2 &c )
+{
+	return cross( b - a, c - a );
+}
+
+inline bool isCollinear( const dvec2 &a, const dvec2 &b, const dvec2 &c )
+{
+	const double area = cross( b - a, c - b );
+	return area * area <= POLYGON_CLIPPER_COLLINEAR_EPSILON * POLYGON_CLIPPER_COLLINEAR_EPSILON * length2( b - a ) * length2( c - b );
+}
+
+inline bool isFilled( int32_t wind, PolygonClipper::Winding winding )
+{
+	switch( winding ) {
+		case PolygonClipper::WINDING_NONZERO:	return wind != 0;
+		case PolygonClipper::WINDING_POSITIVE:	return wind > 0;
+		case PolygonClipper::WINDING_NEGATIVE:	return wind < 0;
+		default:								return ( wind & 1 ) != 0;
+	}
+}
+
+inline bool isInResult( PolygonClipper::Operation operation, bool subject, bool clip )
+{
+	switch( operation ) {
+		case PolygonClipper::OPERATION_INTERSECTION:	return subject && clip;
+		case PolygonClipper::OPERATION_DIFFERENCE:		return subject && ! clip;
+		case PolygonClipper::OPERATION_XOR:				return subject != clip;
+		default:										return subject || clip;
+	}
+}
+
+// Returns the normal pointing to the right of the edge from \a a to \a b
+inline dvec2 rightNormal( const dvec2 &a, const dvec2 &b )
+{
+	const dvec2 dir = normalize( b - a );
+	return dvec2( dir.y, -dir.x );
+}
+
+// Appends the raw offset of the closed contour \a points, whose interior is on its left, to \a result. Each edge is moved by \a delta to its right; where the moved
+// edges separate at a corner they are joined according to \a join, and where they overlap they are connected through the vertex. The region of positive winding
+// of the result is the offset polygon.
+void offsetContour( const dvec2 *points, size_t numPoints, double delta, PolygonClipper::Join join, double miterLimit, double arcTolerance, vector<dvec2> *result )
+{
+	const double stepAngle = 2 * acos( glm::clamp( 1 - arcTolerance / abs( delta ), -1.0, 1.0 ) );
+	for( size_t j = 0; j < numPoints; ++j ) {
+		const dvec2 &p = points[j];
+		const dvec2 n0 = rightNormal( points[( j + numPoints - 1 ) % numPoints], p );
+		const dvec2 n1 = rightNormal( p, points[( j + 1 ) % numPoints] );
+		const double sinA = cross( n0, n1 ), cosA = dot( n0, n1 );
+		const bool reversal = cosA < 0 && abs( sinA ) < POLYGON_CLIPPER_OFFSET_EPSILON;
+		if( sinA * delta <= 0 && ! reversal ) {
+			if( abs( sinA ) < POLYGON_CLIPPER_OFFSET_EPSILON )
+				result->push_back( p + n1 * delta );
+			else {
+				result->push_back( p + n0 * delta );
+				result->push_back( p );
+				result->push_back( p + n1 * delta );
+			}
+			continue;
+		}
+
+		// the signed angle from n0 to n1, turning around the outside of the corner
+		const double angle = reversal ? ( delta > 0 ? M_PI : -M_PI ) : atan2( sinA, cosA );
+		if( join == PolygonClipper::JOIN_MITER && ( 1 + cosA ) * miterLimit * miterLimit > 2 )
+			result->push_back( p + ( n0 + n1 ) * ( delta / ( 1 + cosA ) ) );
+		else if( join == PolygonClipper::JOIN_ROUND ) {
+			const int steps = std::max( 1, (int)ceil( abs( angle ) / stepAngle ) );
+			result->push_back( p + n0 * delta );
+			for( int s = 1; s < steps; ++s ) {
+				const double a = angle * s / steps;
+				const dvec2 n( n0.x * cos( a ) - n0.y * sin( a ), n0.x * sin( a ) + n0.y * cos( a ) );
+				result->push_back( p + n * delta );
+			}
+			result->push_back( p + n1 * delta );
+		}
+		else {
+			// cut the corner perpendicular to its bisector, at a distance of delta from the vertex
+			const double t = tan( angle / 4 ) * delta;
+			result->push_back( p + n0 * delta + dvec2( -n0.y, n0.x ) * t );
+			result->push_back( p + n1 * delta - dvec2( -n1.y, n1.x ) * t );
+		}
+	}
+}
+
+} // anonymous namespace
+
+//! The edges of the subject and clip, split against each other and annotated with the windings on either side
+struct PolygonClipper::Arrangement {
+	struct Edge {
+		dvec2		mA, mB;		// mA is lexicographically less than mB
+		int32_t		mWind[2];	// the change in the winding of the subject and the clip from the right of mA->mB to its left
+		int32_t		mRight[2];	// the winding of the subject and the clip on the right of mA->mB
+	};
+
+	struct Split {
+		uint32_t	mEdge;
+		bool		mExact;		// whether mPoint is an endpoint of an edge, rather than a calculated intersection
+		dvec2		mPoint;
+	};
+
+	void	addEdge( const dvec2 &a, const dvec2 &b, bool clip );
+	//! Splits the edges wherever they intersect, merges coincident pieces and calculates the windings of the pieces
+	void	build();
+	//! Traces the boundary of the result of \a operation into closed loops, with their interior on the left
+	void	trace( Operation operation, Winding winding );
+
+	void	split();
+	void	intersect( uint32_t i, uint32_t j, double snap );
+	void	addSplit( uint32_t i, const dvec2 &p, bool exact );
+	void	weld( double snap );
+	void	merge();
+	void	sweep();
+	//! Returns whether piece \a a is below piece \a b where their x ranges overlap. Pieces don't cross, so comparing an endpoint with the other's line is exact
+	bool	isBelow( uint32_t a, uint32_t b ) const;
+	size_t	findNextEdge( size_t e ) const;
+	void	addLoop( size_t begin );
+
+	vector<Edge>						mEdges, mPieces;
+	vector<Split>						mSplits;
+	vector<uint32_t>					mOrder, mActive, mWeld;
+	vector<uint32_t>					mSweepLine;	// the pieces crossing the sweep line, from the bottom up
+	vector<pair<double, uint32_t>>		mEnds;		// the right x coordinate of each piece, sorted
+	vector<pair<dvec2, dvec2>>			mResultEdges;
+	vector<uint8_t>						mUsed;
+	vector<dvec2>						mLoopPoints, mContour;
+	vector<uint32_t>					mLoopOffsets;	// the first point of each loop in mLoopPoints, followed by mLoopPoints.size()
+};
+
+void PolygonClipper::Arrangement::addEdge( const dvec2 &a, const dvec2 &b, bool clip )
+{
+	if( a == b )
+		return;
+
+	Edge edge;
+	const bool reversed = lexLess( b, a );
+	edge.mA = reversed ? b : a;
+	edge.mB = reversed ? a : b;
+	edge.mWind[clip ? 0 : 1] = 0;
+	edge.mWind[clip ? 1 : 0] = reversed ? -1 : 1;
+	edge.mRight[0] = edge.mRight[1] = 0;
+	mEdges.push_back( edge );
+}
+
+void PolygonClipper::Arrangement::build()
+{
+	split();
+	merge();
+	sweep();
+}
+
+void PolygonClipper::Arrangement::split()
+{
+	dvec2 minPos( numeric_limits<double>::max() ), maxPos( -numeric_limits<double>::max() );
+	for( const auto &edge : mEdges ) {
+		minPos = glm::min( minPos, glm::min( edge.mA, edge.mB ) );
+		maxPos = glm::max( maxPos, glm::max( edge.mA, edge.mB ) );
+	}
+	const double snap = mEdges.empty() ? 0 : POLYGON_CLIPPER_SNAP_EPSILON * std::max( maxPos.x - minPos.x, maxPos.y - minPos.y );
+
+	// sweep along x, testing each edge against those whose x range it overlaps
+	sort( mEdges.begin(), mEdges.end(), []( const Edge &a, const Edge &b ) { return a.mA.x < b.mA.x; } );
+	mSplits.clear();
+	mActive.clear();
+	for( uint32_t i = 0; i < mEdges.size(); ++i ) {
+		const Edge &edge = mEdges[i];
+		const double minY = std::min( edge.mA.y, edge.mB.y ), maxY = std::max( edge.mA.y, edge.mB.y );
+		size_t numActive = 0;
+		for( size_t a = 0; a < mActive.size(); ++a ) {
+			const Edge &other = mEdges[mActive[a]];
+			if( other.mB.x < edge.mA.x )
+				continue;
+			mActive[numActive++] = mActive[a];
+			if( std::max( other.mA.y, other.mB.y ) >= minY && std::min( other.mA.y, other.mB.y ) <= maxY )
+				intersect( i, mActive[a], snap );
+		}
+		mActive.resize( numActive );
+		mActive.push_back( i );
+	}
+
+	weld( snap );
+
+	// cut each edge into pieces at its splits, which are in lexicographic order along it
+	sort( mSplits.begin(), mSplits.end(), []( const Split &a, const Split &b ) {
+		return a.mEdge < b.mEdge || ( a.mEdge == b.mEdge && lexLess( a.mPoint, b.mPoint ) );
+	} );
+	mPieces.clear();
+	size_t s = 0;
+	for( uint32_t i = 0; i < mEdges.size(); ++i ) {
+		Edge piece = mEdges[i];
+		for( ; s < mSplits.size() && mSplits[s].mEdge == i; ++s ) {
+			if( ! lexLess( piece.mA, mSplits[s].mPoint ) || ! lexLess( mSplits[s].mPoint, mEdges[i].mB ) )
+				continue;
+			piece.mB = mSplits[s].mPoint;
+			mPieces.push_back( piece );
+			piece.mA = piece.mB;
+			piece.mB = mEdges[i].mB;
+		}
+		if( piece.mA != piece.mB )
+			mPieces.push_back( piece );
+	}
+}
+
+void PolygonClipper::Arrangement::weld( double snap )
+{
+	// the intersections of three or more edges at a point are calculated pairwise, so they differ by rounding; those within the snap distance of each other
+	// are moved onto a single point, which is an endpoint if any of them is
+	mOrder.resize( mSplits.size() );
+	mWeld.resize( mSplits.size() );
+	for( uint32_t k = 0; k < mSplits.size(); ++k )
+		mOrder[k] = mWeld[k] = k;
+	sort( mOrder.begin(), mOrder.end(), [this]( uint32_t a, uint32_t b ) { return mSplits[a].mPoint.x < mSplits[b].mPoint.x; } );
+	auto find = [this]( uint32_t k ) {
+		while( mWeld[k] != k )
+			k = mWeld[k] = mWeld[mWeld[k]];
+		return k;
+	};
+	for( size_t a = 0; a < mOrder.size(); ++a ) {
+		const dvec2 &pa = mSplits[mOrder[a]].mPoint;
+		for( size_t b = a + 1; b < mOrder.size() && mSplits[mOrder[b]].mPoint.x - pa.x <= snap; ++b ) {
+			if( pa != mSplits[mOrder[b]].mPoint && length2( mSplits[mOrder[b]].mPoint - pa ) <= snap * snap ) {
+				uint32_t rootA = find( mOrder[a] ), rootB = find( mOrder[b] );
+				if( mSplits[rootB].mExact && ! mSplits[rootA].mExact )
+					std::swap( rootA, rootB );
+				mWeld[rootB] = rootA;
+			}
+		}
+	}
+	for( uint32_t k = 0; k < mSplits.size(); ++k )
+		mSplits[k].mPoint = mSplits[find( k )].mPoint;
+}
+
+void PolygonClipper::Arrangement::intersect( uint32_t i, uint32_t j, double snap )
+{
+	const dvec2 a1 = mEdges[i].mA, b1 = mEdges[i].mB, a2 = mEdges[j].mA, b2 = mEdges[j].mB;
+	const double o1 = orient( a2, b2, a1 ), o2 = orient( a2, b2, b1 );
+	if( o1 == 0 && o2 == 0 ) {
+		// collinear edges overlap between their inner endpoints
+		addSplit( i, a2, true ); addSplit( i, b2, true );
+		addSplit( j, a1, true ); addSplit( j, b1, true );
+		return;
+	}
+
+	const double o3 = orient( a1, b1, a2 ), o4 = orient( a1, b1, b2 );
+	if( ( o1 > 0 && o2 > 0 ) || ( o1 < 0 && o2 < 0 ) || ( o3 > 0 && o4 > 0 ) || ( o3 < 0 && o4 < 0 ) )
+		return;
+
+	if( o1 == 0 || o2 == 0 || o3 == 0 || o4 == 0 ) {
+		// an endpoint touches the other edge
+		if( o1 == 0 ) addSplit( j, a1, true );
+		if( o2 == 0 ) addSplit( j, b1, true );
+		if( o3 == 0 ) addSplit( i, a2, true );
+		if( o4 == 0 ) addSplit( i, b2, true );
+		return;
+	}
+
+	dvec2 p = a1 + ( b1 - a1 ) * ( o1 / ( o1 - o2 ) );
+	bool exact = false;
+	const dvec2 endpoints[] = { a1, b1, a2, b2 };
+	for( const auto &endpoint : endpoints ) {
+		if( length2( p - endpoint ) <= snap * snap ) {
+			p = endpoint;
+			exact = true;
+			break;
+		}
+	}
+	addSplit( i, p, exact );
+	addSplit( j, p, exact );
+}
+
+void PolygonClipper::Arrangement::addSplit( uint32_t i, const dvec2 &p, bool exact )
+{
+	if( lexLess( mEdges[i].mA, p ) && lexLess( p, mEdges[i].mB ) ) {
+		Split split = { i, exact, p };
+		mSplits.push_back( split );
+	}
+}
+
+void PolygonClipper::Arrangement::merge()
+{
+	// coincident pieces are identical after splitting, so they become adjacent once sorted
+	sort( mPieces.begin(), mPieces.end(), []( const Edge &a, const Edge &b ) {
+		return lexLess( a.mA, b.mA ) || ( a.mA == b.mA && lexLess( a.mB, b.mB ) );
+	} );
+	size_t numPieces = 0;
+	for( size_t p = 0; p < mPieces.size(); ++p ) {
+		if( numPieces > 0 && mPieces[numPieces - 1].mA == mPieces[p].mA && mPieces[numPieces - 1].mB == mPieces[p].mB ) {
+			mPieces[numPieces - 1].mWind[0] += mPieces[p].mWind[0];
+			mPieces[numPieces - 1].mWind[1] += mPieces[p].mWind[1];
+		}
+		else
+			mPieces[numPieces++] = mPieces[p];
+	}
+	mPieces.resize( numPieces );
+	mPieces.erase( remove_if( mPieces.begin(), mPieces.end(), []( const Edge &piece ) { return piece.mWind[0] == 0 && piece.mWind[1] == 0; } ), mPieces.end() );
+}
+
+bool PolygonClipper::Arrangement::isBelow( uint32_t a, uint32_t b ) const
+{
+	const Edge &pa = mPieces[a], &pb = mPieces[b];
+	if( pa.mA.x >= pb.mA.x ) {
+		double o = orient( pb.mA, pb.mB, pa.mA );
+		if( o == 0 )
+			o = orient( pb.mA, pb.mB, pa.mB );
+		return o < 0;
+	}
+	else {
+		double o = orient( pa.mA, pa.mB, pb.mA );
+		if( o == 0 )
+			o = orient( pa.mA, pa.mB, pb.mB );
+		return o > 0;
+	}
+}
+
+void PolygonClipper::Arrangement::sweep()
+{
+	// the pieces don't cross, so the order of those crossing the sweep line only changes where they start or end, and the winding below a new piece is
+	// that above its neighbor underneath
+	auto isBelowFn = [this]( uint32_t a, uint32_t b ) { return isBelow( a, b ); };
+	mEnds.resize( mPieces.size() );
+	for( uint32_t p = 0; p < mPieces.size(); ++p )
+		mEnds[p] = make_pair( mPieces[p].mB.x, p );
+	sort( mEnds.begin(), mEnds.end() );
+	mSweepLine.clear();
+	mActive.clear();
+	size_t nextPiece = 0, nextEnd = 0;
+	while( nextPiece < mPieces.size() ) {
+		// the pieces are in lexicographic order, so those starting at x are contiguous, including any vertical ones
+		const double x = mPieces[nextPiece].mA.x;
+		for( ; nextEnd < mEnds.size() && mEnds[nextEnd].first <= x; ++nextEnd ) {
+			const uint32_t ended = mEnds[nextEnd].second;
+			if( mPieces[ended].mA.x == mPieces[ended].mB.x )
+				continue;
+			auto it = lower_bound( mSweepLine.begin(), mSweepLine.end(), ended, isBelowFn );
+			// rounding at nearly coincident pieces can leave their order inconsistent, in which case the piece is found the slow way
+			if( it == mSweepLine.end() || *it != ended )
+				it = std::find( mSweepLine.begin(), mSweepLine.end(), ended );
+			if( it != mSweepLine.end() )
+				mSweepLine.erase( it );
+		}
+
+		const size_t firstPiece = nextPiece;
+		for( ; nextPiece < mPieces.size() && mPieces[nextPiece].mA.x == x; ++nextPiece )
+			if( mPieces[nextPiece].mB.x != x )
+				mActive.push_back( (uint32_t)nextPiece );
+		// adding the new pieces from the bottom up means each one's neighbor underneath is final
+		sort( mActive.begin(), mActive.end(), isBelowFn );
+		for( uint32_t p : mActive ) {
+			auto it = mSweepLine.insert( lower_bound( mSweepLine.begin(), mSweepLine.end(), p, isBelowFn ), p );
+			Edge &piece = mPieces[p];
+			piece.mRight[0] = piece.mRight[1] = 0;
+			if( it != mSweepLine.begin() ) {
+				const Edge &below = mPieces[*( it - 1 )];
+				piece.mRight[0] = below.mRight[0] + below.mWind[0];
+				piece.mRight[1] = below.mRight[1] + below.mWind[1];
+			}
+		}
+		mActive.clear();
+
+		// the right of a vertical piece is wound by the pieces passing below its middle
+		for( size_t v = firstPiece; v < nextPiece; ++v ) {
+			Edge &vertical = mPieces[v];
+			if( vertical.mB.x != x )
+				continue;
+			const dvec2 middle( x, ( vertical.mA.y + vertical.mB.y ) / 2 );
+			auto it = lower_bound( mSweepLine.begin(), mSweepLine.end(), middle, [this]( uint32_t a, const dvec2 &pt ) { return orient( mPieces[a].mA, mPieces[a].mB, pt ) > 0; } );
+			vertical.mRight[0] = vertical.mRight[1] = 0;
+			if( it != mSweepLine.begin() ) {
+				const Edge &below = mPieces[*( it - 1 )];
+				vertical.mRight[0] = below.mRight[0] + below.mWind[0];
+				vertical.mRight[1] = below.mRight[1] + below.mWind[1];
+			}
+		}
+	}
+}
+
+void PolygonClipper::Arrangement::trace( Operation operation, Winding winding )
+{
+	mResultEdges.clear();
+	for( const auto &piece : mPieces ) {
+		const bool right = isInResult( operation, isFilled( piece.mRight[0], winding ), isFilled( piece.mRight[1], winding ) );
+		const bool left = isInResult( operation, isFilled( piece.mRight[0] + piece.mWind[0], winding ), isFilled( piece.mRight[1] + piece.mWind[1], winding ) );
+		if( left != right )
+			mResultEdges.push_back( left ? make_pair( piece.mA, piece.mB ) : make_pair( piece.mB, piece.mA ) );
+	}
+
+	sort( mResultEdges.begin(), mResultEdges.end(), []( const pair<dvec2, dvec2> &a, const pair<dvec2, dvec2> &b ) { return lexLess( a.first, b.first ); } );
+	mUsed.assign( mResultEdges.size(), 0 );
+	mLoopPoints.clear();
+	mLoopOffsets.assign( 1, 0 );
+	for( size_t first = 0; first < mResultEdges.size(); ++first ) {
+		if( mUsed[first] )
+			continue;
+		const size_t begin = mLoopPoints.size();
+		size_t e = first;
+		while( true ) {
+			mUsed[e] = 1;
+			mLoopPoints.push_back( mResultEdges[e].first );
+			const size_t next = findNextEdge( e );
+			if( next == first || next == mResultEdges.size() || mUsed[next] )
+				break;
+			e = next;
+		}
+		addLoop( begin );
+	}
+}
+
+size_t PolygonClipper::Arrangement::findNextEdge( size_t e ) const
+{
+	const dvec2 &vertex = mResultEdges[e].second;
+	auto range = equal_range( mResultEdges.begin(), mResultEdges.end(), make_pair( vertex, vertex ), []( const pair<dvec2, dvec2> &a, const pair<dvec2, dvec2> &b ) {
+		return lexLess( a.first, b.first );
+	} );
+	if( range.first == range.second )
+		return mResultEdges.size();
+	else if( range.second - range.first == 1 )
+		return range.first - mResultEdges.begin();
+
+	// where several loops meet at a vertex, keep each separate by taking the first edge clockwise from the one arriving
+	const dvec2 back = mResultEdges[e].first - vertex;
+	double minAngle = numeric_limits<double>::max();
+	size_t result = mResultEdges.size();
+	for( auto it = range.first; it != range.second; ++it ) {
+		const dvec2 out = it->second - vertex;
+		double angle = atan2( cross( out, back ), dot( out, back ) );
+		if( angle <= 0 )
+			angle += 2 * M_PI;
+		if( angle < minAngle ) {
+			minAngle = angle;
+			result = it - mResultEdges.begin();
+		}
+	}
+	return result;
+}
+
+void PolygonClipper::Arrangement::addLoop( size_t begin )
+{
+	// remove the vertices where the loop runs straight, which includes most of the splits
+	size_t end = begin;
+	for( size_t p = begin; p < mLoopPoints.size(); ++p ) {
+		while( end - begin >= 2 && isCollinear( mLoopPoints[end - 2], mLoopPoints[end - 1], mLoopPoints[p] ) )
+			--end;
+		mLoopPoints[end++] = mLoopPoints[p];
+	}
+	size_t start = begin;
+	while( end - start >= 3 ) {
+		if( isCollinear( mLoopPoints[end - 2], mLoopPoints[end - 1], mLoopPoints[start] ) )
+			--end;
+		else if( isCollinear( mLoopPoints[end - 1], mLoopPoints[start], mLoopPoints[start + 1] ) )
+			++start;
+		else
+			break;
+	}
+
+	if( end - start >= 3 ) {
+		std::copy( mLoopPoints.begin() + start, mLoopPoints.begin() + end, mLoopPoints.begin() + begin );
+		mLoopPoints.resize( begin + end - start );
+		mLoopOffsets.push_back( (uint32_t)mLoopPoints.size() );
+	}
+	else
+		mLoopPoints.resize( begin );
+}
+
+PolygonClipper::PolygonClipper()
+	: mMiterLimit( 2 ), mArcTolerance( 0.25f ), mPrepared( false ), mArrangement( new Arrangement ), mOffsetArrangement( new Arrangement )
+{
+}
+
+template<typename T>
+void PolygonClipper::addContour( const T *points, size_t numPoints, bool clip )
+{
+	mPrepared = false;
+	for( size_t p = 0; p < numPoints; ++p )
+		mArrangement->addEdge( dvec2( points[p] ), dvec2( points[( p + 1 ) % numPoints] ), clip );
+}
+
+void PolygonClipper::addSubject( const PolyLine2f &polyLine )
+{
+	addContour( polyLine.getPoints().data(), polyLine.size(), false );
+}
+
+void PolygonClipper::addSubject( const PolyLine2d &polyLine )
+{
+	addContour( polyLine.getPoints().data(), polyLine.size(), false );
+}
+
+void PolygonClipper::addSubject( const std::vector<PolyLine2f> &polyLines )
+{
+	for( const auto &polyLine : polyLines )
+		addSubject( polyLine );
+}
+
+void PolygonClipper::addSubject( const Shape2d &shape, float approximationScale )
+{
+	for( const auto &path : shape.getContours() )
+		addSubject( path, approximationScale );
+}
+
+void PolygonClipper::addSubject( const Path2d &path, float approximationScale )
+{
+	const vector<vec2> subdivided = path.subdivide( approximationScale );
+	addContour( subdivided.data(), subdivided.size(), false );
+}
+
+void PolygonClipper::addClip( const PolyLine2f &polyLine )
+{
+	addContour( polyLine.getPoints().data(), polyLine.size(), true );
+}
+
+void PolygonClipper::addClip( const PolyLine2d &polyLine )
+{
+	addContour( polyLine.getPoints().data(), polyLine.size(), true );
+}
+
+void PolygonClipper::addClip( const std::vector<PolyLine2f> &polyLines )
+{
+	for( const auto &polyLine : polyLines )
+		addClip( polyLine );
+}
+
+void PolygonClipper::addClip( const Shape2d &shape, float approximationScale )
+{
+	for( const auto &path : shape.getContours() )
+		addClip( path, approximationScale );
+}
+
+void PolygonClipper::addClip( const Path2d &path, float approximationScale )
+{
+	const vector<vec2> subdivided = path.subdivide( approximationScale );
+	addContour( subdivided.data(), subdivided.size(), true );
+}
+
+void PolygonClipper::clear()
+{
+	mArrangement->mEdges.clear();
+	mPrepared = false;
+}
+
+void PolygonClipper::prepare()
+{
+	if( ! mPrepared ) {
+		mArrangement->build();
+		mPrepared = true;
+	}
+}
+
+template<typename T>
+void PolygonClipper::copyLoops( const Arrangement &arrangement, std::vector<PolyLineT<T>> *result ) const
+{
+	result->resize( arrangement.mLoopOffsets.size() - 1 );
+	for( size_t l = 0; l < result->size(); ++l ) {
+		PolyLineT<T> &polyLine = (*result)[l];
+		polyLine.getPoints().clear();
+		polyLine.setClosed();
+		for( size_t p = arrangement.mLoopOffsets[l]; p < arrangement.mLoopOffsets[l + 1]; ++p )
+			polyLine.push_back( T( arrangement.mLoopPoints[p] ) );
+	}
+}
+
+std::vector<PolyLine2f> PolygonClipper::calc( Operation operation, Winding winding )
+{
+	std::vector<PolyLine2f> result;
+	calc( operation, &result, winding );
+	return result;
+}
+
+void PolygonClipper::calc( Operation operation, std::vector<PolyLine2f> *result, Winding winding )
+{
+	prepare();
+	mArrangement->trace( operation, winding );
+	copyLoops( *mArrangement, result );
+}
+
+void PolygonClipper::calc( Operation operation, std::vector<PolyLine2d> *result, Winding winding )
+{
+	prepare();
+	mArrangement->trace( operation, winding );
+	copyLoops( *mArrangement, result );
+}
+
+std::vector<PolyLine2f> PolygonClipper::calcOffset( float delta, Join join, Winding winding )
+{
+	std::vector<PolyLine2f> result;
+	calcOffset( delta, &result, join, winding );
+	return result;
+}
+
+void PolygonClipper::calcOffset( float delta, std::vector<PolyLine2f> *result, Join join, Winding winding )
+{
+	prepare();
+	mArrangement->trace( OPERATION_UNION, winding );
+	if( delta == 0 ) {
+		copyLoops( *mArrangement, result );
+		return;
+	}
+
+	// the loops of the union have their interior on the left, so offsetting to the right inflates them and the positive winding of the offsets is the result
+	Arrangement &offset = *mOffsetArrangement;
+	offset.mEdges.clear();
+	for( size_t l = 0; l + 1 < mArrangement->mLoopOffsets.size(); ++l ) {
+		offset.mContour.clear();
+		const uint32_t begin = mArrangement->mLoopOffsets[l], end = mArrangement->mLoopOffsets[l + 1];
+		offsetContour( &mArrangement->mLoopPoints[begin], end - begin, delta, join, mMiterLimit, std::max( (double)mArcTolerance, abs( delta ) * POLYGON_CLIPPER_MIN_ARC_TOLERANCE ), &offset.mContour );
+		for( size_t p = 0; p < offset.mContour.size(); ++p )
+			offset.addEdge( offset.mContour[p], offset.mContour[( p + 1 ) % offset.mContour.size()], false );
+	}
+	offset.build();
+	offset.trace( OPERATION_UNION, WINDING_POSITIVE );
+	copyLoops( offset, result );
+}
+
+} // namespace cinder
@@ -24,9 +24,374 @@
 
 #include "cinder/Rand.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// The fills only match the next*() functions exactly when those use SSE arithmetic too
+#if defined( __SSE2_MATH__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+	#define CINDER_PHILOX_SSE
+	#include <emmintrin.h>
+#endif
+
+// The multipliers and key increments of Philox4x32
+#define PHILOX_M0		0xD2511F53u
+#define PHILOX_M1		0xCD9E8D57u
+#define PHILOX_W0		0x9E3779B9u
+#define PHILOX_W1		0xBB67AE85u
+#define PHILOX_ROUNDS	10
+// The fills generate this many values at a time before transforming them
+#define PHILOX_FILL_CHUNK	256
+
 namespace cinder {
 
 std::mt19937 Rand::sBase( 310u );
 std::uniform_real_distribution<float> Rand::sFloatGen;
 
+namespace {
+
+// Polynomial approximations are used for the logarithm, sine and cosine (after Cephes), which have exact SIMD counterparts. The scalar and SIMD versions
+// must perform the same float operations in the same order.
+const float LOG_SQRTHF = 0.707106781186547524f;
+const float LOG_P[] = { 7.0376836292E-2f, -1.1514610310E-1f, 1.1676998740E-1f, -1.2420140846E-1f, 1.4249322787E-1f, -1.6668057665E-1f, 2.0000714765E-1f, -2.4999993993E-1f, 3.3333331174E-1f };
+const float LOG_Q1 = -2.12194440E-4f, LOG_Q2 = 0.693359375f;
+const float SIN_P[] = { -1.9515295891E-4f, 8.3321608736E-3f, -1.6666654611E-1f };
+const float COS_P[] = { 2.443315711809948E-5f, -1.388731625493765E-3f, 4.166664568298827E-2f };
+const float HALF_PI = 1.57079632679489662f, SQRT_HALF = 0.707106781186547524f;
+const float INV_2_24 = 1.0f / 16777216.0f;
+
+void philoxBlock( const uint32_t key[2], uint64_t stream, uint64_t block, uint32_t result[4] )
+{
+	uint32_t c0 = (uint32_t)block, c1 = (uint32_t)( block >> 32 ), c2 = (uint32_t)stream, c3 = (uint32_t)( stream >> 32 );
+	uint32_t k0 = key[0], k1 = key[1];
+	for( int r = 0; r < PHILOX_ROUNDS; ++r ) {
+		if( r > 0 ) {
+			k0 += PHILOX_W0;
+			k1 += PHILOX_W1;
+		}
+		const uint64_t p0 = (uint64_t)PHILOX_M0 * c0, p1 = (uint64_t)PHILOX_M1 * c2;
+		c0 = (uint32_t)( p1 >> 32 ) ^ c1 ^ k0;
+		c1 = (uint32_t)p1;
+		c2 = (uint32_t)( p0 >> 32 ) ^ c3 ^ k1;
+		c3 = (uint32_t)p0;
+	}
+	result[0] = c0; result[1] = c1; result[2] = c2; result[3] = c3;
+}
+
+// Returns the natural logarithm of \a x, which must be normal and positive
+float logPositive( float x )
+{
+	uint32_t bits;
+	memcpy( &bits, &x, sizeof( bits ) );
+	float e = (float)( (int32_t)( bits >> 23 ) - 127 );
+	// the mantissa in [0.5, 1)
+	bits = ( bits & ~0x7F800000u ) | 0x3F000000u;
+	memcpy( &x, &bits, sizeof( x ) );
+	e = e + 1.0f;
+	if( x < LOG_SQRTHF ) {
+		e = e - 1.0f;
+		x = ( x - 1.0f ) + x;
+	}
+	else
+		x = x - 1.0f;
+
+	const float z = x * x;
+	float y = LOG_P[0];
+	for( int p = 1; p < 9; ++p )
+		y = y * x + LOG_P[p];
+	y = y * x;
+	y = y * z;
+	y = y + e * LOG_Q1;
+	y = y - z * 0.5f;
+	x = x + y;
+	return x + e * LOG_Q2;
+}
+
+// Calculates the sine and cosine of a full turn scaled by \a value / 2^32. The upper two bits select the quadrant and the next 24 the angle within it.
+void sinCosTurn( uint32_t value, float *sine, float *cosine )
+{
+	const uint32_t quadrant = value >> 30;
+	const float b = ( (float)( ( value >> 6 ) & 0xFFFFFF ) * INV_2_24 - 0.5f ) * HALF_PI;
+	const float z = b * b;
+	const float sb = ( ( SIN_P[0] * z + SIN_P[1] ) * z + SIN_P[2] ) * z * b + b;
+	const float cb = ( ( COS_P[0] * z + COS_P[1] ) * z + COS_P[2] ) * z * z - z * 0.5f + 1.0f;
+	// rotate by the eighth turn that b was centered on
+	float s = ( sb + cb ) * SQRT_HALF, c = ( cb - sb ) * SQRT_HALF;
+	if( quadrant & 1 )
+		std::swap( s, c );
+	*sine = ( quadrant & 2 ) ? -s : s;
+	*cosine = ( ( quadrant ^ ( quadrant >> 1 ) ) & 1 ) ? -c : c;
+}
+
+#if defined( CINDER_PHILOX_SSE )
+
+inline __m128 select4( __m128 mask, __m128 a, __m128 b )
+{
+	return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+}
+
+inline void mulHiLo4( __m128i a, __m128i multiplier, __m128i *hi, __m128i *lo )
+{
+	// _mm_mul_epu32 multiplies the even lanes into 64 bits
+	const __m128i even = _mm_mul_epu32( a, multiplier ), odd = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), multiplier );
+	*lo = _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE( 0, 0, 2, 0 ) ), _mm_shuffle_epi32( odd, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+	*hi = _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE( 0, 0, 3, 1 ) ), _mm_shuffle_epi32( odd, _MM_SHUFFLE( 0, 0, 3, 1 ) ) );
+}
+
+// Writes the 16 values of the four blocks starting at \a block to \a result, computing one block per lane
+void philoxBlocks4( const uint32_t key[2], uint64_t stream, uint64_t block, uint32_t *result )
+{
+	uint32_t low[4], high[4];
+	for( int l = 0; l < 4; ++l ) {
+		low[l] = (uint32_t)( block + l );
+		high[l] = (uint32_t)( ( block + l ) >> 32 );
+	}
+	__m128i c0 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( low ) ), c1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( high ) );
+	__m128i c2 = _mm_set1_epi32( (int32_t)(uint32_t)stream ), c3 = _mm_set1_epi32( (int32_t)(uint32_t)( stream >> 32 ) );
+	__m128i k0 = _mm_set1_epi32( (int32_t)key[0] ), k1 = _mm_set1_epi32( (int32_t)key[1] );
+	const __m128i m0 = _mm_set1_epi32( (int32_t)PHILOX_M0 ), m1 = _mm_set1_epi32( (int32_t)PHILOX_M1 );
+	const __m128i w0 = _mm_set1_epi32( (int32_t)PHILOX_W0 ), w1 = _mm_set1_epi32( (int32_t)PHILOX_W1 );
+	for( int r = 0; r < PHILOX_ROUNDS; ++r ) {
+		if( r > 0 ) {
+			k0 = _mm_add_epi32( k0, w0 );
+			k1 = _mm_add_epi32( k1, w1 );
+		}
+		__m128i hi0, lo0, hi1, lo1;
+		mulHiLo4( c0, m0, &hi0, &lo0 );
+		mulHiLo4( c2, m1, &hi1, &lo1 );
+		c0 = _mm_xor_si128( _mm_xor_si128( hi1, c1 ), k0 );
+		c1 = lo1;
+		c2 = _mm_xor_si128( _mm_xor_si128( hi0, c3 ), k1 );
+		c3 = lo0;
+	}
+
+	// each lane holds a block, which is transposed into consecutive values
+	__m128 r0 = _mm_castsi128_ps( c0 ), r1 = _mm_castsi128_ps( c1 ), r2 = _mm_castsi128_ps( c2 ), r3 = _mm_castsi128_ps( c3 );
+	_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+	_mm_storeu_ps( reinterpret_cast<float*>( result ), r0 );
+	_mm_storeu_ps( reinterpret_cast<float*>( result + 4 ), r1 );
+	_mm_storeu_ps( reinterpret_cast<float*>( result + 8 ), r2 );
+	_mm_storeu_ps( reinterpret_cast<float*>( result + 12 ), r3 );
+}
+
+// Converts the upper 24 bits of each value to a float in [0, 1)
+inline __m128 unitFloat4( __m128i values )
+{
+	return _mm_mul_ps( _mm_cvtepi32_ps( _mm_srli_epi32( values, 8 ) ), _mm_set1_ps( INV_2_24 ) );
+}
+
+__m128 logPositive4( __m128 x )
+{
+	const __m128 one = _mm_set1_ps( 1.0f );
+	__m128i bits = _mm_castps_si128( x );
+	__m128 e = _mm_cvtepi32_ps( _mm_sub_epi32( _mm_srli_epi32( bits, 23 ), _mm_set1_epi32( 127 ) ) );
+	bits = _mm_or_si128( _mm_andnot_si128( _mm_set1_epi32( 0x7F800000 ), bits ), _mm_set1_epi32( 0x3F000000 ) );
+	x = _mm_castsi128_ps( bits );
+	e = _mm_add_ps( e, one );
+	const __m128 mask = _mm_cmplt_ps( x, _mm_set1_ps( LOG_SQRTHF ) );
+	e = select4( mask, _mm_sub_ps( e, one ), e );
+	x = select4( mask, _mm_add_ps( _mm_sub_ps( x, one ), x ), _mm_sub_ps( x, one ) );
+
+	const __m128 z = _mm_mul_ps( x, x );
+	__m128 y = _mm_set1_ps( LOG_P[0] );
+	for( int p = 1; p < 9; ++p )
+		y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( LOG_P[p] ) );
+	y = _mm_mul_ps( y, x );
+	y = _mm_mul_ps( y, z );
+	y = _mm_add_ps( y, _mm_mul_ps( e, _mm_set1_ps( LOG_Q1 ) ) );
+	y = _mm_sub_ps( y, _mm_mul_ps( z, _mm_set1_ps( 0.5f ) ) );
+	x = _mm_add_ps( x, y );
+	return _mm_add_ps( x, _mm_mul_ps( e, _mm_set1_ps( LOG_Q2 ) ) );
+}
+
+void sinCosTurn4( __m128i values, __m128 *sine, __m128 *cosine )
+{
+	const __m128i quadrant = _mm_srli_epi32( values, 30 );
+	const __m128 fraction = _mm_mul_ps( _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( values, 6 ), _mm_set1_epi32( 0xFFFFFF ) ) ), _mm_set1_ps( INV_2_24 ) );
+	const __m128 b = _mm_mul_ps( _mm_sub_ps( fraction, _mm_set1_ps( 0.5f ) ), _mm_set1_ps( HALF_PI ) );
+	const __m128 z = _mm_mul_ps( b, b );
+	const __m128 sb = _mm_add_ps( _mm_mul_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( SIN_P[0] ), z ), _mm_set1_ps( SIN_P[1] ) ), z ), _mm_set1_ps( SIN_P[2] ) ), z ), b ), b );
+	const __m128 cb = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( COS_P[0] ), z ), _mm_set1_ps( COS_P[1] ) ), z ), _mm_set1_ps( COS_P[2] ) ), z ), z ),
+												_mm_mul_ps( z, _mm_set1_ps( 0.5f ) ) ), _mm_set1_ps( 1.0f ) );
+	const __m128 s = _mm_mul_ps( _mm_add_ps( sb, cb ), _mm_set1_ps( SQRT_HALF ) ), c = _mm_mul_ps( _mm_sub_ps( cb, sb ), _mm_set1_ps( SQRT_HALF ) );
+	const __m128 swap = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( quadrant, _mm_set1_epi32( 1 ) ), _mm_set1_epi32( 1 ) ) );
+	const __m128 sineSign = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( quadrant, _mm_set1_epi32( 2 ) ), 30 ) );
+	const __m128 cosineSign = _mm_castsi128_ps( _mm_slli_epi32( _mm_xor_si128( quadrant, _mm_srli_epi32( quadrant, 1 ) ), 31 ) );
+	*sine = _mm_xor_ps( select4( swap, c, s ), sineSign );
+	*cosine = _mm_xor_ps( select4( swap, s, c ), cosineSign );
+}
+
+// Splits four pairs of values into their first and second halves
+inline void deinterleave4( const uint32_t *values, __m128i *first, __m128i *second )
+{
+	const __m128 a = _mm_loadu_ps( reinterpret_cast<const float*>( values ) ), b = _mm_loadu_ps( reinterpret_cast<const float*>( values + 4 ) );
+	*first = _mm_castps_si128( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+	*second = _mm_castps_si128( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+}
+
+#endif // defined( CINDER_PHILOX_SSE )
+
+} // anonymous namespace
+
+void Philox::generateBlock()
+{
+	philoxBlock( mKey, mStream, mBlock++, mBuffer );
+	mIndex = 0;
+}
+
+void Philox::discard( uint64_t count )
+{
+	const uint64_t position = getPosition() + count;
+	mBlock = position / 4;
+	mIndex = 4;
+	if( position % 4 ) {
+		generateBlock();
+		mIndex = (uint32_t)( position % 4 );
+	}
+}
+
+vec2 Philox::nextVec2()
+{
+	float s, c;
+	sinCosTurn( nextUint(), &s, &c );
+	return vec2( c, s );
+}
+
+vec3 Philox::nextVec3()
+{
+	float s, c;
+	sinCosTurn( nextUint(), &s, &c );
+	const float z = nextFloat() * 2.0f + -1.0f;
+	const float rho = std::sqrt( 1.0f - z * z );
+	return vec3( rho * c, rho * s, z );
+}
+
+float Philox::nextGaussian()
+{
+	if( mHasSpareGaussian ) {
+		mHasSpareGaussian = false;
+		return mSpareGaussian;
+	}
+
+	// the Box-Muller transform, with the radius from a value in (0, 1]
+	const float u = (float)( ( nextUint() >> 8 ) + 1 ) * INV_2_24;
+	const float r = std::sqrt( logPositive( u ) * -2.0f );
+	float s, c;
+	sinCosTurn( nextUint(), &s, &c );
+	mSpareGaussian = r * s;
+	mHasSpareGaussian = true;
+	return r * c;
+}
+
+void Philox::fillUint( uint32_t *result, size_t count )
+{
+	for( ; count > 0 && mIndex < 4; --count )
+		*result++ = mBuffer[mIndex++];
+#if defined( CINDER_PHILOX_SSE )
+	for( ; count >= 16; count -= 16, result += 16, mBlock += 4 )
+		philoxBlocks4( mKey, mStream, mBlock, result );
+#endif
+	for( ; count >= 4; count -= 4, result += 4, ++mBlock )
+		philoxBlock( mKey, mStream, mBlock, result );
+	for( ; count > 0; --count )
+		*result++ = nextUint();
+}
+
+void Philox::fillFloat( float *result, size_t count, float a, float b )
+{
+	size_t i = 0;
+#if defined( CINDER_PHILOX_SSE )
+	uint32_t values[PHILOX_FILL_CHUNK];
+	const __m128 range = _mm_set1_ps( b - a ), offset = _mm_set1_ps( a );
+	while( count - i >= 4 ) {
+		const size_t n = std::min<size_t>( PHILOX_FILL_CHUNK, ( count - i ) & ~3 );
+		fillUint( values, n );
+		for( size_t v = 0; v < n; v += 4, i += 4 ) {
+			const __m128 u = unitFloat4( _mm_loadu_si128( reinterpret_cast<const __m128i*>( values + v ) ) );
+			_mm_storeu_ps( result + i, _mm_add_ps( _mm_mul_ps( u, range ), offset ) );
+		}
+	}
+#endif
+	for( ; i < count; ++i )
+		result[i] = nextFloat( a, b );
+}
+
+void Philox::fillGaussian( float *result, size_t count, float mean, float stdDev )
+{
+	size_t i = 0;
+	if( count > 0 && mHasSpareGaussian )
+		result[i++] = nextGaussian() * stdDev + mean;
+#if defined( CINDER_PHILOX_SSE )
+	uint32_t values[PHILOX_FILL_CHUNK];
+	const __m128 scale = _mm_set1_ps( stdDev ), offset = _mm_set1_ps( mean );
+	while( count - i >= 8 ) {
+		// each pair of values gives a pair of results
+		const size_t n = std::min<size_t>( PHILOX_FILL_CHUNK, ( count - i ) & ~7 );
+		fillUint( values, n );
+		for( size_t v = 0; v < n; v += 8, i += 8 ) {
+			__m128i radiusValues, angleValues;
+			deinterleave4( values + v, &radiusValues, &angleValues );
+			const __m128 u = _mm_mul_ps( _mm_cvtepi32_ps( _mm_add_epi32( _mm_srli_epi32( radiusValues, 8 ), _mm_set1_epi32( 1 ) ) ), _mm_set1_ps( INV_2_24 ) );
+			const __m128 r = _mm_sqrt_ps( _mm_mul_ps( logPositive4( u ), _mm_set1_ps( -2.0f ) ) );
+			__m128 s, c;
+			sinCosTurn4( angleValues, &s, &c );
+			const __m128 g0 = _mm_add_ps( _mm_mul_ps( _mm_mul_ps( r, c ), scale ), offset ), g1 = _mm_add_ps( _mm_mul_ps( _mm_mul_ps( r, s ), scale ), offset );
+			_mm_storeu_ps( result + i, _mm_unpacklo_ps( g0, g1 ) );
+			_mm_storeu_ps( result + i + 4, _mm_unpackhi_ps( g0, g1 ) );
+		}
+	}
+#endif
+	for( ; i < count; ++i )
+		result[i] = nextGaussian() * stdDev + mean;
+}
+
+void Philox::fillVec2( vec2 *result, size_t count )
+{
+	size_t i = 0;
+#if defined( CINDER_PHILOX_SSE )
+	uint32_t values[PHILOX_FILL_CHUNK];
+	while( count - i >= 4 ) {
+		const size_t n = std::min<size_t>( PHILOX_FILL_CHUNK, ( count - i ) & ~3 );
+		fillUint( values, n );
+		for( size_t v = 0; v < n; v += 4, i += 4 ) {
+			__m128 s, c;
+			sinCosTurn4( _mm_loadu_si128( reinterpret_cast<const __m128i*>( values + v ) ), &s, &c );
+			_mm_storeu_ps( &result[i].x, _mm_unpacklo_ps( c, s ) );
+			_mm_storeu_ps( &result[i + 2].x, _mm_unpackhi_ps( c, s ) );
+		}
+	}
+#endif
+	for( ; i < count; ++i )
+		result[i] = nextVec2();
+}
+
+void Philox::fillVec3( vec3 *result, size_t count )
+{
+	size_t i = 0;
+#if defined( CINDER_PHILOX_SSE )
+	uint32_t values[PHILOX_FILL_CHUNK];
+	while( count - i >= 4 ) {
+		// each vector takes an angle and then a z value
+		const size_t n = std::min<size_t>( PHILOX_FILL_CHUNK, ( ( count - i ) & ~3 ) * 2 );
+		fillUint( values, n );
+		for( size_t v = 0; v < n; v += 8, i += 4 ) {
+			__m128i angleValues, zValues;
+			deinterleave4( values + v, &angleValues, &zValues );
+			__m128 s, c;
+			sinCosTurn4( angleValues, &s, &c );
+			const __m128 z = _mm_add_ps( _mm_mul_ps( unitFloat4( zValues ), _mm_set1_ps( 2.0f ) ), _mm_set1_ps( -1.0f ) );
+			const __m128 rho = _mm_sqrt_ps( _mm_sub_ps( _mm_set1_ps( 1.0f ), _mm_mul_ps( z, z ) ) );
+			float x[4], y[4], zs[4];
+			_mm_storeu_ps( x, _mm_mul_ps( rho, c ) );
+			_mm_storeu_ps( y, _mm_mul_ps( rho, s ) );
+			_mm_storeu_ps( zs, z );
+			for( int l = 0; l < 4; ++l )
+				result[i + l] = vec3( x[l], y[l], zs[l] );
+		}
+	}
+#endif
+	for( ; i < count; ++i )
+		result[i] = nextVec3();
+}
+
 } // ci
\ No newline at end of file
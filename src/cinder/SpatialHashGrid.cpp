@@ -0,0 +1,188 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cinder/SpatialHashGrid.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+using namespace std;
+
+// Builds and batched queries only use another thread for at least this many points
+#define SPATIAL_HASH_GRID_MIN_POINTS_PER_THREAD		16384
+// Points whose bounds span more cells than this per point are hashed rather than stored in a dense grid
+#define SPATIAL_HASH_GRID_MAX_CELLS_PER_POINT		4
+
+namespace cinder {
+
+namespace {
+
+size_t calcNumThreads( size_t numPoints, bool parallel )
+{
+	if( ! parallel )
+		return 1;
+
+	return std::max<size_t>( 1, std::min<size_t>( thread::hardware_concurrency(), numPoints / SPATIAL_HASH_GRID_MIN_POINTS_PER_THREAD ) );
+}
+
+// Calls fn( threadIndex, begin, end ) for numThreads ranges covering [0, count), on that many threads.
+template<typename Fn>
+void parallelFor( size_t numThreads, size_t count, const Fn &fn )
+{
+	vector<thread> threads;
+	for( size_t t = 1; t < numThreads; ++t )
+		threads.push_back( thread( fn, t, count * t / numThreads, count * ( t + 1 ) / numThreads ) );
+	fn( 0, 0, count / numThreads );
+	for( auto &t : threads )
+		t.join();
+}
+
+} // anonymous namespace
+
+template<int D, typename T>
+SpatialHashGrid<D, T>::SpatialHashGrid( T cellSize, uint32_t numBuckets )
+	: mCellSize( cellSize ), mInvCellSize( 1 / cellSize ), mFixedNumBuckets( numBuckets ), mNumBuckets( 1 ), mDense( false )
+{
+	mBucketStarts.assign( 2, 0 );
+}
+
+template<int D, typename T>
+void SpatialHashGrid<D, T>::build( const VecT *points, size_t numPoints, bool parallel )
+{
+	mInvCellSize = 1 / mCellSize;
+	mPoints.resize( numPoints );
+	mIndices.resize( numPoints );
+
+	// store the cells densely unless the points are so spread out that most cells would be empty
+	const size_t numThreads = calcNumThreads( numPoints, parallel );
+	mDense = false;
+	if( ! mFixedNumBuckets && numPoints ) {
+		vector<IVecT> threadMin( numThreads, IVecT( numeric_limits<int>::max() ) ), threadMax( numThreads, IVecT( numeric_limits<int>::min() ) );
+		parallelFor( numThreads, numPoints, [&]( size_t threadIndex, size_t begin, size_t end ) {
+			VecT min = points[begin], max = points[begin];
+			for( size_t i = begin + 1; i < end; ++i ) {
+				min = glm::min( min, points[i] );
+				max = glm::max( max, points[i] );
+			}
+			threadMin[threadIndex] = calcCell( min );
+			threadMax[threadIndex] = calcCell( max );
+		} );
+
+		mGridMin = threadMin[0];
+		IVecT gridMax = threadMax[0];
+		for( size_t t = 1; t < numThreads; ++t ) {
+			mGridMin = glm::min( mGridMin, threadMin[t] );
+			gridMax = glm::max( gridMax, threadMax[t] );
+		}
+
+		double numCells = 1;
+		for( int i = 0; i < D; ++i )
+			numCells *= double( gridMax[i] ) - mGridMin[i] + 1;
+		if( numCells <= std::max<double>( numPoints * SPATIAL_HASH_GRID_MAX_CELLS_PER_POINT, 4096 ) ) {
+			mDense = true;
+			mGridSize = gridMax - mGridMin + IVecT( 1 );
+			mNumBuckets = (uint32_t)numCells;
+		}
+	}
+
+	if( ! mDense ) {
+		mNumBuckets = 1;
+		while( mNumBuckets < ( mFixedNumBuckets ? mFixedNumBuckets : numPoints ) )
+			mNumBuckets *= 2;
+	}
+
+	// each thread counts the points of its range per bucket, and then scatters them behind those of the threads before it, which keeps
+	// the points of each bucket in their original order
+	vector<uint32_t> buckets( numPoints );
+	vector<uint32_t> offsets( numThreads * mNumBuckets, 0 );
+	parallelFor( numThreads, numPoints, [&]( size_t threadIndex, size_t begin, size_t end ) {
+		uint32_t *counts = &offsets[threadIndex * mNumBuckets];
+		for( size_t i = begin; i < end; ++i ) {
+			buckets[i] = calcBucket( calcCell( points[i] ) );
+			counts[buckets[i]]++;
+		}
+	} );
+
+	mBucketStarts.resize( mNumBuckets + 1 );
+	uint32_t total = 0;
+	for( uint32_t bucket = 0; bucket < mNumBuckets; ++bucket ) {
+		mBucketStarts[bucket] = total;
+		for( size_t t = 0; t < numThreads; ++t ) {
+			const uint32_t count = offsets[t * mNumBuckets + bucket];
+			offsets[t * mNumBuckets + bucket] = total;
+			total += count;
+		}
+	}
+	mBucketStarts[mNumBuckets] = total;
+
+	parallelFor( numThreads, numPoints, [&]( size_t threadIndex, size_t begin, size_t end ) {
+		uint32_t *next = &offsets[threadIndex * mNumBuckets];
+		for( size_t i = begin; i < end; ++i ) {
+			const uint32_t dest = next[buckets[i]]++;
+			mPoints[dest] = points[i];
+			mIndices[dest] = (uint32_t)i;
+		}
+	} );
+}
+
+template<int D, typename T>
+size_t SpatialHashGrid<D, T>::findWithinRadius( const VecT &p, T radius, uint32_t *indices, T *distancesSquared, size_t maxResults ) const
+{
+	size_t count = 0;
+	forEachWithinRadius( p, radius, [&]( uint32_t index, T distanceSquared ) {
+		if( count < maxResults ) {
+			if( indices )
+				indices[count] = index;
+			if( distancesSquared )
+				distancesSquared[count] = distanceSquared;
+		}
+		count++;
+	} );
+
+	return count;
+}
+
+template<int D, typename T>
+void SpatialHashGrid<D, T>::findWithinRadius( const VecT &p, T radius, std::vector<uint32_t> *indices, std::vector<T> *distancesSquared ) const
+{
+	forEachWithinRadius( p, radius, [&]( uint32_t index, T distanceSquared ) {
+		indices->push_back( index );
+		if( distancesSquared )
+			distancesSquared->push_back( distanceSquared );
+	} );
+}
+
+template<int D, typename T>
+void SpatialHashGrid<D, T>::findWithinRadius( const VecT *points, size_t numPoints, T radius, size_t maxResults, uint32_t *indices, T *distancesSquared, size_t *counts ) const
+{
+	parallelFor( calcNumThreads( numPoints, true ), numPoints, [=]( size_t /*threadIndex*/, size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			counts[i] = findWithinRadius( points[i], radius, indices + i * maxResults, distancesSquared ? distancesSquared + i * maxResults : nullptr, maxResults );
+	} );
+}
+
+template class SpatialHashGrid<2, float>;
+template class SpatialHashGrid<3, float>;
+
+} // namespace cinder
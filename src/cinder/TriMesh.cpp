@@ -24,6 +24,7 @@
 */
 
 #include "cinder/TriMesh.h"
+#include "cinder/TriMeshView.h"
 #include "cinder/Exception.h"
 #if defined( CINDER_ANDROID )
 	#include "cinder/android/CinderAndroid.h"
@@ -33,6 +34,55 @@ using namespace std;
 
 namespace cinder {
 
+namespace {
+
+// Returns whether the \a dims dimensional elements at \a indexA and \a indexB are within sqrt( \a tolerance2 ) of each other.
+bool attribsEqual( const float *data, uint8_t dims, uint32_t indexA, uint32_t indexB, float tolerance2 )
+{
+	float dist2 = 0;
+	for( uint8_t d = 0; d < dims; ++d ) {
+		float diff = data[indexA * dims + d] - data[indexB * dims + d];
+		dist2 += diff * diff;
+	}
+
+	return dist2 <= tolerance2;
+}
+
+// Moves the elements of the vertices that are mapped onto themselves by \a remap to the front of \a buffer, keeping their order, and discards the rest.
+template<typename T>
+void compactAttrib( vector<T> &buffer, size_t elementsPerVertex, const vector<uint32_t> &remap )
+{
+	if( buffer.size() < remap.size() * elementsPerVertex )
+		return;
+
+	size_t numUnique = 0;
+	for( size_t i = 0; i < remap.size(); ++i ) {
+		if( remap[i] != i )
+			continue;
+
+		if( numUnique != i )
+			copy( buffer.begin() + i * elementsPerVertex, buffer.begin() + ( i + 1 ) * elementsPerVertex, buffer.begin() + numUnique * elementsPerVertex );
+		++numUnique;
+	}
+
+	buffer.resize( numUnique * elementsPerVertex );
+}
+
+// Moves the elements of each vertex i of \a buffer to vertex \a remap[i].
+template<typename T>
+void remapAttrib( vector<T> &buffer, size_t elementsPerVertex, const vector<uint32_t> &remap )
+{
+	if( buffer.size() < remap.size() * elementsPerVertex )
+		return;
+
+	vector<T> remapped( buffer.size() );
+	for( size_t i = 0; i < remap.size(); ++i )
+		copy( buffer.begin() + i * elementsPerVertex, buffer.begin() + ( i + 1 ) * elementsPerVertex, remapped.begin() + remap[i] * elementsPerVertex );
+	buffer.swap( remapped );
+}
+
+} // anonymous namespace
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // TriMeshGeomTarget
 class TriMeshGeomTarget : public geom::Target {
@@ -448,6 +498,15 @@ AxisAlignedBox TriMesh::calcBoundingBox( const mat4 &transform ) const
 
 void TriMesh::read( const DataSourceRef &dataSource )
 {
+	// mesh cache files are decoded through a TriMeshView
+	if( TriMeshView::isTriMeshView( dataSource ) ) {
+		TriMeshView view( dataSource );
+		clear();
+		initFromFormat( formatFromSource( view ) );
+		loadFromSource( view );
+		return;
+	}
+
 	IStreamRef in = dataSource->createStream();
 
 	uint8_t versionNumber;
@@ -640,32 +699,19 @@ bool TriMesh::recalculateNormals( bool smooth, bool weighted )
 	size_t numPositions = mPositions.size() / 3;
 	mNormals.assign( numPositions, vec3() );
 
-	// for smooth renormalization, we first find all unique vertices and keep track of them
+	// for smooth renormalization, we first map all coincident vertices to a single unique vertex
 	std::vector<uint32_t> uniquePositions;
-	if( smooth ) {
-		uniquePositions.assign( numPositions, 0 );
-
-		for( uint32_t i = 0; i < numPositions; ++i ) {
-			if( uniquePositions[i] == 0 ) {
-				uniquePositions[i] = i + 1;
-				const vec3 &v0 = *(const vec3*)(&mPositions[i * 3]);
-				for( size_t j = i + 1; j < numPositions; ++j ) {
-					const vec3 &v1 = *(const vec3*)(&mPositions[j * 3]);
-					if( length2( v1 - v0 ) < FLT_EPSILON )
-						uniquePositions[j] = uniquePositions[i];
-				}
-			}
-		}
-	}
+	if( smooth )
+		geom::calculateWeldMap( numPositions, reinterpret_cast<const vec3*>( mPositions.data() ), sqrt( FLT_EPSILON ), &uniquePositions );
 
 	// perform surface normalization
 	uint32_t index0, index1, index2;
 	size_t numTriangles = getNumTriangles();
 	for( size_t i = 0; i < numTriangles; ++i ) {
 		if( smooth ) {
-			index0 = uniquePositions[mIndices[i * 3 + 0]] - 1;
-			index1 = uniquePositions[mIndices[i * 3 + 1]] - 1;
-			index2 = uniquePositions[mIndices[i * 3 + 2]] - 1;
+			index0 = uniquePositions[mIndices[i * 3 + 0]];
+			index1 = uniquePositions[mIndices[i * 3 + 1]];
+			index2 = uniquePositions[mIndices[i * 3 + 2]];
 		}
 		else {
 			index0 = mIndices[i*3+0];
@@ -707,7 +753,7 @@ bool TriMesh::recalculateNormals( bool smooth, bool weighted )
 	// copy normals to corresponding non-unique vertices
 	if( smooth ) {
 		for( size_t i = 0; i < numPositions; ++i ) {
-			mNormals[i] = mNormals[uniquePositions[i]-1];
+			mNormals[i] = mNormals[uniquePositions[i]];
 		}
 	}
 
@@ -727,10 +773,31 @@ bool TriMesh::recalculateTangents()
 
 	mTangents.clear();
 
+	const size_t numVertices = mPositions.size() / 3;
 	const vec3 *positions = reinterpret_cast<const vec3*>( mPositions.data() );
 	const vec3 *normals = reinterpret_cast<const vec3*>( mNormals.data() );
 	const vec2 *texCoords = reinterpret_cast<const vec2*>( mTexCoords0.data() );
-	geom::calculateTangents( mIndices.size(), mIndices.data(), mPositions.size() / 3, positions, normals, texCoords, &mTangents, nullptr );
+
+	// vertices that have been split but share their position, normal and texture coordinate accumulate their tangents together
+	std::vector<uint32_t> uniqueVertices;
+	size_t numUnique = geom::calculateWeldMap( numVertices, positions, sqrt( FLT_EPSILON ), &uniqueVertices, [=]( uint32_t a, uint32_t b ) {
+		return distance2( normals[a], normals[b] ) <= FLT_EPSILON && distance2( texCoords[a], texCoords[b] ) <= FLT_EPSILON;
+	} );
+
+	if( numUnique == numVertices ) {
+		geom::calculateTangents( mIndices.size(), mIndices.data(), numVertices, positions, normals, texCoords, &mTangents, nullptr );
+	}
+	else {
+		std::vector<uint32_t> uniqueIndices( mIndices.size() );
+		for( size_t i = 0; i < mIndices.size(); ++i )
+			uniqueIndices[i] = uniqueVertices[mIndices[i]];
+
+		geom::calculateTangents( uniqueIndices.size(), uniqueIndices.data(), numVertices, positions, normals, texCoords, &mTangents, nullptr );
+
+		// copy tangents to corresponding non-unique vertices
+		for( size_t i = 0; i < numVertices; ++i )
+			mTangents[i] = mTangents[uniqueVertices[i]];
+	}
 
 	mTangentsDims = 3;
 
@@ -754,6 +821,141 @@ bool TriMesh::recalculateBitangents()
 	return true;
 }
 
+size_t TriMesh::weldVertices( float tolerance, bool positionsOnly )
+{
+	// requires valid indices and 3D vertices
+	if( mIndices.empty() || mPositions.empty() || mPositionsDims != 3 )
+		return 0;
+
+	const size_t numVertices = getNumVertices();
+	const vec3 *positions = reinterpret_cast<const vec3*>( mPositions.data() );
+
+	std::vector<uint32_t> uniqueVertices;
+	size_t numUnique;
+	if( positionsOnly )
+		numUnique = geom::calculateWeldMap( numVertices, positions, tolerance, &uniqueVertices );
+	else {
+		numUnique = geom::calculateWeldMap( numVertices, positions, tolerance, &uniqueVertices, [this, tolerance]( uint32_t a, uint32_t b ) {
+			return verticesEqual( a, b, tolerance );
+		} );
+	}
+
+	if( numUnique == numVertices )
+		return 0;
+
+	for( auto &index : mIndices )
+		index = uniqueVertices[index];
+	compactVertices( uniqueVertices );
+
+	return numVertices - numUnique;
+}
+
+float TriMesh::simplify( size_t numTriangles, float maxError )
+{
+	// requires valid indices and 3D vertices
+	if( mIndices.empty() || mPositions.empty() || mPositionsDims != 3 )
+		return 0;
+
+	const size_t numVertices = getNumVertices();
+	std::vector<uint32_t> simplified;
+	float error;
+	geom::calculateSimplifiedIndices( mIndices.size(), mIndices.data(), numVertices, reinterpret_cast<const vec3*>( mPositions.data() ), numTriangles * 3, maxError, &simplified, &error );
+	mIndices.swap( simplified );
+
+	// keep the vertices that are still referenced
+	std::vector<uint32_t> remap( numVertices, std::numeric_limits<uint32_t>::max() );
+	for( auto index : mIndices )
+		remap[index] = index;
+	compactVertices( remap );
+
+	return error;
+}
+
+std::vector<TriMeshRef> TriMesh::createLods( const std::vector<size_t> &numTriangles, float maxError ) const
+{
+	std::vector<TriMeshRef> result;
+	const TriMesh *previous = this;
+	for( size_t lodTriangles : numTriangles ) {
+		TriMeshRef lod( new TriMesh( *previous ) );
+		lod->simplify( lodTriangles, maxError );
+		result.push_back( lod );
+		previous = lod.get();
+	}
+
+	return result;
+}
+
+void TriMesh::optimizeVertexCache()
+{
+	if( mIndices.empty() )
+		return;
+
+	std::vector<uint32_t> optimized;
+	geom::calculateVertexCacheOptimizedIndices( mIndices.size(), mIndices.data(), getNumVertices(), &optimized );
+	mIndices.swap( optimized );
+}
+
+void TriMesh::optimizeOverdraw( float threshold )
+{
+	// requires valid indices and 3D vertices
+	if( mIndices.empty() || mPositions.empty() || mPositionsDims != 3 )
+		return;
+
+	std::vector<uint32_t> optimized;
+	geom::calculateOverdrawOptimizedIndices( mIndices.size(), mIndices.data(), getNumVertices(), reinterpret_cast<const vec3*>( mPositions.data() ), threshold, &optimized );
+	mIndices.swap( optimized );
+}
+
+void TriMesh::optimizeVertexFetch()
+{
+	if( mIndices.empty() )
+		return;
+
+	std::vector<uint32_t> remap;
+	geom::calculateVertexFetchRemap( mIndices.size(), mIndices.data(), getNumVertices(), &remap );
+	for( auto &index : mIndices )
+		index = remap[index];
+
+	remapAttrib( mPositions, mPositionsDims, remap );
+	remapAttrib( mColors, mColorsDims, remap );
+	remapAttrib( mNormals, 1, remap );
+	remapAttrib( mTangents, 1, remap );
+	remapAttrib( mBitangents, 1, remap );
+	remapAttrib( mTexCoords0, mTexCoords0Dims, remap );
+	remapAttrib( mTexCoords1, mTexCoords1Dims, remap );
+	remapAttrib( mTexCoords2, mTexCoords2Dims, remap );
+	remapAttrib( mTexCoords3, mTexCoords3Dims, remap );
+}
+
+geom::VertexCacheStats TriMesh::calcVertexCacheStats( size_t cacheSize ) const
+{
+	return geom::calculateVertexCacheStats( mIndices.size(), mIndices.data(), getNumVertices(), cacheSize );
+}
+
+void TriMesh::compactVertices( const std::vector<uint32_t> &remap )
+{
+	const size_t numVertices = remap.size();
+
+	// kept vertices keep their order, so their new index is the number of kept vertices that precede them
+	std::vector<uint32_t> newIndices( numVertices );
+	uint32_t nextIndex = 0;
+	for( size_t i = 0; i < numVertices; ++i )
+		newIndices[i] = ( remap[i] == i ) ? nextIndex++ : 0;
+
+	for( auto &index : mIndices )
+		index = newIndices[index];
+
+	compactAttrib( mPositions, mPositionsDims, remap );
+	compactAttrib( mColors, mColorsDims, remap );
+	compactAttrib( mNormals, 1, remap );
+	compactAttrib( mTangents, 1, remap );
+	compactAttrib( mBitangents, 1, remap );
+	compactAttrib( mTexCoords0, mTexCoords0Dims, remap );
+	compactAttrib( mTexCoords1, mTexCoords1Dims, remap );
+	compactAttrib( mTexCoords2, mTexCoords2Dims, remap );
+	compactAttrib( mTexCoords3, mTexCoords3Dims, remap );
+}
+
 //! TODO: optimize memory allocations
 void TriMesh::subdivide( int division, bool normalize )
 {
@@ -1097,138 +1299,33 @@ void TriMesh::copyAttrib( geom::Attrib attr, uint8_t dims, size_t stride, const
 	}
 }
 
-bool TriMesh::verticesEqual( uint32_t indexA, uint32_t indexB ) const
+bool TriMesh::verticesEqual( uint32_t indexA, uint32_t indexB, float tolerance ) const
 {
 	const size_t numPositions = getNumVertices();
 
 	if( indexA >= numPositions || indexB >= numPositions )
 		return false;
 
-	// positions
-	const vec3 &a = *reinterpret_cast<const vec3*>(&mPositions[indexA*mPositionsDims]);
-	const vec3 &b = *reinterpret_cast<const vec3*>(&mPositions[indexB*mPositionsDims]);
-	if( distance2( a, b ) > FLT_EPSILON )
-		return false;
-
-	if( mColorsDims > 0 ) {
-		if( mColorsDims == 3 ) {
-			const vec3 &a = *reinterpret_cast<const vec3*>(&mColors[indexA*mColorsDims]);
-			const vec3 &b = *reinterpret_cast<const vec3*>(&mColors[indexB*mColorsDims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-		else if( mColorsDims == 4 ) {
-			const vec4 &a = *reinterpret_cast<const vec4*>(&mColors[indexA*mColorsDims]);
-			const vec4 &b = *reinterpret_cast<const vec4*>(&mColors[indexB*mColorsDims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-	}
+	const float tolerance2 = tolerance * tolerance;
 
-	if( mNormalsDims > 0 ) {
-		const vec3 &a = *reinterpret_cast<const vec3*>(&mNormals[indexA*mNormalsDims]);
-		const vec3 &b = *reinterpret_cast<const vec3*>(&mNormals[indexB*mNormalsDims]);
-		if( distance2( a, b ) > FLT_EPSILON )
+	if( ! attribsEqual( mPositions.data(), mPositionsDims, indexA, indexB, tolerance2 ) )
 		return false;
-	}
-
-	if( mTexCoords0Dims > 0 ) {
-		if( mTexCoords0Dims == 2 ) {
-			const vec2 &a = *reinterpret_cast<const vec2*>(&mTexCoords0[indexA*mTexCoords0Dims]);
-			const vec2 &b = *reinterpret_cast<const vec2*>(&mTexCoords0[indexB*mTexCoords0Dims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-		else if( mTexCoords0Dims == 3 ) {
-			const vec3 &a = *reinterpret_cast<const vec3*>(&mTexCoords0[indexA*mTexCoords0Dims]);
-			const vec3 &b = *reinterpret_cast<const vec3*>(&mTexCoords0[indexB*mTexCoords0Dims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-		else if( mTexCoords0Dims == 4 ) {
-			const vec4 &a = *reinterpret_cast<const vec4*>(&mTexCoords0[indexA*mTexCoords0Dims]);
-			const vec4 &b = *reinterpret_cast<const vec4*>(&mTexCoords0[indexB*mTexCoords0Dims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-	}
-
-	if( mTexCoords1Dims > 0 ) {
-		if( mTexCoords1Dims == 2 ) {
-			const vec2 &a = *reinterpret_cast<const vec2*>(&mTexCoords1[indexA*mTexCoords1Dims]);
-			const vec2 &b = *reinterpret_cast<const vec2*>(&mTexCoords1[indexB*mTexCoords1Dims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-		else if( mTexCoords1Dims == 3 ) {
-			const vec3 &a = *reinterpret_cast<const vec3*>(&mTexCoords1[indexA*mTexCoords1Dims]);
-			const vec3 &b = *reinterpret_cast<const vec3*>(&mTexCoords1[indexB*mTexCoords1Dims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-		else if( mTexCoords1Dims == 4 ) {
-			const vec4 &a = *reinterpret_cast<const vec4*>(&mTexCoords1[indexA*mTexCoords1Dims]);
-			const vec4 &b = *reinterpret_cast<const vec4*>(&mTexCoords1[indexB*mTexCoords1Dims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-	}
-
-	if( mTexCoords2Dims > 0 ) {
-		if( mTexCoords2Dims == 2 ) {
-			const vec2 &a = *reinterpret_cast<const vec2*>(&mTexCoords2[indexA*mTexCoords2Dims]);
-			const vec2 &b = *reinterpret_cast<const vec2*>(&mTexCoords2[indexB*mTexCoords2Dims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-		else if( mTexCoords2Dims == 3 ) {
-			const vec3 &a = *reinterpret_cast<const vec3*>(&mTexCoords2[indexA*mTexCoords2Dims]);
-			const vec3 &b = *reinterpret_cast<const vec3*>(&mTexCoords2[indexB*mTexCoords2Dims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-		else if( mTexCoords2Dims == 4 ) {
-			const vec4 &a = *reinterpret_cast<const vec4*>(&mTexCoords2[indexA*mTexCoords2Dims]);
-			const vec4 &b = *reinterpret_cast<const vec4*>(&mTexCoords2[indexB*mTexCoords2Dims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-	}
-
-	if( mTexCoords3Dims > 0 ) {
-		if( mTexCoords3Dims == 2 ) {
-			const vec2 &a = *reinterpret_cast<const vec2*>(&mTexCoords3[indexA*mTexCoords3Dims]);
-			const vec2 &b = *reinterpret_cast<const vec2*>(&mTexCoords3[indexB*mTexCoords3Dims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-		else if( mTexCoords3Dims == 3 ) {
-			const vec3 &a = *reinterpret_cast<const vec3*>(&mTexCoords3[indexA*mTexCoords3Dims]);
-			const vec3 &b = *reinterpret_cast<const vec3*>(&mTexCoords3[indexB*mTexCoords3Dims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-		else if( mTexCoords3Dims == 4 ) {
-			const vec4 &a = *reinterpret_cast<const vec4*>(&mTexCoords3[indexA*mTexCoords3Dims]);
-			const vec4 &b = *reinterpret_cast<const vec4*>(&mTexCoords3[indexB*mTexCoords3Dims]);
-			if( distance2( a, b ) > FLT_EPSILON )
-			return false;
-		}
-	}
-
-	if( mTangentsDims > 0 ) {
-		const vec3 &a = *reinterpret_cast<const vec3*>(&mTangents[indexA*mTangentsDims]);
-		const vec3 &b = *reinterpret_cast<const vec3*>(&mTangents[indexB*mTangentsDims]);
-		if( distance2( a, b ) > FLT_EPSILON )
+	if( ! attribsEqual( mColors.data(), mColorsDims, indexA, indexB, tolerance2 ) )
 		return false;
-	}
-
-	if( mBitangentsDims > 0 ) {
-		const vec3 &a = *reinterpret_cast<const vec3*>(&mBitangents[indexA*mBitangentsDims]);
-		const vec3 &b = *reinterpret_cast<const vec3*>(&mBitangents[indexB*mBitangentsDims]);
-		if( distance2( a, b ) > FLT_EPSILON )
+	if( ! attribsEqual( (const float*)mNormals.data(), mNormalsDims, indexA, indexB, tolerance2 ) )
+		return false;
+	if( ! attribsEqual( (const float*)mTangents.data(), mTangentsDims, indexA, indexB, tolerance2 ) )
+		return false;
+	if( ! attribsEqual( (const float*)mBitangents.data(), mBitangentsDims, indexA, indexB, tolerance2 ) )
+		return false;
+	if( ! attribsEqual( mTexCoords0.data(), mTexCoords0Dims, indexA, indexB, tolerance2 ) )
+		return false;
+	if( ! attribsEqual( mTexCoords1.data(), mTexCoords1Dims, indexA, indexB, tolerance2 ) )
+		return false;
+	if( ! attribsEqual( mTexCoords2.data(), mTexCoords2Dims, indexA, indexB, tolerance2 ) )
+		return false;
+	if( ! attribsEqual( mTexCoords3.data(), mTexCoords3Dims, indexA, indexB, tolerance2 ) )
 		return false;
-	}
 
 	// TODO: bone index and weight
 
@@ -0,0 +1,662 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cinder/TriMeshView.h"
+#include "cinder/TriMesh.h"
+
+#include <cstring>
+using namespace std;
+
+#define TRIMESH_VIEW_VERSION		1
+#define TRIMESH_VIEW_ALIGNMENT		16
+#define TRIMESH_VIEW_BYTE_ORDER		0x01020304
+
+namespace cinder {
+
+namespace {
+
+const char sSignature[8] = { 'C', 'I', 'M', 'E', 'S', 'H', 0x1A, '\n' };
+
+const geom::Attrib sAttribs[] = { geom::POSITION, geom::COLOR, geom::TEX_COORD_0, geom::TEX_COORD_1, geom::TEX_COORD_2, geom::TEX_COORD_3,
+									geom::NORMAL, geom::TANGENT, geom::BITANGENT };
+
+inline size_t alignOffset( size_t offset )
+{
+	return ( offset + TRIMESH_VIEW_ALIGNMENT - 1 ) & ~size_t( TRIMESH_VIEW_ALIGNMENT - 1 );
+}
+
+// Returns the size in bytes of \a numVertices values of \a dims components stored with \a encoding.
+size_t calcAttribSize( TriMeshView::Encoding encoding, uint8_t dims, size_t numVertices )
+{
+	switch( encoding ) {
+		case TriMeshView::Encoding::NONE: return numVertices * dims * sizeof( float );
+		case TriMeshView::Encoding::UNORM16: return numVertices * dims * sizeof( uint16_t );
+		case TriMeshView::Encoding::OCTAHEDRAL16: return numVertices * 2 * sizeof( int16_t );
+		default: return 0;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Octahedral unit vectors
+
+inline float signNotZero( float v )
+{
+	return ( v >= 0 ) ? 1.0f : -1.0f;
+}
+
+void encodeOctahedral( const vec3 &v, int16_t *result )
+{
+	const float l1 = fabs( v.x ) + fabs( v.y ) + fabs( v.z );
+	vec2 p = ( l1 > 0 ) ? vec2( v.x, v.y ) / l1 : vec2( 0 );
+	if( v.z < 0 )
+		p = ( 1.0f - vec2( fabs( p.y ), fabs( p.x ) ) ) * vec2( signNotZero( p.x ), signNotZero( p.y ) );
+
+	result[0] = (int16_t)lround( glm::clamp( p.x, -1.0f, 1.0f ) * 32767.0f );
+	result[1] = (int16_t)lround( glm::clamp( p.y, -1.0f, 1.0f ) * 32767.0f );
+}
+
+vec3 decodeOctahedral( const int16_t *encoded )
+{
+	vec3 v( std::max( encoded[0] / 32767.0f, -1.0f ), std::max( encoded[1] / 32767.0f, -1.0f ), 0 );
+	v.z = 1.0f - fabs( v.x ) - fabs( v.y );
+	const float t = std::max( -v.z, 0.0f );
+	v.x += ( v.x >= 0 ) ? -t : t;
+	v.y += ( v.y >= 0 ) ? -t : t;
+	return normalize( v );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Index codec
+//
+// Each triangle starts with a code byte. The high nibble refers to one of the 15 most recent edges if the triangle shares it
+// (in the opposite direction), or is 15 if it shares none. For triangles that share an edge, the low nibble describes the third vertex:
+// 0 if it is the next vertex that hasn't been used yet, 1 to 14 for one of the 14 most recently added vertices, or 15 if it follows
+// explicitly. Explicit vertices are zigzag-encoded varints relative to the previous explicit vertex. Triangles without a shared edge
+// are followed by all three vertices explicitly.
+
+class IndexCodecState {
+  public:
+	IndexCodecState()
+		: mEdgeOffset( 0 ), mVertexOffset( 0 ), mNext( 0 ), mLast( 0 )
+	{
+		memset( mEdges, 0xFF, sizeof( mEdges ) );
+		memset( mVertices, 0xFF, sizeof( mVertices ) );
+	}
+
+	// Returns how many edges ago the edge \a a -> \a b was pushed, or -1 if it isn't among the 15 most recent ones.
+	int findEdge( uint32_t a, uint32_t b ) const
+	{
+		for( int i = 0; i < 15; ++i ) {
+			const uint32_t *edge = mEdges[( mEdgeOffset - 1 - i ) & 15];
+			if( edge[0] == a && edge[1] == b )
+				return i;
+		}
+		return -1;
+	}
+
+	// Returns how many vertices ago \a v was pushed, or -1 if it isn't among the 14 most recent ones.
+	int findVertex( uint32_t v ) const
+	{
+		for( int i = 0; i < 14; ++i ) {
+			if( mVertices[( mVertexOffset - 1 - i ) & 15] == v )
+				return i;
+		}
+		return -1;
+	}
+
+	const uint32_t*	getEdge( int i ) const		{ return mEdges[( mEdgeOffset - 1 - i ) & 15]; }
+	uint32_t		getVertex( int i ) const	{ return mVertices[( mVertexOffset - 1 - i ) & 15]; }
+	uint32_t		getNext() const				{ return mNext; }
+	uint32_t		getLast() const				{ return mLast; }
+
+	void pushEdge( uint32_t a, uint32_t b )
+	{
+		mEdges[mEdgeOffset][0] = a;
+		mEdges[mEdgeOffset][1] = b;
+		mEdgeOffset = ( mEdgeOffset + 1 ) & 15;
+	}
+
+	void pushExplicitVertex( uint32_t v )
+	{
+		mLast = v;
+		pushVertex( v );
+	}
+
+	void pushVertex( uint32_t v )
+	{
+		mVertices[mVertexOffset] = v;
+		mVertexOffset = ( mVertexOffset + 1 ) & 15;
+	}
+
+	void updateNext( uint32_t a, uint32_t b, uint32_t c )
+	{
+		mNext = std::max( mNext, std::max( a, std::max( b, c ) ) + 1 );
+	}
+
+  private:
+	uint32_t	mEdges[16][2];
+	uint32_t	mVertices[16];
+	int			mEdgeOffset, mVertexOffset;
+	uint32_t	mNext, mLast;
+};
+
+void writeVarint( vector<uint8_t> *result, uint32_t value )
+{
+	while( value >= 0x80 ) {
+		result->push_back( uint8_t( value | 0x80 ) );
+		value >>= 7;
+	}
+	result->push_back( uint8_t( value ) );
+}
+
+void writeVertex( vector<uint8_t> *result, uint32_t v, uint32_t last )
+{
+	const int32_t delta = int32_t( v - last );
+	writeVarint( result, ( uint32_t( delta ) << 1 ) ^ uint32_t( delta >> 31 ) );
+}
+
+uint32_t readVertex( const uint8_t *&p, const uint8_t *end, uint32_t last )
+{
+	uint32_t zigzag = 0;
+	for( int shift = 0; ; shift += 7 ) {
+		if( p == end || shift > 28 )
+			throw ExcTriMeshView( "corrupt index data" );
+		const uint8_t byte = *p++;
+		zigzag |= uint32_t( byte & 0x7F ) << shift;
+		if( ! ( byte & 0x80 ) )
+			break;
+	}
+
+	return last + ( ( zigzag >> 1 ) ^ ( 0 - ( zigzag & 1 ) ) );
+}
+
+vector<uint8_t> encodeIndices( const uint32_t *indices, size_t numIndices )
+{
+	vector<uint8_t> result;
+	result.reserve( numIndices + 16 );
+
+	IndexCodecState state;
+	for( size_t i = 0; i + 2 < numIndices; i += 3 ) {
+		const uint32_t tri[3] = { indices[i], indices[i + 1], indices[i + 2] };
+
+		// look for a rotation of the triangle whose first edge was pushed in the opposite direction by a previous triangle
+		int rotation = 0, edge = -1;
+		for( ; rotation < 3; ++rotation ) {
+			edge = state.findEdge( tri[( rotation + 1 ) % 3], tri[rotation] );
+			if( edge >= 0 )
+				break;
+		}
+
+		if( edge >= 0 ) {
+			const uint32_t a = tri[rotation], b = tri[( rotation + 1 ) % 3], c = tri[( rotation + 2 ) % 3];
+			const int cached = state.findVertex( c );
+			if( c == state.getNext() ) {
+				result.push_back( uint8_t( edge << 4 ) );
+				state.pushVertex( c );
+			}
+			else if( cached >= 0 )
+				result.push_back( uint8_t( ( edge << 4 ) | ( cached + 1 ) ) );
+			else {
+				result.push_back( uint8_t( ( edge << 4 ) | 15 ) );
+				writeVertex( &result, c, state.getLast() );
+				state.pushExplicitVertex( c );
+			}
+
+			state.pushEdge( b, c );
+			state.pushEdge( c, a );
+			state.updateNext( a, b, c );
+		}
+		else {
+			result.push_back( 0xFF );
+			for( int v = 0; v < 3; ++v ) {
+				writeVertex( &result, tri[v], state.getLast() );
+				state.pushExplicitVertex( tri[v] );
+			}
+
+			state.pushEdge( tri[0], tri[1] );
+			state.pushEdge( tri[1], tri[2] );
+			state.pushEdge( tri[2], tri[0] );
+			state.updateNext( tri[0], tri[1], tri[2] );
+		}
+	}
+
+	return result;
+}
+
+void decodeIndicesImpl( const uint8_t *data, size_t dataSize, size_t numIndices, uint32_t numVertices, uint32_t *result )
+{
+	const uint8_t *p = data, *end = data + dataSize;
+
+	IndexCodecState state;
+	for( size_t i = 0; i + 2 < numIndices; i += 3 ) {
+		if( p == end )
+			throw ExcTriMeshView( "corrupt index data" );
+
+		const uint8_t code = *p++;
+		const int edge = code >> 4, vertex = code & 15;
+		uint32_t a, b, c;
+
+		if( edge < 15 ) {
+			// the shared edge was pushed as b -> a
+			const uint32_t *shared = state.getEdge( edge );
+			a = shared[1];
+			b = shared[0];
+			if( vertex == 0 ) {
+				c = state.getNext();
+				state.pushVertex( c );
+			}
+			else if( vertex < 15 )
+				c = state.getVertex( vertex - 1 );
+			else {
+				c = readVertex( p, end, state.getLast() );
+				state.pushExplicitVertex( c );
+			}
+
+			state.pushEdge( b, c );
+			state.pushEdge( c, a );
+		}
+		else {
+			a = readVertex( p, end, state.getLast() );
+			state.pushExplicitVertex( a );
+			b = readVertex( p, end, state.getLast() );
+			state.pushExplicitVertex( b );
+			c = readVertex( p, end, state.getLast() );
+			state.pushExplicitVertex( c );
+			state.pushEdge( a, b );
+			state.pushEdge( b, c );
+			state.pushEdge( c, a );
+		}
+
+		if( a >= numVertices || b >= numVertices || c >= numVertices )
+			throw ExcTriMeshView( "corrupt index data" );
+
+		state.updateNext( a, b, c );
+		result[i] = a;
+		result[i + 1] = b;
+		result[i + 2] = c;
+	}
+}
+
+void writePadding( const OStreamRef &out, size_t *offset )
+{
+	static const uint8_t zeros[TRIMESH_VIEW_ALIGNMENT] = { 0 };
+	const size_t aligned = alignOffset( *offset );
+	if( aligned > *offset )
+		out->writeData( zeros, aligned - *offset );
+	*offset = aligned;
+}
+
+} // anonymous namespace
+
+TriMeshView::TriMeshView( const DataSourceRef &dataSource )
+	: mData( nullptr ), mDataSize( 0 ), mHeader( nullptr ), mAttribs( nullptr )
+{
+	if( dataSource->isFilePath() ) {
+		try {
+			mMappedFile = MemoryMappedFile::create( dataSource->getFilePath() );
+			mData = (const uint8_t*)mMappedFile->getData();
+			mDataSize = mMappedFile->getSize();
+		}
+		catch( ExcMemoryMappedFile & ) {
+		}
+	}
+
+	if( ! mMappedFile ) {
+		mBuffer = dataSource->getBuffer();
+		mData = (const uint8_t*)mBuffer->getData();
+		mDataSize = mBuffer->getSize();
+	}
+
+	// validate the header and the location of every array, so that the accessors can trust them
+	if( mDataSize < sizeof( Header ) || memcmp( mData, sSignature, sizeof( sSignature ) ) != 0 )
+		throw ExcTriMeshView( "not a mesh cache file" );
+
+	mHeader = reinterpret_cast<const Header*>( mData );
+	if( mHeader->mByteOrderMark != TRIMESH_VIEW_BYTE_ORDER )
+		throw ExcTriMeshView( "unsupported byte order" );
+	if( mHeader->mVersion > TRIMESH_VIEW_VERSION )
+		throw ExcTriMeshView( "unsupported version " + to_string( mHeader->mVersion ) );
+
+	const size_t tableOffset = alignOffset( sizeof( Header ) );
+	if( tableOffset + (uint64_t)mHeader->mNumAttribs * sizeof( AttribEntry ) > mDataSize )
+		throw ExcTriMeshView( "truncated attribute table" );
+	mAttribs = reinterpret_cast<const AttribEntry*>( mData + tableOffset );
+
+	auto isInside = [this]( uint64_t offset, uint64_t size ) {
+		return offset % TRIMESH_VIEW_ALIGNMENT == 0 && offset <= mDataSize && size <= mDataSize - offset;
+	};
+
+	for( uint32_t a = 0; a < mHeader->mNumAttribs; ++a ) {
+		const AttribEntry &entry = mAttribs[a];
+		const Encoding encoding = (Encoding)entry.mEncoding;
+		if( entry.mAttrib >= geom::NUM_ATTRIBS || entry.mDims < 1 || entry.mDims > 4 || ( encoding == Encoding::OCTAHEDRAL16 && entry.mDims != 3 ) )
+			throw ExcTriMeshView( "invalid attribute" );
+		if( encoding == Encoding::COMPRESSED || entry.mSize != calcAttribSize( encoding, entry.mDims, mHeader->mNumVertices ) || ! isInside( entry.mOffset, entry.mSize ) )
+			throw ExcTriMeshView( "invalid data for attribute " + geom::attribToString( (geom::Attrib)entry.mAttrib ) );
+	}
+
+	const Encoding indexEncoding = getIndexEncoding();
+	if( indexEncoding != Encoding::NONE && indexEncoding != Encoding::COMPRESSED )
+		throw ExcTriMeshView( "invalid index encoding" );
+	if( ( indexEncoding == Encoding::NONE && mHeader->mIndexSize != (uint64_t)mHeader->mNumIndices * getIndexBytes() ) || ! isInside( mHeader->mIndexOffset, mHeader->mIndexSize ) )
+		throw ExcTriMeshView( "invalid index data" );
+}
+
+bool TriMeshView::isTriMeshView( const DataSourceRef &dataSource )
+{
+	IStreamRef in = dataSource->createStream();
+	char signature[sizeof( sSignature )];
+	return in->readDataAvailable( signature, sizeof( signature ) ) == sizeof( signature ) && memcmp( signature, sSignature, sizeof( sSignature ) ) == 0;
+}
+
+void TriMeshView::write( const DataTargetRef &dataTarget, const geom::Source &source, const Format &format )
+{
+	// anything other than a TriMesh is converted to one first
+	unique_ptr<TriMesh> converted;
+	const TriMesh *mesh = dynamic_cast<const TriMesh*>( &source );
+	if( ! mesh ) {
+		converted.reset( new TriMesh( source, TriMesh::formatFromSource( source ) ) );
+		mesh = converted.get();
+	}
+
+	const size_t numVertices = mesh->getNumVertices();
+	const vector<uint32_t> &indices = mesh->getIndices();
+
+	Header header;
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.mSignature, sSignature, sizeof( sSignature ) );
+	header.mVersion = TRIMESH_VIEW_VERSION;
+	header.mByteOrderMark = TRIMESH_VIEW_BYTE_ORDER;
+	header.mNumVertices = (uint32_t)numVertices;
+	header.mNumIndices = (uint32_t)indices.size();
+
+	// bounding box of the positions
+	const uint8_t positionDims = mesh->getAttribDims( geom::POSITION );
+	const float *positions = mesh->getBufferPositions().data();
+	for( uint8_t d = 0; d < std::min<uint8_t>( positionDims, 3 ); ++d ) {
+		header.mBoundsMin[d] = numVertices ? numeric_limits<float>::max() : 0;
+		header.mBoundsMax[d] = numVertices ? -numeric_limits<float>::max() : 0;
+		for( size_t v = 0; v < numVertices; ++v ) {
+			header.mBoundsMin[d] = std::min( header.mBoundsMin[d], positions[v * positionDims + d] );
+			header.mBoundsMax[d] = std::max( header.mBoundsMax[d], positions[v * positionDims + d] );
+		}
+	}
+
+	// encode the attributes that need it, the others are written straight from the TriMesh
+	struct Array {
+		AttribEntry		mEntry;
+		const void*		mData;
+		vector<uint8_t>	mEncoded;
+	};
+
+	vector<Array> arrays;
+	for( geom::Attrib attr : sAttribs ) {
+		const uint8_t dims = mesh->getAttribDims( attr );
+		if( ! dims || ! numVertices )
+			continue;
+
+		const float *data;
+		switch( attr ) {
+			case geom::POSITION: data = mesh->getBufferPositions().data(); break;
+			case geom::COLOR: data = mesh->getBufferColors().data(); break;
+			case geom::TEX_COORD_0: data = mesh->getBufferTexCoords0().data(); break;
+			case geom::TEX_COORD_1: data = mesh->getBufferTexCoords1().data(); break;
+			case geom::TEX_COORD_2: data = mesh->getBufferTexCoords2().data(); break;
+			case geom::TEX_COORD_3: data = mesh->getBufferTexCoords3().data(); break;
+			case geom::NORMAL: data = (const float*)mesh->getNormals().data(); break;
+			case geom::TANGENT: data = (const float*)mesh->getTangents().data(); break;
+			case geom::BITANGENT: data = (const float*)mesh->getBitangents().data(); break;
+			default: continue;
+		}
+
+		Array array;
+		memset( &array.mEntry, 0, sizeof( array.mEntry ) );
+		array.mEntry.mAttrib = (uint32_t)attr;
+		array.mEntry.mDims = dims;
+		array.mData = data;
+
+		const bool isDirection = ( attr == geom::NORMAL || attr == geom::TANGENT || attr == geom::BITANGENT );
+		if( attr == geom::POSITION && format.getQuantizePositions() ) {
+			array.mEntry.mEncoding = (uint8_t)Encoding::UNORM16;
+			for( uint8_t d = 0; d < dims; ++d ) {
+				float minValue = data[d], maxValue = data[d];
+				for( size_t v = 1; v < numVertices; ++v ) {
+					minValue = std::min( minValue, data[v * dims + d] );
+					maxValue = std::max( maxValue, data[v * dims + d] );
+				}
+				array.mEntry.mScale[d] = ( maxValue - minValue ) / 65535.0f;
+				array.mEntry.mBias[d] = minValue;
+			}
+
+			array.mEncoded.resize( calcAttribSize( Encoding::UNORM16, dims, numVertices ) );
+			uint16_t *encoded = (uint16_t*)array.mEncoded.data();
+			for( size_t i = 0; i < numVertices * dims; ++i ) {
+				const uint8_t d = i % dims;
+				const float scale = array.mEntry.mScale[d];
+				encoded[i] = ( scale > 0 ) ? (uint16_t)glm::clamp<long>( lround( ( data[i] - array.mEntry.mBias[d] ) / scale ), 0, 65535 ) : 0;
+			}
+		}
+		else if( isDirection && dims == 3 && format.getQuantizeNormals() ) {
+			array.mEntry.mEncoding = (uint8_t)Encoding::OCTAHEDRAL16;
+			array.mEncoded.resize( calcAttribSize( Encoding::OCTAHEDRAL16, dims, numVertices ) );
+			int16_t *encoded = (int16_t*)array.mEncoded.data();
+			for( size_t v = 0; v < numVertices; ++v )
+				encodeOctahedral( ((const vec3*)data)[v], encoded + v * 2 );
+		}
+		else
+			array.mEntry.mEncoding = (uint8_t)Encoding::NONE;
+
+		array.mEntry.mSize = calcAttribSize( (Encoding)array.mEntry.mEncoding, dims, numVertices );
+		if( ! array.mEncoded.empty() )
+			array.mData = array.mEncoded.data();
+		arrays.push_back( std::move( array ) );
+	}
+
+	// indices are compressed, or narrowed to 16 bits when possible
+	vector<uint8_t> encodedIndices;
+	const void *indexData = indices.data();
+	if( format.getCompressIndices() ) {
+		header.mIndexEncoding = (uint32_t)Encoding::COMPRESSED;
+		encodedIndices = encodeIndices( indices.data(), indices.size() );
+		indexData = encodedIndices.data();
+		header.mIndexSize = encodedIndices.size();
+	}
+	else if( numVertices <= 65536 ) {
+		header.mIndexEncoding = (uint32_t)Encoding::NONE;
+		encodedIndices.resize( indices.size() * sizeof( uint16_t ) );
+		uint16_t *narrowed = (uint16_t*)encodedIndices.data();
+		for( size_t i = 0; i < indices.size(); ++i )
+			narrowed[i] = (uint16_t)indices[i];
+		indexData = encodedIndices.data();
+		header.mIndexSize = encodedIndices.size();
+	}
+	else {
+		header.mIndexEncoding = (uint32_t)Encoding::NONE;
+		header.mIndexSize = indices.size() * sizeof( uint32_t );
+	}
+
+	// lay out the arrays after the header and the attribute table
+	header.mNumAttribs = (uint32_t)arrays.size();
+	size_t offset = alignOffset( alignOffset( sizeof( Header ) ) + arrays.size() * sizeof( AttribEntry ) );
+	for( auto &array : arrays ) {
+		array.mEntry.mOffset = offset;
+		offset = alignOffset( offset + array.mEntry.mSize );
+	}
+	header.mIndexOffset = offset;
+
+	OStreamRef out = dataTarget->getStream();
+	offset = 0;
+	out->writeData( &header, sizeof( header ) );
+	offset += sizeof( header );
+	writePadding( out, &offset );
+	for( const auto &array : arrays ) {
+		out->writeData( &array.mEntry, sizeof( AttribEntry ) );
+		offset += sizeof( AttribEntry );
+	}
+	for( const auto &array : arrays ) {
+		writePadding( out, &offset );
+		out->writeData( array.mData, array.mEntry.mSize );
+		offset += array.mEntry.mSize;
+	}
+	writePadding( out, &offset );
+	if( header.mIndexSize )
+		out->writeData( indexData, header.mIndexSize );
+}
+
+const TriMeshView::AttribEntry* TriMeshView::findAttrib( geom::Attrib attr ) const
+{
+	for( uint32_t a = 0; a < mHeader->mNumAttribs; ++a ) {
+		if( mAttribs[a].mAttrib == (uint32_t)attr )
+			return &mAttribs[a];
+	}
+
+	return nullptr;
+}
+
+TriMeshView::Encoding TriMeshView::getAttribEncoding( geom::Attrib attr ) const
+{
+	const AttribEntry *entry = findAttrib( attr );
+	return entry ? (Encoding)entry->mEncoding : Encoding::NONE;
+}
+
+const float* TriMeshView::getAttribData( geom::Attrib attr ) const
+{
+	const AttribEntry *entry = findAttrib( attr );
+	if( ! entry || (Encoding)entry->mEncoding != Encoding::NONE )
+		return nullptr;
+
+	return reinterpret_cast<const float*>( mData + entry->mOffset );
+}
+
+void TriMeshView::decodeAttrib( geom::Attrib attr, float *result ) const
+{
+	const AttribEntry *entry = findAttrib( attr );
+	if( ! entry )
+		return;
+
+	const size_t numVertices = getNumVertices();
+	const uint8_t *data = mData + entry->mOffset;
+	switch( (Encoding)entry->mEncoding ) {
+		case Encoding::NONE:
+			memcpy( result, data, entry->mSize );
+		break;
+		case Encoding::UNORM16: {
+			const uint16_t *encoded = reinterpret_cast<const uint16_t*>( data );
+			for( size_t i = 0; i < numVertices * entry->mDims; ++i ) {
+				const uint8_t d = i % entry->mDims;
+				result[i] = encoded[i] * entry->mScale[d] + entry->mBias[d];
+			}
+		}
+		break;
+		case Encoding::OCTAHEDRAL16: {
+			const int16_t *encoded = reinterpret_cast<const int16_t*>( data );
+			for( size_t v = 0; v < numVertices; ++v )
+				reinterpret_cast<vec3*>( result )[v] = decodeOctahedral( encoded + v * 2 );
+		}
+		break;
+		default:
+		break;
+	}
+}
+
+const void* TriMeshView::getIndexData() const
+{
+	return ( getIndexEncoding() == Encoding::NONE ) ? mData + mHeader->mIndexOffset : nullptr;
+}
+
+uint8_t TriMeshView::getIndexBytes() const
+{
+	if( getIndexEncoding() != Encoding::NONE )
+		return 0;
+
+	return ( mHeader->mNumVertices <= 65536 ) ? 2 : 4;
+}
+
+void TriMeshView::decodeIndices( uint32_t *result ) const
+{
+	const uint8_t *data = mData + mHeader->mIndexOffset;
+	const size_t numIndices = getNumIndices();
+	if( getIndexEncoding() == Encoding::COMPRESSED )
+		decodeIndicesImpl( data, (size_t)mHeader->mIndexSize, numIndices, mHeader->mNumVertices, result );
+	else if( getIndexBytes() == 2 ) {
+		const uint16_t *indices = reinterpret_cast<const uint16_t*>( data );
+		for( size_t i = 0; i < numIndices; ++i )
+			result[i] = indices[i];
+	}
+	else
+		memcpy( result, data, numIndices * sizeof( uint32_t ) );
+}
+
+AxisAlignedBox TriMeshView::getBoundingBox() const
+{
+	return AxisAlignedBox( vec3( mHeader->mBoundsMin[0], mHeader->mBoundsMin[1], mHeader->mBoundsMin[2] ),
+							vec3( mHeader->mBoundsMax[0], mHeader->mBoundsMax[1], mHeader->mBoundsMax[2] ) );
+}
+
+uint8_t TriMeshView::getAttribDims( geom::Attrib attr ) const
+{
+	const AttribEntry *entry = findAttrib( attr );
+	return entry ? entry->mDims : 0;
+}
+
+geom::AttribSet TriMeshView::getAvailableAttribs() const
+{
+	geom::AttribSet result;
+	for( uint32_t a = 0; a < mHeader->mNumAttribs; ++a )
+		result.insert( (geom::Attrib)mAttribs[a].mAttrib );
+
+	return result;
+}
+
+void TriMeshView::loadInto( geom::Target *target, const geom::AttribSet &requestedAttribs ) const
+{
+	// float attributes are handed to the target straight from the mapped data, quantized ones are decoded first
+	vector<float> decoded;
+	for( auto &attrib : requestedAttribs ) {
+		const AttribEntry *entry = findAttrib( attrib );
+		if( ! entry )
+			continue;
+
+		const float *data = getAttribData( attrib );
+		if( ! data ) {
+			decoded.resize( getNumVertices() * entry->mDims );
+			decodeAttrib( attrib, decoded.data() );
+			data = decoded.data();
+		}
+
+		target->copyAttrib( attrib, entry->mDims, 0, data, getNumVertices() );
+	}
+
+	if( getNumIndices() ) {
+		const uint8_t requiredBytesPerIndex = ( getNumVertices() <= 65536 ) ? 2 : 4;
+		if( getIndexBytes() == 4 )
+			target->copyIndices( geom::Primitive::TRIANGLES, static_cast<const uint32_t*>( getIndexData() ), getNumIndices(), requiredBytesPerIndex );
+		else {
+			vector<uint32_t> indices( getNumIndices() );
+			decodeIndices( indices.data() );
+			target->copyIndices( geom::Primitive::TRIANGLES, indices.data(), indices.size(), requiredBytesPerIndex );
+		}
+	}
+}
+
+} // namespace cinder
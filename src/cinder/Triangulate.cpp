@@ -22,10 +22,24 @@
 
 #include "cinder/Triangulate.h"
 #include "cinder/Shape2d.h"
+#include "cinder/CinderAssert.h"
 #include "../libtess2/tesselator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 using namespace std;
 
+// Contours with more points than this are ear clipped using a z-order hash of their vertices
+#define TRIANGULATE_HASH_MIN_POINTS 80
+// Consecutive points of a contour closer than this, relative to the magnitude of its coordinates, are merged
+#define TRIANGULATE_WELD_EPSILON 0.00001f
+// The number of shapes each worker thread claims at a time in calcMeshes()
+#define TRIANGULATE_BATCH_SIZE 16
+
 namespace cinder {
 
 void* stdAlloc( void* userData, unsigned int size )
@@ -40,27 +54,509 @@ void stdFree( void* /*userData*/, void* ptr )
 	free( ptr );
 }
 
+namespace {
+
+// Returns twice the signed area of triangle abc, positive when it is counter-clockwise. Differences and products of floats are exact in double precision.
+inline double orient( const vec2 &a, const vec2 &b, const vec2 &c )
+{
+	return ( (double)b.x - a.x ) * ( (double)c.y - a.y ) - ( (double)b.y - a.y ) * ( (double)c.x - a.x );
+}
+
+inline int sign( double v )
+{
+	return ( v > 0 ) - ( v < 0 );
+}
+
+// Returns whether q lies within the bounds of segment pr, given that the three are collinear
+inline bool onSegment( const vec2 &p, const vec2 &q, const vec2 &r )
+{
+	return q.x <= std::max( p.x, r.x ) && q.x >= std::min( p.x, r.x ) && q.y <= std::max( p.y, r.y ) && q.y >= std::min( p.y, r.y );
+}
+
+// Returns whether the closed segments p1q1 and p2q2 intersect or touch
+bool segmentsIntersect( const vec2 &p1, const vec2 &q1, const vec2 &p2, const vec2 &q2 )
+{
+	const int o1 = sign( orient( p1, q1, p2 ) ), o2 = sign( orient( p1, q1, q2 ) );
+	const int o3 = sign( orient( p2, q2, p1 ) ), o4 = sign( orient( p2, q2, q1 ) );
+	if( o1 != o2 && o3 != o4 )
+		return true;
+	return ( o1 == 0 && onSegment( p1, p2, q1 ) ) || ( o2 == 0 && onSegment( p1, q2, q1 ) )
+		|| ( o3 == 0 && onSegment( p2, p1, q2 ) ) || ( o4 == 0 && onSegment( p2, q1, q2 ) );
+}
+
+// Returns whether \a p lies inside the closed polygon of \a numPoints \a points, by the even-odd rule
+bool pointInPolygon( const vec2 &p, const vec2 *points, size_t numPoints )
+{
+	bool inside = false;
+	for( size_t i = 0, j = numPoints - 1; i < numPoints; j = i++ ) {
+		const vec2 &a = points[i], &b = points[j];
+		if( ( a.y > p.y ) != ( b.y > p.y ) && p.x < a.x + ( (double)p.y - a.y ) * ( (double)b.x - a.x ) / ( (double)b.y - a.y ) )
+			inside = ! inside;
+	}
+	return inside;
+}
+
+// Returns the position of \a x, \a y along the z-order curve, given coordinates already scaled to [0,32767]
+inline int32_t zOrder( int32_t x, int32_t y )
+{
+	x = ( x | ( x << 8 ) ) & 0x00FF00FF;
+	x = ( x | ( x << 4 ) ) & 0x0F0F0F0F;
+	x = ( x | ( x << 2 ) ) & 0x33333333;
+	x = ( x | ( x << 1 ) ) & 0x55555555;
+	y = ( y | ( y << 8 ) ) & 0x00FF00FF;
+	y = ( y | ( y << 4 ) ) & 0x0F0F0F0F;
+	y = ( y | ( y << 2 ) ) & 0x33333333;
+	y = ( y | ( y << 1 ) ) & 0x55555555;
+	return x | ( y << 1 );
+}
+
+} // anonymous namespace
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Triangulator::EarClipper
+// Ear clipping of polygons with holes after Mapbox's earcut. Holes are bridged into their outer contour, and when the polygon
+// is large, candidate ears are only tested against the vertices nearby on a z-order curve. All memory is kept between calls.
+struct Triangulator::EarClipper {
+	struct Node {
+		Node( uint32_t index, const vec2 &p )
+			: mIndex( index ), mX( p.x ), mY( p.y ), mZ( 0 ), mPrev( nullptr ), mNext( nullptr ), mPrevZ( nullptr ), mNextZ( nullptr )
+		{}
+
+		uint32_t	mIndex;
+		float		mX, mY;
+		int32_t		mZ;
+		Node		*mPrev, *mNext;
+		Node		*mPrevZ, *mNextZ;
+	};
+
+	struct Segment {
+		uint32_t	mA, mB;
+		float		mMinX, mMaxX, mMinY, mMaxY;
+
+		bool operator<( const Segment &rhs ) const { return mMinX < rhs.mMinX; }
+	};
+
+	bool	isSimple( const vector<vec2> &points, const vector<uint32_t> &contourOffsets );
+	bool	triangulate( const vec2 *points, const uint32_t *outer, const uint32_t *holes, size_t numHoles );
+
+	static double	area( const Node *p, const Node *q, const Node *r )	{ return ( (double)q->mY - p->mY ) * ( (double)r->mX - q->mX ) - ( (double)q->mX - p->mX ) * ( (double)r->mY - q->mY ); }
+	static bool		equals( const Node *a, const Node *b )				{ return a->mX == b->mX && a->mY == b->mY; }
+	static bool		pointInTriangle( double ax, double ay, double bx, double by, double cx, double cy, double px, double py );
+	static bool		locallyInside( const Node *a, const Node *b );
+	static bool		sectorContainsSector( const Node *m, const Node *p )	{ return area( m->mPrev, m, p->mPrev ) < 0 && area( p->mNext, m, m->mNext ) < 0; }
+	static void		removeNode( Node *p );
+	static Node*	filterPoints( Node *start, Node *end = nullptr );
+	static Node*	findHoleBridge( Node *hole, Node *outerNode );
+	static Node*	getLeftmost( Node *start );
+
+	Node*	insertNode( uint32_t index, const vec2 &p, Node *last );
+	Node*	linkedList( const vec2 *points, uint32_t begin, uint32_t end, bool counterClockwise );
+	Node*	eliminateHoles( const vec2 *points, const uint32_t *holes, size_t numHoles, Node *outerNode );
+	Node*	splitPolygon( Node *a, Node *b );
+	bool	earcutLinked( Node *ear, int pass );
+	bool	isEar( const Node *ear ) const;
+	bool	isEarHashed( const Node *ear ) const;
+	void	indexCurve( Node *start );
+	int32_t	zOrder( float x, float y ) const;
+
+	vector<Node>		mNodes; // reserved up front, so that Nodes can point at one another
+	vector<Node*>		mSorted;
+	vector<Segment>		mSegments;
+	vector<size_t>		mActive;
+	vector<double>		mAreas;
+	vector<Rectf>		mBounds;
+	vector<int>			mDepths;
+	vector<int>			mParents;
+	vector<uint32_t>	mHoles;
+	vector<uint32_t>	mIndices;
+	float				mMinX, mMinY, mInvSize;
+};
+
+// Returns whether the contours are free of intersections, including touching vertices and edges which fold back onto one another
+bool Triangulator::EarClipper::isSimple( const vector<vec2> &points, const vector<uint32_t> &contourOffsets )
+{
+	mSegments.clear();
+	for( size_t c = 0; c + 1 < contourOffsets.size(); ++c ) {
+		const uint32_t begin = contourOffsets[c], end = contourOffsets[c + 1];
+		for( uint32_t i = begin; i < end; ++i ) {
+			const uint32_t j = ( i + 1 < end ) ? i + 1 : begin;
+			const vec2 &a = points[i], &b = points[j];
+			Segment segment = { i, j, std::min( a.x, b.x ), std::max( a.x, b.x ), std::min( a.y, b.y ), std::max( a.y, b.y ) };
+			mSegments.push_back( segment );
+		}
+	}
+	std::sort( mSegments.begin(), mSegments.end() );
+
+	// sweep along x, testing each segment against those it overlaps
+	mActive.clear();
+	for( size_t s = 0; s < mSegments.size(); ++s ) {
+		const Segment &segment = mSegments[s];
+		for( size_t a = 0; a < mActive.size(); ) {
+			const Segment &other = mSegments[mActive[a]];
+			if( other.mMaxX < segment.mMinX ) {
+				mActive[a] = mActive.back();
+				mActive.pop_back();
+				continue;
+			}
+			++a;
+			if( other.mMaxY < segment.mMinY || other.mMinY > segment.mMaxY )
+				continue;
+
+			if( segment.mA == other.mB || segment.mB == other.mA ) {
+				// consecutive edges only share their common vertex, unless the contour doubles back on itself
+				const uint32_t shared = ( segment.mA == other.mB ) ? segment.mA : segment.mB;
+				const vec2 &u = points[shared == segment.mA ? segment.mB : segment.mA], &v = points[shared == other.mA ? other.mB : other.mA];
+				const vec2 &p = points[shared];
+				if( orient( u, p, v ) == 0 && dot( u - p, v - p ) > 0 )
+					return false;
+			}
+			else if( segmentsIntersect( points[segment.mA], points[segment.mB], points[other.mA], points[other.mB] ) )
+				return false;
+		}
+		mActive.push_back( s );
+	}
+
+	return true;
+}
+
+// Appends the triangles of the polygon with the contour \a outer and the \a numHoles \a holes inside it, each given as the offsets of its first and last point.
+// Returns \c false if the polygon couldn't be fully clipped.
+bool Triangulator::EarClipper::triangulate( const vec2 *points, const uint32_t *outer, const uint32_t *holes, size_t numHoles )
+{
+	Node *outerNode = linkedList( points, outer[0], outer[1], true );
+	if( numHoles > 0 )
+		outerNode = eliminateHoles( points, holes, numHoles, outerNode );
+
+	mInvSize = 0;
+	size_t numPoints = outer[1] - outer[0];
+	for( size_t h = 0; h < numHoles; ++h )
+		numPoints += holes[h * 2 + 1] - holes[h * 2];
+	if( numPoints > TRIANGULATE_HASH_MIN_POINTS ) {
+		// the outer contour bounds the holes, so its bounds cover every vertex
+		float maxX = points[outer[0]].x, maxY = points[outer[0]].y;
+		mMinX = maxX;
+		mMinY = maxY;
+		for( uint32_t i = outer[0] + 1; i < outer[1]; ++i ) {
+			mMinX = std::min( mMinX, points[i].x );
+			mMinY = std::min( mMinY, points[i].y );
+			maxX = std::max( maxX, points[i].x );
+			maxY = std::max( maxY, points[i].y );
+		}
+		const float size = std::max( maxX - mMinX, maxY - mMinY );
+		mInvSize = ( size != 0 ) ? 32767 / size : 0;
+	}
+
+	return earcutLinked( outerNode, 0 );
+}
+
+bool Triangulator::EarClipper::pointInTriangle( double ax, double ay, double bx, double by, double cx, double cy, double px, double py )
+{
+	return ( cx - px ) * ( ay - py ) >= ( ax - px ) * ( cy - py )
+		&& ( ax - px ) * ( by - py ) >= ( bx - px ) * ( ay - py )
+		&& ( bx - px ) * ( cy - py ) >= ( cx - px ) * ( by - py );
+}
+
+// Returns whether a diagonal from \a a to \a b starts inside the polygon at \a a
+bool Triangulator::EarClipper::locallyInside( const Node *a, const Node *b )
+{
+	return ( area( a->mPrev, a, a->mNext ) < 0 )
+		? ( area( a, b, a->mNext ) >= 0 && area( a, a->mPrev, b ) >= 0 )
+		: ( area( a, b, a->mPrev ) < 0 || area( a, a->mNext, b ) < 0 );
+}
+
+void Triangulator::EarClipper::removeNode( Node *p )
+{
+	p->mNext->mPrev = p->mPrev;
+	p->mPrev->mNext = p->mNext;
+	if( p->mPrevZ )
+		p->mPrevZ->mNextZ = p->mNextZ;
+	if( p->mNextZ )
+		p->mNextZ->mPrevZ = p->mPrevZ;
+}
+
+// Removes duplicate and collinear points between \a start and \a end
+Triangulator::EarClipper::Node* Triangulator::EarClipper::filterPoints( Node *start, Node *end )
+{
+	if( ! end )
+		end = start;
+
+	Node *p = start;
+	bool again;
+	do {
+		again = false;
+		if( equals( p, p->mNext ) || area( p->mPrev, p, p->mNext ) == 0 ) {
+			removeNode( p );
+			p = end = p->mPrev;
+			if( p == p->mNext )
+				break;
+			again = true;
+		}
+		else
+			p = p->mNext;
+	} while( again || p != end );
+
+	return end;
+}
+
+// Finds a vertex of the outer contour which can be connected to the leftmost vertex of a hole without crossing any edges
+Triangulator::EarClipper::Node* Triangulator::EarClipper::findHoleBridge( Node *hole, Node *outerNode )
+{
+	// find the segment to the left of the hole's vertex which is closest to it
+	Node *p = outerNode, *m = nullptr;
+	const double hx = hole->mX, hy = hole->mY;
+	double qx = -numeric_limits<double>::infinity();
+	do {
+		if( hy <= p->mY && hy >= p->mNext->mY && p->mNext->mY != p->mY ) {
+			const double x = p->mX + ( hy - p->mY ) * ( (double)p->mNext->mX - p->mX ) / ( (double)p->mNext->mY - p->mY );
+			if( x <= hx && x > qx ) {
+				qx = x;
+				m = ( p->mX < p->mNext->mX ) ? p : p->mNext;
+				if( x == hx )
+					return m; // the hole touches the outer segment
+			}
+		}
+		p = p->mNext;
+	} while( p != outerNode );
+
+	if( ! m )
+		return nullptr;
+
+	// look for vertices inside the triangle between the hole vertex, the segment intersection and the segment's endpoint,
+	// connecting to the one with the smallest angle to the ray instead
+	const Node *stop = m;
+	const double mx = m->mX, my = m->mY;
+	double tanMin = numeric_limits<double>::infinity();
+	p = m;
+	do {
+		if( hx >= p->mX && p->mX >= mx && hx != p->mX && pointInTriangle( hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->mX, p->mY ) ) {
+			const double tan = std::abs( hy - p->mY ) / ( hx - p->mX );
+			if( locallyInside( p, hole ) && ( tan < tanMin || ( tan == tanMin && ( p->mX > m->mX || ( p->mX == m->mX && sectorContainsSector( m, p ) ) ) ) ) ) {
+				m = p;
+				tanMin = tan;
+			}
+		}
+		p = p->mNext;
+	} while( p != stop );
+
+	return m;
+}
+
+Triangulator::EarClipper::Node* Triangulator::EarClipper::getLeftmost( Node *start )
+{
+	Node *p = start, *leftmost = start;
+	do {
+		if( p->mX < leftmost->mX || ( p->mX == leftmost->mX && p->mY < leftmost->mY ) )
+			leftmost = p;
+		p = p->mNext;
+	} while( p != start );
+	return leftmost;
+}
+
+Triangulator::EarClipper::Node* Triangulator::EarClipper::insertNode( uint32_t index, const vec2 &p, Node *last )
+{
+	CI_ASSERT( mNodes.size() < mNodes.capacity() );
+	mNodes.push_back( Node( index, p ) );
+	Node *node = &mNodes.back();
+	if( ! last ) {
+		node->mPrev = node;
+		node->mNext = node;
+	}
+	else {
+		node->mNext = last->mNext;
+		node->mPrev = last;
+		last->mNext->mPrev = node;
+		last->mNext = node;
+	}
+	return node;
+}
+
+// Links the points [\a begin, \a end) into a circular list in the given orientation
+Triangulator::EarClipper::Node* Triangulator::EarClipper::linkedList( const vec2 *points, uint32_t begin, uint32_t end, bool counterClockwise )
+{
+	double area = 0;
+	for( uint32_t i = begin, j = end - 1; i < end; j = i++ )
+		area += ( (double)points[j].x - points[i].x ) * ( (double)points[i].y + points[j].y );
+
+	Node *last = nullptr;
+	if( counterClockwise == ( area > 0 ) ) {
+		for( uint32_t i = begin; i < end; ++i )
+			last = insertNode( i, points[i], last );
+	}
+	else {
+		for( uint32_t i = end; i > begin; --i )
+			last = insertNode( i - 1, points[i - 1], last );
+	}
+	return last;
+}
+
+// Connects each hole to the outer contour with a pair of coincident edges, from left to right
+Triangulator::EarClipper::Node* Triangulator::EarClipper::eliminateHoles( const vec2 *points, const uint32_t *holes, size_t numHoles, Node *outerNode )
+{
+	mSorted.clear();
+	for( size_t h = 0; h < numHoles; ++h )
+		mSorted.push_back( getLeftmost( linkedList( points, holes[h * 2], holes[h * 2 + 1], false ) ) );
+	std::sort( mSorted.begin(), mSorted.end(), []( const Node *a, const Node *b ) { return a->mX < b->mX; } );
+
+	for( Node *hole : mSorted ) {
+		Node *bridge = findHoleBridge( hole, outerNode );
+		if( bridge ) {
+			Node *bridgeReverse = splitPolygon( bridge, hole );
+			filterPoints( bridgeReverse, bridgeReverse->mNext );
+			outerNode = filterPoints( bridge, bridge->mNext );
+		}
+	}
+
+	return outerNode;
+}
+
+// Links \a a and \a b with a diagonal, splitting the polygon in two if they are on the same contour, or merging two contours into one if not.
+// Returns the duplicate of \a b.
+Triangulator::EarClipper::Node* Triangulator::EarClipper::splitPolygon( Node *a, Node *b )
+{
+	Node *a2 = insertNode( a->mIndex, vec2( a->mX, a->mY ), nullptr );
+	Node *b2 = insertNode( b->mIndex, vec2( b->mX, b->mY ), nullptr );
+	Node *an = a->mNext, *bp = b->mPrev;
+
+	a->mNext = b;
+	b->mPrev = a;
+	a2->mNext = an;
+	an->mPrev = a2;
+	b2->mNext = a2;
+	a2->mPrev = b2;
+	bp->mNext = b2;
+	b2->mPrev = bp;
+
+	return b2;
+}
+
+// Clips ears from the list starting at \a ear until only a single triangle's worth remains. If no ear can be found, the list is cleaned of
+// collinear points and clipping is retried once. Returns \c false if that fails too.
+bool Triangulator::EarClipper::earcutLinked( Node *ear, int pass )
+{
+	if( ! ear )
+		return true;
+	if( pass == 0 && mInvSize != 0 )
+		indexCurve( ear );
+
+	Node *stop = ear;
+	while( ear->mPrev != ear->mNext ) {
+		Node *prev = ear->mPrev, *next = ear->mNext;
+		if( ( mInvSize != 0 ) ? isEarHashed( ear ) : isEar( ear ) ) {
+			mIndices.push_back( prev->mIndex );
+			mIndices.push_back( ear->mIndex );
+			mIndices.push_back( next->mIndex );
+			removeNode( ear );
+			ear = next->mNext;
+			stop = next->mNext;
+			continue;
+		}
+
+		ear = next;
+		if( ear == stop )
+			return ( pass == 0 ) ? earcutLinked( filterPoints( ear ), 1 ) : false;
+	}
+
+	return true;
+}
+
+bool Triangulator::EarClipper::isEar( const Node *ear ) const
+{
+	const Node *a = ear->mPrev, *b = ear, *c = ear->mNext;
+	if( area( a, b, c ) >= 0 )
+		return false; // reflex
+
+	const float x0 = std::min( a->mX, std::min( b->mX, c->mX ) ), y0 = std::min( a->mY, std::min( b->mY, c->mY ) );
+	const float x1 = std::max( a->mX, std::max( b->mX, c->mX ) ), y1 = std::max( a->mY, std::max( b->mY, c->mY ) );
+
+	// no other vertex of the polygon may lie inside the ear
+	for( const Node *p = c->mNext; p != a; p = p->mNext ) {
+		if( p->mX >= x0 && p->mX <= x1 && p->mY >= y0 && p->mY <= y1 && ! ( p->mX == a->mX && p->mY == a->mY )
+				&& pointInTriangle( a->mX, a->mY, b->mX, b->mY, c->mX, c->mY, p->mX, p->mY ) && area( p->mPrev, p, p->mNext ) >= 0 )
+			return false;
+	}
+
+	return true;
+}
+
+bool Triangulator::EarClipper::isEarHashed( const Node *ear ) const
+{
+	const Node *a = ear->mPrev, *b = ear, *c = ear->mNext;
+	if( area( a, b, c ) >= 0 )
+		return false; // reflex
+
+	const float x0 = std::min( a->mX, std::min( b->mX, c->mX ) ), y0 = std::min( a->mY, std::min( b->mY, c->mY ) );
+	const float x1 = std::max( a->mX, std::max( b->mX, c->mX ) ), y1 = std::max( a->mY, std::max( b->mY, c->mY ) );
+
+	// only the vertices within the z-order range of the ear's bounds can lie inside it
+	const int32_t minZ = zOrder( x0, y0 ), maxZ = zOrder( x1, y1 );
+	auto inside = [&]( const Node *p ) {
+		return p->mX >= x0 && p->mX <= x1 && p->mY >= y0 && p->mY <= y1 && p != a && p != c
+			&& pointInTriangle( a->mX, a->mY, b->mX, b->mY, c->mX, c->mY, p->mX, p->mY ) && area( p->mPrev, p, p->mNext ) >= 0;
+	};
+
+	const Node *p = ear->mPrevZ, *n = ear->mNextZ;
+	while( p && p->mZ >= minZ && n && n->mZ <= maxZ ) {
+		if( inside( p ) || inside( n ) )
+			return false;
+		p = p->mPrevZ;
+		n = n->mNextZ;
+	}
+	for( ; p && p->mZ >= minZ; p = p->mPrevZ )
+		if( inside( p ) )
+			return false;
+	for( ; n && n->mZ <= maxZ; n = n->mNextZ )
+		if( inside( n ) )
+			return false;
+
+	return true;
+}
+
+// Links the nodes of the list starting at \a start in z-order
+void Triangulator::EarClipper::indexCurve( Node *start )
+{
+	mSorted.clear();
+	Node *p = start;
+	do {
+		p->mZ = zOrder( p->mX, p->mY );
+		mSorted.push_back( p );
+		p = p->mNext;
+	} while( p != start );
+
+	std::sort( mSorted.begin(), mSorted.end(), []( const Node *a, const Node *b ) { return a->mZ < b->mZ; } );
+	for( size_t i = 0; i < mSorted.size(); ++i ) {
+		mSorted[i]->mPrevZ = ( i > 0 ) ? mSorted[i - 1] : nullptr;
+		mSorted[i]->mNextZ = ( i + 1 < mSorted.size() ) ? mSorted[i + 1] : nullptr;
+	}
+}
+
+int32_t Triangulator::EarClipper::zOrder( float x, float y ) const
+{
+	return cinder::zOrder( (int32_t)( ( x - mMinX ) * mInvSize ), (int32_t)( ( y - mMinY ) * mInvSize ) );
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Triangulator
 Triangulator::Triangulator( const Path2d &path, float approximationScale )
-{	
-	allocate();
+	: mAllocated( 0 ), mEarClippingEnabled( true )
+{
 	addPath( path, approximationScale );
 }
 
 Triangulator::Triangulator( const Shape2d &shape, float approximationScale )
-{	
-	allocate();
+	: mAllocated( 0 ), mEarClippingEnabled( true )
+{
 	addShape( shape, approximationScale );
 }
 
 Triangulator::Triangulator( const PolyLine2f &polyLine )
-{	
-	allocate();
+	: mAllocated( 0 ), mEarClippingEnabled( true )
+{
 	addPolyLine( polyLine );
 }
 
 Triangulator::Triangulator()
+	: mAllocated( 0 ), mEarClippingEnabled( true )
 {
-	allocate();
 }
 
 void Triangulator::allocate()
@@ -90,28 +586,60 @@ void Triangulator::addShape( const Shape2d &shape, float approximationScale )
 void Triangulator::addPath( const Path2d &path, float approximationScale )
 {
 	vector<vec2> subdivided = path.subdivide( approximationScale );
-	tessAddContour( mTess.get(), 2, &subdivided[0], sizeof(float) * 2, (int)subdivided.size() );
+	addContour( subdivided.data(), subdivided.size() );
 }
 
 void Triangulator::addPolyLine( const PolyLine2f &polyLine )
 {
-	if( polyLine.size() > 0 )
-		tessAddContour( mTess.get(), 2, &polyLine.getPoints()[0], sizeof(float) * 2, (int)polyLine.size() );
+	addContour( polyLine.getPoints().data(), polyLine.size() );
 }
 
 void Triangulator::addPolyLine( const vec2 *points, size_t numPoints )
 {
-	if( numPoints > 0 )
-		tessAddContour( mTess.get(), 2, &points, sizeof(vec2), (int)numPoints );
+	addContour( points, numPoints );
+}
+
+void Triangulator::clear()
+{
+	mPoints.clear();
+	mContourOffsets.clear();
+}
+
+// Stores a contour without its repeated points, including a closing point equal to the first. Points closer together than the precision of the contour's
+// coordinates are treated as repeated, as curves which end where they began often do so only approximately, leaving a tiny loop. Contours of fewer than three
+// points enclose nothing and are dropped.
+void Triangulator::addContour( const vec2 *points, size_t numPoints )
+{
+	if( mContourOffsets.empty() )
+		mContourOffsets.push_back( 0 );
+	if( numPoints < 3 )
+		return;
+
+	float extent = 0;
+	for( size_t p = 0; p < numPoints; ++p )
+		extent = std::max( extent, std::max( std::abs( points[p].x ), std::abs( points[p].y ) ) );
+	const float epsilon = extent * TRIANGULATE_WELD_EPSILON;
+	auto close = [epsilon]( const vec2 &a, const vec2 &b ) { return std::abs( a.x - b.x ) <= epsilon && std::abs( a.y - b.y ) <= epsilon; };
+
+	const size_t begin = mPoints.size();
+	for( size_t p = 0; p < numPoints; ++p )
+		if( mPoints.size() == begin || ! close( points[p], mPoints.back() ) )
+			mPoints.push_back( points[p] );
+	while( mPoints.size() > begin + 1 && close( mPoints.back(), mPoints[begin] ) )
+		mPoints.pop_back();
+
+	if( mPoints.size() < begin + 3 )
+		mPoints.resize( begin );
+	else
+		mContourOffsets.push_back( (uint32_t)mPoints.size() );
 }
 
 TriMesh Triangulator::calcMesh( Winding winding )
 {
 	TriMesh result( TriMesh::Format().positions( 2 ) );
 	
-	tessTesselate( mTess.get(), (int)winding, TESS_POLYGONS, 3, 2, 0 );
-	result.appendPositions( (vec2*)tessGetVertices( mTess.get() ), tessGetVertexCount( mTess.get() ) );
-	result.appendIndices( (uint32_t*)( tessGetElements( mTess.get() ) ), tessGetElementCount( mTess.get() ) * 3 );
+	if( ! mEarClippingEnabled || ! earClip( winding, &result ) )
+		tesselate( winding, &result );
 	
 	return result;
 }
@@ -120,10 +648,154 @@ TriMeshRef Triangulator::createMesh( Winding winding )
 {
 	TriMeshRef result = make_shared<TriMesh>( TriMesh::Format().positions( 2 ) );
 	
+	if( ! mEarClippingEnabled || ! earClip( winding, result.get() ) )
+		tesselate( winding, result.get() );
+	
+	return result;
+}
+
+bool Triangulator::earClip( Winding winding, TriMesh *result )
+{
+	if( winding == WINDING_ABS_GEQ_TWO )
+		return false;
+	if( mPoints.empty() )
+		return true;
+
+	if( ! mEarClipper )
+		mEarClipper = make_shared<EarClipper>();
+	EarClipper &clipper = *mEarClipper;
+	const size_t numContours = mContourOffsets.size() - 1;
+
+	clipper.mAreas.resize( numContours );
+	clipper.mBounds.resize( numContours );
+	for( size_t c = 0; c < numContours; ++c ) {
+		const vec2 *points = &mPoints[mContourOffsets[c]];
+		const size_t numPoints = mContourOffsets[c + 1] - mContourOffsets[c];
+		double area = 0;
+		for( size_t i = 0, j = numPoints - 1; i < numPoints; j = i++ )
+			area += (double)points[j].x * points[i].y - (double)points[i].x * points[j].y;
+		if( area == 0 )
+			return false;
+		clipper.mAreas[c] = area;
+		clipper.mBounds[c] = Rectf( points[0], points[0] );
+		for( size_t i = 1; i < numPoints; ++i )
+			clipper.mBounds[c].include( points[i] );
+	}
+
+	if( ! clipper.isSimple( mPoints, mContourOffsets ) )
+		return false;
+
+	// as the contours don't touch, each one is either entirely inside or outside another. Contours nested an even number of times
+	// are filled, and those nested an odd number of times are holes in the smallest contour containing them.
+	clipper.mDepths.assign( numContours, 0 );
+	clipper.mParents.assign( numContours, -1 );
+	for( size_t c = 0; c < numContours; ++c ) {
+		const vec2 &first = mPoints[mContourOffsets[c]];
+		for( size_t d = 0; d < numContours; ++d ) {
+			if( d == c || std::abs( clipper.mAreas[d] ) <= std::abs( clipper.mAreas[c] ) || ! clipper.mBounds[d].contains( first ) )
+				continue;
+			if( pointInPolygon( first, &mPoints[mContourOffsets[d]], mContourOffsets[d + 1] - mContourOffsets[d] ) ) {
+				clipper.mDepths[c]++;
+				if( clipper.mParents[c] < 0 || std::abs( clipper.mAreas[d] ) < std::abs( clipper.mAreas[clipper.mParents[c]] ) )
+					clipper.mParents[c] = (int)d;
+			}
+		}
+	}
+
+	// under the other rules, nesting matches the even-odd rule as long as the orientations alternate
+	if( winding != WINDING_ODD ) {
+		for( size_t c = 0; c < numContours; ++c ) {
+			const int parent = clipper.mParents[c];
+			if( parent >= 0 && ( clipper.mAreas[c] > 0 ) == ( clipper.mAreas[parent] > 0 ) )
+				return false;
+			if( parent < 0 && winding == WINDING_POSITIVE && clipper.mAreas[c] < 0 )
+				return false;
+			if( parent < 0 && winding == WINDING_NEGATIVE && clipper.mAreas[c] > 0 )
+				return false;
+		}
+	}
+
+	// each bridge between a hole and its outer contour duplicates two vertices
+	clipper.mNodes.clear();
+	clipper.mNodes.reserve( mPoints.size() + numContours * 2 );
+	clipper.mIndices.clear();
+	for( size_t c = 0; c < numContours; ++c ) {
+		if( clipper.mDepths[c] % 2 != 0 )
+			continue;
+		clipper.mHoles.clear();
+		for( size_t h = 0; h < numContours; ++h ) {
+			if( clipper.mParents[h] == (int)c ) {
+				clipper.mHoles.push_back( mContourOffsets[h] );
+				clipper.mHoles.push_back( mContourOffsets[h + 1] );
+			}
+		}
+		if( ! clipper.triangulate( mPoints.data(), &mContourOffsets[c], clipper.mHoles.data(), clipper.mHoles.size() / 2 ) )
+			return false;
+	}
+
+	result->appendPositions( mPoints.data(), mPoints.size() );
+	result->appendIndices( clipper.mIndices.data(), clipper.mIndices.size() );
+	return true;
+}
+
+void Triangulator::tesselate( Winding winding, TriMesh *result )
+{
+	if( ! mTess )
+		allocate();
+
+	// libtess2 consumes its contours, so they're added again on every call
+	for( size_t c = 0; c + 1 < mContourOffsets.size(); ++c )
+		tessAddContour( mTess.get(), 2, &mPoints[mContourOffsets[c]], sizeof(vec2), (int)( mContourOffsets[c + 1] - mContourOffsets[c] ) );
+
+	// the result can't be trusted from the return value, as libtess2 flags running out of its preallocated space even when it recovers
 	tessTesselate( mTess.get(), (int)winding, TESS_POLYGONS, 3, 2, 0 );
+	if( ! tessGetVertices( mTess.get() ) )
+		return;
 	result->appendPositions( (vec2*)tessGetVertices( mTess.get() ), tessGetVertexCount( mTess.get() ) );
 	result->appendIndices( (uint32_t*)( tessGetElements( mTess.get() ) ), tessGetElementCount( mTess.get() ) * 3 );
-	
+}
+
+vector<TriMesh> Triangulator::calcMeshes( const vector<Shape2d> &shapes, float approximationScale, Winding winding )
+{
+	vector<TriMesh> result( shapes.size(), TriMesh( TriMesh::Format().positions( 2 ) ) );
+	const size_t numBatches = ( shapes.size() + TRIANGULATE_BATCH_SIZE - 1 ) / TRIANGULATE_BATCH_SIZE;
+
+	atomic<size_t> nextBatch( 0 );
+	mutex exceptionMutex;
+	exception_ptr exception;
+	auto work = [&]() {
+		Triangulator triangulator;
+		try {
+			for( size_t batch = nextBatch++; batch < numBatches; batch = nextBatch++ ) {
+				const size_t end = std::min( shapes.size(), ( batch + 1 ) * TRIANGULATE_BATCH_SIZE );
+				for( size_t s = batch * TRIANGULATE_BATCH_SIZE; s < end; ++s ) {
+					triangulator.clear();
+					triangulator.addShape( shapes[s], approximationScale );
+					if( ! triangulator.mEarClippingEnabled || ! triangulator.earClip( winding, &result[s] ) )
+						triangulator.tesselate( winding, &result[s] );
+				}
+			}
+		}
+		catch( ... ) {
+			// stop the other workers and rethrow the first exception on the calling thread
+			nextBatch = numBatches;
+			lock_guard<mutex> lock( exceptionMutex );
+			if( ! exception )
+				exception = current_exception();
+		}
+	};
+
+	const size_t numThreads = std::min<size_t>( thread::hardware_concurrency(), numBatches );
+	vector<thread> threads;
+	for( size_t t = 1; t < numThreads; ++t )
+		threads.push_back( thread( work ) );
+	work();
+	for( auto &t : threads )
+		t.join();
+
+	if( exception )
+		rethrow_exception( exception );
+
 	return result;
 }
 
@@ -25,8 +25,10 @@
 */
 
 #include "cinder/Xml.h"
+#include "cinder/MemoryMappedFile.h"
 #include "cinder/Utilities.h"
 #include <boost/algorithm/string.hpp>
+#include <cstring>
 
 #include "rapidxml/rapidxml.hpp"
 #include "rapidxml/rapidxml_print.hpp"
@@ -38,15 +40,36 @@ namespace cinder {
 void parseItem( const rapidxml::xml_node<> &node, XmlTree *parent, XmlTree *result, const XmlTree::ParseOptions &parseOptions );
 
 namespace {
-bool tagsMatch( const std::string &tag1, const std::string &tag2, bool caseSensitive )
+
+inline char toLowerAscii( char c )
 {
-	if( caseSensitive && ( tag1 == tag2 ) )
-		return true;
-	else if( ( ! caseSensitive ) && ( boost::iequals( tag1, tag2 ) ) )
-		return true;
-	else
+	return ( c >= 'A' && c <= 'Z' ) ? c + ( 'a' - 'A' ) : c;
+}
+
+// compares ASCII case-insensitively rather than through a std::locale as boost::iequals() does, which is far slower
+bool tagsMatch( const char *tag, size_t tagSize, const boost::string_ref &searchTag, bool caseSensitive )
+{
+	if( tagSize != searchTag.size() )
 		return false;
+	else if( tagSize == 0 )
+		return true;
+	else if( caseSensitive )
+		return memcmp( tag, searchTag.data(), tagSize ) == 0;
+
+	for( size_t i = 0; i < tagSize; i++ ) {
+		if( tag[i] != searchTag[i] && toLowerAscii( tag[i] ) != toLowerAscii( searchTag[i] ) )
+			return false;
+	}
+	return true;
 }
+
+// Children which XmlTree keeps with its default ParseOptions
+bool isVisibleChild( const rapidxml::xml_node<> *node )
+{
+	const rapidxml::node_type type = node->type();
+	return type == rapidxml::node_element || type == rapidxml::node_cdata || type == rapidxml::node_comment;
+}
+
 } // anonymous namespace
 
 XmlTree::ConstIter::ConstIter( const Container *sequence )
@@ -136,11 +159,12 @@ void XmlTree::ConstIter::increment()
 	}
 }
 
-XmlTree::Container::const_iterator XmlTree::findNextChildNamed( const Container &sequence, Container::const_iterator firstCandidate, const string &searchTag, bool caseSensitive )
+XmlTree::Container::const_iterator XmlTree::findNextChildNamed( const Container &sequence, Container::const_iterator firstCandidate, const boost::string_ref &searchTag, bool caseSensitive )
 {
 	Container::const_iterator result = firstCandidate;
 	while( result != sequence.end() ) {
-		if( tagsMatch( (*result)->getTag(), searchTag, caseSensitive ) )
+		const string &tag = (*result)->getTag();
+		if( tagsMatch( tag.data(), tag.size(), searchTag, caseSensitive ) )
 			break;
 		else
 			++result;
@@ -332,15 +356,20 @@ XmlTree* XmlTree::getNodePtr( const string &relativePath, bool caseSensitive, ch
 {
 	XmlTree *curNode = const_cast<XmlTree*>( this );
 
-	vector<string> pathComponents = split( relativePath, separator );
-	for( vector<string>::const_iterator pathIt = pathComponents.begin(); pathIt != pathComponents.end(); ++pathIt ) {
-		if( pathIt->empty() )
-			continue;
-		Container::const_iterator node = XmlTree::findNextChildNamed( curNode->getChildren(), curNode->getChildren().begin(), *pathIt, caseSensitive )	;
-		if( node != curNode->getChildren().end() )
-			curNode = const_cast<XmlTree*>( node->get() );
-		else
-			return 0;
+	// walk the components of the path in place, skipping empty ones
+	for( size_t start = 0; start < relativePath.size(); ) {
+		size_t end = relativePath.find( separator, start );
+		if( end == string::npos )
+			end = relativePath.size();
+		if( end > start ) {
+			const boost::string_ref component( relativePath.data() + start, end - start );
+			Container::const_iterator node = XmlTree::findNextChildNamed( curNode->getChildren(), curNode->getChildren().begin(), component, caseSensitive );
+			if( node != curNode->getChildren().end() )
+				curNode = const_cast<XmlTree*>( node->get() );
+			else
+				return 0;
+		}
+		start = end + 1;
 	}
 
 	return curNode;
@@ -437,4 +466,269 @@ XmlTree::ExcAttrNotFound::ExcAttrNotFound( const XmlTree &node, const string &at
 #endif
 }
 
-} // namespace cinder
\ No newline at end of file
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// XmlView
+
+namespace {
+
+const rapidxml::xml_node<>* findPath( const rapidxml::xml_node<> *node, const boost::string_ref &path, bool caseSensitive, char separator )
+{
+	const size_t end = path.find( separator );
+	const boost::string_ref component = path.substr( 0, end );
+	for( const rapidxml::xml_node<> *child = node->first_node(); child; child = child->next_sibling() ) {
+		if( ! isVisibleChild( child ) || ! tagsMatch( child->name(), child->name_size(), component, caseSensitive ) )
+			continue;
+		if( end == boost::string_ref::npos )
+			return child;
+		// later children are tried when the rest of the path doesn't match below this one
+		const rapidxml::xml_node<> *result = findPath( child, path.substr( end + 1 ), caseSensitive, separator );
+		if( result )
+			return result;
+	}
+
+	return nullptr;
+}
+
+const rapidxml::xml_attribute<>* findAttribute( const rapidxml::xml_node<> *node, const boost::string_ref &attrName )
+{
+	for( const rapidxml::xml_attribute<> *attr = node->first_attribute(); attr; attr = attr->next_attribute() ) {
+		if( attr->name_size() == attrName.size() && ( attrName.empty() || memcmp( attr->name(), attrName.data(), attrName.size() ) == 0 ) )
+			return attr;
+	}
+
+	return nullptr;
+}
+
+} // anonymous namespace
+
+struct XmlView::Document {
+	void	parse( const char *data, size_t size, bool parseComments )
+	{
+		// RapidXML parses in place, decoding entities and terminating strings, so it needs a mutable copy of the document
+		mData.reset( new char[size + 1] );
+		memcpy( mData.get(), data, size );
+		mData[size] = 0;
+		if( parseComments )
+			mDoc.parse<rapidxml::parse_comment_nodes | rapidxml::parse_doctype_node>( mData.get() );
+		else
+			mDoc.parse<rapidxml::parse_doctype_node>( mData.get() );
+	}
+
+	unique_ptr<char[]>		mData;
+	rapidxml::xml_document<>	mDoc;
+};
+
+XmlView::XmlView( const DataSourceRef &dataSource, bool parseComments )
+	: mDocument( new Document )
+{
+	if( dataSource->isFilePath() ) {
+		try {
+			MemoryMappedFileRef mappedFile = MemoryMappedFile::create( dataSource->getFilePath() );
+			mDocument->parse( (const char*)mappedFile->getData(), mappedFile->getSize(), parseComments );
+			return;
+		}
+		catch( ExcMemoryMappedFile & ) {
+		}
+	}
+
+	BufferRef buffer = dataSource->getBuffer();
+	mDocument->parse( (const char*)buffer->getData(), buffer->getSize(), parseComments );
+}
+
+XmlView::XmlView( const std::string &xmlString, bool parseComments )
+	: mDocument( new Document )
+{
+	mDocument->parse( xmlString.data(), xmlString.size(), parseComments );
+}
+
+XmlView::Node XmlView::getDocument() const
+{
+	return Node( &mDocument->mDoc );
+}
+
+boost::string_ref XmlView::getDocType() const
+{
+	for( const rapidxml::xml_node<> *node = mDocument->mDoc.first_node(); node; node = node->next_sibling() ) {
+		if( node->type() == rapidxml::node_doctype )
+			return boost::string_ref( node->value(), node->value_size() );
+	}
+
+	return boost::string_ref();
+}
+
+boost::string_ref XmlView::Attr::getName() const
+{
+	return boost::string_ref( mAttr->name(), mAttr->name_size() );
+}
+
+boost::string_ref XmlView::Attr::getValue() const
+{
+	return boost::string_ref( mAttr->value(), mAttr->value_size() );
+}
+
+XmlView::Attr XmlView::Attr::getNextAttribute() const
+{
+	return Attr( mAttr->next_attribute() );
+}
+
+XmlView::ChildIter::ChildIter( const rapidxml::xml_node<> *node, const boost::string_ref &tag, bool caseSensitive )
+	: mNode( node ), mTag( tag ), mCaseSensitive( caseSensitive )
+{
+	while( mNode && ! ( isVisibleChild( mNode ) && ( mTag.empty() || tagsMatch( mNode->name(), mNode->name_size(), mTag, mCaseSensitive ) ) ) )
+		mNode = mNode->next_sibling();
+}
+
+XmlView::ChildIter& XmlView::ChildIter::operator++()
+{
+	do {
+		mNode = mNode->next_sibling();
+	} while( mNode && ! ( isVisibleChild( mNode ) && ( mTag.empty() || tagsMatch( mNode->name(), mNode->name_size(), mTag, mCaseSensitive ) ) ) );
+
+	return *this;
+}
+
+XmlTree::NodeType XmlView::Node::getNodeType() const
+{
+	switch( mNode->type() ) {
+		case rapidxml::node_document:	return XmlTree::NODE_DOCUMENT;
+		case rapidxml::node_element:	return XmlTree::NODE_ELEMENT;
+		case rapidxml::node_cdata:		return XmlTree::NODE_CDATA;
+		case rapidxml::node_comment:	return XmlTree::NODE_COMMENT;
+		case rapidxml::node_data:		return XmlTree::NODE_DATA;
+		default:						return XmlTree::NODE_UNKNOWN;
+	}
+}
+
+boost::string_ref XmlView::Node::getTag() const
+{
+	return boost::string_ref( mNode->name(), mNode->name_size() );
+}
+
+boost::string_ref XmlView::Node::getValue() const
+{
+	return boost::string_ref( mNode->value(), mNode->value_size() );
+}
+
+bool XmlView::Node::hasAttribute( const boost::string_ref &attrName ) const
+{
+	return findAttribute( mNode, attrName ) != nullptr;
+}
+
+boost::string_ref XmlView::Node::getAttributeValue( const boost::string_ref &attrName ) const
+{
+	const rapidxml::xml_attribute<> *attr = findAttribute( mNode, attrName );
+	if( ! attr )
+		throw ExcAttrNotFound( *this, attrName );
+
+	return boost::string_ref( attr->value(), attr->value_size() );
+}
+
+boost::string_ref XmlView::Node::operator[]( const boost::string_ref &attrName ) const
+{
+	const rapidxml::xml_attribute<> *attr = findAttribute( mNode, attrName );
+	return attr ? boost::string_ref( attr->value(), attr->value_size() ) : boost::string_ref();
+}
+
+XmlView::Attr XmlView::Node::getFirstAttribute() const
+{
+	return Attr( mNode->first_attribute() );
+}
+
+XmlView::Node XmlView::Node::find( const boost::string_ref &relativePath, bool caseSensitive, char separator ) const
+{
+	// a leading separator is ignored so that "/one/two" is equivalent to "one/two"
+	boost::string_ref path = relativePath;
+	if( ! path.empty() && path[0] == separator )
+		path.remove_prefix( 1 );
+	if( path.empty() )
+		return Node();
+
+	return Node( findPath( mNode, path, caseSensitive, separator ) );
+}
+
+XmlView::Node XmlView::Node::getChild( const boost::string_ref &relativePath, bool caseSensitive, char separator ) const
+{
+	const rapidxml::xml_node<> *child = getNodePtr( relativePath, caseSensitive, separator );
+	if( ! child )
+		throw ExcChildNotFound( *this, relativePath );
+
+	return Node( child );
+}
+
+bool XmlView::Node::hasParent() const
+{
+	return mNode->parent() != nullptr;
+}
+
+XmlView::Node XmlView::Node::getParent() const
+{
+	return Node( mNode->parent() );
+}
+
+string XmlView::Node::getPath( char separator ) const
+{
+	string result;
+	for( const rapidxml::xml_node<> *node = mNode; node && node->type() != rapidxml::node_document; node = node->parent() ) {
+		if( node != mNode )
+			result.insert( result.begin(), separator );
+		result.insert( 0, node->name(), node->name_size() );
+	}
+
+	return result;
+}
+
+XmlTree XmlView::Node::createXmlTree( const XmlTree::ParseOptions &parseOptions ) const
+{
+	XmlTree result;
+	parseItem( *mNode, NULL, &result, parseOptions );
+	result.setNodeType( getNodeType() ); // call this after parse - parseItem() replaces it
+	return result;
+}
+
+const rapidxml::xml_node<>* XmlView::Node::firstChild() const
+{
+	return mNode->first_node();
+}
+
+const rapidxml::xml_node<>* XmlView::Node::getNodePtr( const boost::string_ref &relativePath, bool caseSensitive, char separator ) const
+{
+	const rapidxml::xml_node<> *curNode = mNode;
+
+	for( size_t start = 0; start < relativePath.size(); ) {
+		const char *separatorPos = (const char*)memchr( relativePath.data() + start, separator, relativePath.size() - start );
+		const size_t end = separatorPos ? separatorPos - relativePath.data() : relativePath.size();
+		if( end > start ) {
+			const boost::string_ref component = relativePath.substr( start, end - start );
+			const rapidxml::xml_node<> *child = curNode->first_node();
+			while( child && ! ( isVisibleChild( child ) && tagsMatch( child->name(), child->name_size(), component, caseSensitive ) ) )
+				child = child->next_sibling();
+			if( ! child )
+				return nullptr;
+			curNode = child;
+		}
+		start = end + 1;
+	}
+
+	return curNode;
+}
+
+XmlView::ExcChildNotFound::ExcChildNotFound( const Node &node, const boost::string_ref &childPath ) throw()
+{
+#if defined( CINDER_MSW )
+	sprintf_s( mMessage, "Could not find child: %s for node: %s", childPath.to_string().c_str(), node.getPath().c_str() );
+#else
+	sprintf( mMessage, "Could not find child: %s for node: %s", childPath.to_string().c_str(), node.getPath().c_str() );
+#endif
+}
+
+XmlView::ExcAttrNotFound::ExcAttrNotFound( const Node &node, const boost::string_ref &attrName ) throw()
+{
+#if defined( CINDER_MSW )
+	sprintf_s( mMessage, "Could not find attribute: %s for node: %s", attrName.to_string().c_str(), node.getPath().c_str() );
+#else
+	sprintf( mMessage, "Could not find attribute: %s for node: %s", attrName.to_string().c_str(), node.getPath().c_str() );
+#endif
+}
+
+} // namespace cinder
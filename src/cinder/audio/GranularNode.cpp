@@ -0,0 +1,289 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cinder/audio/GranularNode.h"
+#include "cinder/audio/Context.h"
+#include "cinder/CinderMath.h"
+
+#define WINDOW_TABLE_SIZE 1024
+#define DEFAULT_MAX_GRAINS 256
+
+using namespace std;
+
+namespace cinder { namespace audio {
+
+namespace {
+
+// linear interpolation into a symmetric window table, pos range: 0 - ( tableSize - 1 )
+inline float windowLookup( const float *table, size_t tableSize, float pos )
+{
+	size_t index1 = (size_t)pos;
+	size_t index2 = min( index1 + 1, tableSize - 1 );
+	float frac = pos - (float)index1;
+
+	return table[index1] + frac * ( table[index2] - table[index1] );
+}
+
+// linear interpolation into a circular sample buffer, readPos range: 0 - arraySize
+inline float sampleLookup( const float *array, size_t arraySize, double readPos )
+{
+	size_t index1 = (size_t)readPos;
+	if( index1 >= arraySize )
+		index1 = 0;
+
+	size_t index2 = index1 + 1;
+	if( index2 >= arraySize )
+		index2 = 0;
+
+	float frac = float( readPos - (double)index1 );
+	return array[index1] + frac * ( array[index2] - array[index1] );
+}
+
+// wraps \a readPos into the range [0:numFrames)
+inline double wrapReadPos( double readPos, double numFrames )
+{
+	if( readPos >= numFrames || readPos < 0 ) {
+		readPos = fmod( readPos, numFrames );
+		if( readPos < 0 )
+			readPos += numFrames;
+	}
+
+	return readPos;
+}
+
+} // anonymous namespace
+
+GranularNode::GranularNode( const Format &format )
+	: InputNode( format ), mWindowType( dsp::WindowType::HANN ), mFramesUntilNextGrain( 0 ), mSampleRate( 0 ),
+		mDensity( 20 ), mOnsetJitter( 0 ), mGrainDuration( 0.05f ), mPosition( 0 ), mPositionJitter( 0 ), mRate( 1 ), mRateJitter( 0 ),
+		mGrainAmp( 1 ), mNumActiveGrains( 0 ), mNumDroppedGrains( 0 )
+{
+	setChannelMode( ChannelMode::SPECIFIED );
+	setMaxGrains( DEFAULT_MAX_GRAINS );
+}
+
+GranularNode::GranularNode( const BufferRef &buffer, const Format &format )
+	: InputNode( format ), mBuffer( buffer ), mWindowType( dsp::WindowType::HANN ), mFramesUntilNextGrain( 0 ), mSampleRate( 0 ),
+		mDensity( 20 ), mOnsetJitter( 0 ), mGrainDuration( 0.05f ), mPosition( 0 ), mPositionJitter( 0 ), mRate( 1 ), mRateJitter( 0 ),
+		mGrainAmp( 1 ), mNumActiveGrains( 0 ), mNumDroppedGrains( 0 )
+{
+	// force channel mode to match buffer
+	setChannelMode( ChannelMode::SPECIFIED );
+	if( mBuffer )
+		setNumChannels( mBuffer->getNumChannels() );
+
+	setMaxGrains( DEFAULT_MAX_GRAINS );
+}
+
+void GranularNode::initialize()
+{
+	mSampleRate = (float)getSampleRate();
+	mFramesUntilNextGrain = 0;
+	mGrainBuffer.setNumFrames( getFramesPerBlock() );
+
+	mWindow.setNumFrames( WINDOW_TABLE_SIZE );
+	dsp::generateWindow( mWindowType, mWindow.getData(), WINDOW_TABLE_SIZE );
+}
+
+void GranularNode::setBuffer( const BufferRef &buffer )
+{
+	lock_guard<mutex> lock( getContext()->getMutex() );
+
+	if( buffer && getNumChannels() != buffer->getNumChannels() ) {
+		setNumChannels( buffer->getNumChannels() );
+		configureConnections();
+	}
+
+	mBuffer = buffer;
+
+	// discard active grains, they may be reading past the end of the new buffer
+	for( size_t grainIndex : mActiveGrains )
+		mFreeGrains.push_back( grainIndex );
+
+	mActiveGrains.clear();
+}
+
+void GranularNode::setMaxGrains( size_t maxGrains )
+{
+	if( maxGrains == mGrains.size() )
+		return;
+
+	auto ctx = getContext();
+	unique_lock<mutex> lock;
+	if( ctx )
+		lock = unique_lock<mutex>( ctx->getMutex() );
+
+	mGrains.resize( maxGrains );
+	mActiveGrains.clear();
+	mActiveGrains.reserve( maxGrains );
+	mFreeGrains.clear();
+	mFreeGrains.reserve( maxGrains );
+	for( size_t i = 0; i < maxGrains; i++ )
+		mFreeGrains.push_back( maxGrains - i - 1 );
+}
+
+void GranularNode::setWindowType( dsp::WindowType windowType )
+{
+	if( mWindowType == windowType )
+		return;
+
+	auto ctx = getContext();
+	unique_lock<mutex> lock;
+	if( ctx )
+		lock = unique_lock<mutex>( ctx->getMutex() );
+
+	mWindowType = windowType;
+	if( isInitialized() )
+		dsp::generateWindow( mWindowType, mWindow.getData(), WINDOW_TABLE_SIZE );
+}
+
+uint64_t GranularNode::getNumDroppedGrains()
+{
+	return mNumDroppedGrains.exchange( 0 );
+}
+
+void GranularNode::startGrain( size_t frameOffset )
+{
+	if( mFreeGrains.empty() ) {
+		mNumDroppedGrains++;
+		return;
+	}
+
+	const size_t grainFrames = (size_t)max( 2.0f, mGrainDuration * mSampleRate );
+	const double bufferFrames = (double)mBuffer->getNumFrames();
+
+	float position = mPosition;
+	const float positionJitter = mPositionJitter;
+	if( positionJitter > 0 )
+		position += mRand.nextFloat( -positionJitter, positionJitter );
+
+	float rate = mRate;
+	const float rateJitter = mRateJitter;
+	if( rateJitter > 0 )
+		rate += mRand.nextFloat( -rateJitter, rateJitter );
+
+	size_t grainIndex = mFreeGrains.back();
+	mFreeGrains.pop_back();
+	mActiveGrains.push_back( grainIndex );
+
+	Grain &grain = mGrains[grainIndex];
+	grain.mReadPos = wrapReadPos( (double)position * (double)mSampleRate, bufferFrames );
+	grain.mRate = rate;
+	grain.mAmp = mGrainAmp;
+	grain.mWindowPos = 0;
+	grain.mWindowIncr = float( WINDOW_TABLE_SIZE - 1 ) / float( grainFrames - 1 );
+	grain.mFramesLeft = grainFrames;
+	grain.mStartOffset = frameOffset;
+}
+
+void GranularNode::renderGrain( Grain *grain, Buffer *buffer, size_t frameBegin, size_t frameEnd )
+{
+	frameBegin = max( frameBegin, grain->mStartOffset );
+	const size_t numFrames = min( frameEnd - frameBegin, grain->mFramesLeft );
+	const size_t numChannels = min( buffer->getNumChannels(), mBuffer->getNumChannels() );
+	const size_t bufferFrames = mBuffer->getNumFrames();
+	const double bufferFramesD = (double)bufferFrames;
+	const double rate = (double)grain->mRate;
+	const float *window = mWindow.getData();
+	float *envelope = mGrainBuffer.getData();
+
+	// compute the grain's envelope for this block once, then apply it to each channel.
+	float windowPos = grain->mWindowPos;
+	const float windowIncr = grain->mWindowIncr;
+	const float amp = grain->mAmp;
+	for( size_t i = 0; i < numFrames; i++ ) {
+		envelope[i] = windowLookup( window, WINDOW_TABLE_SIZE, windowPos ) * amp;
+		windowPos = min( windowPos + windowIncr, float( WINDOW_TABLE_SIZE - 1 ) );
+	}
+
+	double readPos = grain->mReadPos;
+	for( size_t ch = 0; ch < numChannels; ch++ ) {
+		const float *source = mBuffer->getChannel( ch );
+		float *out = buffer->getChannel( ch ) + frameBegin;
+
+		readPos = grain->mReadPos;
+		for( size_t i = 0; i < numFrames; i++ ) {
+			out[i] += sampleLookup( source, bufferFrames, readPos ) * envelope[i];
+
+			readPos += rate;
+			if( readPos >= bufferFramesD )
+				readPos -= bufferFramesD;
+			else if( readPos < 0 )
+				readPos += bufferFramesD;
+		}
+	}
+
+	grain->mReadPos = wrapReadPos( readPos, bufferFramesD );
+	grain->mWindowPos = windowPos;
+	grain->mFramesLeft -= numFrames;
+	grain->mStartOffset = 0;
+}
+
+void GranularNode::process( Buffer *buffer )
+{
+	if( ! mBuffer || ! mBuffer->getNumFrames() ) {
+		mNumActiveGrains = 0;
+		return;
+	}
+
+	const auto &frameRange = getProcessFramesRange();
+
+	// schedule the grains with onsets that fall within this block
+	const float density = mDensity;
+	if( density > 0 ) {
+		const double framesPerGrain = (double)mSampleRate / (double)density;
+		double frame = (double)frameRange.first + mFramesUntilNextGrain;
+
+		while( frame < (double)frameRange.second ) {
+			startGrain( (size_t)frame );
+
+			double interval = framesPerGrain;
+			const float onsetJitter = mOnsetJitter;
+			if( onsetJitter > 0 )
+				interval *= 1.0 + (double)mRand.nextFloat( -onsetJitter, onsetJitter );
+
+			frame += max( interval, 1.0 );
+		}
+
+		mFramesUntilNextGrain = frame - (double)frameRange.second;
+	}
+
+	// render all active grains, returning finished ones to the pool.
+	for( size_t i = 0; i < mActiveGrains.size(); ) {
+		const size_t grainIndex = mActiveGrains[i];
+		Grain *grain = &mGrains[grainIndex];
+		renderGrain( grain, buffer, frameRange.first, frameRange.second );
+
+		if( grain->mFramesLeft == 0 ) {
+			mActiveGrains[i] = mActiveGrains.back();
+			mActiveGrains.pop_back();
+			mFreeGrains.push_back( grainIndex );
+		}
+		else
+			i++;
+	}
+
+	mNumActiveGrains = mActiveGrains.size();
+}
+
+} } // namespace cinder::audio
@@ -0,0 +1,377 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cinder/audio/MultiTapDelayNode.h"
+#include "cinder/audio/Context.h"
+#include "cinder/audio/dsp/Dsp.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/CinderMath.h"
+
+// the shortest delay that can be read, in frames. All interpolators read the current sample at most.
+#define MIN_DELAY_FRAMES 1
+// extra frames kept in each delay line for the interpolators that read past the integer delay position.
+#define INTERPOLATION_PADDING_FRAMES 4
+
+using namespace std;
+
+namespace cinder { namespace audio {
+
+namespace {
+
+// Delay lines are a power of two frames long, so all reads wrap with \a mask. The read position for frame i is
+// writeIndex + i - delayFrames[i], where the sample at writeIndex + i has already been written this block.
+
+inline void readLinear( const float *line, size_t mask, size_t writeIndex, const float *delayFrames, float *result, size_t numFrames )
+{
+	for( size_t i = 0; i < numFrames; i++ ) {
+		const size_t delayInt = (size_t)delayFrames[i];
+		const float frac = delayFrames[i] - (float)delayInt;
+		const size_t index = ( writeIndex + i - delayInt ) & mask;
+
+		const float x0 = line[index];
+		const float x1 = line[( index - 1 ) & mask];
+		result[i] = x0 + frac * ( x1 - x0 );
+	}
+}
+
+// 4-point, 3rd order Hermite interpolation between the samples at delayInt and delayInt + 1.
+inline void readCubic( const float *line, size_t mask, size_t writeIndex, const float *delayFrames, float *result, size_t numFrames )
+{
+	for( size_t i = 0; i < numFrames; i++ ) {
+		const size_t delayInt = (size_t)delayFrames[i];
+		const float t = delayFrames[i] - (float)delayInt;
+		const size_t index = ( writeIndex + i - delayInt ) & mask;
+
+		const float xm1 = line[( index + 1 ) & mask];
+		const float x0 = line[index];
+		const float x1 = line[( index - 1 ) & mask];
+		const float x2 = line[( index - 2 ) & mask];
+
+		const float c1 = 0.5f * ( x1 - xm1 );
+		const float c2 = xm1 - 2.5f * x0 + 2 * x1 - 0.5f * x2;
+		const float c3 = 0.5f * ( x2 - xm1 ) + 1.5f * ( x0 - x1 );
+		result[i] = ( ( c3 * t + c2 ) * t + c1 ) * t + x0;
+	}
+}
+
+// First-order allpass interpolation. The fractional part is kept within [0.5:1.5), where the filter coefficient stays small
+// and the phase delay is closest to linear. \a state holds the previous output, and is carried across blocks.
+inline void readAllpass( const float *line, size_t mask, size_t writeIndex, const float *delayFrames, float *state, float *result, size_t numFrames )
+{
+	float y1 = *state;
+	for( size_t i = 0; i < numFrames; i++ ) {
+		const size_t delayInt = (size_t)( delayFrames[i] - 0.5f );
+		const float frac = delayFrames[i] - (float)delayInt;
+		const float a = ( 1 - frac ) / ( 1 + frac );
+		const size_t index = ( writeIndex + i - delayInt ) & mask;
+
+		y1 = a * ( line[index] - y1 ) + line[( index - 1 ) & mask];
+		result[i] = y1;
+	}
+
+	*state = y1;
+}
+
+// writes \a length samples of \a source scaled by \a gain into \a line at \a writeIndex, wrapping around at \a lineFrames.
+inline void writeScaled( const float *source, float gain, float *line, size_t lineFrames, size_t writeIndex, size_t length )
+{
+	const size_t firstLength = min( length, lineFrames - writeIndex );
+	dsp::mul( source, gain, line + writeIndex, firstLength );
+	dsp::mul( source + firstLength, gain, line, length - firstLength );
+}
+
+inline void addScaled( const float *source, float gain, float *dest, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		dest[i] += source[i] * gain;
+}
+
+// accumulates \a length samples of \a source scaled by \a gain into \a line at \a writeIndex, wrapping around at \a lineFrames.
+inline void addScaled( const float *source, float gain, float *line, size_t lineFrames, size_t writeIndex, size_t length )
+{
+	const size_t firstLength = min( length, lineFrames - writeIndex );
+	addScaled( source, gain, line + writeIndex, firstLength );
+	addScaled( source + firstLength, gain, line, length - firstLength );
+}
+
+inline size_t nextPowerOfTwo( size_t x )
+{
+	size_t result = 1;
+	while( result < x )
+		result <<= 1;
+
+	return result;
+}
+
+} // anonymous namespace
+
+MultiTapDelayNode::MultiTapDelayNode( size_t numTaps, const Format &format )
+	: Node( format ), mInterpolation( Interpolation::CUBIC ), mWriteIndex( 0 ), mMaxDelaySeconds( 0 ), mMaxDelayFrames( MIN_DELAY_FRAMES ),
+		mSampleRate( 0 ), mDryGain( 0 ), mGainsDirty( true ), mTapDryGain( 0 )
+{
+	CI_ASSERT( numTaps > 0 );
+
+	for( size_t t = 0; t < numTaps; t++ )
+		mParamsDelaySeconds.emplace_back( new Param( this, 0 ) );
+
+	mInputGains.resize( numTaps, 1 );
+	mOutputGains.resize( numTaps, 1 );
+	mFeedbackMatrix.resize( numTaps * numTaps, 0 );
+	mTapInputGains.resize( numTaps );
+	mTapOutputGains.resize( numTaps );
+	mTapFeedbackMatrix.resize( numTaps * numTaps );
+}
+
+float MultiTapDelayNode::getDelaySeconds( size_t tap ) const
+{
+	CI_ASSERT( tap < getNumTaps() );
+	return mParamsDelaySeconds[tap]->getValue();
+}
+
+Param* MultiTapDelayNode::getParamDelaySeconds( size_t tap )
+{
+	CI_ASSERT( tap < getNumTaps() );
+	return mParamsDelaySeconds[tap].get();
+}
+
+void MultiTapDelayNode::setDelaySeconds( size_t tap, float seconds )
+{
+	CI_ASSERT( tap < getNumTaps() );
+
+	seconds = math<float>::max( seconds, 0 );
+
+	mParamsDelaySeconds[tap]->setValue( seconds );
+
+	if( seconds > mMaxDelaySeconds )
+		setMaxDelaySeconds( seconds );
+}
+
+void MultiTapDelayNode::setMaxDelaySeconds( float seconds )
+{
+	lock_guard<mutex> lock( getContext()->getMutex() );
+
+	mMaxDelaySeconds = math<float>::max( seconds, 0 );
+	resizeDelayLines();
+}
+
+void MultiTapDelayNode::setInputGain( size_t tap, float gain )
+{
+	CI_ASSERT( tap < getNumTaps() );
+
+	lock_guard<mutex> lock( mGainsMutex );
+	mInputGains[tap] = gain;
+	mGainsDirty = true;
+}
+
+float MultiTapDelayNode::getInputGain( size_t tap ) const
+{
+	CI_ASSERT( tap < getNumTaps() );
+	return mInputGains[tap];
+}
+
+void MultiTapDelayNode::setOutputGain( size_t tap, float gain )
+{
+	CI_ASSERT( tap < getNumTaps() );
+
+	lock_guard<mutex> lock( mGainsMutex );
+	mOutputGains[tap] = gain;
+	mGainsDirty = true;
+}
+
+float MultiTapDelayNode::getOutputGain( size_t tap ) const
+{
+	CI_ASSERT( tap < getNumTaps() );
+	return mOutputGains[tap];
+}
+
+void MultiTapDelayNode::setDryGain( float gain )
+{
+	lock_guard<mutex> lock( mGainsMutex );
+	mDryGain = gain;
+	mGainsDirty = true;
+}
+
+float MultiTapDelayNode::getDryGain() const
+{
+	return mDryGain;
+}
+
+void MultiTapDelayNode::setFeedback( size_t destTap, size_t sourceTap, float gain )
+{
+	CI_ASSERT( destTap < getNumTaps() && sourceTap < getNumTaps() );
+
+	lock_guard<mutex> lock( mGainsMutex );
+	mFeedbackMatrix[destTap * getNumTaps() + sourceTap] = gain;
+	mGainsDirty = true;
+}
+
+float MultiTapDelayNode::getFeedback( size_t destTap, size_t sourceTap ) const
+{
+	CI_ASSERT( destTap < getNumTaps() && sourceTap < getNumTaps() );
+	return mFeedbackMatrix[destTap * getNumTaps() + sourceTap];
+}
+
+void MultiTapDelayNode::setFeedbackMatrix( const vector<float> &matrix )
+{
+	CI_ASSERT_MSG( matrix.size() == mFeedbackMatrix.size(), "feedback matrix must have numTaps * numTaps elements" );
+
+	lock_guard<mutex> lock( mGainsMutex );
+	copy( matrix.begin(), matrix.end(), mFeedbackMatrix.begin() );
+	mGainsDirty = true;
+}
+
+vector<float> MultiTapDelayNode::getFeedbackMatrix() const
+{
+	return mFeedbackMatrix;
+}
+
+void MultiTapDelayNode::setInterpolation( Interpolation interpolation )
+{
+	mInterpolation = interpolation;
+}
+
+void MultiTapDelayNode::clearBuffer()
+{
+	lock_guard<mutex> lock( getContext()->getMutex() );
+
+	mDelayLines.zero();
+	fill( mAllpassStates.begin(), mAllpassStates.end(), 0.0f );
+}
+
+void MultiTapDelayNode::initialize()
+{
+	mSampleRate = (float)getSampleRate();
+
+	mTapBuffer.setSize( getFramesPerBlock(), getNumTaps() );
+	mDelayFramesBuffer.setSize( getFramesPerBlock(), getNumTaps() );
+
+	resizeDelayLines();
+}
+
+// Must be called with the Context's mutex locked, or from initialize().
+void MultiTapDelayNode::resizeDelayLines()
+{
+	const size_t framesPerBlock = getFramesPerBlock();
+	const size_t maxDelayFrames = max<size_t>( MIN_DELAY_FRAMES, (size_t)lroundf( mMaxDelaySeconds * (float)getSampleRate() ) );
+
+	// the current block is written before it is read, so the line must hold the max delay plus one block without wrapping onto itself.
+	const size_t lineFrames = nextPowerOfTwo( maxDelayFrames + framesPerBlock + INTERPOLATION_PADDING_FRAMES );
+
+	mDelayLines.setSize( lineFrames, getNumTaps() * getNumChannels() );
+	mDelayLines.zero();
+	mAllpassStates.assign( getNumTaps() * getNumChannels(), 0.0f );
+
+	mMaxDelayFrames = (float)maxDelayFrames;
+	mWriteIndex = 0;
+}
+
+// Called from the audio thread. If the lock can't be acquired, the updated gains are picked up on the next block instead of blocking.
+void MultiTapDelayNode::syncGains()
+{
+	if( ! mGainsDirty )
+		return;
+
+	unique_lock<mutex> lock( mGainsMutex, try_to_lock );
+	if( ! lock.owns_lock() )
+		return;
+
+	copy( mInputGains.begin(), mInputGains.end(), mTapInputGains.begin() );
+	copy( mOutputGains.begin(), mOutputGains.end(), mTapOutputGains.begin() );
+	copy( mFeedbackMatrix.begin(), mFeedbackMatrix.end(), mTapFeedbackMatrix.begin() );
+	mTapDryGain = mDryGain;
+
+	mGainsDirty = false;
+}
+
+void MultiTapDelayNode::process( Buffer *buffer )
+{
+	syncGains();
+
+	const size_t numFrames = buffer->getNumFrames();
+	const size_t numChannels = buffer->getNumChannels();
+	const size_t numTaps = getNumTaps();
+	const size_t lineFrames = mDelayLines.getNumFrames();
+	const size_t mask = lineFrames - 1;
+	const size_t writeIndex = mWriteIndex;
+	const float sampleRate = mSampleRate;
+	const float maxDelayFrames = mMaxDelayFrames;
+	const Interpolation interpolation = mInterpolation;
+
+	if( mDelayLines.getNumChannels() != numTaps * numChannels || numFrames > mTapBuffer.getNumFrames() )
+		return;
+
+	// convert each tap's delay seconds to clamped frames once per block, these are shared by all channels.
+	for( size_t t = 0; t < numTaps; t++ ) {
+		Param *param = mParamsDelaySeconds[t].get();
+		float *delayFrames = mDelayFramesBuffer.getChannel( t );
+
+		if( param->eval() ) {
+			const float *delaySeconds = param->getValueArray();
+			for( size_t i = 0; i < numFrames; i++ )
+				delayFrames[i] = math<float>::clamp( delaySeconds[i] * sampleRate, MIN_DELAY_FRAMES, maxDelayFrames );
+		}
+		else
+			dsp::fill( math<float>::clamp( param->getValue() * sampleRate, MIN_DELAY_FRAMES, maxDelayFrames ), delayFrames, numFrames );
+	}
+
+	for( size_t ch = 0; ch < numChannels; ch++ ) {
+		float *channel = buffer->getChannel( ch );
+
+		// write this block's input to every tap before reading, so that delays shorter than a block are possible.
+		for( size_t t = 0; t < numTaps; t++ )
+			writeScaled( channel, mTapInputGains[t], mDelayLines.getChannel( ch * numTaps + t ), lineFrames, writeIndex, numFrames );
+
+		for( size_t t = 0; t < numTaps; t++ ) {
+			const float *line = mDelayLines.getChannel( ch * numTaps + t );
+			const float *delayFrames = mDelayFramesBuffer.getChannel( t );
+			float *tapOutput = mTapBuffer.getChannel( t );
+
+			switch( interpolation ) {
+				case Interpolation::LINEAR:		readLinear( line, mask, writeIndex, delayFrames, tapOutput, numFrames ); break;
+				case Interpolation::CUBIC:		readCubic( line, mask, writeIndex, delayFrames, tapOutput, numFrames ); break;
+				case Interpolation::ALLPASS:	readAllpass( line, mask, writeIndex, delayFrames, &mAllpassStates[ch * numTaps + t], tapOutput, numFrames ); break;
+			}
+		}
+
+		// mix the tap outputs back into this block of each tap's delay line through the feedback matrix.
+		for( size_t destTap = 0; destTap < numTaps; destTap++ ) {
+			float *line = mDelayLines.getChannel( ch * numTaps + destTap );
+			const float *feedbackRow = &mTapFeedbackMatrix[destTap * numTaps];
+
+			for( size_t sourceTap = 0; sourceTap < numTaps; sourceTap++ ) {
+				if( feedbackRow[sourceTap] != 0 )
+					addScaled( mTapBuffer.getChannel( sourceTap ), feedbackRow[sourceTap], line, lineFrames, writeIndex, numFrames );
+			}
+		}
+
+		dsp::mul( channel, mTapDryGain, channel, numFrames );
+		for( size_t t = 0; t < numTaps; t++ ) {
+			if( mTapOutputGains[t] != 0 )
+				addScaled( mTapBuffer.getChannel( t ), mTapOutputGains[t], channel, numFrames );
+		}
+	}
+
+	mWriteIndex = ( writeIndex + numFrames ) & mask;
+}
+
+} } // namespace cinder::audio
@@ -0,0 +1,349 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cinder/audio/OscillatorBankNode.h"
+#include "cinder/audio/Context.h"
+#include "cinder/CinderMath.h"
+
+#define DEFAULT_TABLE_SIZE 4096
+#define DEFAULT_BANDLIMITED_TABLES 40
+
+using namespace std;
+
+namespace cinder { namespace audio {
+
+namespace {
+
+// linear interpolation, phase range: 0 - 1. tableSize must be a power of 2.
+inline float tableLookup( const float *table, size_t tableSize, float phase )
+{
+	float lookup = phase * tableSize;
+	size_t index1 = (size_t)lookup;
+	size_t index2 = ( index1 + 1 ) & ( tableSize - 1 );
+	float val1 = table[index1 & ( tableSize - 1 )];
+	float val2 = table[index2];
+	float frac = lookup - (float)index1;
+
+	return val1 + frac * ( val2 - val1 );
+}
+
+// accumulates \a source scaled by \a gain into \a dest
+inline void addScaled( const float *source, float gain, float *dest, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		dest[i] += source[i] * gain;
+}
+
+} // anonymous namespace
+
+OscillatorBankNode::OscillatorBankNode( size_t numVoices, const Format &format )
+	: InputNode( format ), mWaveformType( WaveformType::SINE ), mSamplePeriod( 0 ), mParamsDirty( false )
+{
+	resizeVoices( numVoices );
+}
+
+OscillatorBankNode::OscillatorBankNode( WaveformType waveformType, size_t numVoices, const Format &format )
+	: InputNode( format ), mWaveformType( waveformType ), mSamplePeriod( 0 ), mParamsDirty( false )
+{
+	resizeVoices( numVoices );
+}
+
+void OscillatorBankNode::initialize()
+{
+	mSamplePeriod = 1.0f / (float)getSampleRate();
+	mVoiceBuffer.setNumFrames( getFramesPerBlock() );
+
+	size_t sampleRate = getSampleRate();
+	bool needsFill = false;
+	if( ! mWaveTable ) {
+		mWaveTable.reset( new WaveTable2d( sampleRate, DEFAULT_TABLE_SIZE, DEFAULT_BANDLIMITED_TABLES ) );
+		needsFill = true;
+	}
+	else if( sampleRate != mWaveTable->getSampleRate() ) {
+		mWaveTable->setSampleRate( sampleRate );
+		needsFill = true;
+	}
+
+	if( needsFill )
+		mWaveTable->fillBandlimited( mWaveformType );
+
+	// channel count may have changed, so recompute all pan gains.
+	lock_guard<mutex> lock( mParamsMutex );
+	for( size_t v = 0; v < mPans.size(); v++ )
+		updatePanGains( v );
+
+	mParamsDirty = true;
+}
+
+void OscillatorBankNode::setNumVoices( size_t numVoices )
+{
+	if( numVoices == getNumVoices() )
+		return;
+
+	auto ctx = getContext();
+	if( ctx ) {
+		lock_guard<mutex> lock( ctx->getMutex() );
+		resizeVoices( numVoices );
+	}
+	else
+		resizeVoices( numVoices );
+}
+
+void OscillatorBankNode::resizeVoices( size_t numVoices )
+{
+	lock_guard<mutex> lock( mParamsMutex );
+
+	size_t prevNumVoices = mPans.size();
+
+	mFreqs.resize( numVoices, 0 );
+	mAmps.resize( numVoices, 0 );
+	mPans.resize( numVoices, 0.5f );
+	mResetPhases.resize( numVoices, -1 );
+	mPanGains1.resize( numVoices, 0 );
+	mPanGains2.resize( numVoices, 0 );
+	mPanChannels.resize( numVoices, 0 );
+
+	mVoiceFreqs.resize( numVoices, 0 );
+	mVoiceAmps.resize( numVoices, 0 );
+	mVoiceCurrentAmps.resize( numVoices, 0 );
+	mVoicePhases.resize( numVoices, 0 );
+	mVoicePanGains1.resize( numVoices, 0 );
+	mVoicePanGains2.resize( numVoices, 0 );
+	mVoiceChannels.resize( numVoices, 0 );
+
+	for( size_t v = prevNumVoices; v < numVoices; v++ ) {
+		updatePanGains( v );
+		mVoiceChannels[v] = mPanChannels[v];
+		mVoicePanGains1[v] = mPanGains1[v];
+		mVoicePanGains2[v] = mPanGains2[v];
+	}
+}
+
+void OscillatorBankNode::setFreq( size_t voice, float freq )
+{
+	CI_ASSERT( voice < getNumVoices() );
+
+	lock_guard<mutex> lock( mParamsMutex );
+	mFreqs[voice] = freq;
+	mParamsDirty = true;
+}
+
+void OscillatorBankNode::setAmp( size_t voice, float amp )
+{
+	CI_ASSERT( voice < getNumVoices() );
+
+	lock_guard<mutex> lock( mParamsMutex );
+	mAmps[voice] = amp;
+	mParamsDirty = true;
+}
+
+void OscillatorBankNode::setPan( size_t voice, float pan )
+{
+	CI_ASSERT( voice < getNumVoices() );
+
+	lock_guard<mutex> lock( mParamsMutex );
+	mPans[voice] = math<float>::clamp( pan );
+	updatePanGains( voice );
+	mParamsDirty = true;
+}
+
+void OscillatorBankNode::setPhase( size_t voice, float phase )
+{
+	CI_ASSERT( voice < getNumVoices() );
+
+	lock_guard<mutex> lock( mParamsMutex );
+	mResetPhases[voice] = fract( phase );
+	mParamsDirty = true;
+}
+
+void OscillatorBankNode::setFreqs( const float *freqs, size_t count, size_t firstVoice )
+{
+	CI_ASSERT( firstVoice + count <= getNumVoices() );
+
+	lock_guard<mutex> lock( mParamsMutex );
+	copy( freqs, freqs + count, mFreqs.begin() + firstVoice );
+	mParamsDirty = true;
+}
+
+void OscillatorBankNode::setAmps( const float *amps, size_t count, size_t firstVoice )
+{
+	CI_ASSERT( firstVoice + count <= getNumVoices() );
+
+	lock_guard<mutex> lock( mParamsMutex );
+	copy( amps, amps + count, mAmps.begin() + firstVoice );
+	mParamsDirty = true;
+}
+
+void OscillatorBankNode::setPans( const float *pans, size_t count, size_t firstVoice )
+{
+	CI_ASSERT( firstVoice + count <= getNumVoices() );
+
+	lock_guard<mutex> lock( mParamsMutex );
+	for( size_t i = 0; i < count; i++ ) {
+		mPans[firstVoice + i] = math<float>::clamp( pans[i] );
+		updatePanGains( firstVoice + i );
+	}
+	mParamsDirty = true;
+}
+
+float OscillatorBankNode::getFreq( size_t voice ) const
+{
+	CI_ASSERT( voice < getNumVoices() );
+	return mFreqs[voice];
+}
+
+float OscillatorBankNode::getAmp( size_t voice ) const
+{
+	CI_ASSERT( voice < getNumVoices() );
+	return mAmps[voice];
+}
+
+float OscillatorBankNode::getPan( size_t voice ) const
+{
+	CI_ASSERT( voice < getNumVoices() );
+	return mPans[voice];
+}
+
+void OscillatorBankNode::setWaveform( WaveformType waveformType )
+{
+	if( mWaveformType == waveformType )
+		return;
+
+	if( ! isInitialized() )
+		getContext()->initializeNode( shared_from_this() );
+
+	lock_guard<mutex> lock( getContext()->getMutex() );
+
+	mWaveformType = waveformType;
+	mWaveTable->fillBandlimited( waveformType );
+}
+
+void OscillatorBankNode::setWaveTable( const WaveTable2dRef &waveTable )
+{
+	auto ctx = getContext();
+	if( ctx ) {
+		lock_guard<mutex> lock( ctx->getMutex() );
+		mWaveTable = waveTable;
+	}
+	else
+		mWaveTable = waveTable;
+}
+
+// Computes the equal-power gains used to spread a voice between the two output channels adjacent to its pan position.
+// Must be called with mParamsMutex locked, the result is picked up by the audio thread in syncVoiceParams().
+void OscillatorBankNode::updatePanGains( size_t voice )
+{
+	const size_t numChannels = getNumChannels();
+	if( numChannels <= 1 ) {
+		mPanChannels[voice] = 0;
+		mPanGains1[voice] = 1;
+		mPanGains2[voice] = 0;
+		return;
+	}
+
+	const float pos = mPans[voice] * float( numChannels - 1 );
+	const size_t channel = min( (size_t)pos, numChannels - 2 );
+	const float frac = pos - (float)channel;
+
+	mPanChannels[voice] = channel;
+	mPanGains1[voice] = math<float>::cos( frac * float( M_PI / 2 ) );
+	mPanGains2[voice] = math<float>::sin( frac * float( M_PI / 2 ) );
+}
+
+// Called from the audio thread. If the lock can't be acquired, the updated parameters are picked up on the next block instead of blocking.
+void OscillatorBankNode::syncVoiceParams()
+{
+	if( ! mParamsDirty )
+		return;
+
+	unique_lock<mutex> lock( mParamsMutex, try_to_lock );
+	if( ! lock.owns_lock() )
+		return;
+
+	const size_t numVoices = mFreqs.size();
+	copy( mFreqs.begin(), mFreqs.end(), mVoiceFreqs.begin() );
+	copy( mAmps.begin(), mAmps.end(), mVoiceAmps.begin() );
+	copy( mPanChannels.begin(), mPanChannels.end(), mVoiceChannels.begin() );
+	copy( mPanGains1.begin(), mPanGains1.end(), mVoicePanGains1.begin() );
+	copy( mPanGains2.begin(), mPanGains2.end(), mVoicePanGains2.begin() );
+
+	for( size_t v = 0; v < numVoices; v++ ) {
+		if( mResetPhases[v] >= 0 ) {
+			mVoicePhases[v] = mResetPhases[v];
+			mResetPhases[v] = -1;
+		}
+	}
+
+	mParamsDirty = false;
+}
+
+void OscillatorBankNode::process( Buffer *buffer )
+{
+	syncVoiceParams();
+
+	const auto &frameRange = getProcessFramesRange();
+	const size_t numFrames = frameRange.second - frameRange.first;
+	const size_t numVoices = mVoiceFreqs.size();
+	const size_t numChannels = buffer->getNumChannels();
+	const size_t tableSize = mWaveTable->getTableSize();
+	const float samplePeriod = mSamplePeriod;
+	const float rampScale = 1.0f / (float)numFrames;
+	float *voiceData = mVoiceBuffer.getData();
+
+	for( size_t v = 0; v < numVoices; v++ ) {
+		const float f0 = mVoiceFreqs[v];
+		const float phaseIncr = f0 * samplePeriod;
+		float phase = mVoicePhases[v];
+
+		float amp = mVoiceCurrentAmps[v];
+		const float targetAmp = mVoiceAmps[v];
+
+		// silent voices only need their phase advanced, so that they remain coherent when made audible again.
+		if( amp == 0 && targetAmp == 0 ) {
+			mVoicePhases[v] = fract( phase + phaseIncr * (float)numFrames );
+			continue;
+		}
+
+		const float *table = mWaveTable->getBandLimitedTable( f0 );
+		const float ampIncr = ( targetAmp - amp ) * rampScale;
+
+		for( size_t i = 0; i < numFrames; i++ ) {
+			voiceData[i] = tableLookup( table, tableSize, phase ) * amp;
+			phase = fract( phase + phaseIncr );
+			amp += ampIncr;
+		}
+
+		mVoicePhases[v] = phase;
+		mVoiceCurrentAmps[v] = targetAmp;
+
+		const size_t channel = mVoiceChannels[v];
+		if( numChannels == 1 )
+			addScaled( voiceData, 1, buffer->getChannel( 0 ) + frameRange.first, numFrames );
+		else if( channel + 1 < numChannels ) {
+			addScaled( voiceData, mVoicePanGains1[v], buffer->getChannel( channel ) + frameRange.first, numFrames );
+			addScaled( voiceData, mVoicePanGains2[v], buffer->getChannel( channel + 1 ) + frameRange.first, numFrames );
+		}
+	}
+}
+
+} } // namespace cinder::audio
@@ -0,0 +1,306 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cinder/audio/dsp/ConverterPolyphase.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/CinderMath.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+	#define CINDER_AUDIO_CONVERTER_SSE
+	#include <xmmintrin.h>
+#endif
+
+// number of filter phases stored per input sample, coefficients for the fractional positions in between are linearly interpolated.
+#define NUM_PHASES 256
+// upper limit on the filter length, which grows as the ratio lowers when downsampling.
+#define MAX_NUM_TAPS 1024
+
+using namespace std;
+
+namespace cinder { namespace audio { namespace dsp {
+
+namespace {
+
+struct QualitySpec {
+	size_t	mNumTaps;
+	double	mKaiserBeta;
+	double	mPassband;		// fraction of the lower nyquist frequency that is passed
+};
+
+QualitySpec getQualitySpec( ConverterImplPolyphase::Quality quality )
+{
+	switch( quality ) {
+		case ConverterImplPolyphase::Quality::LOW:		return { 8, 5.0, 0.80 };
+		case ConverterImplPolyphase::Quality::MEDIUM:	return { 24, 7.5, 0.90 };
+		case ConverterImplPolyphase::Quality::HIGH:		return { 48, 10.0, 0.94 };
+		default:										CI_ASSERT_NOT_REACHABLE();
+	}
+
+	return { 24, 7.5, 0.90 };
+}
+
+// zeroth order modified Bessel function of the first kind, used by the kaiser window
+double besselI0( double x )
+{
+	double sum = 1;
+	double term = 1;
+	const double halfX = x * 0.5;
+	for( int k = 1; k < 50; k++ ) {
+		term *= halfX / (double)k;
+		double termSquared = term * term;
+		sum += termSquared;
+		if( termSquared < sum * 1e-12 )
+			break;
+	}
+
+	return sum;
+}
+
+inline double sinc( double x )
+{
+	if( fabs( x ) < 1e-9 )
+		return 1;
+
+	return sin( M_PI * x ) / ( M_PI * x );
+}
+
+#if defined( CINDER_AUDIO_CONVERTER_SSE )
+
+// length must be a multiple of 4
+inline float dotProduct( const float *a, const float *b, size_t length )
+{
+	__m128 sum0 = _mm_setzero_ps();
+	__m128 sum1 = _mm_setzero_ps();
+
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		sum0 = _mm_add_ps( sum0, _mm_mul_ps( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i ) ) );
+		sum1 = _mm_add_ps( sum1, _mm_mul_ps( _mm_loadu_ps( a + i + 4 ), _mm_loadu_ps( b + i + 4 ) ) );
+	}
+	if( i < length )
+		sum0 = _mm_add_ps( sum0, _mm_mul_ps( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i ) ) );
+
+	sum0 = _mm_add_ps( sum0, sum1 );
+	sum0 = _mm_add_ps( sum0, _mm_movehl_ps( sum0, sum0 ) );
+	sum0 = _mm_add_ss( sum0, _mm_shuffle_ps( sum0, sum0, 1 ) );
+	return _mm_cvtss_f32( sum0 );
+}
+
+// result = a + alpha * ( b - a ), length must be a multiple of 4
+inline void interpolate( const float *a, const float *b, float alpha, float *result, size_t length )
+{
+	const __m128 alpha4 = _mm_set1_ps( alpha );
+	for( size_t i = 0; i < length; i += 4 ) {
+		__m128 a4 = _mm_loadu_ps( a + i );
+		__m128 b4 = _mm_loadu_ps( b + i );
+		_mm_storeu_ps( result + i, _mm_add_ps( a4, _mm_mul_ps( alpha4, _mm_sub_ps( b4, a4 ) ) ) );
+	}
+}
+
+#else
+
+// length must be a multiple of 4
+inline float dotProduct( const float *a, const float *b, size_t length )
+{
+	float sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+	for( size_t i = 0; i < length; i += 4 ) {
+		sum0 += a[i] * b[i];
+		sum1 += a[i + 1] * b[i + 1];
+		sum2 += a[i + 2] * b[i + 2];
+		sum3 += a[i + 3] * b[i + 3];
+	}
+
+	return ( sum0 + sum1 ) + ( sum2 + sum3 );
+}
+
+// result = a + alpha * ( b - a ), length must be a multiple of 4
+inline void interpolate( const float *a, const float *b, float alpha, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = a[i] + alpha * ( b[i] - a[i] );
+}
+
+#endif // defined( CINDER_AUDIO_CONVERTER_SSE )
+
+} // anonymous namespace
+
+ConverterImplPolyphase::ConverterImplPolyphase( size_t sourceSampleRate, size_t destSampleRate, size_t sourceNumChannels, size_t destNumChannels, size_t sourceMaxFramesPerBlock, Quality quality )
+	: Converter( sourceSampleRate, destSampleRate, sourceNumChannels, destNumChannels, sourceMaxFramesPerBlock ), mQuality( quality ),
+		mDesignCutoff( 0 ), mReadPos( 0 ), mNumTaps( 0 ), mNumPhases( NUM_PHASES ), mHistoryFrames( 0 )
+{
+	// resample the lesser amount of channels, mixing before when downmixing or after when upmixing
+	mNumResampledChannels = min( mSourceNumChannels, mDestNumChannels );
+
+	setRatio( (double)mDestSampleRate / (double)mSourceSampleRate );
+}
+
+void ConverterImplPolyphase::setRatio( double ratio )
+{
+	CI_ASSERT( ratio > 0 );
+
+	mRatio = ratio;
+	mStep = 1.0 / ratio;
+	mDestSampleRate = (size_t)lround( (double)mSourceSampleRate * ratio );
+	mDestMaxFramesPerBlock = (size_t)ceil( (double)mSourceMaxFramesPerBlock * ratio ) + 1;
+
+	// the cutoff is relative to the source nyquist frequency, when downsampling it must be lowered to the destination nyquist.
+	const double cutoff = min( 1.0, ratio ) * getQualitySpec( mQuality ).mPassband;
+	if( cutoff < mDesignCutoff * 0.999 || cutoff > mDesignCutoff * 1.2 )
+		designFilter( cutoff );
+
+	if( mSourceNumChannels > mDestNumChannels ) {
+		if( mMixingBuffer.getNumFrames() < mSourceMaxFramesPerBlock || mMixingBuffer.getNumChannels() != mDestNumChannels )
+			mMixingBuffer.setSize( mSourceMaxFramesPerBlock, mDestNumChannels );
+	}
+	else if( mSourceNumChannels < mDestNumChannels ) {
+		if( mMixingBuffer.getNumFrames() < mDestMaxFramesPerBlock || mMixingBuffer.getNumChannels() != mSourceNumChannels )
+			mMixingBuffer.setSize( mDestMaxFramesPerBlock, mSourceNumChannels );
+	}
+}
+
+void ConverterImplPolyphase::designFilter( double cutoff )
+{
+	const QualitySpec spec = getQualitySpec( mQuality );
+
+	// the filter spans more input samples the lower the cutoff, keep the tap count a multiple of 4 for the vectorized kernels.
+	size_t numTaps = (size_t)ceil( (double)spec.mNumTaps * spec.mPassband / cutoff );
+	numTaps = min<size_t>( ( numTaps + 3 ) & ~size_t( 3 ), MAX_NUM_TAPS );
+
+	const size_t halfTaps = numTaps / 2;
+	const double windowNormalizer = 1.0 / besselI0( spec.mKaiserBeta );
+
+	mPhaseTable.resize( ( mNumPhases + 1 ) * numTaps );
+	for( size_t p = 0; p <= mNumPhases; p++ ) {
+		const double frac = (double)p / (double)mNumPhases;
+		float *row = &mPhaseTable[p * numTaps];
+		for( size_t j = 0; j < numTaps; j++ ) {
+			// distance in input samples between the tap and the output frame
+			const double t = (double)j - (double)( halfTaps - 1 ) - frac;
+			const double x = t / (double)halfTaps;
+			const double window = fabs( x ) >= 1 ? 0 : besselI0( spec.mKaiserBeta * sqrt( 1 - x * x ) ) * windowNormalizer;
+
+			row[j] = float( cutoff * sinc( cutoff * t ) * window );
+		}
+	}
+
+	mCoeffs.resize( numTaps );
+	mDesignCutoff = cutoff;
+
+	if( numTaps != mNumTaps ) {
+		mNumTaps = numTaps;
+		mHistory.setSize( mNumTaps + 2 * mSourceMaxFramesPerBlock + 1, mNumResampledChannels );
+		clear();
+	}
+}
+
+void ConverterImplPolyphase::clear()
+{
+	// start with enough zero-valued frames so that the first output frame is aligned with the first input frame.
+	mHistory.zero();
+	mHistoryFrames = mNumTaps / 2 - 1;
+	mReadPos = (double)mHistoryFrames;
+}
+
+pair<size_t, size_t> ConverterImplPolyphase::convert( const Buffer *sourceBuffer, Buffer *destBuffer )
+{
+	CI_ASSERT( sourceBuffer->getNumChannels() == mSourceNumChannels && destBuffer->getNumChannels() == mDestNumChannels );
+
+	const size_t readCount = min( sourceBuffer->getNumFrames(), mSourceMaxFramesPerBlock );
+
+	// append the new source frames to the history, downmixing first if needed.
+	const Buffer *resampleSource = sourceBuffer;
+	if( mSourceNumChannels > mDestNumChannels ) {
+		mixBuffers( sourceBuffer, &mMixingBuffer, readCount );
+		resampleSource = &mMixingBuffer;
+	}
+
+	for( size_t ch = 0; ch < mNumResampledChannels; ch++ )
+		memcpy( mHistory.getChannel( ch ) + mHistoryFrames, resampleSource->getChannel( ch ), readCount * sizeof( float ) );
+
+	mHistoryFrames += readCount;
+
+	size_t outCount;
+	if( mSourceNumChannels < mDestNumChannels ) {
+		outCount = process( readCount, &mMixingBuffer, min( mMixingBuffer.getNumFrames(), destBuffer->getNumFrames() ) );
+		mixBuffers( &mMixingBuffer, destBuffer, outCount );
+	}
+	else
+		outCount = process( readCount, destBuffer, destBuffer->getNumFrames() );
+
+	return make_pair( readCount, outCount );
+}
+
+size_t ConverterImplPolyphase::process( size_t numFrames, Buffer *destBuffer, size_t destMaxFrames )
+{
+	const size_t numTaps = mNumTaps;
+	const size_t halfTaps = numTaps / 2;
+	const size_t numPhases = mNumPhases;
+	const size_t numChannels = mNumResampledChannels;
+	const size_t historyFrames = mHistoryFrames;
+	const double step = mStep;
+	const float *phaseTable = mPhaseTable.data();
+	float *coeffs = mCoeffs.data();
+
+	double readPos = mReadPos;
+	size_t outCount = 0;
+
+	while( outCount < destMaxFrames ) {
+		const size_t index = (size_t)readPos;
+		if( index + halfTaps >= historyFrames )
+			break;
+
+		// coefficients are interpolated once per output frame and then applied to all channels
+		const double phasePos = ( readPos - (double)index ) * (double)numPhases;
+		const size_t phase = (size_t)phasePos;
+		const float alpha = float( phasePos - (double)phase );
+		const float *row = phaseTable + phase * numTaps;
+		interpolate( row, row + numTaps, alpha, coeffs, numTaps );
+
+		const size_t firstTap = index + 1 - halfTaps;
+		for( size_t ch = 0; ch < numChannels; ch++ )
+			destBuffer->getChannel( ch )[outCount] = dotProduct( mHistory.getChannel( ch ) + firstTap, coeffs, numTaps );
+
+		outCount++;
+		readPos += step;
+	}
+
+	// discard history frames that no output frame will need anymore
+	const size_t consumed = min( (size_t)readPos + 1 - halfTaps, historyFrames );
+	if( consumed ) {
+		for( size_t ch = 0; ch < numChannels; ch++ ) {
+			float *history = mHistory.getChannel( ch );
+			memmove( history, history + consumed, ( historyFrames - consumed ) * sizeof( float ) );
+		}
+
+		mHistoryFrames = historyFrames - consumed;
+		readPos -= (double)consumed;
+	}
+
+	mReadPos = readPos;
+	return outCount;
+}
+
+} } } // namespace cinder::audio::dsp
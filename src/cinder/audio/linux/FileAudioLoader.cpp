@@ -29,6 +29,13 @@
 #include <mpg123.h>
 #include <sndfile.h>
 
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+// Reads of at least twice this many frames are split across threads, if the format allows for it.
+#define MIN_FRAMES_PER_PARALLEL_CHUNK ( 1 << 18 )
+
 namespace audioloader {
 
 using SampleType = cinder::audio::SampleType;
@@ -215,6 +222,87 @@ FileType determineFileType( const ci::IStreamRef& stream )
 	return result;	
 }
 
+// ----------------------------------------------------------------------------------------------------
+// SeekIndex
+// ----------------------------------------------------------------------------------------------------
+//! Byte offsets of every mStep'th mp3 frame, as built by mpg123_scan(). Allows accurate seeking in VBR files without re-scanning, and is shared between all FileLoader's of a file.
+struct SeekIndex {
+	std::vector<off_t>	mOffsets;
+	off_t				mStep		= 0;
+	size_t				mNumFrames	= 0;
+
+	bool isComplete() const		{ return ! mOffsets.empty() && mNumFrames > 0; }
+
+	//! Loads the index from  cachePath, if it was built for a file of  fileSize bytes last modified at  fileTime.
+	bool read( const ci::fs::path &cachePath, uint64_t fileSize, int64_t fileTime );
+	//! Writes the index to  cachePath, tagged with the source file's  fileSize and  fileTime.
+	void write( const ci::fs::path &cachePath, uint64_t fileSize, int64_t fileTime ) const;
+};
+
+namespace {
+
+const char		SEEK_INDEX_MAGIC[8]		= { 'C', 'I', 'S', 'E', 'E', 'K', 'I', 'X' };
+const uint32_t	SEEK_INDEX_VERSION		= 1;
+
+} // anonymous namespace
+
+bool SeekIndex::read( const ci::fs::path &cachePath, uint64_t fileSize, int64_t fileTime )
+{
+	std::ifstream stream( cachePath.string().c_str(), std::ios::binary );
+	if( ! stream )
+		return false;
+
+	char magic[8];
+	uint32_t version = 0;
+	uint64_t cachedFileSize = 0, numFrames = 0, numOffsets = 0;
+	int64_t cachedFileTime = 0, step = 0;
+
+	stream.read( magic, sizeof( magic ) );
+	stream.read( reinterpret_cast<char*>( &version ), sizeof( version ) );
+	stream.read( reinterpret_cast<char*>( &cachedFileSize ), sizeof( cachedFileSize ) );
+	stream.read( reinterpret_cast<char*>( &cachedFileTime ), sizeof( cachedFileTime ) );
+	stream.read( reinterpret_cast<char*>( &numFrames ), sizeof( numFrames ) );
+	stream.read( reinterpret_cast<char*>( &step ), sizeof( step ) );
+	stream.read( reinterpret_cast<char*>( &numOffsets ), sizeof( numOffsets ) );
+	if( ! stream || std::memcmp( magic, SEEK_INDEX_MAGIC, sizeof( magic ) ) != 0 || version != SEEK_INDEX_VERSION )
+		return false;
+
+	// stale index, the file has changed since it was cached
+	if( cachedFileSize != fileSize || cachedFileTime != fileTime )
+		return false;
+
+	std::vector<int64_t> offsets( numOffsets );
+	stream.read( reinterpret_cast<char*>( offsets.data() ), numOffsets * sizeof( int64_t ) );
+	if( ! stream )
+		return false;
+
+	mOffsets.assign( offsets.begin(), offsets.end() );
+	mStep = static_cast<off_t>( step );
+	mNumFrames = static_cast<size_t>( numFrames );
+	return true;
+}
+
+void SeekIndex::write( const ci::fs::path &cachePath, uint64_t fileSize, int64_t fileTime ) const
+{
+	std::ofstream stream( cachePath.string().c_str(), std::ios::binary | std::ios::trunc );
+	if( ! stream )
+		return;
+
+	// offsets are always stored as 64-bit, regardless of the size of off_t
+	const uint64_t numFrames = mNumFrames, numOffsets = mOffsets.size();
+	const int64_t step = mStep;
+	std::vector<int64_t> offsets( mOffsets.begin(), mOffsets.end() );
+
+	stream.write( SEEK_INDEX_MAGIC, sizeof( SEEK_INDEX_MAGIC ) );
+	stream.write( reinterpret_cast<const char*>( &SEEK_INDEX_VERSION ), sizeof( SEEK_INDEX_VERSION ) );
+	stream.write( reinterpret_cast<const char*>( &fileSize ), sizeof( fileSize ) );
+	stream.write( reinterpret_cast<const char*>( &fileTime ), sizeof( fileTime ) );
+	stream.write( reinterpret_cast<const char*>( &numFrames ), sizeof( numFrames ) );
+	stream.write( reinterpret_cast<const char*>( &step ), sizeof( step ) );
+	stream.write( reinterpret_cast<const char*>( &numOffsets ), sizeof( numOffsets ) );
+	stream.write( reinterpret_cast<const char*>( offsets.data() ), numOffsets * sizeof( int64_t ) );
+}
+
 // ----------------------------------------------------------------------------------------------------
 // FileLoader
 // ----------------------------------------------------------------------------------------------------
@@ -232,6 +320,10 @@ class FileLoader {
 	virtual size_t 		read( void* buffer, size_t frameCount ) = 0;
 	//! Seeks to the absolute position specified by readPositionFrames
 	virtual void 		seek( int readPositionFrames ) = 0;
+	//! Returns true if separate FileLoader's can decode different sections of the file independently and with sample accuracy.
+	virtual bool		supportsParallelDecode() const { return false; }
+	//! Creates a new FileLoader that reads the same file from \a stream, sharing any state that was computed for the entire file.
+	virtual std::unique_ptr<FileLoader>	clone( const ci::IStreamRef& stream ) const = 0;
 
   protected:
 	SourceFileAudioLoader*	mCinderParent = nullptr;
@@ -264,7 +356,8 @@ FileLoader::~FileLoader()
 // ----------------------------------------------------------------------------------------------------
 class FileLoaderMpg123 : public FileLoader {
   public:
-	FileLoaderMpg123( SourceFileAudioLoader* cinderParent, const ci::IStreamRef& stream );
+	//! If \a seekIndex is empty, the stream is scanned to build a new one, which is available afterwards from getSeekIndex().
+	FileLoaderMpg123( SourceFileAudioLoader* cinderParent, const ci::IStreamRef& stream, const std::shared_ptr<SeekIndex>& seekIndex = nullptr );
 	virtual ~FileLoaderMpg123();
 
 	//! Returns the length in frames.
@@ -273,13 +366,19 @@ class FileLoaderMpg123 : public FileLoader {
 	virtual size_t 		read( void* buffer, size_t frameCount ) override;
 	//! Seeks to the absolute position specified by readPositionFrames
 	virtual void 		seek( int readPositionFrames ) override;
+	//! Frame accurate seeking is only possible once the stream has been fully indexed.
+	virtual bool		supportsParallelDecode() const override { return mSeekIndex && mSeekIndex->isComplete(); }
+	virtual std::unique_ptr<FileLoader>	clone( const ci::IStreamRef& stream ) const override;
+
+	const std::shared_ptr<SeekIndex>&	getSeekIndex() const { return mSeekIndex; }
 
   private:
   	mpg123_handle*	mHandle = nullptr;
   	int 			mEncodings = -1;
+  	std::shared_ptr<SeekIndex>	mSeekIndex;
 };
 
-FileLoaderMpg123::FileLoaderMpg123( SourceFileAudioLoader* cinderParent, const ci::IStreamRef& stream )
+FileLoaderMpg123::FileLoaderMpg123( SourceFileAudioLoader* cinderParent, const ci::IStreamRef& stream, const std::shared_ptr<SeekIndex>& seekIndex )
 	: FileLoader( cinderParent, stream )
 {
 	int ret = MPG123_OK;
@@ -311,6 +410,31 @@ FileLoaderMpg123::FileLoaderMpg123( SourceFileAudioLoader* cinderParent, const c
 		mNumChannels = channels;
 		mEncodings = encodings;
 
+		if( seekIndex && seekIndex->isComplete() ) {
+			// mpg123 copies the offsets into its own frame index
+			mpg123_set_index( mHandle, const_cast<off_t*>( seekIndex->mOffsets.data() ), seekIndex->mStep, seekIndex->mOffsets.size() );
+			mSeekIndex = seekIndex;
+		}
+		else {
+			// Scan the entire stream once, which makes the length exact and the frame index complete. Without this seeking
+			// in VBR files needs to decode up to the seek point.
+			mSeekIndex = std::make_shared<SeekIndex>();
+			if( MPG123_OK == mpg123_scan( mHandle ) ) {
+				off_t* offsets = nullptr;
+				off_t step = 0;
+				size_t fill = 0;
+				if( MPG123_OK == mpg123_index( mHandle, &offsets, &step, &fill ) && fill > 0 ) {
+					mSeekIndex->mOffsets.assign( offsets, offsets + fill );
+					mSeekIndex->mStep = step;
+				}
+
+				off_t len = mpg123_length( mHandle );
+				if( MPG123_ERR != len && len > 0 ) {
+					mSeekIndex->mNumFrames = static_cast<size_t>( len );
+				}
+			}
+		}
+
 		/*
 		switch( mEncodings ) {
 			case MPG123_ENC_8			: std::cout << "MPG123_ENC_8" << std::endl; break;
@@ -348,6 +472,10 @@ FileLoaderMpg123::~FileLoaderMpg123()
 
 size_t FileLoaderMpg123::getNumFrames() const
 {
+	if( mSeekIndex && mSeekIndex->mNumFrames > 0 ) {
+		return mSeekIndex->mNumFrames;
+	}
+
 	size_t result = 0;
 	if( nullptr != mHandle) {
 		// mpg123_length seems to return the number of frames - not samples as stated in the docs.
@@ -388,6 +516,11 @@ void FileLoaderMpg123::seek( int readPositionFrames )
 	mpg123_seek( mHandle, sampleoff, SEEK_SET );
 }
 
+std::unique_ptr<FileLoader> FileLoaderMpg123::clone( const ci::IStreamRef& stream ) const
+{
+	return std::unique_ptr<FileLoader>( new FileLoaderMpg123( mCinderParent, stream, mSeekIndex ) );
+}
+
 // ----------------------------------------------------------------------------------------------------
 // FileLoaderSndFile
 // ----------------------------------------------------------------------------------------------------
@@ -402,6 +535,8 @@ class FileLoaderSndFile : public FileLoader {
 	virtual size_t 		read( void* buffer, size_t frameCount ) override;
 	//! Seeks to the absolute position specified by readPositionFrames
 	virtual void 		seek( int readPositionFrames ) override;
+	virtual bool		supportsParallelDecode() const override { return mInfo.seekable != 0; }
+	virtual std::unique_ptr<FileLoader>	clone( const ci::IStreamRef& stream ) const override;
 
   private:
   	SF_INFO		mInfo;
@@ -465,6 +600,59 @@ void FileLoaderSndFile::seek( int readPositionFrames )
 	sf_seek( mHandle, readPositionFrames, SEEK_SET );
 }
 
+std::unique_ptr<FileLoader> FileLoaderSndFile::clone( const ci::IStreamRef& stream ) const
+{
+	return std::unique_ptr<FileLoader>( new FileLoaderSndFile( mCinderParent, stream ) );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Decoding utilities
+// ----------------------------------------------------------------------------------------------------
+//! Decodes up to numFrames frames from loader into buffer at bufferFrameOffset, using interleavedBuffer and deinterleavedBuffer as scratch
+//! space. Returns the actual number of frames decoded.
+size_t decodeFrames( FileLoader* loader, ci::audio::Buffer* buffer, size_t bufferFrameOffset, size_t numFrames, ci::audio::BufferDynamic* interleavedBuffer, ci::audio::BufferDynamic* deinterleavedBuffer )
+{
+	const size_t numChannels = loader->getNumChannels();
+	const size_t maxFramesPerRead = deinterleavedBuffer->getNumFrames();
+
+	size_t readCount = 0;
+	while( readCount < numFrames ) {
+		// Read the audio audio data
+		const size_t maxFrames = std::min<size_t>( maxFramesPerRead, numFrames - readCount );
+		size_t numFramesRead = loader->read( interleavedBuffer->getData(), maxFrames );
+		if( 0 == numFramesRead ) {
+			break;
+		}
+
+		// Deinterleave the audio data
+		if( 1 == numChannels ) {
+			std::memcpy( deinterleavedBuffer->getData(), interleavedBuffer->getData(), numFramesRead * sizeof( float ) );
+		}
+		else {
+			cinder::audio::dsp::deinterleave( interleavedBuffer->getData(), deinterleavedBuffer->getData(), deinterleavedBuffer->getNumFrames(), numChannels, numFramesRead );
+		}
+
+		// Copy to channels
+		for( size_t ch = 0; ch < numChannels; ch++ ) {
+			float *readChannel = deinterleavedBuffer->getChannel( ch );
+			float *resultChannel = buffer->getChannel( ch );
+			std::memcpy( resultChannel + bufferFrameOffset + readCount, readChannel, numFramesRead * sizeof( float ) );
+		}
+
+		readCount += numFramesRead;
+	}
+
+	return readCount;
+}
+
+//! Returns the path of the cached SeekIndex for filePath within cacheDirectory.
+ci::fs::path getSeekIndexCachePath( const ci::fs::path& cacheDirectory, const ci::fs::path& filePath )
+{
+	std::stringstream ss;
+	ss << filePath.filename().string() << "-" << std::hex << std::hash<std::string>()( filePath.string() ) << ".seekindex";
+	return cacheDirectory / ss.str();
+}
+
 } // namespace audioloader
 
 namespace cinder { namespace audio { namespace linux {
@@ -472,17 +660,39 @@ namespace cinder { namespace audio { namespace linux {
 // ----------------------------------------------------------------------------------------------------
 // SourceFileAudioLoader
 // ----------------------------------------------------------------------------------------------------
+namespace {
+
+fs::path sSeekIndexCacheDirectory;
+
+} // anonymous namespace
+
 SourceFileAudioLoader::SourceFileAudioLoader()
-	: SourceFile( 0 )
+	: SourceFile( 0 ), mFileReadPos( 0 )
 {
 }
 
 SourceFileAudioLoader::SourceFileAudioLoader( const DataSourceRef &dataSource, size_t sampleRate )
-	: SourceFile( sampleRate ), mDataSource( dataSource )
+	: SourceFile( sampleRate ), mDataSource( dataSource ), mFileReadPos( 0 )
+{
+	init();
+}
+
+SourceFileAudioLoader::SourceFileAudioLoader( const DataSourceRef &dataSource, size_t sampleRate, const std::shared_ptr<audioloader::SeekIndex> &seekIndex )
+	: SourceFile( sampleRate ), mSeekIndex( seekIndex ), mDataSource( dataSource ), mFileReadPos( 0 )
 {
 	init();
 }
 
+void SourceFileAudioLoader::setSeekIndexCacheDirectory( const fs::path &directory )
+{
+	sSeekIndexCacheDirectory = directory;
+}
+
+const fs::path& SourceFileAudioLoader::getSeekIndexCacheDirectory()
+{
+	return sSeekIndexCacheDirectory;
+}
+
 SourceFileAudioLoader::~SourceFileAudioLoader()
 {
 }
@@ -516,7 +726,36 @@ void SourceFileAudioLoader::init()
 	*/
 
 	if( audioloader::FileType::MP3 == fileType ) {
-		mFileLoader.reset( new audioloader::FileLoaderMpg123( this, mStream ) );
+		// Reuse a seek index from a previously opened instance or the cache directory if possible, otherwise one is built now and cached.
+		fs::path cachePath;
+		uint64_t fileSize = 0;
+		int64_t fileTime = 0;
+		if( ! mSeekIndex && mDataSource->isFilePath() && ! sSeekIndexCacheDirectory.empty() ) {
+			try {
+				const fs::path &filePath = mDataSource->getFilePath();
+				fileSize = fs::file_size( filePath );
+				fileTime = static_cast<int64_t>( fs::last_write_time( filePath ) );
+				cachePath = audioloader::getSeekIndexCachePath( sSeekIndexCacheDirectory, filePath );
+
+				auto seekIndex = std::make_shared<audioloader::SeekIndex>();
+				if( seekIndex->read( cachePath, fileSize, fileTime ) ) {
+					mSeekIndex = seekIndex;
+				}
+			}
+			catch( fs::filesystem_error & ) {
+				cachePath.clear();
+			}
+		}
+
+		bool needsCacheWrite = ! mSeekIndex && ! cachePath.empty();
+
+		auto fileLoader = new audioloader::FileLoaderMpg123( this, mStream, mSeekIndex );
+		mFileLoader.reset( fileLoader );
+		mSeekIndex = fileLoader->getSeekIndex();
+
+		if( needsCacheWrite && mSeekIndex->isComplete() ) {
+			mSeekIndex->write( cachePath, fileSize, fileTime );
+		}
 	}
 	else if( audioloader::FileType::PCM == fileType ) {
 		mFileLoader.reset( new audioloader::FileLoaderSndFile( this, mStream ) );
@@ -544,7 +783,7 @@ void SourceFileAudioLoader::init()
 
 SourceFileRef SourceFileAudioLoader::cloneWithSampleRate( size_t sampleRate ) const
 {
-	auto result = std::make_shared<SourceFileAudioLoader>( mDataSource, sampleRate );
+	std::shared_ptr<SourceFileAudioLoader> result( new SourceFileAudioLoader( mDataSource, sampleRate, mSeekIndex ) );
 	result->setupSampleRateConversion();
 
 	return result;
@@ -563,47 +802,82 @@ size_t SourceFileAudioLoader::getSampleRateNative() const
 size_t SourceFileAudioLoader::performRead( Buffer *buffer, size_t bufferFrameOffset, size_t numFramesNeeded )
 {
 	CI_ASSERT( buffer->getNumFrames() >= bufferFrameOffset + numFramesNeeded );
-//std::cout << "numFramesNeeded: " << numFramesNeeded << std::endl;
 
-	size_t readCount = 0;
+	// Large reads, such as from loadBuffer(), are decoded in parallel if the file is on disk and the format allows it.
+	if( numFramesNeeded >= 2 * MIN_FRAMES_PER_PARALLEL_CHUNK && mDataSource->isFilePath() && mFileLoader->supportsParallelDecode() ) {
+		return performReadParallel( buffer, bufferFrameOffset, numFramesNeeded );
+	}
+
+	mReadBuffer.setSize( getMaxFramesPerRead(), mFileLoader->getNumChannels() );
+
+	size_t readCount = audioloader::decodeFrames( mFileLoader.get(), buffer, bufferFrameOffset, numFramesNeeded, &mAudioData, &mReadBuffer );
+	mFileReadPos += readCount;
 
+	return readCount;
+}
+
+size_t SourceFileAudioLoader::performReadParallel( Buffer *buffer, size_t bufferFrameOffset, size_t numFramesNeeded )
+{
 	const size_t numChannels = mFileLoader->getNumChannels();
+	const size_t maxFramesPerRead = getMaxFramesPerRead();
+	const size_t numChunks = std::max<size_t>( 1, std::min<size_t>( std::thread::hardware_concurrency(), numFramesNeeded / MIN_FRAMES_PER_PARALLEL_CHUNK ) );
+	const size_t framesPerChunk = ( numFramesNeeded + numChunks - 1 ) / numChunks;
+	const fs::path filePath = mDataSource->getFilePath();
+	const size_t readPos = mFileReadPos;
+
+	// Each chunk is decoded by its own FileLoader and stream, so that they share no state other than the seek index.
+	std::vector<size_t> chunkReadCounts( numChunks, 0 );
+	std::vector<std::exception_ptr> chunkExceptions( numChunks );
+	std::vector<std::thread> threads;
+
+	for( size_t i = 0; i < numChunks; i++ ) {
+		threads.emplace_back( [&, i] {
+			try {
+				const size_t chunkOffset = i * framesPerChunk;
+				const size_t chunkFrames = std::min( framesPerChunk, numFramesNeeded - chunkOffset );
+
+				std::unique_ptr<audioloader::FileLoader> loader = mFileLoader->clone( ci::loadFileStream( filePath ) );
+				loader->seek( static_cast<int>( readPos + chunkOffset ) );
+
+				BufferDynamic interleavedBuffer( maxFramesPerRead, numChannels );
+				BufferDynamic deinterleavedBuffer( maxFramesPerRead, numChannels );
+				chunkReadCounts[i] = audioloader::decodeFrames( loader.get(), buffer, bufferFrameOffset + chunkOffset, chunkFrames, &interleavedBuffer, &deinterleavedBuffer );
+			}
+			catch( ... ) {
+				chunkExceptions[i] = std::current_exception();
+			}
+		} );
+	}
 
-	mReadBuffer.setSize( getMaxFramesPerRead(), numChannels );
+	for( auto &thread : threads ) {
+		thread.join();
+	}
 
-	while( readCount < numFramesNeeded ) {
-		// Read the audio audio data
-		const size_t maxFrames = std::min<size_t>( mAudioData.getNumFrames(), getNumFrames() - readCount );
-		size_t numFramesRead = mFileLoader->read( mAudioData.getData(), maxFrames );
-		if( 0 == numFramesRead ) {
-			break;
+	for( const auto &exc : chunkExceptions ) {
+		if( exc ) {
+			std::rethrow_exception( exc );
 		}
+	}
 
-		// Deinterleave the audio data
-		if( 1 == numChannels ) {
-			std::memcpy( mReadBuffer.getData(), mAudioData.getData(), numFramesRead * sizeof( float ) );
-		}
-		else {
-			dsp::deinterleave( mAudioData.getData(), mReadBuffer.getData(), mReadBuffer.getNumFrames(), numChannels, numFramesRead );
+	// Only frames up to the first short chunk are contiguous.
+	size_t readCount = 0;
+	for( size_t i = 0; i < numChunks; i++ ) {
+		readCount += chunkReadCounts[i];
+		if( chunkReadCounts[i] < std::min( framesPerChunk, numFramesNeeded - i * framesPerChunk ) ) {
+			break;
 		}
+	}
 
-		// Copy to channels
-		for( size_t ch = 0; ch < numChannels; ch++ ) {
-			float *readChannel = mReadBuffer.getChannel( ch );
-			float *resultChannel = buffer->getChannel( ch );
-			std::memcpy( resultChannel + readCount, readChannel, numFramesRead * sizeof( float ) );
-		}		
+	mFileReadPos = readPos + readCount;
+	mFileLoader->seek( static_cast<int>( mFileReadPos ) );
 
-		readCount += numFramesRead;
-	}
-	
-//std::cout << "readCount: " << readCount << std::endl;	
-	return static_cast<size_t>( readCount );
+	return readCount;
 }
 
 void SourceFileAudioLoader::performSeek( size_t readPositionFrames )
 {
 	mFileLoader->seek( readPositionFrames );
+	mFileReadPos = readPositionFrames;
 }
 
 std::vector<std::string> SourceFileAudioLoader::getSupportedExtensions()
@@ -0,0 +1,555 @@
+/*
+ Copyright (c) 2016, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cinder/ip/DistanceField.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+using namespace std;
+
+// The number of rows of pixels which share a list of nearby segments
+#define DISTANCE_FIELD_BAND_HEIGHT 8
+// The maximum distance in pixels between a curve and the straight pieces approximating it
+#define DISTANCE_FIELD_FLATNESS 0.02f
+// The maximum number of straight pieces approximating a single curve
+#define DISTANCE_FIELD_MAX_PIECES 1024
+// Neighbouring pixels whose channels differ by more than this many pixels are interpolated into artifacts by a multi-channel field
+#define DISTANCE_FIELD_CLASH_THRESHOLD 1.001f
+
+namespace cinder { namespace ip {
+
+namespace {
+
+// The channels a segment contributes to in a multi-channel field
+const uint8_t COLOR_RED		= 1;
+const uint8_t COLOR_GREEN	= 2;
+const uint8_t COLOR_BLUE	= 4;
+const uint8_t COLOR_YELLOW	= COLOR_RED | COLOR_GREEN;
+const uint8_t COLOR_MAGENTA	= COLOR_RED | COLOR_BLUE;
+const uint8_t COLOR_CYAN	= COLOR_GREEN | COLOR_BLUE;
+const uint8_t COLOR_WHITE	= COLOR_RED | COLOR_GREEN | COLOR_BLUE;
+
+// A straight piece of a flattened contour, in pixel coordinates
+struct Piece {
+	vec2		mA, mB;
+	float		mMinX, mMaxX, mMinY, mMaxY; // bounds expanded by the range
+	uint8_t		mColor;
+	bool		mExtendA, mExtendB; // whether the multi-channel field extends the piece beyond its ends along its direction
+};
+
+// The closest piece to a pixel in a single channel
+struct Closest {
+	float		mDistance, mDot;
+	uint32_t	mPiece;
+	float		mT;
+};
+
+// Where the field is written. Offsets are in floats from the start of each pixel, or -1 for fields not requested.
+struct Target {
+	float* getPixel( int32_t x, int32_t y ) const { return reinterpret_cast<float*>( mData + y * mRowBytes ) + x * mIncrement; }
+
+	uint8_t		*mData;
+	ptrdiff_t	mRowBytes;
+	int32_t		mWidth, mHeight;
+	uint8_t		mIncrement;
+	int			mSingle;
+	int			mMulti[3];
+};
+
+inline float median( float a, float b, float c )
+{
+	return std::max( std::min( a, b ), std::min( std::max( a, b ), c ) );
+}
+
+inline float cross( const vec2 &a, const vec2 &b )
+{
+	return a.x * b.y - a.y * b.x;
+}
+
+// Returns the number of straight pieces approximating a curve whose second derivative has magnitude at most \a maxSecondDerivative
+inline int calcNumPieces( float maxSecondDerivative )
+{
+	// a chord of a curve over a parameter interval h deviates from it by at most h^2 / 8 times its second derivative
+	const float n = std::ceil( std::sqrt( maxSecondDerivative / ( 8 * DISTANCE_FIELD_FLATNESS ) ) );
+	return (int)std::min<float>( std::max<float>( n, 1 ), DISTANCE_FIELD_MAX_PIECES );
+}
+
+// Moves \a color on to another of the three two-channel colors, avoiding sharing only a single channel with \a banned. After msdfgen's switchColor().
+void switchColor( uint8_t *color, uint8_t banned = 0 )
+{
+	const uint8_t combined = *color & banned;
+	if( combined == COLOR_RED || combined == COLOR_GREEN || combined == COLOR_BLUE )
+		*color = combined ^ COLOR_WHITE;
+	else if( *color == 0 || *color == COLOR_WHITE )
+		*color = COLOR_CYAN;
+	else {
+		const int shifted = *color << 1;
+		*color = ( shifted | shifted >> 3 ) & COLOR_WHITE;
+	}
+}
+
+class Rasterizer {
+  public:
+	Rasterizer( const Shape2d &shape, const DistanceFieldFormat &format, bool multiChannel );
+
+	void	rasterize( const Target &target );
+
+  private:
+	void	addContour( const Path2d &path );
+	void	colorContour( size_t firstSegment );
+	void	orientContour( size_t begin, size_t end );
+	bool	isFilled( int winding ) const { return mFormat.isEvenOddFill() ? ( winding & 1 ) != 0 : winding != 0; }
+	int		calcWinding( const vec2 &p ) const;
+	void	rasterizeBand( const Target &target, int32_t y0, int32_t y1, vector<uint32_t> *candidates, vector<uint32_t> *rowPieces, vector<uint32_t> *active, vector<pair<float, int>> *crossings ) const;
+	void	correctClashes( const Target &target ) const;
+
+	const DistanceFieldFormat	&mFormat;
+	bool						mMultiChannel;
+	vector<Piece>				mPieces;
+	vector<size_t>				mSegmentStarts; // the first piece of each segment of the current contour, followed by the end of its pieces
+};
+
+Rasterizer::Rasterizer( const Shape2d &shape, const DistanceFieldFormat &format, bool multiChannel )
+	: mFormat( format ), mMultiChannel( multiChannel )
+{
+	vector<size_t> contourStarts;
+	for( const auto &path : shape.getContours() ) {
+		contourStarts.push_back( mPieces.size() );
+		addContour( path );
+		colorContour( contourStarts.back() );
+	}
+	contourStarts.push_back( mPieces.size() );
+	for( size_t c = 0; c + 1 < contourStarts.size(); ++c )
+		orientContour( contourStarts[c], contourStarts[c + 1] );
+
+	const float range = mFormat.getRange();
+	for( auto &piece : mPieces ) {
+		piece.mMinX = std::min( piece.mA.x, piece.mB.x ) - range;
+		piece.mMaxX = std::max( piece.mA.x, piece.mB.x ) + range;
+		piece.mMinY = std::min( piece.mA.y, piece.mB.y ) - range;
+		piece.mMaxY = std::max( piece.mA.y, piece.mB.y ) + range;
+	}
+}
+
+// Flattens \a path into pieces in pixel coordinates, closing it if it isn't already
+void Rasterizer::addContour( const Path2d &path )
+{
+	mSegmentStarts.clear();
+	if( path.empty() )
+		return;
+
+	const float scale = mFormat.getScale();
+	const vec2 offset = mFormat.getOffset();
+	const vector<vec2> &points = path.getPoints();
+	const vec2 start = points[0] * scale + offset;
+	vec2 current = start;
+	auto addPiece = [&]( const vec2 &p ) {
+		if( p != current ) {
+			Piece piece;
+			piece.mA = current;
+			piece.mB = p;
+			piece.mColor = COLOR_WHITE;
+			piece.mExtendA = piece.mExtendB = false;
+			mPieces.push_back( piece );
+		}
+		current = p;
+	};
+
+	size_t firstPoint = 0;
+	for( size_t s = 0; s < path.getNumSegments(); ++s ) {
+		const Path2d::SegmentType type = path.getSegmentType( s );
+		mSegmentStarts.push_back( mPieces.size() );
+		switch( type ) {
+			case Path2d::LINETO:
+				addPiece( points[firstPoint + 1] * scale + offset );
+			break;
+			case Path2d::QUADTO: {
+				const vec2 p[3] = { current, points[firstPoint + 1] * scale + offset, points[firstPoint + 2] * scale + offset };
+				const int n = calcNumPieces( 2 * length( p[0] - 2.0f * p[1] + p[2] ) );
+				for( int i = 1; i < n; ++i )
+					addPiece( Path2d::calcQuadraticBezierPos( p, i / (float)n ) );
+				addPiece( p[2] );
+			}
+			break;
+			case Path2d::CUBICTO: {
+				const vec2 p[4] = { current, points[firstPoint + 1] * scale + offset, points[firstPoint + 2] * scale + offset, points[firstPoint + 3] * scale + offset };
+				const int n = calcNumPieces( 6 * std::max( length( p[0] - 2.0f * p[1] + p[2] ), length( p[1] - 2.0f * p[2] + p[3] ) ) );
+				for( int i = 1; i < n; ++i )
+					addPiece( Path2d::calcCubicBezierPos( p, i / (float)n ) );
+				addPiece( p[3] );
+			}
+			break;
+			case Path2d::CLOSE:
+				addPiece( start );
+			break;
+			default:
+			break;
+		}
+		firstPoint += Path2d::sSegmentTypePointCounts[type];
+	}
+
+	mSegmentStarts.push_back( mPieces.size() );
+	addPiece( start );
+	mSegmentStarts.push_back( mPieces.size() );
+}
+
+// Colors the segments of the contour starting at piece \a begin so that those meeting at a corner differ in two channels, after msdfgen's edgeColoringSimple()
+void Rasterizer::colorContour( size_t begin )
+{
+	const size_t numPieces = mPieces.size() - begin;
+	if( ! mMultiChannel || numPieces < 3 )
+		return;
+
+	// the segments which begin at a corner
+	vector<size_t> segments, corners;
+	for( size_t s = 0; s + 1 < mSegmentStarts.size(); ++s )
+		if( mSegmentStarts[s + 1] > mSegmentStarts[s] )
+			segments.push_back( s );
+	const float crossThreshold = std::sin( mFormat.getCornerAngle() );
+	for( size_t i = 0; i < segments.size(); ++i ) {
+		const Piece &in = mPieces[mSegmentStarts[segments[( i + segments.size() - 1 ) % segments.size()] + 1] - 1];
+		const Piece &out = mPieces[mSegmentStarts[segments[i]]];
+		const vec2 a = normalize( in.mB - in.mA ), b = normalize( out.mB - out.mA );
+		if( dot( a, b ) <= 0 || std::abs( cross( a, b ) ) > crossThreshold )
+			corners.push_back( i );
+	}
+
+	if( corners.size() == 1 ) {
+		// a teardrop needs its single smooth edge split into three colors
+		const uint8_t colors[3] = { COLOR_CYAN, COLOR_WHITE, COLOR_MAGENTA };
+		const size_t first = mSegmentStarts[segments[corners[0]]] - begin;
+		for( size_t i = 0; i < numPieces; ++i )
+			mPieces[begin + ( first + i ) % numPieces].mColor = colors[i * 3 / numPieces];
+	}
+	else if( corners.size() > 1 ) {
+		uint8_t color = COLOR_WHITE;
+		switchColor( &color );
+		const uint8_t initialColor = color;
+		size_t corner = 0;
+		for( size_t i = 0; i < segments.size(); ++i ) {
+			const size_t index = ( corners[0] + i ) % segments.size();
+			if( corner + 1 < corners.size() && corners[corner + 1] == index ) {
+				++corner;
+				switchColor( &color, ( corner == corners.size() - 1 ) ? initialColor : 0 );
+			}
+			for( size_t p = mSegmentStarts[segments[index]]; p < mSegmentStarts[segments[index] + 1]; ++p )
+				mPieces[p].mColor = color;
+		}
+	}
+
+	// each run of a single color acts as one edge, extended along its direction at either end
+	for( size_t i = 0; i < numPieces; ++i ) {
+		Piece &piece = mPieces[begin + i];
+		piece.mExtendA = piece.mColor != mPieces[begin + ( i + numPieces - 1 ) % numPieces].mColor;
+		piece.mExtendB = piece.mColor != mPieces[begin + ( i + 1 ) % numPieces].mColor;
+	}
+}
+
+// Reverses the contour made of pieces [\a begin, \a end) if it is filled on its right, so that every piece has the inside of the shape on its left
+void Rasterizer::orientContour( size_t begin, size_t end )
+{
+	if( end - begin < 3 )
+		return;
+
+	size_t longest = begin;
+	for( size_t p = begin + 1; p < end; ++p )
+		if( distance2( mPieces[p].mA, mPieces[p].mB ) > distance2( mPieces[longest].mA, mPieces[longest].mB ) )
+			longest = p;
+
+	const Piece &piece = mPieces[longest];
+	const vec2 dir = piece.mB - piece.mA;
+	const vec2 middle = ( piece.mA + piece.mB ) * 0.5f;
+	const vec2 normal = vec2( -dir.y, dir.x ) * ( std::min( 0.01f, length( dir ) * 0.25f ) / length( dir ) );
+	if( isFilled( calcWinding( middle + normal ) ) || ! isFilled( calcWinding( middle - normal ) ) )
+		return;
+
+	std::reverse( mPieces.begin() + begin, mPieces.begin() + end );
+	for( size_t p = begin; p < end; ++p ) {
+		std::swap( mPieces[p].mA, mPieces[p].mB );
+		std::swap( mPieces[p].mExtendA, mPieces[p].mExtendB );
+	}
+}
+
+// Returns the winding number of the shape around \a p
+int Rasterizer::calcWinding( const vec2 &p ) const
+{
+	int winding = 0;
+	for( const auto &piece : mPieces ) {
+		if( ( piece.mA.y <= p.y ) != ( piece.mB.y <= p.y ) ) {
+			const float x = piece.mA.x + ( p.y - piece.mA.y ) * ( piece.mB.x - piece.mA.x ) / ( piece.mB.y - piece.mA.y );
+			if( x < p.x )
+				winding += ( piece.mB.y > piece.mA.y ) ? 1 : -1;
+		}
+	}
+	return winding;
+}
+
+void Rasterizer::rasterize( const Target &target )
+{
+	const int32_t numBands = ( target.mHeight + DISTANCE_FIELD_BAND_HEIGHT - 1 ) / DISTANCE_FIELD_BAND_HEIGHT;
+	atomic<int32_t> nextBand( 0 );
+	auto work = [&]() {
+		vector<uint32_t> candidates, rowPieces, active;
+		vector<pair<float, int>> crossings;
+		for( int32_t band = nextBand++; band < numBands; band = nextBand++ ) {
+			const int32_t y0 = band * DISTANCE_FIELD_BAND_HEIGHT;
+			rasterizeBand( target, y0, std::min( y0 + DISTANCE_FIELD_BAND_HEIGHT, target.mHeight ), &candidates, &rowPieces, &active, &crossings );
+		}
+	};
+
+	const size_t numThreads = mFormat.isParallel() ? std::min<size_t>( thread::hardware_concurrency(), numBands ) : 1;
+	vector<thread> threads;
+	for( size_t t = 1; t < numThreads; ++t )
+		threads.push_back( thread( work ) );
+	work();
+	for( auto &t : threads )
+		t.join();
+
+	if( mMultiChannel )
+		correctClashes( target );
+}
+
+void Rasterizer::rasterizeBand( const Target &target, int32_t y0, int32_t y1, vector<uint32_t> *candidates, vector<uint32_t> *rowPieces, vector<uint32_t> *active, vector<pair<float, int>> *crossings ) const
+{
+	const float range = mFormat.getRange();
+
+	// the pieces near the band, sorted by their left edge. This includes every piece crossing the band, which decide what is inside.
+	candidates->clear();
+	for( uint32_t p = 0; p < (uint32_t)mPieces.size(); ++p )
+		if( mPieces[p].mMaxY >= y0 + 0.5f && mPieces[p].mMinY <= y1 - 0.5f )
+			candidates->push_back( p );
+	std::sort( candidates->begin(), candidates->end(), [&]( uint32_t a, uint32_t b ) { return mPieces[a].mMinX < mPieces[b].mMinX; } );
+
+	for( int32_t y = y0; y < y1; ++y ) {
+		const float py = y + 0.5f;
+		crossings->clear();
+		rowPieces->clear();
+		for( uint32_t p : *candidates ) {
+			const Piece &piece = mPieces[p];
+			if( ( piece.mA.y <= py ) != ( piece.mB.y <= py ) )
+				crossings->push_back( make_pair( piece.mA.x + ( py - piece.mA.y ) * ( piece.mB.x - piece.mA.x ) / ( piece.mB.y - piece.mA.y ), ( piece.mB.y > piece.mA.y ) ? 1 : -1 ) );
+			if( piece.mMinY <= py && piece.mMaxY >= py )
+				rowPieces->push_back( p );
+		}
+		std::sort( crossings->begin(), crossings->end() );
+
+		// sweep along the row, keeping the pieces within range of the pixel active
+		active->clear();
+		size_t nextCrossing = 0, nextPiece = 0;
+		int winding = 0;
+		for( int32_t x = 0; x < target.mWidth; ++x ) {
+			const vec2 p( x + 0.5f, py );
+			for( ; nextCrossing < crossings->size() && (*crossings)[nextCrossing].first < p.x; ++nextCrossing )
+				winding += (*crossings)[nextCrossing].second;
+			const bool inside = isFilled( winding );
+			for( ; nextPiece < rowPieces->size() && mPieces[(*rowPieces)[nextPiece]].mMinX <= p.x; ++nextPiece )
+				active->push_back( (*rowPieces)[nextPiece] );
+			for( size_t a = 0; a < active->size(); ) {
+				if( mPieces[(*active)[a]].mMaxX < p.x ) {
+					(*active)[a] = active->back();
+					active->pop_back();
+				}
+				else
+					++a;
+			}
+
+			float minDistance = range;
+			Closest closest[3];
+			for( auto &c : closest )
+				c.mDistance = range;
+			for( uint32_t a : *active ) {
+				const Piece &piece = mPieces[a];
+				const vec2 ab = piece.mB - piece.mA, aq = p - piece.mA;
+				const float t = dot( aq, ab ) / dot( ab, ab );
+				const float distance = glm::distance( p, piece.mA + ab * glm::clamp( t, 0.0f, 1.0f ) );
+				minDistance = std::min( minDistance, distance );
+				if( ! mMultiChannel )
+					continue;
+
+				// ties at a shared endpoint go to the piece most orthogonal to the pixel, after msdfgen
+				float dotAlong = 0;
+				if( t <= 0 || t >= 1 ) {
+					const vec2 eq = p - ( ( t <= 0 ) ? piece.mA : piece.mB );
+					dotAlong = ( eq == vec2( 0 ) ) ? 0 : std::abs( dot( normalize( ab ), normalize( eq ) ) );
+				}
+				for( int c = 0; c < 3; ++c ) {
+					if( ( piece.mColor & ( 1 << c ) ) && ( distance < closest[c].mDistance || ( distance == closest[c].mDistance && closest[c].mDistance < range && dotAlong < closest[c].mDot ) ) ) {
+						closest[c].mDistance = distance;
+						closest[c].mDot = dotAlong;
+						closest[c].mPiece = a;
+						closest[c].mT = t;
+					}
+				}
+			}
+
+			float *pixel = target.getPixel( x, y );
+			if( target.mSingle >= 0 )
+				pixel[target.mSingle] = inside ? -minDistance : minDistance;
+			if( ! mMultiChannel )
+				continue;
+
+			// each channel holds the signed pseudo-distance to its closest edge, which extends beyond the ends of the edge along its direction
+			float values[3];
+			bool fromEdge[3];
+			for( int c = 0; c < 3; ++c ) {
+				fromEdge[c] = closest[c].mDistance < range;
+				if( ! fromEdge[c] ) {
+					values[c] = inside ? -range : range;
+					continue;
+				}
+				const Piece &piece = mPieces[closest[c].mPiece];
+				const vec2 dir = normalize( piece.mB - piece.mA );
+				float value = ( cross( dir, p - piece.mA ) > 0 ) ? -closest[c].mDistance : closest[c].mDistance;
+				if( closest[c].mT < 0 && piece.mExtendA ) {
+					const vec2 aq = p - piece.mA;
+					const float pseudo = -cross( dir, aq );
+					if( dot( aq, dir ) < 0 && std::abs( pseudo ) <= std::abs( value ) )
+						value = pseudo;
+				}
+				else if( closest[c].mT > 1 && piece.mExtendB ) {
+					const vec2 bq = p - piece.mB;
+					const float pseudo = -cross( dir, bq );
+					if( dot( bq, dir ) > 0 && std::abs( pseudo ) <= std::abs( value ) )
+						value = pseudo;
+				}
+				values[c] = glm::clamp( value, -range, range );
+			}
+
+			// the orientation of the contours can disagree with the fill rule where they overlap, which the fill rule wins
+			const float m = median( values[0], values[1], values[2] );
+			if( m != 0 && ( m < 0 ) != inside ) {
+				for( int c = 0; c < 3; ++c )
+					if( fromEdge[c] )
+						values[c] = -values[c];
+			}
+			for( int c = 0; c < 3; ++c )
+				pixel[target.mMulti[c]] = values[c];
+		}
+	}
+}
+
+// Returns whether pixels \a a and \a b would interpolate into an artifact, and \a a is the one which should be flattened to its median. After msdfgen's detectClash().
+bool detectClash( const float a[3], const float b[3] )
+{
+	// sort the channels so that pairs go from the biggest to the smallest absolute difference
+	float a0 = a[0], a1 = a[1], a2 = a[2], b0 = b[0], b1 = b[1], b2 = b[2];
+	if( std::abs( b0 - a0 ) < std::abs( b1 - a1 ) ) {
+		std::swap( a0, a1 );
+		std::swap( b0, b1 );
+	}
+	if( std::abs( b1 - a1 ) < std::abs( b2 - a2 ) ) {
+		std::swap( a1, a2 );
+		std::swap( b1, b2 );
+		if( std::abs( b0 - a0 ) < std::abs( b1 - a1 ) ) {
+			std::swap( a0, a1 );
+			std::swap( b0, b1 );
+		}
+	}
+	// ignore pixels which have already been flattened, and only flag the one further from the edge
+	return std::abs( b1 - a1 ) >= DISTANCE_FIELD_CLASH_THRESHOLD && ! ( b0 == b1 && b0 == b2 ) && std::abs( a2 ) >= std::abs( b2 );
+}
+
+// Flattens the channels of pixels which would interpolate into artifacts with their neighbors
+void Rasterizer::correctClashes( const Target &target ) const
+{
+	auto load = [&]( int32_t x, int32_t y, float *values ) {
+		const float *pixel = target.getPixel( x, y );
+		for( int c = 0; c < 3; ++c )
+			values[c] = pixel[target.mMulti[c]];
+	};
+
+	vector<ivec2> clashes;
+	float center[3], neighbor[3];
+	for( int32_t y = 0; y < target.mHeight; ++y ) {
+		for( int32_t x = 0; x < target.mWidth; ++x ) {
+			load( x, y, center );
+			const ivec2 neighbors[4] = { ivec2( x - 1, y ), ivec2( x + 1, y ), ivec2( x, y - 1 ), ivec2( x, y + 1 ) };
+			for( const auto &n : neighbors ) {
+				if( n.x < 0 || n.x >= target.mWidth || n.y < 0 || n.y >= target.mHeight )
+					continue;
+				load( n.x, n.y, neighbor );
+				if( detectClash( center, neighbor ) ) {
+					clashes.push_back( ivec2( x, y ) );
+					break;
+				}
+			}
+		}
+	}
+
+	for( const auto &clash : clashes ) {
+		float *pixel = target.getPixel( clash.x, clash.y );
+		const float m = median( pixel[target.mMulti[0]], pixel[target.mMulti[1]], pixel[target.mMulti[2]] );
+		for( int c = 0; c < 3; ++c )
+			pixel[target.mMulti[c]] = m;
+	}
+}
+
+} // anonymous namespace
+
+void distanceField( const Shape2d &shape, Channel32f *dstChannel, const DistanceFieldFormat &format )
+{
+	Target target;
+	target.mData = reinterpret_cast<uint8_t*>( dstChannel->getData() );
+	target.mRowBytes = dstChannel->getRowBytes();
+	target.mWidth = dstChannel->getWidth();
+	target.mHeight = dstChannel->getHeight();
+	target.mIncrement = dstChannel->getIncrement();
+	target.mSingle = 0;
+	target.mMulti[0] = target.mMulti[1] = target.mMulti[2] = -1;
+
+	Rasterizer( shape, format, false ).rasterize( target );
+}
+
+Channel32f distanceField( const Shape2d &shape, const ivec2 &size, const DistanceFieldFormat &format )
+{
+	Channel32f result( size.x, size.y );
+	distanceField( shape, &result, format );
+	return result;
+}
+
+void multiChannelDistanceField( const Shape2d &shape, Surface32f *dstSurface, const DistanceFieldFormat &format )
+{
+	Target target;
+	target.mData = reinterpret_cast<uint8_t*>( dstSurface->getData() );
+	target.mRowBytes = dstSurface->getRowBytes();
+	target.mWidth = dstSurface->getWidth();
+	target.mHeight = dstSurface->getHeight();
+	target.mIncrement = dstSurface->getPixelInc();
+	target.mSingle = dstSurface->hasAlpha() ? dstSurface->getAlphaOffset() : -1;
+	target.mMulti[0] = dstSurface->getRedOffset();
+	target.mMulti[1] = dstSurface->getGreenOffset();
+	target.mMulti[2] = dstSurface->getBlueOffset();
+
+	Rasterizer( shape, format, true ).rasterize( target );
+}
+
+Surface32f multiChannelDistanceField( const Shape2d &shape, const ivec2 &size, bool alpha, const DistanceFieldFormat &format )
+{
+	Surface32f result( size.x, size.y, alpha );
+	multiChannelDistanceField( shape, &result, format );
+	return result;
+}
+
+} } // namespace cinder::ip
@@ -0,0 +1,168 @@
+// Compares ObjLoader against the line-by-line istringstream parser it replaced.
+// usage: ObjLoaderBenchmark [file.obj]. Without an argument a grid of quads with normals and tex coords is generated.
+
+#include "cinder/ObjLoader.h"
+#include "cinder/TriMesh.h"
+#include "cinder/Utilities.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <map>
+#include <tuple>
+
+using namespace std;
+using namespace ci;
+
+static double timestampSeconds()
+{
+	return chrono::duration<double>( chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+// The previous ObjLoader parser, reduced to producing an indexed triangle list.
+struct LegacyObjMesh {
+	vector<vec3>		mPositions, mNormals;
+	vector<vec2>		mTexCoords;
+	vector<uint32_t>	mIndices;
+};
+
+static LegacyObjMesh legacyLoad( const DataSourceRef &dataSource )
+{
+	typedef tuple<int,int,int> VertexTriple;
+
+	auto stream = dataSource->createStream();
+	vector<vec3> vertices, normals;
+	vector<vec2> texCoords;
+	map<VertexTriple,int> uniqueVerts;
+	LegacyObjMesh result;
+
+	while( ! stream->isEof() ) {
+		string line = stream->readLine(), tag;
+		if( line.empty() || line[0] == '#' )
+			continue;
+		while( line.back() == '\\' && ! stream->isEof() )
+			line = line.substr( 0, line.size() - 1 ) + stream->readLine();
+
+		stringstream ss( line );
+		ss >> tag;
+		if( tag == "v" ) {
+			vec3 v;
+			ss >> v.x >> v.y >> v.z;
+			vertices.push_back( v );
+		}
+		else if( tag == "vt" ) {
+			vec2 t;
+			ss >> t.x >> t.y;
+			texCoords.push_back( t );
+		}
+		else if( tag == "vn" ) {
+			vec3 n;
+			ss >> n.x >> n.y >> n.z;
+			normals.push_back( normalize( n ) );
+		}
+		else if( tag == "f" ) {
+			vector<int> faceIndices;
+			string vertex;
+			while( ss >> vertex ) {
+				int v = 0, t = 0, n = 0;
+				size_t slash = vertex.find( '/' );
+				v = stoi( vertex.substr( 0, slash ) );
+				if( slash != string::npos ) {
+					size_t slash2 = vertex.find( '/', slash + 1 );
+					if( slash2 != slash + 1 )
+						t = stoi( vertex.substr( slash + 1, slash2 - slash - 1 ) );
+					if( slash2 != string::npos )
+						n = stoi( vertex.substr( slash2 + 1 ) );
+				}
+				v = ( v < 0 ) ? (int)vertices.size() + v : v - 1;
+				t = ( t < 0 ) ? (int)texCoords.size() + t : t - 1;
+				n = ( n < 0 ) ? (int)normals.size() + n : n - 1;
+
+				auto inserted = uniqueVerts.insert( make_pair( make_tuple( v, t, n ), (int)result.mPositions.size() ) );
+				if( inserted.second ) {
+					result.mPositions.push_back( vertices[v] );
+					result.mTexCoords.push_back( t >= 0 ? texCoords[t] : vec2() );
+					result.mNormals.push_back( n >= 0 ? normals[n] : vec3() );
+				}
+				faceIndices.push_back( inserted.first->second );
+			}
+
+			for( size_t i = 2; i < faceIndices.size(); ++i ) {
+				result.mIndices.push_back( faceIndices[0] );
+				result.mIndices.push_back( faceIndices[i - 1] );
+				result.mIndices.push_back( faceIndices[i] );
+			}
+		}
+	}
+
+	return result;
+}
+
+// Writes a grid of size x size quads split into a few groups.
+static void writeGrid( const fs::path &path, int size )
+{
+	ofstream out( path.string().c_str() );
+	for( int y = 0; y <= size; ++y ) {
+		for( int x = 0; x <= size; ++x ) {
+			const float u = x / (float)size, v = y / (float)size;
+			out << "v " << u * 10 << " " << sin( u * 20 ) * cos( v * 20 ) << " " << v * 10 << "\n";
+			out << "vt " << u << " " << v << "\n";
+			out << "vn " << -cos( u * 20 ) << " 1 " << sin( v * 20 ) << "\n";
+		}
+	}
+
+	for( int y = 0; y < size; ++y ) {
+		if( y % ( size / 4 + 1 ) == 0 )
+			out << "g rows" << y << "\n";
+		for( int x = 0; x < size; ++x ) {
+			const int a = y * ( size + 1 ) + x + 1, b = a + 1, c = a + size + 2, d = a + size + 1;
+			out << "f " << a << "/" << a << "/" << a << " " << b << "/" << b << "/" << b << " " << c << "/" << c << "/" << c << " " << d << "/" << d << "/" << d << "\n";
+		}
+	}
+}
+
+// Sums the positions of all triangle corners, which doesn't depend on how vertices are shared.
+static vec3 checksum( const vec3 *positions, const uint32_t *indices, size_t numIndices )
+{
+	dvec3 result;
+	for( size_t i = 0; i < numIndices; ++i )
+		result += dvec3( positions[indices[i]] );
+	return vec3( result );
+}
+
+int main( int argc, char *argv[] )
+{
+	fs::path path;
+	if( argc > 1 )
+		path = argv[1];
+	else {
+		path = fs::temp_directory_path() / "ObjLoaderBenchmark.obj";
+		cout << "writing " << path << "... " << flush;
+		writeGrid( path, 600 );
+		cout << fs::file_size( path ) / ( 1024 * 1024 ) << " MB" << endl;
+	}
+
+	double start = timestampSeconds();
+	LegacyObjMesh legacy = legacyLoad( loadFile( path ) );
+	const double legacySeconds = timestampSeconds() - start;
+	cout << "legacy parser: " << legacySeconds << "s, " << legacy.mIndices.size() / 3 << " triangles, " << legacy.mPositions.size() << " vertices" << endl;
+
+	start = timestampSeconds();
+	ObjLoader loader( loadFile( path ) );
+	const double parseSeconds = timestampSeconds() - start;
+	TriMesh mesh( loader );
+	const double loadSeconds = timestampSeconds() - start;
+	cout << "ObjLoader: " << loadSeconds << "s (" << parseSeconds << "s parsing), " << mesh.getNumTriangles() << " triangles, " << mesh.getNumVertices() << " vertices" << endl;
+	cout << "speedup: " << legacySeconds / loadSeconds << "x" << endl;
+
+	const vec3 legacyChecksum = checksum( legacy.mPositions.data(), legacy.mIndices.data(), legacy.mIndices.size() );
+	const vec3 meshChecksum = checksum( mesh.getPositions<3>(), mesh.getIndices().data(), mesh.getNumIndices() );
+	const bool matches = legacy.mIndices.size() == mesh.getNumIndices() && distance( legacyChecksum, meshChecksum ) <= 0.0001f * length( legacyChecksum );
+	cout << ( matches ? "results match" : "RESULTS DIFFER" ) << endl;
+
+	if( argc <= 1 )
+		fs::remove( path );
+
+	return matches ? 0 : 1;
+}
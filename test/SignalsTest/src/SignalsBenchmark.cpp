@@ -27,12 +27,15 @@ static void printSize()
 {
     Signal<void ()> sig;
     cout << "sizeof( signal ): " << sizeof( sig ) << " bytes" << endl;
+    FlatSignal<void ()> flatSig;
+    cout << "sizeof( flat signal ): " << sizeof( flatSig ) << " bytes" << endl;
 }
 
 // profile time for emission with 1 slot
+template<typename SignalT>
 static void benchSignalEmission1()
 {
-	Signal<void ( void*, uint64_t )> sigIncrement;
+	SignalT sigIncrement;
 	sigIncrement.connect( testCounterAdd2 );
 
 	const uint64_t startCounter = TestCounter::get();
@@ -51,9 +54,10 @@ static void benchSignalEmission1()
 }
 
 // profile time for emission with 5 slots
+template<typename SignalT>
 static void benchSignalEmission5()
 {
-	Signal<void ( void*, uint64_t )> sigIncrement;
+	SignalT sigIncrement;
 	sigIncrement.connect( testCounterAdd2 );
 	sigIncrement.connect( testCounterAdd2 );
 	sigIncrement.connect( testCounterAdd2 );
@@ -79,9 +83,10 @@ static void benchSignalEmission5()
 }
 
 // profile time for emission with 4 slots, 2 in group 0 and 2 in group 1
+template<typename SignalT>
 static void benchSignalEmissionGroups()
 {
-	Signal<void ( void*, uint64_t )> sigIncrement;
+	SignalT sigIncrement;
 	sigIncrement.connect( testCounterAdd2 );
 	sigIncrement.connect( testCounterAdd2 );
 	sigIncrement.connect( 1, testCounterAdd2 );
@@ -105,6 +110,32 @@ static void benchSignalEmissionGroups()
 	<< endl;
 }
 
+// profile time for emission with 100 slots, each a lambda capturing its own data
+template<typename SignalT>
+static void benchSignalEmission100Lambdas()
+{
+	SignalT sigIncrement;
+	for( uint64_t s = 0; s < 100; s++ )
+		sigIncrement.connect( [s]( void *data, uint64_t incr ) { testCounterAdd2( data, incr + s * 0 ); } );
+
+	const uint64_t startCounter = TestCounter::get();
+	const uint64_t benchStart = timestampBenchmark();
+
+	uint64_t i;
+	for( i = 0; i < 100000; i++ )
+		sigIncrement.emit( nullptr, 1 );
+
+	const uint64_t benchDone = timestampBenchmark();
+	const uint64_t endCounter = TestCounter::get();
+
+	assert( endCounter - startCounter == ( i * 100 ) );
+
+	cout << "OK" << endl;
+	cout << "\tper emission: " << double( benchDone - benchStart ) / double( i ) << "ns"
+	<< ", per slot: " << double( benchDone - benchStart ) / double( i * 100 ) << "ns"
+	<< endl;
+}
+
 // the time of a plain callback
 static void benchPlainCallbackLoop()
 {
@@ -150,12 +181,25 @@ int main()
 {
 	printSize();
 
+	typedef Signal<void ( void*, uint64_t )>		SignalType;
+	typedef FlatSignal<void ( void*, uint64_t )>	FlatSignalType;
+
 	cout << "Benchmark: emmission (1 slot): ";
-	benchSignalEmission1();
+	benchSignalEmission1<SignalType>();
+	cout << "Benchmark: flat emmission (1 slot): ";
+	benchSignalEmission1<FlatSignalType>();
 	cout << "Benchmark: emmission (5 slots): ";
-	benchSignalEmission5();
+	benchSignalEmission5<SignalType>();
+	cout << "Benchmark: flat emmission (5 slots): ";
+	benchSignalEmission5<FlatSignalType>();
 	cout << "Benchmark: emmission with groups (2 groups, 4 slots): ";
-	benchSignalEmissionGroups();
+	benchSignalEmissionGroups<SignalType>();
+	cout << "Benchmark: flat emmission with groups (2 groups, 4 slots): ";
+	benchSignalEmissionGroups<FlatSignalType>();
+	cout << "Benchmark: emmission (100 lambda slots): ";
+	benchSignalEmission100Lambdas<SignalType>();
+	cout << "Benchmark: flat emmission (100 lambda slots): ";
+	benchSignalEmission100Lambdas<FlatSignalType>();
 	cout << "Benchmark: plain callback loop: ";
 	benchPlainCallbackLoop();
 	cout << "Benchmark: std::function callback loop: ";
@@ -2,10 +2,41 @@
 #include "catch.hpp"
 #include "cinder/Base64.h"
 #include "cinder/app/App.h"
+#include "cinder/Rand.h"
 
 using namespace cinder;
 using namespace std;
 
+namespace {
+
+// Returns \a size bytes of random data, with every byte value represented for larger sizes
+std::string randomBytes( size_t size, uint32_t seed )
+{
+	Rand rand( seed );
+	std::string result( size, 0 );
+	for( size_t i = 0; i < size; i++ )
+		result[i] = (char)( ( i < 256 ) ? i : rand.nextUint() );
+	return result;
+}
+
+// A reference encoder working a bit at a time
+std::string slowBase64( const std::string &input )
+{
+	const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	std::string result;
+	for( size_t bit = 0; bit < input.size() * 8; bit += 6 ) {
+		int value = 0;
+		for( size_t b = bit; b < bit + 6; b++ )
+			value = ( value << 1 ) | ( ( b < input.size() * 8 ) ? ( ( (uint8_t)input[b / 8] >> ( 7 - b % 8 ) ) & 1 ) : 0 );
+		result += alphabet[value];
+	}
+	while( result.size() % 4 )
+		result += '=';
+	return result;
+}
+
+} // anonymous namespace
+
 std::string toString( Buffer b )
 {
 	return string( static_cast<const char *>( b.getData() ), b.getSize() );
@@ -43,4 +74,93 @@ TEST_CASE("Base64")
 			}
 		}
 	}
+	SECTION( "long inputs match the reference and survive a round trip" )
+	{
+		for( size_t size : { 1, 11, 12, 13, 47, 48, 49, 255, 256, 1000, 65537 } ) {
+			const std::string data = randomBytes( size, (uint32_t)size );
+			const std::string encoded = toBase64( data );
+			REQUIRE( encoded == slowBase64( data ) );
+			REQUIRE( encoded.size() == getBase64EncodedSize( size ) );
+			REQUIRE( toString( fromBase64( encoded ) ) == data );
+		}
+	}
+	SECTION( "line breaks are inserted and skipped" )
+	{
+		const std::string data = randomBytes( 1000, 1 );
+		const std::string plain = toBase64( data );
+		for( int charsPerLine : { 4, 7, 64, 76, 1336 } ) {
+			const std::string lines = toBase64( data, charsPerLine );
+			REQUIRE( lines.size() == getBase64EncodedSize( data.size(), charsPerLine ) );
+			const size_t lineLength = charsPerLine - charsPerLine % 4;
+			std::string joined;
+			for( size_t i = 0; i < lines.size(); i++ ) {
+				if( ( i + 1 ) % ( lineLength + 1 ) == 0 )
+					REQUIRE( lines[i] == '\n' );
+				else
+					joined += lines[i];
+			}
+			REQUIRE( joined == plain );
+			REQUIRE( toString( fromBase64( lines ) ) == data );
+		}
+
+		// whitespace and other characters outside of the alphabet are skipped wherever they appear
+		std::string messy;
+		for( size_t i = 0; i < plain.size(); i++ ) {
+			messy += plain[i];
+			if( i % 13 == 5 )
+				messy += "\r\n";
+			if( i % 29 == 0 )
+				messy += " \t\x80\xff";
+		}
+		REQUIRE( toString( fromBase64( messy ) ) == data );
+	}
+	SECTION( "encoding and decoding in chunks matches the whole" )
+	{
+		const std::string data = randomBytes( 5000, 2 );
+		const std::string expected = toBase64( data, 76 );
+
+		Rand rand( 3 );
+		Base64Encoder encoder( 76 );
+		std::string encoded;
+		for( size_t offset = 0; offset < data.size(); ) {
+			const size_t size = std::min<size_t>( rand.nextUint( 40 ), data.size() - offset );
+			std::string chunk( encoder.getEncodedSize( size ), 0 );
+			REQUIRE( encoder.encode( &data[offset], size, &chunk[0] ) == chunk.size() );
+			encoded += chunk;
+			offset += size;
+		}
+		char tail[4];
+		encoded.append( tail, encoder.finish( tail ) );
+		REQUIRE( encoded == expected );
+
+		Base64Decoder decoder;
+		std::string decoded;
+		for( size_t offset = 0; offset < encoded.size(); ) {
+			const size_t size = std::min<size_t>( rand.nextUint( 40 ), encoded.size() - offset );
+			std::string chunk( decoder.getDecodedSizeMax( size ), 0 );
+			chunk.resize( decoder.decode( &encoded[offset], size, &chunk[0] ) );
+			decoded += chunk;
+			offset += size;
+		}
+		REQUIRE( decoded == data );
+	}
+	SECTION( "preallocated buffers and streams" )
+	{
+		const std::string data = randomBytes( 200000, 4 );
+		const std::string encoded = toBase64( data, 76 );
+
+		std::vector<char> chars( getBase64EncodedSize( data.size(), 76 ) );
+		REQUIRE( toBase64( data.data(), data.size(), chars.data(), 76 ) == chars.size() );
+		REQUIRE( std::string( chars.begin(), chars.end() ) == encoded );
+		std::vector<char> bytes( getBase64DecodedSizeMax( encoded.size() ) );
+		REQUIRE( fromBase64( encoded.data(), encoded.size(), bytes.data() ) == data.size() );
+		REQUIRE( std::string( bytes.data(), data.size() ) == data );
+
+		OStreamMemRef encodedStream = OStreamMem::create();
+		REQUIRE( toBase64( IStreamMem::create( data.data(), data.size() ), encodedStream, 76 ) == encoded.size() );
+		REQUIRE( std::string( static_cast<const char*>( encodedStream->getBuffer() ), (size_t)encodedStream->tell() ) == encoded );
+		OStreamMemRef decodedStream = OStreamMem::create();
+		REQUIRE( fromBase64( IStreamMem::create( encoded.data(), encoded.size() ), decodedStream ) == data.size() );
+		REQUIRE( std::string( static_cast<const char*>( decodedStream->getBuffer() ), (size_t)decodedStream->tell() ) == data );
+	}
 }
@@ -0,0 +1,113 @@
+#include "catch.hpp"
+#include "cinder/BatchTimeline.h"
+#include "cinder/Timeline.h"
+
+using namespace cinder;
+
+TEST_CASE( "BatchTimeline" )
+{
+
+SECTION( "tweens match the ones of a Timeline" )
+{
+	TimelineRef timeline = Timeline::create();
+	BatchTimeline batch;
+	Anim<float> animFloat( 1 );
+	Anim<vec3> animVec3( vec3( 0 ) );
+	Anim<Color> animColor( Color( 1, 0, 0 ) );
+	float batchFloat = 1;
+	vec3 batchVec3( 0 );
+	Color batchColor( 1, 0, 0 );
+
+	timeline->apply( &animFloat, 5.0f, 2.0f, easeInOutQuad );
+	timeline->apply( &animVec3, vec3( 1, 2, 3 ), 1.5f, easeOutCubic );
+	timeline->apply( &animColor, Color( 0, 0, 1 ), 3.0f );
+	batch.apply( &batchFloat, 5.0f, 2.0f, easeInOutQuad );
+	batch.apply( &batchVec3, vec3( 1, 2, 3 ), 1.5f, easeOutCubic );
+	batch.apply( &batchColor, Color( 0, 0, 1 ), 3.0f );
+	REQUIRE( batch.getNumTweens() == 3 );
+
+	for( int i = 0; i < 40; i++ ) {
+		timeline->step( 0.1f );
+		batch.step( 0.1f );
+		REQUIRE( batchFloat == Approx( animFloat.value() ) );
+		REQUIRE( distance( batchVec3, animVec3.value() ) < 0.00001f );
+		REQUIRE( distance( vec3( batchColor.r, batchColor.g, batchColor.b ), vec3( animColor().r, animColor().g, animColor().b ) ) < 0.00001f );
+	}
+	REQUIRE( batchFloat == 5 );
+	REQUIRE( batchVec3 == vec3( 1, 2, 3 ) );
+	REQUIRE( batchColor == Color( 0, 0, 1 ) );
+	REQUIRE( batch.empty() );
+}
+
+SECTION( "inserted tweens leave their target alone until they start" )
+{
+	BatchTimeline batch;
+	vec2 value( -1 );
+	BatchTimeline::Handle handle = batch.insert( &value, vec2( 0 ), vec2( 10, 20 ), 1.0f, 2.0f );
+	batch.stepTo( 0.5f );
+	REQUIRE( value == vec2( -1 ) );
+	batch.stepTo( 2.0f );
+	REQUIRE( value == vec2( 5, 10 ) );
+	REQUIRE( batch.isActive( handle ) );
+	batch.stepTo( 3.0f );
+	REQUIRE( value == vec2( 10, 20 ) );
+	REQUIRE( ! batch.isActive( handle ) );
+
+	// a tween without duration completes as soon as it starts
+	float instant = 0;
+	batch.insert( &instant, 0.0f, 1.0f, 4.0f, 0.0f );
+	batch.stepTo( 4.0f );
+	REQUIRE( instant == 1 );
+	REQUIRE( batch.empty() );
+}
+
+SECTION( "handles remove tweens and are invalidated" )
+{
+	BatchTimeline batch;
+	std::vector<float> values( 1000, 0 );
+	std::vector<BatchTimeline::Handle> handles;
+	for( size_t i = 0; i < values.size(); i++ )
+		handles.push_back( batch.apply( &values[i], 0.0f, (float)i, 1.0f, ( i % 2 ) ? easeNone : easeInQuad ) );
+
+	// remove every third tween, so that both groups move tweens around
+	for( size_t i = 0; i < values.size(); i += 3 )
+		REQUIRE( batch.remove( handles[i] ) );
+	REQUIRE( ! batch.remove( handles[0] ) );
+	REQUIRE( batch.getNumTweens() == values.size() - ( values.size() + 2 ) / 3 );
+
+	batch.stepTo( 0.5f );
+	for( size_t i = 0; i < values.size(); i++ ) {
+		REQUIRE( batch.isActive( handles[i] ) == ( i % 3 != 0 ) );
+		const float expected = ( i % 3 == 0 ) ? 0 : ( ( i % 2 ) ? 0.5f : 0.25f ) * i;
+		REQUIRE( values[i] == Approx( expected ) );
+	}
+
+	// slots of removed tweens are reused without reviving their old handles
+	float reused = 0;
+	BatchTimeline::Handle handle = batch.apply( &reused, 1.0f, 1.0f );
+	REQUIRE( batch.isActive( handle ) );
+	REQUIRE( ! batch.isActive( handles[0] ) );
+	REQUIRE( ! batch.isActive( BatchTimeline::Handle() ) );
+
+	batch.clear();
+	REQUIRE( batch.empty() );
+	REQUIRE( ! batch.isActive( handle ) );
+	REQUIRE( ! batch.isActive( handles[1] ) );
+}
+
+SECTION( "without auto-removal tweens can be stepped backwards" )
+{
+	BatchTimeline batch;
+	batch.setAutoRemove( false );
+	float value = 0;
+	BatchTimeline::Handle handle = batch.apply( &value, 0.0f, 4.0f, 1.0f );
+	batch.stepTo( 2.0f );
+	REQUIRE( value == 4 );
+	REQUIRE( batch.isActive( handle ) );
+	batch.stepTo( 0.25f );
+	REQUIRE( value == 1 );
+	REQUIRE( batch.remove( handle ) );
+	REQUIRE( batch.empty() );
+}
+
+} // BatchTimeline tests
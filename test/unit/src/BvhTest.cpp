@@ -0,0 +1,177 @@
+#include "catch.hpp"
+#include "cinder/Bvh.h"
+#include "cinder/TriMesh.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+using namespace cinder;
+
+namespace {
+
+// Returns a heightfield of \a size by \a size quads with some bumps, so that rays hit it at varying depths.
+TriMesh makeTerrain( int size )
+{
+	TriMesh mesh( TriMesh::Format().positions() );
+	for( int y = 0; y <= size; y++ ) {
+		for( int x = 0; x <= size; x++ ) {
+			const float u = x / (float)size * 2 - 1, v = y / (float)size * 2 - 1;
+			mesh.appendPosition( vec3( u, v, 0.2f * sinf( u * 7 ) * cosf( v * 5 ) ) );
+		}
+	}
+	for( int y = 0; y < size; y++ ) {
+		for( int x = 0; x < size; x++ ) {
+			const uint32_t i = y * ( size + 1 ) + x;
+			mesh.appendTriangle( i, i + 1, i + size + 2 );
+			mesh.appendTriangle( i, i + size + 2, i + size + 1 );
+		}
+	}
+	return mesh;
+}
+
+bool bruteForceHit( const TriMesh &mesh, const Ray &ray, uint32_t *triangle, float *distance )
+{
+	*distance = std::numeric_limits<float>::max();
+	for( size_t t = 0; t < mesh.getNumTriangles(); t++ ) {
+		vec3 a, b, c;
+		mesh.getTriangleVertices( t, &a, &b, &c );
+		float d;
+		if( ray.calcTriangleIntersection( a, b, c, &d ) && d < *distance ) {
+			*distance = d;
+			*triangle = (uint32_t)t;
+		}
+	}
+	return *distance != std::numeric_limits<float>::max();
+}
+
+template<typename OverlapFn>
+std::vector<uint32_t> bruteForceQuery( const TriMesh &mesh, const OverlapFn &overlaps )
+{
+	std::vector<uint32_t> result;
+	for( size_t t = 0; t < mesh.getNumTriangles(); t++ ) {
+		vec3 a, b, c;
+		mesh.getTriangleVertices( t, &a, &b, &c );
+		if( overlaps( AxisAlignedBox( glm::min( a, glm::min( b, c ) ), glm::max( a, glm::max( b, c ) ) ) ) )
+			result.push_back( (uint32_t)t );
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "Bvh" )
+{
+
+SECTION( "closestHit() matches a brute force search" )
+{
+	const TriMesh mesh = makeTerrain( 40 );
+	const Bvh bvh( mesh );
+	REQUIRE( bvh.getNumTriangles() == mesh.getNumTriangles() );
+
+	int hits = 0;
+	for( int i = 0; i < 400; i++ ) {
+		const vec3 origin( ( i % 20 ) / 10.0f - 0.95f, ( i / 20 ) / 10.0f - 0.95f, 2 );
+		const Ray ray( origin, normalize( vec3( 0.1f * sinf( (float)i ), 0.1f * cosf( (float)i ), -1 ) ) );
+
+		uint32_t expectedTriangle;
+		float expectedDistance;
+		const bool expected = bruteForceHit( mesh, ray, &expectedTriangle, &expectedDistance );
+
+		Bvh::Hit hit;
+		REQUIRE( bvh.closestHit( ray, &hit ) == expected );
+		REQUIRE( bvh.anyHit( ray ) == expected );
+		if( expected ) {
+			hits++;
+			REQUIRE( hit.mDistance == Approx( expectedDistance ) );
+			// the hit may be on an edge shared with the expected triangle
+			vec3 a, b, c;
+			mesh.getTriangleVertices( hit.mTriangle, &a, &b, &c );
+			const vec3 barycentric = a + hit.mU * ( b - a ) + hit.mV * ( c - a );
+			REQUIRE( distance( barycentric, ray.calcPosition( hit.mDistance ) ) < 0.0001f );
+			// nothing is found closer than the hit
+			REQUIRE_FALSE( bvh.anyHit( ray, hit.mDistance * 0.99f ) );
+		}
+	}
+	REQUIRE( hits > 300 );
+}
+
+SECTION( "missing rays and empty meshes" )
+{
+	const Bvh bvh( makeTerrain( 8 ) );
+	Bvh::Hit hit;
+	REQUIRE_FALSE( bvh.closestHit( Ray( vec3( 0, 0, 2 ), vec3( 0, 0, 1 ) ), &hit ) );
+	REQUIRE_FALSE( bvh.closestHit( Ray( vec3( 3, 0, 2 ), vec3( 0, 0, -1 ) ), &hit ) );
+	REQUIRE_FALSE( bvh.anyHit( Ray( vec3( 0, 0, 2 ), vec3( 0, 0, -1 ) ), 1.0f ) );
+
+	const Bvh empty( TriMesh( TriMesh::Format().positions() ) );
+	REQUIRE( empty.getNumNodes() == 0 );
+	REQUIRE_FALSE( empty.closestHit( Ray( vec3( 0 ), vec3( 0, 0, 1 ) ), &hit ) );
+}
+
+SECTION( "parallel and serial builds agree" )
+{
+	const TriMesh mesh = makeTerrain( 200 );
+	const Bvh serial( mesh, Bvh::Format().parallel( false ) );
+	const Bvh parallel( mesh, Bvh::Format().parallel() );
+	REQUIRE( serial.getNumTriangles() == 80000 );
+	REQUIRE( parallel.getNumTriangles() == 80000 );
+
+	for( int i = 0; i < 100; i++ ) {
+		const Ray ray( vec3( i / 50.0f - 0.99f, 0.3f, 1 ), vec3( 0, 0, -1 ) );
+		Bvh::Hit a, b;
+		REQUIRE( serial.closestHit( ray, &a ) );
+		REQUIRE( parallel.closestHit( ray, &b ) );
+		REQUIRE( a.mDistance == Approx( b.mDistance ) );
+	}
+}
+
+SECTION( "queryTriangles() matches a brute force search" )
+{
+	const TriMesh mesh = makeTerrain( 30 );
+	const Bvh bvh( mesh );
+
+	const AxisAlignedBox box( vec3( -0.5f, -0.2f, -1 ), vec3( 0.3f, 0.6f, 0.05f ) );
+	std::vector<uint32_t> result;
+	bvh.queryTriangles( box, &result );
+	std::sort( result.begin(), result.end() );
+	const vec3 boxMin = box.getMin(), boxMax = box.getMax();
+	REQUIRE( result == bruteForceQuery( mesh, [&]( const AxisAlignedBox &b ) {
+		return all( lessThanEqual( b.getMin(), boxMax ) ) && all( greaterThanEqual( b.getMax(), boxMin ) );
+	} ) );
+
+	// a box around everything returns every triangle
+	result.clear();
+	bvh.queryTriangles( AxisAlignedBox( vec3( -2 ), vec3( 2 ) ), &result );
+	REQUIRE( result.size() == mesh.getNumTriangles() );
+
+	// an orthographic frustum looking down -z that covers part of the terrain
+	const Frustum frustum( glm::ortho( -0.4f, 0.7f, -0.9f, 0.1f, -1.0f, 1.0f ) );
+	result.clear();
+	bvh.queryTriangles( frustum, &result );
+	std::sort( result.begin(), result.end() );
+	const std::vector<uint32_t> expected = bruteForceQuery( mesh, [&]( const AxisAlignedBox &b ) { return frustum.intersects( b ); } );
+	REQUIRE( ! expected.empty() );
+	REQUIRE( expected.size() < mesh.getNumTriangles() );
+	REQUIRE( result == expected );
+}
+
+SECTION( "refit() follows moved vertices" )
+{
+	TriMesh mesh = makeTerrain( 20 );
+	Bvh bvh( mesh );
+
+	for( size_t v = 0; v < mesh.getNumVertices(); v++ )
+		mesh.getPositions<3>()[v] += vec3( 5, 0, 0 );
+	bvh.refit( mesh.getPositions<3>(), mesh.getNumVertices() );
+	REQUIRE( bvh.getBounds().getMin().x == Approx( 4 ) );
+
+	Bvh::Hit hit;
+	REQUIRE_FALSE( bvh.closestHit( Ray( vec3( 0, 0, 2 ), vec3( 0, 0, -1 ) ), &hit ) );
+	const Ray ray( vec3( 5.1f, 0.2f, 2 ), vec3( 0, 0, -1 ) );
+	uint32_t expectedTriangle;
+	float expectedDistance;
+	REQUIRE( bruteForceHit( mesh, ray, &expectedTriangle, &expectedDistance ) );
+	REQUIRE( bvh.closestHit( ray, &hit ) );
+	REQUIRE( hit.mDistance == Approx( expectedDistance ) );
+}
+
+} // Bvh tests
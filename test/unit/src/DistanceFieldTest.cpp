@@ -0,0 +1,105 @@
+#include "catch.hpp"
+#include "cinder/ip/DistanceField.h"
+
+using namespace cinder;
+
+namespace {
+
+float median( float a, float b, float c )
+{
+	return std::max( std::min( a, b ), std::min( std::max( a, b ), c ) );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "DistanceField" )
+{
+
+SECTION( "distanceField() matches the distance to a circle" )
+{
+	Shape2d circle;
+	circle.moveTo( 26, 16 );
+	circle.arc( vec2( 16, 16 ), 10, 0, 6.2831853f );
+	circle.close();
+
+	Channel32f field = ip::distanceField( circle, ivec2( 32, 32 ) );
+	for( int32_t y = 0; y < 32; y++ ) {
+		for( int32_t x = 0; x < 32; x++ ) {
+			const float expected = glm::clamp( distance( vec2( x + 0.5f, y + 0.5f ), vec2( 16 ) ) - 10, -4.0f, 4.0f );
+			// curves are approximated to within a fiftieth of a pixel
+			REQUIRE( std::abs( field.getValue( ivec2( x, y ) ) - expected ) < 0.03f );
+		}
+	}
+}
+
+SECTION( "distanceField() matches Shape2d::calcSignedDistance()" )
+{
+	// a rounded outline with a hole wound the same way, which is only empty under the even-odd rule
+	Shape2d shape;
+	shape.moveTo( 2, 2 );
+	shape.lineTo( 20, 2 );
+	shape.quadTo( 28, 2, 28, 10 );
+	shape.curveTo( 28, 20, 20, 28, 10, 28 );
+	shape.lineTo( 2, 28 );
+	shape.close();
+	shape.moveTo( 8, 8 );
+	shape.lineTo( 16, 8 );
+	shape.lineTo( 16, 16 );
+	shape.lineTo( 8, 16 );
+	shape.close();
+
+	const auto format = ip::DistanceFieldFormat().scale( 2 ).offset( vec2( 3, 1 ) ).range( 8 );
+	Channel32f field = ip::distanceField( shape, ivec2( 64, 64 ), format );
+	Channel32f serial = ip::distanceField( shape, ivec2( 64, 64 ), ip::DistanceFieldFormat( format ).parallel( false ) );
+	Channel32f nonZero = ip::distanceField( shape, ivec2( 64, 64 ), ip::DistanceFieldFormat( format ).evenOddFill( false ) );
+	for( int32_t y = 0; y < 64; y++ ) {
+		for( int32_t x = 0; x < 64; x++ ) {
+			const vec2 p = ( vec2( x + 0.5f, y + 0.5f ) - vec2( 3, 1 ) ) / 2.0f;
+			const float value = field.getValue( ivec2( x, y ) );
+			REQUIRE( std::abs( value - glm::clamp( shape.calcSignedDistance( p ) * 2, -8.0f, 8.0f ) ) < 0.03f );
+			REQUIRE( value == serial.getValue( ivec2( x, y ) ) );
+			REQUIRE( std::abs( nonZero.getValue( ivec2( x, y ) ) - glm::clamp( shape.calcSignedDistance( p, false ) * 2, -8.0f, 8.0f ) ) < 0.03f );
+		}
+	}
+}
+
+SECTION( "multiChannelDistanceField() keeps the distance and the corners of a square" )
+{
+	Shape2d square;
+	square.moveTo( 8, 8 );
+	square.lineTo( 8, 24 );
+	square.lineTo( 24, 24 );
+	square.lineTo( 24, 8 );
+	square.close();
+
+	Surface32f msdf = ip::multiChannelDistanceField( square, ivec2( 32, 32 ), true );
+	Channel32f sdf = ip::distanceField( square, ivec2( 32, 32 ) );
+	for( int32_t y = 0; y < 32; y++ ) {
+		for( int32_t x = 0; x < 32; x++ ) {
+			const ColorAf color = msdf.getPixel( ivec2( x, y ) );
+			const float expected = sdf.getValue( ivec2( x, y ) );
+			REQUIRE( color.a == expected );
+			const float m = median( color.r, color.g, color.b );
+			REQUIRE( ( m < 0 ) == ( expected < 0 ) );
+			// inside, the median is the distance to the nearest side. Outside it's the distance to the nearest side's line, which keeps the corners square.
+			if( expected < 0 )
+				REQUIRE( m == Approx( expected ) );
+			else if( expected < 4 )
+				REQUIRE( m == Approx( std::max( std::abs( x + 0.5f - 16 ), std::abs( y + 0.5f - 16 ) ) - 8 ) );
+		}
+	}
+
+	// bilinear interpolation of the magnified field finds the corner exactly
+	auto sample = [&]( const vec2 &p ) {
+		const ivec2 i( glm::floor( p - vec2( 0.5f ) ) );
+		const vec2 f = p - vec2( 0.5f ) - vec2( i );
+		const ColorAf c = ( msdf.getPixel( i ) * ( 1 - f.x ) + msdf.getPixel( i + ivec2( 1, 0 ) ) * f.x ) * ( 1 - f.y )
+			+ ( msdf.getPixel( i + ivec2( 0, 1 ) ) * ( 1 - f.x ) + msdf.getPixel( i + ivec2( 1, 1 ) ) * f.x ) * f.y;
+		return median( c.r, c.g, c.b );
+	};
+	REQUIRE( sample( vec2( 23.9f, 23.9f ) ) < 0 );
+	REQUIRE( sample( vec2( 24.1f, 23.9f ) ) > 0 );
+	REQUIRE( sample( vec2( 24.1f, 24.1f ) ) > 0 );
+}
+
+} // DistanceField tests
@@ -0,0 +1,175 @@
+#include "catch.hpp"
+#include "cinder/GeomIo.h"
+#include "cinder/TriMesh.h"
+
+#include <array>
+
+using namespace cinder;
+
+namespace {
+
+// Wraps a geom::Plane, counting how many times it is loaded
+class CountingPlane : public geom::Source {
+  public:
+	CountingPlane( const geom::Plane &plane )
+		: mPlane( plane ), mNumLoads( 0 )
+	{}
+
+	size_t			getNumVertices() const override { return mPlane.getNumVertices(); }
+	size_t			getNumIndices() const override { return mPlane.getNumIndices(); }
+	geom::Primitive	getPrimitive() const override { return mPlane.getPrimitive(); }
+	uint8_t			getAttribDims( geom::Attrib attr ) const override { return mPlane.getAttribDims( attr ); }
+	geom::AttribSet	getAvailableAttribs() const override { return mPlane.getAvailableAttribs(); }
+	void			loadInto( geom::Target *target, const geom::AttribSet &requestedAttribs ) const override { ++mNumLoads; mPlane.loadInto( target, requestedAttribs ); }
+	CountingPlane*	clone() const override { return new CountingPlane( *this ); }
+
+	geom::Plane		mPlane;
+	mutable int		mNumLoads;
+};
+
+bool equalPositions( const TriMesh &a, const TriMesh &b )
+{
+	if( a.getNumVertices() != b.getNumVertices() )
+		return false;
+	for( size_t v = 0; v < a.getNumVertices(); v++ )
+		if( distance( a.getPositions<3>()[v], b.getPositions<3>()[v] ) > 0.00001f )
+			return false;
+	return true;
+}
+
+// Returns the positions and normals of \a mesh, sorted so that meshes can be compared regardless of vertex order
+std::vector<std::array<float, 6>> sortedVertices( const TriMesh &mesh )
+{
+	std::vector<std::array<float, 6>> result( mesh.getNumVertices() );
+	for( size_t v = 0; v < mesh.getNumVertices(); v++ ) {
+		const vec3 &p = mesh.getPositions<3>()[v], &n = mesh.getNormals()[v];
+		result[v] = {{ p.x, p.y, p.z, n.x, n.y, n.z }};
+	}
+	std::sort( result.begin(), result.end() );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "GeomIo" )
+{
+
+SECTION( "large meshes are modified the same as small ones" )
+{
+	// enough vertices for the per-vertex Modifiers to split their work across threads
+	const geom::Plane plane = geom::Plane().subdivisions( ivec2( 255 ) );
+	const geom::Twist twist = geom::Twist().axis( vec3( 0, 0, -0.5f ), vec3( 0, 0, 0.5f ) ).startAngle( 0 ).endAngle( 3.14159f );
+
+	TriMesh twisted( plane >> twist >> geom::Translate( 1, 2, 3 ) );
+	TriMesh plain( plane );
+	REQUIRE( twisted.getNumVertices() == plain.getNumVertices() );
+	for( size_t v = 0; v < plain.getNumVertices(); v++ ) {
+		const vec3 p = plain.getPositions<3>()[v];
+		const float angle = glm::mix( 0.0f, 3.14159f, glm::clamp( p.z + 0.5f, 0.0f, 1.0f ) );
+		const vec3 expected = vec3( glm::rotate( angle, vec3( 0, 0, 1 ) ) * vec4( p, 1 ) ) + vec3( 1, 2, 3 );
+		REQUIRE( distance( twisted.getPositions<3>()[v], expected ) < 0.001f );
+	}
+
+	TriMesh subdivided( plane >> geom::Subdivide() );
+	REQUIRE( subdivided.getNumVertices() == plain.getNumVertices() + plain.getNumTriangles() );
+	REQUIRE( subdivided.getNumTriangles() == plain.getNumTriangles() * 3 );
+	for( size_t t = 0; t < plain.getNumTriangles(); t++ ) {
+		vec3 a, b, c;
+		plain.getTriangleVertices( t, &a, &b, &c );
+		REQUIRE( distance( subdivided.getPositions<3>()[plain.getNumVertices() + t], ( a + b + c ) / 3.0f ) < 0.0001f );
+		REQUIRE( length( subdivided.getNormals()[plain.getNumVertices() + t] ) == Approx( 1 ) );
+	}
+
+	auto fn = []( vec3 p ) { return p * 2.0f; };
+	TriMesh scaled( plane >> geom::AttribFn<vec3, vec3>( geom::POSITION, fn ).parallel() );
+	for( size_t v = 0; v < plain.getNumVertices(); v++ )
+		REQUIRE( scaled.getPositions<3>()[v] == plain.getPositions<3>()[v] * 2.0f );
+}
+
+SECTION( "Simplify reduces the triangles but keeps the vertices" )
+{
+	const geom::Sphere sphere = geom::Sphere().subdivisions( 32 );
+	TriMesh original( sphere );
+	TriMesh simplified( sphere >> geom::Simplify( 0.25f ) );
+	REQUIRE( simplified.getNumVertices() == original.getNumVertices() );
+	REQUIRE( simplified.getNumTriangles() <= original.getNumTriangles() / 4 );
+	REQUIRE( simplified.getNumTriangles() > original.getNumTriangles() / 8 );
+	REQUIRE( simplified.getNormals() == original.getNormals() );
+
+	TriMesh counted( sphere >> geom::Simplify().numTriangles( 100 ) );
+	REQUIRE( counted.getNumTriangles() <= 100 );
+
+	// an error bound smaller than any collapse leaves the mesh unchanged
+	const geom::Icosphere icosphere = geom::Icosphere().subdivisions( 3 );
+	TriMesh bounded( icosphere >> geom::Simplify( 0.25f ).maxError( 0.0001f ) );
+	REQUIRE( bounded.getNumTriangles() == TriMesh( icosphere ).getNumTriangles() );
+}
+
+SECTION( "vertex cache statistics and OptimizeVertexCache" )
+{
+	const uint32_t indices[] = { 0, 1, 2, 2, 1, 3 };
+	geom::VertexCacheStats stats = geom::calculateVertexCacheStats( 6, indices, 4 );
+	REQUIRE( stats.mNumTransformed == 4 );
+	REQUIRE( stats.mAcmr == Approx( 2 ) );
+	REQUIRE( stats.mAtvr == Approx( 1 ) );
+	// with a cache of a single vertex, only the repeated 2 hits
+	REQUIRE( geom::calculateVertexCacheStats( 6, indices, 4, 1 ).mNumTransformed == 5 );
+
+	const geom::Torus torus = geom::Torus().subdivisionsAxis( 64 ).subdivisionsHeight( 32 );
+	TriMesh original( torus );
+	TriMesh optimized( torus >> geom::OptimizeVertexCache().overdraw() );
+	REQUIRE( optimized.getNumVertices() == original.getNumVertices() );
+	REQUIRE( optimized.getNumTriangles() == original.getNumTriangles() );
+	REQUIRE( optimized.calcVertexCacheStats().mAcmr < original.calcVertexCacheStats().mAcmr );
+	REQUIRE( optimized.calcVertexCacheStats().mAcmr < 0.8f );
+	// vertices were reordered along with their attributes
+	REQUIRE( optimized.getIndices()[0] == 0 );
+	REQUIRE( sortedVertices( optimized ) == sortedVertices( original ) );
+}
+
+SECTION( "a cached SourceMods only evaluates its Source once" )
+{
+	CountingPlane plane( geom::Plane().subdivisions( ivec2( 8 ) ) );
+	geom::SourceMods mods = &plane >> geom::Twist() >> geom::Translate( 0, 1, 0 );
+	mods.enableCache();
+
+	TriMesh first( mods, TriMesh::Format().positions() );
+	TriMesh second( mods, TriMesh::Format().positions() );
+	REQUIRE( plane.mNumLoads == 1 );
+	REQUIRE( equalPositions( first, second ) );
+	REQUIRE( first.getIndices() == second.getIndices() );
+
+	// requesting an attribute that wasn't captured evaluates the chain again
+	TriMesh withNormals( mods, TriMesh::Format().positions().normals() );
+	REQUIRE( plane.mNumLoads == 2 );
+	REQUIRE( withNormals.getNormals().size() == withNormals.getNumVertices() );
+	TriMesh third( mods, TriMesh::Format().positions() );
+	REQUIRE( plane.mNumLoads == 2 );
+	REQUIRE( equalPositions( first, third ) );
+
+	// copies share the cache, appending discards it
+	geom::SourceMods copy = mods;
+	const CountingPlane *copiedPlane = static_cast<const CountingPlane*>( copy.getSource() );
+	TriMesh fromCopy( copy, TriMesh::Format().positions() );
+	REQUIRE( copiedPlane->mNumLoads == 2 );
+	copy.append( geom::Translate( 0, 1, 0 ) );
+	TriMesh appended( copy, TriMesh::Format().positions() );
+	REQUIRE( copiedPlane->mNumLoads == 3 );
+	REQUIRE( plane.mNumLoads == 2 );
+	REQUIRE( equalPositions( first, fromCopy ) );
+	REQUIRE( appended.getPositions<3>()[0] == first.getPositions<3>()[0] + vec3( 0, 1, 0 ) );
+
+	mods.invalidateCache();
+	TriMesh invalidated( mods, TriMesh::Format().positions() );
+	REQUIRE( plane.mNumLoads == 3 );
+	REQUIRE( equalPositions( first, invalidated ) );
+
+	// without the cache every load evaluates the Source
+	mods.enableCache( false );
+	TriMesh uncached( mods, TriMesh::Format().positions() );
+	TriMesh uncached2( mods, TriMesh::Format().positions() );
+	REQUIRE( plane.mNumLoads == 5 );
+	REQUIRE( equalPositions( first, uncached2 ) );
+}
+
+} // GeomIo tests
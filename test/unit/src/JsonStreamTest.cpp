@@ -0,0 +1,242 @@
+#include "catch.hpp"
+#include "cinder/JsonStream.h"
+#include "cinder/Json.h"
+
+#include <sstream>
+#include <cmath>
+
+using namespace cinder;
+
+namespace {
+
+// Returns the events of \a json, and the text of each string, key and number.
+std::vector<std::string> readEvents( const std::string &json )
+{
+	std::vector<std::string> result;
+	JsonReader reader( json.data(), json.size() );
+	while( true ) {
+		switch( reader.next() ) {
+			case JsonReader::EVENT_START_OBJECT:	result.push_back( "{" ); break;
+			case JsonReader::EVENT_END_OBJECT:		result.push_back( "}" ); break;
+			case JsonReader::EVENT_START_ARRAY:		result.push_back( "[" ); break;
+			case JsonReader::EVENT_END_ARRAY:		result.push_back( "]" ); break;
+			case JsonReader::EVENT_KEY:				result.push_back( "key " + reader.getStringCopy() ); break;
+			case JsonReader::EVENT_STRING:			result.push_back( "string " + reader.getStringCopy() ); break;
+			case JsonReader::EVENT_NUMBER:			result.push_back( "number " + reader.getStringCopy() ); break;
+			case JsonReader::EVENT_BOOL:			result.push_back( reader.getBool() ? "true" : "false" ); break;
+			case JsonReader::EVENT_NULL:			result.push_back( "null" ); break;
+			default:								return result;
+		}
+	}
+}
+
+bool isMalformed( const std::string &json, bool allowComments = true )
+{
+	try {
+		JsonReader reader( json.data(), json.size(), allowComments );
+		while( reader.next() != JsonReader::EVENT_END_DOCUMENT )
+			;
+	}
+	catch( ExcJsonReader & ) {
+		return true;
+	}
+	return false;
+}
+
+JsonReader& readNumber( JsonReader &reader )
+{
+	REQUIRE( reader.next() == JsonReader::EVENT_NUMBER );
+	return reader;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "JsonStream" )
+{
+
+SECTION( "JsonReader returns the events of a document in order" )
+{
+	const std::vector<std::string> expected = { "{", "key b", "[", "number 1", "string two", "true", "false", "null", "{", "}", "[", "]", "]",
+												"key a", "{", "key c", "number -0.5e3", "}", "}" };
+	REQUIRE( readEvents( " {\"b\" : [1, \"two\", true, false, null, {}, []], \"a\": { \"c\":-0.5e3 }}\n" ) == expected );
+	REQUIRE( readEvents( "42" ) == std::vector<std::string>( { "number 42" } ) );
+
+	// comments are whitespace unless disabled
+	REQUIRE( readEvents( "// leading\n[1, /* inner */ 2]" ) == std::vector<std::string>( { "[", "number 1", "number 2", "]" } ) );
+	REQUIRE( isMalformed( "[1, /* inner */ 2]", false ) );
+	REQUIRE( isMalformed( "[1] /* unterminated" ) );
+}
+
+SECTION( "JsonReader returns strings in place unless they contain escape sequences" )
+{
+	const std::string json = "[\"plain\", \"a\\\"b\\\\c\\/d\\n\\t\", \"\\u00e9\\u20AC\\ud83d\\ude00\"]";
+	JsonReader reader( json.data(), json.size() );
+	reader.next();
+	REQUIRE( reader.next() == JsonReader::EVENT_STRING );
+	REQUIRE( reader.getString() == "plain" );
+	REQUIRE( reader.getString().data() == json.data() + 2 );
+	reader.next();
+	REQUIRE( reader.getString() == "a\"b\\c/d\n\t" );
+	reader.next();
+	REQUIRE( reader.getString() == "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80" );
+
+	REQUIRE( isMalformed( "[\"unterminated]" ) );
+	REQUIRE( isMalformed( "[\"\\x\"]" ) );
+	REQUIRE( isMalformed( "[\"\\ud83d\"]" ) );
+	REQUIRE( isMalformed( "[\"tab\tin string\"]" ) );
+}
+
+SECTION( "JsonReader parses numbers exactly" )
+{
+	const std::string json = "[0, -0, 9223372036854775807, -9223372036854775808, 18446744073709551615, 18446744073709551616, "
+							"0.1, -2.5, 1e22, 1.7976931348623157e308, 4.9e-324, 3.141592653589793238462643383279, 0.000001234, 1E+2]";
+	JsonReader reader( json.data(), json.size() );
+	reader.next();
+	REQUIRE( readNumber( reader ).getInt64() == 0 );
+	REQUIRE( readNumber( reader ).getInt64() == 0 );
+	REQUIRE( readNumber( reader ).getInt64() == std::numeric_limits<int64_t>::max() );
+	REQUIRE( reader.isInteger() );
+	REQUIRE( readNumber( reader ).getInt64() == std::numeric_limits<int64_t>::min() );
+	REQUIRE( readNumber( reader ).getUint64() == std::numeric_limits<uint64_t>::max() );
+	REQUIRE( reader.isInteger() );
+	REQUIRE( readNumber( reader ).getDouble() == 18446744073709551616.0 );
+	REQUIRE( ! reader.isInteger() );
+	const double reals[] = { 0.1, -2.5, 1e22, 1.7976931348623157e308, 4.9e-324, 3.141592653589793238462643383279, 0.000001234, 1e2 };
+	for( double real : reals ) {
+		REQUIRE( readNumber( reader ).getDouble() == real );
+		REQUIRE( ! reader.isInteger() );
+	}
+	REQUIRE( reader.getInt() == 100 );
+
+	REQUIRE( isMalformed( "[01]" ) );
+	REQUIRE( isMalformed( "[1.]" ) );
+	REQUIRE( isMalformed( "[.5]" ) );
+	REQUIRE( isMalformed( "[1e]" ) );
+	REQUIRE( isMalformed( "[-]" ) );
+}
+
+SECTION( "JsonReader rejects malformed documents" )
+{
+	REQUIRE( isMalformed( "" ) );
+	REQUIRE( isMalformed( "[1, 2" ) );
+	REQUIRE( isMalformed( "[1, 2}" ) );
+	REQUIRE( isMalformed( "[1 2]" ) );
+	REQUIRE( isMalformed( "[1,]" ) );
+	REQUIRE( isMalformed( "{\"a\" 1}" ) );
+	REQUIRE( isMalformed( "{1: 1}" ) );
+	REQUIRE( isMalformed( "{\"a\": 1,}" ) );
+	REQUIRE( isMalformed( "[tru]" ) );
+	REQUIRE( isMalformed( "[1] [2]" ) );
+	REQUIRE( ! isMalformed( "\xEF\xBB\xBF[1]" ) );
+
+	try {
+		const std::string json = "{\n\t\"a\": [1,\n\t\t2 3] }";
+		JsonReader reader( json.data(), json.size() );
+		while( reader.next() != JsonReader::EVENT_END_DOCUMENT )
+			;
+		FAIL();
+	}
+	catch( ExcJsonReader &exc ) {
+		REQUIRE( std::string( exc.what() ).find( "line 3, column 5" ) != std::string::npos );
+	}
+}
+
+SECTION( "JsonReader::skip() skips whole values" )
+{
+	const std::string json = "{\"skipped\": {\"a\": [1, {\"b\": 2}], \"c\": \"}\"}, \"array\": [[1, [2]], 3], \"kept\": 4}";
+	JsonReader reader( json.data(), json.size() );
+	reader.next();
+	REQUIRE( reader.next() == JsonReader::EVENT_KEY );
+	reader.skip();
+	REQUIRE( reader.getEvent() == JsonReader::EVENT_END_OBJECT );
+	REQUIRE( reader.getDepth() == 1 );
+	REQUIRE( reader.next() == JsonReader::EVENT_KEY );
+	REQUIRE( reader.next() == JsonReader::EVENT_START_ARRAY );
+	reader.skip();
+	REQUIRE( reader.getEvent() == JsonReader::EVENT_END_ARRAY );
+	REQUIRE( reader.next() == JsonReader::EVENT_KEY );
+	REQUIRE( reader.getString() == "kept" );
+	REQUIRE( readNumber( reader ).getInt() == 4 );
+	REQUIRE( reader.next() == JsonReader::EVENT_END_OBJECT );
+	REQUIRE( reader.next() == JsonReader::EVENT_END_DOCUMENT );
+	REQUIRE( reader.next() == JsonReader::EVENT_END_DOCUMENT );
+}
+
+SECTION( "JsonWriter writes documents which read back the same" )
+{
+	std::ostringstream compact;
+	{
+		JsonWriter writer( compact, false );
+		writer.startObject();
+		writer.key( "name" ).value( "quote \" backslash \\ newline \n control \x01" );
+		writer.key( "numbers" ).startArray().value( 1 ).value( -2 ).value( (uint64_t)18446744073709551615ULL ).value( 0.1 ).value( 2.0 ).value( 0.3f ).endArray();
+		writer.key( "flags" ).startArray().value( true ).value( false ).nullValue().value( std::nan( "" ) ).endArray();
+		writer.key( "empty" ).startObject().endObject();
+		writer.endObject();
+	}
+	REQUIRE( compact.str() == "{\"name\":\"quote \\\" backslash \\\\ newline \\n control \\u0001\",\"numbers\":[1,-2,18446744073709551615,0.1,2.0,0.3],"
+							"\"flags\":[true,false,null,null],\"empty\":{}}" );
+	REQUIRE( readEvents( compact.str() )[2] == "string quote \" backslash \\ newline \n control \x01" );
+
+	std::ostringstream indented;
+	{
+		JsonWriter writer( indented );
+		writer.startObject().key( "a" ).startArray().value( 1 ).value( 2 ).endArray().key( "b" ).startArray().endArray().endObject();
+	}
+	REQUIRE( indented.str() == "{\n\t\"a\" : [\n\t\t1,\n\t\t2\n\t],\n\t\"b\" : []\n}\n" );
+}
+
+SECTION( "JsonWriter rejects calls which would produce an invalid document" )
+{
+	std::ostringstream stream;
+	JsonWriter writer( stream );
+	REQUIRE_THROWS_AS( writer.key( "a" ), ExcJsonWriter );
+	REQUIRE_THROWS_AS( writer.endObject(), ExcJsonWriter );
+	writer.startObject();
+	REQUIRE_THROWS_AS( writer.value( 1 ), ExcJsonWriter );
+	REQUIRE_THROWS_AS( writer.endArray(), ExcJsonWriter );
+	writer.key( "a" );
+	REQUIRE_THROWS_AS( writer.key( "b" ), ExcJsonWriter );
+	REQUIRE_THROWS_AS( writer.endObject(), ExcJsonWriter );
+	writer.value( 1 ).endObject();
+	REQUIRE( writer.getDepth() == 0 );
+	REQUIRE_THROWS_AS( writer.value( 2 ), ExcJsonWriter );
+}
+
+SECTION( "JsonTree can be read from a JsonReader and written to a JsonWriter" )
+{
+	const std::string json = "{\"zebra\": [1, 2.5, -3, 18446744073709551615], \"apple\": {\"name\": \"\\u00e9\", \"ok\": true, \"none\": null}}";
+	JsonReader reader( json.data(), json.size() );
+	JsonTree tree( reader );
+	REQUIRE( reader.getEvent() == JsonReader::EVENT_END_OBJECT );
+	REQUIRE( tree.getNodeType() == JsonTree::NODE_OBJECT );
+	// members stay in document order
+	REQUIRE( tree.getChild( 0 ).getKey() == "zebra" );
+	REQUIRE( tree.getChild( "zebra" ).getNumChildren() == 4 );
+	REQUIRE( tree.getValueForKey<int>( "zebra.0" ) == 1 );
+	REQUIRE( tree.getValueForKey<double>( "zebra.1" ) == 2.5 );
+	REQUIRE( tree.getValueForKey<int>( "zebra.2" ) == -3 );
+	REQUIRE( tree.getValueForKey<uint64_t>( "zebra.3" ) == std::numeric_limits<uint64_t>::max() );
+	REQUIRE( tree.getValueForKey( "apple.name" ) == "\xC3\xA9" );
+	REQUIRE( tree.getValueForKey<bool>( "apple.ok" ) );
+	REQUIRE( tree.getChild( "apple.none" ).getNodeType() == JsonTree::NODE_NULL );
+	REQUIRE( &tree.getChild( "apple.name" ).getParent() == &tree.getChild( "apple" ) );
+
+	std::ostringstream stream;
+	{
+		JsonWriter writer( stream, false );
+		tree.write( writer );
+	}
+	REQUIRE( stream.str() == "{\"zebra\":[1,2.5,-3,18446744073709551615],\"apple\":{\"name\":\"\xC3\xA9\",\"ok\":true,\"none\":null}}" );
+
+	// elements of a large array can be read one at a time
+	const std::string array = "[{\"id\": 1}, {\"id\": 2}, {\"id\": 3}]";
+	JsonReader arrayReader( array.data(), array.size() );
+	arrayReader.next();
+	int sum = 0;
+	while( arrayReader.next() != JsonReader::EVENT_END_ARRAY )
+		sum += JsonTree( arrayReader ).getValueForKey<int>( "id" );
+	REQUIRE( sum == 6 );
+}
+
+} // JsonStream tests
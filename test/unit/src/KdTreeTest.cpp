@@ -0,0 +1,168 @@
+#include "catch.hpp"
+#include "cinder/KdTree.h"
+#include "cinder/Rand.h"
+
+using namespace cinder;
+
+namespace {
+
+std::vector<vec3> makePoints( size_t numPoints, uint32_t seed )
+{
+	Rand rand( seed );
+	std::vector<vec3> points;
+	for( size_t i = 0; i < numPoints; i++ )
+		points.push_back( vec3( rand.nextFloat(), rand.nextFloat(), rand.nextFloat() ) );
+	// duplicates and points on splitting planes shouldn't trip the tree up
+	for( size_t i = 0; i < numPoints / 10; i++ )
+		points.push_back( points[i] );
+	return points;
+}
+
+// Returns the indices of \a points sorted by their distance to \a p, ties broken by index.
+std::vector<uint32_t> sortByDistance( const std::vector<vec3> &points, const vec3 &p )
+{
+	std::vector<uint32_t> result( points.size() );
+	for( uint32_t i = 0; i < result.size(); i++ )
+		result[i] = i;
+	std::sort( result.begin(), result.end(), [&]( uint32_t a, uint32_t b ) {
+		const float da = distance2( points[a], p ), db = distance2( points[b], p );
+		return ( da == db ) ? a < b : da < db;
+	} );
+	return result;
+}
+
+struct CountingLookupProc {
+	CountingLookupProc() : mCount( new size_t( 0 ) ) {}
+	void process( uint32_t id, float distSqrd, float &maxDistSqrd ) const { ++*mCount; }
+	std::shared_ptr<size_t>	mCount;
+};
+
+} // anonymous namespace
+
+TEST_CASE( "KdTree" )
+{
+
+SECTION( "findNearest() matches a brute force search" )
+{
+	const std::vector<vec3> points = makePoints( 2000, 1 );
+	const std::vector<vec3> queries = makePoints( 100, 2 );
+	for( uint32_t bucketSize : { 1, 8, 32 } ) {
+		const KdTree<vec3> tree( points, KdTree<vec3>::Format().bucketSize( bucketSize ) );
+		REQUIRE( tree.getNumPoints() == points.size() );
+		for( const vec3 &q : queries ) {
+			const std::vector<uint32_t> expected = sortByDistance( points, q );
+			uint32_t indices[10];
+			float distancesSquared[10];
+			REQUIRE( tree.findNearest( q, 10, indices, distancesSquared ) == 10 );
+			for( int i = 0; i < 10; i++ ) {
+				// ties between duplicates may come out in either order
+				REQUIRE( distancesSquared[i] == Approx( distance2( points[expected[i]], q ) ) );
+				REQUIRE( distance2( points[indices[i]], q ) == distancesSquared[i] );
+			}
+
+			// the legacy interface
+			float p[3] = { q.x, q.y, q.z }, result[3];
+			uint32_t resultIndex;
+			tree.findNearest( p, result, &resultIndex );
+			REQUIRE( distance2( points[resultIndex], q ) == distancesSquared[0] );
+			REQUIRE( vec3( result[0], result[1], result[2] ) == points[resultIndex] );
+		}
+	}
+}
+
+SECTION( "findNearest() honors the maximum distance" )
+{
+	const KdTree<vec3> tree( makePoints( 500, 3 ) );
+	uint32_t indices[500];
+	float distancesSquared[500];
+	const vec3 q( 0.5f );
+	const size_t found = tree.findNearest( q, 500, indices, distancesSquared, 0.2f );
+	REQUIRE( found > 0 );
+	REQUIRE( found < 500 );
+	REQUIRE( distancesSquared[found - 1] < 0.2f * 0.2f );
+	REQUIRE( found == tree.findWithinRadius( q, 0.2f, nullptr, nullptr, 0 ) );
+}
+
+SECTION( "findWithinRadius() matches a brute force search" )
+{
+	const std::vector<vec3> points = makePoints( 3000, 4 );
+	const KdTree<vec3, 3, CountingLookupProc> tree( points );
+	const std::vector<vec3> queries = makePoints( 50, 5 );
+	for( const vec3 &q : queries ) {
+		std::vector<uint32_t> expected;
+		for( uint32_t i = 0; i < points.size(); i++ ) {
+			if( distance2( points[i], q ) < 0.15f * 0.15f )
+				expected.push_back( i );
+		}
+
+		std::vector<uint32_t> result;
+		std::vector<float> distancesSquared;
+		tree.findWithinRadius( q, 0.15f, &result, &distancesSquared );
+		REQUIRE( distancesSquared.size() == result.size() );
+		std::sort( result.begin(), result.end() );
+		REQUIRE( result == expected );
+
+		// buffers report the full count but only fill what fits
+		uint32_t buffer[4] = { ~0u, ~0u, ~0u, ~0u };
+		REQUIRE( tree.findWithinRadius( q, 0.15f, buffer, nullptr, 3 ) == expected.size() );
+		REQUIRE( buffer[3] == ~0u );
+
+		CountingLookupProc proc;
+		tree.lookup( q, proc, 0.15f );
+		REQUIRE( *proc.mCount == expected.size() );
+	}
+}
+
+SECTION( "batched queries match single queries" )
+{
+	const std::vector<vec3> points = makePoints( 5000, 6 );
+	const KdTree<vec3> tree( points );
+	const std::vector<vec3> queries = makePoints( 3000, 7 );
+	const size_t k = 6;
+
+	std::vector<uint32_t> indices( queries.size() * k );
+	std::vector<float> distancesSquared( queries.size() * k );
+	std::vector<size_t> counts( queries.size() );
+	tree.findNearest( queries.data(), queries.size(), k, indices.data(), distancesSquared.data(), counts.data(), 0.05f );
+
+	std::vector<uint32_t> radiusIndices( queries.size() * 32 );
+	std::vector<size_t> radiusCounts( queries.size() );
+	tree.findWithinRadius( queries.data(), queries.size(), 0.05f, 32, radiusIndices.data(), nullptr, radiusCounts.data() );
+
+	for( size_t i = 0; i < queries.size(); i++ ) {
+		uint32_t single[k];
+		float singleDistances[k];
+		const size_t count = tree.findNearest( queries[i], k, single, singleDistances, 0.05f );
+		REQUIRE( counts[i] == count );
+		for( size_t j = 0; j < count; j++ )
+			REQUIRE( distancesSquared[i * k + j] == singleDistances[j] );
+		for( size_t j = count; j < k; j++ )
+			REQUIRE( indices[i * k + j] == ~0u );
+		REQUIRE( radiusCounts[i] == tree.findWithinRadius( queries[i], 0.05f, nullptr, nullptr, 0 ) );
+	}
+}
+
+SECTION( "vec2 points and empty trees" )
+{
+	std::vector<vec2> points;
+	for( int y = 0; y < 20; y++ ) {
+		for( int x = 0; x < 20; x++ )
+			points.push_back( vec2( x, y ) );
+	}
+	const KdTree<vec2, 2> tree( points );
+	uint32_t indices[5];
+	float distancesSquared[5];
+	REQUIRE( tree.findNearest( vec2( 7.1f, 3.2f ), 5, indices, distancesSquared ) == 5 );
+	REQUIRE( points[indices[0]] == vec2( 7, 3 ) );
+	REQUIRE( distancesSquared[3] == Approx( 1.1f * 1.1f + 0.2f * 0.2f ) );
+
+	const KdTree<vec2, 2> empty( std::vector<vec2>{} );
+	REQUIRE( empty.getNumPoints() == 0 );
+	REQUIRE( empty.findNearest( vec2( 0 ), 5, indices, distancesSquared ) == 0 );
+	float p[2] = { 0, 0 }, result[2];
+	uint32_t resultIndex;
+	empty.findNearest( p, result, &resultIndex );
+	REQUIRE( resultIndex == ~0u );
+}
+
+} // KdTree tests
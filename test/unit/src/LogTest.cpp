@@ -0,0 +1,95 @@
+#include "catch.hpp"
+#include "cinder/Log.h"
+
+#include <algorithm>
+#include <thread>
+
+using namespace cinder;
+
+namespace {
+
+// Records everything written to it
+class LoggerCapture : public log::Logger {
+  public:
+	void write( const log::Metadata &meta, const std::string &text ) override
+	{
+		mLevels.push_back( meta.mLevel );
+		mFunctionNames.push_back( meta.mLocation.getFunctionName() );
+		mTexts.push_back( text );
+	}
+
+	std::vector<log::Level>		mLevels;
+	std::vector<std::string>	mFunctionNames, mTexts;
+};
+
+} // anonymous namespace
+
+TEST_CASE( "Log" )
+{
+	log::LogManager *manager = log::manager();
+	const std::vector<log::LoggerRef> previousLoggers = manager->getAllLoggers();
+	auto capture = std::make_shared<LoggerCapture>();
+	manager->resetLogger( capture );
+
+SECTION( "asynchronous logging writes the records of all threads in order" )
+{
+	manager->enableAsync();
+	REQUIRE( manager->isAsyncEnabled() );
+
+	std::vector<std::thread> threads;
+	for( int t = 0; t < 4; t++ ) {
+		threads.emplace_back( [t] {
+			for( int i = 0; i < 500; i++ )
+				CI_LOG_I( t << " " << i );
+		} );
+	}
+	for( auto &thread : threads )
+		thread.join();
+	CI_LOG_W( "main thread" );
+	manager->flush();
+
+	REQUIRE( capture->mTexts.size() == 2001 );
+	REQUIRE( capture->mTexts.back() == "main thread" );
+	REQUIRE( capture->mLevels.back() == log::LEVEL_WARNING );
+	REQUIRE( capture->mFunctionNames.back() == std::string( CINDER_CURRENT_FUNCTION ) );
+	int next[4] = { 0, 0, 0, 0 };
+	for( size_t r = 0; r < 2000; r++ ) {
+		int t, i;
+		REQUIRE( sscanf( capture->mTexts[r].c_str(), "%d %d", &t, &i ) == 2 );
+		REQUIRE( i == next[t]++ );
+	}
+	REQUIRE( manager->getNumDroppedRecords() == 0 );
+
+	// records logged before disabling are still written
+	CI_LOG_I( "last" );
+	manager->disableAsync();
+	REQUIRE( ! manager->isAsyncEnabled() );
+	REQUIRE( capture->mTexts.back() == "last" );
+	CI_LOG_I( "synchronous" );
+	REQUIRE( capture->mTexts.back() == "synchronous" );
+}
+
+SECTION( "full buffers drop records and count them" )
+{
+	// a thread which hasn't logged before gets a buffer of the new size
+	std::thread thread( [manager] {
+		manager->enableAsync( 1024 );
+		const std::string text( 200, 'x' );
+		for( int i = 0; i < 100; i++ )
+			CI_LOG_I( text );
+		manager->disableAsync();
+	} );
+	thread.join();
+
+	const uint64_t dropped = manager->getNumDroppedRecords();
+	REQUIRE( dropped > 0 );
+	// the drops are reported with a warning
+	REQUIRE( capture->mLevels.back() == log::LEVEL_WARNING );
+	const size_t written = std::count( capture->mLevels.begin(), capture->mLevels.end(), log::LEVEL_INFO );
+	REQUIRE( written + dropped == 100 );
+}
+
+	manager->clearLoggers();
+	for( const auto &logger : previousLoggers )
+		manager->addLogger( logger );
+} // Log tests
@@ -94,4 +94,71 @@ SECTION( "ObjLoader successfully parses faces with line continuations." )
 	REQUIRE( matchesExpectedPositions( mesh->getPositions<3>() ) );
 }
 
+SECTION( "ObjLoader resolves negative indices relative to the preceding vertices." )
+{
+	const std::string data( R"obj(
+v 1 1 -1
+v 1 1 1
+v -1.0 1.0 1.0
+v -1.0 1.0 -1.0
+f -4 -1 -2 -3
+)obj" );
+
+	auto obj = ObjLoader( IStreamMem::create( data.c_str(), data.size() ) );
+	auto mesh = TriMesh::create( obj );
+	REQUIRE( mesh->getNumTriangles() == 2 );
+	REQUIRE( matchesExpectedPositions( mesh->getPositions<3>() ) );
+}
+
+SECTION( "ObjLoader splits faces into groups and shares vertices with identical attributes." )
+{
+	const std::string data( R"obj(
+v 0 0 0
+v 1 0 0
+v 1 1 0
+v 0 1 0
+vt 0 0
+vt 1 0
+vt 1 1
+vt 0 1
+vn 0 0 1
+g front
+f 1/1/1 2/2/1 3/3/1
+f 1/1/1 3/3/1 4/4/1
+g  back 
+f 1 3 2
+)obj" );
+
+	auto obj = ObjLoader( IStreamMem::create( data.c_str(), data.size() ) );
+	REQUIRE( obj.getNumGroups() == 2 );
+	REQUIRE( obj.hasGroup( "front" ) );
+	REQUIRE( obj.hasGroup( "back" ) );
+	REQUIRE( obj.getGroups()[0].mFaces.size() == 2 );
+	REQUIRE( obj.getGroups()[0].mHasNormals );
+	REQUIRE( obj.getGroups()[0].mHasTexCoords );
+	REQUIRE_FALSE( obj.getGroups()[1].mHasNormals );
+
+	auto front = TriMesh::create( obj.groupName( "front" ) );
+	REQUIRE( front->getNumTriangles() == 2 );
+	REQUIRE( front->getNumVertices() == 4 );
+	REQUIRE( front->getTexCoords0<2>()[2] == vec2( 1, 1 ) );
+
+	// the back face has no normals, so it gets its own vertices with an inferred normal
+	auto all = TriMesh::create( ObjLoader( IStreamMem::create( data.c_str(), data.size() ) ) );
+	REQUIRE( all->getNumTriangles() == 3 );
+	REQUIRE( all->getNumVertices() == 7 );
+	REQUIRE( all->getNormals()[4] == vec3( 0, 0, -1 ) );
+}
+
+SECTION( "ObjLoader parses number formats." )
+{
+	const std::string data( "v 1e2 -2.5E-1 +.5\r\nv 3.40282e38 0.000001 -0\r\nv 123456789012345678901234 1 1\r\nf 1 2 3\r\n" );
+
+	auto mesh = TriMesh::create( ObjLoader( IStreamMem::create( data.c_str(), data.size() ) ) );
+	REQUIRE( mesh->getNumVertices() == 3 );
+	REQUIRE( mesh->getPositions<3>()[0] == vec3( 100, -0.25f, 0.5f ) );
+	REQUIRE( mesh->getPositions<3>()[1] == vec3( 3.40282e38f, 0.000001f, 0 ) );
+	REQUIRE( mesh->getPositions<3>()[2].x == 123456789012345678901234.0f );
+}
+
 } // ObjLoader tests
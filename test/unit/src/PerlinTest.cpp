@@ -0,0 +1,97 @@
+#include "catch.hpp"
+#include "cinder/Perlin.h"
+#include "cinder/Rand.h"
+
+using namespace cinder;
+
+TEST_CASE( "Perlin" )
+{
+
+SECTION( "batched fBm and dfBm match the single point versions" )
+{
+	Rand rand( 42 );
+	std::vector<vec2> positions2;
+	std::vector<vec3> positions3;
+	// an odd count leaves points over after the last batch, and some points lie exactly on cell corners or are negative
+	for( int i = 0; i < 1001; i++ ) {
+		const float scale = ( i % 3 == 0 ) ? 100.0f : 3.0f;
+		positions2.push_back( vec2( rand.nextFloat( -scale, scale ), rand.nextFloat( -scale, scale ) ) );
+		positions3.push_back( vec3( rand.nextFloat( -scale, scale ), rand.nextFloat( -scale, scale ), rand.nextFloat( -scale, scale ) ) );
+	}
+	positions2[0] = vec2( 0 );
+	positions2[1] = vec2( -1, 2 );
+	positions3[0] = vec3( 0 );
+	positions3[1] = vec3( -1, 2, -3 );
+
+	for( uint8_t octaves : { 1, 4, 7 } ) {
+		Perlin perlin( octaves, 1234 );
+		std::vector<float> values2( positions2.size() ), values3( positions3.size() );
+		std::vector<vec2> derivatives2( positions2.size() );
+		std::vector<vec3> derivatives3( positions3.size() );
+		perlin.fBm( positions2.data(), positions2.size(), values2.data() );
+		perlin.fBm( positions3.data(), positions3.size(), values3.data() );
+		perlin.dfBm( positions2.data(), positions2.size(), derivatives2.data() );
+		perlin.dfBm( positions3.data(), positions3.size(), derivatives3.data() );
+		for( size_t i = 0; i < positions2.size(); i++ ) {
+			REQUIRE( values2[i] == perlin.fBm( positions2[i] ) );
+			REQUIRE( values3[i] == perlin.fBm( positions3[i] ) );
+			REQUIRE( derivatives2[i] == perlin.dfBm( positions2[i] ) );
+			REQUIRE( derivatives3[i] == perlin.dfBm( positions3[i] ) );
+		}
+	}
+
+	// coordinates too large for the batches are evaluated one at a time
+	Perlin perlin;
+	const vec3 large[] = { vec3( 1, 2, 3 ), vec3( 3e9f, 1, 2 ), vec3( -5, 6, 7 ), vec3( 8, 9, 10 ) };
+	float values[4];
+	perlin.fBm( large, 4, values );
+	for( int i = 0; i < 4; i++ )
+		REQUIRE( values[i] == perlin.fBm( large[i] ) );
+}
+
+SECTION( "grids and channels match the single point versions" )
+{
+	Perlin perlin( 5 );
+	const vec2 origin( -3.5f, 1.25f ), step( 0.0371f, 0.05f );
+	const ivec2 size( 67, 45 );
+	std::vector<float> grid( size.x * size.y );
+	perlin.fBm( size, origin, step, grid.data() );
+	for( int j = 0; j < size.y; j++ )
+		for( int i = 0; i < size.x; i++ )
+			REQUIRE( grid[j * size.x + i] == perlin.fBm( origin + step * vec2( i, j ) ) );
+
+	const vec3 origin3( 0.5f, -2, 7 ), step3( 0.1f, 0.2f, -0.3f );
+	const ivec3 size3( 13, 6, 5 );
+	std::vector<float> grid3( size3.x * size3.y * size3.z );
+	perlin.fBm( size3, origin3, step3, grid3.data() );
+	for( int k = 0; k < size3.z; k++ )
+		for( int j = 0; j < size3.y; j++ )
+			for( int i = 0; i < size3.x; i++ )
+				REQUIRE( grid3[( k * size3.y + j ) * size3.x + i] == perlin.fBm( origin3 + step3 * vec3( i, j, k ) ) );
+
+	Channel32f channel( size.x, size.y );
+	perlin.fBm( &channel, origin, step );
+	for( int j = 0; j < size.y; j++ )
+		for( int i = 0; i < size.x; i++ )
+			REQUIRE( channel.getValue( ivec2( i, j ) ) == grid[j * size.x + i] );
+}
+
+SECTION( "parallel batches match serial ones" )
+{
+	Perlin perlin( 3 );
+	const ivec2 size( 300, 300 );
+	std::vector<float> serial( size.x * size.y ), parallel( size.x * size.y );
+	perlin.fBm( size, vec2( 0 ), vec2( 0.01f ), serial.data() );
+	perlin.fBm( size, vec2( 0 ), vec2( 0.01f ), parallel.data(), true );
+	REQUIRE( serial == parallel );
+
+	std::vector<vec3> positions( 100000 );
+	for( size_t i = 0; i < positions.size(); i++ )
+		positions[i] = vec3( i * 0.001f, i * 0.0007f, 1 );
+	std::vector<vec3> serialDerivatives( positions.size() ), parallelDerivatives( positions.size() );
+	perlin.dfBm( positions.data(), positions.size(), serialDerivatives.data() );
+	perlin.dfBm( positions.data(), positions.size(), parallelDerivatives.data(), true );
+	REQUIRE( serialDerivatives == parallelDerivatives );
+}
+
+} // Perlin tests
@@ -0,0 +1,275 @@
+#include "catch.hpp"
+#include "cinder/PolygonClipper.h"
+#include "cinder/Rand.h"
+
+using namespace cinder;
+
+namespace {
+
+PolyLine2f makeRect( float x0, float y0, float x1, float y1 )
+{
+	return PolyLine2f( { vec2( x0, y0 ), vec2( x1, y0 ), vec2( x1, y1 ), vec2( x0, y1 ) }, true );
+}
+
+// Returns a random star shaped contour, which is self-intersecting when \a tangled
+PolyLine2f makeRandomContour( Rand &rand, const vec2 &center, float radius, size_t numPoints, bool tangled )
+{
+	PolyLine2f result;
+	for( size_t p = 0; p < numPoints; p++ ) {
+		const float angle = ( tangled ? rand.nextFloat( 6.2832f ) : p * 6.2832f / numPoints );
+		result.push_back( center + vec2( cos( angle ), sin( angle ) ) * radius * rand.nextFloat( 0.3f, 1.0f ) );
+	}
+	return result;
+}
+
+int calcWinding( const std::vector<PolyLine2f> &polyLines, const vec2 &pt )
+{
+	int result = 0;
+	for( const auto &polyLine : polyLines ) {
+		const auto &points = polyLine.getPoints();
+		for( size_t p = 0; p < points.size(); p++ ) {
+			const vec2 &a = points[p], &b = points[( p + 1 ) % points.size()];
+			if( ( a.x <= pt.x ) != ( b.x <= pt.x ) ) {
+				const float y = a.y + ( b.y - a.y ) * ( pt.x - a.x ) / ( b.x - a.x );
+				if( y < pt.y )
+					result += ( b.x > a.x ) ? 1 : -1;
+			}
+		}
+	}
+	return result;
+}
+
+bool isFilled( int winding, PolygonClipper::Winding rule )
+{
+	switch( rule ) {
+		case PolygonClipper::WINDING_NONZERO: return winding != 0;
+		case PolygonClipper::WINDING_POSITIVE: return winding > 0;
+		case PolygonClipper::WINDING_NEGATIVE: return winding < 0;
+		default: return ( winding & 1 ) != 0;
+	}
+}
+
+float distanceToSegment( const vec2 &pt, const vec2 &a, const vec2 &b )
+{
+	const float t = glm::clamp( dot( pt - a, b - a ) / dot( b - a, b - a ), 0.0f, 1.0f );
+	return distance( pt, a + ( b - a ) * t );
+}
+
+float distanceToContours( const std::vector<PolyLine2f> &polyLines, const vec2 &pt )
+{
+	float result = 1e30f;
+	for( const auto &polyLine : polyLines )
+		for( size_t p = 0; p < polyLine.size(); p++ )
+			result = std::min( result, distanceToSegment( pt, polyLine.getPoints()[p], polyLine.getPoints()[( p + 1 ) % polyLine.size()] ) );
+	return result;
+}
+
+// Returns whether \a pt is within \a epsilon of an edge of \a polyLines
+bool isNearEdge( const std::vector<PolyLine2f> &polyLines, const vec2 &pt, float epsilon )
+{
+	return distanceToContours( polyLines, pt ) < epsilon;
+}
+
+double calcSignedArea( const std::vector<PolyLine2f> &polyLines )
+{
+	double result = 0;
+	for( const auto &polyLine : polyLines ) {
+		const auto &points = polyLine.getPoints();
+		for( size_t p = 0; p < points.size(); p++ )
+			result += ( (double)points[p].x * points[( p + 1 ) % points.size()].y - (double)points[( p + 1 ) % points.size()].x * points[p].y ) / 2;
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "PolygonClipper" )
+{
+
+SECTION( "overlapping rectangles" )
+{
+	PolygonClipper clipper;
+	clipper.addSubject( makeRect( 0, 0, 2, 2 ) );
+	clipper.addClip( makeRect( 1, 1, 3, 3 ) );
+
+	auto unioned = clipper.calc( PolygonClipper::OPERATION_UNION );
+	REQUIRE( unioned.size() == 1 );
+	REQUIRE( unioned[0].size() == 8 );
+	REQUIRE( unioned[0].isClosed() );
+	REQUIRE( unioned[0].isCounterclockwise() );
+	REQUIRE( calcSignedArea( unioned ) == Approx( 7 ) );
+
+	auto intersection = clipper.calc( PolygonClipper::OPERATION_INTERSECTION );
+	REQUIRE( intersection.size() == 1 );
+	REQUIRE( intersection[0].size() == 4 );
+	REQUIRE( calcSignedArea( intersection ) == Approx( 1 ) );
+
+	REQUIRE( calcSignedArea( clipper.calc( PolygonClipper::OPERATION_DIFFERENCE ) ) == Approx( 3 ) );
+	REQUIRE( clipper.calc( PolygonClipper::OPERATION_XOR ).size() == 2 );
+	REQUIRE( calcSignedArea( clipper.calc( PolygonClipper::OPERATION_XOR ) ) == Approx( 6 ) );
+
+	// a hole is clockwise
+	clipper.clear();
+	clipper.addSubject( makeRect( 0, 0, 3, 3 ) );
+	clipper.addClip( makeRect( 1, 1, 2, 2 ) );
+	auto difference = clipper.calc( PolygonClipper::OPERATION_DIFFERENCE );
+	REQUIRE( difference.size() == 2 );
+	REQUIRE( difference[0].isCounterclockwise() != difference[1].isCounterclockwise() );
+	REQUIRE( calcSignedArea( difference ) == Approx( 8 ) );
+}
+
+SECTION( "shared edges and vertices" )
+{
+	// rectangles sharing an edge merge, with the vertices along the seam removed
+	PolygonClipper clipper;
+	clipper.addSubject( makeRect( 0, 0, 1, 1 ) );
+	clipper.addSubject( makeRect( 1, 0, 2, 1 ) );
+	clipper.addSubject( makeRect( 0.5f, 1, 1.5f, 2 ) );
+	auto unioned = clipper.calc( PolygonClipper::OPERATION_UNION, PolygonClipper::WINDING_NONZERO );
+	REQUIRE( unioned.size() == 1 );
+	REQUIRE( unioned[0].size() == 8 );
+	REQUIRE( calcSignedArea( unioned ) == Approx( 3 ) );
+
+	// rectangles touching at a corner stay separate loops
+	clipper.clear();
+	clipper.addSubject( makeRect( 0, 0, 1, 1 ) );
+	clipper.addSubject( makeRect( 1, 1, 2, 2 ) );
+	unioned = clipper.calc( PolygonClipper::OPERATION_UNION, PolygonClipper::WINDING_NONZERO );
+	REQUIRE( unioned.size() == 2 );
+	REQUIRE( unioned[0].size() == 4 );
+	REQUIRE( unioned[1].size() == 4 );
+
+	// identical contours cancel out under the even-odd rule
+	clipper.clear();
+	clipper.addSubject( makeRect( 0, 0, 1, 1 ) );
+	clipper.addClip( makeRect( 0, 0, 1, 1 ) );
+	REQUIRE( clipper.calc( PolygonClipper::OPERATION_XOR ).empty() );
+	REQUIRE( calcSignedArea( clipper.calc( PolygonClipper::OPERATION_INTERSECTION ) ) == Approx( 1 ) );
+}
+
+SECTION( "winding rules" )
+{
+	// a pentagram's center is wound twice
+	PolyLine2f star;
+	for( int p = 0; p < 5; p++ )
+		star.push_back( vec2( cos( p * 4 * 3.14159265f / 5 ), sin( p * 4 * 3.14159265f / 5 ) ) );
+	PolygonClipper clipper;
+	clipper.addSubject( star );
+	auto odd = clipper.calc( PolygonClipper::OPERATION_UNION, PolygonClipper::WINDING_ODD );
+	auto nonZero = clipper.calc( PolygonClipper::OPERATION_UNION, PolygonClipper::WINDING_NONZERO );
+	REQUIRE( odd.size() == 5 );
+	REQUIRE( nonZero.size() == 1 );
+	REQUIRE( nonZero[0].size() == 10 );
+	REQUIRE( calcSignedArea( nonZero ) > calcSignedArea( odd ) );
+	REQUIRE( clipper.calc( PolygonClipper::OPERATION_UNION, PolygonClipper::WINDING_NEGATIVE ).empty() );
+	REQUIRE( calcSignedArea( clipper.calc( PolygonClipper::OPERATION_UNION, PolygonClipper::WINDING_POSITIVE ) ) == Approx( calcSignedArea( nonZero ) ) );
+}
+
+SECTION( "random contours match point sampling" )
+{
+	Rand rand( 1234 );
+	const PolygonClipper::Operation operations[] = { PolygonClipper::OPERATION_UNION, PolygonClipper::OPERATION_INTERSECTION, PolygonClipper::OPERATION_DIFFERENCE, PolygonClipper::OPERATION_XOR };
+	const PolygonClipper::Winding windings[] = { PolygonClipper::WINDING_ODD, PolygonClipper::WINDING_NONZERO, PolygonClipper::WINDING_POSITIVE, PolygonClipper::WINDING_NEGATIVE };
+	PolygonClipper clipper;
+	std::vector<PolyLine2f> result;
+	for( int trial = 0; trial < 20; trial++ ) {
+		const bool tangled = trial % 2 == 1;
+		std::vector<PolyLine2f> subject, clip;
+		for( int c = 0; c < 2; c++ ) {
+			subject.push_back( makeRandomContour( rand, rand.nextVec2() * 0.5f, 1, 12, tangled ) );
+			clip.push_back( makeRandomContour( rand, rand.nextVec2() * 0.5f, 1, 12, tangled ) );
+		}
+		// share a vertex and part of an edge between the subject and clip
+		clip[0].getPoints()[0] = subject[0].getPoints()[0];
+		clip[1].getPoints()[1] = subject[0].getPoints()[1];
+		clip[1].getPoints()[2] = subject[0].getPoints()[2];
+
+		clipper.clear();
+		clipper.addSubject( subject );
+		clipper.addClip( clip );
+		for( auto operation : operations ) {
+			for( auto winding : windings ) {
+				clipper.calc( operation, &result, winding );
+				for( int s = 0; s < 200; s++ ) {
+					const vec2 pt = rand.nextVec2() * rand.nextFloat( 1.6f );
+					if( isNearEdge( subject, pt, 0.001f ) || isNearEdge( clip, pt, 0.001f ) )
+						continue;
+					const bool inSubject = isFilled( calcWinding( subject, pt ), winding ), inClip = isFilled( calcWinding( clip, pt ), winding );
+					bool expected = inSubject || inClip;
+					if( operation == PolygonClipper::OPERATION_INTERSECTION )
+						expected = inSubject && inClip;
+					else if( operation == PolygonClipper::OPERATION_DIFFERENCE )
+						expected = inSubject && ! inClip;
+					else if( operation == PolygonClipper::OPERATION_XOR )
+						expected = inSubject != inClip;
+					// the result has no self-intersections and its holes are clockwise, so its winding is 0 or 1
+					REQUIRE( calcWinding( result, pt ) == ( expected ? 1 : 0 ) );
+				}
+			}
+		}
+	}
+}
+
+SECTION( "offsets" )
+{
+	PolygonClipper clipper;
+	clipper.addSubject( makeRect( 0, 0, 4, 4 ) );
+	REQUIRE( calcSignedArea( clipper.calcOffset( 1, PolygonClipper::JOIN_MITER ) ) == Approx( 36 ) );
+	REQUIRE( calcSignedArea( clipper.calcOffset( 1, PolygonClipper::JOIN_ROUND ) ) == Approx( 16 + 16 + 3.14159 ).epsilon( 0.01 ) );
+	REQUIRE( calcSignedArea( clipper.calcOffset( -1, PolygonClipper::JOIN_ROUND ) ) == Approx( 4 ) );
+	REQUIRE( clipper.calcOffset( -2.5f ).empty() );
+	// a miter beyond the limit is squared off
+	clipper.setMiterLimit( 1 );
+	auto squared = clipper.calcOffset( 1, PolygonClipper::JOIN_MITER );
+	REQUIRE( squared[0].size() == 8 );
+	REQUIRE( calcSignedArea( squared ) == Approx( calcSignedArea( clipper.calcOffset( 1, PolygonClipper::JOIN_SQUARE ) ) ) );
+
+	// points of a random contour, holes and all, are inside its offset when they are closer than the offset
+	Rand rand( 5678 );
+	clipper.setArcTolerance( 0.001f );
+	for( int trial = 0; trial < 10; trial++ ) {
+		std::vector<PolyLine2f> contours( 1, makeRandomContour( rand, vec2( 0 ), 1, 16, false ) );
+		contours.push_back( makeRandomContour( rand, vec2( 0 ), 0.25f, 5, false ) );
+		clipper.clear();
+		clipper.addSubject( contours );
+		const float delta = ( trial % 2 ) ? 0.1f : -0.05f;
+		auto offset = clipper.calcOffset( delta );
+		for( int s = 0; s < 500; s++ ) {
+			const vec2 pt = rand.nextVec2() * rand.nextFloat( 1.2f );
+			const float dist = distanceToContours( contours, pt );
+			if( abs( dist - abs( delta ) ) < 0.002f || dist < 0.002f )
+				continue;
+			const bool inside = ( calcWinding( contours, pt ) & 1 ) != 0;
+			const bool expected = ( delta > 0 ) ? ( inside || dist < delta ) : ( inside && dist > -delta );
+			REQUIRE( calcWinding( offset, pt ) == ( expected ? 1 : 0 ) );
+		}
+	}
+}
+
+SECTION( "shapes with curves" )
+{
+	Path2d circle;
+	circle.arc( vec2( 0 ), 1, 0, 2 * 3.14159265f );
+	circle.close();
+	PolygonClipper clipper;
+	clipper.addSubject( circle, 4 );
+	clipper.addClip( makeRect( 0, -2, 2, 2 ) );
+	REQUIRE( calcSignedArea( clipper.calc( PolygonClipper::OPERATION_INTERSECTION ) ) == Approx( 3.14159 / 2 ).epsilon( 0.01 ) );
+	REQUIRE( calcSignedArea( clipper.calc( PolygonClipper::OPERATION_UNION ) ) == Approx( 8 + 3.14159 / 2 ).epsilon( 0.01 ) );
+}
+
+SECTION( "PolyLine boolean operations" )
+{
+	std::vector<PolyLine2f> a( 1, makeRect( 0, 0, 2, 2 ) ), b( 1, makeRect( 1, 1, 3, 3 ) );
+	REQUIRE( calcSignedArea( PolyLine2f::calcUnion( a, b ) ) == Approx( 7 ) );
+	REQUIRE( calcSignedArea( PolyLine2f::calcIntersection( a, b ) ) == Approx( 1 ) );
+	REQUIRE( calcSignedArea( PolyLine2f::calcDifference( a, b ) ) == Approx( 3 ) );
+	REQUIRE( calcSignedArea( PolyLine2f::calcXor( a, b ) ) == Approx( 6 ) );
+	REQUIRE( PolyLine2f::calcIntersection( a, std::vector<PolyLine2f>() ).empty() );
+
+	std::vector<PolyLine2d> da( 1, PolyLine2d( { dvec2( 0, 0 ), dvec2( 2, 0 ), dvec2( 2, 2 ), dvec2( 0, 2 ) } ) );
+	std::vector<PolyLine2d> db( 1, PolyLine2d( { dvec2( 1, 1 ), dvec2( 3, 1 ), dvec2( 3, 3 ), dvec2( 1, 3 ) } ) );
+	REQUIRE( PolyLine2d::calcUnion( da, db )[0].calcArea() == Approx( 7 ) );
+}
+
+} // PolygonClipper tests
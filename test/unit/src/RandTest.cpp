@@ -133,3 +133,124 @@ TEST_CASE("Rand", "[noisy]")
 	}
 	#endif // not DEBUG
 } // rand
+
+TEST_CASE( "Philox" )
+{
+	SECTION( "matches the reference sequence and skips ahead exactly" )
+	{
+		Philox rand;
+		REQUIRE( rand.nextUint() == 0x6627e8d5 );
+		REQUIRE( rand.nextUint() == 0xe169c58d );
+		REQUIRE( rand.nextUint() == 0xbc57ac4c );
+		REQUIRE( rand.nextUint() == 0x9b00dbd8 );
+
+		Philox a( 1234, 5 ), b( 1234, 5 );
+		for( int i = 0; i < 1003; ++i )
+			a.nextUint();
+		b.discard( 1003 );
+		REQUIRE( a.getPosition() == 1003 );
+		REQUIRE( b.getPosition() == 1003 );
+		for( int i = 0; i < 10; ++i )
+			REQUIRE( a.nextUint() == b.nextUint() );
+
+		// other streams and seeds give other sequences
+		Philox c( 1234, 6 ), d( 1235, 5 );
+		b.seed( 1234, 5 );
+		int numDifferent = 0;
+		for( int i = 0; i < 100; ++i ) {
+			const uint32_t v = b.nextUint();
+			numDifferent += ( v != c.nextUint() ) + ( v != d.nextUint() );
+		}
+		REQUIRE( numDifferent > 190 );
+
+		std::uniform_int_distribution<int> dist( 3, 7 );
+		for( int i = 0; i < 100; ++i ) {
+			int v = dist( rand );
+			REQUIRE( v >= 3 );
+			REQUIRE( v <= 7 );
+		}
+	}
+
+	SECTION( "fills consume the sequence like the equivalent next calls" )
+	{
+		Philox filled( 42 ), called( 42 );
+		// start part way into a block, and leave odd counts over after the batches
+		filled.nextUint();
+		called.nextUint();
+
+		vector<uint32_t> uints( 1001 );
+		filled.fillUint( uints.data(), uints.size() );
+		for( auto v : uints )
+			REQUIRE( v == called.nextUint() );
+
+		vector<float> floats( 999 );
+		filled.fillFloat( floats.data(), floats.size(), -2.0f, 3.0f );
+		for( auto v : floats )
+			REQUIRE( v == called.nextFloat( -2.0f, 3.0f ) );
+
+		vector<float> gaussians( 1001 );
+		filled.fillGaussian( gaussians.data(), gaussians.size(), 1.0f, 0.5f );
+		for( auto v : gaussians )
+			REQUIRE( v == called.nextGaussian() * 0.5f + 1.0f );
+		// the spare value of the last pair carries over
+		filled.fillGaussian( gaussians.data(), 17 );
+		for( int i = 0; i < 17; ++i )
+			REQUIRE( gaussians[i] == called.nextGaussian() );
+
+		vector<vec2> vec2s( 1003 );
+		filled.fillVec2( vec2s.data(), vec2s.size() );
+		for( const auto &v : vec2s )
+			REQUIRE( v == called.nextVec2() );
+
+		vector<vec3> vec3s( 1005 );
+		filled.fillVec3( vec3s.data(), vec3s.size() );
+		for( const auto &v : vec3s )
+			REQUIRE( v == called.nextVec3() );
+
+		REQUIRE( filled.getPosition() == called.getPosition() );
+	}
+
+	SECTION( "values are in range and distributed as expected" )
+	{
+		Philox rand( 7 );
+		const size_t count = 100000;
+		vector<float> floats( count );
+		rand.fillFloat( floats.data(), count, 2.0f, 10.0f );
+		double sum = 0;
+		for( auto v : floats ) {
+			REQUIRE( v >= 2.0f );
+			REQUIRE( v < 10.0f );
+			sum += v;
+		}
+		REQUIRE( sum / count == Approx( 6.0 ).epsilon( 0.01 ) );
+
+		vector<float> gaussians( count );
+		rand.fillGaussian( gaussians.data(), count );
+		double sumSquares = 0;
+		sum = 0;
+		for( auto v : gaussians ) {
+			sum += v;
+			sumSquares += v * v;
+		}
+		REQUIRE( std::abs( sum / count ) < 0.01 );
+		REQUIRE( sumSquares / count == Approx( 1.0 ).epsilon( 0.02 ) );
+
+		vector<vec2> vec2s( count );
+		rand.fillVec2( vec2s.data(), count );
+		vec2 sum2( 0 );
+		for( const auto &v : vec2s ) {
+			REQUIRE( length( v ) == Approx( 1.0f ).epsilon( 0.00001f ) );
+			sum2 += v;
+		}
+		REQUIRE( length( sum2 ) / count < 0.01f );
+
+		vector<vec3> vec3s( count );
+		rand.fillVec3( vec3s.data(), count );
+		vec3 sum3( 0 );
+		for( const auto &v : vec3s ) {
+			REQUIRE( length( v ) == Approx( 1.0f ).epsilon( 0.00001f ) );
+			sum3 += v;
+		}
+		REQUIRE( length( sum3 ) / count < 0.01f );
+	}
+} // Philox
@@ -0,0 +1,134 @@
+#include "catch.hpp"
+#include "cinder/SpatialHashGrid.h"
+#include "cinder/Rand.h"
+
+using namespace cinder;
+
+namespace {
+
+template<typename VecT>
+std::vector<VecT> makePoints( size_t numPoints, uint32_t seed )
+{
+	Rand rand( seed );
+	std::vector<VecT> points( numPoints );
+	for( auto &p : points ) {
+		for( size_t i = 0; i < sizeof( VecT ) / sizeof( float ); i++ )
+			p[i] = rand.nextFloat( -10, 10 );
+	}
+	return points;
+}
+
+template<typename VecT>
+std::vector<uint32_t> bruteForce( const std::vector<VecT> &points, const VecT &p, float radius )
+{
+	std::vector<uint32_t> result;
+	for( uint32_t i = 0; i < points.size(); i++ ) {
+		if( distance2( points[i], p ) <= radius * radius )
+			result.push_back( i );
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "SpatialHashGrid" )
+{
+
+SECTION( "3D radius queries match a brute force search" )
+{
+	const std::vector<vec3> points = makePoints<vec3>( 4000, 1 );
+	const std::vector<vec3> queries = makePoints<vec3>( 100, 2 );
+	// a tiny table forces distinct cells to share buckets
+	for( uint32_t numBuckets : { 0, 16 } ) {
+		SpatialHashGrid3f grid( 1.5f, numBuckets );
+		grid.build( points );
+		REQUIRE( grid.getNumPoints() == points.size() );
+		REQUIRE( grid.isHashed() == ( numBuckets != 0 ) );
+		for( const vec3 &q : queries ) {
+			for( float radius : { 0.7f, 1.5f, 4.0f, 100.0f } ) {
+				std::vector<uint32_t> result;
+				std::vector<float> distancesSquared;
+				grid.findWithinRadius( q, radius, &result, &distancesSquared );
+				REQUIRE( result.size() == distancesSquared.size() );
+				std::sort( result.begin(), result.end() );
+				REQUIRE( result == bruteForce( points, q, radius ) );
+			}
+		}
+	}
+}
+
+SECTION( "2D radius queries match a brute force search" )
+{
+	const std::vector<vec2> points = makePoints<vec2>( 3000, 3 );
+	SpatialHashGrid2f grid( 0.5f );
+	grid.build( points );
+	for( const vec2 &q : makePoints<vec2>( 100, 4 ) ) {
+		std::vector<uint32_t> result;
+		grid.findWithinRadius( q, 0.8f, &result );
+		std::sort( result.begin(), result.end() );
+		REQUIRE( result == bruteForce( points, q, 0.8f ) );
+
+		// buffers report the full count but only fill what fits
+		uint32_t buffer[3] = { ~0u, ~0u, ~0u };
+		REQUIRE( grid.findWithinRadius( q, 0.8f, buffer, nullptr, 2 ) == result.size() );
+		REQUIRE( buffer[2] == ~0u );
+	}
+}
+
+SECTION( "parallel builds and batched queries match serial ones" )
+{
+	const std::vector<vec3> points = makePoints<vec3>( 100000, 5 );
+	SpatialHashGrid3f serial( 1 ), parallel( 1 );
+	serial.build( points, false );
+	parallel.build( points, true );
+	REQUIRE( serial.getIndices() == parallel.getIndices() );
+	REQUIRE( serial.getPoints() == parallel.getPoints() );
+	for( size_t i = 0; i < points.size(); i++ )
+		REQUIRE( parallel.getPoints()[i] == points[parallel.getIndices()[i]] );
+
+	const std::vector<vec3> queries = makePoints<vec3>( 20000, 6 );
+	const size_t maxResults = 16;
+	std::vector<uint32_t> indices( queries.size() * maxResults );
+	std::vector<size_t> counts( queries.size() );
+	parallel.findWithinRadius( queries.data(), queries.size(), 0.5f, maxResults, indices.data(), nullptr, counts.data() );
+	for( size_t i = 0; i < queries.size(); i += 97 )
+		REQUIRE( counts[i] == serial.findWithinRadius( queries[i], 0.5f, nullptr, nullptr, 0 ) );
+}
+
+SECTION( "widely scattered points are hashed" )
+{
+	std::vector<vec3> points = makePoints<vec3>( 1000, 8 );
+	points.push_back( vec3( 100000, -50000, 3 ) );
+	SpatialHashGrid3f grid( 0.5f );
+	grid.build( points );
+	REQUIRE( grid.isHashed() );
+
+	for( const vec3 &q : { vec3( 0 ), vec3( 5, -3, 2 ), vec3( 100000, -50000, 3.5f ) } ) {
+		std::vector<uint32_t> result;
+		grid.findWithinRadius( q, 1.0f, &result );
+		std::sort( result.begin(), result.end() );
+		REQUIRE( result == bruteForce( points, q, 1.0f ) );
+	}
+
+	points.pop_back();
+	grid.setCellSize( 2 );
+	grid.build( points );
+	REQUIRE_FALSE( grid.isHashed() );
+	// queries outside the bounds of a dense grid find nothing
+	REQUIRE( grid.findWithinRadius( vec3( 100, 0, 0 ), 5, nullptr, nullptr, 0 ) == 0 );
+}
+
+SECTION( "rebuilding with fewer points and an empty grid" )
+{
+	SpatialHashGrid3f grid( 2 );
+	grid.build( makePoints<vec3>( 1000, 7 ) );
+	grid.build( std::vector<vec3>{ vec3( 0 ), vec3( 1, 0, 0 ) } );
+	std::vector<uint32_t> result;
+	grid.findWithinRadius( vec3( 0 ), 1.5f, &result );
+	REQUIRE( result.size() == 2 );
+
+	grid.build( std::vector<vec3>() );
+	REQUIRE( grid.findWithinRadius( vec3( 0 ), 100, nullptr, nullptr, 0 ) == 0 );
+}
+
+} // SpatialHashGrid tests
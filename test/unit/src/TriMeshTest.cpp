@@ -0,0 +1,237 @@
+#include "catch.hpp"
+#include "cinder/TriMesh.h"
+#include "cinder/ObjLoader.h"
+
+#include <array>
+
+using namespace cinder;
+
+namespace {
+
+// Returns a mesh of \a numQuads unit quads along x, with every triangle using its own three vertices.
+TriMesh makeSplitQuads( size_t numQuads )
+{
+	TriMesh mesh( TriMesh::Format().positions().normals().texCoords() );
+	for( size_t q = 0; q < numQuads; q++ ) {
+		const float x = (float)q;
+		const vec3 corners[] = { vec3( x, 0, 0 ), vec3( x + 1, 0, 0 ), vec3( x + 1, 1, 0 ), vec3( x, 1, 0 ) };
+		const uint32_t triangles[] = { 0, 1, 2, 0, 2, 3 };
+		for( uint32_t i : triangles ) {
+			mesh.appendPosition( corners[i] );
+			mesh.appendNormal( vec3( 0, 0, 1 ) );
+			mesh.appendTexCoord0( vec2( corners[i] ) );
+		}
+		const uint32_t base = (uint32_t)q * 6;
+		mesh.appendTriangle( base, base + 1, base + 2 );
+		mesh.appendTriangle( base + 3, base + 4, base + 5 );
+	}
+	return mesh;
+}
+
+// Returns the triangles of \a mesh by position, each starting from its smallest vertex and sorted, so that meshes can be compared regardless of triangle and vertex order.
+std::vector<std::array<float, 9>> sortedTriangles( const TriMesh &mesh )
+{
+	std::vector<std::array<float, 9>> result;
+	for( size_t t = 0; t < mesh.getNumTriangles(); t++ ) {
+		vec3 v[3];
+		mesh.getTriangleVertices( t, &v[0], &v[1], &v[2] );
+		int first = 0;
+		for( int k = 1; k < 3; k++ )
+			if( std::lexicographical_compare( &v[k].x, &v[k].x + 3, &v[first].x, &v[first].x + 3 ) )
+				first = k;
+		std::array<float, 9> triangle;
+		for( int k = 0; k < 3; k++ )
+			for( int d = 0; d < 3; d++ )
+				triangle[k * 3 + d] = v[( first + k ) % 3][d];
+		result.push_back( triangle );
+	}
+	std::sort( result.begin(), result.end() );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "TriMesh" )
+{
+
+SECTION( "removeDuplicateVertices() merges identical vertices" )
+{
+	TriMesh mesh = makeSplitQuads( 3 );
+	REQUIRE( mesh.getNumVertices() == 18 );
+
+	size_t removed = mesh.removeDuplicateVertices();
+	REQUIRE( removed == 18 - 8 );
+	REQUIRE( mesh.getNumVertices() == 8 );
+	REQUIRE( mesh.getNumTriangles() == 6 );
+	REQUIRE( mesh.getNormals().size() == 8 );
+
+	// every index still refers to a vertex at the same position as before
+	const TriMesh original = makeSplitQuads( 3 );
+	for( size_t i = 0; i < mesh.getNumIndices(); i++ )
+		REQUIRE( mesh.getPositions<3>()[mesh.getIndices()[i]] == original.getPositions<3>()[original.getIndices()[i]] );
+}
+
+SECTION( "weldVertices() respects the tolerance and attribute seams" )
+{
+	TriMesh mesh = makeSplitQuads( 1 );
+	// nudge one of the duplicated corners by less than the tolerance
+	mesh.getPositions<3>()[3] += vec3( 0.00001f, 0, 0 );
+	REQUIRE( mesh.weldVertices( 0.0001f ) == 2 );
+	REQUIRE( mesh.getNumVertices() == 4 );
+
+	// a texture coordinate seam is preserved unless only positions are considered
+	TriMesh seam = makeSplitQuads( 1 );
+	seam.getTexCoords0<2>()[3] = vec2( 5, 5 );
+	REQUIRE( seam.weldVertices( 0.0001f ) == 1 );
+	REQUIRE( seam.getNumVertices() == 5 );
+	REQUIRE( seam.weldVertices( 0.0001f, true ) == 1 );
+	REQUIRE( seam.getNumVertices() == 4 );
+}
+
+SECTION( "recalculateNormals( true ) averages normals of coincident vertices" )
+{
+	// two triangles folded along the shared edge x = 0, each using its own vertices
+	TriMesh mesh( TriMesh::Format().positions() );
+	mesh.appendPosition( vec3( 0, 0, 0 ) ); mesh.appendPosition( vec3( 0, 1, 0 ) ); mesh.appendPosition( vec3( -1, 0, 0 ) );
+	mesh.appendPosition( vec3( 0, 0, 0 ) ); mesh.appendPosition( vec3( 0, 0, -1 ) ); mesh.appendPosition( vec3( 0, 1, 0 ) );
+	mesh.appendTriangle( 0, 1, 2 );
+	mesh.appendTriangle( 3, 4, 5 );
+
+	REQUIRE( mesh.recalculateNormals( true ) );
+	const vec3 expected = normalize( vec3( 1, 0, 1 ) );
+	REQUIRE( distance( mesh.getNormals()[0], expected ) < 0.0001f );
+	REQUIRE( distance( mesh.getNormals()[3], expected ) < 0.0001f );
+	REQUIRE( distance( mesh.getNormals()[1], mesh.getNormals()[5] ) < 0.0001f );
+	// vertices that are not shared keep their face normal
+	REQUIRE( distance( mesh.getNormals()[2], vec3( 0, 0, 1 ) ) < 0.0001f );
+
+	REQUIRE( mesh.recalculateNormals( false ) );
+	REQUIRE( distance( mesh.getNormals()[0], vec3( 0, 0, 1 ) ) < 0.0001f );
+}
+
+SECTION( "recalculateTangents() gives split vertices the same tangent" )
+{
+	TriMesh mesh = makeSplitQuads( 2 );
+	REQUIRE( mesh.recalculateTangents() );
+	REQUIRE( mesh.getTangents().size() == mesh.getNumVertices() );
+	for( const auto &tangent : mesh.getTangents() )
+		REQUIRE( distance( tangent, vec3( 1, 0, 0 ) ) < 0.0001f );
+}
+
+SECTION( "ObjLoader merges identical vertices from distinct indices" )
+{
+	const std::string data( R"obj(
+v 0 0 0
+v 1 0 0
+v 1 1 0
+v 0 0 0
+v 1 1 0
+v 0 1 0
+vn 0 0 1
+f 1//1 2//1 3//1
+f 4//1 5//1 6//1
+)obj" );
+
+	auto optimized = TriMesh::create( ObjLoader( IStreamMem::create( data.c_str(), data.size() ) ) );
+	REQUIRE( optimized->getNumTriangles() == 2 );
+	REQUIRE( optimized->getNumVertices() == 4 );
+
+	auto unoptimized = TriMesh::create( ObjLoader( IStreamMem::create( data.c_str(), data.size() ), true, true, false ) );
+	REQUIRE( unoptimized->getNumVertices() == 6 );
+}
+
+SECTION( "simplify() keeps flat borders, texture seams and face orientation" )
+{
+	TriMesh plane( geom::Plane().subdivisions( ivec2( 32 ) ) );
+	const AxisAlignedBox bounds = plane.calcBoundingBox();
+	// coplanar faces can be collapsed without any error
+	REQUIRE( plane.simplify( 2, 0 ) == 0 );
+	REQUIRE( plane.getNumTriangles() <= 16 );
+	REQUIRE( plane.getNumVertices() < 32 );
+	REQUIRE( plane.calcBoundingBox().getMin() == bounds.getMin() );
+	REQUIRE( plane.calcBoundingBox().getMax() == bounds.getMax() );
+	float area = 0;
+	for( size_t t = 0; t < plane.getNumTriangles(); t++ ) {
+		vec3 a, b, c;
+		plane.getTriangleVertices( t, &a, &b, &c );
+		const vec3 faceNormal = cross( b - a, c - a );
+		REQUIRE( faceNormal.y > 0 );
+		area += length( faceNormal ) / 2;
+	}
+	REQUIRE( area == Approx( bounds.getSize().x * bounds.getSize().z ) );
+
+	TriMesh sphere( geom::Sphere().subdivisions( 48 ) );
+	const size_t numTriangles = sphere.getNumTriangles();
+	const float error = sphere.simplify( numTriangles / 4 );
+	REQUIRE( sphere.getNumTriangles() <= numTriangles / 4 );
+	REQUIRE( sphere.getNumTriangles() > numTriangles / 8 );
+	REQUIRE( error > 0 );
+	REQUIRE( error < 0.1f );
+	for( size_t t = 0; t < sphere.getNumTriangles(); t++ ) {
+		vec3 a, b, c;
+		sphere.getTriangleVertices( t, &a, &b, &c );
+		// the poles of the source sphere have slivers of nearly zero area, which have no meaningful orientation
+		const vec3 faceNormal = cross( b - a, c - a );
+		if( length( faceNormal ) > 0.00001f )
+			REQUIRE( dot( faceNormal, a + b + c ) > 0 );
+		// a triangle across the texture seam would span most of the u range
+		const vec2 *texCoords = sphere.getTexCoords0<2>();
+		const uint32_t *indices = &sphere.getIndices()[t * 3];
+		const float u0 = texCoords[indices[0]].x, u1 = texCoords[indices[1]].x, u2 = texCoords[indices[2]].x;
+		REQUIRE( std::max( u0, std::max( u1, u2 ) ) - std::min( u0, std::min( u1, u2 ) ) < 0.5f );
+	}
+}
+
+SECTION( "createLods() returns decreasing levels of detail" )
+{
+	const TriMesh sphere( geom::Sphere().subdivisions( 32 ) );
+	const std::vector<size_t> counts = { sphere.getNumTriangles() / 2, sphere.getNumTriangles() / 4, sphere.getNumTriangles() / 8 };
+	auto lods = sphere.createLods( counts );
+	REQUIRE( lods.size() == 3 );
+	for( size_t i = 0; i < lods.size(); i++ ) {
+		REQUIRE( lods[i]->getNumTriangles() <= counts[i] );
+		REQUIRE( lods[i]->getNumTriangles() > counts[i] / 2 );
+		REQUIRE( lods[i]->getNormals().size() == lods[i]->getNumVertices() );
+	}
+	REQUIRE( sphere.getNumTriangles() == counts[0] * 2 );
+}
+
+SECTION( "optimizeVertexCache() reduces the ACMR without changing the triangles" )
+{
+	TriMesh mesh( geom::Sphere().subdivisions( 64 ) );
+	// scramble the triangle order so there is something to gain
+	std::vector<uint32_t> &indices = mesh.getIndices();
+	for( size_t t = 0; t < mesh.getNumTriangles(); t++ ) {
+		const size_t other = ( t * 7919 ) % mesh.getNumTriangles();
+		std::swap_ranges( indices.begin() + t * 3, indices.begin() + t * 3 + 3, indices.begin() + other * 3 );
+	}
+	const auto triangles = sortedTriangles( mesh );
+	const geom::VertexCacheStats before = mesh.calcVertexCacheStats();
+
+	mesh.optimizeVertexCache();
+	const geom::VertexCacheStats after = mesh.calcVertexCacheStats();
+	REQUIRE( after.mAcmr < before.mAcmr * 0.5f );
+	REQUIRE( after.mAcmr < 0.8f );
+	REQUIRE( after.mAtvr < 1.4f );
+	REQUIRE( sortedTriangles( mesh ) == triangles );
+
+	mesh.optimizeOverdraw( 1.05f );
+	REQUIRE( mesh.calcVertexCacheStats().mAcmr < after.mAcmr * 1.2f );
+	REQUIRE( sortedTriangles( mesh ) == triangles );
+
+	const size_t numVertices = mesh.getNumVertices();
+	mesh.optimizeVertexFetch();
+	REQUIRE( mesh.getNumVertices() == numVertices );
+	REQUIRE( mesh.getNormals().size() == numVertices );
+	REQUIRE( mesh.getIndices()[0] == 0 );
+	uint32_t maxIndex = 0;
+	for( auto index : mesh.getIndices() ) {
+		REQUIRE( index <= maxIndex + 1 );
+		maxIndex = std::max( maxIndex, index );
+	}
+	REQUIRE( sortedTriangles( mesh ) == triangles );
+	for( size_t v = 0; v < numVertices; v++ )
+		REQUIRE( dot( mesh.getNormals()[v], normalize( mesh.getPositions<3>()[v] ) ) > 0.99f );
+}
+
+} // TriMesh tests
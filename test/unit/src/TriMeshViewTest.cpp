@@ -0,0 +1,133 @@
+#include "catch.hpp"
+#include "cinder/TriMeshView.h"
+#include "cinder/TriMesh.h"
+#include "cinder/GeomIo.h"
+
+#include <algorithm>
+
+using namespace cinder;
+
+namespace {
+
+// Returns the triangles of \a indices, each rotated to start with its smallest index, in sorted order.
+std::vector<uvec3> canonicalTriangles( const std::vector<uint32_t> &indices )
+{
+	std::vector<uvec3> result;
+	for( size_t i = 0; i + 2 < indices.size(); i += 3 ) {
+		uvec3 t( indices[i], indices[i + 1], indices[i + 2] );
+		while( t.x > t.y || t.x > t.z )
+			t = uvec3( t.y, t.z, t.x );
+		result.push_back( t );
+	}
+
+	std::sort( result.begin(), result.end(), []( const uvec3 &a, const uvec3 &b ) {
+		return std::tie( a.x, a.y, a.z ) < std::tie( b.x, b.y, b.z );
+	} );
+	return result;
+}
+
+std::vector<uint32_t> decodedIndices( const TriMeshView &view )
+{
+	std::vector<uint32_t> result( view.getNumIndices() );
+	view.decodeIndices( result.data() );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "TriMeshView" )
+{
+	const fs::path path = fs::temp_directory_path() / "TriMeshViewTest.mesh";
+	const TriMesh sphere( geom::Sphere().subdivisions( 24 ) );
+
+SECTION( "Uncompressed files round trip exactly and are used in place" )
+{
+	TriMeshView::write( writeFile( path ), sphere );
+	auto view = TriMeshView::create( loadFile( path ) );
+
+	REQUIRE( view->getNumVertices() == sphere.getNumVertices() );
+	REQUIRE( view->getNumIndices() == sphere.getNumIndices() );
+	REQUIRE( view->getAvailableAttribs() == sphere.getAvailableAttribs() );
+	REQUIRE( view->getIndexBytes() == 2 );
+	REQUIRE( decodedIndices( *view ) == sphere.getIndices() );
+
+	const float *positions = view->getAttribData( geom::POSITION );
+	REQUIRE( positions != nullptr );
+	REQUIRE( std::equal( positions, positions + sphere.getNumVertices() * 3, sphere.getBufferPositions().begin() ) );
+
+	TriMesh mesh( *view );
+	REQUIRE( mesh.getNormals() == sphere.getNormals() );
+	REQUIRE( mesh.getBufferTexCoords0() == sphere.getBufferTexCoords0() );
+
+	AxisAlignedBox bounds = view->getBoundingBox();
+	REQUIRE( bounds.getMin() == sphere.calcBoundingBox().getMin() );
+	REQUIRE( bounds.getMax() == sphere.calcBoundingBox().getMax() );
+}
+
+SECTION( "Quantized attributes and compressed indices decode within their precision" )
+{
+	TriMeshView::write( writeFile( path ), sphere, TriMeshView::Format().quantizePositions().quantizeNormals().compressIndices() );
+	auto view = TriMeshView::create( loadFile( path ) );
+
+	REQUIRE( view->getAttribEncoding( geom::POSITION ) == TriMeshView::Encoding::UNORM16 );
+	REQUIRE( view->getAttribEncoding( geom::NORMAL ) == TriMeshView::Encoding::OCTAHEDRAL16 );
+	REQUIRE( view->getAttribData( geom::POSITION ) == nullptr );
+	REQUIRE( view->getIndexEncoding() == TriMeshView::Encoding::COMPRESSED );
+	REQUIRE( view->getIndexData() == nullptr );
+
+	TriMesh mesh( *view );
+	REQUIRE( mesh.getNumVertices() == sphere.getNumVertices() );
+	for( size_t v = 0; v < mesh.getNumVertices(); ++v ) {
+		REQUIRE( distance( mesh.getPositions<3>()[v], sphere.getPositions<3>()[v] ) < 0.0001f );
+		REQUIRE( dot( mesh.getNormals()[v], sphere.getNormals()[v] ) > 0.99999f );
+	}
+
+	// triangles may be rotated, but keep their winding
+	REQUIRE( canonicalTriangles( mesh.getIndices() ) == canonicalTriangles( sphere.getIndices() ) );
+}
+
+SECTION( "Compressed indices of large meshes" )
+{
+	const TriMesh plane( geom::Plane().subdivisions( ivec2( 300 ) ) );
+	REQUIRE( plane.getNumVertices() > 65536 );
+
+	TriMeshView::write( writeFile( path ), plane );
+	REQUIRE( TriMeshView( loadFile( path ) ).getIndexBytes() == 4 );
+
+	TriMeshView::write( writeFile( path ), plane, TriMeshView::Format().compressIndices() );
+	const size_t compressedFileSize = fs::file_size( path );
+	TriMeshView view( loadFile( path ) );
+	REQUIRE( canonicalTriangles( decodedIndices( view ) ) == canonicalTriangles( plane.getIndices() ) );
+
+	// a regular grid needs less than two bytes per triangle
+	size_t attribSize = 0;
+	for( auto attrib : view.getAvailableAttribs() )
+		attribSize += view.getNumVertices() * view.getAttribDims( attrib ) * sizeof( float );
+	REQUIRE( compressedFileSize - attribSize < view.getNumIndices() / 3 * 2 );
+}
+
+SECTION( "TriMesh::read() opens mesh cache files" )
+{
+	TriMeshView::write( writeFile( path ), sphere, TriMeshView::Format().compressIndices() );
+	REQUIRE( TriMeshView::isTriMeshView( loadFile( path ) ) );
+
+	TriMesh mesh;
+	mesh.read( loadFile( path ) );
+	REQUIRE( mesh.getNumTriangles() == sphere.getNumTriangles() );
+	REQUIRE( mesh.getBufferPositions() == sphere.getBufferPositions() );
+}
+
+SECTION( "Invalid files are rejected" )
+{
+	sphere.write( writeFile( path ) );
+	REQUIRE_FALSE( TriMeshView::isTriMeshView( loadFile( path ) ) );
+	REQUIRE_THROWS_AS( TriMeshView( loadFile( path ) ), ExcTriMeshView );
+
+	// truncating the file leaves the arrays outside of it
+	TriMeshView::write( writeFile( path ), sphere );
+	fs::resize_file( path, fs::file_size( path ) - 16 );
+	REQUIRE_THROWS_AS( TriMeshView( loadFile( path ) ), ExcTriMeshView );
+}
+
+	fs::remove( path );
+} // TriMeshView tests
@@ -0,0 +1,168 @@
+#include "catch.hpp"
+#include "cinder/Triangulate.h"
+
+using namespace cinder;
+
+namespace {
+
+// Returns the sum of the signed areas of the triangles of \a mesh, and optionally the sum of their absolute areas
+float triangleArea( const TriMesh &mesh, float *absoluteArea = nullptr )
+{
+	float result = 0, absolute = 0;
+	for( size_t t = 0; t < mesh.getNumTriangles(); t++ ) {
+		const uint32_t *indices = &mesh.getIndices()[t * 3];
+		const vec2 a = mesh.getPositions<2>()[indices[0]], b = mesh.getPositions<2>()[indices[1]], c = mesh.getPositions<2>()[indices[2]];
+		const float area = ( ( b.x - a.x ) * ( c.y - a.y ) - ( b.y - a.y ) * ( c.x - a.x ) ) / 2;
+		result += area;
+		absolute += std::abs( area );
+	}
+	if( absoluteArea )
+		*absoluteArea = absolute;
+	return result;
+}
+
+void addRect( Shape2d *shape, float x1, float y1, float x2, float y2, bool counterClockwise = true )
+{
+	shape->moveTo( x1, y1 );
+	shape->lineTo( counterClockwise ? vec2( x2, y1 ) : vec2( x1, y2 ) );
+	shape->lineTo( x2, y2 );
+	shape->lineTo( counterClockwise ? vec2( x1, y2 ) : vec2( x2, y1 ) );
+	shape->close();
+}
+
+void addCircle( Shape2d *shape, const vec2 &center, float radius, bool counterClockwise = true )
+{
+	shape->moveTo( center + vec2( radius, 0 ) );
+	shape->arc( center, radius, 0, counterClockwise ? 6.2831853f : -6.2831853f, counterClockwise );
+	shape->close();
+}
+
+// Returns the mesh of \a shape with and without ear clipping
+std::pair<TriMesh, TriMesh> calcBoth( const Shape2d &shape, Triangulator::Winding winding = Triangulator::WINDING_ODD )
+{
+	Triangulator triangulator( shape );
+	TriMesh clipped = triangulator.calcMesh( winding );
+	triangulator.setEarClippingEnabled( false );
+	return std::make_pair( clipped, triangulator.calcMesh( winding ) );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "Triangulator" )
+{
+
+SECTION( "polygons with holes are ear clipped without overlapping triangles" )
+{
+	// a glyph-like outline with two holes, one of which has an island inside it
+	Shape2d shape;
+	addRect( &shape, 0, 0, 10, 10 );
+	addRect( &shape, 1, 1, 4, 9, false );
+	addRect( &shape, 2, 2, 3, 3 );
+	addCircle( &shape, vec2( 7, 5 ), 2, false );
+
+	auto meshes = calcBoth( shape );
+	float absolute;
+	const float area = triangleArea( meshes.first, &absolute );
+	REQUIRE( area == Approx( triangleArea( meshes.second ) ).epsilon( 0.0001 ) );
+	REQUIRE( absolute == Approx( area ) );
+	REQUIRE( area == Approx( 100 - 24 + 1 - 3.1416f * 4 ).epsilon( 0.01 ) );
+	// a polygon of n vertices with h holes has n + 2h - 2 triangles
+	REQUIRE( meshes.first.getNumTriangles() <= meshes.first.getNumVertices() + 2 );
+
+	// nested contours of alternating orientation give the same result under every winding rule but ABS_GEQ_TWO
+	for( auto winding : { Triangulator::WINDING_NONZERO, Triangulator::WINDING_POSITIVE } ) {
+		auto wound = calcBoth( shape, winding );
+		REQUIRE( triangleArea( wound.first ) == Approx( area ) );
+		REQUIRE( triangleArea( wound.second ) == Approx( area ) );
+	}
+	REQUIRE( calcBoth( shape, Triangulator::WINDING_NEGATIVE ).first.getNumTriangles() == 0 );
+}
+
+SECTION( "large contours are clipped using the z-order hash" )
+{
+	// a star of 500 points around a hole of 200
+	Shape2d shape;
+	for( int i = 0; i < 500; i++ ) {
+		const float angle = i * 6.2831853f / 500, radius = ( i % 2 ) ? 10.0f : 8.0f;
+		const vec2 p( cos( angle ) * radius, sin( angle ) * radius );
+		if( i == 0 )
+			shape.moveTo( p );
+		else
+			shape.lineTo( p );
+	}
+	shape.close();
+	addCircle( &shape, vec2( 1, 0 ), 4 );
+
+	auto meshes = calcBoth( shape );
+	float absolute;
+	const float area = triangleArea( meshes.first, &absolute );
+	REQUIRE( area == Approx( triangleArea( meshes.second ) ).epsilon( 0.0001 ) );
+	REQUIRE( absolute == Approx( area ).epsilon( 0.0001 ) );
+}
+
+SECTION( "self-intersecting and overlapping contours fall back to libtess2" )
+{
+	Shape2d bowtie;
+	bowtie.moveTo( 0, 0 );
+	bowtie.lineTo( 2, 2 );
+	bowtie.lineTo( 2, 0 );
+	bowtie.lineTo( 0, 2 );
+	bowtie.close();
+	auto meshes = calcBoth( bowtie );
+	REQUIRE( meshes.first.getNumTriangles() == meshes.second.getNumTriangles() );
+	REQUIRE( std::abs( triangleArea( meshes.first ) ) == Approx( 2 ) );
+
+	// under NONZERO, a hole with the same orientation as its outer contour is filled
+	Shape2d nested;
+	addRect( &nested, 0, 0, 4, 4 );
+	addRect( &nested, 1, 1, 3, 3 );
+	REQUIRE( triangleArea( calcBoth( nested ).first ) == Approx( 12 ) );
+	REQUIRE( triangleArea( calcBoth( nested, Triangulator::WINDING_NONZERO ).first ) == Approx( 16 ) );
+	REQUIRE( triangleArea( calcBoth( nested, Triangulator::WINDING_ABS_GEQ_TWO ).first ) == Approx( 4 ) );
+
+	// touching contours
+	Shape2d touching;
+	addRect( &touching, 0, 0, 1, 1 );
+	addRect( &touching, 1, 0, 2, 1 );
+	REQUIRE( triangleArea( calcBoth( touching ).first ) == Approx( 2 ) );
+}
+
+SECTION( "contours are kept between calls and can be cleared" )
+{
+	const vec2 points[] = { vec2( 0, 0 ), vec2( 3, 0 ), vec2( 3, 3 ), vec2( 0, 3 ), vec2( 0, 0 ) };
+	Triangulator triangulator;
+	triangulator.addPolyLine( points, 5 );
+	REQUIRE( triangulator.calcMesh().getNumTriangles() == 2 );
+	REQUIRE( triangleArea( triangulator.calcMesh() ) == Approx( 9 ) );
+	triangulator.setEarClippingEnabled( false );
+	REQUIRE( triangleArea( *triangulator.createMesh() ) == Approx( 9 ) );
+	REQUIRE( triangleArea( *triangulator.createMesh() ) == Approx( 9 ) );
+
+	triangulator.clear();
+	REQUIRE( triangulator.calcMesh().getNumTriangles() == 0 );
+	triangulator.setEarClippingEnabled();
+	REQUIRE( triangulator.calcMesh().getNumTriangles() == 0 );
+}
+
+SECTION( "calcMeshes() matches triangulating each shape on its own" )
+{
+	std::vector<Shape2d> shapes( 100 );
+	for( size_t s = 0; s < shapes.size(); s++ ) {
+		addCircle( &shapes[s], vec2( s, 0 ), 10 + s % 7 );
+		if( s % 3 == 0 )
+			addCircle( &shapes[s], vec2( s, 0 ), 5, false );
+		if( s % 10 == 0 )
+			addRect( &shapes[s], (float)s, 0, s + 20.0f, 20 ); // overlaps the circle
+	}
+
+	auto meshes = Triangulator::calcMeshes( shapes, 2.0f );
+	REQUIRE( meshes.size() == shapes.size() );
+	for( size_t s = 0; s < shapes.size(); s++ ) {
+		TriMesh expected = Triangulator( shapes[s], 2.0f ).calcMesh();
+		REQUIRE( meshes[s].getNumTriangles() == expected.getNumTriangles() );
+		REQUIRE( meshes[s].getIndices() == expected.getIndices() );
+		REQUIRE( triangleArea( meshes[s] ) == Approx( triangleArea( expected ) ) );
+	}
+}
+
+} // Triangulator tests
@@ -0,0 +1,133 @@
+#include "catch.hpp"
+#include "cinder/Xml.h"
+
+using namespace cinder;
+
+namespace {
+
+const std::string sDocument = R"xml(<?xml version="1.0" encoding="utf-8"?>
+<!DOCTYPE library>
+<library name="Main &amp; Annex">
+	<!-- a comment -->
+	<shelf id="1">
+		<book year="2004">Seven Swans</book>
+	</shelf>
+	<Shelf id="2">
+		<book year="1999">First</book>
+		<book year="2001">Second</book>
+		<magazine issue="12"/>
+	</Shelf>
+	<notes><![CDATA[<raw>]]></notes>
+	<count>42</count>
+</library>
+)xml";
+
+} // anonymous namespace
+
+TEST_CASE( "Xml" )
+{
+
+SECTION( "XmlView exposes tags, values and attributes in place" )
+{
+	XmlView view( sDocument );
+	REQUIRE( view.getDocType() == "library" );
+	REQUIRE( view.getDocument().getNodeType() == XmlTree::NODE_DOCUMENT );
+
+	XmlView::Node library = view / "library";
+	REQUIRE( library.getTag() == "library" );
+	REQUIRE( library["name"] == "Main & Annex" );
+	REQUIRE( library["missing"].empty() );
+	REQUIRE( library.hasAttribute( "name" ) );
+	REQUIRE_THROWS_AS( library.getAttributeValue( "missing" ), XmlView::ExcAttrNotFound );
+	REQUIRE( library.getChild( "count" ).getValue<int>() == 42 );
+	REQUIRE( library.getChild( "count" ).getValue<float>( 1.0f ) == 42.0f );
+	REQUIRE( library.getChild( "notes" ).getValue( 7 ) == 7 );
+	REQUIRE( library.getChild( "shelf/book" ).getAttributeValue<int>( "year" ) == 2004 );
+	REQUIRE( library.getChild( "shelf/book" ).getAttributeValue( "month", 3 ) == 3 );
+
+	XmlView::Attr attr = library.getChild( "Shelf/magazine", true ).getFirstAttribute();
+	REQUIRE( attr.getName() == "issue" );
+	REQUIRE( attr.getValue<int>() == 12 );
+	REQUIRE( ! attr.getNextAttribute() );
+}
+
+SECTION( "XmlView iterates and finds children like XmlTree" )
+{
+	XmlView view( sDocument, true );
+	XmlTree tree( sDocument, XmlTree::ParseOptions().parseComments() );
+	XmlView::Node library = view.getChild( "library" );
+
+	std::vector<std::string> tags;
+	for( XmlView::Node child : library )
+		tags.push_back( child.getTag().to_string() );
+	std::vector<std::string> treeTags;
+	for( XmlTree::ConstIter child = tree.getChild( "library" ).begin(); child != tree.getChild( "library" ).end(); ++child )
+		treeTags.push_back( child->getTag() );
+	REQUIRE( tags == treeTags );
+	REQUIRE( tags.size() == 5 );
+
+	// tags match case-insensitively by default
+	int numShelves = 0;
+	for( XmlView::Node shelf : library.children( "shelf" ) ) {
+		REQUIRE( shelf.getParent() == library );
+		numShelves++;
+	}
+	REQUIRE( numShelves == 2 );
+	int numCaseSensitive = 0;
+	for( XmlView::Node shelf : library.children( "shelf", true ) ) {
+		REQUIRE( shelf["id"] == "1" );
+		numCaseSensitive++;
+	}
+	REQUIRE( numCaseSensitive == 1 );
+
+	// getChild() only follows the first match of each component, find() tries the others
+	REQUIRE( ! library.hasChild( "shelf/magazine" ) );
+	REQUIRE( ! tree.getChild( "library" ).hasChild( "shelf/magazine" ) );
+	REQUIRE_THROWS_AS( library.getChild( "shelf/magazine" ), XmlView::ExcChildNotFound );
+	XmlView::Node magazine = view.find( "/library/shelf/magazine" );
+	REQUIRE( magazine );
+	REQUIRE( magazine.getPath() == "library/Shelf/magazine" );
+	REQUIRE( ! view.find( "library/shelf/missing" ) );
+	REQUIRE( ! view.find( "" ) );
+
+	REQUIRE( library.getChild( "notes" ).begin() != library.getChild( "notes" ).end() );
+	REQUIRE( ( *library.getChild( "notes" ).begin() ).getNodeType() == XmlTree::NODE_CDATA );
+	REQUIRE( ( *library.getChild( "notes" ).begin() ).getValue() == "<raw>" );
+}
+
+SECTION( "XmlView nodes can be copied into an XmlTree" )
+{
+	XmlView view( sDocument );
+	XmlTree shelf = view.getChild( "library/Shelf", true ).createXmlTree();
+	REQUIRE( shelf.getTag() == "Shelf" );
+	REQUIRE( shelf.getAttributeValue<int>( "id" ) == 2 );
+	REQUIRE( shelf.getChildren().size() == 3 );
+	REQUIRE( shelf.getChild( "book" ).getValue() == "First" );
+
+	XmlTree document = view.getDocument().createXmlTree();
+	REQUIRE( document.isDocument() );
+	REQUIRE( document.getDocType() == "library" );
+	REQUIRE( document.getChild( "library/notes" ).getValue() == "<raw>" );
+
+	// the view shares its document with copies
+	XmlView::Node count;
+	{
+		XmlView copy = view;
+		count = copy.getChild( "library/count" );
+	}
+	REQUIRE( count.getValue() == "42" );
+}
+
+SECTION( "XmlTree finds children case-insensitively" )
+{
+	XmlTree tree( sDocument );
+	REQUIRE( tree.getChild( "LIBRARY/shelf/BOOK" ).getValue() == "Seven Swans" );
+	REQUIRE( tree.hasChild( "library//shelf/" ) );
+	REQUIRE( ! tree.hasChild( "LIBRARY/shelf/BOOK", true ) );
+	int numBooks = 0;
+	for( XmlTree::ConstIter book = tree.begin( "library/shelf/book" ); book != tree.end(); ++book )
+		numBooks++;
+	REQUIRE( numBooks == 3 );
+}
+
+} // Xml tests
@@ -0,0 +1,190 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/audio/dsp/Converter.h"
+#include "cinder/audio/dsp/ConverterPolyphase.h"
+#include "cinder/Log.h"
+#include "cinder/Timer.h"
+
+#include <cmath>
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+const size_t	FRAMES_PER_BLOCK	= 512;
+const size_t	SOURCE_SAMPLERATE	= 44100;
+const size_t	DEST_SAMPLERATE		= 48000;
+const double	SINE_FREQ			= 997;
+
+struct ConvertResult {
+	Buffer	mOutput;
+	double	mSeconds;
+};
+
+// converts numSeconds of a sine wave at SINE_FREQ in blocks of FRAMES_PER_BLOCK, returning all output frames and the time spent converting.
+ConvertResult convertSine( dsp::Converter *converter, double numSeconds )
+{
+	const size_t numChannels = converter->getSourceNumChannels();
+	const size_t numSourceFrames = size_t( numSeconds * converter->getSourceSampleRate() );
+	const size_t numBlocks = numSourceFrames / FRAMES_PER_BLOCK;
+
+	Buffer source( numBlocks * FRAMES_PER_BLOCK, numChannels );
+	for( size_t ch = 0; ch < numChannels; ch++ ) {
+		float *channel = source.getChannel( ch );
+		for( size_t i = 0; i < source.getNumFrames(); i++ )
+			channel[i] = 0.5f * (float)sin( 2 * M_PI * SINE_FREQ * (double)i / (double)converter->getSourceSampleRate() );
+	}
+
+	ConvertResult result;
+	result.mOutput = Buffer( size_t( numBlocks * ( converter->getDestMaxFramesPerBlock() + 1 ) ), converter->getDestNumChannels() );
+
+	Buffer sourceBlock( FRAMES_PER_BLOCK, numChannels );
+	Buffer destBlock( converter->getDestMaxFramesPerBlock(), converter->getDestNumChannels() );
+
+	// copy all source blocks up front so that only the conversion is timed
+	vector<Buffer> sourceBlocks( numBlocks, Buffer( FRAMES_PER_BLOCK, numChannels ) );
+	for( size_t b = 0; b < numBlocks; b++ )
+		sourceBlocks[b].copyOffset( source, FRAMES_PER_BLOCK, 0, b * FRAMES_PER_BLOCK );
+
+	size_t outFrames = 0;
+	Timer timer( true );
+	for( size_t b = 0; b < numBlocks; b++ ) {
+		auto count = converter->convert( &sourceBlocks[b], &destBlock );
+		result.mOutput.copyOffset( destBlock, count.second, outFrames, 0 );
+		outFrames += count.second;
+	}
+	result.mSeconds = timer.getSeconds();
+
+	Buffer trimmed( outFrames, result.mOutput.getNumChannels() );
+	trimmed.copy( result.mOutput, outFrames );
+	result.mOutput = trimmed;
+	return result;
+}
+
+// Returns THD+N in decibels: the power remaining after removing the best fitting sine at \a freq, relative to the power of that sine.
+double calcThdN( const float *signal, size_t length, double freq, size_t sampleRate )
+{
+	// least squares fit of a * sin + b * cos + c
+	const double w = 2 * M_PI * freq / (double)sampleRate;
+	double ss = 0, cc = 0, sc = 0, s1 = 0, c1 = 0, ys = 0, yc = 0, y1 = 0;
+	for( size_t i = 0; i < length; i++ ) {
+		double s = sin( w * i ), c = cos( w * i ), y = signal[i];
+		ss += s * s; cc += c * c; sc += s * c; s1 += s; c1 += c;
+		ys += y * s; yc += y * c; y1 += y;
+	}
+
+	// solve the 3x3 normal equations with Cramer's rule
+	const double n = (double)length;
+	auto det3 = []( double a, double b, double c, double d, double e, double f, double g, double h, double k ) {
+		return a * ( e * k - f * h ) - b * ( d * k - f * g ) + c * ( d * h - e * g );
+	};
+	const double det = det3( ss, sc, s1, sc, cc, c1, s1, c1, n );
+	const double a = det3( ys, sc, s1, yc, cc, c1, y1, c1, n ) / det;
+	const double b = det3( ss, ys, s1, sc, yc, c1, s1, y1, n ) / det;
+	const double c = det3( ss, sc, ys, sc, cc, yc, s1, c1, y1 ) / det;
+
+	double signalPower = 0, residualPower = 0;
+	for( size_t i = 0; i < length; i++ ) {
+		double fit = a * sin( w * i ) + b * cos( w * i ) + c;
+		double residual = signal[i] - fit;
+		signalPower += fit * fit;
+		residualPower += residual * residual;
+	}
+
+	return 10 * log10( residualPower / signalPower );
+}
+
+// measures THD+N on the second half of the output, so that any converter latency and startup transients are skipped.
+double calcThdN( const ConvertResult &result, size_t sampleRate )
+{
+	const size_t length = result.mOutput.getNumFrames() / 2;
+	return calcThdN( result.mOutput.getChannel( 0 ) + length, length, SINE_FREQ, sampleRate );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/ConverterPolyphase" )
+{
+
+SECTION( "output length matches ratio" )
+{
+	dsp::ConverterImplPolyphase converter( SOURCE_SAMPLERATE, DEST_SAMPLERATE, 2, 2, FRAMES_PER_BLOCK );
+	auto result = convertSine( &converter, 2 );
+
+	const double expectedFrames = 2 * (double)DEST_SAMPLERATE;
+	REQUIRE( fabs( (double)result.mOutput.getNumFrames() - expectedFrames ) < (double)FRAMES_PER_BLOCK * 2 );
+}
+
+SECTION( "THD+N" )
+{
+	const dsp::ConverterImplPolyphase::Quality qualities[] = { dsp::ConverterImplPolyphase::Quality::LOW, dsp::ConverterImplPolyphase::Quality::MEDIUM, dsp::ConverterImplPolyphase::Quality::HIGH };
+	const double maxThdN[] = { -40, -65, -85 };
+
+	for( size_t q = 0; q < 3; q++ ) {
+		// upsampling
+		dsp::ConverterImplPolyphase up( SOURCE_SAMPLERATE, DEST_SAMPLERATE, 1, 1, FRAMES_PER_BLOCK, qualities[q] );
+		double thdnUp = calcThdN( convertSine( &up, 1 ), DEST_SAMPLERATE );
+		REQUIRE( thdnUp < maxThdN[q] );
+
+		// downsampling
+		dsp::ConverterImplPolyphase down( DEST_SAMPLERATE, SOURCE_SAMPLERATE, 1, 1, FRAMES_PER_BLOCK, qualities[q] );
+		double thdnDown = calcThdN( convertSine( &down, 1 ), SOURCE_SAMPLERATE );
+		REQUIRE( thdnDown < maxThdN[q] );
+	}
+}
+
+SECTION( "channel mixing" )
+{
+	dsp::ConverterImplPolyphase upMix( SOURCE_SAMPLERATE, DEST_SAMPLERATE, 1, 2, FRAMES_PER_BLOCK );
+	auto upMixResult = convertSine( &upMix, 0.5 );
+	REQUIRE( upMixResult.mOutput.getNumChannels() == 2 );
+	for( size_t i = 0; i < upMixResult.mOutput.getNumFrames(); i++ )
+		REQUIRE( upMixResult.mOutput.getChannel( 0 )[i] == upMixResult.mOutput.getChannel( 1 )[i] );
+
+	dsp::ConverterImplPolyphase downMix( SOURCE_SAMPLERATE, DEST_SAMPLERATE, 2, 1, FRAMES_PER_BLOCK );
+	auto downMixResult = convertSine( &downMix, 0.5 );
+	REQUIRE( downMixResult.mOutput.getNumChannels() == 1 );
+}
+
+SECTION( "ratio change while running" )
+{
+	dsp::ConverterImplPolyphase converter( SOURCE_SAMPLERATE, SOURCE_SAMPLERATE, 1, 1, FRAMES_PER_BLOCK );
+	Buffer source( FRAMES_PER_BLOCK, 1 );
+	fillRandom( &source );
+
+	const double ratios[] = { 1.0, 1.5, 0.75, 1.01 };
+	for( double ratio : ratios ) {
+		converter.setRatio( ratio );
+		Buffer dest( converter.getDestMaxFramesPerBlock(), 1 );
+
+		size_t outFrames = 0;
+		const size_t numBlocks = 50;
+		for( size_t b = 0; b < numBlocks; b++ )
+			outFrames += converter.convert( &source, &dest ).second;
+
+		const double expectedFrames = numBlocks * FRAMES_PER_BLOCK * ratio;
+		REQUIRE( fabs( (double)outFrames - expectedFrames ) < (double)converter.getNumTaps() + 2 );
+	}
+}
+
+SECTION( "benchmark against default Converter" )
+{
+	const double numSeconds = 10;
+
+	auto defaultConverter = dsp::Converter::create( SOURCE_SAMPLERATE, DEST_SAMPLERATE, 2, 2, FRAMES_PER_BLOCK );
+	auto defaultResult = convertSine( defaultConverter.get(), numSeconds );
+	CI_LOG_I( "default Converter: " << numSeconds / defaultResult.mSeconds << "x realtime, THD+N: " << calcThdN( defaultResult, DEST_SAMPLERATE ) << " dB" );
+
+	const char *qualityNames[] = { "LOW", "MEDIUM", "HIGH" };
+	const dsp::ConverterImplPolyphase::Quality qualities[] = { dsp::ConverterImplPolyphase::Quality::LOW, dsp::ConverterImplPolyphase::Quality::MEDIUM, dsp::ConverterImplPolyphase::Quality::HIGH };
+	for( size_t q = 0; q < 3; q++ ) {
+		dsp::ConverterImplPolyphase converter( SOURCE_SAMPLERATE, DEST_SAMPLERATE, 2, 2, FRAMES_PER_BLOCK, qualities[q] );
+		auto result = convertSine( &converter, numSeconds );
+		CI_LOG_I( "ConverterImplPolyphase (" << qualityNames[q] << "): " << numSeconds / result.mSeconds << "x realtime, THD+N: " << calcThdN( result, DEST_SAMPLERATE ) << " dB" );
+	}
+}
+
+} // "audio/ConverterPolyphase"
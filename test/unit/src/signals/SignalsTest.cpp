@@ -5,9 +5,12 @@
 #include "cinder/Signals.h"
 #include "cinder/app/Event.h"
 
+#include <array>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <thread>
 
 using namespace std;
 using namespace ci;
@@ -605,3 +608,118 @@ TEST_CASE( "signals/Signals" )
 	}
 
 } // Signals
+
+TEST_CASE( "signals/FlatSignal" )
+{
+	SECTION( "FlatSignal calls slots in priority order like Signal" )
+	{
+		FlatSignal<void (vector<int>*)> sig;
+		auto conn0 = sig.connect( [] ( vector<int> *order ) { order->push_back( 0 ); } );
+		auto conn1 = sig.connect( -1, [] ( vector<int> *order ) { order->push_back( 1 ); } );
+		auto conn2 = sig.connect( 5, [] ( vector<int> *order ) { order->push_back( 2 ); } );
+		auto conn3 = sig.connect( [] ( vector<int> *order ) { order->push_back( 3 ); } );
+		auto conn4 = sig.connect( 5, [] ( vector<int> *order ) { order->push_back( 4 ); } );
+		REQUIRE( sig.getNumSlots() == 5 );
+
+		vector<int> order;
+		sig.emit( &order );
+		REQUIRE( order == vector<int>( { 2, 4, 0, 3, 1 } ) );
+
+		REQUIRE( conn2.disconnect() );
+		REQUIRE( ! conn2.disconnect() );
+		REQUIRE( ! conn2.isConnected() );
+		conn3.disable();
+		order.clear();
+		sig.emit( &order );
+		REQUIRE( order == vector<int>( { 4, 0, 1 } ) );
+		REQUIRE( sig.getNumSlots() == 4 );
+
+		conn3.enable();
+		order.clear();
+		sig.emit( &order );
+		REQUIRE( order == vector<int>( { 4, 0, 3, 1 } ) );
+	}
+
+	SECTION( "FlatSignal defers disconnections made during emission" )
+	{
+		FlatSignal<void ()> sig;
+		int i = 0, j = 0;
+		auto conn1 = sig.connect( [&] { i++; } );
+		sig.connect( 1, [&] { conn1.disconnect(); i++; } );
+		Connection conn3;
+		conn3 = sig.connect( [&] { j++; conn3.disconnect(); } );
+
+		sig.emit();
+		REQUIRE( i == 1 );
+		REQUIRE( j == 1 );
+		REQUIRE( sig.getNumSlots() == 1 );
+
+		// slots connected during an emission are called from the next one
+		sig.connect( -1, [&] { sig.connect( [&] { j += 10; } ); } );
+		sig.emit();
+		REQUIRE( i == 2 );
+		REQUIRE( j == 1 );
+		sig.emit();
+		REQUIRE( j == 11 );
+	}
+
+	SECTION( "FlatSignal works with ScopedConnection, ConnectionList and collectors" )
+	{
+		FlatSignal<int (int), CollectorVector<int>> sig;
+		{
+			ScopedConnection scoped = sig.connect( [] ( int x ) { return x + 1; } );
+			ConnectionList list;
+			list += sig.connect( [] ( int x ) { return x * 2; } );
+			list += sig.connect( 1, [] ( int x ) { return x * 3; } );
+			REQUIRE( sig.emit( 2 ) == vector<int>( { 6, 3, 4 } ) );
+		}
+		REQUIRE( sig.getNumSlots() == 0 );
+		REQUIRE( sig.emit( 2 ).empty() );
+
+		// callables too large to be stored inline
+		array<int, 64> large;
+		large.fill( 1 );
+		auto conn = sig.connect( [large] ( int x ) { return x + large[63]; } );
+		REQUIRE( sig.emit( 5 ) == vector<int>( { 6 } ) );
+		REQUIRE( conn.disconnect() );
+
+		FlatSignal<bool (), CollectorUntil0<bool>> until;
+		int calls = 0;
+		until.connect( [&] { calls++; return true; } );
+		until.connect( [&] { calls++; return false; } );
+		until.connect( [&] { calls++; return true; } );
+		REQUIRE( ! until.emit() );
+		REQUIRE( calls == 2 );
+	}
+
+	SECTION( "FlatSignal can be emitted from several threads while connecting and disconnecting" )
+	{
+		FlatSignal<void (int)> sig;
+		std::atomic<int> sum( 0 );
+		sig.connect( [&] ( int x ) { sum += x; } );
+
+		std::atomic<bool> done( false );
+		vector<thread> emitters;
+		for( int t = 0; t < 4; t++ ) {
+			emitters.emplace_back( [&] {
+				while( ! done )
+					sig.emit( 1 );
+			} );
+		}
+
+		for( int k = 0; k < 1000; k++ ) {
+			auto conn = sig.connect( k % 7, [&] ( int x ) { sum += x; } );
+			if( k % 3 )
+				sig.emit( 0 );
+			conn.disconnect();
+		}
+		done = true;
+		for( auto &emitter : emitters )
+			emitter.join();
+
+		REQUIRE( sig.getNumSlots() == 1 );
+		const int before = sum;
+		sig.emit( 1 );
+		REQUIRE( sum == before + 1 );
+	}
+} // FlatSignal